@@ -942,6 +942,7 @@ AnalyzeEnableXMagicEngine(FTIMES_PROPERTIES *psProperties, char *pcError)
 {
   const char          acRoutine[] = "AnalyzeEnableXMagicEngine()";
   char                acLocalError[MESSAGE_SIZE] = "";
+  char                acMessage[MESSAGE_SIZE] = "";
   unsigned char       aucMD5[MD5_HASH_SIZE];
   int                 i;
   int                 iError;
@@ -1027,6 +1028,59 @@ AnalyzeEnableXMagicEngine(FTIMES_PROPERTIES *psProperties, char *pcError)
     strcpy(psProperties->acMagicHash, "NA");
   }
 
+  /*-
+   *********************************************************************
+   *
+   * Conditionally load the result cache. The cache is tied to the
+   * magic hash, so results produced by other magic are discarded. An
+   * unreadable cache is not fatal -- just start with an empty one.
+   * Entries are keyed on the bytes that the magic can reach, so if
+   * that reach can't be bounded (e.g., the magic contains a long
+   * indirect offset), every lookup would have to digest the entire
+   * file. That costs more than the tests it saves, so the cache is
+   * disabled in that case.
+   *
+   *********************************************************************
+   */
+  if (psProperties->acMagicCacheFileName[0] && XMagicGetReach(psProperties->psXMagic) < 0)
+  {
+    snprintf(acMessage, MESSAGE_SIZE, "%s: MagicFile = [%s]: The magic's reach is unbounded. The result cache will not be used.", acRoutine, psProperties->acMagicFileName);
+    ErrorHandler(ER_Warning, acMessage, ERROR_WARNING);
+  }
+  else if (psProperties->acMagicCacheFileName[0])
+  {
+    /*-
+     *******************************************************************
+     *
+     * A cache that doesn't exist yet can't be expanded. It will be
+     * created relative to the current directory when the run ends.
+     *
+     *******************************************************************
+     */
+    if (SupportGetFileType(psProperties->acMagicCacheFileName, acLocalError) != FTIMES_FILETYPE_ERROR)
+    {
+      iError = SupportExpandPath(psProperties->acMagicCacheFileName, psProperties->acMagicCacheFileName, FTIMES_MAX_PATH, 0, acLocalError);
+      if (iError != ER_OK)
+      {
+        snprintf(pcError, MESSAGE_SIZE, "%s: %s", acRoutine, acLocalError);
+        return ER_XMagic;
+      }
+    }
+    psProperties->psXMagicCache = XMagicLoadCache(psProperties->acMagicCacheFileName, psProperties->acMagicHash, acLocalError);
+    if (psProperties->psXMagicCache == NULL)
+    {
+      snprintf(acMessage, MESSAGE_SIZE, "%s: %s", acRoutine, acLocalError);
+      ErrorHandler(ER_Warning, acMessage, ERROR_WARNING);
+      psProperties->psXMagicCache = XMagicNewCache(psProperties->acMagicHash, acLocalError);
+      if (psProperties->psXMagicCache == NULL)
+      {
+        snprintf(pcError, MESSAGE_SIZE, "%s: %s", acRoutine, acLocalError);
+        return ER_XMagic;
+      }
+    }
+    psProperties->psXMagicCache->iReach = XMagicGetReach(psProperties->psXMagic);
+  }
+
   return ER_OK;
 }
 
@@ -1045,12 +1099,22 @@ AnalyzeDoXMagic(unsigned char *pucBuffer, int iBufferLength, int iBlockTag, int
   char                acLocalError[MESSAGE_SIZE] = "";
   char                acMessage[MESSAGE_SIZE] = "";
   int                 iError = 0;
+  int                 iFileLength = 0;
   int                 iMemoryMapped = 0;
   int                 iMemoryMapSize = 0;
+#ifdef HAVE_PREAD
+  int                 iWindowLength = 0;
+  unsigned char      *pucWindow = NULL;
+#endif
+  char               *pcDescription = NULL;
+  unsigned char       aucDigest[XMAGIC_CACHE_DIGEST_SIZE];
   void               *pvMemoryMap = NULL;
   static int          iFirst = 1;
   static int          iMemoryMapEnable = 0;
+  static int          iReach = -1;
   static XMAGIC      *psXMagic = NULL;
+  static XMAGIC_CACHE *psXMagicCache = NULL;
+  APP_UI64            ui64Size = 0;
 
   /*-
    *********************************************************************
@@ -1064,15 +1128,18 @@ AnalyzeDoXMagic(unsigned char *pucBuffer, int iBufferLength, int iBlockTag, int
   {
     FTIMES_PROPERTIES *psProperties = FTimesGetPropertiesReference();
     psXMagic = psProperties->psXMagic;
+    psXMagicCache = psProperties->psXMagicCache;
     iMemoryMapEnable = psProperties->iMemoryMapEnable;
+    iReach = XMagicGetReach(psXMagic);
     iFirst = 0;
   }
 
   /*-
    *********************************************************************
    *
-   * XMagic tests are only done once -- either on the first block or
-   * on a memory mapped view of the file.
+   * XMagic tests are only done once -- either on the first block, on
+   * a memory mapped view of the file, or on a window that extends the
+   * first block out to the magic's reach.
    *
    *********************************************************************
    */
@@ -1084,41 +1151,98 @@ AnalyzeDoXMagic(unsigned char *pucBuffer, int iBufferLength, int iBlockTag, int
   /*-
    *********************************************************************
    *
-   * Conditionally map the file into memory. If the file's size is
-   * zero, do not attempt to map it as this will lead to EINVAL errors
-   * on some platforms -- either for mmap() or munmap(). If the memory
-   * can't be mapped for whatever reason, fallback to using the block
-   * of data provided by the caller.
+   * Determine how much of the file the magic is allowed to see. This
+   * is the file's size, but it is capped at FTIMES_MAX_MMAP_SIZE. If
+   * the size is zero (e.g., a device or a proc file), just use the
+   * block of data provided by the caller.
    *
    *********************************************************************
    */
-  if (iMemoryMapEnable)
-  {
 #ifdef WINNT
-    if (psFTFileData->dwFileSizeHigh == 0 && psFTFileData->dwFileSizeLow < FTIMES_MAX_MMAP_SIZE)
-    {
-      iMemoryMapSize = psFTFileData->dwFileSizeLow;
-    }
+  ui64Size = (((APP_UI64) psFTFileData->dwFileSizeHigh) << 32) | psFTFileData->dwFileSizeLow;
 #else
-    if (psFTFileData->sStatEntry.st_size < FTIMES_MAX_MMAP_SIZE)
-    {
-      iMemoryMapSize = psFTFileData->sStatEntry.st_size;
-    }
+  ui64Size = (APP_UI64) psFTFileData->sStatEntry.st_size;
 #endif
-    else
+  iFileLength = (ui64Size < (APP_UI64) FTIMES_MAX_MMAP_SIZE) ? (int) ui64Size : FTIMES_MAX_MMAP_SIZE;
+
+  /*-
+   *********************************************************************
+   *
+   * The first block is a window onto the start of the file. If every
+   * byte that the magic can reach falls within that window, test it
+   * directly -- there is no need to map or read anything else. Note
+   * that the window only starts at offset zero when no start offset
+   * was specified.
+   *
+   *********************************************************************
+   */
+  if (gui64StartOffset == 0 && (iFileLength <= iBufferLength || (iReach >= 0 && iReach <= iBufferLength)))
+  {
+    if (iFileLength > 0)
     {
-      iMemoryMapSize = FTIMES_MAX_MMAP_SIZE;
+      iBufferLength = iFileLength;
     }
-    if (iMemoryMapSize > 0 && (pvMemoryMap = AnalyzeMapMemory(iMemoryMapSize)) != NULL)
+  }
+
+  /*-
+   *********************************************************************
+   *
+   * Otherwise, conditionally map the file into memory. Pages are only
+   * faulted in as the magic touches them, so far offsets don't cost a
+   * full read. If the file's size is zero, do not attempt to map it as
+   * this will lead to EINVAL errors on some platforms -- either for
+   * mmap() or munmap(). If the memory can't be mapped for whatever
+   * reason, read the reachable part of the file through the existing
+   * descriptor, or fallback to using the block of data provided by the
+   * caller.
+   *
+   *********************************************************************
+   */
+  else if (iMemoryMapEnable && iFileLength > 0 && (pvMemoryMap = AnalyzeMapMemory(iFileLength)) != NULL)
+  {
+    pucBuffer = (unsigned char *) pvMemoryMap;
+    iBufferLength = iMemoryMapSize = iFileLength;
+    iMemoryMapped = 1;
+  }
+#ifdef HAVE_PREAD
+  else if (gui64StartOffset == 0 && iReach >= 0)
+  {
+    pucWindow = AnalyzeReadXMagicWindow(pucBuffer, iBufferLength, (iReach < iFileLength) ? iReach : iFileLength, &iWindowLength, acLocalError);
+    if (pucWindow == NULL)
     {
-      pucBuffer = (unsigned char *) pvMemoryMap;
-      iBufferLength = iMemoryMapSize;
-      iMemoryMapped = 1;
+      snprintf(pcError, MESSAGE_SIZE, "%s: %s", acRoutine, acLocalError);
+      return ER_XMagic;
     }
+    pucBuffer = pucWindow;
+    iBufferLength = (iWindowLength < iReach) ? iWindowLength : iFileLength;
   }
+#endif
   snprintf(acMessage, MESSAGE_SIZE, "AnalysisStage=XMagic MemoryMapped=%d BufferLength=%d", iMemoryMapped, iBufferLength);
   MessageHandler(MESSAGE_FLUSH_IT, MESSAGE_DEBUGGER, MESSAGE_DEBUGGER_STRING, acMessage);
 
+  /*-
+   *********************************************************************
+   *
+   * If a result cache is active, and this content has been seen
+   * before, reuse the prior description.
+   *
+   *********************************************************************
+   */
+  if (psXMagicCache != NULL && iBufferLength > 0)
+  {
+    pcDescription = XMagicLookupCache(psXMagicCache, ui64Size, pucBuffer, iBufferLength, aucDigest);
+    if (pcDescription != NULL)
+    {
+      snprintf(psFTFileData->acType, FTIMES_FILETYPE_BUFSIZE, "%s", pcDescription);
+      psFTFileData->ulAttributeMask |= MAP_MAGIC;
+      if (iMemoryMapped)
+      {
+        AnalyzeUnmapMemory(pvMemoryMap, iMemoryMapSize);
+      }
+      return ER_OK;
+    }
+  }
+
   /*-
    *********************************************************************
    *
@@ -1137,6 +1261,23 @@ AnalyzeDoXMagic(unsigned char *pucBuffer, int iBufferLength, int iBlockTag, int
     return ER_XMagic;
   }
   psFTFileData->ulAttributeMask |= MAP_MAGIC;
+
+  /*-
+   *********************************************************************
+   *
+   * Remember the result. A failure here only costs a future lookup.
+   *
+   *********************************************************************
+   */
+  if (psXMagicCache != NULL && iBufferLength > 0)
+  {
+    iError = XMagicInsertCache(psXMagicCache, ui64Size, iBufferLength, aucDigest, psFTFileData->acType, acLocalError);
+    if (iError != ER_OK)
+    {
+      snprintf(acMessage, MESSAGE_SIZE, "%s: %s", acRoutine, acLocalError);
+      ErrorHandler(ER_Warning, acMessage, ERROR_WARNING);
+    }
+  }
   if (iMemoryMapped)
   {
     AnalyzeUnmapMemory(pvMemoryMap, iMemoryMapSize);
@@ -1193,6 +1334,81 @@ AnalyzeMapMemory(int iMemoryMapSize)
 }
 
 
+/*-
+ ***********************************************************************
+ *
+ * AnalyzeReadXMagicWindow
+ *
+ ***********************************************************************
+ */
+#if defined(USE_XMAGIC) && defined(HAVE_PREAD)
+unsigned char *
+AnalyzeReadXMagicWindow(unsigned char *pucBlock, int iBlockLength, int iWindowSize, int *piWindowLength, char *pcError)
+{
+  const char          acRoutine[] = "AnalyzeReadXMagicWindow()";
+  int                 iNRead = 0;
+  int                 iOffset = 0;
+  unsigned char      *pucTemp = NULL;
+  static int          iBufferSize = 0;
+  static unsigned char *pucBuffer = NULL;
+
+  /*-
+   *********************************************************************
+   *
+   * Grow the window as needed. This memory should not be freed --
+   * i.e., it should remain active until the program exits.
+   *
+   *********************************************************************
+   */
+  if (iWindowSize > iBufferSize)
+  {
+    pucTemp = realloc(pucBuffer, iWindowSize);
+    if (pucTemp == NULL)
+    {
+      snprintf(pcError, MESSAGE_SIZE, "%s: realloc(): %s", acRoutine, strerror(errno));
+      return NULL;
+    }
+    pucBuffer = pucTemp;
+    iBufferSize = iWindowSize;
+  }
+
+  /*-
+   *********************************************************************
+   *
+   * Start with the block that was already read, and then fetch the
+   * rest of the window through the open descriptor. Use pread() so
+   * that the stream's file position is not disturbed. A short read
+   * simply yields a short window.
+   *
+   *********************************************************************
+   */
+  iOffset = (iBlockLength < iWindowSize) ? iBlockLength : iWindowSize;
+  memcpy(pucBuffer, pucBlock, iOffset);
+  while (iOffset < iWindowSize)
+  {
+    iNRead = pread(giFile, &pucBuffer[iOffset], iWindowSize - iOffset, (off_t) iOffset);
+    if (iNRead < 0)
+    {
+      if (errno == EINTR)
+      {
+        continue;
+      }
+      snprintf(pcError, MESSAGE_SIZE, "%s: pread(): %s", acRoutine, strerror(errno));
+      return NULL;
+    }
+    if (iNRead == 0)
+    {
+      break;
+    }
+    iOffset += iNRead;
+  }
+  *piWindowLength = iOffset;
+
+  return pucBuffer;
+}
+#endif
+
+
 /*-
  ***********************************************************************
  *
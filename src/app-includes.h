@@ -76,6 +76,10 @@ typedef unsigned int APP_UI32;
 #include "xmagic.h"
 #endif
 
+#ifdef USE_ZLIB
+#include "gzip.h"
+#endif
+
 #ifdef USE_AP_SNPRINTF
 #include "ap_snprintf.h"
 #define snprintf ap_snprintf
@@ -89,8 +93,8 @@ typedef unsigned int APP_UI32;
 #include "sha1.h"
 #include "sha256.h"
 
-#include "compare.h"
 #include "decode.h"
+#include "compare.h"
 #include "dig.h"
 #include "fsinfo.h"
 #include "socket.h"
@@ -20,6 +20,358 @@
  */
 static CMP_PROPERTIES *gpsCmpProperties;
 
+/*-
+ ***********************************************************************
+ *
+ * NOTE: The field order in this table must exactly match the order in
+ *       gasCmpMaskTable (mask.c). Key layouts rely on this.
+ *
+ ***********************************************************************
+ */
+static CMP_KEY_TABLE  gasCmpKeyTable[] = {
+  { CMP_KEY_TYPE_STRING,  MD5_HASH_SIZE    }, /* name */
+  { CMP_KEY_TYPE_DECIMAL, 8                }, /* dev */
+  { CMP_KEY_TYPE_DECIMAL, 8                }, /* inode */
+  { CMP_KEY_TYPE_DECIMAL, 4                }, /* volume */
+  { CMP_KEY_TYPE_DECIMAL, 8                }, /* findex */
+  { CMP_KEY_TYPE_OCTAL,   4                }, /* mode */
+  { CMP_KEY_TYPE_DECIMAL, 4                }, /* attributes */
+  { CMP_KEY_TYPE_DECIMAL, 4                }, /* nlink */
+  { CMP_KEY_TYPE_DECIMAL, 4                }, /* uid */
+  { CMP_KEY_TYPE_DECIMAL, 4                }, /* gid */
+  { CMP_KEY_TYPE_DECIMAL, 8                }, /* rdev */
+  { CMP_KEY_TYPE_TIME,    4                }, /* atime */
+  { CMP_KEY_TYPE_DECIMAL, 4                }, /* ams */
+  { CMP_KEY_TYPE_TIME,    4                }, /* mtime */
+  { CMP_KEY_TYPE_DECIMAL, 4                }, /* mms */
+  { CMP_KEY_TYPE_TIME,    4                }, /* ctime */
+  { CMP_KEY_TYPE_DECIMAL, 4                }, /* cms */
+  { CMP_KEY_TYPE_TIME,    4                }, /* chtime */
+  { CMP_KEY_TYPE_DECIMAL, 4                }, /* chms */
+  { CMP_KEY_TYPE_DECIMAL, 8                }, /* size */
+  { CMP_KEY_TYPE_DECIMAL, 4                }, /* altstreams */
+  { CMP_KEY_TYPE_DIGEST,  MD5_HASH_SIZE    }, /* md5 */
+  { CMP_KEY_TYPE_DIGEST,  SHA1_HASH_SIZE   }, /* sha1 */
+  { CMP_KEY_TYPE_DIGEST,  SHA256_HASH_SIZE }, /* sha256 */
+  { CMP_KEY_TYPE_STRING,  MD5_HASH_SIZE    }, /* magic */
+  { CMP_KEY_TYPE_STRING,  MD5_HASH_SIZE    }, /* osid */
+  { CMP_KEY_TYPE_STRING,  MD5_HASH_SIZE    }, /* gsid */
+  { CMP_KEY_TYPE_STRING,  MD5_HASH_SIZE    }, /* dacl */
+};
+#define CMP_KEY_TABLE_SIZE sizeof(gasCmpKeyTable) / sizeof(gasCmpKeyTable[0])
+
+/*-
+ ***********************************************************************
+ *
+ * CompareBuildKey
+ *
+ ***********************************************************************
+ */
+int
+CompareBuildKey(CMP_PROPERTIES *psProperties, int k, char *pc, APP_UI32 *pui32Key)
+{
+  static int          aiDaysBeforeMonth[] = { 0, 31, 59, 90, 120, 151, 181, 212, 243, 273, 304, 334, 365 };
+  int                 i = psProperties->aiKeyFields[k];
+  int                 j = 0;
+  int                 n = 0;
+  int                 iDays = 0;
+  int                 iLeap = 0;
+  int                 iNibble = 0;
+  int                 aiTime[6];
+  unsigned char      *puc = NULL;
+  APP_UI64            ui64 = 0;
+
+  /*-
+   *********************************************************************
+   *
+   * Convert one decoded field into its fixed-width binary key. Keys
+   * are built from 32-bit words, and each field takes only as many
+   * words as its table entry calls for. Numbers are stored in one or
+   * two words, and times are stored as seconds since the epoch in one
+   * word. Digests are stored as raw bytes followed by a tag word that
+   * marks the DIRECTORY, SYMLINK, and SPECIAL placeholders. Free-form
+   * text is reduced to its MD5 hash. Any value that is not in its
+   * canonical form or does not fit in its key causes this routine to
+   * fail.
+   *
+   *********************************************************************
+   */
+  switch (gasCmpKeyTable[i].iType)
+  {
+  case CMP_KEY_TYPE_DECIMAL:
+    if (pc[0] == '0' && pc[1] != 0)
+    {
+      return ER;
+    }
+    for (n = 0, ui64 = 0; pc[n] >= '0' && pc[n] <= '9'; n++)
+    {
+      if (n >= 19)
+      {
+        return ER;
+      }
+      ui64 = (ui64 * 10) + (pc[n] - '0');
+    }
+    if (pc[n] != 0)
+    {
+      return ER;
+    }
+    if (gasCmpKeyTable[i].iSize == 4)
+    {
+      if (ui64 > 0xffffffff)
+      {
+        return ER;
+      }
+      pui32Key[0] = (APP_UI32) ui64;
+    }
+    else
+    {
+      pui32Key[0] = (APP_UI32) (ui64 & 0xffffffff);
+      pui32Key[1] = (APP_UI32) (ui64 >> 32);
+    }
+    break;
+  case CMP_KEY_TYPE_OCTAL:
+    if (pc[0] == '0' && pc[1] != 0)
+    {
+      return ER;
+    }
+    for (n = 0, ui64 = 0; pc[n] >= '0' && pc[n] <= '7'; n++)
+    {
+      if (n >= 11)
+      {
+        return ER;
+      }
+      ui64 = (ui64 << 3) | (pc[n] - '0');
+    }
+    if (pc[n] != 0 || ui64 > 0xffffffff)
+    {
+      return ER;
+    }
+    pui32Key[0] = (APP_UI32) ui64;
+    break;
+  case CMP_KEY_TYPE_TIME:
+    for (n = 0, j = 0, aiTime[0] = 0; n < DECODE_TIME_FORMAT_SIZE - 1; n++)
+    {
+      switch (n)
+      {
+      case 4:
+      case 7:
+        if (pc[n] != '-')
+        {
+          return ER;
+        }
+        aiTime[++j] = 0;
+        break;
+      case 10:
+        if (pc[n] != ' ')
+        {
+          return ER;
+        }
+        aiTime[++j] = 0;
+        break;
+      case 13:
+      case 16:
+        if (pc[n] != ':')
+        {
+          return ER;
+        }
+        aiTime[++j] = 0;
+        break;
+      default:
+        if (pc[n] < '0' || pc[n] > '9')
+        {
+          return ER;
+        }
+        aiTime[j] = (aiTime[j] * 10) + (pc[n] - '0');
+        break;
+      }
+    }
+    if (pc[n] != 0)
+    {
+      return ER;
+    }
+    /*-
+     *******************************************************************
+     *
+     * Only accept dates that exist and whose seconds since the epoch
+     * fit in 32 bits. This keeps the mapping from text to key one to
+     * one. Anything else is left to the textual comparison.
+     *
+     *******************************************************************
+     */
+    iLeap = ((aiTime[0] % 4) == 0 && (aiTime[0] % 100) != 0) || (aiTime[0] % 400) == 0;
+    if
+    (
+         aiTime[0] < 1970
+      || aiTime[0] > 2105
+      || aiTime[1] < 1
+      || aiTime[1] > 12
+      || aiTime[2] < 1
+      || aiTime[2] > aiDaysBeforeMonth[aiTime[1]] - aiDaysBeforeMonth[aiTime[1] - 1] + ((aiTime[1] == 2) ? iLeap : 0)
+      || aiTime[3] > 23
+      || aiTime[4] > 59
+      || aiTime[5] > 59
+    )
+    {
+      return ER;
+    }
+    n = aiTime[0] - 1;
+    iDays = (365 * (aiTime[0] - 1970)) + ((n / 4) - (n / 100) + (n / 400)) - ((1969 / 4) - (1969 / 100) + (1969 / 400));
+    iDays += aiDaysBeforeMonth[aiTime[1] - 1] + ((aiTime[1] > 2) ? iLeap : 0) + aiTime[2] - 1;
+    pui32Key[0] = ((APP_UI32) iDays * 86400) + (aiTime[3] * 3600) + (aiTime[4] * 60) + aiTime[5];
+    break;
+  case CMP_KEY_TYPE_DIGEST:
+    n = psProperties->aiKeyOffsets[k + 1] - psProperties->aiKeyOffsets[k] - 1; /* This is the index of the tag word. */
+    if (strcmp(pc, "DIRECTORY") == 0)
+    {
+      pui32Key[n] = 1;
+    }
+    else if (strcmp(pc, "SYMLINK") == 0)
+    {
+      pui32Key[n] = 2;
+    }
+    else if (strcmp(pc, "SPECIAL") == 0)
+    {
+      pui32Key[n] = 3;
+    }
+    else
+    {
+      puc = (unsigned char *) pui32Key;
+      for (j = 0; j < gasCmpKeyTable[i].iSize * 2; j++)
+      {
+        if (pc[j] >= '0' && pc[j] <= '9')
+        {
+          iNibble = pc[j] - '0';
+        }
+        else if (pc[j] >= 'a' && pc[j] <= 'f')
+        {
+          iNibble = (pc[j] - 'a') + 10;
+        }
+        else
+        {
+          return ER;
+        }
+        puc[j / 2] = (j % 2) ? (puc[j / 2] | iNibble) : (iNibble << 4);
+      }
+      if (pc[j] != 0)
+      {
+        return ER;
+      }
+    }
+    break;
+  case CMP_KEY_TYPE_STRING:
+    MD5HashString((unsigned char *) pc, strlen(pc), (unsigned char *) pui32Key);
+    break;
+  default:
+    return ER;
+    break;
+  }
+
+  return ER_OK;
+}
+
+
+/*-
+ ***********************************************************************
+ *
+ * CompareBuildKeys
+ *
+ ***********************************************************************
+ */
+int
+CompareBuildKeys(CMP_PROPERTIES *psProperties, char **ppcFields, APP_UI32 *pui32Keys, unsigned long *pulDefinedMask, unsigned long *pulInvalidMask)
+{
+  char               *pc = NULL;
+  int                 i = 0;
+  int                 j = 0;
+  int                 k = 0;
+  unsigned long       ul = 0;
+
+  /*-
+   *********************************************************************
+   *
+   * Convert each decoded field in the compare mask into a binary key.
+   * An empty field is left undefined so that it can be reported as
+   * unknown. A field that is not in its canonical form is marked as
+   * invalid, and its key must not be used. Such a field can't be equal
+   * to any canonical value, so it only needs to be compared as text if
+   * the other side is invalid too. If any field is invalid, this
+   * routine fails.
+   *
+   *********************************************************************
+   */
+  *pulDefinedMask = 0;
+  *pulInvalidMask = 0;
+  for (k = 0; k < psProperties->iKeyFieldCount; k++)
+  {
+    i = psProperties->aiKeyFields[k];
+    for (j = psProperties->aiKeyOffsets[k]; j < psProperties->aiKeyOffsets[k + 1]; j++)
+    {
+      pui32Keys[j] = 0;
+    }
+    pc = ppcFields[i];
+    if (pc[0] == 0)
+    {
+      continue; /* It's not an error if a value is missing. */
+    }
+    ul = 1 << i;
+    *pulDefinedMask |= ul;
+    if (CompareBuildKey(psProperties, k, pc, &pui32Keys[psProperties->aiKeyOffsets[k]]) != ER_OK)
+    {
+      *pulInvalidMask |= ul;
+    }
+  }
+
+  return (*pulInvalidMask) ? ER : ER_OK;
+}
+
+
+/*-
+ ***********************************************************************
+ *
+ * CompareComputeMasks
+ *
+ ***********************************************************************
+ */
+void
+CompareComputeMasks(CMP_PROPERTIES *psProperties, APP_UI32 *pui32BaselineKeys, unsigned long ulBaselineDefinedMask, APP_UI32 *pui32SnapshotKeys, unsigned long ulSnapshotDefinedMask, CMP_DATA *psData)
+{
+  APP_UI32            aui32Deltas[CMP_MAX_KEY_WORDS];
+  APP_UI32            ui32Delta = 0;
+  int                 j = 0;
+  int                 k = 0;
+  unsigned long       ulChangedMask = 0;
+  unsigned long       ulDefinedMask = ulBaselineDefinedMask & ulSnapshotDefinedMask;
+
+  /*-
+   *********************************************************************
+   *
+   * XOR the two key vectors as one flat array of words. This loop has
+   * no branches or cross-word dependencies, so the compiler is free to
+   * vectorize it. Then, fold the words that belong to each field into
+   * a single changed bit without branching. A field is changed only
+   * if it is defined on both sides; otherwise, it is unknown.
+   *
+   *********************************************************************
+   */
+  for (j = 0; j < psProperties->iKeyWordCount; j++)
+  {
+    aui32Deltas[j] = pui32BaselineKeys[j] ^ pui32SnapshotKeys[j];
+  }
+
+  for (k = 0; k < psProperties->iKeyFieldCount; k++)
+  {
+    for (j = psProperties->aiKeyOffsets[k], ui32Delta = 0; j < psProperties->aiKeyOffsets[k + 1]; j++)
+    {
+      ui32Delta |= aui32Deltas[j];
+    }
+    ulChangedMask |= ((unsigned long) ((ui32Delta | (0 - ui32Delta)) >> 31)) << psProperties->aiKeyFields[k];
+  }
+
+  psData->ulChangedMask = ulChangedMask & ulDefinedMask;
+  psData->ulUnknownMask = psProperties->psCompareMask->ulMask & ~ulDefinedMask;
+}
+
+
 /*-
  ***********************************************************************
  *
@@ -31,80 +383,72 @@ int
 CompareDecodeLine(char *pcLine, SNAPSHOT_CONTEXT *psBaseline, char **ppcDecodeFields, char *pcError)
 {
   const char          acRoutine[] = "CompareDecodeLine()";
-  char                acTempLine[CMP_MAX_LINE] = { 0 };
+  static char        *pcTempLine = NULL;
+  static int          iTempSize = 0;
+  char               *pc = NULL;
   char               *pcHead = NULL;
   char               *pcTail = NULL;
   int                 i = 0;
   int                 iDone = 0;
-  int                 iFound = 0;
   int                 iField = 0;
   int                 iLength = 0;
   int                 iMaskTableLength = MaskGetTableLength(MASK_MASK_TYPE_CMP);
-  unsigned long       ul = 0;
 
   /*-
    *********************************************************************
    *
-   * Terminate each output field.
+   * Point each output field at an empty string.
    *
    *********************************************************************
    */
   for (i = 0; i < iMaskTableLength; i++)
   {
-    ppcDecodeFields[i][0] = 0;
+    ppcDecodeFields[i] = "";
   }
 
   /*-
    *********************************************************************
    *
-   * Check the line's length.
+   * Make a working copy of the line. The copy is kept in a buffer
+   * that is reused from call to call, and it is grown as needed, so
+   * lines are not limited in length.
    *
    *********************************************************************
    */
   iLength = strlen(pcLine);
-  if (iLength > CMP_MAX_LINE - 1)
+  if (iLength + 1 > iTempSize)
   {
-    snprintf(pcError, MESSAGE_SIZE, "%s: Length = [%d]: Length exceeds %d bytes.", acRoutine, iLength, CMP_MAX_LINE - 1);
-    return ER;
+    pc = realloc(pcTempLine, ((((iLength + 1) / CMP_MAX_LINE) + 1) * CMP_MAX_LINE));
+    if (pc == NULL)
+    {
+      snprintf(pcError, MESSAGE_SIZE, "%s: realloc(): %s", acRoutine, strerror(errno));
+      return ER;
+    }
+    pcTempLine = pc;
+    iTempSize = (((iLength + 1) / CMP_MAX_LINE) + 1) * CMP_MAX_LINE;
   }
-  snprintf(acTempLine, CMP_MAX_LINE, "%s", pcLine);
+  memcpy(pcTempLine, pcLine, iLength + 1);
 
   /*-
    *********************************************************************
    *
-   * Parse data, and make a copy of each specified field.
+   * Split the copy in place, and point each specified field at its
+   * value. Fields beyond those declared in the header are ignored.
    *
    *********************************************************************
    */
-  for (pcHead = pcTail = acTempLine, iDone = iField = 0; !iDone; pcHead = ++pcTail, iField++)
+  for (pcHead = pcTempLine, iDone = iField = 0; !iDone; pcHead = pcTail + 1, iField++)
   {
-    while (*pcTail != CMP_SEPARATOR_C && *pcTail != 0)
-    {
-      pcTail++;
-    }
-    if (*pcTail == 0)
+    pcTail = memchr(pcHead, CMP_SEPARATOR_C, &pcTempLine[iLength] - pcHead);
+    if (pcTail == NULL)
     {
+      pcTail = &pcTempLine[iLength];
       iDone = 1;
     }
-    else
+    *pcTail = 0;
+    if (iField < psBaseline->iFieldCount)
     {
-      *pcTail = 0;
-    }
-    for (i = 0, iFound = -1; i < iMaskTableLength; i++)
-    {
-      ul = 1 << i;
-      if (MASK_BIT_IS_SET(psBaseline->ulFieldMask, ul))
-      {
-        iFound++;
-      }
-      if (iFound == iField)
-      {
-        break;
-      }
-    }
-    if (i != iMaskTableLength)
-    {
-      snprintf(ppcDecodeFields[psBaseline->aiIndex2Map[iField]], CMP_MAX_LINE, "%s", pcHead);
+      ppcDecodeFields[psBaseline->aiIndex2Map[iField]] = pcHead;
     }
   }
 
@@ -127,7 +471,9 @@ CompareEnumerateChanges(SNAPSHOT_CONTEXT *psBaseline, SNAPSHOT_CONTEXT *psSnapsh
   char              **ppcBaselineFields = NULL;
   char              **ppcSnapshotFields = NULL;
   CMP_DATA            sCompareData;
+  CMP_NODE           *psNode = NULL;
   CMP_PROPERTIES     *psProperties = CompareGetPropertiesReference();
+  APP_UI32            aui32SnapshotKeys[CMP_MAX_KEY_WORDS];
   int                 iLastIndex = 0;
   int                 iTempIndex = 0;
   int                 i = 0;
@@ -136,33 +482,24 @@ CompareEnumerateChanges(SNAPSHOT_CONTEXT *psBaseline, SNAPSHOT_CONTEXT *psSnapsh
   int                 iKeysIndex = 0;
   int                 iMaskTableLength = MaskGetTableLength(MASK_MASK_TYPE_CMP);
   unsigned long       ul = 0;
+  unsigned long       ulSnapshotDefinedMask = 0;
+  unsigned long       ulSnapshotInvalidMask = 0;
 
   /*-
    *********************************************************************
    *
-   * Allocate enough memory to hold one complete baseline record broken
-   * down into individual fields and stored in an array.
+   * Allocate an array of field pointers. CompareDecodeLine() points
+   * these at the fields of one baseline record at a time.
    *
    *********************************************************************
    */
-/* FIXME Move this code to a subroutine. Add logic to free this memory when it's no longer required. */
-  ppcBaselineFields = (char **) malloc(iMaskTableLength * sizeof(char **));
+  ppcBaselineFields = (char **) calloc(iMaskTableLength, sizeof(char **));
   if (ppcBaselineFields == NULL)
   {
-    snprintf(pcError, MESSAGE_SIZE, "%s: malloc(): %s", acRoutine, strerror(errno));
+    snprintf(pcError, MESSAGE_SIZE, "%s: calloc(): %s", acRoutine, strerror(errno));
     return ER;
   }
 
-  for (i = 0; i < iMaskTableLength; i++)
-  {
-    ppcBaselineFields[i] = (char *) malloc(CMP_MAX_LINE);
-    if (ppcBaselineFields[i] == NULL)
-    {
-      snprintf(pcError, MESSAGE_SIZE, "%s: malloc(): %s", acRoutine, strerror(errno));
-      return ER;
-    }
-  }
-
   /*-
    *********************************************************************
    *
@@ -216,35 +553,73 @@ CompareEnumerateChanges(SNAPSHOT_CONTEXT *psBaseline, SNAPSHOT_CONTEXT *psSnapsh
     iLastIndex = iTempIndex = psProperties->aiBaselineKeys[iKeysIndex];
     while (iTempIndex != -1)
     {
-      if (memcmp(psProperties->psBaselineNodes[iTempIndex].aucHash, psSnapshot->psCurrRecord->aucHash, MD5_HASH_SIZE) == 0)
+      psNode = &psProperties->psBaselineNodes[iTempIndex];
+      if (memcmp(psNode->aucHash, psSnapshot->psCurrRecord->aucHash, MD5_HASH_SIZE) == 0)
       {
         iFound++;
-        if (++psProperties->psBaselineNodes[iTempIndex].iFound > 1)
+        if (++psNode->iFound > 1)
         {
           snprintf(pcError, MESSAGE_SIZE, "%s: File = [%s], Line = [%d]: Hash collision. Check for duplicate filenames.", acRoutine, psSnapshot->pcFile, psSnapshot->iLineNumber);
           return ER;
         }
-        CompareDecodeLine(psProperties->psBaselineNodes[iTempIndex].pcData, psBaseline, ppcBaselineFields, acLocalError);
-        sCompareData.ulChangedMask = 0;
-        sCompareData.ulUnknownMask = 0;
-        sCompareData.iBaselineRecord = psProperties->psBaselineNodes[iTempIndex].iLineNumber;
-        for (i = 0; i < iMaskTableLength; i++)
+        sCompareData.iBaselineRecord = psNode->iLineNumber;
+
+        /*-
+         ***************************************************************
+         *
+         * Compare binary keys whenever the baseline record has them.
+         * Snapshot fields that are not in canonical form can't equal
+         * their (canonical) baseline counterparts, so they are changed
+         * if both sides are defined. Baseline records holding values
+         * that are not in canonical form are compared field by field
+         * as text.
+         *
+         ***************************************************************
+         */
+        CompareBuildKeys(psProperties, ppcSnapshotFields, aui32SnapshotKeys, &ulSnapshotDefinedMask, &ulSnapshotInvalidMask);
+        if (psNode->iKeysValid)
         {
-          ul = 1 << i;
-          if (MASK_BIT_IS_SET(psProperties->psCompareMask->ulMask, ul))
+          CompareComputeMasks
+          (
+            psProperties,
+            &psProperties->pui32BaselineKeys[iTempIndex * psProperties->iKeyWordCount],
+            psNode->ulDefinedMask,
+            aui32SnapshotKeys,
+            ulSnapshotDefinedMask,
+            &sCompareData
+          );
+          sCompareData.ulChangedMask |= ulSnapshotInvalidMask & psNode->ulDefinedMask;
+          sCompareData.pcRecord = psNode->pcData; /* This is the quoted name, and that's all CompareWriteRecord() needs. */
+        }
+        else
+        {
+          iError = CompareDecodeLine(psNode->pcData, psBaseline, ppcBaselineFields, acLocalError);
+          if (iError != ER_OK)
           {
-            if (ppcBaselineFields[i][0] != 0 && ppcSnapshotFields[i][0] != 0)
+            snprintf(pcError, MESSAGE_SIZE, "%s: File = [%s], Line = [%d]: %s", acRoutine, psBaseline->pcFile, psNode->iLineNumber, acLocalError);
+            return ER;
+          }
+          sCompareData.ulChangedMask = 0;
+          sCompareData.ulUnknownMask = 0;
+          for (i = 0; i < iMaskTableLength; i++)
+          {
+            ul = 1 << i;
+            if (MASK_BIT_IS_SET(psProperties->psCompareMask->ulMask, ul))
             {
-              if (strcmp(ppcBaselineFields[i], ppcSnapshotFields[i]) != 0)
+              if (ppcBaselineFields[i][0] != 0 && ppcSnapshotFields[i][0] != 0)
               {
-                sCompareData.ulChangedMask |= ul;
+                if (strcmp(ppcBaselineFields[i], ppcSnapshotFields[i]) != 0)
+                {
+                  sCompareData.ulChangedMask |= ul;
+                }
+              }
+              else
+              {
+                sCompareData.ulUnknownMask |= ul;
               }
-            }
-            else
-            {
-              sCompareData.ulUnknownMask |= ul;
             }
           }
+          sCompareData.pcRecord = ppcBaselineFields[0];
         }
         if (sCompareData.ulChangedMask && !sCompareData.ulUnknownMask)
         {
@@ -261,7 +636,6 @@ CompareEnumerateChanges(SNAPSHOT_CONTEXT *psBaseline, SNAPSHOT_CONTEXT *psSnapsh
           sCompareData.cCategory = 'X';
           psProperties->ulCrossed++;
         }
-        sCompareData.pcRecord = ppcBaselineFields[0];
         break;
       }
       iLastIndex = iTempIndex;
@@ -284,6 +658,7 @@ CompareEnumerateChanges(SNAPSHOT_CONTEXT *psBaseline, SNAPSHOT_CONTEXT *psSnapsh
       return ER;
     }
   }
+  free(ppcBaselineFields);
   if (ferror(psSnapshot->pFile))
   {
     snprintf(pcError, MESSAGE_SIZE, "%s: File = [%s], Line = [%d]: %s", acRoutine, psSnapshot->pcFile, psSnapshot->iLineNumber, acLocalError);
@@ -325,34 +700,6 @@ CompareEnumerateChanges(SNAPSHOT_CONTEXT *psBaseline, SNAPSHOT_CONTEXT *psSnapsh
 }
 
 
-/*-
- ***********************************************************************
- *
- * CompareFreeNodeData
- *
- ***********************************************************************
- */
-void
-CompareFreeNodeData(int *piKeys, CMP_NODE *psNodes)
-{
-  int                 iKeysIndex = 0;
-  int                 iNodeIndex = 0;
-
-  for (iKeysIndex = 0; iKeysIndex < CMP_MODULUS; iKeysIndex++)
-  {
-    iNodeIndex = piKeys[iKeysIndex];
-    while (iNodeIndex != -1)
-    {
-      if (psNodes[iNodeIndex].pcData)
-      {
-        free(psNodes[iNodeIndex].pcData);
-      }
-      iNodeIndex = psNodes[iNodeIndex].iNextIndex;
-    }
-  }
-}
-
-
 /*-
  ***********************************************************************
  *
@@ -371,27 +718,23 @@ CompareFreeProperties(CMP_PROPERTIES *psProperties)
     }
     if (psProperties->psBaselineNodes != NULL)
     {
-      /*-
-       *****************************************************************
-       * NOTE: CompareFreeNodeData() should be used to free this data,
-       * but it causes severe cleanup lag (e.g., it takes more time to
-       * free the data than it did to compare it) on some systems such
-       * as FreeBSD for large jobs (~700K+ records). Therefore, the
-       * following code has been disabled, and it is being kept as a
-       * reminder. Other systems such as Linux and Solaris didn't have
-       * this problem, so there may be other issues involved that are
-       * not yet understood. However, since the program is essentially
-       * terminal at this point, the risk of not doing this seems low.
-       *
-       * if (!psProperties->iMemoryMapFile)
-       * {
-       *   CompareFreeNodeData(psProperties->aiBaselineKeys, psProperties->psBaselineNodes);
-       * }
-       *
-       *****************************************************************
-       */
       free(psProperties->psBaselineNodes);
     }
+    /*-
+     *******************************************************************
+     *
+     * Node data lives in arena slabs, so it's released with a handful
+     * of free() calls rather than one per record. This avoids the
+     * severe cleanup lag that per-record frees caused on some systems
+     * (e.g., FreeBSD) for large jobs (~700K+ records).
+     *
+     *******************************************************************
+     */
+    DecodeFreeArena(&psProperties->sBaselineArena);
+    if (psProperties->pui32BaselineKeys != NULL)
+    {
+      free(psProperties->pui32BaselineKeys);
+    }
     free(psProperties);
   }
 }
@@ -544,15 +887,20 @@ CompareLoadBaselineData(SNAPSHOT_CONTEXT *psBaseline, char *pcError)
   const char          acRoutine[] = "CompareLoadBaselineData()";
   char                acLocalError[MESSAGE_SIZE] = "";
   char               *pcData = NULL;
+  CMP_NODE           *psNode = NULL;
   CMP_PROPERTIES     *psProperties = CompareGetPropertiesReference();
   FILE               *pFile = NULL;
   int                 i = 0;
   int                 n = 0;
   int                 iError = 0;
+  int                 iFieldCount = 0;
   int                 iNodeCount = 0;
   int                 iNodeIndex = 0;
   int                 iOffset = 0;
   int                *piNodeIndex = NULL;
+  int                 aiLengths[DECODE_FIELD_COUNT];
+  DECODE_BUFFER       sScratch = { NULL, 0, 0 };
+  unsigned long       ulInvalidMask = 0;
 #ifdef WINNT
   HANDLE              hFile = NULL;
   HANDLE              hMemoryMap = NULL;
@@ -560,6 +908,22 @@ CompareLoadBaselineData(SNAPSHOT_CONTEXT *psBaseline, char *pcError)
   int                 iFile = 0;
 #endif
 
+  /*-
+   *********************************************************************
+   *
+   * Lay out the binary compare keys. This must be done here because
+   * the compare mask isn't final until both snapshots have been
+   * opened and their headers have been parsed.
+   *
+   *********************************************************************
+   */
+  iError = CompareSetKeyLayout(psProperties, acLocalError);
+  if (iError != ER_OK)
+  {
+    snprintf(pcError, MESSAGE_SIZE, "%s: %s", acRoutine, acLocalError);
+    return ER;
+  }
+
   /*-
    *********************************************************************
    *
@@ -644,98 +1008,136 @@ CompareLoadBaselineData(SNAPSHOT_CONTEXT *psBaseline, char *pcError)
     /*-
      *******************************************************************
      *
-     * Allocate a block of memory to hold this record. Then, join the
-     * fields to form a single record. If a memory map file is being
-     * used, this memory is freed as soon as it has been written out
-     * the file. Otherwise it is freed later in CompareFreeNodeData().
+     * Check node count, and allocate more, if necessary.
      *
      *******************************************************************
      */
-    for (i = n = 0; i < psBaseline->iFieldCount; i++)
-    {
-      n += strlen(psBaseline->psCurrRecord->ppcFields[psBaseline->aiIndex2Map[i]]);
-    }
-    pcData = malloc(n + i + 1); /* The value for i represents the number of delimiters needed. */
-    if (pcData == NULL)
-    {
-      snprintf(pcError, MESSAGE_SIZE, "%s: malloc(): File = [%s], Line = [%d]: %s", acRoutine, psBaseline->pcFile, psBaseline->iLineNumber, strerror(errno));
-      return ER;
-    }
-    for (i = n = 0; i < psBaseline->iFieldCount; i++)
+    if (iNodeIndex >= iNodeCount)
     {
-      n += sprintf(&pcData[n], "%s%s", (i > 0) ? DECODE_SEPARATOR_S : "", psBaseline->psCurrRecord->ppcFields[psBaseline->aiIndex2Map[i]]);
+      iNodeCount += CMP_NODE_REQUEST_COUNT;
+      psProperties->psBaselineNodes = (CMP_NODE *) realloc(psProperties->psBaselineNodes, (iNodeCount * sizeof(CMP_NODE)));
+      if (psProperties->psBaselineNodes == NULL)
+      {
+        snprintf(pcError, MESSAGE_SIZE, "%s: realloc(): File = [%s], Line = [%d]: %s", acRoutine, psBaseline->pcFile, psBaseline->iLineNumber, strerror(errno));
+        return ER;
+      }
+      if (psProperties->iKeyWordCount > 0)
+      {
+        psProperties->pui32BaselineKeys = (APP_UI32 *) realloc(psProperties->pui32BaselineKeys, (iNodeCount * psProperties->iKeyWordCount * sizeof(APP_UI32)));
+        if (psProperties->pui32BaselineKeys == NULL)
+        {
+          snprintf(pcError, MESSAGE_SIZE, "%s: realloc(): File = [%s], Line = [%d]: %s", acRoutine, psBaseline->pcFile, psBaseline->iLineNumber, strerror(errno));
+          return ER;
+        }
+      }
     }
 
     /*-
      *******************************************************************
      *
-     * Conditionally write this record out to the backing file.
+     * Insert a new node. Abort on a collision.
      *
      *******************************************************************
      */
-    if (psProperties->iMemoryMapFile)
+    piNodeIndex = CompareGetNodeIndexReference(psBaseline->psCurrRecord->aucHash, psProperties->aiBaselineKeys, psProperties->psBaselineNodes);
+    if (piNodeIndex == NULL)
     {
-      iError = SupportWriteData(pFile, pcData, n + 1, acLocalError);
-      if (iError != ER_OK)
-      {
-        snprintf(pcError, MESSAGE_SIZE, "%s: %s", acRoutine, acLocalError);
-        return ER;
-      }
-      free(pcData);
+      snprintf(pcError, MESSAGE_SIZE, "%s: File = [%s], Line = [%d]: Hash collision. Check for duplicate filenames.", acRoutine, psBaseline->pcFile, psBaseline->iLineNumber);
+      return ER;
     }
+    *piNodeIndex = iNodeIndex;
+    psNode = &psProperties->psBaselineNodes[iNodeIndex];
+    psNode->iNextIndex = -1;
+    memcpy(psNode->aucHash, psBaseline->psCurrRecord->aucHash, MD5_HASH_SIZE);
+    iError = CompareBuildKeys
+    (
+      psProperties,
+      psBaseline->psCurrRecord->ppcFields,
+      &psProperties->pui32BaselineKeys[iNodeIndex * psProperties->iKeyWordCount],
+      &psNode->ulDefinedMask,
+      &ulInvalidMask
+    );
+    psNode->iKeysValid = (iError == ER_OK) ? 1 : 0;
 
     /*-
      *******************************************************************
      *
-     * Check node count, and allocate more, if necessary.
+     * Reserve a block of memory to hold this record's data. If the
+     * record has valid keys, its fields are never compared as text, so
+     * only the quoted name (i.e., the first field) is kept. Otherwise,
+     * join the fields to form a single record. If a memory map file is
+     * being used, a scratch buffer is reused for each record since the
+     * data is written out to the file. Otherwise, the data is carved
+     * out of the baseline arena, which stores records back to back in
+     * large slabs. This avoids per-record malloc() overhead, and the
+     * arena is released all at once in CompareFreeProperties().
      *
      *******************************************************************
      */
-    if (iNodeIndex >= iNodeCount)
+    iFieldCount = (psNode->iKeysValid) ? 1 : psBaseline->iFieldCount;
+    for (i = n = 0; i < iFieldCount; i++)
     {
-      iNodeCount += CMP_NODE_REQUEST_COUNT;
-      psProperties->psBaselineNodes = (CMP_NODE *) realloc(psProperties->psBaselineNodes, (iNodeCount * sizeof(CMP_NODE)));
-      if (psProperties->psBaselineNodes == NULL)
+      aiLengths[i] = strlen(psBaseline->psCurrRecord->ppcFields[psBaseline->aiIndex2Map[i]]);
+      n += aiLengths[i];
+    }
+    n += i; /* The value for i represents the number of delimiters needed (including the terminator). */
+    if (psProperties->iMemoryMapFile)
+    {
+      sScratch.iLength = 0;
+      iError = DecodeAppendBuffer(&sScratch, NULL, n, acLocalError);
+      pcData = (iError == ER_OK) ? sScratch.pcData : NULL;
+    }
+    else
+    {
+      pcData = DecodeAllocateFromArena(&psProperties->sBaselineArena, n, acLocalError);
+    }
+    if (pcData == NULL)
+    {
+      snprintf(pcError, MESSAGE_SIZE, "%s: File = [%s], Line = [%d]: %s", acRoutine, psBaseline->pcFile, psBaseline->iLineNumber, acLocalError);
+      return ER;
+    }
+    for (i = n = 0; i < iFieldCount; i++)
+    {
+      if (i > 0)
       {
-        snprintf(pcError, MESSAGE_SIZE, "%s: realloc(): File = [%s], Line = [%d]: %s", acRoutine, psBaseline->pcFile, psBaseline->iLineNumber, strerror(errno));
-        return ER;
+        pcData[n++] = DECODE_SEPARATOR_C;
       }
+      memcpy(&pcData[n], psBaseline->psCurrRecord->ppcFields[psBaseline->aiIndex2Map[i]], aiLengths[i]);
+      n += aiLengths[i];
     }
+    pcData[n] = 0;
 
     /*-
      *******************************************************************
      *
-     * Insert a new node. Abort on a collision.
+     * Conditionally write this record out to the backing file.
      *
      *******************************************************************
      */
-    piNodeIndex = CompareGetNodeIndexReference(psBaseline->psCurrRecord->aucHash, psProperties->aiBaselineKeys, psProperties->psBaselineNodes);
-    if (piNodeIndex == NULL)
+/* FIXME See TODO list. */
+    psNode->iLineNumber = psBaseline->iLineNumber;
+    if (psProperties->iMemoryMapFile)
     {
-      snprintf(pcError, MESSAGE_SIZE, "%s: File = [%s], Line = [%d]: Hash collision. Check for duplicate filenames.", acRoutine, psBaseline->pcFile, psBaseline->iLineNumber);
-      return ER;
+      iError = SupportWriteData(pFile, pcData, n + 1, acLocalError);
+      if (iError != ER_OK)
+      {
+        snprintf(pcError, MESSAGE_SIZE, "%s: %s", acRoutine, acLocalError);
+        return ER;
+      }
+      psNode->pcData = NULL;
+      psNode->iOffset = iOffset;
+      iOffset += n + 1;
     }
     else
     {
-      *piNodeIndex = iNodeIndex;
-      psProperties->psBaselineNodes[*piNodeIndex].iNextIndex = -1;
-      memcpy(psProperties->psBaselineNodes[*piNodeIndex].aucHash, psBaseline->psCurrRecord->aucHash, MD5_HASH_SIZE);
-/* FIXME See TODO list. */
-      if (psProperties->iMemoryMapFile)
-      {
-        psProperties->psBaselineNodes[*piNodeIndex].pcData = NULL;
-        psProperties->psBaselineNodes[*piNodeIndex].iLineNumber = psBaseline->iLineNumber;
-        psProperties->psBaselineNodes[*piNodeIndex].iOffset = iOffset;
-        iOffset += n + 1;
-      }
-      else
-      {
-        psProperties->psBaselineNodes[*piNodeIndex].pcData = pcData;
-        psProperties->psBaselineNodes[*piNodeIndex].iLineNumber = psBaseline->iLineNumber;
-        psProperties->psBaselineNodes[*piNodeIndex].iOffset = 0;
-      }
-      iNodeIndex++;
+      psNode->pcData = pcData;
+      psNode->iOffset = 0;
     }
+    iNodeIndex++;
+  }
+  if (sScratch.pcData != NULL)
+  {
+    free(sScratch.pcData);
   }
   if (ferror(psBaseline->pFile))
   {
@@ -847,6 +1249,61 @@ CompareNewProperties(char *pcError)
 }
 
 
+/*-
+ ***********************************************************************
+ *
+ * CompareSetKeyLayout
+ *
+ ***********************************************************************
+ */
+int
+CompareSetKeyLayout(CMP_PROPERTIES *psProperties, char *pcError)
+{
+  const char          acRoutine[] = "CompareSetKeyLayout()";
+  int                 i = 0;
+  int                 k = 0;
+  int                 iMaskTableLength = MaskGetTableLength(MASK_MASK_TYPE_CMP);
+  int                 iWordCount = 0;
+  unsigned long       ul = 0;
+
+  if (iMaskTableLength != (int)(CMP_KEY_TABLE_SIZE) || iMaskTableLength > CMP_KEY_FIELD_COUNT)
+  {
+    snprintf(pcError, MESSAGE_SIZE, "%s: MaskTableLength = [%d] != [%d]: Key table mismatch. That shouldn't happen.", acRoutine, iMaskTableLength, (int)(CMP_KEY_TABLE_SIZE));
+    return ER;
+  }
+
+  /*-
+   *********************************************************************
+   *
+   * Assign each field in the compare mask a fixed slot in the key. The
+   * slots are contiguous so that a pair of keys can be compared as two
+   * flat arrays of words.
+   *
+   *********************************************************************
+   */
+  for (i = k = 0; i < iMaskTableLength; i++)
+  {
+    ul = 1 << i;
+    if (MASK_BIT_IS_SET(psProperties->psCompareMask->ulMask, ul))
+    {
+      psProperties->aiKeyFields[k] = i;
+      psProperties->aiKeyOffsets[k] = iWordCount;
+      iWordCount += (gasCmpKeyTable[i].iSize + 3) / 4;
+      if (gasCmpKeyTable[i].iType == CMP_KEY_TYPE_DIGEST)
+      {
+        iWordCount++; /* Add 1 for the tag word. */
+      }
+      k++;
+    }
+  }
+  psProperties->aiKeyOffsets[k] = iWordCount;
+  psProperties->iKeyFieldCount = k;
+  psProperties->iKeyWordCount = iWordCount;
+
+  return ER_OK;
+}
+
+
 /*-
  ***********************************************************************
  *
@@ -965,6 +1422,7 @@ CompareWriteRecord(CMP_PROPERTIES *psProperties, CMP_DATA *psData, char *pcError
   const char          acRoutine[] = "CompareWriteRecord()";
   static char        *pcOutput = NULL;
   static int          iMaskTableLength = 0;
+  static int          iNameSize = CMP_MAX_LINE;
   static MASK_B2S_TABLE *pasMaskTable = NULL;
   char                acLocalError[MESSAGE_SIZE] = "";
   char               *pc = NULL;
@@ -981,7 +1439,7 @@ CompareWriteRecord(CMP_PROPERTIES *psProperties, CMP_DATA *psData, char *pcError
    * this operation once. Note that this memory is never freed.
    *
    * category      1
-   * name          CMP_MAX_LINE
+   * name          CMP_MAX_LINE (grown below for longer names)
    * changed       (iMaskTableLength * (MASK_NAME_SIZE))
    * unknown       (iMaskTableLength * (MASK_NAME_SIZE))
    * records       (2 * (FTIMES_MAX_32BIT_SIZE))
@@ -994,7 +1452,7 @@ CompareWriteRecord(CMP_PROPERTIES *psProperties, CMP_DATA *psData, char *pcError
   {
     iMaskTableLength = MaskGetTableLength(MASK_MASK_TYPE_CMP);
     pasMaskTable = MaskGetTableReference(MASK_MASK_TYPE_CMP);
-    pcOutput = malloc(CMP_MAX_LINE + (2 * (iMaskTableLength * (MASK_NAME_SIZE))) + (2 * (FTIMES_MAX_32BIT_SIZE)) + 6);
+    pcOutput = malloc(iNameSize + (2 * (iMaskTableLength * (MASK_NAME_SIZE))) + (2 * (FTIMES_MAX_32BIT_SIZE)) + 6);
     if (pcOutput == NULL)
     {
       snprintf(pcError, MESSAGE_SIZE, "%s: malloc(): %s", acRoutine, strerror(errno));
@@ -1038,6 +1496,16 @@ CompareWriteRecord(CMP_PROPERTIES *psProperties, CMP_DATA *psData, char *pcError
     snprintf(pcError, MESSAGE_SIZE, "%s: Name = [%s]: Name is not quoted. That shouldn't happen.", acRoutine, psData->pcRecord);
     return ER;
   }
+  if (pc - psData->pcRecord + 1 > iNameSize)
+  {
+    iNameSize = ((((pc - psData->pcRecord + 1)) / CMP_MAX_LINE) + 1) * CMP_MAX_LINE;
+    pcOutput = realloc(pcOutput, iNameSize + (2 * (iMaskTableLength * (MASK_NAME_SIZE))) + (2 * (FTIMES_MAX_32BIT_SIZE)) + 6);
+    if (pcOutput == NULL)
+    {
+      snprintf(pcError, MESSAGE_SIZE, "%s: realloc(): %s", acRoutine, strerror(errno));
+      return ER;
+    }
+  }
   pcOutput[iIndex++] = CMP_SEPARATOR_C;
   for (i = 0; i <= pc - psData->pcRecord; i++)
   {
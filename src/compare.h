@@ -30,6 +30,13 @@
 #define CMP_MAX_LINE                      8192
 #define CMP_MODULUS                     (1<<16)
 #define CMP_HASH_MASK         ((CMP_MODULUS)-1)
+#define CMP_KEY_FIELD_COUNT                 32
+#define CMP_KEY_TYPE_DECIMAL                 1
+#define CMP_KEY_TYPE_DIGEST                  2
+#define CMP_KEY_TYPE_OCTAL                   3
+#define CMP_KEY_TYPE_STRING                  4
+#define CMP_KEY_TYPE_TIME                    5
+#define CMP_MAX_KEY_WORDS ((CMP_KEY_FIELD_COUNT)*(((SHA256_HASH_SIZE)/4)+1))
 #define CMP_NODE_REQUEST_COUNT          200000
 #define CMP_SEPARATOR_C                     '|'
 #define CMP_SEPARATOR_S                     "|"
@@ -51,14 +58,22 @@ typedef struct _CMP_DATA
   unsigned long       ulUnknownMask;
 } CMP_DATA;
 
+typedef struct _CMP_KEY_TABLE
+{
+  int                 iType;
+  int                 iSize;
+} CMP_KEY_TABLE;
+
 typedef struct _CMP_NODE
 {
   unsigned char       aucHash[MD5_HASH_SIZE];
   char               *pcData;
   int                 iFound;
+  int                 iKeysValid;
   int                 iLineNumber;
   int                 iNextIndex;
   int                 iOffset;
+  unsigned long       ulDefinedMask;
 } CMP_NODE;
 
 typedef struct _CMP_PROPERTIES
@@ -66,8 +81,13 @@ typedef struct _CMP_PROPERTIES
   char                acNewLine[NEWLINE_LENGTH];
   char               *pcMemoryMapFile;
   CMP_NODE           *psBaselineNodes;
+  DECODE_ARENA        sBaselineArena;
   FILE               *pFileOut;
   int                 aiBaselineKeys[CMP_MODULUS];
+  int                 aiKeyFields[CMP_KEY_FIELD_COUNT];
+  int                 aiKeyOffsets[CMP_KEY_FIELD_COUNT + 1];
+  int                 iKeyFieldCount;
+  int                 iKeyWordCount;
   int                 iMemoryMapFile;
   int                 iMemoryMapSize;
   MASK_USS_MASK      *psCompareMask;
@@ -79,6 +99,7 @@ typedef struct _CMP_PROPERTIES
   unsigned long       ulUnknown;
   unsigned long       ulCrossed;
   void               *pvMemoryMap;
+  APP_UI32           *pui32BaselineKeys;
 } CMP_PROPERTIES;
 
 /*-
@@ -97,9 +118,11 @@ typedef struct _CMP_PROPERTIES
  *
  ***********************************************************************
  */
+int                 CompareBuildKey(CMP_PROPERTIES *psProperties, int k, char *pc, APP_UI32 *pui32Key);
+int                 CompareBuildKeys(CMP_PROPERTIES *psProperties, char **ppcFields, APP_UI32 *pui32Keys, unsigned long *pulDefinedMask, unsigned long *pulInvalidMask);
+void                CompareComputeMasks(CMP_PROPERTIES *psProperties, APP_UI32 *pui32BaselineKeys, unsigned long ulBaselineDefinedMask, APP_UI32 *pui32SnapshotKeys, unsigned long ulSnapshotDefinedMask, CMP_DATA *psData);
 //int               CompareDecodeLine(char *pcLine, SNAPSHOT_CONTEXT *psBaseline, char **ppcDecodeFields, char *pcError); /* This is declared in ftimes.h */
 //int               CompareEnumerateChanges(SNAPSHOT_CONTEXT *psBaseline, SNAPSHOT_CONTEXT *psSnapshot, char *pcError); /* This is declared in ftimes.h */
-void                CompareFreeNodeData(int *piKeys, CMP_NODE *psNodes);
 void                CompareFreeProperties(CMP_PROPERTIES *psProperties);
 int                 CompareGetChangedCount(void);
 int                 CompareGetCrossedCount(void);
@@ -111,6 +134,7 @@ int                 CompareGetRecordCount(void);
 int                 CompareGetUnknownCount(void);
 //int               CompareLoadBaselineData(SNAPSHOT_CONTEXT *psBaseline, char *pcError); /* This is declared in ftimes.h */
 CMP_PROPERTIES     *CompareNewProperties(char *pcError);
+int                 CompareSetKeyLayout(CMP_PROPERTIES *psProperties, char *pcError);
 void                CompareSetNewLine(char *pcNewLine);
 void                CompareSetNodeData(int *piKeys, CMP_NODE *psNodes, void *pvBaseAddress);
 void                CompareSetOutputStream(FILE *pFile);
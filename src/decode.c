@@ -233,6 +233,94 @@ Decode64BitHexToDecimal(char *pcData, int iLength, APP_UI64 *pui64ValueNew, APP_
 }
 
 
+/*-
+ ***********************************************************************
+ *
+ * DecodeAllocateFromArena
+ *
+ ***********************************************************************
+ */
+char *
+DecodeAllocateFromArena(DECODE_ARENA *psArena, int iLength, char *pcError)
+{
+  const char          acRoutine[] = "DecodeAllocateFromArena()";
+  char               *pc = NULL;
+  DECODE_ARENA_SLAB  *psSlab = NULL;
+  int                 iSize = 0;
+
+  /*-
+   *********************************************************************
+   *
+   * Carve the request out of the current slab. If it doesn't fit, put
+   * a new slab at the head of the list. Requests that are larger than
+   * a slab get a slab of their own. Memory is never returned to the
+   * arena piecemeal -- the whole arena is released at once.
+   *
+   *********************************************************************
+   */
+  psSlab = psArena->psSlabs;
+  if (psSlab == NULL || psSlab->iLength + iLength > psSlab->iSize)
+  {
+    iSize = (iLength > DECODE_ARENA_SLAB_SIZE) ? iLength : DECODE_ARENA_SLAB_SIZE;
+    psSlab = (DECODE_ARENA_SLAB *) malloc(sizeof(DECODE_ARENA_SLAB) + iSize);
+    if (psSlab == NULL)
+    {
+      snprintf(pcError, MESSAGE_SIZE, "%s: malloc(): %s", acRoutine, strerror(errno));
+      return NULL;
+    }
+    psSlab->iLength = 0;
+    psSlab->iSize = iSize;
+    psSlab->psNext = psArena->psSlabs;
+    psArena->psSlabs = psSlab;
+  }
+  pc = (char *) (psSlab + 1) + psSlab->iLength;
+  psSlab->iLength += iLength;
+  psArena->ui64Allocated += (APP_UI64) iLength;
+
+  return pc;
+}
+
+
+/*-
+ ***********************************************************************
+ *
+ * DecodeAppendBuffer
+ *
+ ***********************************************************************
+ */
+int
+DecodeAppendBuffer(DECODE_BUFFER *psBuffer, char *pcData, int iLength, char *pcError)
+{
+  const char          acRoutine[] = "DecodeAppendBuffer()";
+  char               *pc = NULL;
+  int                 iSize = 0;
+
+  if (psBuffer->iLength + iLength > psBuffer->iSize)
+  {
+    iSize = (psBuffer->iSize > 0) ? psBuffer->iSize : DECODE_READ_BUFSIZE;
+    while (iSize < psBuffer->iLength + iLength)
+    {
+      iSize *= 2;
+    }
+    pc = (char *) realloc(psBuffer->pcData, iSize);
+    if (pc == NULL)
+    {
+      snprintf(pcError, MESSAGE_SIZE, "%s: realloc(): %s", acRoutine, strerror(errno));
+      return ER;
+    }
+    psBuffer->pcData = pc;
+    psBuffer->iSize = iSize;
+  }
+  if (pcData != NULL)
+  {
+    memcpy(&psBuffer->pcData[psBuffer->iLength], pcData, iLength);
+    psBuffer->iLength += iLength;
+  }
+
+  return ER_OK;
+}
+
+
 /*-
  ***********************************************************************
  *
@@ -257,6 +345,163 @@ DecodeBuildFromBase64Table(void)
 }
 
 
+/*-
+ ***********************************************************************
+ *
+ * DecodeBuildIndex
+ *
+ ***********************************************************************
+ */
+int
+DecodeBuildIndex(SNAPSHOT_CONTEXT *psSnapshot, char *pcIndexFile, char *pcError)
+{
+  const char          acRoutine[] = "DecodeBuildIndex()";
+  char                acLocalError[MESSAGE_SIZE] = "";
+  DECODE_INDEX_ENTRY *psEntries = NULL;
+  DECODE_INDEX_ENTRY *psEntry = NULL;
+  DECODE_INDEX_ENTRY *psTempEntries = NULL;
+  FILE               *pFile = NULL;
+  APP_UI32            ui32SyncLine = 0;
+  APP_UI64            ui64Count = 0;
+  APP_UI64            ui64Entry = 0;
+  APP_UI64            ui64Size = 0;
+  APP_UI64            ui64SyncOffset = 0;
+  int                 iCheckpoint = 0;
+  int                 iError = 0;
+  unsigned char       aucHeader[DECODE_INDEX_HEADER_SIZE];
+  unsigned long       ulSize = 0;
+
+  /*-
+   *********************************************************************
+   *
+   * Read and parse each record, and note where it starts along with
+   * the location of the record that must be decoded first in order
+   * to reconstruct it (i.e., its sync point). Uncompressed records
+   * are their own sync points. Compressed records are synchronized
+   * to the most recent checkpoint. Records that fail to parse are
+   * skipped in the same way that DecodeReadSnapshot() skips them.
+   *
+   *********************************************************************
+   */
+  if (psSnapshot->iGzipped)
+  {
+    snprintf(pcError, MESSAGE_SIZE, "%s: File = [%s]: Gzip compressed snapshots can not be indexed.", acRoutine, psSnapshot->pcFile);
+    return ER;
+  }
+
+  while (DecodeReadLine(psSnapshot, acLocalError) != NULL)
+  {
+    psSnapshot->sDecodeStats.ulAnalyzed++;
+    iCheckpoint = (!psSnapshot->iCompressed || strncmp(psSnapshot->psCurrRecord->pcLine, DECODE_CHECKPOINT_STRING, DECODE_CHECKPOINT_LENGTH) == 0) ? 1 : 0;
+    iError = DecodeParseRecord(psSnapshot, acLocalError);
+    if (iError != ER_OK)
+    {
+      if (psSnapshot->iCompressed)
+      {
+        psSnapshot->iSkipToNext = TRUE;
+      }
+      psSnapshot->sDecodeStats.ulSkipped++;
+      continue;
+    }
+    if (iCheckpoint)
+    {
+      ui64SyncOffset = psSnapshot->psCurrRecord->ui64Offset;
+      ui32SyncLine = (APP_UI32) psSnapshot->iLineNumber;
+    }
+    if (ui64Count >= (APP_UI64) ulSize)
+    {
+      ulSize = (ulSize == 0) ? 0x10000 : ulSize * 2;
+      psTempEntries = (DECODE_INDEX_ENTRY *) realloc(psEntries, ulSize * sizeof(DECODE_INDEX_ENTRY));
+      if (psTempEntries == NULL)
+      {
+        snprintf(pcError, MESSAGE_SIZE, "%s: realloc(): %s", acRoutine, strerror(errno));
+        free(psEntries);
+        return ER;
+      }
+      psEntries = psTempEntries;
+    }
+    psEntry = &psEntries[ui64Count++];
+    memcpy(psEntry->aucHash, psSnapshot->psCurrRecord->aucHash, MD5_HASH_SIZE);
+    psEntry->ui64Offset = psSnapshot->psCurrRecord->ui64Offset;
+    psEntry->ui64SyncOffset = ui64SyncOffset;
+    psEntry->ui32Line = (APP_UI32) psSnapshot->iLineNumber;
+    psEntry->ui32SyncLine = ui32SyncLine;
+    psSnapshot->sDecodeStats.ulDecoded++;
+  }
+  if (ferror(psSnapshot->pFile))
+  {
+    snprintf(pcError, MESSAGE_SIZE, "%s: File = [%s], Line = [%d]: %s", acRoutine, psSnapshot->pcFile, psSnapshot->iLineNumber, acLocalError);
+    free(psEntries);
+    return ER;
+  }
+  ui64Size = psSnapshot->ui64ReadBase + psSnapshot->iReadLength;
+
+  /*-
+   *********************************************************************
+   *
+   * Sort the entries by name hash. Entries having the same hash are
+   * kept in snapshot order.
+   *
+   *********************************************************************
+   */
+  if (ui64Count > 0)
+  {
+    qsort(psEntries, (size_t) ui64Count, sizeof(DECODE_INDEX_ENTRY), DecodeCompareIndexEntries);
+  }
+
+  /*-
+   *********************************************************************
+   *
+   * Write the index. All numbers are stored in network byte order.
+   * The snapshot's size is recorded so that stale indexes can be
+   * detected at lookup time.
+   *
+   *********************************************************************
+   */
+  pFile = fopen(pcIndexFile, "wb");
+  if (pFile == NULL)
+  {
+    snprintf(pcError, MESSAGE_SIZE, "%s: fopen(): File = [%s]: %s", acRoutine, pcIndexFile, strerror(errno));
+    free(psEntries);
+    return ER;
+  }
+
+  memcpy(aucHeader, DECODE_INDEX_MAGIC, DECODE_INDEX_MAGIC_LENGTH);
+  DECODE_PACK_NUMBER(&aucHeader[8], DECODE_INDEX_VERSION, 4);
+  DECODE_PACK_NUMBER(&aucHeader[12], DECODE_INDEX_ENTRY_SIZE, 4);
+  DECODE_PACK_NUMBER(&aucHeader[16], ui64Count, 8);
+  DECODE_PACK_NUMBER(&aucHeader[24], ui64Size, 8);
+  if (fwrite(aucHeader, 1, DECODE_INDEX_HEADER_SIZE, pFile) != DECODE_INDEX_HEADER_SIZE)
+  {
+    snprintf(pcError, MESSAGE_SIZE, "%s: fwrite(): File = [%s]: %s", acRoutine, pcIndexFile, strerror(errno));
+    fclose(pFile);
+    free(psEntries);
+    return ER;
+  }
+
+  for (ui64Entry = 0; ui64Entry < ui64Count; ui64Entry++)
+  {
+    iError = DecodeWriteIndexEntry(pFile, &psEntries[ui64Entry], acLocalError);
+    if (iError != ER_OK)
+    {
+      snprintf(pcError, MESSAGE_SIZE, "%s: File = [%s]: %s", acRoutine, pcIndexFile, acLocalError);
+      fclose(pFile);
+      free(psEntries);
+      return ER;
+    }
+  }
+  free(psEntries);
+
+  if (fclose(pFile) != 0)
+  {
+    snprintf(pcError, MESSAGE_SIZE, "%s: fclose(): File = [%s]: %s", acRoutine, pcIndexFile, strerror(errno));
+    return ER;
+  }
+
+  return ER_OK;
+}
+
+
 /*-
  ***********************************************************************
  *
@@ -269,7 +514,7 @@ DecodeClearRecord(DECODE_RECORD *psRecord, int iFieldCount)
 {
   int                 i = 0;
 
-  psRecord->acLine[0] = 0;
+  psRecord->pcLine[0] = 0;
   psRecord->iLineLength = 0;
   for (i = 0; i < iFieldCount; i++)
   {
@@ -278,6 +523,193 @@ DecodeClearRecord(DECODE_RECORD *psRecord, int iFieldCount)
 }
 
 
+/*-
+ ***********************************************************************
+ *
+ * DecodeCompareIndexEntries
+ *
+ ***********************************************************************
+ */
+int
+DecodeCompareIndexEntries(const void *pvEntry1, const void *pvEntry2)
+{
+  DECODE_INDEX_ENTRY *psEntry1 = (DECODE_INDEX_ENTRY *) pvEntry1;
+  DECODE_INDEX_ENTRY *psEntry2 = (DECODE_INDEX_ENTRY *) pvEntry2;
+  int                 iResult = 0;
+
+  iResult = memcmp(psEntry1->aucHash, psEntry2->aucHash, MD5_HASH_SIZE);
+  if (iResult == 0)
+  {
+    iResult = (psEntry1->ui64Offset < psEntry2->ui64Offset) ? -1 : (psEntry1->ui64Offset > psEntry2->ui64Offset) ? 1 : 0;
+  }
+
+  return iResult;
+}
+
+
+/*-
+ ***********************************************************************
+ *
+ * DecodeFormatBinaryRecord
+ *
+ ***********************************************************************
+ */
+int
+DecodeFormatBinaryRecord(SNAPSHOT_CONTEXT *psSnapshot, unsigned char *pucRecord, int iLength, char *pcError)
+{
+  const char          acRoutine[] = "DecodeFormatBinaryRecord()";
+  static const char   acHexDigits[] = "0123456789abcdef";
+  char                acLocalError[MESSAGE_SIZE] = "";
+  char               *pcLine = NULL;
+  int                 i = 0;
+  int                 iError = 0;
+  int                 iField = 0;
+  int                 iLineLength = 0;
+  int                 iOffset = 0;
+  int                 n = 0;
+  time_t              tTime = 0;
+  unsigned char       ucTag = 0;
+  APP_UI64            ui64Value = 0;
+
+  /*-
+   *********************************************************************
+   *
+   * Render each tagged field in the same way that DevelopNormalOutput()
+   * would have. Numbers are stored as varints (times are zigzagged so
+   * that they may be negative), and digests are stored as raw bytes.
+   * No tagged field can expand to more than twice its encoded size
+   * plus a small constant, so that's how the line buffer is grown.
+   *
+   *********************************************************************
+   */
+  for (iField = 0; iOffset < iLength; iField++)
+  {
+    if (iField >= psSnapshot->iFieldCount)
+    {
+      snprintf(pcError, MESSAGE_SIZE, "%s: FieldCount = [%d] > [%d]: FieldCount exceeds expected value.", acRoutine, iField + 1, psSnapshot->iFieldCount);
+      return ER;
+    }
+    iError = DecodeGrowRecord(psSnapshot->psCurrRecord, iLineLength + (2 * (iLength - iOffset)) + 32, 0, acLocalError);
+    if (iError != ER_OK)
+    {
+      snprintf(pcError, MESSAGE_SIZE, "%s: %s", acRoutine, acLocalError);
+      return ER;
+    }
+    pcLine = psSnapshot->psCurrRecord->pcLine;
+    if (iField > 0)
+    {
+      pcLine[iLineLength++] = DECODE_SEPARATOR_C;
+    }
+    ucTag = pucRecord[iOffset++];
+    if (ucTag == DECODE_BINARY_TAG_NULL)
+    {
+      continue;
+    }
+    n = DecodeGetVarint(&pucRecord[iOffset], iLength - iOffset, &ui64Value);
+    if (n == ER)
+    {
+      snprintf(pcError, MESSAGE_SIZE, "%s: Field = [%d]: Truncated or invalid varint.", acRoutine, iField);
+      return ER;
+    }
+    iOffset += n;
+    switch (ucTag)
+    {
+    case DECODE_BINARY_TAG_DECIMAL:
+      iLineLength += DecodeFormatNumber(ui64Value, 10, &pcLine[iLineLength]);
+      break;
+    case DECODE_BINARY_TAG_OCTAL:
+      iLineLength += DecodeFormatNumber(ui64Value, 8, &pcLine[iLineLength]);
+      break;
+    case DECODE_BINARY_TAG_TIME:
+      tTime = (time_t) ((ui64Value & 1) ? ~(ui64Value >> 1) : (ui64Value >> 1));
+#ifdef WIN32
+      snprintf(pcError, MESSAGE_SIZE, "%s: Field = [%d]: Binary time values are not supported on this platform.", acRoutine, iField);
+      return ER;
+#else
+      if (TimeFormatTime(&tTime, &pcLine[iLineLength]) == ER_OK)
+      {
+        iLineLength += FTIMES_TIME_FORMAT_SIZE - 1;
+      }
+#endif
+      break;
+    case DECODE_BINARY_TAG_HEX:
+    case DECODE_BINARY_TAG_TEXT:
+    case DECODE_BINARY_TAG_QUOTED:
+      if (ui64Value > (APP_UI64) (iLength - iOffset))
+      {
+        snprintf(pcError, MESSAGE_SIZE, "%s: Field = [%d], Length = [%d]: Value overruns the record.", acRoutine, iField, (int) ui64Value);
+        return ER;
+      }
+      n = (int) ui64Value;
+      if (ucTag == DECODE_BINARY_TAG_HEX)
+      {
+        for (i = 0; i < n; i++)
+        {
+          pcLine[iLineLength++] = acHexDigits[(pucRecord[iOffset + i] >> 4) & 0x0f];
+          pcLine[iLineLength++] = acHexDigits[pucRecord[iOffset + i] & 0x0f];
+        }
+      }
+      else
+      {
+        if (ucTag == DECODE_BINARY_TAG_QUOTED)
+        {
+          pcLine[iLineLength++] = '"';
+        }
+        memcpy(&pcLine[iLineLength], &pucRecord[iOffset], n);
+        iLineLength += n;
+        if (ucTag == DECODE_BINARY_TAG_QUOTED)
+        {
+          pcLine[iLineLength++] = '"';
+        }
+      }
+      iOffset += n;
+      break;
+    default:
+      snprintf(pcError, MESSAGE_SIZE, "%s: Field = [%d], Tag = [%d]: Unknown field tag.", acRoutine, iField, (int) ucTag);
+      return ER;
+      break;
+    }
+  }
+  if (iField != psSnapshot->iFieldCount)
+  {
+    snprintf(pcError, MESSAGE_SIZE, "%s: FieldCount = [%d] != [%d]: FieldCount mismatch!", acRoutine, iField, psSnapshot->iFieldCount);
+    return ER;
+  }
+  psSnapshot->psCurrRecord->pcLine[iLineLength] = 0;
+
+  return iLineLength;
+}
+
+
+/*-
+ ***********************************************************************
+ *
+ * DecodeFormatNumber
+ *
+ ***********************************************************************
+ */
+int
+DecodeFormatNumber(APP_UI64 ui64Value, int iBase, char *pcOutput)
+{
+  char                acDigits[DECODE_BINARY_VARINT_SIZE * 3];
+  int                 i = 0;
+  int                 n = 0;
+
+  do
+  {
+    acDigits[i++] = (char) ('0' + (ui64Value % iBase));
+    ui64Value /= iBase;
+  } while (ui64Value != 0);
+
+  while (i > 0)
+  {
+    pcOutput[n++] = acDigits[--i];
+  }
+
+  return n;
+}
+
+
 /*-
  ***********************************************************************
  *
@@ -390,35 +822,79 @@ DecodeFormatTime(APP_UI32 *pui32Time, char *pcTime)
 /*-
  ***********************************************************************
  *
- * DecodeFreeSnapshotContext
+ * DecodeFreeArena
  *
  ***********************************************************************
  */
 void
-DecodeFreeSnapshotContext(SNAPSHOT_CONTEXT *psSnapshot)
+DecodeFreeArena(DECODE_ARENA *psArena)
 {
-  int                 i = 0;
-  int                 j = 0;
+  DECODE_ARENA_SLAB  *psSlab = NULL;
 
-  if (psSnapshot != NULL)
+  while (psArena->psSlabs != NULL)
   {
-    if (psSnapshot->psDecodeMap != NULL)
-    {
-      free(psSnapshot->psDecodeMap);
-    }
-    for (i = 0; i < DECODE_RECORD_COUNT; i++)
-    {
-      if (psSnapshot->asRecords[i].ppcFields != NULL)
-      {
-        for (j = 0; j < psSnapshot->iFieldCount; j++)
-        {
-          if (psSnapshot->asRecords[i].ppcFields[j] != NULL)
-          {
-            free(psSnapshot->asRecords[i].ppcFields[j]);
-          }
-        }
-        free(psSnapshot->asRecords[i].ppcFields);
-      }
+    psSlab = psArena->psSlabs;
+    psArena->psSlabs = psSlab->psNext;
+    free(psSlab);
+  }
+  psArena->ui64Allocated = 0;
+}
+
+
+/*-
+ ***********************************************************************
+ *
+ * DecodeFreeRecord
+ *
+ ***********************************************************************
+ */
+void
+DecodeFreeRecord(DECODE_RECORD *psRecord)
+{
+  if (psRecord->pcLine != NULL)
+  {
+    free(psRecord->pcLine);
+  }
+  if (psRecord->pcFieldData != NULL)
+  {
+    free(psRecord->pcFieldData);
+  }
+  if (psRecord->ppcFields != NULL)
+  {
+    free(psRecord->ppcFields);
+  }
+}
+
+
+/*-
+ ***********************************************************************
+ *
+ * DecodeFreeSnapshotContext
+ *
+ ***********************************************************************
+ */
+void
+DecodeFreeSnapshotContext(SNAPSHOT_CONTEXT *psSnapshot)
+{
+  int                 i = 0;
+
+  if (psSnapshot != NULL)
+  {
+    if (psSnapshot->psDecodeMap != NULL)
+    {
+      free(psSnapshot->psDecodeMap);
+    }
+    if (psSnapshot->pcReadBuffer != NULL)
+    {
+      free(psSnapshot->pcReadBuffer);
+    }
+    if (psSnapshot->sBinaryRecord.pcData != NULL)
+    {
+      free(psSnapshot->sBinaryRecord.pcData);
+    }
+    for (i = 0; i < DECODE_RECORD_COUNT; i++)
+    {
+      DecodeFreeRecord(&psSnapshot->asRecords[i]);
     }
     free(psSnapshot);
   }
@@ -436,7 +912,6 @@ void
 DecodeFreeSnapshotContext2(SNAPSHOT_CONTEXT *psSnapshot)
 {
   int                 i = 0;
-  int                 j = 0;
 
   if (psSnapshot != NULL)
   {
@@ -448,19 +923,17 @@ DecodeFreeSnapshotContext2(SNAPSHOT_CONTEXT *psSnapshot)
     {
       free(psSnapshot->psDecodeMap);
     }
+    if (psSnapshot->pcReadBuffer != NULL)
+    {
+      free(psSnapshot->pcReadBuffer);
+    }
+    if (psSnapshot->sBinaryRecord.pcData != NULL)
+    {
+      free(psSnapshot->sBinaryRecord.pcData);
+    }
     for (i = 0; i < DECODE_RECORD_COUNT; i++)
     {
-      if (psSnapshot->asRecords[i].ppcFields != NULL)
-      {
-        for (j = 0; j < psSnapshot->iFieldCount; j++)
-        {
-          if (psSnapshot->asRecords[i].ppcFields[j] != NULL)
-          {
-            free(psSnapshot->asRecords[i].ppcFields[j]);
-          }
-        }
-        free(psSnapshot->asRecords[i].ppcFields);
-      }
+      DecodeFreeRecord(&psSnapshot->asRecords[i]);
     }
     free(psSnapshot);
   }
@@ -505,6 +978,76 @@ DecodeGetBase64Hash(char *pcData, unsigned char *pucHash, int iLength, char *pcE
 }
 
 
+/*-
+ ***********************************************************************
+ *
+ * DecodeGetFileHandle
+ *
+ ***********************************************************************
+ */
+FILE *
+DecodeGetFileHandle(SNAPSHOT_CONTEXT *psSnapshot, char *pcError)
+{
+  const char          acRoutine[] = "DecodeGetFileHandle()";
+  char                acLocalError[MESSAGE_SIZE] = "";
+  FILE               *pFile = NULL;
+#ifdef USE_ZLIB
+  FILE               *pGzipFile = NULL;
+#endif
+  int                 iByte = 0;
+
+  pFile = SupportGetFileHandle(psSnapshot->pcFile, acLocalError);
+  if (pFile == NULL)
+  {
+    snprintf(pcError, MESSAGE_SIZE, "%s: %s", acRoutine, acLocalError);
+    return NULL;
+  }
+
+  /*-
+   *********************************************************************
+   *
+   * Peek at the first byte. Snapshots always begin with a header line,
+   * so a gzip magic byte means the file was written with output
+   * compression enabled. In that case, read through a decompressor.
+   *
+   *********************************************************************
+   */
+  psSnapshot->iGzipped = 0;
+  iByte = getc(pFile);
+  if (iByte == EOF)
+  {
+    return pFile;
+  }
+  ungetc(iByte, pFile);
+  if (iByte == DECODE_GZIP_MAGIC)
+  {
+#ifdef USE_ZLIB
+    pGzipFile = GzipNewReadStream(pFile, acLocalError);
+    if (pGzipFile == NULL)
+    {
+      snprintf(pcError, MESSAGE_SIZE, "%s: %s", acRoutine, acLocalError);
+      if (pFile != stdin)
+      {
+        fclose(pFile);
+      }
+      return NULL;
+    }
+    psSnapshot->iGzipped = 1;
+    return pGzipFile;
+#else
+    snprintf(pcError, MESSAGE_SIZE, "%s: Snapshot appears to be gzip compressed, but zlib support was not enabled in this build.", acRoutine);
+    if (pFile != stdin)
+    {
+      fclose(pFile);
+    }
+    return NULL;
+#endif
+  }
+
+  return pFile;
+}
+
+
 /*-
  ***********************************************************************
  *
@@ -522,182 +1065,189 @@ DecodeGetTableLength(void)
 /*-
  ***********************************************************************
  *
- * DecodeNewSnapshotContext
+ * DecodeGetVarint
  *
  ***********************************************************************
  */
-SNAPSHOT_CONTEXT *
-DecodeNewSnapshotContext(char *pcError)
+int
+DecodeGetVarint(unsigned char *pucData, int iLength, APP_UI64 *pui64Value)
 {
-  const char          acRoutine[] = "DecodeNewSnapshotContext()";
-  SNAPSHOT_CONTEXT   *psSnapshot = NULL;
   int                 i = 0;
-  int                 j = 0;
-
-  psSnapshot = (SNAPSHOT_CONTEXT *) calloc(sizeof(SNAPSHOT_CONTEXT), 1);
-  if (psSnapshot == NULL)
-  {
-    snprintf(pcError, MESSAGE_SIZE, "%s: calloc(): %s", acRoutine, strerror(errno));
-    return NULL;
-  }
 
-  psSnapshot->psDecodeMap = (DECODE_TABLE *) calloc(sizeof(DECODE_TABLE), DECODE_TABLE_SIZE);
-  if (psSnapshot->psDecodeMap == NULL)
-  {
-    snprintf(pcError, MESSAGE_SIZE, "%s: calloc(): %s", acRoutine, strerror(errno));
-    DecodeFreeSnapshotContext(psSnapshot);
-    return NULL;
-  }
-
-  for (i = 0; i < DECODE_RECORD_COUNT; i++)
+  /*-
+   *********************************************************************
+   *
+   * Varints hold seven bits per byte, least significant group first.
+   * The high bit is set on every byte except the last.
+   *
+   *********************************************************************
+   */
+  for (i = 0, *pui64Value = 0; i < iLength && i < DECODE_BINARY_VARINT_SIZE; i++)
   {
-    psSnapshot->asRecords[i].ppcFields = (char **) calloc(DECODE_TABLE_SIZE, sizeof(char **));
-    if (psSnapshot->asRecords[i].ppcFields == NULL)
-    {
-      snprintf(pcError, MESSAGE_SIZE, "%s: calloc(): %s", acRoutine, strerror(errno));
-      DecodeFreeSnapshotContext(psSnapshot);
-      return NULL;
-    }
-
-    for (j = 0; j < (int)(DECODE_TABLE_SIZE); j++)
+    *pui64Value |= ((APP_UI64) (pucData[i] & 0x7f)) << (7 * i);
+    if ((pucData[i] & 0x80) == 0)
     {
-      psSnapshot->asRecords[i].ppcFields[j] = (char *) calloc(DECODE_MAX_LINE, 1);
-      if (psSnapshot->asRecords[i].ppcFields[j] == NULL)
-      {
-        snprintf(pcError, MESSAGE_SIZE, "%s: calloc(): %s", acRoutine, strerror(errno));
-        DecodeFreeSnapshotContext(psSnapshot);
-        return NULL;
-      }
+      return i + 1;
     }
   }
 
-  return psSnapshot;
+  return ER;
 }
 
 
 /*-
  ***********************************************************************
  *
- * DecodeNewSnapshotContext2
+ * DecodeGrowRecord
  *
  ***********************************************************************
  */
-SNAPSHOT_CONTEXT *
-DecodeNewSnapshotContext2(char *pcSnapshot, char *pcError)
+int
+DecodeGrowRecord(DECODE_RECORD *psRecord, int iLineSize, int iFieldSize, char *pcError)
 {
-  const char          acRoutine[] = "DecodeNewSnapshotContext2()";
-  char                acLocalError[MESSAGE_SIZE] = "";
-  SNAPSHOT_CONTEXT   *psSnapshot = NULL;
-  int                 iError = 0;
+  const char          acRoutine[] = "DecodeGrowRecord()";
+  char               *pc = NULL;
   int                 i = 0;
-  int                 j = 0;
-
-  psSnapshot = (SNAPSHOT_CONTEXT *)calloc(sizeof(SNAPSHOT_CONTEXT), 1);
-  if (psSnapshot == NULL)
-  {
-    snprintf(pcError, MESSAGE_SIZE, "%s: calloc(): %s", acRoutine, strerror(errno));
-    goto FAIL;
-  }
 
-  psSnapshot->psDecodeMap = (DECODE_TABLE *)calloc(sizeof(DECODE_TABLE), DECODE_TABLE_SIZE);
-  if (psSnapshot->psDecodeMap == NULL)
+  /*-
+   *********************************************************************
+   *
+   * Buffers only ever grow, and they are grown in whole multiples of
+   * DECODE_MAX_LINE. Thus, typical snapshots never trigger a realloc.
+   *
+   *********************************************************************
+   */
+  if (iLineSize > psRecord->iLineSize)
   {
-    snprintf(pcError, MESSAGE_SIZE, "%s: calloc(): %s", acRoutine, strerror(errno));
-    goto FAIL;
+    iLineSize = ((iLineSize / DECODE_MAX_LINE) + 1) * DECODE_MAX_LINE;
+    pc = (char *) realloc(psRecord->pcLine, iLineSize);
+    if (pc == NULL)
+    {
+      snprintf(pcError, MESSAGE_SIZE, "%s: realloc(): %s", acRoutine, strerror(errno));
+      return ER;
+    }
+    psRecord->pcLine = pc;
+    psRecord->iLineSize = iLineSize;
   }
 
-  for (i = 0; i < DECODE_RECORD_COUNT; i++)
+  /*-
+   *********************************************************************
+   *
+   * The field buffers share one slab. When it grows, existing field
+   * values are moved (last to first) to their new, wider slots.
+   *
+   *********************************************************************
+   */
+  if (iFieldSize > psRecord->iFieldSize)
   {
-    psSnapshot->asRecords[i].ppcFields = (char **)calloc(DECODE_TABLE_SIZE, sizeof(char **));
-    if (psSnapshot->asRecords[i].ppcFields == NULL)
+    iFieldSize = ((iFieldSize / DECODE_MAX_LINE) + 1) * DECODE_MAX_LINE;
+    pc = (char *) realloc(psRecord->pcFieldData, (size_t) iFieldSize * DECODE_TABLE_SIZE);
+    if (pc == NULL)
     {
-      snprintf(pcError, MESSAGE_SIZE, "%s: calloc(): %s", acRoutine, strerror(errno));
-      goto FAIL;
+      snprintf(pcError, MESSAGE_SIZE, "%s: realloc(): %s", acRoutine, strerror(errno));
+      return ER;
     }
-
-    for (j = 0; j < (int)(DECODE_TABLE_SIZE); j++)
+    for (i = (int)(DECODE_TABLE_SIZE) - 1; i >= 0; i--)
     {
-      psSnapshot->asRecords[i].ppcFields[j] = (char *)calloc(DECODE_MAX_LINE, 1);
-      if (psSnapshot->asRecords[i].ppcFields[j] == NULL)
-      {
-        snprintf(pcError, MESSAGE_SIZE, "%s: calloc(): %s", acRoutine, strerror(errno));
-        goto FAIL;
-      }
+      memmove(&pc[i * iFieldSize], &pc[i * psRecord->iFieldSize], psRecord->iFieldSize);
+      psRecord->ppcFields[i] = &pc[i * iFieldSize];
     }
+    psRecord->pcFieldData = pc;
+    psRecord->iFieldSize = iFieldSize;
   }
 
-  iError = MaskSetDynamicString(&psSnapshot->pcFile, pcSnapshot, acLocalError);
-  if (iError == ER)
-  {
-    snprintf(pcError, MESSAGE_SIZE, "%s: %s", acRoutine, acLocalError);
-    goto FAIL;
-  }
+  return ER_OK;
+}
 
-  psSnapshot->pFile = SupportGetFileHandle(psSnapshot->pcFile, acLocalError);
-  if (psSnapshot->pFile == NULL)
-  {
-    snprintf(pcError, MESSAGE_SIZE, "%s: File = [%s], Line = [%d]: %s", acRoutine, psSnapshot->pcFile, psSnapshot->iLineNumber, acLocalError);
-    goto FAIL;
-  }
 
-  if (DecodeReadLine(psSnapshot, acLocalError) == NULL && ferror(psSnapshot->pFile))
+/*-
+ ***********************************************************************
+ *
+ * DecodeHashName
+ *
+ ***********************************************************************
+ */
+void
+DecodeHashName(char *pcName, int iNamesAreCaseInsensitive, unsigned char *pucHash)
+{
+  char                acName[DECODE_MAX_LINE] = { 0 };
+  int                 i = 0;
+  int                 iLength = 0;
+  int                 n = 0;
+  MD5_CONTEXT         sMD5Context;
+
+  /*-
+   *********************************************************************
+   *
+   * If the user has declared names to be case insensitive or the name
+   * begins with a WINX drive specification, convert it to lower case
+   * before computing its hash. Note that WINX-based names are not case
+   * sensitive. Usually, the original case is preserved at file
+   * creation, but there is no guarantee that the case for a given
+   * file will be the same from snapshot to snapshot. Therefore,
+   * WINX-based names must always be converted to lower case before
+   * computing their hash. Since names are not limited to
+   * DECODE_MAX_LINE bytes, the lower case version is hashed one
+   * buffer at a time.
+   *
+   *********************************************************************
+   */
+  iLength = strlen(pcName);
+  if (iNamesAreCaseInsensitive || (isalpha((int) pcName[1]) && pcName[2] == ':'))
   {
-    snprintf(pcError, MESSAGE_SIZE, "%s: File = [%s], Line = [%d]: %s", acRoutine, psSnapshot->pcFile, psSnapshot->iLineNumber, acLocalError);
-    goto FAIL;
+    MD5Alpha(&sMD5Context);
+    while (iLength > 0)
+    {
+      n = (iLength > DECODE_MAX_LINE) ? DECODE_MAX_LINE : iLength;
+      for (i = 0; i < n; i++)
+      {
+        acName[i] = tolower((int) pcName[i]);
+      }
+      MD5Cycle(&sMD5Context, (unsigned char *) acName, n);
+      pcName += n;
+      iLength -= n;
+    }
+    MD5Omega(&sMD5Context, pucHash);
   }
-
-  iError = DecodeParseHeader(psSnapshot, acLocalError);
-  if (iError != ER_OK)
+  else
   {
-    snprintf(pcError, MESSAGE_SIZE, "%s: File = [%s], Line = [%d]: %s", acRoutine, psSnapshot->pcFile, psSnapshot->iLineNumber, acLocalError);
-    goto FAIL;
+    MD5HashString((unsigned char *) pcName, iLength, pucHash);
   }
-
-  return psSnapshot;
-
-FAIL:
-  DecodeFreeSnapshotContext2(psSnapshot);
-
-  return NULL;
 }
 
 
 /*-
  ***********************************************************************
  *
- * DecodeOpenSnapshot
+ * DecodeIndexSnapshot
  *
  ***********************************************************************
  */
 int
-DecodeOpenSnapshot(SNAPSHOT_CONTEXT *psSnapshot, char *pcError)
+DecodeIndexSnapshot(char *pcSnapshot, char *pcIndexFile, char *pcError)
 {
-  const char          acRoutine[] = "DecodeOpenSnapshot()";
+  const char          acRoutine[] = "DecodeIndexSnapshot()";
   char                acLocalError[MESSAGE_SIZE] = "";
+  SNAPSHOT_CONTEXT   *psSnapshot = NULL;
   int                 iError = 0;
 
-  psSnapshot->pFile = SupportGetFileHandle(psSnapshot->pcFile, acLocalError);
-  if (psSnapshot->pFile == NULL)
-  {
-    snprintf(pcError, MESSAGE_SIZE, "%s: File = [%s], Line = [%d]: %s", acRoutine, psSnapshot->pcFile, psSnapshot->iLineNumber, acLocalError);
-    return ER;
-  }
-
-  if (DecodeReadLine(psSnapshot, acLocalError) == NULL && ferror(psSnapshot->pFile))
+  psSnapshot = DecodeNewSnapshotContext2(pcSnapshot, acLocalError);
+  if (psSnapshot == NULL)
   {
-    snprintf(pcError, MESSAGE_SIZE, "%s: File = [%s], Line = [%d]: %s", acRoutine, psSnapshot->pcFile, psSnapshot->iLineNumber, acLocalError);
-    fclose(psSnapshot->pFile);
+    snprintf(pcError, MESSAGE_SIZE, "%s: %s", acRoutine, acLocalError);
     return ER;
   }
 
-  iError = DecodeParseHeader(psSnapshot, acLocalError);
+  iError = DecodeBuildIndex(psSnapshot, pcIndexFile, acLocalError);
   if (iError != ER_OK)
   {
-    snprintf(pcError, MESSAGE_SIZE, "%s: File = [%s], Line = [%d]: %s", acRoutine, psSnapshot->pcFile, psSnapshot->iLineNumber, acLocalError);
-    fclose(psSnapshot->pFile);
+    snprintf(pcError, MESSAGE_SIZE, "%s: %s", acRoutine, acLocalError);
+    DecodeFreeSnapshotContext2(psSnapshot);
     return ER;
   }
 
+  DecodeFreeSnapshotContext2(psSnapshot);
+
   return ER_OK;
 }
 
@@ -705,108 +1255,229 @@ DecodeOpenSnapshot(SNAPSHOT_CONTEXT *psSnapshot, char *pcError)
 /*-
  ***********************************************************************
  *
- * DecodeParseHeader
+ * DecodeLookupRecord
  *
  ***********************************************************************
  */
 int
-DecodeParseHeader(SNAPSHOT_CONTEXT *psSnapshot, char *pcError)
+DecodeLookupRecord(SNAPSHOT_CONTEXT *psSnapshot, char *pcIndexFile, char *pcName, char *pcError)
 {
-  const char          acRoutine[] = "DecodeParseHeader()";
-  char                acLegacyName[DECODE_FIELDNAME_SIZE] = { 0 };
-  char               *pc = NULL;
-  int                 i = 0;
-  int                 iIndex = 0;
+  const char          acRoutine[] = "DecodeLookupRecord()";
+  char                acLocalError[MESSAGE_SIZE] = "";
+  char                acName[DECODE_MAX_PATH] = "";
+  DECODE_INDEX_ENTRY  sEntry;
+  FILE               *pFile = NULL;
+  APP_UI32            ui32Value = 0;
+  APP_UI64            ui64Count = 0;
+  APP_UI64            ui64Entry = 0;
+  APP_UI64            ui64High = 0;
+  APP_UI64            ui64Low = 0;
+  APP_UI64            ui64Middle = 0;
+  APP_UI64            ui64Size = 0;
+  int                 iCaseInsensitive = 0;
+  int                 iError = 0;
+  int                 iFound = 0;
+  int                 iLength = 0;
+  struct stat         sStatEntry;
+  unsigned char       aucHash[MD5_HASH_SIZE];
+  unsigned char       aucHeader[DECODE_INDEX_HEADER_SIZE];
+
+  if (psSnapshot->iGzipped)
+  {
+    snprintf(pcError, MESSAGE_SIZE, "%s: File = [%s]: Gzip compressed snapshots do not support lookups.", acRoutine, psSnapshot->pcFile);
+    return ER;
+  }
 
   /*-
    *********************************************************************
    *
-   * First, check to see that there's at least a name field.
+   * Names are stored in quoted form. Add the quotes if the caller did
+   * not supply them, and compute the hash that the index is keyed on.
    *
    *********************************************************************
    */
-  if (strcmp(psSnapshot->psCurrRecord->acLine, "name") == 0 || strncmp(psSnapshot->psCurrRecord->acLine, "name|", 5) == 0)
+  iLength = strlen(pcName);
+  if (iLength > 0 && pcName[0] == '"')
   {
-    psSnapshot->iCompressed = 0;
-    psSnapshot->iLegacyFile = 0;
+    iLength = snprintf(acName, DECODE_MAX_PATH, "%s", pcName);
   }
-  else if (strcmp(psSnapshot->psCurrRecord->acLine, "z_name") == 0 || strncmp(psSnapshot->psCurrRecord->acLine, "z_name|", 7) == 0)
+  else
   {
-    psSnapshot->iCompressed = 1;
-    psSnapshot->iLegacyFile = 0;
+    iLength = snprintf(acName, DECODE_MAX_PATH, "\"%s\"", pcName);
   }
-  else if (strcmp(psSnapshot->psCurrRecord->acLine, "zname") == 0 || strncmp(psSnapshot->psCurrRecord->acLine, "zname|", 6) == 0)
+  if (iLength < 3 || iLength >= DECODE_MAX_PATH)
   {
-    psSnapshot->iCompressed = 1;
-    psSnapshot->iLegacyFile = 1;
+    snprintf(pcError, MESSAGE_SIZE, "%s: Name length must be in the range [1-%d].", acRoutine, DECODE_MAX_PATH - 3);
+    return ER;
   }
-  else
+  iCaseInsensitive = (psSnapshot->iNamesAreCaseInsensitive || (isalpha((int) acName[1]) && acName[2] == ':')) ? 1 : 0;
+  DecodeHashName(acName, psSnapshot->iNamesAreCaseInsensitive, aucHash);
+
+  /*-
+   *********************************************************************
+   *
+   * Open the index, and make sure that it matches the snapshot.
+   *
+   *********************************************************************
+   */
+  pFile = fopen(pcIndexFile, "rb");
+  if (pFile == NULL)
   {
-    snprintf(pcError, MESSAGE_SIZE, "%s: Header magic is not recognized.", acRoutine);
+    snprintf(pcError, MESSAGE_SIZE, "%s: fopen(): File = [%s]: %s", acRoutine, pcIndexFile, strerror(errno));
+    return ER;
+  }
+
+  if (fread(aucHeader, 1, DECODE_INDEX_HEADER_SIZE, pFile) != DECODE_INDEX_HEADER_SIZE || memcmp(aucHeader, DECODE_INDEX_MAGIC, DECODE_INDEX_MAGIC_LENGTH) != 0)
+  {
+    snprintf(pcError, MESSAGE_SIZE, "%s: File = [%s]: Header magic is not recognized.", acRoutine, pcIndexFile);
+    fclose(pFile);
+    return ER;
+  }
+  DECODE_UNPACK_NUMBER(&aucHeader[8], ui32Value, 4);
+  if (ui32Value != DECODE_INDEX_VERSION)
+  {
+    snprintf(pcError, MESSAGE_SIZE, "%s: File = [%s], Version = [%u]: Unsupported index version.", acRoutine, pcIndexFile, ui32Value);
+    fclose(pFile);
+    return ER;
+  }
+  DECODE_UNPACK_NUMBER(&aucHeader[12], ui32Value, 4);
+  if (ui32Value != DECODE_INDEX_ENTRY_SIZE)
+  {
+    snprintf(pcError, MESSAGE_SIZE, "%s: File = [%s], EntrySize = [%u]: Unsupported entry size.", acRoutine, pcIndexFile, ui32Value);
+    fclose(pFile);
+    return ER;
+  }
+  DECODE_UNPACK_NUMBER(&aucHeader[16], ui64Count, 8);
+  DECODE_UNPACK_NUMBER(&aucHeader[24], ui64Size, 8);
+
+  if (fstat(fileno(psSnapshot->pFile), &sStatEntry) == ER)
+  {
+    snprintf(pcError, MESSAGE_SIZE, "%s: fstat(): File = [%s]: %s", acRoutine, psSnapshot->pcFile, strerror(errno));
+    fclose(pFile);
+    return ER;
+  }
+  if ((APP_UI64) sStatEntry.st_size != ui64Size)
+  {
+    snprintf(pcError, MESSAGE_SIZE, "%s: File = [%s]: Index does not match the snapshot. Rebuild the index.", acRoutine, pcIndexFile);
+    fclose(pFile);
     return ER;
   }
 
   /*-
    *********************************************************************
    *
-   * Then, parse the header, and construct a decode table.
+   * Locate the first entry whose hash matches. Entries are sorted by
+   * hash, so this takes O(log n) reads.
    *
    *********************************************************************
    */
-  for (iIndex = 0, pc = strtok(psSnapshot->psCurrRecord->acLine, DECODE_SEPARATOR_S); pc != NULL; pc = strtok(NULL, DECODE_SEPARATOR_S), iIndex++)
+  ui64Low = 0;
+  ui64High = ui64Count;
+  while (ui64Low < ui64High)
   {
-    for (i = 0; i < (int)(DECODE_TABLE_SIZE); i++)
+    ui64Middle = ui64Low + (ui64High - ui64Low) / 2;
+    iError = DecodeReadIndexEntry(pFile, ui64Middle, &sEntry, acLocalError);
+    if (iError != ER_OK)
     {
-      if (psSnapshot->iCompressed)
-      {
-        if (strcmp(gasDecodeTable[i].acZName, pc) == 0)
-        {
-          psSnapshot->aiIndex2Map[iIndex] = i;
-          psSnapshot->psDecodeMap[i] = gasDecodeTable[i]; /* This initializes all elements at the given index. */
-          PUTBIT(psSnapshot->ulFieldMask, 1, i);
-          break;
-        }
-        if (psSnapshot->iLegacyFile)
-        {
-          snprintf(acLegacyName, DECODE_FIELDNAME_SIZE - 1, "z_%s", pc);
-          acLegacyName[DECODE_FIELDNAME_SIZE - 1] = 0;
-          if (strcmp(gasDecodeTable[i].acZName, acLegacyName) == 0 || strcmp("zname", pc) == 0)
-          {
-            psSnapshot->aiIndex2Map[iIndex] = i;
-            psSnapshot->psDecodeMap[i] = gasDecodeTable[i]; /* This initializes all elements at the given index. */
-            PUTBIT(psSnapshot->ulFieldMask, 1, i);
-            break;
-          }
-        }
-      }
-      else
-      {
-        if (strcmp(gasDecodeTable[i].acUName, pc) == 0)
-        {
-          psSnapshot->aiIndex2Map[iIndex] = i;
-          psSnapshot->psDecodeMap[i] = gasDecodeTable[i]; /* This initializes all elements at the given index. */
-          psSnapshot->psDecodeMap[i].piRoutine = DecodeProcessNada; /* Override the normal decode routine. */
-          PUTBIT(psSnapshot->ulFieldMask, 1, i);
-          break;
-        }
-      }
+      snprintf(pcError, MESSAGE_SIZE, "%s: File = [%s]: %s", acRoutine, pcIndexFile, acLocalError);
+      fclose(pFile);
+      return ER;
     }
-    if (i == DECODE_TABLE_SIZE)
+    if (memcmp(sEntry.aucHash, aucHash, MD5_HASH_SIZE) < 0)
     {
-      snprintf(pcError, MESSAGE_SIZE, "%s: Field = [%s]: Unrecognized field.", acRoutine, pc);
-      return ER;
+      ui64Low = ui64Middle + 1;
+    }
+    else
+    {
+      ui64High = ui64Middle;
     }
   }
 
   /*-
    *********************************************************************
    *
-   * Finally, record the last field index -- it's used to represent the
-   * length of the decode table.
+   * Decode each matching record. The decoder is positioned at the
+   * record's sync point, and it runs forward until it reaches the
+   * record. For compressed snapshots, this is at most one checkpoint
+   * interval. The decoded name is checked to rule out collisions.
    *
    *********************************************************************
    */
-  psSnapshot->iFieldCount = iIndex;
+  for (ui64Entry = ui64Low; ui64Entry < ui64Count; ui64Entry++)
+  {
+    iError = DecodeReadIndexEntry(pFile, ui64Entry, &sEntry, acLocalError);
+    if (iError != ER_OK)
+    {
+      snprintf(pcError, MESSAGE_SIZE, "%s: File = [%s]: %s", acRoutine, pcIndexFile, acLocalError);
+      fclose(pFile);
+      return ER;
+    }
+    if (memcmp(sEntry.aucHash, aucHash, MD5_HASH_SIZE) != 0)
+    {
+      break;
+    }
+
+    iError = DecodeSeekFile(psSnapshot->pFile, sEntry.ui64SyncOffset, acLocalError);
+    if (iError != ER_OK)
+    {
+      snprintf(pcError, MESSAGE_SIZE, "%s: File = [%s]: %s", acRoutine, psSnapshot->pcFile, acLocalError);
+      fclose(pFile);
+      return ER;
+    }
+    psSnapshot->iReadLength = psSnapshot->iReadOffset = 0;
+    psSnapshot->ui64ReadBase = sEntry.ui64SyncOffset;
+    psSnapshot->iLineNumber = (int) sEntry.ui32SyncLine - 1;
+    psSnapshot->iSkipToNext = FALSE;
+    memset(&psSnapshot->sDecodeState, 0, sizeof(DECODE_STATE));
+
+    do
+    {
+      if (DecodeReadLine(psSnapshot, acLocalError) == NULL)
+      {
+        snprintf(pcError, MESSAGE_SIZE, "%s: File = [%s], Line = [%d]: Unexpected end of snapshot. Rebuild the index.", acRoutine, psSnapshot->pcFile, psSnapshot->iLineNumber);
+        fclose(pFile);
+        return ER;
+      }
+      psSnapshot->sDecodeStats.ulAnalyzed++;
+      iError = DecodeParseRecord(psSnapshot, acLocalError);
+      if (iError != ER_OK)
+      {
+        snprintf(pcError, MESSAGE_SIZE, "%s: File = [%s], Line = [%d]: Record could not be decoded. Rebuild the index.", acRoutine, psSnapshot->pcFile, psSnapshot->iLineNumber);
+        psSnapshot->sDecodeStats.ulSkipped++;
+        fclose(pFile);
+        return ER;
+      }
+    } while (psSnapshot->iLineNumber < (int) sEntry.ui32Line);
+
+    if (psSnapshot->psCurrRecord->ui64Offset != sEntry.ui64Offset)
+    {
+      snprintf(pcError, MESSAGE_SIZE, "%s: File = [%s], Line = [%d]: Record offset mismatch. Rebuild the index.", acRoutine, psSnapshot->pcFile, psSnapshot->iLineNumber);
+      fclose(pFile);
+      return ER;
+    }
+
+    if ((iCaseInsensitive) ? strcasecmp(psSnapshot->psCurrRecord->ppcFields[0], acName) != 0 : strcmp(psSnapshot->psCurrRecord->ppcFields[0], acName) != 0)
+    {
+      continue;
+    }
+
+    iError = DecodeWriteRecord(psSnapshot, acLocalError);
+    if (iError != ER_OK)
+    {
+      snprintf(pcError, MESSAGE_SIZE, "%s: File = [%s], Line = [%d]: %s", acRoutine, psSnapshot->pcFile, psSnapshot->iLineNumber, acLocalError);
+      fclose(pFile);
+      return ER;
+    }
+    psSnapshot->sDecodeStats.ulDecoded++;
+    iFound++;
+  }
+  fclose(pFile);
+
+  if (iFound == 0)
+  {
+    snprintf(pcError, MESSAGE_SIZE, "%s: Name = [%s]: Record not found.", acRoutine, acName);
+    return ER_NothingToDo;
+  }
 
   return ER_OK;
 }
@@ -815,124 +1486,51 @@ DecodeParseHeader(SNAPSHOT_CONTEXT *psSnapshot, char *pcError)
 /*-
  ***********************************************************************
  *
- * DecodeParseRecord
+ * DecodeNewRecord
  *
  ***********************************************************************
  */
 int
-DecodeParseRecord(SNAPSHOT_CONTEXT *psSnapshot, char *pcError)
+DecodeNewRecord(DECODE_RECORD *psRecord, char *pcError)
 {
-  char                acLocalError[MESSAGE_SIZE] = "";
-  char                acName[DECODE_MAX_LINE] = { 0 };
-  char               *pcName = NULL;
-  char               *pcToken = NULL;
+  const char          acRoutine[] = "DecodeNewRecord()";
   int                 i = 0;
-  int                 iDone = 0;
-  int                 iError = 0;
-  int                 iLength = 0;
-  int                 iOffset = 0;
-  int                 iFieldCount = 1;
-  int                 iFieldIndex = 0;
 
   /*-
    *********************************************************************
    *
-   * Scan the line -- stopping at each delimiter to decode the field.
+   * The field buffers are carved out of a single slab, so each record
+   * requires exactly three allocations regardless of how many fields
+   * the decode table holds.
    *
    *********************************************************************
    */
-  pcToken = psSnapshot->psCurrRecord->acLine;
-  while (!iDone)
+  psRecord->ppcFields = (char **) calloc(DECODE_TABLE_SIZE, sizeof(char **));
+  if (psRecord->ppcFields == NULL)
   {
-    if (psSnapshot->psCurrRecord->acLine[iOffset] == DECODE_SEPARATOR_C || psSnapshot->psCurrRecord->acLine[iOffset] == 0)
-    {
-      if (iFieldCount > psSnapshot->iFieldCount)
-      {
-        snprintf(pcError, MESSAGE_SIZE, "File = [%s], Line = [%d], FieldCount = [%d] > [%d]: FieldCount exceeds expected value.",
-          psSnapshot->pcFile,
-          psSnapshot->iLineNumber,
-          iFieldCount,
-          psSnapshot->iFieldCount
-          );
-        ErrorHandler(ER_Failure, pcError, ERROR_FAILURE);
-        return ER;
-      }
-      if (psSnapshot->psCurrRecord->acLine[iOffset] == 0)
-      {
-        iDone = 1;
-      }
-      psSnapshot->psCurrRecord->acLine[iOffset] = 0; /* Terminate the field value. */
-      iError = psSnapshot->psDecodeMap[psSnapshot->aiIndex2Map[iFieldIndex]].piRoutine(
-        &psSnapshot->sDecodeState,
-        pcToken,
-        iLength,
-        psSnapshot->psCurrRecord->ppcFields[psSnapshot->aiIndex2Map[iFieldIndex]],
-        acLocalError
-        );
-      if (iError == ER)
-      {
-        snprintf(pcError, MESSAGE_SIZE, "File = [%s], Line = [%d], Field = [%s]: %s",
-          psSnapshot->pcFile,
-          psSnapshot->iLineNumber,
-          (psSnapshot->iCompressed) ? psSnapshot->psDecodeMap[psSnapshot->aiIndex2Map[iFieldIndex]].acZName : psSnapshot->psDecodeMap[psSnapshot->aiIndex2Map[iFieldIndex]].acUName,
-          acLocalError
-          );
-        ErrorHandler(ER_Failure, pcError, ERROR_FAILURE);
-        return ER;
-      }
-      if (!iDone)
-      {
-        iOffset++;
-        iFieldCount++;
-        iFieldIndex++;
-        pcToken = &psSnapshot->psCurrRecord->acLine[iOffset];
-        iLength = 0;
-      }
-    }
-    else
-    {
-      iOffset++;
-      iLength++;
-    }
+    snprintf(pcError, MESSAGE_SIZE, "%s: calloc(): %s", acRoutine, strerror(errno));
+    return ER;
   }
-  if (iFieldCount != psSnapshot->iFieldCount)
+
+  psRecord->pcFieldData = (char *) calloc(DECODE_TABLE_SIZE, DECODE_MAX_LINE);
+  if (psRecord->pcFieldData == NULL)
   {
-    snprintf(pcError, MESSAGE_SIZE, "File = [%s], Line = [%d], FieldCount = [%d] != [%d]: FieldCount mismatch!",
-      psSnapshot->pcFile,
-      psSnapshot->iLineNumber,
-      iFieldCount,
-      psSnapshot->iFieldCount
-      );
-    ErrorHandler(ER_Failure, pcError, ERROR_FAILURE);
+    snprintf(pcError, MESSAGE_SIZE, "%s: calloc(): %s", acRoutine, strerror(errno));
     return ER;
   }
+  for (i = 0; i < (int)(DECODE_TABLE_SIZE); i++)
+  {
+    psRecord->ppcFields[i] = &psRecord->pcFieldData[i * DECODE_MAX_LINE];
+  }
+  psRecord->iFieldSize = DECODE_MAX_LINE;
 
-  /*-
-   *********************************************************************
-   *
-   * Compute the MD5 hash of the name field. If the user has declared
-   * names to be case insensitive or the name begins with a WINX drive
-   * specification, convert it to lower case before computing its
-   * hash. Note that WINX-based names are not case sensitive. Usually,
-   * the original case is preserved at file creation, but there is no
-   * guarantee that the case for a given file will be the same from
-   * snapshot to snapshot. Therefore, WINX-based names must always be
-   * converted to lower case before computing their hash.
-   *
-   *********************************************************************
-   */
-  pcName = psSnapshot->psCurrRecord->ppcFields[0];
-  iLength = strlen(pcName);
-  if (psSnapshot->iNamesAreCaseInsensitive || (isalpha((int) pcName[1]) && pcName[2] == ':'))
+  psRecord->pcLine = (char *) calloc(DECODE_MAX_LINE, 1);
+  if (psRecord->pcLine == NULL)
   {
-    snprintf(acName, DECODE_MAX_LINE, "%s", pcName);
-    for (i = 0; i < iLength; i++)
-    {
-      acName[i] = tolower((int) acName[i]);
-    }
-    pcName = acName;
+    snprintf(pcError, MESSAGE_SIZE, "%s: calloc(): %s", acRoutine, strerror(errno));
+    return ER;
   }
-  MD5HashString((unsigned char *) pcName, iLength, psSnapshot->psCurrRecord->aucHash);
+  psRecord->iLineSize = DECODE_MAX_LINE;
 
   return ER_OK;
 }
@@ -941,79 +1539,474 @@ DecodeParseRecord(SNAPSHOT_CONTEXT *psSnapshot, char *pcError)
 /*-
  ***********************************************************************
  *
- * DecodeProcessATime
+ * DecodeNewSnapshotContext
  *
  ***********************************************************************
  */
-int
-DecodeProcessATime(DECODE_STATE *psDecodeState, char *pcToken, int iLength, char *pcOutput, char *pcError)
+SNAPSHOT_CONTEXT *
+DecodeNewSnapshotContext(char *pcError)
 {
-  const char          acRoutine[] = "DecodeProcessATime()";
+  const char          acRoutine[] = "DecodeNewSnapshotContext()";
   char                acLocalError[MESSAGE_SIZE] = "";
-  char                acTimeString[DECODE_TIME_FORMAT_SIZE] = { 0 };
-  int                 iError = 0;
-  APP_UI32            ui32Value = 0;
+  SNAPSHOT_CONTEXT   *psSnapshot = NULL;
+  int                 i = 0;
 
-  if (iLength <= 0)
+  psSnapshot = (SNAPSHOT_CONTEXT *) calloc(sizeof(SNAPSHOT_CONTEXT), 1);
+  if (psSnapshot == NULL)
   {
-    DECODE_UNDEFINE_PREV_NUMBER_VALUE(psDecodeState->atime, psDecodeState->patime);
-    pcOutput[0] = 0;
-    return ER_OK; /* It's not an error if a value is missing. */
+    snprintf(pcError, MESSAGE_SIZE, "%s: calloc(): %s", acRoutine, strerror(errno));
+    return NULL;
   }
 
-  if (pcToken[0] == '~')
+  psSnapshot->psDecodeMap = (DECODE_TABLE *) calloc(sizeof(DECODE_TABLE), DECODE_TABLE_SIZE);
+  if (psSnapshot->psDecodeMap == NULL)
   {
-    DECODE_UNDEFINE_PREV_NUMBER_VALUE(psDecodeState->atime, psDecodeState->patime);
-    iError = DecodeFormatOutOfBandTime(&pcToken[1], iLength - 1, acTimeString, acLocalError);
-    if (iError == ER)
-    {
-      snprintf(pcError, MESSAGE_SIZE, "%s: %s", acRoutine, acLocalError);
-      return ER;
-    }
-    snprintf(pcOutput, DECODE_TIME_FORMAT_SIZE, "%s", acTimeString);
-    return ER_OK;
+    snprintf(pcError, MESSAGE_SIZE, "%s: calloc(): %s", acRoutine, strerror(errno));
+    DecodeFreeSnapshotContext(psSnapshot);
+    return NULL;
   }
 
-  switch (pcToken[0])
+  for (i = 0; i < DECODE_RECORD_COUNT; i++)
   {
-  case '#':
-    if (psDecodeState->patime != NULL)
-    {
-      ui32Value = *psDecodeState->patime;
-    }
-    else
-    {
-      snprintf(pcError, MESSAGE_SIZE, "%s: Expected previous value to be defined!", acRoutine);
-      return ER;
-    }
-    break;
-  default:
-    iError = Decode32BitHexToDecimal(pcToken, iLength, &ui32Value, psDecodeState->patime, acLocalError);
-    if (iError == ER)
+    if (DecodeNewRecord(&psSnapshot->asRecords[i], acLocalError) != ER_OK)
     {
       snprintf(pcError, MESSAGE_SIZE, "%s: %s", acRoutine, acLocalError);
-      return ER;
+      DecodeFreeSnapshotContext(psSnapshot);
+      return NULL;
     }
-    break;
-  }
-
-  iError = DecodeFormatTime(&ui32Value, pcOutput);
-  if (iError == ER)
-  {
-    snprintf(pcError, MESSAGE_SIZE, "%s: %s", acRoutine, acLocalError);
-    return ER;
   }
 
-  DECODE_DEFINE_PREV_NUMBER_VALUE(psDecodeState->atime, psDecodeState->patime, ui32Value);
-
-  return ER_OK;
+  return psSnapshot;
 }
 
 
 /*-
  ***********************************************************************
  *
- * DecodeProcessATimeMs
+ * DecodeNewSnapshotContext2
+ *
+ ***********************************************************************
+ */
+SNAPSHOT_CONTEXT *
+DecodeNewSnapshotContext2(char *pcSnapshot, char *pcError)
+{
+  const char          acRoutine[] = "DecodeNewSnapshotContext2()";
+  char                acLocalError[MESSAGE_SIZE] = "";
+  SNAPSHOT_CONTEXT   *psSnapshot = NULL;
+  int                 iError = 0;
+  int                 i = 0;
+
+  psSnapshot = (SNAPSHOT_CONTEXT *)calloc(sizeof(SNAPSHOT_CONTEXT), 1);
+  if (psSnapshot == NULL)
+  {
+    snprintf(pcError, MESSAGE_SIZE, "%s: calloc(): %s", acRoutine, strerror(errno));
+    goto FAIL;
+  }
+
+  psSnapshot->psDecodeMap = (DECODE_TABLE *)calloc(sizeof(DECODE_TABLE), DECODE_TABLE_SIZE);
+  if (psSnapshot->psDecodeMap == NULL)
+  {
+    snprintf(pcError, MESSAGE_SIZE, "%s: calloc(): %s", acRoutine, strerror(errno));
+    goto FAIL;
+  }
+
+  for (i = 0; i < DECODE_RECORD_COUNT; i++)
+  {
+    if (DecodeNewRecord(&psSnapshot->asRecords[i], acLocalError) != ER_OK)
+    {
+      snprintf(pcError, MESSAGE_SIZE, "%s: %s", acRoutine, acLocalError);
+      goto FAIL;
+    }
+  }
+
+  iError = MaskSetDynamicString(&psSnapshot->pcFile, pcSnapshot, acLocalError);
+  if (iError == ER)
+  {
+    snprintf(pcError, MESSAGE_SIZE, "%s: %s", acRoutine, acLocalError);
+    goto FAIL;
+  }
+
+  psSnapshot->pFile = DecodeGetFileHandle(psSnapshot, acLocalError);
+  if (psSnapshot->pFile == NULL)
+  {
+    snprintf(pcError, MESSAGE_SIZE, "%s: File = [%s], Line = [%d]: %s", acRoutine, psSnapshot->pcFile, psSnapshot->iLineNumber, acLocalError);
+    goto FAIL;
+  }
+
+  if (DecodeReadLine(psSnapshot, acLocalError) == NULL && ferror(psSnapshot->pFile))
+  {
+    snprintf(pcError, MESSAGE_SIZE, "%s: File = [%s], Line = [%d]: %s", acRoutine, psSnapshot->pcFile, psSnapshot->iLineNumber, acLocalError);
+    goto FAIL;
+  }
+
+  iError = DecodeParseHeader(psSnapshot, acLocalError);
+  if (iError != ER_OK)
+  {
+    snprintf(pcError, MESSAGE_SIZE, "%s: File = [%s], Line = [%d]: %s", acRoutine, psSnapshot->pcFile, psSnapshot->iLineNumber, acLocalError);
+    goto FAIL;
+  }
+
+  return psSnapshot;
+
+FAIL:
+  DecodeFreeSnapshotContext2(psSnapshot);
+
+  return NULL;
+}
+
+
+/*-
+ ***********************************************************************
+ *
+ * DecodeOpenSnapshot
+ *
+ ***********************************************************************
+ */
+int
+DecodeOpenSnapshot(SNAPSHOT_CONTEXT *psSnapshot, char *pcError)
+{
+  const char          acRoutine[] = "DecodeOpenSnapshot()";
+  char                acLocalError[MESSAGE_SIZE] = "";
+  int                 iError = 0;
+
+  psSnapshot->pFile = DecodeGetFileHandle(psSnapshot, acLocalError);
+  if (psSnapshot->pFile == NULL)
+  {
+    snprintf(pcError, MESSAGE_SIZE, "%s: File = [%s], Line = [%d]: %s", acRoutine, psSnapshot->pcFile, psSnapshot->iLineNumber, acLocalError);
+    return ER;
+  }
+
+  if (DecodeReadLine(psSnapshot, acLocalError) == NULL && ferror(psSnapshot->pFile))
+  {
+    snprintf(pcError, MESSAGE_SIZE, "%s: File = [%s], Line = [%d]: %s", acRoutine, psSnapshot->pcFile, psSnapshot->iLineNumber, acLocalError);
+    fclose(psSnapshot->pFile);
+    return ER;
+  }
+
+  iError = DecodeParseHeader(psSnapshot, acLocalError);
+  if (iError != ER_OK)
+  {
+    snprintf(pcError, MESSAGE_SIZE, "%s: File = [%s], Line = [%d]: %s", acRoutine, psSnapshot->pcFile, psSnapshot->iLineNumber, acLocalError);
+    fclose(psSnapshot->pFile);
+    return ER;
+  }
+
+  return ER_OK;
+}
+
+
+/*-
+ ***********************************************************************
+ *
+ * DecodeParseHeader
+ *
+ ***********************************************************************
+ */
+int
+DecodeParseHeader(SNAPSHOT_CONTEXT *psSnapshot, char *pcError)
+{
+  const char          acRoutine[] = "DecodeParseHeader()";
+  char                acLegacyName[DECODE_FIELDNAME_SIZE] = { 0 };
+  char               *pc = NULL;
+  char               *pcName = NULL;
+  int                 i = 0;
+  int                 iIndex = 0;
+
+  /*-
+   *********************************************************************
+   *
+   * First, check to see that there's at least a name field.
+   *
+   *********************************************************************
+   */
+  if (strcmp(psSnapshot->psCurrRecord->pcLine, "name") == 0 || strncmp(psSnapshot->psCurrRecord->pcLine, "name|", 5) == 0)
+  {
+    psSnapshot->iBinary = 0;
+    psSnapshot->iCompressed = 0;
+    psSnapshot->iLegacyFile = 0;
+  }
+#ifdef UNIX
+  else if (strcmp(psSnapshot->psCurrRecord->pcLine, "b_name") == 0 || strncmp(psSnapshot->psCurrRecord->pcLine, "b_name|", 7) == 0)
+  {
+    psSnapshot->iBinary = 1;
+    psSnapshot->iCompressed = 0;
+    psSnapshot->iLegacyFile = 0;
+  }
+#endif
+  else if (strcmp(psSnapshot->psCurrRecord->pcLine, "z_name") == 0 || strncmp(psSnapshot->psCurrRecord->pcLine, "z_name|", 7) == 0)
+  {
+    psSnapshot->iBinary = 0;
+    psSnapshot->iCompressed = 1;
+    psSnapshot->iLegacyFile = 0;
+  }
+  else if (strcmp(psSnapshot->psCurrRecord->pcLine, "zname") == 0 || strncmp(psSnapshot->psCurrRecord->pcLine, "zname|", 6) == 0)
+  {
+    psSnapshot->iBinary = 0;
+    psSnapshot->iCompressed = 1;
+    psSnapshot->iLegacyFile = 1;
+  }
+  else
+  {
+    snprintf(pcError, MESSAGE_SIZE, "%s: Header magic is not recognized.", acRoutine);
+    return ER;
+  }
+
+  /*-
+   *********************************************************************
+   *
+   * Then, parse the header, and construct a decode table. Binary
+   * snapshots use the uncompressed field names with a "b_" prefix.
+   * Their records are rendered as uncompressed lines when they are
+   * read, so they are decoded in pass-through mode as well.
+   *
+   *********************************************************************
+   */
+  for (iIndex = 0, pc = strtok(psSnapshot->psCurrRecord->pcLine, DECODE_SEPARATOR_S); pc != NULL; pc = strtok(NULL, DECODE_SEPARATOR_S), iIndex++)
+  {
+    if (psSnapshot->iBinary)
+    {
+      pcName = (strncmp(pc, "b_", 2) == 0) ? &pc[2] : "";
+    }
+    else
+    {
+      pcName = pc;
+    }
+    for (i = 0; i < (int)(DECODE_TABLE_SIZE); i++)
+    {
+      if (psSnapshot->iCompressed)
+      {
+        if (strcmp(gasDecodeTable[i].acZName, pc) == 0)
+        {
+          psSnapshot->aiIndex2Map[iIndex] = i;
+          psSnapshot->psDecodeMap[i] = gasDecodeTable[i]; /* This initializes all elements at the given index. */
+          PUTBIT(psSnapshot->ulFieldMask, 1, i);
+          break;
+        }
+        if (psSnapshot->iLegacyFile)
+        {
+          snprintf(acLegacyName, DECODE_FIELDNAME_SIZE - 1, "z_%s", pc);
+          acLegacyName[DECODE_FIELDNAME_SIZE - 1] = 0;
+          if (strcmp(gasDecodeTable[i].acZName, acLegacyName) == 0 || strcmp("zname", pc) == 0)
+          {
+            psSnapshot->aiIndex2Map[iIndex] = i;
+            psSnapshot->psDecodeMap[i] = gasDecodeTable[i]; /* This initializes all elements at the given index. */
+            PUTBIT(psSnapshot->ulFieldMask, 1, i);
+            break;
+          }
+        }
+      }
+      else
+      {
+        if (strcmp(gasDecodeTable[i].acUName, pcName) == 0)
+        {
+          psSnapshot->aiIndex2Map[iIndex] = i;
+          psSnapshot->psDecodeMap[i] = gasDecodeTable[i]; /* This initializes all elements at the given index. */
+          psSnapshot->psDecodeMap[i].piRoutine = DecodeProcessNada; /* Override the normal decode routine. */
+          PUTBIT(psSnapshot->ulFieldMask, 1, i);
+          break;
+        }
+      }
+    }
+    if (i == DECODE_TABLE_SIZE)
+    {
+      snprintf(pcError, MESSAGE_SIZE, "%s: Field = [%s]: Unrecognized field.", acRoutine, pc);
+      return ER;
+    }
+  }
+
+  /*-
+   *********************************************************************
+   *
+   * Finally, record the last field index -- it's used to represent the
+   * length of the decode table.
+   *
+   *********************************************************************
+   */
+  psSnapshot->iFieldCount = iIndex;
+
+  return ER_OK;
+}
+
+
+/*-
+ ***********************************************************************
+ *
+ * DecodeParseRecord
+ *
+ ***********************************************************************
+ */
+int
+DecodeParseRecord(SNAPSHOT_CONTEXT *psSnapshot, char *pcError)
+{
+  char                acLocalError[MESSAGE_SIZE] = "";
+  char               *pc = NULL;
+  char               *pcEnd = NULL;
+  char               *pcToken = NULL;
+  int                 iDone = 0;
+  int                 iError = 0;
+  int                 iLength = 0;
+  int                 iFieldCount = 1;
+  int                 iFieldIndex = 0;
+
+  /*-
+   *********************************************************************
+   *
+   * Scan the line -- stopping at each delimiter to decode the field.
+   * The delimiters are located with memchr(), which most C libraries
+   * implement with word- or vector-wide scans. Each field is handed to
+   * its decode routine in place (i.e., it is terminated, not copied).
+   *
+   *********************************************************************
+   */
+  pcToken = psSnapshot->psCurrRecord->pcLine;
+  pcEnd = &psSnapshot->psCurrRecord->pcLine[psSnapshot->psCurrRecord->iLineLength];
+  while (!iDone)
+  {
+    if (iFieldCount > psSnapshot->iFieldCount)
+    {
+      snprintf(pcError, MESSAGE_SIZE, "File = [%s], Line = [%d], FieldCount = [%d] > [%d]: FieldCount exceeds expected value.",
+        psSnapshot->pcFile,
+        psSnapshot->iLineNumber,
+        iFieldCount,
+        psSnapshot->iFieldCount
+        );
+      DecodeReportError(psSnapshot, ER_Failure, pcError, ERROR_FAILURE);
+      return ER;
+    }
+    pc = memchr(pcToken, DECODE_SEPARATOR_C, pcEnd - pcToken);
+    if (pc == NULL)
+    {
+      pc = pcEnd;
+      iDone = 1;
+    }
+    *pc = 0; /* Terminate the field value. */
+    iLength = pc - pcToken;
+    iError = psSnapshot->psDecodeMap[psSnapshot->aiIndex2Map[iFieldIndex]].piRoutine(
+      &psSnapshot->sDecodeState,
+      pcToken,
+      iLength,
+      psSnapshot->psCurrRecord->ppcFields[psSnapshot->aiIndex2Map[iFieldIndex]],
+      acLocalError
+      );
+    if (iError == ER)
+    {
+      snprintf(pcError, MESSAGE_SIZE, "File = [%s], Line = [%d], Field = [%s]: %s",
+        psSnapshot->pcFile,
+        psSnapshot->iLineNumber,
+        (psSnapshot->iCompressed) ? psSnapshot->psDecodeMap[psSnapshot->aiIndex2Map[iFieldIndex]].acZName : psSnapshot->psDecodeMap[psSnapshot->aiIndex2Map[iFieldIndex]].acUName,
+        acLocalError
+        );
+      DecodeReportError(psSnapshot, ER_Failure, pcError, ERROR_FAILURE);
+      return ER;
+    }
+    if (!iDone)
+    {
+      iFieldCount++;
+      iFieldIndex++;
+      pcToken = pc + 1;
+    }
+  }
+  if (iFieldCount != psSnapshot->iFieldCount)
+  {
+    snprintf(pcError, MESSAGE_SIZE, "File = [%s], Line = [%d], FieldCount = [%d] != [%d]: FieldCount mismatch!",
+      psSnapshot->pcFile,
+      psSnapshot->iLineNumber,
+      iFieldCount,
+      psSnapshot->iFieldCount
+      );
+    DecodeReportError(psSnapshot, ER_Failure, pcError, ERROR_FAILURE);
+    return ER;
+  }
+
+  /*-
+   *********************************************************************
+   *
+   * Compute the MD5 hash of the name field.
+   *
+   *********************************************************************
+   */
+  DecodeHashName(psSnapshot->psCurrRecord->ppcFields[0], psSnapshot->iNamesAreCaseInsensitive, psSnapshot->psCurrRecord->aucHash);
+
+  return ER_OK;
+}
+
+
+/*-
+ ***********************************************************************
+ *
+ * DecodeProcessATime
+ *
+ ***********************************************************************
+ */
+int
+DecodeProcessATime(DECODE_STATE *psDecodeState, char *pcToken, int iLength, char *pcOutput, char *pcError)
+{
+  const char          acRoutine[] = "DecodeProcessATime()";
+  char                acLocalError[MESSAGE_SIZE] = "";
+  char                acTimeString[DECODE_TIME_FORMAT_SIZE] = { 0 };
+  int                 iError = 0;
+  APP_UI32            ui32Value = 0;
+
+  if (iLength <= 0)
+  {
+    DECODE_UNDEFINE_PREV_NUMBER_VALUE(psDecodeState->atime, psDecodeState->patime);
+    pcOutput[0] = 0;
+    return ER_OK; /* It's not an error if a value is missing. */
+  }
+
+  if (pcToken[0] == '~')
+  {
+    DECODE_UNDEFINE_PREV_NUMBER_VALUE(psDecodeState->atime, psDecodeState->patime);
+    iError = DecodeFormatOutOfBandTime(&pcToken[1], iLength - 1, acTimeString, acLocalError);
+    if (iError == ER)
+    {
+      snprintf(pcError, MESSAGE_SIZE, "%s: %s", acRoutine, acLocalError);
+      return ER;
+    }
+    snprintf(pcOutput, DECODE_TIME_FORMAT_SIZE, "%s", acTimeString);
+    return ER_OK;
+  }
+
+  switch (pcToken[0])
+  {
+  case '#':
+    if (psDecodeState->patime != NULL)
+    {
+      ui32Value = *psDecodeState->patime;
+    }
+    else
+    {
+      snprintf(pcError, MESSAGE_SIZE, "%s: Expected previous value to be defined!", acRoutine);
+      return ER;
+    }
+    break;
+  default:
+    iError = Decode32BitHexToDecimal(pcToken, iLength, &ui32Value, psDecodeState->patime, acLocalError);
+    if (iError == ER)
+    {
+      snprintf(pcError, MESSAGE_SIZE, "%s: %s", acRoutine, acLocalError);
+      return ER;
+    }
+    break;
+  }
+
+  iError = DecodeFormatTime(&ui32Value, pcOutput);
+  if (iError == ER)
+  {
+    snprintf(pcError, MESSAGE_SIZE, "%s: %s", acRoutine, acLocalError);
+    return ER;
+  }
+
+  DECODE_DEFINE_PREV_NUMBER_VALUE(psDecodeState->atime, psDecodeState->patime, ui32Value);
+
+  return ER_OK;
+}
+
+
+/*-
+ ***********************************************************************
+ *
+ * DecodeProcessATimeMs
  *
  ***********************************************************************
  */
@@ -1539,21 +2532,131 @@ DecodeProcessChTimeMs(DECODE_STATE *psDecodeState, char *pcToken, int iLength, c
 /*-
  ***********************************************************************
  *
- * DecodeProcessDevice
+ * DecodeProcessDevice
+ *
+ ***********************************************************************
+ */
+int
+DecodeProcessDevice(DECODE_STATE *psDecodeState, char *pcToken, int iLength, char *pcOutput, char *pcError)
+{
+  const char          acRoutine[] = "DecodeProcessDevice()";
+  char                acLocalError[MESSAGE_SIZE] = "";
+  int                 iError = 0;
+  APP_UI32            ui32Value = 0;
+
+  if (iLength <= 0)
+  {
+    DECODE_UNDEFINE_PREV_NUMBER_VALUE(psDecodeState->dev, psDecodeState->pdev);
+    pcOutput[0] = 0;
+    return ER_OK; /* It's not an error if a value is missing. */
+  }
+
+  /*-
+   *********************************************************************
+   *
+   * If the decode routine returns an error, clear the previous value
+   * and NULLify its pointer. A NULL pointer signifies that the value
+   * is undefined (and, therefore, not to be used). If the decode
+   * routine returns success, record the decoded value in the output
+   * buffer, save it as the new previous value, and update its pointer
+   * as it may have been NULLified in a previous round.
+   *
+   *********************************************************************
+   */
+  iError = Decode32BitHexToDecimal(pcToken, iLength, &ui32Value, psDecodeState->pdev, acLocalError);
+  if (iError == ER)
+  {
+    DECODE_UNDEFINE_PREV_NUMBER_VALUE(psDecodeState->dev, psDecodeState->pdev);
+    snprintf(pcError, MESSAGE_SIZE, "%s: %s", acRoutine, acLocalError);
+    return iError;
+  }
+  else
+  {
+    DECODE_DEFINE_PREV_NUMBER_VALUE(psDecodeState->dev, psDecodeState->pdev, ui32Value);
+    snprintf(pcOutput, FTIMES_MAX_32BIT_SIZE, "%u", ui32Value);
+  }
+
+  return ER_OK;
+}
+
+
+/*-
+ ***********************************************************************
+ *
+ * DecodeProcessFileIndex
+ *
+ ***********************************************************************
+ */
+int
+DecodeProcessFileIndex(DECODE_STATE *psDecodeState, char *pcToken, int iLength, char *pcOutput, char *pcError)
+{
+  const char          acRoutine[] = "DecodeProcessFileIndex()";
+  char                acLocalError[MESSAGE_SIZE] = "";
+  int                 iError = 0;
+  APP_UI64            ui64Value = 0;
+
+  if (iLength <= 0)
+  {
+    DECODE_UNDEFINE_PREV_NUMBER_VALUE(psDecodeState->findex, psDecodeState->pfindex);
+    pcOutput[0] = 0;
+    return ER_OK; /* It's not an error if a value is missing. */
+  }
+
+  /*-
+   *********************************************************************
+   *
+   * If the decode routine returns an error, clear the previous value
+   * and NULLify its pointer. A NULL pointer signifies that the value
+   * is undefined (and, therefore, not to be used). If the decode
+   * routine returns success, record the decoded value in the output
+   * buffer, save it as the new previous value, and update its pointer
+   * as it may have been NULLified in a previous round.
+   *
+   *********************************************************************
+   */
+  iError = Decode64BitHexToDecimal(pcToken, iLength, &ui64Value, psDecodeState->pfindex, acLocalError);
+  if (iError == ER)
+  {
+    DECODE_UNDEFINE_PREV_NUMBER_VALUE(psDecodeState->findex, psDecodeState->pfindex);
+    snprintf(pcError, MESSAGE_SIZE, "%s: %s", acRoutine, acLocalError);
+    return iError;
+  }
+  else
+  {
+    DECODE_DEFINE_PREV_NUMBER_VALUE(psDecodeState->findex, psDecodeState->pfindex, ui64Value);
+#ifdef WIN32
+    snprintf(pcOutput, FTIMES_MAX_64BIT_SIZE, "%I64u", ui64Value);
+#else
+  #ifdef USE_AP_SNPRINTF
+    snprintf(pcOutput, FTIMES_MAX_64BIT_SIZE, "%qu", (unsigned long long) ui64Value);
+  #else
+    snprintf(pcOutput, FTIMES_MAX_64BIT_SIZE, "%llu", (unsigned long long) ui64Value);
+  #endif
+#endif
+  }
+
+  return ER_OK;
+}
+
+
+/*-
+ ***********************************************************************
+ *
+ * DecodeProcessGroupId
  *
  ***********************************************************************
  */
 int
-DecodeProcessDevice(DECODE_STATE *psDecodeState, char *pcToken, int iLength, char *pcOutput, char *pcError)
+DecodeProcessGroupId(DECODE_STATE *psDecodeState, char *pcToken, int iLength, char *pcOutput, char *pcError)
 {
-  const char          acRoutine[] = "DecodeProcessDevice()";
+  const char          acRoutine[] = "DecodeProcessGroupId()";
   char                acLocalError[MESSAGE_SIZE] = "";
   int                 iError = 0;
   APP_UI32            ui32Value = 0;
 
   if (iLength <= 0)
   {
-    DECODE_UNDEFINE_PREV_NUMBER_VALUE(psDecodeState->dev, psDecodeState->pdev);
+    DECODE_UNDEFINE_PREV_NUMBER_VALUE(psDecodeState->gid, psDecodeState->pgid);
     pcOutput[0] = 0;
     return ER_OK; /* It's not an error if a value is missing. */
   }
@@ -1570,16 +2673,16 @@ DecodeProcessDevice(DECODE_STATE *psDecodeState, char *pcToken, int iLength, cha
    *
    *********************************************************************
    */
-  iError = Decode32BitHexToDecimal(pcToken, iLength, &ui32Value, psDecodeState->pdev, acLocalError);
+  iError = Decode32BitHexToDecimal(pcToken, iLength, &ui32Value, psDecodeState->pgid, acLocalError);
   if (iError == ER)
   {
-    DECODE_UNDEFINE_PREV_NUMBER_VALUE(psDecodeState->dev, psDecodeState->pdev);
+    DECODE_UNDEFINE_PREV_NUMBER_VALUE(psDecodeState->gid, psDecodeState->pgid);
     snprintf(pcError, MESSAGE_SIZE, "%s: %s", acRoutine, acLocalError);
     return iError;
   }
   else
   {
-    DECODE_DEFINE_PREV_NUMBER_VALUE(psDecodeState->dev, psDecodeState->pdev, ui32Value);
+    DECODE_DEFINE_PREV_NUMBER_VALUE(psDecodeState->gid, psDecodeState->pgid, ui32Value);
     snprintf(pcOutput, FTIMES_MAX_32BIT_SIZE, "%u", ui32Value);
   }
 
@@ -1590,21 +2693,21 @@ DecodeProcessDevice(DECODE_STATE *psDecodeState, char *pcToken, int iLength, cha
 /*-
  ***********************************************************************
  *
- * DecodeProcessFileIndex
+ * DecodeProcessInode
  *
  ***********************************************************************
  */
 int
-DecodeProcessFileIndex(DECODE_STATE *psDecodeState, char *pcToken, int iLength, char *pcOutput, char *pcError)
+DecodeProcessInode(DECODE_STATE *psDecodeState, char *pcToken, int iLength, char *pcOutput, char *pcError)
 {
-  const char          acRoutine[] = "DecodeProcessFileIndex()";
+  const char          acRoutine[] = "DecodeProcessInode()";
   char                acLocalError[MESSAGE_SIZE] = "";
   int                 iError = 0;
-  APP_UI64            ui64Value = 0;
+  APP_UI32            ui32Value = 0;
 
   if (iLength <= 0)
   {
-    DECODE_UNDEFINE_PREV_NUMBER_VALUE(psDecodeState->findex, psDecodeState->pfindex);
+    DECODE_UNDEFINE_PREV_NUMBER_VALUE(psDecodeState->inode, psDecodeState->pinode);
     pcOutput[0] = 0;
     return ER_OK; /* It's not an error if a value is missing. */
   }
@@ -1621,25 +2724,17 @@ DecodeProcessFileIndex(DECODE_STATE *psDecodeState, char *pcToken, int iLength,
    *
    *********************************************************************
    */
-  iError = Decode64BitHexToDecimal(pcToken, iLength, &ui64Value, psDecodeState->pfindex, acLocalError);
+  iError = Decode32BitHexToDecimal(pcToken, iLength, &ui32Value, psDecodeState->pinode, acLocalError);
   if (iError == ER)
   {
-    DECODE_UNDEFINE_PREV_NUMBER_VALUE(psDecodeState->findex, psDecodeState->pfindex);
+    DECODE_UNDEFINE_PREV_NUMBER_VALUE(psDecodeState->inode, psDecodeState->pinode);
     snprintf(pcError, MESSAGE_SIZE, "%s: %s", acRoutine, acLocalError);
     return iError;
   }
   else
   {
-    DECODE_DEFINE_PREV_NUMBER_VALUE(psDecodeState->findex, psDecodeState->pfindex, ui64Value);
-#ifdef WIN32
-    snprintf(pcOutput, FTIMES_MAX_64BIT_SIZE, "%I64u", ui64Value);
-#else
-  #ifdef USE_AP_SNPRINTF
-    snprintf(pcOutput, FTIMES_MAX_64BIT_SIZE, "%qu", (unsigned long long) ui64Value);
-  #else
-    snprintf(pcOutput, FTIMES_MAX_64BIT_SIZE, "%llu", (unsigned long long) ui64Value);
-  #endif
-#endif
+    DECODE_DEFINE_PREV_NUMBER_VALUE(psDecodeState->inode, psDecodeState->pinode, ui32Value);
+    snprintf(pcOutput, FTIMES_MAX_32BIT_SIZE, "%u", ui32Value);
   }
 
   return ER_OK;
@@ -1649,21 +2744,21 @@ DecodeProcessFileIndex(DECODE_STATE *psDecodeState, char *pcToken, int iLength,
 /*-
  ***********************************************************************
  *
- * DecodeProcessGroupId
+ * DecodeProcessLinkCount
  *
  ***********************************************************************
  */
 int
-DecodeProcessGroupId(DECODE_STATE *psDecodeState, char *pcToken, int iLength, char *pcOutput, char *pcError)
+DecodeProcessLinkCount(DECODE_STATE *psDecodeState, char *pcToken, int iLength, char *pcOutput, char *pcError)
 {
-  const char          acRoutine[] = "DecodeProcessGroupId()";
+  const char          acRoutine[] = "DecodeProcessLinkCount()";
   char                acLocalError[MESSAGE_SIZE] = "";
   int                 iError = 0;
   APP_UI32            ui32Value = 0;
 
   if (iLength <= 0)
   {
-    DECODE_UNDEFINE_PREV_NUMBER_VALUE(psDecodeState->gid, psDecodeState->pgid);
+    DECODE_UNDEFINE_PREV_NUMBER_VALUE(psDecodeState->nlink, psDecodeState->pnlink);
     pcOutput[0] = 0;
     return ER_OK; /* It's not an error if a value is missing. */
   }
@@ -1680,16 +2775,16 @@ DecodeProcessGroupId(DECODE_STATE *psDecodeState, char *pcToken, int iLength, ch
    *
    *********************************************************************
    */
-  iError = Decode32BitHexToDecimal(pcToken, iLength, &ui32Value, psDecodeState->pgid, acLocalError);
+  iError = Decode32BitHexToDecimal(pcToken, iLength, &ui32Value, psDecodeState->pnlink, acLocalError);
   if (iError == ER)
   {
-    DECODE_UNDEFINE_PREV_NUMBER_VALUE(psDecodeState->gid, psDecodeState->pgid);
+    DECODE_UNDEFINE_PREV_NUMBER_VALUE(psDecodeState->nlink, psDecodeState->pnlink);
     snprintf(pcError, MESSAGE_SIZE, "%s: %s", acRoutine, acLocalError);
     return iError;
   }
   else
   {
-    DECODE_DEFINE_PREV_NUMBER_VALUE(psDecodeState->gid, psDecodeState->pgid, ui32Value);
+    DECODE_DEFINE_PREV_NUMBER_VALUE(psDecodeState->nlink, psDecodeState->pnlink, ui32Value);
     snprintf(pcOutput, FTIMES_MAX_32BIT_SIZE, "%u", ui32Value);
   }
 
@@ -1700,48 +2795,208 @@ DecodeProcessGroupId(DECODE_STATE *psDecodeState, char *pcToken, int iLength, ch
 /*-
  ***********************************************************************
  *
- * DecodeProcessInode
+ * DecodeProcessMTime
  *
  ***********************************************************************
  */
 int
-DecodeProcessInode(DECODE_STATE *psDecodeState, char *pcToken, int iLength, char *pcOutput, char *pcError)
+DecodeProcessMTime(DECODE_STATE *psDecodeState, char *pcToken, int iLength, char *pcOutput, char *pcError)
 {
-  const char          acRoutine[] = "DecodeProcessInode()";
+  const char          acRoutine[] = "DecodeProcessMTime()";
   char                acLocalError[MESSAGE_SIZE] = "";
+  char                acTimeString[DECODE_TIME_FORMAT_SIZE] = { 0 };
   int                 iError = 0;
   APP_UI32            ui32Value = 0;
 
   if (iLength <= 0)
   {
-    DECODE_UNDEFINE_PREV_NUMBER_VALUE(psDecodeState->inode, psDecodeState->pinode);
+    DECODE_UNDEFINE_PREV_NUMBER_VALUE(psDecodeState->mtime, psDecodeState->pmtime);
     pcOutput[0] = 0;
     return ER_OK; /* It's not an error if a value is missing. */
   }
 
-  /*-
-   *********************************************************************
-   *
-   * If the decode routine returns an error, clear the previous value
-   * and NULLify its pointer. A NULL pointer signifies that the value
-   * is undefined (and, therefore, not to be used). If the decode
-   * routine returns success, record the decoded value in the output
-   * buffer, save it as the new previous value, and update its pointer
-   * as it may have been NULLified in a previous round.
-   *
-   *********************************************************************
-   */
-  iError = Decode32BitHexToDecimal(pcToken, iLength, &ui32Value, psDecodeState->pinode, acLocalError);
+  if (pcToken[0] == '~')
+  {
+    DECODE_UNDEFINE_PREV_NUMBER_VALUE(psDecodeState->mtime, psDecodeState->pmtime);
+    iError = DecodeFormatOutOfBandTime(&pcToken[1], iLength - 1, acTimeString, acLocalError);
+    if (iError == ER)
+    {
+      snprintf(pcError, MESSAGE_SIZE, "%s: %s", acRoutine, acLocalError);
+      return ER;
+    }
+    snprintf(pcOutput, DECODE_TIME_FORMAT_SIZE, "%s", acTimeString);
+    return ER_OK;
+  }
+
+  switch (pcToken[0])
+  {
+  case '#':
+    if (psDecodeState->pmtime != NULL)
+    {
+      ui32Value = *psDecodeState->pmtime;
+    }
+    else
+    {
+      snprintf(pcError, MESSAGE_SIZE, "%s: Expected previous value to be defined!", acRoutine);
+      return ER;
+    }
+    break;
+  case 'X':
+    if (psDecodeState->patime != NULL)
+    {
+      ui32Value = *psDecodeState->patime;
+    }
+    else
+    {
+      snprintf(pcError, MESSAGE_SIZE, "%s: Expected current atime value to be defined!", acRoutine);
+      return ER;
+    }
+    break;
+  default:
+    iError = Decode32BitHexToDecimal(pcToken, iLength, &ui32Value, psDecodeState->pmtime, acLocalError);
+    if (iError == ER)
+    {
+      snprintf(pcError, MESSAGE_SIZE, "%s: %s", acRoutine, acLocalError);
+      return ER;
+    }
+    break;
+  }
+
+  iError = DecodeFormatTime(&ui32Value, pcOutput);
   if (iError == ER)
   {
-    DECODE_UNDEFINE_PREV_NUMBER_VALUE(psDecodeState->inode, psDecodeState->pinode);
     snprintf(pcError, MESSAGE_SIZE, "%s: %s", acRoutine, acLocalError);
-    return iError;
+    return ER;
+  }
+
+  DECODE_DEFINE_PREV_NUMBER_VALUE(psDecodeState->mtime, psDecodeState->pmtime, ui32Value);
+
+  return ER_OK;
+}
+
+
+/*-
+ ***********************************************************************
+ *
+ * DecodeProcessMTimeMs
+ *
+ ***********************************************************************
+ */
+int
+DecodeProcessMTimeMs(DECODE_STATE *psDecodeState, char *pcToken, int iLength, char *pcOutput, char *pcError)
+{
+  const char          acRoutine[] = "DecodeProcessMTimeMs()";
+  char                acLocalError[MESSAGE_SIZE] = "";
+  int                 iError = 0;
+  APP_UI32            ui32Value = 0;
+
+  if (iLength <= 0)
+  {
+    DECODE_UNDEFINE_PREV_NUMBER_VALUE(psDecodeState->chtime, psDecodeState->pchtime);
+    pcOutput[0] = 0;
+    return ER_OK; /* It's not an error if a value is missing. */
+  }
+
+  switch (pcToken[0])
+  {
+  case '#':
+    if (psDecodeState->pmms != NULL)
+    {
+      ui32Value = *psDecodeState->pmms;
+    }
+    else
+    {
+      snprintf(pcError, MESSAGE_SIZE, "%s: Expected previous value to be defined!", acRoutine);
+      return ER;
+    }
+    break;
+  case 'X':
+    if (psDecodeState->pams != NULL)
+    {
+      ui32Value = *psDecodeState->pams;
+    }
+    else
+    {
+      snprintf(pcError, MESSAGE_SIZE, "%s: Expected current ams value to be defined!", acRoutine);
+      return ER;
+    }
+    break;
+  default:
+    iError = Decode32BitHexToDecimal(pcToken, iLength, &ui32Value, psDecodeState->pmms, acLocalError);
+    if (iError == ER)
+    {
+      snprintf(pcError, MESSAGE_SIZE, "%s: %s", acRoutine, acLocalError);
+      return ER;
+    }
+    break;
+  }
+
+  snprintf(pcOutput, FTIMES_MAX_32BIT_SIZE, "%u", ui32Value);
+
+  DECODE_DEFINE_PREV_NUMBER_VALUE(psDecodeState->mms, psDecodeState->pmms, ui32Value);
+
+  return ER_OK;
+}
+
+
+/*-
+ ***********************************************************************
+ *
+ * DecodeProcessMagic
+ *
+ ***********************************************************************
+ */
+int
+DecodeProcessMagic(DECODE_STATE *psDecodeState, char *pcToken, int iLength, char *pcOutput, char *pcError)
+{
+  memcpy(pcOutput, pcToken, iLength + 1); /* The caller guarantees that pcOutput can hold the entire line. */
+
+  return ER_OK;
+}
+
+
+/*-
+ ***********************************************************************
+ *
+ * DecodeProcessMd5
+ *
+ ***********************************************************************
+ */
+int
+DecodeProcessMd5(DECODE_STATE *psDecodeState, char *pcToken, int iLength, char *pcOutput, char *pcError)
+{
+  const char          acRoutine[] = "DecodeProcessMd5()";
+  char                acLocalError[MESSAGE_SIZE] = "";
+  int                 iError = 0;
+  unsigned char       aucFileMd5[MD5_HASH_SIZE] = { 0 };
+
+  if (iLength <= 0)
+  {
+    pcOutput[0] = 0;
+    return ER_OK; /* It's not an error if a value is missing. */
+  }
+
+  if (pcToken[0] == 'D' && pcToken[1] == 0)
+  {
+    snprintf(pcOutput, DECODE_MAX_LINE, "DIRECTORY");
+  }
+  else if (pcToken[0] == 'L' && pcToken[1] == 0)
+  {
+    snprintf(pcOutput, DECODE_MAX_LINE, "SYMLINK");
+  }
+  else if (pcToken[0] == 'S' && pcToken[1] == 0)
+  {
+    snprintf(pcOutput, DECODE_MAX_LINE, "SPECIAL");
   }
   else
   {
-    DECODE_DEFINE_PREV_NUMBER_VALUE(psDecodeState->inode, psDecodeState->pinode, ui32Value);
-    snprintf(pcOutput, FTIMES_MAX_32BIT_SIZE, "%u", ui32Value);
+    iError = DecodeGetBase64Hash(pcToken, aucFileMd5, iLength, acLocalError);
+    if (iError == ER)
+    {
+      snprintf(pcError, MESSAGE_SIZE, "%s: %s", acRoutine, acLocalError);
+      return ER;
+    }
+    MD5HashToHex(aucFileMd5, pcOutput);
   }
 
   return ER_OK;
@@ -1751,21 +3006,21 @@ DecodeProcessInode(DECODE_STATE *psDecodeState, char *pcToken, int iLength, char
 /*-
  ***********************************************************************
  *
- * DecodeProcessLinkCount
+ * DecodeProcessMode
  *
  ***********************************************************************
  */
 int
-DecodeProcessLinkCount(DECODE_STATE *psDecodeState, char *pcToken, int iLength, char *pcOutput, char *pcError)
+DecodeProcessMode(DECODE_STATE *psDecodeState, char *pcToken, int iLength, char *pcOutput, char *pcError)
 {
-  const char          acRoutine[] = "DecodeProcessLinkCount()";
+  const char          acRoutine[] = "DecodeProcessMode()";
   char                acLocalError[MESSAGE_SIZE] = "";
   int                 iError = 0;
   APP_UI32            ui32Value = 0;
 
   if (iLength <= 0)
   {
-    DECODE_UNDEFINE_PREV_NUMBER_VALUE(psDecodeState->nlink, psDecodeState->pnlink);
+    DECODE_UNDEFINE_PREV_NUMBER_VALUE(psDecodeState->mode, psDecodeState->pmode);
     pcOutput[0] = 0;
     return ER_OK; /* It's not an error if a value is missing. */
   }
@@ -1782,17 +3037,17 @@ DecodeProcessLinkCount(DECODE_STATE *psDecodeState, char *pcToken, int iLength,
    *
    *********************************************************************
    */
-  iError = Decode32BitHexToDecimal(pcToken, iLength, &ui32Value, psDecodeState->pnlink, acLocalError);
+  iError = Decode32BitHexToDecimal(pcToken, iLength, &ui32Value, psDecodeState->pmode, acLocalError);
   if (iError == ER)
   {
-    DECODE_UNDEFINE_PREV_NUMBER_VALUE(psDecodeState->nlink, psDecodeState->pnlink);
+    DECODE_UNDEFINE_PREV_NUMBER_VALUE(psDecodeState->mode, psDecodeState->pmode);
     snprintf(pcError, MESSAGE_SIZE, "%s: %s", acRoutine, acLocalError);
     return iError;
   }
   else
   {
-    DECODE_DEFINE_PREV_NUMBER_VALUE(psDecodeState->nlink, psDecodeState->pnlink, ui32Value);
-    snprintf(pcOutput, FTIMES_MAX_32BIT_SIZE, "%u", ui32Value);
+    DECODE_DEFINE_PREV_NUMBER_VALUE(psDecodeState->mode, psDecodeState->pmode, ui32Value);
+    snprintf(pcOutput, FTIMES_MAX_32BIT_SIZE, "%o", ui32Value);
   }
 
   return ER_OK;
@@ -1802,81 +3057,120 @@ DecodeProcessLinkCount(DECODE_STATE *psDecodeState, char *pcToken, int iLength,
 /*-
  ***********************************************************************
  *
- * DecodeProcessMTime
+ * DecodeProcessNada
  *
  ***********************************************************************
  */
 int
-DecodeProcessMTime(DECODE_STATE *psDecodeState, char *pcToken, int iLength, char *pcOutput, char *pcError)
+DecodeProcessNada(DECODE_STATE *psDecodeState, char *pcToken, int iLength, char *pcOutput, char *pcError)
 {
-  const char          acRoutine[] = "DecodeProcessMTime()";
-  char                acLocalError[MESSAGE_SIZE] = "";
-  char                acTimeString[DECODE_TIME_FORMAT_SIZE] = { 0 };
-  int                 iError = 0;
-  APP_UI32            ui32Value = 0;
+  memcpy(pcOutput, pcToken, iLength + 1); /* The caller guarantees that pcOutput can hold the entire line. */
 
-  if (iLength <= 0)
-  {
-    DECODE_UNDEFINE_PREV_NUMBER_VALUE(psDecodeState->mtime, psDecodeState->pmtime);
-    pcOutput[0] = 0;
-    return ER_OK; /* It's not an error if a value is missing. */
-  }
+  return ER_OK;
+}
 
-  if (pcToken[0] == '~')
+
+/*-
+ ***********************************************************************
+ *
+ * DecodeProcessName
+ *
+ ***********************************************************************
+ */
+int
+DecodeProcessName(DECODE_STATE *psDecodeState, char *pcToken, int iLength, char *pcOutput, char *pcError)
+{
+  const char          acRoutine[] = "DecodeProcessName()";
+  int                 i = 0;
+  int                 j = 0;
+  unsigned int        iFromLastLine = 0;
+
+  if (iLength < 2)
   {
-    DECODE_UNDEFINE_PREV_NUMBER_VALUE(psDecodeState->mtime, psDecodeState->pmtime);
-    iError = DecodeFormatOutOfBandTime(&pcToken[1], iLength - 1, acTimeString, acLocalError);
-    if (iError == ER)
-    {
-      snprintf(pcError, MESSAGE_SIZE, "%s: %s", acRoutine, acLocalError);
-      return ER;
-    }
-    snprintf(pcOutput, DECODE_TIME_FORMAT_SIZE, "%s", acTimeString);
-    return ER_OK;
+    pcOutput[0] = 0;
+    snprintf(pcError, MESSAGE_SIZE, "%s: Name length must be >= 2.", acRoutine);
+    return ER;
   }
 
-  switch (pcToken[0])
+  /*
+   *********************************************************************
+   *
+   * Get 2-byte prefix (i.e., the number of repeated bytes in name)
+   *
+   *********************************************************************
+   */
+  for (i = iFromLastLine = 0; i < 2; i++)
   {
-  case '#':
-    if (psDecodeState->pmtime != NULL)
-    {
-      ui32Value = *psDecodeState->pmtime;
-    }
-    else
+    iFromLastLine <<= 4;
+    if ((pcToken[i] >= '0') && (pcToken[i] <= '9'))
     {
-      snprintf(pcError, MESSAGE_SIZE, "%s: Expected previous value to be defined!", acRoutine);
-      return ER;
+      iFromLastLine |= pcToken[i] - '0';
     }
-    break;
-  case 'X':
-    if (psDecodeState->patime != NULL)
+    else if ((pcToken[i] >= 'a') && (pcToken[i] <= 'f'))
     {
-      ui32Value = *psDecodeState->patime;
+      iFromLastLine |= (pcToken[i] - 'a') + 10;
     }
     else
     {
-      snprintf(pcError, MESSAGE_SIZE, "%s: Expected current atime value to be defined!", acRoutine);
+      snprintf(pcError, MESSAGE_SIZE, "%s: Illegal 2-byte prefix.", acRoutine);
       return ER;
     }
-    break;
-  default:
-    iError = Decode32BitHexToDecimal(pcToken, iLength, &ui32Value, psDecodeState->pmtime, acLocalError);
-    if (iError == ER)
+  }
+  if (iFromLastLine > strlen(psDecodeState->name))
+  {
+    snprintf(pcError, MESSAGE_SIZE, "%s: Not enough bytes available to perform decode.", acRoutine);
+    return ER;
+  }
+
+  /*
+   *********************************************************************
+   *
+   * Copy the rest of the current name to the previous name.
+   *
+   *********************************************************************
+   */
+  if (iFromLastLine == 0)
+  {
+    psDecodeState->name[0] = '"';
+    j = 1;
+    i = 3;
+  }
+  else
+  {
+    j = iFromLastLine;
+    i = 2;
+  }
+  while (pcToken[i] != 0 && pcToken[i] != '"')
+  {
+    if (j >= DECODE_MAX_PATH - 2)
     {
-      snprintf(pcError, MESSAGE_SIZE, "%s: %s", acRoutine, acLocalError);
+      snprintf(pcError, MESSAGE_SIZE, "%s: Name length exceeds %d bytes.", acRoutine, DECODE_MAX_PATH - 2);
       return ER;
     }
-    break;
+    psDecodeState->name[j++] = pcToken[i++];
   }
-
-  iError = DecodeFormatTime(&ui32Value, pcOutput);
-  if (iError == ER)
+  if (pcToken[i] != '"')
   {
-    snprintf(pcError, MESSAGE_SIZE, "%s: %s", acRoutine, acLocalError);
+    snprintf(pcError, MESSAGE_SIZE, "%s: Names must end with a double quote.", acRoutine);
     return ER;
   }
+  psDecodeState->name[j++] = pcToken[i++];
+  psDecodeState->name[j] = 0;
 
-  DECODE_DEFINE_PREV_NUMBER_VALUE(psDecodeState->mtime, psDecodeState->pmtime, ui32Value);
+  snprintf(pcOutput, DECODE_MAX_LINE, "%s", psDecodeState->name);
+
+  /*
+   *********************************************************************
+   *
+   * Sanity check the name value.
+   *
+   *********************************************************************
+   */
+  if (psDecodeState->name[0] != '"' || psDecodeState->name[j - 1] != '"')
+  {
+    snprintf(pcError, MESSAGE_SIZE, "%s: Names must be enclosed in double quotes.", acRoutine);
+    return ER;
+  }
 
   return ER_OK;
 }
@@ -1885,62 +3179,49 @@ DecodeProcessMTime(DECODE_STATE *psDecodeState, char *pcToken, int iLength, char
 /*-
  ***********************************************************************
  *
- * DecodeProcessMTimeMs
+ * DecodeProcessRDevice
  *
  ***********************************************************************
  */
 int
-DecodeProcessMTimeMs(DECODE_STATE *psDecodeState, char *pcToken, int iLength, char *pcOutput, char *pcError)
+DecodeProcessRDevice(DECODE_STATE *psDecodeState, char *pcToken, int iLength, char *pcOutput, char *pcError)
 {
-  const char          acRoutine[] = "DecodeProcessMTimeMs()";
+  const char          acRoutine[] = "DecodeProcessRDevice()";
   char                acLocalError[MESSAGE_SIZE] = "";
   int                 iError = 0;
   APP_UI32            ui32Value = 0;
 
   if (iLength <= 0)
   {
-    DECODE_UNDEFINE_PREV_NUMBER_VALUE(psDecodeState->chtime, psDecodeState->pchtime);
+    DECODE_UNDEFINE_PREV_NUMBER_VALUE(psDecodeState->rdev, psDecodeState->prdev);
     pcOutput[0] = 0;
     return ER_OK; /* It's not an error if a value is missing. */
   }
 
-  switch (pcToken[0])
+  /*-
+   *********************************************************************
+   *
+   * If the decode routine returns an error, clear the previous value
+   * and NULLify its pointer. A NULL pointer signifies that the value
+   * is undefined (and, therefore, not to be used). If the decode
+   * routine returns success, record the decoded value in the output
+   * buffer, save it as the new previous value, and update its pointer
+   * as it may have been NULLified in a previous round.
+   *
+   *********************************************************************
+   */
+  iError = Decode32BitHexToDecimal(pcToken, iLength, &ui32Value, psDecodeState->prdev, acLocalError);
+  if (iError == ER)
   {
-  case '#':
-    if (psDecodeState->pmms != NULL)
-    {
-      ui32Value = *psDecodeState->pmms;
-    }
-    else
-    {
-      snprintf(pcError, MESSAGE_SIZE, "%s: Expected previous value to be defined!", acRoutine);
-      return ER;
-    }
-    break;
-  case 'X':
-    if (psDecodeState->pams != NULL)
-    {
-      ui32Value = *psDecodeState->pams;
-    }
-    else
-    {
-      snprintf(pcError, MESSAGE_SIZE, "%s: Expected current ams value to be defined!", acRoutine);
-      return ER;
-    }
-    break;
-  default:
-    iError = Decode32BitHexToDecimal(pcToken, iLength, &ui32Value, psDecodeState->pmms, acLocalError);
-    if (iError == ER)
-    {
-      snprintf(pcError, MESSAGE_SIZE, "%s: %s", acRoutine, acLocalError);
-      return ER;
-    }
-    break;
+    DECODE_UNDEFINE_PREV_NUMBER_VALUE(psDecodeState->rdev, psDecodeState->prdev);
+    snprintf(pcError, MESSAGE_SIZE, "%s: %s", acRoutine, acLocalError);
+    return iError;
+  }
+  else
+  {
+    DECODE_DEFINE_PREV_NUMBER_VALUE(psDecodeState->rdev, psDecodeState->prdev, ui32Value);
+    snprintf(pcOutput, FTIMES_MAX_32BIT_SIZE, "%u", ui32Value);
   }
-
-  snprintf(pcOutput, FTIMES_MAX_32BIT_SIZE, "%u", ui32Value);
-
-  DECODE_DEFINE_PREV_NUMBER_VALUE(psDecodeState->mms, psDecodeState->pmms, ui32Value);
 
   return ER_OK;
 }
@@ -1949,14 +3230,46 @@ DecodeProcessMTimeMs(DECODE_STATE *psDecodeState, char *pcToken, int iLength, ch
 /*-
  ***********************************************************************
  *
- * DecodeProcessMagic
+ * DecodeProcessSha1
  *
  ***********************************************************************
  */
 int
-DecodeProcessMagic(DECODE_STATE *psDecodeState, char *pcToken, int iLength, char *pcOutput, char *pcError)
+DecodeProcessSha1(DECODE_STATE *psDecodeState, char *pcToken, int iLength, char *pcOutput, char *pcError)
 {
-  snprintf(pcOutput, DECODE_MAX_LINE, "%s", pcToken);
+  const char          acRoutine[] = "DecodeProcessSha1()";
+  char                acLocalError[MESSAGE_SIZE] = "";
+  int                 iError = 0;
+  unsigned char       aucFileSha1[SHA1_HASH_SIZE] = { 0 };
+
+  if (iLength <= 0)
+  {
+    pcOutput[0] = 0;
+    return ER_OK; /* It's not an error if a value is missing. */
+  }
+
+  if (pcToken[0] == 'D' && pcToken[1] == 0)
+  {
+    snprintf(pcOutput, DECODE_MAX_LINE, "DIRECTORY");
+  }
+  else if (pcToken[0] == 'L' && pcToken[1] == 0)
+  {
+    snprintf(pcOutput, DECODE_MAX_LINE, "SYMLINK");
+  }
+  else if (pcToken[0] == 'S' && pcToken[1] == 0)
+  {
+    snprintf(pcOutput, DECODE_MAX_LINE, "SPECIAL");
+  }
+  else
+  {
+    iError = DecodeGetBase64Hash(pcToken, aucFileSha1, iLength, acLocalError);
+    if (iError == ER)
+    {
+      snprintf(pcError, MESSAGE_SIZE, "%s: %s", acRoutine, acLocalError);
+      return iError;
+    }
+    SHA1HashToHex(aucFileSha1, pcOutput);
+  }
 
   return ER_OK;
 }
@@ -1965,17 +3278,17 @@ DecodeProcessMagic(DECODE_STATE *psDecodeState, char *pcToken, int iLength, char
 /*-
  ***********************************************************************
  *
- * DecodeProcessMd5
+ * DecodeProcessSha256
  *
  ***********************************************************************
  */
 int
-DecodeProcessMd5(DECODE_STATE *psDecodeState, char *pcToken, int iLength, char *pcOutput, char *pcError)
+DecodeProcessSha256(DECODE_STATE *psDecodeState, char *pcToken, int iLength, char *pcOutput, char *pcError)
 {
-  const char          acRoutine[] = "DecodeProcessMd5()";
+  const char          acRoutine[] = "DecodeProcessSha256()";
   char                acLocalError[MESSAGE_SIZE] = "";
   int                 iError = 0;
-  unsigned char       aucFileMd5[MD5_HASH_SIZE] = { 0 };
+  unsigned char       aucFileSha256[SHA256_HASH_SIZE] = { 0 };
 
   if (iLength <= 0)
   {
@@ -1997,13 +3310,13 @@ DecodeProcessMd5(DECODE_STATE *psDecodeState, char *pcToken, int iLength, char *
   }
   else
   {
-    iError = DecodeGetBase64Hash(pcToken, aucFileMd5, iLength, acLocalError);
+    iError = DecodeGetBase64Hash(pcToken, aucFileSha256, iLength, acLocalError);
     if (iError == ER)
     {
       snprintf(pcError, MESSAGE_SIZE, "%s: %s", acRoutine, acLocalError);
-      return ER;
+      return iError;
     }
-    MD5HashToHex(aucFileMd5, pcOutput);
+    SHA256HashToHex(aucFileSha256, pcOutput);
   }
 
   return ER_OK;
@@ -2013,21 +3326,21 @@ DecodeProcessMd5(DECODE_STATE *psDecodeState, char *pcToken, int iLength, char *
 /*-
  ***********************************************************************
  *
- * DecodeProcessMode
+ * DecodeProcessSize
  *
  ***********************************************************************
  */
 int
-DecodeProcessMode(DECODE_STATE *psDecodeState, char *pcToken, int iLength, char *pcOutput, char *pcError)
+DecodeProcessSize(DECODE_STATE *psDecodeState, char *pcToken, int iLength, char *pcOutput, char *pcError)
 {
-  const char          acRoutine[] = "DecodeProcessMode()";
+  const char          acRoutine[] = "DecodeProcessSize()";
   char                acLocalError[MESSAGE_SIZE] = "";
   int                 iError = 0;
-  APP_UI32            ui32Value = 0;
+  APP_UI64            ui64Value = 0;
 
   if (iLength <= 0)
   {
-    DECODE_UNDEFINE_PREV_NUMBER_VALUE(psDecodeState->mode, psDecodeState->pmode);
+    DECODE_UNDEFINE_PREV_NUMBER_VALUE(psDecodeState->size, psDecodeState->psize);
     pcOutput[0] = 0;
     return ER_OK; /* It's not an error if a value is missing. */
   }
@@ -2044,17 +3357,25 @@ DecodeProcessMode(DECODE_STATE *psDecodeState, char *pcToken, int iLength, char
    *
    *********************************************************************
    */
-  iError = Decode32BitHexToDecimal(pcToken, iLength, &ui32Value, psDecodeState->pmode, acLocalError);
+  iError = Decode64BitHexToDecimal(pcToken, iLength, &ui64Value, psDecodeState->psize, acLocalError);
   if (iError == ER)
   {
-    DECODE_UNDEFINE_PREV_NUMBER_VALUE(psDecodeState->mode, psDecodeState->pmode);
+    DECODE_UNDEFINE_PREV_NUMBER_VALUE(psDecodeState->size, psDecodeState->psize);
     snprintf(pcError, MESSAGE_SIZE, "%s: %s", acRoutine, acLocalError);
     return iError;
   }
   else
   {
-    DECODE_DEFINE_PREV_NUMBER_VALUE(psDecodeState->mode, psDecodeState->pmode, ui32Value);
-    snprintf(pcOutput, FTIMES_MAX_32BIT_SIZE, "%o", ui32Value);
+    DECODE_DEFINE_PREV_NUMBER_VALUE(psDecodeState->size, psDecodeState->psize, ui64Value);
+#ifdef WIN32
+    snprintf(pcOutput, FTIMES_MAX_64BIT_SIZE, "%I64u", ui64Value);
+#else
+  #ifdef USE_AP_SNPRINTF
+    snprintf(pcOutput, FTIMES_MAX_64BIT_SIZE, "%qu", (unsigned long long) ui64Value);
+  #else
+    snprintf(pcOutput, FTIMES_MAX_64BIT_SIZE, "%llu", (unsigned long long) ui64Value);
+  #endif
+#endif
   }
 
   return ER_OK;
@@ -2064,114 +3385,48 @@ DecodeProcessMode(DECODE_STATE *psDecodeState, char *pcToken, int iLength, char
 /*-
  ***********************************************************************
  *
- * DecodeProcessNada
- *
- ***********************************************************************
- */
-int
-DecodeProcessNada(DECODE_STATE *psDecodeState, char *pcToken, int iLength, char *pcOutput, char *pcError)
-{
-  snprintf(pcOutput, DECODE_MAX_LINE, "%s", pcToken);
-
-  return ER_OK;
-}
-
-
-/*-
- ***********************************************************************
- *
- * DecodeProcessName
+ * DecodeProcessUserId
  *
  ***********************************************************************
  */
 int
-DecodeProcessName(DECODE_STATE *psDecodeState, char *pcToken, int iLength, char *pcOutput, char *pcError)
+DecodeProcessUserId(DECODE_STATE *psDecodeState, char *pcToken, int iLength, char *pcOutput, char *pcError)
 {
-  const char          acRoutine[] = "DecodeProcessName()";
-  int                 i = 0;
-  int                 j = 0;
-  unsigned int        iFromLastLine = 0;
+  const char          acRoutine[] = "DecodeProcessUserId()";
+  char                acLocalError[MESSAGE_SIZE] = "";
+  int                 iError = 0;
+  APP_UI32            ui32Value = 0;
 
-  if (iLength < 2)
+  if (iLength <= 0)
   {
+    DECODE_UNDEFINE_PREV_NUMBER_VALUE(psDecodeState->uid, psDecodeState->puid);
     pcOutput[0] = 0;
-    snprintf(pcError, MESSAGE_SIZE, "%s: Name length must be >= 2.", acRoutine);
-    return ER;
-  }
-
-  /*
-   *********************************************************************
-   *
-   * Get 2-byte prefix (i.e., the number of repeated bytes in name)
-   *
-   *********************************************************************
-   */
-  for (i = iFromLastLine = 0; i < 2; i++)
-  {
-    iFromLastLine <<= 4;
-    if ((pcToken[i] >= '0') && (pcToken[i] <= '9'))
-    {
-      iFromLastLine |= pcToken[i] - '0';
-    }
-    else if ((pcToken[i] >= 'a') && (pcToken[i] <= 'f'))
-    {
-      iFromLastLine |= (pcToken[i] - 'a') + 10;
-    }
-    else
-    {
-      snprintf(pcError, MESSAGE_SIZE, "%s: Illegal 2-byte prefix.", acRoutine);
-      return ER;
-    }
-  }
-  if (iFromLastLine > strlen(psDecodeState->name))
-  {
-    snprintf(pcError, MESSAGE_SIZE, "%s: Not enough bytes available to perform decode.", acRoutine);
-    return ER;
+    return ER_OK; /* It's not an error if a value is missing. */
   }
 
-  /*
+  /*-
    *********************************************************************
    *
-   * Copy the rest of the current name to the previous name.
+   * If the decode routine returns an error, clear the previous value
+   * and NULLify its pointer. A NULL pointer signifies that the value
+   * is undefined (and, therefore, not to be used). If the decode
+   * routine returns success, record the decoded value in the output
+   * buffer, save it as the new previous value, and update its pointer
+   * as it may have been NULLified in a previous round.
    *
    *********************************************************************
    */
-  if (iFromLastLine == 0)
+  iError = Decode32BitHexToDecimal(pcToken, iLength, &ui32Value, psDecodeState->puid, acLocalError);
+  if (iError == ER)
   {
-    psDecodeState->name[0] = '"';
-    j = 1;
-    i = 3;
+    DECODE_UNDEFINE_PREV_NUMBER_VALUE(psDecodeState->uid, psDecodeState->puid);
+    snprintf(pcError, MESSAGE_SIZE, "%s: %s", acRoutine, acLocalError);
+    return iError;
   }
   else
   {
-    j = iFromLastLine;
-    i = 2;
-  }
-  while (pcToken[i] != 0 && pcToken[i] != '"')
-  {
-    psDecodeState->name[j++] = pcToken[i++];
-  }
-  if (pcToken[i] != '"')
-  {
-    snprintf(pcError, MESSAGE_SIZE, "%s: Names must end with a double quote.", acRoutine);
-    return ER;
-  }
-  psDecodeState->name[j++] = pcToken[i++];
-  psDecodeState->name[j] = 0;
-
-  snprintf(pcOutput, DECODE_MAX_LINE, "%s", psDecodeState->name);
-
-  /*
-   *********************************************************************
-   *
-   * Sanity check the name value.
-   *
-   *********************************************************************
-   */
-  if (psDecodeState->name[0] != '"' || psDecodeState->name[j - 1] != '"')
-  {
-    snprintf(pcError, MESSAGE_SIZE, "%s: Names must be enclosed in double quotes.", acRoutine);
-    return ER;
+    DECODE_DEFINE_PREV_NUMBER_VALUE(psDecodeState->uid, psDecodeState->puid, ui32Value);
+    snprintf(pcOutput, FTIMES_MAX_32BIT_SIZE, "%u", ui32Value);
   }
 
   return ER_OK;
@@ -2181,21 +3436,21 @@ DecodeProcessName(DECODE_STATE *psDecodeState, char *pcToken, int iLength, char
 /*-
  ***********************************************************************
  *
- * DecodeProcessRDevice
+ * DecodeProcessVolume
  *
  ***********************************************************************
  */
 int
-DecodeProcessRDevice(DECODE_STATE *psDecodeState, char *pcToken, int iLength, char *pcOutput, char *pcError)
+DecodeProcessVolume(DECODE_STATE *psDecodeState, char *pcToken, int iLength, char *pcOutput, char *pcError)
 {
-  const char          acRoutine[] = "DecodeProcessRDevice()";
+  const char          acRoutine[] = "DecodeProcessVolume()";
   char                acLocalError[MESSAGE_SIZE] = "";
   int                 iError = 0;
   APP_UI32            ui32Value = 0;
 
   if (iLength <= 0)
   {
-    DECODE_UNDEFINE_PREV_NUMBER_VALUE(psDecodeState->rdev, psDecodeState->prdev);
+    DECODE_UNDEFINE_PREV_NUMBER_VALUE(psDecodeState->volume, psDecodeState->pvolume);
     pcOutput[0] = 0;
     return ER_OK; /* It's not an error if a value is missing. */
   }
@@ -2212,16 +3467,16 @@ DecodeProcessRDevice(DECODE_STATE *psDecodeState, char *pcToken, int iLength, ch
    *
    *********************************************************************
    */
-  iError = Decode32BitHexToDecimal(pcToken, iLength, &ui32Value, psDecodeState->prdev, acLocalError);
+  iError = Decode32BitHexToDecimal(pcToken, iLength, &ui32Value, psDecodeState->pvolume, acLocalError);
   if (iError == ER)
   {
-    DECODE_UNDEFINE_PREV_NUMBER_VALUE(psDecodeState->rdev, psDecodeState->prdev);
+    DECODE_UNDEFINE_PREV_NUMBER_VALUE(psDecodeState->volume, psDecodeState->pvolume);
     snprintf(pcError, MESSAGE_SIZE, "%s: %s", acRoutine, acLocalError);
     return iError;
   }
   else
   {
-    DECODE_DEFINE_PREV_NUMBER_VALUE(psDecodeState->rdev, psDecodeState->prdev, ui32Value);
+    DECODE_DEFINE_PREV_NUMBER_VALUE(psDecodeState->volume, psDecodeState->pvolume, ui32Value);
     snprintf(pcOutput, FTIMES_MAX_32BIT_SIZE, "%u", ui32Value);
   }
 
@@ -2232,95 +3487,180 @@ DecodeProcessRDevice(DECODE_STATE *psDecodeState, char *pcToken, int iLength, ch
 /*-
  ***********************************************************************
  *
- * DecodeProcessSha1
+ * DecodeReadBinaryRecord
  *
  ***********************************************************************
  */
 int
-DecodeProcessSha1(DECODE_STATE *psDecodeState, char *pcToken, int iLength, char *pcOutput, char *pcError)
+DecodeReadBinaryRecord(SNAPSHOT_CONTEXT *psSnapshot, char *pcError)
 {
-  const char          acRoutine[] = "DecodeProcessSha1()";
+  const char          acRoutine[] = "DecodeReadBinaryRecord()";
   char                acLocalError[MESSAGE_SIZE] = "";
+  char                acMessage[MESSAGE_SIZE] = "";
   int                 iError = 0;
-  unsigned char       aucFileSha1[SHA1_HASH_SIZE] = { 0 };
+  int                 iLength = 0;
+  int                 n = 0;
+  unsigned char       aucLength[DECODE_BINARY_LENGTH_SIZE];
+  APP_UI32            ui32Length = 0;
 
-  if (iLength <= 0)
+  /*-
+   *********************************************************************
+   *
+   * Each binary record is a little-endian length followed by that
+   * many bytes of tagged fields. A record that is cut short ends the
+   * snapshot, and so does a length that is out of range since there
+   * is no way to resynchronize. A record that is framed correctly,
+   * but fails to render, is simply skipped.
+   *
+   *********************************************************************
+   */
+  for (;;)
   {
-    pcOutput[0] = 0;
-    return ER_OK; /* It's not an error if a value is missing. */
-  }
+    psSnapshot->psCurrRecord->ui64Offset = psSnapshot->ui64ReadBase + psSnapshot->iReadOffset;
+    n = DecodeReadData(psSnapshot, (char *) aucLength, DECODE_BINARY_LENGTH_SIZE, acLocalError);
+    if (n == ER)
+    {
+      snprintf(pcError, MESSAGE_SIZE, "%s: %s", acRoutine, acLocalError);
+      return ER;
+    }
+    if (n == 0)
+    {
+      return 0; /* Assume we've reached EOF. */
+    }
+    if (n != DECODE_BINARY_LENGTH_SIZE)
+    {
+      snprintf(acMessage, MESSAGE_SIZE, "File = [%s], Line = [%d]: Truncated record length. Stopping.", psSnapshot->pcFile, psSnapshot->iLineNumber);
+      DecodeReportError(psSnapshot, ER_Warning, acMessage, ERROR_WARNING);
+      return 0;
+    }
+    ui32Length = ((APP_UI32) aucLength[0]) | ((APP_UI32) aucLength[1] << 8) | ((APP_UI32) aucLength[2] << 16) | ((APP_UI32) aucLength[3] << 24);
+    if (ui32Length == 0 || ui32Length > DECODE_BINARY_MAX_RECORD)
+    {
+      snprintf(acMessage, MESSAGE_SIZE, "File = [%s], Line = [%d], Length = [%lu]: Record length is out of range. Stopping.", psSnapshot->pcFile, psSnapshot->iLineNumber, (unsigned long) ui32Length);
+      DecodeReportError(psSnapshot, ER_Failure, acMessage, ERROR_FAILURE);
+      return 0;
+    }
 
-  if (pcToken[0] == 'D' && pcToken[1] == 0)
-  {
-    snprintf(pcOutput, DECODE_MAX_LINE, "DIRECTORY");
-  }
-  else if (pcToken[0] == 'L' && pcToken[1] == 0)
-  {
-    snprintf(pcOutput, DECODE_MAX_LINE, "SYMLINK");
-  }
-  else if (pcToken[0] == 'S' && pcToken[1] == 0)
-  {
-    snprintf(pcOutput, DECODE_MAX_LINE, "SPECIAL");
-  }
-  else
-  {
-    iError = DecodeGetBase64Hash(pcToken, aucFileSha1, iLength, acLocalError);
-    if (iError == ER)
+    psSnapshot->sBinaryRecord.iLength = 0;
+    iError = DecodeAppendBuffer(&psSnapshot->sBinaryRecord, NULL, (int) ui32Length, acLocalError);
+    if (iError != ER_OK)
     {
       snprintf(pcError, MESSAGE_SIZE, "%s: %s", acRoutine, acLocalError);
-      return iError;
+      return ER;
     }
-    SHA1HashToHex(aucFileSha1, pcOutput);
+    n = DecodeReadData(psSnapshot, psSnapshot->sBinaryRecord.pcData, (int) ui32Length, acLocalError);
+    if (n == ER)
+    {
+      snprintf(pcError, MESSAGE_SIZE, "%s: %s", acRoutine, acLocalError);
+      return ER;
+    }
+    if (n != (int) ui32Length)
+    {
+      snprintf(acMessage, MESSAGE_SIZE, "File = [%s], Line = [%d]: Truncated record. Stopping.", psSnapshot->pcFile, psSnapshot->iLineNumber);
+      DecodeReportError(psSnapshot, ER_Warning, acMessage, ERROR_WARNING);
+      return 0;
+    }
+
+    iLength = DecodeFormatBinaryRecord(psSnapshot, (unsigned char *) psSnapshot->sBinaryRecord.pcData, n, acLocalError);
+    if (iLength != ER)
+    {
+      break;
+    }
+    snprintf(acMessage, MESSAGE_SIZE, "File = [%s], Line = [%d]: %s", psSnapshot->pcFile, psSnapshot->iLineNumber, acLocalError);
+    DecodeReportError(psSnapshot, ER_Failure, acMessage, ERROR_FAILURE);
+    psSnapshot->sDecodeStats.ulSkipped++;
   }
 
-  return ER_OK;
+  return iLength;
 }
 
 
 /*-
  ***********************************************************************
  *
- * DecodeProcessSha256
+ * DecodeReadData
  *
  ***********************************************************************
  */
 int
-DecodeProcessSha256(DECODE_STATE *psDecodeState, char *pcToken, int iLength, char *pcOutput, char *pcError)
+DecodeReadData(SNAPSHOT_CONTEXT *psSnapshot, char *pcData, int iLength, char *pcError)
 {
-  const char          acRoutine[] = "DecodeProcessSha256()";
-  char                acLocalError[MESSAGE_SIZE] = "";
-  int                 iError = 0;
-  unsigned char       aucFileSha256[SHA256_HASH_SIZE] = { 0 };
+  const char          acRoutine[] = "DecodeReadData()";
+  int                 iCount = 0;
+  int                 n = 0;
 
-  if (iLength <= 0)
+  /*-
+   *********************************************************************
+   *
+   * Copy the requested number of bytes out of the read buffer, and
+   * refill it as needed. A short count means that EOF was reached.
+   *
+   *********************************************************************
+   */
+  for (iCount = 0; iCount < iLength; iCount += n)
   {
-    pcOutput[0] = 0;
-    return ER_OK; /* It's not an error if a value is missing. */
+    if (psSnapshot->iReadOffset >= psSnapshot->iReadLength)
+    {
+      psSnapshot->ui64ReadBase += psSnapshot->iReadLength;
+      psSnapshot->iReadOffset = 0;
+      psSnapshot->iReadLength = (psSnapshot->pFile == NULL) ? 0 : fread(psSnapshot->pcReadBuffer, 1, DECODE_READ_BUFSIZE, psSnapshot->pFile);
+      if (psSnapshot->iReadLength == 0)
+      {
+        if (psSnapshot->pFile != NULL && ferror(psSnapshot->pFile))
+        {
+          snprintf(pcError, MESSAGE_SIZE, "%s: fread(): %s", acRoutine, strerror(errno));
+          return ER;
+        }
+        break;
+      }
+    }
+    n = psSnapshot->iReadLength - psSnapshot->iReadOffset;
+    if (n > iLength - iCount)
+    {
+      n = iLength - iCount;
+    }
+    memcpy(&pcData[iCount], &psSnapshot->pcReadBuffer[psSnapshot->iReadOffset], n);
+    psSnapshot->iReadOffset += n;
   }
 
-  if (pcToken[0] == 'D' && pcToken[1] == 0)
-  {
-    snprintf(pcOutput, DECODE_MAX_LINE, "DIRECTORY");
-  }
-  else if (pcToken[0] == 'L' && pcToken[1] == 0)
-  {
-    snprintf(pcOutput, DECODE_MAX_LINE, "SYMLINK");
-  }
-  else if (pcToken[0] == 'S' && pcToken[1] == 0)
+  return iCount;
+}
+
+
+/*-
+ ***********************************************************************
+ *
+ * DecodeReadIndexEntry
+ *
+ ***********************************************************************
+ */
+int
+DecodeReadIndexEntry(FILE *pFile, APP_UI64 ui64Entry, DECODE_INDEX_ENTRY *psEntry, char *pcError)
+{
+  const char          acRoutine[] = "DecodeReadIndexEntry()";
+  char                acLocalError[MESSAGE_SIZE] = "";
+  int                 iError = 0;
+  unsigned char       aucEntry[DECODE_INDEX_ENTRY_SIZE];
+
+  iError = DecodeSeekFile(pFile, DECODE_INDEX_HEADER_SIZE + (ui64Entry * DECODE_INDEX_ENTRY_SIZE), acLocalError);
+  if (iError != ER_OK)
   {
-    snprintf(pcOutput, DECODE_MAX_LINE, "SPECIAL");
+    snprintf(pcError, MESSAGE_SIZE, "%s: %s", acRoutine, acLocalError);
+    return ER;
   }
-  else
+
+  if (fread(aucEntry, 1, DECODE_INDEX_ENTRY_SIZE, pFile) != DECODE_INDEX_ENTRY_SIZE)
   {
-    iError = DecodeGetBase64Hash(pcToken, aucFileSha256, iLength, acLocalError);
-    if (iError == ER)
-    {
-      snprintf(pcError, MESSAGE_SIZE, "%s: %s", acRoutine, acLocalError);
-      return iError;
-    }
-    SHA256HashToHex(aucFileSha256, pcOutput);
+    snprintf(pcError, MESSAGE_SIZE, "%s: fread(): Entry = [%lu]: Short read or truncated index.", acRoutine, (unsigned long) ui64Entry);
+    return ER;
   }
 
+  memcpy(psEntry->aucHash, aucEntry, MD5_HASH_SIZE);
+  DECODE_UNPACK_NUMBER(&aucEntry[16], psEntry->ui64Offset, 8);
+  DECODE_UNPACK_NUMBER(&aucEntry[24], psEntry->ui64SyncOffset, 8);
+  DECODE_UNPACK_NUMBER(&aucEntry[32], psEntry->ui32Line, 4);
+  DECODE_UNPACK_NUMBER(&aucEntry[36], psEntry->ui32SyncLine, 4);
+
   return ER_OK;
 }
 
@@ -2328,330 +3668,700 @@ DecodeProcessSha256(DECODE_STATE *psDecodeState, char *pcToken, int iLength, cha
 /*-
  ***********************************************************************
  *
- * DecodeProcessSize
+ * DecodeReadLine
  *
  ***********************************************************************
  */
-int
-DecodeProcessSize(DECODE_STATE *psDecodeState, char *pcToken, int iLength, char *pcOutput, char *pcError)
+char *
+DecodeReadLine(SNAPSHOT_CONTEXT *psSnapshot, char *pcError)
 {
-  const char          acRoutine[] = "DecodeProcessSize()";
+  const char          acRoutine[] = "DecodeReadLine()";
   char                acLocalError[MESSAGE_SIZE] = "";
+  char               *pc = NULL;
+  char               *pcData = NULL;
   int                 iError = 0;
-  APP_UI64            ui64Value = 0;
+  int                 iFound = 0;
+  int                 iLength = 0;
+  int                 n = 0;
 
-  if (iLength <= 0)
+  if (psSnapshot->pcReadBuffer == NULL)
   {
-    DECODE_UNDEFINE_PREV_NUMBER_VALUE(psDecodeState->size, psDecodeState->psize);
-    pcOutput[0] = 0;
-    return ER_OK; /* It's not an error if a value is missing. */
+    psSnapshot->pcReadBuffer = (char *) malloc(DECODE_READ_BUFSIZE);
+    if (psSnapshot->pcReadBuffer == NULL)
+    {
+      snprintf(pcError, MESSAGE_SIZE, "%s: malloc(): %s", acRoutine, strerror(errno));
+      return NULL;
+    }
+    psSnapshot->iReadLength = psSnapshot->iReadOffset = 0;
   }
 
+  do
+  {
+    /*-
+     *******************************************************************
+     *
+     * Flip the current and previous records. This is how we maintain
+     * state from line to line when decoding a compressed file. The
+     * current line number is used to determine the new index values,
+     * so it must not be modified anywhere else in the code.
+     *
+     *******************************************************************
+     */
+    psSnapshot->psCurrRecord = &psSnapshot->asRecords[(0 + psSnapshot->iLineNumber) % 2];
+    psSnapshot->psPrevRecord = &psSnapshot->asRecords[(1 + psSnapshot->iLineNumber) % 2];
+    psSnapshot->iLineNumber++;
+
+    /*-
+     *******************************************************************
+     *
+     * Wipe the slate clean for the current (i.e., new) record.
+     *
+     *******************************************************************
+     */
+    DecodeClearRecord(psSnapshot->psCurrRecord, psSnapshot->iFieldCount);
+    psSnapshot->psCurrRecord->ui64Offset = psSnapshot->ui64ReadBase + psSnapshot->iReadOffset;
+
+    /*-
+     *******************************************************************
+     *
+     * Read a line, and prune any EOL characters. Input is read in
+     * DECODE_READ_BUFSIZE blocks, and memchr() is used to locate each
+     * newline. Lines are not limited in length -- the line buffer is
+     * grown as needed. If EOF is reached before an EOL is found, the
+     * remaining data is returned as the last line. Contexts that have
+     * no file handle (i.e., workers) decode only what has already been
+     * placed in their read buffer. The file offset of each line is
+     * recorded so that it can be indexed.
+     *
+     *******************************************************************
+     */
+    if (psSnapshot->iBinary)
+    {
+      iLength = DecodeReadBinaryRecord(psSnapshot, acLocalError);
+      if (iLength == ER)
+      {
+        snprintf(pcError, MESSAGE_SIZE, "%s: %s", acRoutine, acLocalError);
+        return NULL;
+      }
+      if (iLength == 0)
+      {
+        return NULL; /* Assume we've reached EOF. */
+      }
+      break;
+    }
+    for (iFound = iLength = 0; !iFound; iLength += n)
+    {
+      if (psSnapshot->iReadOffset >= psSnapshot->iReadLength)
+      {
+        psSnapshot->ui64ReadBase += psSnapshot->iReadLength;
+        psSnapshot->iReadOffset = 0;
+        psSnapshot->iReadLength = (psSnapshot->pFile == NULL) ? 0 : fread(psSnapshot->pcReadBuffer, 1, DECODE_READ_BUFSIZE, psSnapshot->pFile);
+        if (psSnapshot->iReadLength == 0)
+        {
+          if (psSnapshot->pFile != NULL && ferror(psSnapshot->pFile))
+          {
+            snprintf(pcError, MESSAGE_SIZE, "%s: fread(): %s", acRoutine, strerror(errno));
+            return NULL;
+          }
+          if (iLength == 0)
+          {
+            return NULL; /* Assume we've reached EOF. */
+          }
+          break;
+        }
+      }
+      pcData = &psSnapshot->pcReadBuffer[psSnapshot->iReadOffset];
+      n = psSnapshot->iReadLength - psSnapshot->iReadOffset;
+      pc = memchr(pcData, '\n', n);
+      if (pc != NULL)
+      {
+        n = pc - pcData + 1;
+        iFound = 1;
+      }
+      iError = DecodeGrowRecord(psSnapshot->psCurrRecord, iLength + n + 1, 0, acLocalError);
+      if (iError != ER_OK)
+      {
+        snprintf(pcError, MESSAGE_SIZE, "%s: %s", acRoutine, acLocalError);
+        return NULL;
+      }
+      memcpy(&psSnapshot->psCurrRecord->pcLine[iLength], pcData, n);
+      psSnapshot->iReadOffset += n;
+    }
+    while (iLength > 0 && (psSnapshot->psCurrRecord->pcLine[iLength - 1] == '\n' || psSnapshot->psCurrRecord->pcLine[iLength - 1] == '\r'))
+    {
+      iLength--;
+    }
+    psSnapshot->psCurrRecord->pcLine[iLength] = 0;
+
+    /*-
+     *******************************************************************
+     *
+     * When compression is enabled, FTimes inserts a checkpoint record
+     * every COMPRESS_RECOVERY_RATE records. A checkpoint records is
+     * an uncompressed record. The following logic is used to recover
+     * from a damaged input stream. All records between the bad record
+     * and the checkpoint are thrown away. When a new checkpoint is
+     * located, the decoder state values are reset (i.e., cleared).
+     *
+     * Note: This logic does not and should not apply to uncompressed
+     * files -- i.e., those are decoded in pass-through mode.
+     *
+     * Note: Warning messages need to include the snapshot's filename
+     * and line number because they are written directly to the error
+     * stream.
+     *
+     *******************************************************************
+     */
+    if (psSnapshot->iCompressed && psSnapshot->iSkipToNext == TRUE)
+    {
+      if (strncmp(psSnapshot->psCurrRecord->pcLine, DECODE_CHECKPOINT_STRING, DECODE_CHECKPOINT_LENGTH) == 0)
+      {
+        snprintf(pcError, MESSAGE_SIZE, "File = [%s], Line = [%d]: Checkpoint located. Restarting decoders.", psSnapshot->pcFile, psSnapshot->iLineNumber);
+        DecodeReportError(psSnapshot, ER_Warning, pcError, ERROR_WARNING);
+        memset(&psSnapshot->sDecodeState, 0, sizeof(DECODE_STATE));
+        psSnapshot->iSkipToNext = FALSE;
+      }
+      else
+      {
+        snprintf(pcError, MESSAGE_SIZE, "File = [%s], Line = [%d]: Record skipped due to previous error.", psSnapshot->pcFile, psSnapshot->iLineNumber);
+        DecodeReportError(psSnapshot, ER_Warning, pcError, ERROR_WARNING);
+        psSnapshot->sDecodeStats.ulSkipped++;
+      }
+    }
+
+  } while (psSnapshot->iSkipToNext == TRUE);
+
+  psSnapshot->psCurrRecord->iLineLength = strlen(psSnapshot->psCurrRecord->pcLine);
+
   /*-
    *********************************************************************
    *
-   * If the decode routine returns an error, clear the previous value
-   * and NULLify its pointer. A NULL pointer signifies that the value
-   * is undefined (and, therefore, not to be used). If the decode
-   * routine returns success, record the decoded value in the output
-   * buffer, save it as the new previous value, and update its pointer
-   * as it may have been NULLified in a previous round.
+   * Make sure that each field buffer can hold the entire line. This
+   * is what allows DecodeProcessNada() and friends to copy a field
+   * without checking its length.
    *
    *********************************************************************
    */
-  iError = Decode64BitHexToDecimal(pcToken, iLength, &ui64Value, psDecodeState->psize, acLocalError);
-  if (iError == ER)
+  iError = DecodeGrowRecord(psSnapshot->psCurrRecord, 0, psSnapshot->psCurrRecord->iLineLength + 1, acLocalError);
+  if (iError != ER_OK)
   {
-    DECODE_UNDEFINE_PREV_NUMBER_VALUE(psDecodeState->size, psDecodeState->psize);
     snprintf(pcError, MESSAGE_SIZE, "%s: %s", acRoutine, acLocalError);
-    return iError;
-  }
-  else
-  {
-    DECODE_DEFINE_PREV_NUMBER_VALUE(psDecodeState->size, psDecodeState->psize, ui64Value);
-#ifdef WIN32
-    snprintf(pcOutput, FTIMES_MAX_64BIT_SIZE, "%I64u", ui64Value);
-#else
-  #ifdef USE_AP_SNPRINTF
-    snprintf(pcOutput, FTIMES_MAX_64BIT_SIZE, "%qu", (unsigned long long) ui64Value);
-  #else
-    snprintf(pcOutput, FTIMES_MAX_64BIT_SIZE, "%llu", (unsigned long long) ui64Value);
-  #endif
-#endif
+    return NULL;
   }
 
-  return ER_OK;
+  return psSnapshot->psCurrRecord->pcLine;
 }
 
 
 /*-
  ***********************************************************************
  *
- * DecodeProcessUserId
+ * DecodeReadSnapshot
  *
  ***********************************************************************
  */
 int
-DecodeProcessUserId(DECODE_STATE *psDecodeState, char *pcToken, int iLength, char *pcOutput, char *pcError)
+DecodeReadSnapshot(SNAPSHOT_CONTEXT *psSnapshot, char *pcError)
 {
-  const char          acRoutine[] = "DecodeProcessUserId()";
+  const char          acRoutine[] = "DecodeReadSnapshot()";
   char                acLocalError[MESSAGE_SIZE] = "";
   int                 iError = 0;
-  APP_UI32            ui32Value = 0;
 
-  if (iLength <= 0)
+#ifdef USE_DECODE_THREADS
+  /*-
+   *********************************************************************
+   *
+   * Compressed snapshots contain a checkpoint record at regular
+   * intervals. Each checkpoint is independent of the records that
+   * precede it, so the snapshot can be split at those points and
+   * decoded by multiple workers.
+   *
+   *********************************************************************
+   */
+  if (psSnapshot->iCompressed && psSnapshot->iWorkerCount > 1)
   {
-    DECODE_UNDEFINE_PREV_NUMBER_VALUE(psDecodeState->uid, psDecodeState->puid);
-    pcOutput[0] = 0;
-    return ER_OK; /* It's not an error if a value is missing. */
+    return DecodeReadSnapshotInParallel(psSnapshot, pcError);
   }
+#endif
 
   /*-
    *********************************************************************
    *
-   * If the decode routine returns an error, clear the previous value
-   * and NULLify its pointer. A NULL pointer signifies that the value
-   * is undefined (and, therefore, not to be used). If the decode
-   * routine returns success, record the decoded value in the output
-   * buffer, save it as the new previous value, and update its pointer
-   * as it may have been NULLified in a previous round.
+   * Read and process snapshot data. If the read returns NULL, it
+   * could mean an error has occured or EOF was reached. If a record
+   * fails to parse (compressed files only), set a flag so that the
+   * next read will automatically skip all records up to the next
+   * checkpoint.
    *
    *********************************************************************
    */
-  iError = Decode32BitHexToDecimal(pcToken, iLength, &ui32Value, psDecodeState->puid, acLocalError);
-  if (iError == ER)
+  while (DecodeReadLine(psSnapshot, acLocalError) != NULL)
   {
-    DECODE_UNDEFINE_PREV_NUMBER_VALUE(psDecodeState->uid, psDecodeState->puid);
-    snprintf(pcError, MESSAGE_SIZE, "%s: %s", acRoutine, acLocalError);
-    return iError;
+    psSnapshot->sDecodeStats.ulAnalyzed++;
+    iError = DecodeParseRecord(psSnapshot, acLocalError);
+    if (iError != ER_OK)
+    {
+      if (psSnapshot->iCompressed)
+      {
+        psSnapshot->iSkipToNext = TRUE;
+      }
+      psSnapshot->sDecodeStats.ulSkipped++;
+      continue;
+    }
+    iError = DecodeWriteRecord(psSnapshot, acLocalError);
+    if (iError != ER_OK)
+    {
+      snprintf(pcError, MESSAGE_SIZE, "%s: File = [%s], Line = [%d]: %s", acRoutine, psSnapshot->pcFile, psSnapshot->iLineNumber, acLocalError);
+      return ER;
+    }
+    psSnapshot->sDecodeStats.ulDecoded++;
   }
-  else
+  if (ferror(psSnapshot->pFile))
   {
-    DECODE_DEFINE_PREV_NUMBER_VALUE(psDecodeState->uid, psDecodeState->puid, ui32Value);
-    snprintf(pcOutput, FTIMES_MAX_32BIT_SIZE, "%u", ui32Value);
+    snprintf(pcError, MESSAGE_SIZE, "%s: File = [%s], Line = [%d]: %s", acRoutine, psSnapshot->pcFile, psSnapshot->iLineNumber, acLocalError);
+    psSnapshot->sDecodeStats.ulSkipped++;
+    return ER;
   }
 
   return ER_OK;
 }
 
 
+#ifdef USE_DECODE_THREADS
 /*-
  ***********************************************************************
  *
- * DecodeProcessVolume
+ * DecodeReadSnapshotInParallel
  *
  ***********************************************************************
  */
 int
-DecodeProcessVolume(DECODE_STATE *psDecodeState, char *pcToken, int iLength, char *pcOutput, char *pcError)
+DecodeReadSnapshotInParallel(SNAPSHOT_CONTEXT *psSnapshot, char *pcError)
 {
-  const char          acRoutine[] = "DecodeProcessVolume()";
+  const char          acRoutine[] = "DecodeReadSnapshotInParallel()";
   char                acLocalError[MESSAGE_SIZE] = "";
-  int                 iError = 0;
-  APP_UI32            ui32Value = 0;
-
-  if (iLength <= 0)
-  {
-    DECODE_UNDEFINE_PREV_NUMBER_VALUE(psDecodeState->volume, psDecodeState->pvolume);
-    pcOutput[0] = 0;
-    return ER_OK; /* It's not an error if a value is missing. */
-  }
+  char               *pc = NULL;
+  char               *pcEnd = NULL;
+  DECODE_BUFFER       sCarry = { NULL, 0, 0 };
+  DECODE_CHUNK       *psChunk = NULL;
+  DECODE_CHUNK        asChunks[DECODE_MAX_WORKERS];
+  SNAPSHOT_CONTEXT   *psWorker = NULL;
+  int                 aiStarted[DECODE_MAX_WORKERS];
+  int                 i = 0;
+  int                 iChunkCount = 0;
+  int                 iCut = 0;
+  int                 iDone = 0;
+  int                 iEOF = 0;
+  int                 iError = ER_OK;
+  int                 iNRead = 0;
+  int                 iSkipToNext = FALSE;
+  int                 iTarget = 0;
+  int                 iWorkerCount = (psSnapshot->iWorkerCount > DECODE_MAX_WORKERS) ? DECODE_MAX_WORKERS : psSnapshot->iWorkerCount;
+  pthread_t           atThreads[DECODE_MAX_WORKERS];
 
   /*-
    *********************************************************************
    *
-   * If the decode routine returns an error, clear the previous value
-   * and NULLify its pointer. A NULL pointer signifies that the value
-   * is undefined (and, therefore, not to be used). If the decode
-   * routine returns success, record the decoded value in the output
-   * buffer, save it as the new previous value, and update its pointer
-   * as it may have been NULLified in a previous round.
+   * Create one decode context per worker. Each context inherits the
+   * decode map from the snapshot, but has its own records and state.
+   * Records and messages are collected in per-chunk buffers so that
+   * they can be emitted in their original order.
    *
    *********************************************************************
    */
-  iError = Decode32BitHexToDecimal(pcToken, iLength, &ui32Value, psDecodeState->pvolume, acLocalError);
-  if (iError == ER)
+  memset(asChunks, 0, sizeof(asChunks));
+  for (i = 0; i < iWorkerCount; i++)
   {
-    DECODE_UNDEFINE_PREV_NUMBER_VALUE(psDecodeState->volume, psDecodeState->pvolume);
-    snprintf(pcError, MESSAGE_SIZE, "%s: %s", acRoutine, acLocalError);
-    return iError;
+    psWorker = DecodeNewSnapshotContext(acLocalError);
+    if (psWorker == NULL)
+    {
+      snprintf(pcError, MESSAGE_SIZE, "%s: %s", acRoutine, acLocalError);
+      iError = ER;
+      goto CLEANUP;
+    }
+    memcpy(psWorker->psDecodeMap, psSnapshot->psDecodeMap, sizeof(DECODE_TABLE) * DECODE_TABLE_SIZE);
+    memcpy(psWorker->aiIndex2Map, psSnapshot->aiIndex2Map, sizeof(psSnapshot->aiIndex2Map));
+    psWorker->pcFile = psSnapshot->pcFile;
+    psWorker->iCompressed = psSnapshot->iCompressed;
+    psWorker->iFieldCount = psSnapshot->iFieldCount;
+    psWorker->iLegacyFile = psSnapshot->iLegacyFile;
+    psWorker->iNamesAreCaseInsensitive = psSnapshot->iNamesAreCaseInsensitive;
+    psWorker->ulFieldMask = psSnapshot->ulFieldMask;
+    psWorker->psMessageBuffer = &asChunks[i].sMessages;
+    psWorker->psOutputBuffer = &asChunks[i].sOutput;
+    asChunks[i].psSnapshot = psWorker;
   }
-  else
+
+  /*-
+   *********************************************************************
+   *
+   * Any data that was read along with the header belongs to the first
+   * chunk.
+   *
+   *********************************************************************
+   */
+  if (psSnapshot->pcReadBuffer != NULL && psSnapshot->iReadOffset < psSnapshot->iReadLength)
   {
-    DECODE_DEFINE_PREV_NUMBER_VALUE(psDecodeState->volume, psDecodeState->pvolume, ui32Value);
-    snprintf(pcOutput, FTIMES_MAX_32BIT_SIZE, "%u", ui32Value);
+    iError = DecodeAppendBuffer(&sCarry, &psSnapshot->pcReadBuffer[psSnapshot->iReadOffset], psSnapshot->iReadLength - psSnapshot->iReadOffset, acLocalError);
+    if (iError != ER_OK)
+    {
+      snprintf(pcError, MESSAGE_SIZE, "%s: %s", acRoutine, acLocalError);
+      goto CLEANUP;
+    }
+    psSnapshot->iReadOffset = psSnapshot->iReadLength;
   }
 
-  return ER_OK;
-}
-
-
-/*-
- ***********************************************************************
- *
- * DecodeReadLine
- *
- ***********************************************************************
- */
-char *
-DecodeReadLine(SNAPSHOT_CONTEXT *psSnapshot, char *pcError)
-{
-  const char          acRoutine[] = "DecodeReadLine()";
-  char                acLocalError[MESSAGE_SIZE] = "";
-
-  do
+  while (!iDone)
   {
     /*-
      *******************************************************************
      *
-     * Flip the current and previous records. This is how we maintain
-     * state from line to line when decoding a compressed file. The
-     * current line number is used to determine the new index values,
-     * so it must not be modified anywhere else in the code.
+     * Fill up to one chunk per worker. Each chunk is cut just before
+     * the last checkpoint (i.e., a line that begins with "00") in its
+     * buffer. If no checkpoint is found, more data is read until one
+     * is found or EOF is reached.
      *
      *******************************************************************
      */
-    psSnapshot->psCurrRecord = &psSnapshot->asRecords[(0 + psSnapshot->iLineNumber) % 2];
-    psSnapshot->psPrevRecord = &psSnapshot->asRecords[(1 + psSnapshot->iLineNumber) % 2];
-    psSnapshot->iLineNumber++;
+    for (iChunkCount = 0; iChunkCount < iWorkerCount && !iDone; iChunkCount++)
+    {
+      psChunk = &asChunks[iChunkCount];
+      psChunk->sInput.iLength = 0;
+      iError = DecodeAppendBuffer(&psChunk->sInput, sCarry.pcData, sCarry.iLength, acLocalError);
+      if (iError != ER_OK)
+      {
+        snprintf(pcError, MESSAGE_SIZE, "%s: %s", acRoutine, acLocalError);
+        goto CLEANUP;
+      }
+      sCarry.iLength = 0;
+      for (iCut = 0, iTarget = DECODE_CHUNK_SIZE; iCut == 0; iTarget *= 2)
+      {
+        while (!iEOF && psChunk->sInput.iLength < iTarget)
+        {
+          iError = DecodeAppendBuffer(&psChunk->sInput, NULL, iTarget - psChunk->sInput.iLength, acLocalError);
+          if (iError != ER_OK)
+          {
+            snprintf(pcError, MESSAGE_SIZE, "%s: %s", acRoutine, acLocalError);
+            goto CLEANUP;
+          }
+          iNRead = fread(&psChunk->sInput.pcData[psChunk->sInput.iLength], 1, iTarget - psChunk->sInput.iLength, psSnapshot->pFile);
+          if (iNRead == 0)
+          {
+            if (ferror(psSnapshot->pFile))
+            {
+              snprintf(pcError, MESSAGE_SIZE, "%s: fread(): %s", acRoutine, strerror(errno));
+              iError = ER;
+              goto CLEANUP;
+            }
+            iEOF = 1;
+          }
+          psChunk->sInput.iLength += iNRead;
+        }
+        if (iEOF)
+        {
+          iCut = psChunk->sInput.iLength;
+          iDone = 1;
+          break;
+        }
+        pcEnd = &psChunk->sInput.pcData[psChunk->sInput.iLength - DECODE_CHECKPOINT_LENGTH];
+        for (pc = pcEnd; pc > psChunk->sInput.pcData; pc--)
+        {
+          if (pc[-1] == '\n' && strncmp(pc, DECODE_CHECKPOINT_STRING, DECODE_CHECKPOINT_LENGTH) == 0)
+          {
+            iCut = pc - psChunk->sInput.pcData;
+            break;
+          }
+        }
+      }
+      if (iCut < psChunk->sInput.iLength)
+      {
+        iError = DecodeAppendBuffer(&sCarry, &psChunk->sInput.pcData[iCut], psChunk->sInput.iLength - iCut, acLocalError);
+        if (iError != ER_OK)
+        {
+          snprintf(pcError, MESSAGE_SIZE, "%s: %s", acRoutine, acLocalError);
+          goto CLEANUP;
+        }
+        psChunk->sInput.iLength = iCut;
+      }
 
-    /*-
-     *******************************************************************
-     *
-     * Wipe the slate clean for the current (i.e., new) record.
-     *
-     *******************************************************************
-     */
-    DecodeClearRecord(psSnapshot->psCurrRecord, psSnapshot->iFieldCount);
+      /*-
+       *****************************************************************
+       *
+       * Count the lines in this chunk so that line numbers reported by
+       * its worker match those of a sequential decode.
+       *
+       *****************************************************************
+       */
+      psChunk->iFirstLine = psSnapshot->iLineNumber;
+      pcEnd = &psChunk->sInput.pcData[psChunk->sInput.iLength];
+      for (pc = psChunk->sInput.pcData; pc < pcEnd && (pc = memchr(pc, '\n', pcEnd - pc)) != NULL; pc++)
+      {
+        psSnapshot->iLineNumber++;
+      }
+      if (psChunk->sInput.iLength > 0 && pcEnd[-1] != '\n')
+      {
+        psSnapshot->iLineNumber++;
+      }
+      if (psChunk->sInput.iLength == 0)
+      {
+        break; /* There's nothing left to decode. */
+      }
+    }
 
     /*-
      *******************************************************************
      *
-     * Read a line, and prune any EOL characters.
+     * Decode the chunks. If a thread can't be started, the chunk is
+     * decoded here instead.
      *
      *******************************************************************
      */
-/* FIXME Turn this into a loop that can read until an EOL is found.
- *       There probably should be a maximum length, but it should not
- *       be too low. If no EOL is found, assume that data is missing,
- *       and generate an error.
- */
-    if (fgets(psSnapshot->psCurrRecord->acLine, DECODE_MAX_LINE, psSnapshot->pFile) == NULL)
+    for (i = 0; i < iChunkCount; i++)
     {
-      if (ferror(psSnapshot->pFile))
-      {
-        snprintf(pcError, MESSAGE_SIZE, "%s: fgets(): %s", acRoutine, strerror(errno));
-        return NULL;
-      }
-      else
+      psWorker = asChunks[i].psSnapshot;
+      psWorker->pcReadBuffer = asChunks[i].sInput.pcData;
+      psWorker->iReadLength = asChunks[i].sInput.iLength;
+      psWorker->iReadOffset = 0;
+      psWorker->iLineNumber = asChunks[i].iFirstLine;
+      psWorker->iSkipToNext = FALSE;
+      memset(&psWorker->sDecodeState, 0, sizeof(DECODE_STATE));
+      memset(&psWorker->sDecodeStats, 0, sizeof(DECODE_STATS));
+      asChunks[i].sMessages.iLength = 0;
+      asChunks[i].sOutput.iLength = 0;
+      aiStarted[i] = (pthread_create(&atThreads[i], NULL, DecodeReadSnapshotWorker, &asChunks[i]) == 0) ? 1 : 0;
+      if (!aiStarted[i])
       {
-        return NULL; /* Assume we've reached EOF. */
+        DecodeReadSnapshotWorker(&asChunks[i]);
       }
     }
-
-    if (SupportChopEOLs(psSnapshot->psCurrRecord->acLine, feof(psSnapshot->pFile) ? 0 : 1, acLocalError) == ER)
+    for (i = 0; i < iChunkCount; i++)
     {
-      snprintf(pcError, MESSAGE_SIZE, "%s: %s", acRoutine, acLocalError);
-      return NULL;
+      if (aiStarted[i])
+      {
+        pthread_join(atThreads[i], NULL);
+      }
     }
 
     /*-
      *******************************************************************
      *
-     * When compression is enabled, FTimes inserts a checkpoint record
-     * every COMPRESS_RECOVERY_RATE records. A checkpoint records is
-     * an uncompressed record. The following logic is used to recover
-     * from a damaged input stream. All records between the bad record
-     * and the checkpoint are thrown away. When a new checkpoint is
-     * located, the decoder state values are reset (i.e., cleared).
-     *
-     * Note: This logic does not and should not apply to uncompressed
-     * files -- i.e., those are decoded in pass-through mode.
-     *
-     * Note: Warning messages need to include the snapshot's filename
-     * and line number because they are written directly to the error
-     * stream.
+     * Emit messages and records in chunk order. A chunk that ends in
+     * skip mode would have caused a sequential decoder to report the
+     * checkpoint that begins the next chunk, so do that here too.
      *
      *******************************************************************
      */
-    if (psSnapshot->iCompressed && psSnapshot->iSkipToNext == TRUE)
+    for (i = 0; i < iChunkCount; i++)
     {
-      if (strncmp(psSnapshot->psCurrRecord->acLine, DECODE_CHECKPOINT_STRING, DECODE_CHECKPOINT_LENGTH) == 0)
+      psChunk = &asChunks[i];
+      psWorker = psChunk->psSnapshot;
+      if (iSkipToNext == TRUE && psChunk->sInput.iLength > 0)
       {
-        snprintf(pcError, MESSAGE_SIZE, "File = [%s], Line = [%d]: Checkpoint located. Restarting decoders.", psSnapshot->pcFile, psSnapshot->iLineNumber);
-        ErrorHandler(ER_Warning, pcError, ERROR_WARNING);
-        memset(&psSnapshot->sDecodeState, 0, sizeof(DECODE_STATE));
-        psSnapshot->iSkipToNext = FALSE;
+        snprintf(acLocalError, MESSAGE_SIZE, "File = [%s], Line = [%d]: Checkpoint located. Restarting decoders.", psSnapshot->pcFile, psChunk->iFirstLine + 1);
+        ErrorHandler(ER_Warning, acLocalError, ERROR_WARNING);
       }
-      else
+      for (pc = psChunk->sMessages.pcData; pc < &psChunk->sMessages.pcData[psChunk->sMessages.iLength]; pc += strlen(pc) + 1)
       {
-        snprintf(pcError, MESSAGE_SIZE, "File = [%s], Line = [%d]: Record skipped due to previous error.", psSnapshot->pcFile, psSnapshot->iLineNumber);
-        ErrorHandler(ER_Warning, pcError, ERROR_WARNING);
-        psSnapshot->sDecodeStats.ulSkipped++;
+        if (pc[0] == 'W')
+        {
+          ErrorHandler(ER_Warning, &pc[1], ERROR_WARNING);
+        }
+        else
+        {
+          ErrorHandler(ER_Failure, &pc[1], ERROR_FAILURE);
+        }
+      }
+      psSnapshot->sDecodeStats.ulAnalyzed += psWorker->sDecodeStats.ulAnalyzed;
+      psSnapshot->sDecodeStats.ulDecoded += psWorker->sDecodeStats.ulDecoded;
+      psSnapshot->sDecodeStats.ulSkipped += psWorker->sDecodeStats.ulSkipped;
+      if (psChunk->iError != ER_OK)
+      {
+        snprintf(pcError, MESSAGE_SIZE, "%s: %s", acRoutine, psChunk->acError);
+        iError = ER;
+        goto CLEANUP;
+      }
+      if (psChunk->sOutput.iLength > 0)
+      {
+        iError = SupportWriteData(gpFile, psChunk->sOutput.pcData, psChunk->sOutput.iLength, acLocalError);
+        if (iError != ER_OK)
+        {
+          snprintf(pcError, MESSAGE_SIZE, "%s: %s", acRoutine, acLocalError);
+          goto CLEANUP;
+        }
       }
+      iSkipToNext = psWorker->iSkipToNext;
     }
+  }
 
-  } while (psSnapshot->iSkipToNext == TRUE);
-
-  psSnapshot->psCurrRecord->iLineLength = strlen(psSnapshot->psCurrRecord->acLine);
+CLEANUP:
+  for (i = 0; i < iWorkerCount; i++)
+  {
+    if (asChunks[i].psSnapshot != NULL)
+    {
+      asChunks[i].psSnapshot->pcReadBuffer = NULL; /* This buffer belongs to the chunk. */
+      DecodeFreeSnapshotContext(asChunks[i].psSnapshot);
+    }
+    if (asChunks[i].sInput.pcData != NULL)
+    {
+      free(asChunks[i].sInput.pcData);
+    }
+    if (asChunks[i].sMessages.pcData != NULL)
+    {
+      free(asChunks[i].sMessages.pcData);
+    }
+    if (asChunks[i].sOutput.pcData != NULL)
+    {
+      free(asChunks[i].sOutput.pcData);
+    }
+  }
+  if (sCarry.pcData != NULL)
+  {
+    free(sCarry.pcData);
+  }
 
-  return psSnapshot->psCurrRecord->acLine;
+  return iError;
 }
 
 
 /*-
  ***********************************************************************
  *
- * DecodeReadSnapshot
+ * DecodeReadSnapshotWorker
  *
  ***********************************************************************
  */
-int
-DecodeReadSnapshot(SNAPSHOT_CONTEXT *psSnapshot, char *pcError)
+void *
+DecodeReadSnapshotWorker(void *pvChunk)
 {
-  const char          acRoutine[] = "DecodeReadSnapshot()";
+  const char          acRoutine[] = "DecodeReadSnapshotWorker()";
   char                acLocalError[MESSAGE_SIZE] = "";
-  int                 iError = 0;
+  DECODE_CHUNK       *psChunk = (DECODE_CHUNK *) pvChunk;
+  SNAPSHOT_CONTEXT   *psSnapshot = psChunk->psSnapshot;
 
   /*-
    *********************************************************************
    *
-   * Read and process snapshot data. If the read returns NULL, it
-   * could mean an error has occured or EOF was reached. If a record
-   * fails to parse (compressed files only), set a flag so that the
-   * next read will automatically skip all records up to the next
-   * checkpoint.
+   * This is the same loop that DecodeReadSnapshot() uses, except that
+   * input comes from the chunk, and output goes to the chunk.
    *
    *********************************************************************
    */
+  psChunk->iError = ER_OK;
   while (DecodeReadLine(psSnapshot, acLocalError) != NULL)
   {
     psSnapshot->sDecodeStats.ulAnalyzed++;
-    iError = DecodeParseRecord(psSnapshot, acLocalError);
-    if (iError != ER_OK)
+    if (DecodeParseRecord(psSnapshot, acLocalError) != ER_OK)
     {
-      if (psSnapshot->iCompressed)
-      {
-        psSnapshot->iSkipToNext = TRUE;
-      }
+      psSnapshot->iSkipToNext = TRUE;
       psSnapshot->sDecodeStats.ulSkipped++;
       continue;
     }
-    iError = DecodeWriteRecord(psSnapshot, acLocalError);
-    if (iError != ER_OK)
+    if (DecodeWriteRecord(psSnapshot, acLocalError) != ER_OK)
     {
-      snprintf(pcError, MESSAGE_SIZE, "%s: File = [%s], Line = [%d]: %s", acRoutine, psSnapshot->pcFile, psSnapshot->iLineNumber, acLocalError);
-      return ER;
+      snprintf(psChunk->acError, MESSAGE_SIZE, "%s: File = [%s], Line = [%d]: %s", acRoutine, psSnapshot->pcFile, psSnapshot->iLineNumber, acLocalError);
+      psChunk->iError = ER;
+      return NULL;
     }
     psSnapshot->sDecodeStats.ulDecoded++;
   }
-  if (ferror(psSnapshot->pFile))
+  if (acLocalError[0] != 0 && psSnapshot->iReadOffset < psSnapshot->iReadLength)
   {
-    snprintf(pcError, MESSAGE_SIZE, "%s: File = [%s], Line = [%d]: %s", acRoutine, psSnapshot->pcFile, psSnapshot->iLineNumber, acLocalError);
-    psSnapshot->sDecodeStats.ulSkipped++;
+    snprintf(psChunk->acError, MESSAGE_SIZE, "%s: File = [%s], Line = [%d]: %s", acRoutine, psSnapshot->pcFile, psSnapshot->iLineNumber, acLocalError);
+    psChunk->iError = ER;
+  }
+
+  return NULL;
+}
+#endif
+
+
+/*-
+ ***********************************************************************
+ *
+ * DecodeReportError
+ *
+ ***********************************************************************
+ */
+void
+DecodeReportError(SNAPSHOT_CONTEXT *psSnapshot, int iError, char *pcError, int iSeverity)
+{
+  char                acLocalError[MESSAGE_SIZE] = "";
+  DECODE_BUFFER      *psBuffer = psSnapshot->psMessageBuffer;
+  int                 iLength = strlen(pcError) + 1;
+
+  /*-
+   *********************************************************************
+   *
+   * Workers must not touch the message subsystem directly. Instead,
+   * their messages are queued, and the caller replays them in order.
+   * Each message is stored as a severity byte followed by a C string.
+   *
+   *********************************************************************
+   */
+  if (psBuffer != NULL && iSeverity != ERROR_CRITICAL)
+  {
+    if (DecodeAppendBuffer(psBuffer, NULL, iLength + 1, acLocalError) == ER_OK)
+    {
+      psBuffer->pcData[psBuffer->iLength++] = (iSeverity == ERROR_WARNING) ? 'W' : 'F';
+      memcpy(&psBuffer->pcData[psBuffer->iLength], pcError, iLength);
+      psBuffer->iLength += iLength;
+    }
+    return;
+  }
+
+  ErrorHandler(iError, pcError, iSeverity);
+}
+
+
+/*-
+ ***********************************************************************
+ *
+ * DecodeSeekFile
+ *
+ ***********************************************************************
+ */
+int
+DecodeSeekFile(FILE *pFile, APP_UI64 ui64Offset, char *pcError)
+{
+  const char          acRoutine[] = "DecodeSeekFile()";
+  int                 iError = 0;
+  int                 iNToSeek = 0;
+
+  /*-
+   *********************************************************************
+   *
+   * Seek in steps that fit in a signed int so that offsets beyond
+   * 2GB can be reached on platforms that lack fseeko().
+   *
+   *********************************************************************
+   */
+  iError = fseek(pFile, 0, SEEK_SET);
+  if (iError == ER)
+  {
+    snprintf(pcError, MESSAGE_SIZE, "%s: fseek(): %s", acRoutine, strerror(errno));
     return ER;
   }
 
+  while (ui64Offset > 0)
+  {
+    iNToSeek = (ui64Offset > (APP_UI64) 0x7fffffff) ? 0x7fffffff : (int) ui64Offset;
+#ifdef HAVE_FSEEKO
+    iError = fseeko(pFile, (off_t) iNToSeek, SEEK_CUR);
+#else
+    iError = fseek(pFile, iNToSeek, SEEK_CUR);
+#endif
+    if (iError == ER)
+    {
+#ifdef HAVE_FSEEKO
+      snprintf(pcError, MESSAGE_SIZE, "%s: fseeko(): %s", acRoutine, strerror(errno));
+#else
+      snprintf(pcError, MESSAGE_SIZE, "%s: fseek(): %s", acRoutine, strerror(errno));
+#endif
+      return ER;
+    }
+    ui64Offset -= (APP_UI64) iNToSeek;
+  }
+
   return ER_OK;
 }
 
@@ -2718,6 +4428,35 @@ DecodeWriteHeader(SNAPSHOT_CONTEXT *psSnapshot, char *pcError)
 }
 
 
+/*-
+ ***********************************************************************
+ *
+ * DecodeWriteIndexEntry
+ *
+ ***********************************************************************
+ */
+int
+DecodeWriteIndexEntry(FILE *pFile, DECODE_INDEX_ENTRY *psEntry, char *pcError)
+{
+  const char          acRoutine[] = "DecodeWriteIndexEntry()";
+  unsigned char       aucEntry[DECODE_INDEX_ENTRY_SIZE];
+
+  memcpy(aucEntry, psEntry->aucHash, MD5_HASH_SIZE);
+  DECODE_PACK_NUMBER(&aucEntry[16], psEntry->ui64Offset, 8);
+  DECODE_PACK_NUMBER(&aucEntry[24], psEntry->ui64SyncOffset, 8);
+  DECODE_PACK_NUMBER(&aucEntry[32], psEntry->ui32Line, 4);
+  DECODE_PACK_NUMBER(&aucEntry[36], psEntry->ui32SyncLine, 4);
+
+  if (fwrite(aucEntry, 1, DECODE_INDEX_ENTRY_SIZE, pFile) != DECODE_INDEX_ENTRY_SIZE)
+  {
+    snprintf(pcError, MESSAGE_SIZE, "%s: fwrite(): %s", acRoutine, strerror(errno));
+    return ER;
+  }
+
+  return ER_OK;
+}
+
+
 /*-
  ***********************************************************************
  *
@@ -2731,17 +4470,63 @@ DecodeWriteRecord(SNAPSHOT_CONTEXT *psSnapshot, char *pcError)
   const char          acRoutine[] = "DecodeWriteRecord()";
   char                acOutput[(DECODE_FIELD_COUNT)*(DECODE_MAX_LINE)]; /* Don't initialize this with '{ 0 }' -- it's a hugh performance hit. */
   char                acLocalError[MESSAGE_SIZE] = "";
+  char               *pcField = NULL;
+  char               *pcOutput = acOutput;
+  int                 aiLengths[DECODE_FIELD_COUNT];
   int                 i = 0;
   int                 iError = 0;
+  int                 iNewLineLength = strlen(gacNewLine);
   int                 n = 0;
 
+  /*-
+   *********************************************************************
+   *
+   * Fields are no longer bounded by DECODE_MAX_LINE, so measure the
+   * record first, and only fall back to the heap if it won't fit.
+   *
+   *********************************************************************
+   */
+  for (i = n = 0; i < psSnapshot->iFieldCount; i++)
+  {
+    aiLengths[i] = strlen(psSnapshot->psCurrRecord->ppcFields[psSnapshot->aiIndex2Map[i]]);
+    n += aiLengths[i] + 1;
+  }
+  n += iNewLineLength;
+  if (n > (int) sizeof(acOutput))
+  {
+    pcOutput = (char *) malloc(n);
+    if (pcOutput == NULL)
+    {
+      snprintf(pcError, MESSAGE_SIZE, "%s: malloc(): %s", acRoutine, strerror(errno));
+      return ER;
+    }
+  }
+
   for (i = n = 0; i < psSnapshot->iFieldCount; i++)
   {
-    n += sprintf(&acOutput[n], "%s%s", (i > 0) ? DECODE_SEPARATOR_S : "", psSnapshot->psCurrRecord->ppcFields[psSnapshot->aiIndex2Map[i]]);
+    if (i > 0)
+    {
+      pcOutput[n++] = DECODE_SEPARATOR_C;
+    }
+    pcField = psSnapshot->psCurrRecord->ppcFields[psSnapshot->aiIndex2Map[i]];
+    memcpy(&pcOutput[n], pcField, aiLengths[i]);
+    n += aiLengths[i];
   }
-  n += sprintf(&acOutput[n], "%s", gacNewLine);
+  memcpy(&pcOutput[n], gacNewLine, iNewLineLength);
+  n += iNewLineLength;
 
-  iError = SupportWriteData(gpFile, acOutput, n, acLocalError);
+  if (psSnapshot->psOutputBuffer != NULL)
+  {
+    iError = DecodeAppendBuffer(psSnapshot->psOutputBuffer, pcOutput, n, acLocalError);
+  }
+  else
+  {
+    iError = SupportWriteData(gpFile, pcOutput, n, acLocalError);
+  }
+  if (pcOutput != acOutput)
+  {
+    free(pcOutput);
+  }
   if (iError != ER_OK)
   {
     snprintf(pcError, MESSAGE_SIZE, "%s: %s", acRoutine, acLocalError);
@@ -27,20 +27,41 @@
 #define NEWLINE_LENGTH 3
 #endif
 
+#define DECODE_ARENA_SLAB_SIZE 0x100000
+#define DECODE_BINARY_LENGTH_SIZE 4
+#define DECODE_BINARY_MAX_RECORD 0x100000
+#define DECODE_BINARY_TAG_NULL 0
+#define DECODE_BINARY_TAG_DECIMAL 1
+#define DECODE_BINARY_TAG_OCTAL 2
+#define DECODE_BINARY_TAG_TIME 3
+#define DECODE_BINARY_TAG_HEX 4
+#define DECODE_BINARY_TAG_TEXT 5
+#define DECODE_BINARY_TAG_QUOTED 6
+#define DECODE_BINARY_VARINT_SIZE 10
 #define DECODE_CHECKPOINT_LENGTH 2
+#define DECODE_CHUNK_SIZE 0x400000
 #define DECODE_CHECKPOINT_STRING "00"
 #define DECODE_FIELDNAME_SIZE 32
 #define DECODE_FIELD_COUNT 28 /* This value must be updated as new fields are added. */
+#define DECODE_GZIP_MAGIC 0x1f
+#define DECODE_INDEX_ENTRY_SIZE 40
+#define DECODE_INDEX_HEADER_SIZE 32
+#define DECODE_INDEX_MAGIC "FTIMESIX"
+#define DECODE_INDEX_MAGIC_LENGTH 8
+#define DECODE_INDEX_SUFFIX ".idx"
+#define DECODE_INDEX_VERSION 1
 #ifndef FTIMES_MAX_LINE
 #define DECODE_MAX_LINE 8192
 #else
 #define DECODE_MAX_LINE FTIMES_MAX_LINE
 #endif
+#define DECODE_MAX_WORKERS 64
 #ifndef FTIMES_MAX_PATH
 #define DECODE_MAX_PATH 4096
 #else
 #define DECODE_MAX_PATH FTIMES_MAX_PATH
 #endif
+#define DECODE_READ_BUFSIZE 0x10000
 #define DECODE_SEPARATOR_C '|'
 #define DECODE_SEPARATOR_S "|"
 #define DECODE_TIME_FORMAT "%04d-%02d-%02d %02d:%02d:%02d"
@@ -55,6 +76,8 @@
  */
 #define DECODE_DEFINE_PREV_NUMBER_VALUE(field, pfield, value) field = value; pfield = &field;
 #define DECODE_UNDEFINE_PREV_NUMBER_VALUE(field, pfield) field = 0; pfield = NULL;
+#define DECODE_PACK_NUMBER(pucBuffer, value, size) { int iByte; for (iByte = 0; iByte < (size); iByte++) { (pucBuffer)[iByte] = (unsigned char) ((value) >> (8 * ((size) - iByte - 1))); } }
+#define DECODE_UNPACK_NUMBER(pucBuffer, value, size) { int iByte; for (iByte = 0, (value) = 0; iByte < (size); iByte++) { (value) = ((value) << 8) | (pucBuffer)[iByte]; } }
 
 /*-
  ***********************************************************************
@@ -63,14 +86,47 @@
  *
  ***********************************************************************
  */
+typedef struct _DECODE_ARENA_SLAB
+{
+  struct _DECODE_ARENA_SLAB *psNext;
+  int                 iLength;
+  int                 iSize;
+} DECODE_ARENA_SLAB;
+
+typedef struct _DECODE_ARENA
+{
+  DECODE_ARENA_SLAB  *psSlabs;
+  APP_UI64            ui64Allocated;
+} DECODE_ARENA;
+
+typedef struct _DECODE_BUFFER
+{
+  char               *pcData;
+  int                 iLength;
+  int                 iSize;
+} DECODE_BUFFER;
+
 typedef struct _DECODE_RECORD
 {
-  char                acLine[DECODE_MAX_LINE];
+  char               *pcFieldData;
+  char               *pcLine;
   char              **ppcFields;
+  int                 iFieldSize;
   int                 iLineLength;
+  int                 iLineSize;
   unsigned char       aucHash[MD5_HASH_SIZE];
+  APP_UI64            ui64Offset;
 } DECODE_RECORD;
 
+typedef struct _DECODE_INDEX_ENTRY
+{
+  unsigned char       aucHash[MD5_HASH_SIZE];
+  APP_UI64            ui64Offset;
+  APP_UI64            ui64SyncOffset;
+  APP_UI32            ui32Line;
+  APP_UI32            ui32SyncLine;
+} DECODE_INDEX_ENTRY;
+
 typedef struct _DECODE_STATE
 {
   char                name[DECODE_MAX_PATH];
@@ -141,9 +197,21 @@ typedef struct _SNAPSHOT_CONTEXT
   DECODE_STATS        sDecodeStats;
   DECODE_TABLE       *psDecodeMap;
   FILE               *pFile;
+  char               *pcReadBuffer;
+  int                 iReadLength;
+  int                 iReadOffset;
+  APP_UI64            ui64ReadBase;
+  char               *pcLookupName;
+  int                 iBuildIndex;
+  DECODE_BUFFER      *psMessageBuffer;
+  DECODE_BUFFER      *psOutputBuffer;
+  int                 iWorkerCount;
+  int                 iBinary;
+  DECODE_BUFFER       sBinaryRecord;
   int                 iCompressed;
   int                 aiIndex2Map[DECODE_FIELD_COUNT];
   int                 iFieldCount;
+  int                 iGzipped;
   int                 iLegacyFile;
   int                 iLineNumber;
   int                 iNamesAreCaseInsensitive;
@@ -151,6 +219,19 @@ typedef struct _SNAPSHOT_CONTEXT
   unsigned long       ulFieldMask;
 } SNAPSHOT_CONTEXT;
 
+#ifdef USE_DECODE_THREADS
+typedef struct _DECODE_CHUNK
+{
+  char                acError[MESSAGE_SIZE];
+  DECODE_BUFFER       sInput;
+  DECODE_BUFFER       sMessages;
+  DECODE_BUFFER       sOutput;
+  int                 iError;
+  int                 iFirstLine;
+  SNAPSHOT_CONTEXT   *psSnapshot;
+} DECODE_CHUNK;
+#endif
+
 /*-
  ***********************************************************************
  *
@@ -160,14 +241,29 @@ typedef struct _SNAPSHOT_CONTEXT
  */
 int                 Decode32BitHexToDecimal(char *pcData, int iLength, APP_UI32 *pui32ValueNew, APP_UI32 *pui32ValueOld, char *pcError);
 int                 Decode64BitHexToDecimal(char *pcData, int iLength, APP_UI64 *pui64ValueNew, APP_UI64 *pui64ValueOld, char *pcError);
+char               *DecodeAllocateFromArena(DECODE_ARENA *psArena, int iLength, char *pcError);
+int                 DecodeAppendBuffer(DECODE_BUFFER *psBuffer, char *pcData, int iLength, char *pcError);
 void                DecodeBuildFromBase64Table(void);
+int                 DecodeBuildIndex(SNAPSHOT_CONTEXT *psSnapshot, char *pcIndexFile, char *pcError);
 void                DecodeClearRecord(DECODE_RECORD *psRecord, int iFieldCount);
+int                 DecodeCompareIndexEntries(const void *pvEntry1, const void *pvEntry2);
+int                 DecodeFormatBinaryRecord(SNAPSHOT_CONTEXT *psSnapshot, unsigned char *pucRecord, int iLength, char *pcError);
+int                 DecodeFormatNumber(APP_UI64 ui64Value, int iBase, char *pcOutput);
 int                 DecodeFormatOutOfBandTime(char *pcToken, int iLength, char *pcOutput, char *pcError);
 int                 DecodeFormatTime(APP_UI32 *pui32Time, char *pcTime);
+void                DecodeFreeArena(DECODE_ARENA *psArena);
+void                DecodeFreeRecord(DECODE_RECORD *psRecord);
 void                DecodeFreeSnapshotContext(SNAPSHOT_CONTEXT *psSnapshot);
 void                DecodeFreeSnapshotContext2(SNAPSHOT_CONTEXT *psSnapshot);
 int                 DecodeGetBase64Hash(char *pcData, unsigned char *pucHash, int iLength, char *pcError);
+FILE               *DecodeGetFileHandle(SNAPSHOT_CONTEXT *psSnapshot, char *pcError);
 int                 DecodeGetTableLength(void);
+int                 DecodeGetVarint(unsigned char *pucData, int iLength, APP_UI64 *pui64Value);
+int                 DecodeGrowRecord(DECODE_RECORD *psRecord, int iLineSize, int iFieldSize, char *pcError);
+void                DecodeHashName(char *pcName, int iNamesAreCaseInsensitive, unsigned char *pucHash);
+int                 DecodeIndexSnapshot(char *pcSnapshot, char *pcIndexFile, char *pcError);
+int                 DecodeLookupRecord(SNAPSHOT_CONTEXT *psSnapshot, char *pcIndexFile, char *pcName, char *pcError);
+int                 DecodeNewRecord(DECODE_RECORD *psRecord, char *pcError);
 SNAPSHOT_CONTEXT   *DecodeNewSnapshotContext(char *pcError);
 SNAPSHOT_CONTEXT   *DecodeNewSnapshotContext2(char *pcSnapshot, char *pcError);
 int                 DecodeOpenSnapshot(SNAPSHOT_CONTEXT *psSnapshot, char *pcError);
@@ -200,10 +296,20 @@ int                 DecodeProcessSize(DECODE_STATE *psDecodeState, char *pcToken
 int                 DecodeProcessUserId(DECODE_STATE *psDecodeState, char *pcToken, int iLength, char *pcOutput, char *pcError);
 int                 DecodeProcessVolume(DECODE_STATE *psDecodeState, char *pcToken, int iLength, char *pcOutput, char *pcError);
 char               *DecodeReadLine(SNAPSHOT_CONTEXT *psSnapshot, char *pcError);
+int                 DecodeReadBinaryRecord(SNAPSHOT_CONTEXT *psSnapshot, char *pcError);
+int                 DecodeReadData(SNAPSHOT_CONTEXT *psSnapshot, char *pcData, int iLength, char *pcError);
+int                 DecodeReadIndexEntry(FILE *pFile, APP_UI64 ui64Entry, DECODE_INDEX_ENTRY *psEntry, char *pcError);
 int                 DecodeReadSnapshot(SNAPSHOT_CONTEXT *psSnapshot, char *pcError);
+#ifdef USE_DECODE_THREADS
+int                 DecodeReadSnapshotInParallel(SNAPSHOT_CONTEXT *psSnapshot, char *pcError);
+void               *DecodeReadSnapshotWorker(void *pvChunk);
+#endif
+void                DecodeReportError(SNAPSHOT_CONTEXT *psSnapshot, int iError, char *pcError, int iSeverity);
+int                 DecodeSeekFile(FILE *pFile, APP_UI64 ui64Offset, char *pcError);
 void                DecodeSetNewLine(char *pcNewLine);
 void                DecodeSetOutputStream(FILE *pFile);
 int                 DecodeWriteHeader(SNAPSHOT_CONTEXT *psSnapshot, char *pcError);
+int                 DecodeWriteIndexEntry(FILE *pFile, DECODE_INDEX_ENTRY *psEntry, char *pcError);
 int                 DecodeWriteRecord(SNAPSHOT_CONTEXT *psSnapshot, char *pcError);
 
 #endif /* !_DECODE_H_INCLUDED */
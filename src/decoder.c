@@ -58,6 +58,25 @@ DecoderCheckDependencies(void *pvProperties, char *pcError)
     return ER_MissingControl;
   }
 
+  if (psProperties->psSnapshotContext->iBuildIndex || psProperties->psSnapshotContext->pcLookupName != NULL)
+  {
+    if (psProperties->psSnapshotContext->iBuildIndex && psProperties->psSnapshotContext->pcLookupName != NULL)
+    {
+      snprintf(pcError, MESSAGE_SIZE, "%s: The --Index and --Lookup options are mutually exclusive.", acRoutine);
+      return ER;
+    }
+    if (strcmp(psProperties->psSnapshotContext->pcFile, "-") == 0)
+    {
+      snprintf(pcError, MESSAGE_SIZE, "%s: Indexes are not supported when the snapshot is read from stdin.", acRoutine);
+      return ER;
+    }
+    if (strlen(psProperties->psSnapshotContext->pcFile) + strlen(DECODE_INDEX_SUFFIX) > FTIMES_MAX_PATH - 1)
+    {
+      snprintf(pcError, MESSAGE_SIZE, "%s: Index filename length would exceed %d bytes.", acRoutine, FTIMES_MAX_PATH - 1);
+      return ER;
+    }
+  }
+
   return ER_OK;
 }
 
@@ -101,6 +120,23 @@ DecoderFinalize(void *pvProperties, char *pcError)
   psProperties->pFileOut = stdout;
   DecodeSetOutputStream(psProperties->pFileOut);
 
+  /*-
+   *******************************************************************
+   *
+   * Finalize the index filename. The index is a sidecar file that
+   * lives alongside the snapshot.
+   *
+   *******************************************************************
+   */
+  if (psProperties->psSnapshotContext->iBuildIndex || psProperties->psSnapshotContext->pcLookupName != NULL)
+  {
+    snprintf(psProperties->acIndexFileName, FTIMES_MAX_PATH, "%s%s", psProperties->psSnapshotContext->pcFile, DECODE_INDEX_SUFFIX);
+    if (psProperties->psSnapshotContext->iBuildIndex)
+    {
+      strncpy(psProperties->acOutFileName, psProperties->acIndexFileName, FTIMES_MAX_PATH);
+    }
+  }
+
   /*-
    *******************************************************************
    *
@@ -156,6 +192,26 @@ DecoderWorkHorse(void *pvProperties, char *pcError)
   FTIMES_PROPERTIES  *psProperties = (FTIMES_PROPERTIES *)pvProperties;
   int                 iError = 0;
 
+  /*-
+   *******************************************************************
+   *
+   * Build the index, if requested. No records are written out.
+   *
+   *******************************************************************
+   */
+  if (psProperties->psSnapshotContext->iBuildIndex)
+  {
+    iError = DecodeBuildIndex(psProperties->psSnapshotContext, psProperties->acIndexFileName, acLocalError);
+    if (iError != ER_OK)
+    {
+      snprintf(pcError, MESSAGE_SIZE, "%s: %s", acRoutine, acLocalError);
+      fclose(psProperties->psSnapshotContext->pFile);
+      return iError;
+    }
+    fclose(psProperties->psSnapshotContext->pFile);
+    return ER_OK;
+  }
+
   /*-
    *******************************************************************
    *
@@ -173,11 +229,19 @@ DecoderWorkHorse(void *pvProperties, char *pcError)
   /*-
    *******************************************************************
    *
-   * Read the snapshot, and process its data.
+   * Read the snapshot, and process its data. If a name was supplied,
+   * use the index to fetch just the matching record(s).
    *
    *******************************************************************
    */
-  iError = DecodeReadSnapshot(psProperties->psSnapshotContext, acLocalError);
+  if (psProperties->psSnapshotContext->pcLookupName != NULL)
+  {
+    iError = DecodeLookupRecord(psProperties->psSnapshotContext, psProperties->acIndexFileName, psProperties->psSnapshotContext->pcLookupName, acLocalError);
+  }
+  else
+  {
+    iError = DecodeReadSnapshot(psProperties->psSnapshotContext, acLocalError);
+  }
   if (iError != ER_OK)
   {
     snprintf(pcError, MESSAGE_SIZE, "%s: %s", acRoutine, acLocalError);
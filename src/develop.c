@@ -19,10 +19,433 @@
  ***********************************************************************
  */
 #define COMPRESS_RECOVERY_RATE 100
+#define DEVELOP_MIN_BINARY_TIME ((APP_SI64) -30610224000LL) /* 1000-01-01 00:00:00 */
+#define DEVELOP_MAX_BINARY_TIME ((APP_SI64) 253402300799LL) /* 9999-12-31 23:59:59 */
+#define DEVELOP_MAX_DIGITS 24 /* Enough for a 64-bit value in octal. */
+#define DEVELOP_SECONDS_PER_DAY 86400
+#define DEVELOP_TIME_DAY_LENGTH 11 /* Length of "YYYY-MM-DD ". */
+
+/*-
+ ***********************************************************************
+ *
+ * Macros
+ *
+ ***********************************************************************
+ */
+#define DEVELOP_PUT_BINARY_BYTES(pucData, n, ucTag, pvValue, iLength) { (pucData)[(n)++] = (ucTag); (n) += DevelopPutVarint(&(pucData)[(n)], (APP_UI64) (iLength)); memcpy(&(pucData)[(n)], (pvValue), (iLength)); (n) += (iLength); }
+#define DEVELOP_PUT_BINARY_NUMBER(pucData, n, ucTag, ui64Value) { (pucData)[(n)++] = (ucTag); (n) += DevelopPutVarint(&(pucData)[(n)], (APP_UI64) (ui64Value)); }
 
 static unsigned char  gaucMd5ZeroHash[MD5_HASH_SIZE] = {0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0};
 static unsigned char  gaucSha1ZeroHash[SHA1_HASH_SIZE] = {0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0};
 static unsigned char  gaucSha256ZeroHash[SHA256_HASH_SIZE] = {0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0};
+static char           gacBase64Digits[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+static char           gacDecimalPairs[] =
+  "00010203040506070809"
+  "10111213141516171819"
+  "20212223242526272829"
+  "30313233343536373839"
+  "40414243444546474849"
+  "50515253545556575859"
+  "60616263646566676869"
+  "70717273747576777879"
+  "80818283848586878889"
+  "90919293949596979899";
+static char           gacHexDigits[] = "0123456789abcdef";
+static char           gacHexPairs[] =
+  "000102030405060708090a0b0c0d0e0f"
+  "101112131415161718191a1b1c1d1e1f"
+  "202122232425262728292a2b2c2d2e2f"
+  "303132333435363738393a3b3c3d3e3f"
+  "404142434445464748494a4b4c4d4e4f"
+  "505152535455565758595a5b5c5d5e5f"
+  "606162636465666768696a6b6c6d6e6f"
+  "707172737475767778797a7b7c7d7e7f"
+  "808182838485868788898a8b8c8d8e8f"
+  "909192939495969798999a9b9c9d9e9f"
+  "a0a1a2a3a4a5a6a7a8a9aaabacadaeaf"
+  "b0b1b2b3b4b5b6b7b8b9babbbcbdbebf"
+  "c0c1c2c3c4c5c6c7c8c9cacbcccdcecf"
+  "d0d1d2d3d4d5d6d7d8d9dadbdcdddedf"
+  "e0e1e2e3e4e5e6e7e8e9eaebecedeeef"
+  "f0f1f2f3f4f5f6f7f8f9fafbfcfdfeff";
+#ifdef UNIX
+static char           gacTimeDay[FTIMES_TIME_FORMAT_SIZE];
+static int            giTimeDayCached = 0;
+static time_t         gtTimeDay = 0;
+#endif
+
+#ifdef UNIX
+/*-
+ ***********************************************************************
+ *
+ * DevelopBinaryOutput
+ *
+ ***********************************************************************
+ */
+int
+DevelopBinaryOutput(void *pvProperties, char *pcOutData, int *iWriteCount, FTIMES_FILE_DATA *psFTFileData, char *pcError)
+{
+  FTIMES_PROPERTIES  *psProperties = (FTIMES_PROPERTIES *)pvProperties;
+  int                 i = 0;
+  int                 iLength = 0;
+  int                 iMaskTableLength = MaskGetTableLength(MASK_MASK_TYPE_MAP);
+  int                 iStatus = ER_OK;
+  int                 n = DECODE_BINARY_LENGTH_SIZE;
+  MASK_B2S_TABLE     *psMaskTable = MaskGetTableReference(MASK_MASK_TYPE_MAP);
+  unsigned char      *pucOutData = (unsigned char *) pcOutData;
+  unsigned long       ul = 0;
+  APP_SI64            asi64Times[3];
+  unsigned long       aulTimeMasks[3] = { MAP_ATIME, MAP_MTIME, MAP_CTIME };
+
+  /*-
+   *********************************************************************
+   *
+   * This is required since only strcats are used below.
+   *
+   *********************************************************************
+   */
+  pcError[0] = 0;
+
+  /*-
+   *********************************************************************
+   *
+   * The record's length is filled in last. Each field consists of a
+   * tag followed by a varint value or a varint length and that many
+   * bytes. The tags tell the decoder how to render each field so that
+   * the result is identical to what DevelopNormalOutput() produces.
+   *
+   *********************************************************************
+   */
+
+  /*-
+   *********************************************************************
+   *
+   * File Name = name
+   *
+   *********************************************************************
+   */
+  iLength = strlen(psFTFileData->pcNeuteredPath);
+  DEVELOP_PUT_BINARY_BYTES(pucOutData, n, DECODE_BINARY_TAG_QUOTED, psFTFileData->pcNeuteredPath, iLength);
+
+  /*-
+   *********************************************************************
+   *
+   * If there are no attributes to develop, just generate a series of
+   * NULL fields.
+   *
+   *********************************************************************
+   */
+  if (psFTFileData->ulAttributeMask == 0)
+  {
+    for (i = 0; i < iMaskTableLength; i++)
+    {
+      ul = (1 << i);
+      if (MASK_BIT_IS_SET(psProperties->psFieldMask->ulMask, ul))
+      {
+        pucOutData[n++] = DECODE_BINARY_TAG_NULL;
+        if (pcError[0])
+        {
+          strcat(pcError, ",");
+        }
+        strcat(pcError, (char *) psMaskTable[i].acName);
+      }
+    }
+    iStatus = ER_NullFields;
+  }
+  else
+  {
+    /*-
+     *******************************************************************
+     *
+     * Device = dev, Inode = inode, Permissions and Mode = mode, Number
+     * of Links = nlink, User ID = uid, Group ID = gid, and Special
+     * Device Type = rdev. These are truncated in the same way that
+     * DevelopNormalOutput() truncates them.
+     *
+     *******************************************************************
+     */
+    if (MASK_BIT_IS_SET(psProperties->psFieldMask->ulMask, MAP_DEV))
+    {
+      DEVELOP_PUT_BINARY_NUMBER(pucOutData, n, DECODE_BINARY_TAG_DECIMAL, (unsigned) psFTFileData->sStatEntry.st_dev);
+    }
+    if (MASK_BIT_IS_SET(psProperties->psFieldMask->ulMask, MAP_INODE))
+    {
+      DEVELOP_PUT_BINARY_NUMBER(pucOutData, n, DECODE_BINARY_TAG_DECIMAL, (unsigned) psFTFileData->sStatEntry.st_ino);
+    }
+    if (MASK_BIT_IS_SET(psProperties->psFieldMask->ulMask, MAP_MODE))
+    {
+      DEVELOP_PUT_BINARY_NUMBER(pucOutData, n, DECODE_BINARY_TAG_OCTAL, (unsigned) psFTFileData->sStatEntry.st_mode);
+    }
+    if (MASK_BIT_IS_SET(psProperties->psFieldMask->ulMask, MAP_NLINK))
+    {
+      DEVELOP_PUT_BINARY_NUMBER(pucOutData, n, DECODE_BINARY_TAG_DECIMAL, (unsigned) psFTFileData->sStatEntry.st_nlink);
+    }
+    if (MASK_BIT_IS_SET(psProperties->psFieldMask->ulMask, MAP_UID))
+    {
+      DEVELOP_PUT_BINARY_NUMBER(pucOutData, n, DECODE_BINARY_TAG_DECIMAL, (unsigned) psFTFileData->sStatEntry.st_uid);
+    }
+    if (MASK_BIT_IS_SET(psProperties->psFieldMask->ulMask, MAP_GID))
+    {
+      DEVELOP_PUT_BINARY_NUMBER(pucOutData, n, DECODE_BINARY_TAG_DECIMAL, (unsigned) psFTFileData->sStatEntry.st_gid);
+    }
+    if (MASK_BIT_IS_SET(psProperties->psFieldMask->ulMask, MAP_RDEV))
+    {
+      DEVELOP_PUT_BINARY_NUMBER(pucOutData, n, DECODE_BINARY_TAG_DECIMAL, (unsigned) psFTFileData->sStatEntry.st_rdev);
+    }
+
+    /*-
+     *******************************************************************
+     *
+     * Last Access Time = atime, Last Modification Time = mtime, and
+     * Last Status Change Time = ctime. Times are zigzag encoded. Times
+     * that TimeFormatTime() can't represent are written as NULL fields
+     * and reported just like DevelopNormalOutput() reports them.
+     *
+     *******************************************************************
+     */
+    asi64Times[0] = (APP_SI64) psFTFileData->sStatEntry.st_atime;
+    asi64Times[1] = (APP_SI64) psFTFileData->sStatEntry.st_mtime;
+    asi64Times[2] = (APP_SI64) psFTFileData->sStatEntry.st_ctime;
+    for (i = 0; i < 3; i++)
+    {
+      if (MASK_BIT_IS_SET(psProperties->psFieldMask->ulMask, aulTimeMasks[i]))
+      {
+        if (asi64Times[i] >= DEVELOP_MIN_BINARY_TIME && asi64Times[i] <= DEVELOP_MAX_BINARY_TIME)
+        {
+          DEVELOP_PUT_BINARY_NUMBER(pucOutData, n, DECODE_BINARY_TAG_TIME, (asi64Times[i] < 0) ? ((((APP_UI64) -(asi64Times[i] + 1)) << 1) | 1) : (((APP_UI64) asi64Times[i]) << 1));
+        }
+        else
+        {
+          pucOutData[n++] = DECODE_BINARY_TAG_NULL;
+          strcat(pcError, (pcError[0]) ? "," : "");
+          strcat(pcError, (i == 0) ? "atime" : (i == 1) ? "mtime" : "ctime");
+          iStatus = ER_NullFields;
+        }
+      }
+    }
+
+    /*-
+     *******************************************************************
+     *
+     * File Size = size
+     *
+     *******************************************************************
+     */
+    if (MASK_BIT_IS_SET(psProperties->psFieldMask->ulMask, MAP_SIZE))
+    {
+      DEVELOP_PUT_BINARY_NUMBER(pucOutData, n, DECODE_BINARY_TAG_DECIMAL, (APP_UI64) psFTFileData->sStatEntry.st_size);
+    }
+
+    /*-
+     *******************************************************************
+     *
+     * File MD5 = md5
+     *
+     *******************************************************************
+     */
+    if (MASK_BIT_IS_SET(psProperties->psFieldMask->ulMask, MAP_MD5))
+    {
+      if (S_ISDIR(psFTFileData->sStatEntry.st_mode))
+      {
+        if (!psProperties->bHashDirectories)
+        {
+          DEVELOP_PUT_BINARY_BYTES(pucOutData, n, DECODE_BINARY_TAG_TEXT, "DIRECTORY", 9);
+        }
+        else if (memcmp(psFTFileData->aucFileMd5, gaucMd5ZeroHash, MD5_HASH_SIZE) != 0)
+        {
+          DEVELOP_PUT_BINARY_BYTES(pucOutData, n, DECODE_BINARY_TAG_HEX, psFTFileData->aucFileMd5, MD5_HASH_SIZE);
+        }
+        else
+        {
+          pucOutData[n++] = DECODE_BINARY_TAG_NULL;
+        }
+      }
+      else if (S_ISLNK(psFTFileData->sStatEntry.st_mode) && !psProperties->bHashSymbolicLinks)
+      {
+        DEVELOP_PUT_BINARY_BYTES(pucOutData, n, DECODE_BINARY_TAG_TEXT, "SYMLINK", 7);
+      }
+      else if (S_ISREG(psFTFileData->sStatEntry.st_mode) || S_ISLNK(psFTFileData->sStatEntry.st_mode))
+      {
+        if (memcmp(psFTFileData->aucFileMd5, gaucMd5ZeroHash, MD5_HASH_SIZE) != 0)
+        {
+          DEVELOP_PUT_BINARY_BYTES(pucOutData, n, DECODE_BINARY_TAG_HEX, psFTFileData->aucFileMd5, MD5_HASH_SIZE);
+        }
+        else
+        {
+          pucOutData[n++] = DECODE_BINARY_TAG_NULL;
+          strcat(pcError, (pcError[0]) ? ",md5" : "md5");
+          iStatus = ER_NullFields;
+        }
+      }
+      else
+      {
+        if (psProperties->bAnalyzeDeviceFiles && memcmp(psFTFileData->aucFileMd5, gaucMd5ZeroHash, MD5_HASH_SIZE) != 0)
+        {
+          DEVELOP_PUT_BINARY_BYTES(pucOutData, n, DECODE_BINARY_TAG_HEX, psFTFileData->aucFileMd5, MD5_HASH_SIZE);
+        }
+        else
+        {
+          DEVELOP_PUT_BINARY_BYTES(pucOutData, n, DECODE_BINARY_TAG_TEXT, "SPECIAL", 7);
+        }
+      }
+    }
+
+    /*-
+     *******************************************************************
+     *
+     * File SHA1 = sha1. Note that special files get the same (short)
+     * treatment that DevelopNormalOutput() gives them.
+     *
+     *******************************************************************
+     */
+    if (MASK_BIT_IS_SET(psProperties->psFieldMask->ulMask, MAP_SHA1))
+    {
+      if (S_ISDIR(psFTFileData->sStatEntry.st_mode))
+      {
+        if (!psProperties->bHashDirectories)
+        {
+          DEVELOP_PUT_BINARY_BYTES(pucOutData, n, DECODE_BINARY_TAG_TEXT, "DIRECTORY", 9);
+        }
+        else if (memcmp(psFTFileData->aucFileSha1, gaucSha1ZeroHash, SHA1_HASH_SIZE) != 0)
+        {
+          DEVELOP_PUT_BINARY_BYTES(pucOutData, n, DECODE_BINARY_TAG_HEX, psFTFileData->aucFileSha1, SHA1_HASH_SIZE);
+        }
+        else
+        {
+          pucOutData[n++] = DECODE_BINARY_TAG_NULL;
+        }
+      }
+      else if (S_ISLNK(psFTFileData->sStatEntry.st_mode) && !psProperties->bHashSymbolicLinks)
+      {
+        DEVELOP_PUT_BINARY_BYTES(pucOutData, n, DECODE_BINARY_TAG_TEXT, "SYMLINK", 7);
+      }
+      else if (S_ISREG(psFTFileData->sStatEntry.st_mode) || S_ISLNK(psFTFileData->sStatEntry.st_mode))
+      {
+        if (memcmp(psFTFileData->aucFileSha1, gaucSha1ZeroHash, SHA1_HASH_SIZE) != 0)
+        {
+          DEVELOP_PUT_BINARY_BYTES(pucOutData, n, DECODE_BINARY_TAG_HEX, psFTFileData->aucFileSha1, SHA1_HASH_SIZE);
+        }
+        else
+        {
+          pucOutData[n++] = DECODE_BINARY_TAG_NULL;
+          strcat(pcError, (pcError[0]) ? ",sha1" : "sha1");
+          iStatus = ER_NullFields;
+        }
+      }
+      else
+      {
+        if (psProperties->bAnalyzeDeviceFiles && memcmp(psFTFileData->aucFileSha1, gaucSha1ZeroHash, MD5_HASH_SIZE) != 0)
+        {
+          DEVELOP_PUT_BINARY_BYTES(pucOutData, n, DECODE_BINARY_TAG_HEX, psFTFileData->aucFileSha1, MD5_HASH_SIZE);
+        }
+        else
+        {
+          DEVELOP_PUT_BINARY_BYTES(pucOutData, n, DECODE_BINARY_TAG_TEXT, "SPECIAL", 7);
+        }
+      }
+    }
+
+    /*-
+     *******************************************************************
+     *
+     * File SHA256 = sha256. Note that special files get the same
+     * (short) treatment that DevelopNormalOutput() gives them.
+     *
+     *******************************************************************
+     */
+    if (MASK_BIT_IS_SET(psProperties->psFieldMask->ulMask, MAP_SHA256))
+    {
+      if (S_ISDIR(psFTFileData->sStatEntry.st_mode))
+      {
+        if (!psProperties->bHashDirectories)
+        {
+          DEVELOP_PUT_BINARY_BYTES(pucOutData, n, DECODE_BINARY_TAG_TEXT, "DIRECTORY", 9);
+        }
+        else if (memcmp(psFTFileData->aucFileSha256, gaucSha256ZeroHash, SHA256_HASH_SIZE) != 0)
+        {
+          DEVELOP_PUT_BINARY_BYTES(pucOutData, n, DECODE_BINARY_TAG_HEX, psFTFileData->aucFileSha256, SHA256_HASH_SIZE);
+        }
+        else
+        {
+          pucOutData[n++] = DECODE_BINARY_TAG_NULL;
+        }
+      }
+      else if (S_ISLNK(psFTFileData->sStatEntry.st_mode) && !psProperties->bHashSymbolicLinks)
+      {
+        DEVELOP_PUT_BINARY_BYTES(pucOutData, n, DECODE_BINARY_TAG_TEXT, "SYMLINK", 7);
+      }
+      else if (S_ISREG(psFTFileData->sStatEntry.st_mode) || S_ISLNK(psFTFileData->sStatEntry.st_mode))
+      {
+        if (memcmp(psFTFileData->aucFileSha256, gaucSha256ZeroHash, SHA256_HASH_SIZE) != 0)
+        {
+          DEVELOP_PUT_BINARY_BYTES(pucOutData, n, DECODE_BINARY_TAG_HEX, psFTFileData->aucFileSha256, SHA256_HASH_SIZE);
+        }
+        else
+        {
+          pucOutData[n++] = DECODE_BINARY_TAG_NULL;
+          strcat(pcError, (pcError[0]) ? ",sha256" : "sha256");
+          iStatus = ER_NullFields;
+        }
+      }
+      else
+      {
+        if (psProperties->bAnalyzeDeviceFiles && memcmp(psFTFileData->aucFileSha256, gaucSha256ZeroHash, MD5_HASH_SIZE) != 0)
+        {
+          DEVELOP_PUT_BINARY_BYTES(pucOutData, n, DECODE_BINARY_TAG_HEX, psFTFileData->aucFileSha256, MD5_HASH_SIZE);
+        }
+        else
+        {
+          DEVELOP_PUT_BINARY_BYTES(pucOutData, n, DECODE_BINARY_TAG_TEXT, "SPECIAL", 7);
+        }
+      }
+    }
+
+    /*-
+     *******************************************************************
+     *
+     * File Magic = magic
+     *
+     *******************************************************************
+     */
+    if (MASK_BIT_IS_SET(psProperties->psFieldMask->ulMask, MAP_MAGIC))
+    {
+#ifdef USE_XMAGIC
+      if (psFTFileData->acType[0])
+      {
+        iLength = strlen(psFTFileData->acType);
+        DEVELOP_PUT_BINARY_BYTES(pucOutData, n, DECODE_BINARY_TAG_TEXT, psFTFileData->acType, iLength);
+      }
+      else
+      {
+        pucOutData[n++] = DECODE_BINARY_TAG_NULL;
+        strcat(pcError, (pcError[0]) ? ",magic" : "magic");
+        iStatus = ER_NullFields;
+      }
+#else
+      pucOutData[n++] = DECODE_BINARY_TAG_NULL;
+#endif
+    }
+  }
+
+  /*-
+   *********************************************************************
+   *
+   * Fill in the record's length (little-endian), and set the write
+   * count for the caller.
+   *
+   *********************************************************************
+   */
+  iLength = n - DECODE_BINARY_LENGTH_SIZE;
+  pucOutData[0] = (unsigned char) (iLength & 0xff);
+  pucOutData[1] = (unsigned char) ((iLength >> 8) & 0xff);
+  pucOutData[2] = (unsigned char) ((iLength >> 16) & 0xff);
+  pucOutData[3] = (unsigned char) ((iLength >> 24) & 0xff);
+  *iWriteCount = n;
+
+  return iStatus;
+}
+#endif
+
 
 /*-
  ***********************************************************************
@@ -69,12 +492,12 @@ DevelopHaveNothingOutput(void *pvProperties, char *pcOutData, int *iWriteCount,
         break;
       }
 #else
-      n += sprintf(&pcOutData[n], "|");
+      pcOutData[n++] = '|';
 #endif
       m += sprintf(&pcError[m], "%s%s", (i == 0) ? "" : ",", (char *) psMaskTable[i].acName);
     }
   }
-  n += sprintf(&pcOutData[n], "%s", psProperties->acNewLine);
+  n += DevelopFormatString(&pcOutData[n], psProperties->acNewLine);
   *iWriteCount += n;
 
   return ER_NullFields;
@@ -139,7 +562,9 @@ DevelopNormalOutput(void *pvProperties, char *pcOutData, int *iWriteCount, FTIME
    *
    *********************************************************************
    */
-  n = sprintf(pcOutData, "\"%s\"", psFTFileData->pcNeuteredPath);
+  pcOutData[0] = '"';
+  n = 1 + DevelopFormatString(&pcOutData[1], psFTFileData->pcNeuteredPath);
+  pcOutData[n++] = '"';
 
   /*-
    *********************************************************************
@@ -164,7 +589,8 @@ DevelopNormalOutput(void *pvProperties, char *pcOutData, int *iWriteCount, FTIME
    */
   if (MASK_BIT_IS_SET(psProperties->psFieldMask->ulMask, MAP_DEV))
   {
-    n += sprintf(&pcOutData[n], "|%u", (unsigned) psFTFileData->sStatEntry.st_dev);
+    pcOutData[n++] = '|';
+    n += DevelopFormatDecimal(&pcOutData[n], (unsigned) psFTFileData->sStatEntry.st_dev);
   }
 
   /*-
@@ -176,7 +602,8 @@ DevelopNormalOutput(void *pvProperties, char *pcOutData, int *iWriteCount, FTIME
    */
   if (MASK_BIT_IS_SET(psProperties->psFieldMask->ulMask, MAP_INODE))
   {
-    n += sprintf(&pcOutData[n], "|%u", (unsigned) psFTFileData->sStatEntry.st_ino);
+    pcOutData[n++] = '|';
+    n += DevelopFormatDecimal(&pcOutData[n], (unsigned) psFTFileData->sStatEntry.st_ino);
   }
 
   /*-
@@ -188,7 +615,8 @@ DevelopNormalOutput(void *pvProperties, char *pcOutData, int *iWriteCount, FTIME
    */
   if (MASK_BIT_IS_SET(psProperties->psFieldMask->ulMask, MAP_MODE))
   {
-    n += sprintf(&pcOutData[n], "|%o", (unsigned) psFTFileData->sStatEntry.st_mode);
+    pcOutData[n++] = '|';
+    n += DevelopFormatOctal(&pcOutData[n], (unsigned) psFTFileData->sStatEntry.st_mode);
   }
 
   /*-
@@ -200,7 +628,8 @@ DevelopNormalOutput(void *pvProperties, char *pcOutData, int *iWriteCount, FTIME
    */
   if (MASK_BIT_IS_SET(psProperties->psFieldMask->ulMask, MAP_NLINK))
   {
-    n += sprintf(&pcOutData[n], "|%u", (unsigned) psFTFileData->sStatEntry.st_nlink);
+    pcOutData[n++] = '|';
+    n += DevelopFormatDecimal(&pcOutData[n], (unsigned) psFTFileData->sStatEntry.st_nlink);
   }
 
   /*-
@@ -212,7 +641,8 @@ DevelopNormalOutput(void *pvProperties, char *pcOutData, int *iWriteCount, FTIME
    */
   if (MASK_BIT_IS_SET(psProperties->psFieldMask->ulMask, MAP_UID))
   {
-    n += sprintf(&pcOutData[n], "|%u", (unsigned) psFTFileData->sStatEntry.st_uid);
+    pcOutData[n++] = '|';
+    n += DevelopFormatDecimal(&pcOutData[n], (unsigned) psFTFileData->sStatEntry.st_uid);
   }
 
   /*-
@@ -224,7 +654,8 @@ DevelopNormalOutput(void *pvProperties, char *pcOutData, int *iWriteCount, FTIME
    */
   if (MASK_BIT_IS_SET(psProperties->psFieldMask->ulMask, MAP_GID))
   {
-    n += sprintf(&pcOutData[n], "|%u", (unsigned) psFTFileData->sStatEntry.st_gid);
+    pcOutData[n++] = '|';
+    n += DevelopFormatDecimal(&pcOutData[n], (unsigned) psFTFileData->sStatEntry.st_gid);
   }
 
   /*-
@@ -236,7 +667,8 @@ DevelopNormalOutput(void *pvProperties, char *pcOutData, int *iWriteCount, FTIME
    */
   if (MASK_BIT_IS_SET(psProperties->psFieldMask->ulMask, MAP_RDEV))
   {
-    n += sprintf(&pcOutData[n], "|%u", (unsigned) psFTFileData->sStatEntry.st_rdev);
+    pcOutData[n++] = '|';
+    n += DevelopFormatDecimal(&pcOutData[n], (unsigned) psFTFileData->sStatEntry.st_rdev);
   }
 
   /*-
@@ -248,14 +680,15 @@ DevelopNormalOutput(void *pvProperties, char *pcOutData, int *iWriteCount, FTIME
    */
   if (MASK_BIT_IS_SET(psProperties->psFieldMask->ulMask, MAP_ATIME))
   {
-    iError = TimeFormatTime(&psFTFileData->sStatEntry.st_atime, acTime);
+    pcOutData[n++] = '|';
+    iError = DevelopFormatTime(&psFTFileData->sStatEntry.st_atime, acTime);
     if (iError == ER_OK)
     {
-      n += sprintf(&pcOutData[n], "|%s", acTime);
+      memcpy(&pcOutData[n], acTime, FTIMES_TIME_FORMAT_SIZE - 1);
+      n += FTIMES_TIME_FORMAT_SIZE - 1;
     }
     else
     {
-      n += sprintf(&pcOutData[n], "|");
       strcat(pcError, (pcError[0]) ? ",atime" : "atime");
       iStatus = ER_NullFields;
     }
@@ -270,14 +703,15 @@ DevelopNormalOutput(void *pvProperties, char *pcOutData, int *iWriteCount, FTIME
    */
   if (MASK_BIT_IS_SET(psProperties->psFieldMask->ulMask, MAP_MTIME))
   {
-    iError = TimeFormatTime(&psFTFileData->sStatEntry.st_mtime, acTime);
+    pcOutData[n++] = '|';
+    iError = DevelopFormatTime(&psFTFileData->sStatEntry.st_mtime, acTime);
     if (iError == ER_OK)
     {
-      n += sprintf(&pcOutData[n], "|%s", acTime);
+      memcpy(&pcOutData[n], acTime, FTIMES_TIME_FORMAT_SIZE - 1);
+      n += FTIMES_TIME_FORMAT_SIZE - 1;
     }
     else
     {
-      n += sprintf(&pcOutData[n], "|");
       strcat(pcError, (pcError[0]) ? ",mtime" : "mtime");
       iStatus = ER_NullFields;
     }
@@ -292,14 +726,15 @@ DevelopNormalOutput(void *pvProperties, char *pcOutData, int *iWriteCount, FTIME
    */
   if (MASK_BIT_IS_SET(psProperties->psFieldMask->ulMask, MAP_CTIME))
   {
-    iError = TimeFormatTime(&psFTFileData->sStatEntry.st_ctime, acTime);
+    pcOutData[n++] = '|';
+    iError = DevelopFormatTime(&psFTFileData->sStatEntry.st_ctime, acTime);
     if (iError == ER_OK)
     {
-      n += sprintf(&pcOutData[n], "|%s", acTime);
+      memcpy(&pcOutData[n], acTime, FTIMES_TIME_FORMAT_SIZE - 1);
+      n += FTIMES_TIME_FORMAT_SIZE - 1;
     }
     else
     {
-      n += sprintf(&pcOutData[n], "|");
       strcat(pcError, (pcError[0]) ? ",ctime" : "ctime");
       iStatus = ER_NullFields;
     }
@@ -314,11 +749,8 @@ DevelopNormalOutput(void *pvProperties, char *pcOutData, int *iWriteCount, FTIME
    */
   if (MASK_BIT_IS_SET(psProperties->psFieldMask->ulMask, MAP_SIZE))
   {
-#ifdef USE_AP_SNPRINTF
-    n += snprintf(&pcOutData[n], FTIMES_MAX_64BIT_SIZE, "|%qu", (unsigned long long) psFTFileData->sStatEntry.st_size);
-#else
-    n += snprintf(&pcOutData[n], FTIMES_MAX_64BIT_SIZE, "|%llu", (unsigned long long) psFTFileData->sStatEntry.st_size);
-#endif
+    pcOutData[n++] = '|';
+    n += DevelopFormatDecimal(&pcOutData[n], (APP_UI64) psFTFileData->sStatEntry.st_size);
   }
 
   /*-
@@ -337,19 +769,19 @@ DevelopNormalOutput(void *pvProperties, char *pcOutData, int *iWriteCount, FTIME
       {
         if (memcmp(psFTFileData->aucFileMd5, gaucMd5ZeroHash, MD5_HASH_SIZE) != 0)
         {
-          n += MD5HashToHex(psFTFileData->aucFileMd5, &pcOutData[n]);
+          n += DevelopFormatHexBytes(&pcOutData[n], psFTFileData->aucFileMd5, MD5_HASH_SIZE);
         }
       }
       else
       {
-        n += sprintf(&pcOutData[n], "DIRECTORY");
+        n += DevelopFormatString(&pcOutData[n], "DIRECTORY");
       }
     }
     else if (S_ISREG(psFTFileData->sStatEntry.st_mode))
     {
       if (memcmp(psFTFileData->aucFileMd5, gaucMd5ZeroHash, MD5_HASH_SIZE) != 0)
       {
-        n += MD5HashToHex(psFTFileData->aucFileMd5, &pcOutData[n]);
+        n += DevelopFormatHexBytes(&pcOutData[n], psFTFileData->aucFileMd5, MD5_HASH_SIZE);
       }
       else
       {
@@ -363,7 +795,7 @@ DevelopNormalOutput(void *pvProperties, char *pcOutData, int *iWriteCount, FTIME
       {
         if (memcmp(psFTFileData->aucFileMd5, gaucMd5ZeroHash, MD5_HASH_SIZE) != 0)
         {
-          n += MD5HashToHex(psFTFileData->aucFileMd5, &pcOutData[n]);
+          n += DevelopFormatHexBytes(&pcOutData[n], psFTFileData->aucFileMd5, MD5_HASH_SIZE);
         }
         else
         {
@@ -373,18 +805,18 @@ DevelopNormalOutput(void *pvProperties, char *pcOutData, int *iWriteCount, FTIME
       }
       else
       {
-        n += sprintf(&pcOutData[n], "SYMLINK");
+        n += DevelopFormatString(&pcOutData[n], "SYMLINK");
       }
     }
     else
     {
       if (psProperties->bAnalyzeDeviceFiles && memcmp(psFTFileData->aucFileMd5, gaucMd5ZeroHash, MD5_HASH_SIZE) != 0)
       {
-        n += MD5HashToHex(psFTFileData->aucFileMd5, &pcOutData[n]);
+        n += DevelopFormatHexBytes(&pcOutData[n], psFTFileData->aucFileMd5, MD5_HASH_SIZE);
       }
       else
       {
-        n += sprintf(&pcOutData[n], "SPECIAL");
+        n += DevelopFormatString(&pcOutData[n], "SPECIAL");
       }
     }
   }
@@ -405,19 +837,19 @@ DevelopNormalOutput(void *pvProperties, char *pcOutData, int *iWriteCount, FTIME
       {
         if (memcmp(psFTFileData->aucFileSha1, gaucSha1ZeroHash, SHA1_HASH_SIZE) != 0)
         {
-          n += SHA1HashToHex(psFTFileData->aucFileSha1, &pcOutData[n]);
+          n += DevelopFormatHexBytes(&pcOutData[n], psFTFileData->aucFileSha1, SHA1_HASH_SIZE);
         }
       }
       else
       {
-        n += sprintf(&pcOutData[n], "DIRECTORY");
+        n += DevelopFormatString(&pcOutData[n], "DIRECTORY");
       }
     }
     else if (S_ISREG(psFTFileData->sStatEntry.st_mode))
     {
       if (memcmp(psFTFileData->aucFileSha1, gaucSha1ZeroHash, SHA1_HASH_SIZE) != 0)
       {
-        n += SHA1HashToHex(psFTFileData->aucFileSha1, &pcOutData[n]);
+        n += DevelopFormatHexBytes(&pcOutData[n], psFTFileData->aucFileSha1, SHA1_HASH_SIZE);
       }
       else
       {
@@ -431,7 +863,7 @@ DevelopNormalOutput(void *pvProperties, char *pcOutData, int *iWriteCount, FTIME
       {
         if (memcmp(psFTFileData->aucFileSha1, gaucSha1ZeroHash, SHA1_HASH_SIZE) != 0)
         {
-          n += SHA1HashToHex(psFTFileData->aucFileSha1, &pcOutData[n]);
+          n += DevelopFormatHexBytes(&pcOutData[n], psFTFileData->aucFileSha1, SHA1_HASH_SIZE);
         }
         else
         {
@@ -441,18 +873,18 @@ DevelopNormalOutput(void *pvProperties, char *pcOutData, int *iWriteCount, FTIME
       }
       else
       {
-        n += sprintf(&pcOutData[n], "SYMLINK");
+        n += DevelopFormatString(&pcOutData[n], "SYMLINK");
       }
     }
     else
     {
       if (psProperties->bAnalyzeDeviceFiles && memcmp(psFTFileData->aucFileSha1, gaucSha1ZeroHash, MD5_HASH_SIZE) != 0)
       {
-        n += MD5HashToHex(psFTFileData->aucFileSha1, &pcOutData[n]);
+        n += DevelopFormatHexBytes(&pcOutData[n], psFTFileData->aucFileSha1, MD5_HASH_SIZE);
       }
       else
       {
-        n += sprintf(&pcOutData[n], "SPECIAL");
+        n += DevelopFormatString(&pcOutData[n], "SPECIAL");
       }
     }
   }
@@ -473,19 +905,19 @@ DevelopNormalOutput(void *pvProperties, char *pcOutData, int *iWriteCount, FTIME
       {
         if (memcmp(psFTFileData->aucFileSha256, gaucSha256ZeroHash, SHA256_HASH_SIZE) != 0)
         {
-          n += SHA256HashToHex(psFTFileData->aucFileSha256, &pcOutData[n]);
+          n += DevelopFormatHexBytes(&pcOutData[n], psFTFileData->aucFileSha256, SHA256_HASH_SIZE);
         }
       }
       else
       {
-        n += sprintf(&pcOutData[n], "DIRECTORY");
+        n += DevelopFormatString(&pcOutData[n], "DIRECTORY");
       }
     }
     else if (S_ISREG(psFTFileData->sStatEntry.st_mode))
     {
       if (memcmp(psFTFileData->aucFileSha256, gaucSha256ZeroHash, SHA256_HASH_SIZE) != 0)
       {
-        n += SHA256HashToHex(psFTFileData->aucFileSha256, &pcOutData[n]);
+        n += DevelopFormatHexBytes(&pcOutData[n], psFTFileData->aucFileSha256, SHA256_HASH_SIZE);
       }
       else
       {
@@ -499,7 +931,7 @@ DevelopNormalOutput(void *pvProperties, char *pcOutData, int *iWriteCount, FTIME
       {
         if (memcmp(psFTFileData->aucFileSha256, gaucSha256ZeroHash, SHA256_HASH_SIZE) != 0)
         {
-          n += SHA256HashToHex(psFTFileData->aucFileSha256, &pcOutData[n]);
+          n += DevelopFormatHexBytes(&pcOutData[n], psFTFileData->aucFileSha256, SHA256_HASH_SIZE);
         }
         else
         {
@@ -509,18 +941,18 @@ DevelopNormalOutput(void *pvProperties, char *pcOutData, int *iWriteCount, FTIME
       }
       else
       {
-        n += sprintf(&pcOutData[n], "SYMLINK");
+        n += DevelopFormatString(&pcOutData[n], "SYMLINK");
       }
     }
     else
     {
       if (psProperties->bAnalyzeDeviceFiles && memcmp(psFTFileData->aucFileSha256, gaucSha256ZeroHash, MD5_HASH_SIZE) != 0)
       {
-        n += MD5HashToHex(psFTFileData->aucFileSha256, &pcOutData[n]);
+        n += DevelopFormatHexBytes(&pcOutData[n], psFTFileData->aucFileSha256, MD5_HASH_SIZE);
       }
       else
       {
-        n += sprintf(&pcOutData[n], "SPECIAL");
+        n += DevelopFormatString(&pcOutData[n], "SPECIAL");
       }
     }
   }
@@ -538,7 +970,7 @@ DevelopNormalOutput(void *pvProperties, char *pcOutData, int *iWriteCount, FTIME
     pcOutData[n++] = '|';
     if (psFTFileData->acType[0])
     {
-      n += sprintf(&pcOutData[n], "%s", psFTFileData->acType);
+      n += DevelopFormatString(&pcOutData[n], psFTFileData->acType);
     }
     else
     {
@@ -560,7 +992,7 @@ DevelopNormalOutput(void *pvProperties, char *pcOutData, int *iWriteCount, FTIME
    *
    *********************************************************************
    */
-  n += sprintf(&pcOutData[n], "%s", psProperties->acNewLine);
+  n += DevelopFormatString(&pcOutData[n], psProperties->acNewLine);
 
   /*-
    *********************************************************************
@@ -661,7 +1093,7 @@ DevelopNormalOutput(void *pvProperties, char *pcOutData, int *iWriteCount, FTIME
     if (psFTFileData->dwFileIndexHigh != 0xffffffff && psFTFileData->dwFileIndexLow != 0xffffffff)
     {
       ui64FileIndex = (((unsigned __int64) psFTFileData->dwFileIndexHigh) << 32) | psFTFileData->dwFileIndexLow;
-      n += sprintf(&pcOutData[n], "%I64u", (APP_UI64) ui64FileIndex);
+      n += DevelopFormatDecimal(&pcOutData[n], (APP_UI64) ui64FileIndex);
     }
     else
     {
@@ -822,7 +1254,8 @@ DevelopNormalOutput(void *pvProperties, char *pcOutData, int *iWriteCount, FTIME
   if (MASK_BIT_IS_SET(psProperties->psFieldMask->ulMask, MAP_SIZE))
   {
     ui64FileSize = (((unsigned __int64) psFTFileData->dwFileSizeHigh) << 32) | psFTFileData->dwFileSizeLow;
-    n += sprintf(&pcOutData[n], "|%I64u", (APP_UI64) ui64FileSize);
+    pcOutData[n++] = '|';
+    n += DevelopFormatDecimal(&pcOutData[n], (APP_UI64) ui64FileSize);
   }
 
   /*-
@@ -865,7 +1298,7 @@ DevelopNormalOutput(void *pvProperties, char *pcOutData, int *iWriteCount, FTIME
       {
         if (memcmp(psFTFileData->aucFileMd5, gaucMd5ZeroHash, MD5_HASH_SIZE) != 0)
         {
-          n += MD5HashToHex(psFTFileData->aucFileMd5, &pcOutData[n]);
+          n += DevelopFormatHexBytes(&pcOutData[n], psFTFileData->aucFileMd5, MD5_HASH_SIZE);
         }
       }
       else
@@ -877,7 +1310,7 @@ DevelopNormalOutput(void *pvProperties, char *pcOutData, int *iWriteCount, FTIME
     {
       if (memcmp(psFTFileData->aucFileMd5, gaucMd5ZeroHash, MD5_HASH_SIZE) != 0)
       {
-        n += MD5HashToHex(psFTFileData->aucFileMd5, &pcOutData[n]);
+        n += DevelopFormatHexBytes(&pcOutData[n], psFTFileData->aucFileMd5, MD5_HASH_SIZE);
       }
       else
       {
@@ -903,7 +1336,7 @@ DevelopNormalOutput(void *pvProperties, char *pcOutData, int *iWriteCount, FTIME
       {
         if (memcmp(psFTFileData->aucFileSha1, gaucSha1ZeroHash, SHA1_HASH_SIZE) != 0)
         {
-          n += SHA1HashToHex(psFTFileData->aucFileSha1, &pcOutData[n]);
+          n += DevelopFormatHexBytes(&pcOutData[n], psFTFileData->aucFileSha1, SHA1_HASH_SIZE);
         }
       }
       else
@@ -915,7 +1348,7 @@ DevelopNormalOutput(void *pvProperties, char *pcOutData, int *iWriteCount, FTIME
     {
       if (memcmp(psFTFileData->aucFileSha1, gaucSha1ZeroHash, SHA1_HASH_SIZE) != 0)
       {
-        n += SHA1HashToHex(psFTFileData->aucFileSha1, &pcOutData[n]);
+        n += DevelopFormatHexBytes(&pcOutData[n], psFTFileData->aucFileSha1, SHA1_HASH_SIZE);
       }
       else
       {
@@ -941,7 +1374,7 @@ DevelopNormalOutput(void *pvProperties, char *pcOutData, int *iWriteCount, FTIME
       {
         if (memcmp(psFTFileData->aucFileSha256, gaucSha256ZeroHash, SHA256_HASH_SIZE) != 0)
         {
-          n += SHA256HashToHex(psFTFileData->aucFileSha256, &pcOutData[n]);
+          n += DevelopFormatHexBytes(&pcOutData[n], psFTFileData->aucFileSha256, SHA256_HASH_SIZE);
         }
       }
       else
@@ -953,7 +1386,7 @@ DevelopNormalOutput(void *pvProperties, char *pcOutData, int *iWriteCount, FTIME
     {
       if (memcmp(psFTFileData->aucFileSha256, gaucSha256ZeroHash, SHA256_HASH_SIZE) != 0)
       {
-        n += SHA256HashToHex(psFTFileData->aucFileSha256, &pcOutData[n]);
+        n += DevelopFormatHexBytes(&pcOutData[n], psFTFileData->aucFileSha256, SHA256_HASH_SIZE);
       }
       else
       {
@@ -1077,7 +1510,7 @@ DevelopNormalOutput(void *pvProperties, char *pcOutData, int *iWriteCount, FTIME
    *
    *********************************************************************
    */
-  n += sprintf(&pcOutData[n], "%s", psProperties->acNewLine);
+  n += DevelopFormatString(&pcOutData[n], psProperties->acNewLine);
 
   /*-
    *********************************************************************
@@ -1130,7 +1563,9 @@ DevelopCompressedOutput(void *pvProperties, char *pcOutData, int *iWriteCount, F
    */
   if (lRecoveryCounter == 0)
   {
-    n = sprintf(pcOutData, "00\"%s\"", psFTFileData->pcNeuteredPath);
+    memcpy(pcOutData, "00\"", 3);
+    n = 3 + DevelopFormatString(&pcOutData[3], psFTFileData->pcNeuteredPath);
+    pcOutData[n++] = '"';
     strncpy(acLastName, psFTFileData->pcNeuteredPath, (4 * FTIMES_MAX_PATH));
   }
   else
@@ -1146,7 +1581,9 @@ DevelopCompressedOutput(void *pvProperties, char *pcOutData, int *iWriteCount, F
     i = 0;
     if (acLastName[0] == '\0')
     {
-      n = sprintf(pcOutData, "00\"%s\"", psFTFileData->pcNeuteredPath);
+      memcpy(pcOutData, "00\"", 3);
+    n = 3 + DevelopFormatString(&pcOutData[3], psFTFileData->pcNeuteredPath);
+    pcOutData[n++] = '"';
     }
     else
     {
@@ -1157,7 +1594,9 @@ DevelopCompressedOutput(void *pvProperties, char *pcOutData, int *iWriteCount, F
       {
         i++;
       }
-      n = sprintf(pcOutData, "%02x%s\"", i + 1 /* Add 1 for the leading quote. */, &psFTFileData->pcNeuteredPath[i]);
+      memcpy(pcOutData, &gacHexPairs[(i + 1 /* Add 1 for the leading quote. */) * 2], 2);
+      n = 2 + DevelopFormatString(&pcOutData[2], &psFTFileData->pcNeuteredPath[i]);
+      pcOutData[n++] = '"';
     }
     strncpy(&acLastName[i], &psFTFileData->pcNeuteredPath[i], ((4 * FTIMES_MAX_PATH) - i) /* Must subtract i here to prevent overruns. */);
   }
@@ -1192,7 +1631,7 @@ DevelopCompressedOutput(void *pvProperties, char *pcOutData, int *iWriteCount, F
     pcOutData[n++] = '|';
     if (lRecoveryCounter == 0)
     {
-      n += sprintf(&pcOutData[n], "%x", (unsigned) psFTFileData->sStatEntry.st_dev);
+      n += DevelopFormatHex(&pcOutData[n], (unsigned) psFTFileData->sStatEntry.st_dev);
     }
     else
     {
@@ -1202,7 +1641,7 @@ DevelopCompressedOutput(void *pvProperties, char *pcOutData, int *iWriteCount, F
       }
       else
       {
-        n += sprintf(&pcOutData[n], "%x", (unsigned) psFTFileData->sStatEntry.st_dev);
+        n += DevelopFormatHex(&pcOutData[n], (unsigned) psFTFileData->sStatEntry.st_dev);
       }
     }
   }
@@ -1219,7 +1658,7 @@ DevelopCompressedOutput(void *pvProperties, char *pcOutData, int *iWriteCount, F
     pcOutData[n++] = '|';
     if (lRecoveryCounter == 0)
     {
-      n += sprintf(&pcOutData[n], "%x", (unsigned) psFTFileData->sStatEntry.st_ino);
+      n += DevelopFormatHex(&pcOutData[n], (unsigned) psFTFileData->sStatEntry.st_ino);
     }
     else
     {
@@ -1239,7 +1678,7 @@ DevelopCompressedOutput(void *pvProperties, char *pcOutData, int *iWriteCount, F
     pcOutData[n++] = '|';
     if (lRecoveryCounter == 0)
     {
-      n += sprintf(&pcOutData[n], "%x", (unsigned) psFTFileData->sStatEntry.st_mode);
+      n += DevelopFormatHex(&pcOutData[n], (unsigned) psFTFileData->sStatEntry.st_mode);
     }
     else
     {
@@ -1249,7 +1688,7 @@ DevelopCompressedOutput(void *pvProperties, char *pcOutData, int *iWriteCount, F
       }
       else
       {
-        n += sprintf(&pcOutData[n], "%x", (unsigned) psFTFileData->sStatEntry.st_mode);
+        n += DevelopFormatHex(&pcOutData[n], (unsigned) psFTFileData->sStatEntry.st_mode);
       }
     }
   }
@@ -1266,7 +1705,7 @@ DevelopCompressedOutput(void *pvProperties, char *pcOutData, int *iWriteCount, F
     pcOutData[n++] = '|';
     if (lRecoveryCounter == 0)
     {
-      n += sprintf(&pcOutData[n], "%x", (unsigned) psFTFileData->sStatEntry.st_nlink);
+      n += DevelopFormatHex(&pcOutData[n], (unsigned) psFTFileData->sStatEntry.st_nlink);
     }
     else
     {
@@ -1276,7 +1715,7 @@ DevelopCompressedOutput(void *pvProperties, char *pcOutData, int *iWriteCount, F
       }
       else
       {
-        n += sprintf(&pcOutData[n], "%x", (unsigned) psFTFileData->sStatEntry.st_nlink);
+        n += DevelopFormatHex(&pcOutData[n], (unsigned) psFTFileData->sStatEntry.st_nlink);
       }
     }
   }
@@ -1293,7 +1732,7 @@ DevelopCompressedOutput(void *pvProperties, char *pcOutData, int *iWriteCount, F
     pcOutData[n++] = '|';
     if (lRecoveryCounter == 0)
     {
-      n += sprintf(&pcOutData[n], "%x", (unsigned) psFTFileData->sStatEntry.st_uid);
+      n += DevelopFormatHex(&pcOutData[n], (unsigned) psFTFileData->sStatEntry.st_uid);
     }
     else
     {
@@ -1303,7 +1742,7 @@ DevelopCompressedOutput(void *pvProperties, char *pcOutData, int *iWriteCount, F
       }
       else
       {
-        n += sprintf(&pcOutData[n], "%x", (unsigned) psFTFileData->sStatEntry.st_uid);
+        n += DevelopFormatHex(&pcOutData[n], (unsigned) psFTFileData->sStatEntry.st_uid);
       }
     }
   }
@@ -1320,7 +1759,7 @@ DevelopCompressedOutput(void *pvProperties, char *pcOutData, int *iWriteCount, F
     pcOutData[n++] = '|';
     if (lRecoveryCounter == 0)
     {
-      n += sprintf(&pcOutData[n], "%x", (unsigned) psFTFileData->sStatEntry.st_gid);
+      n += DevelopFormatHex(&pcOutData[n], (unsigned) psFTFileData->sStatEntry.st_gid);
     }
     else
     {
@@ -1330,7 +1769,7 @@ DevelopCompressedOutput(void *pvProperties, char *pcOutData, int *iWriteCount, F
       }
       else
       {
-        n += sprintf(&pcOutData[n], "%x", (unsigned) psFTFileData->sStatEntry.st_gid);
+        n += DevelopFormatHex(&pcOutData[n], (unsigned) psFTFileData->sStatEntry.st_gid);
       }
     }
   }
@@ -1347,7 +1786,7 @@ DevelopCompressedOutput(void *pvProperties, char *pcOutData, int *iWriteCount, F
     pcOutData[n++] = '|';
     if (lRecoveryCounter == 0)
     {
-      n += sprintf(&pcOutData[n], "%x", (unsigned) psFTFileData->sStatEntry.st_rdev);
+      n += DevelopFormatHex(&pcOutData[n], (unsigned) psFTFileData->sStatEntry.st_rdev);
     }
     else
     {
@@ -1357,7 +1796,7 @@ DevelopCompressedOutput(void *pvProperties, char *pcOutData, int *iWriteCount, F
       }
       else
       {
-        n += sprintf(&pcOutData[n], "%x", (unsigned) psFTFileData->sStatEntry.st_rdev);
+        n += DevelopFormatHex(&pcOutData[n], (unsigned) psFTFileData->sStatEntry.st_rdev);
       }
     }
   }
@@ -1374,7 +1813,7 @@ DevelopCompressedOutput(void *pvProperties, char *pcOutData, int *iWriteCount, F
     pcOutData[n++] = '|';
     if (lRecoveryCounter == 0)
     {
-      n += sprintf(&pcOutData[n], "%x", (unsigned) psFTFileData->sStatEntry.st_atime);
+      n += DevelopFormatHex(&pcOutData[n], (unsigned) psFTFileData->sStatEntry.st_atime);
     }
     else if (psFTFileData->sStatEntry.st_atime == sStatLastEntry.st_atime)
     {
@@ -1402,7 +1841,7 @@ DevelopCompressedOutput(void *pvProperties, char *pcOutData, int *iWriteCount, F
     }
     else if (lRecoveryCounter == 0)
     {
-      n += sprintf(&pcOutData[n], "%x", (unsigned) psFTFileData->sStatEntry.st_mtime);
+      n += DevelopFormatHex(&pcOutData[n], (unsigned) psFTFileData->sStatEntry.st_mtime);
     }
     else
     {
@@ -1437,7 +1876,7 @@ DevelopCompressedOutput(void *pvProperties, char *pcOutData, int *iWriteCount, F
     }
     else if (lRecoveryCounter == 0)
     {
-      n += sprintf(&pcOutData[n], "%x", (unsigned) psFTFileData->sStatEntry.st_ctime);
+      n += DevelopFormatHex(&pcOutData[n], (unsigned) psFTFileData->sStatEntry.st_ctime);
     }
     else
     {
@@ -1462,11 +1901,7 @@ DevelopCompressedOutput(void *pvProperties, char *pcOutData, int *iWriteCount, F
   if (MASK_BIT_IS_SET(psProperties->psFieldMask->ulMask, MAP_SIZE))
   {
     pcOutData[n++] = '|';
-#ifdef USE_AP_SNPRINTF
-    n += snprintf(&pcOutData[n], FTIMES_MAX_64BIT_SIZE, "%qx", (unsigned long long) psFTFileData->sStatEntry.st_size);
-#else
-    n += snprintf(&pcOutData[n], FTIMES_MAX_64BIT_SIZE, "%llx", (unsigned long long) psFTFileData->sStatEntry.st_size);
-#endif
+    n += DevelopFormatHex(&pcOutData[n], (APP_UI64) psFTFileData->sStatEntry.st_size);
   }
 
   /*-
@@ -1485,7 +1920,7 @@ DevelopCompressedOutput(void *pvProperties, char *pcOutData, int *iWriteCount, F
       {
         if (memcmp(psFTFileData->aucFileMd5, gaucMd5ZeroHash, MD5_HASH_SIZE) != 0)
         {
-          n += MD5HashToBase64(psFTFileData->aucFileMd5, &pcOutData[n]);
+          n += DevelopFormatBase64(&pcOutData[n], psFTFileData->aucFileMd5, MD5_HASH_SIZE);
         }
         else
         {
@@ -1502,7 +1937,7 @@ DevelopCompressedOutput(void *pvProperties, char *pcOutData, int *iWriteCount, F
     {
       if (memcmp(psFTFileData->aucFileMd5, gaucMd5ZeroHash, MD5_HASH_SIZE) != 0)
       {
-        n += MD5HashToBase64(psFTFileData->aucFileMd5, &pcOutData[n]);
+        n += DevelopFormatBase64(&pcOutData[n], psFTFileData->aucFileMd5, MD5_HASH_SIZE);
       }
       else
       {
@@ -1516,7 +1951,7 @@ DevelopCompressedOutput(void *pvProperties, char *pcOutData, int *iWriteCount, F
       {
         if (memcmp(psFTFileData->aucFileMd5, gaucMd5ZeroHash, MD5_HASH_SIZE) != 0)
         {
-          n += MD5HashToBase64(psFTFileData->aucFileMd5, &pcOutData[n]);
+          n += DevelopFormatBase64(&pcOutData[n], psFTFileData->aucFileMd5, MD5_HASH_SIZE);
         }
         else
         {
@@ -1533,7 +1968,7 @@ DevelopCompressedOutput(void *pvProperties, char *pcOutData, int *iWriteCount, F
     {
       if (psProperties->bAnalyzeDeviceFiles && memcmp(psFTFileData->aucFileMd5, gaucMd5ZeroHash, MD5_HASH_SIZE) != 0)
       {
-        n += MD5HashToBase64(psFTFileData->aucFileMd5, &pcOutData[n]);
+        n += DevelopFormatBase64(&pcOutData[n], psFTFileData->aucFileMd5, MD5_HASH_SIZE);
       }
       else
       {
@@ -1558,7 +1993,7 @@ DevelopCompressedOutput(void *pvProperties, char *pcOutData, int *iWriteCount, F
       {
         if (memcmp(psFTFileData->aucFileSha1, gaucSha1ZeroHash, SHA1_HASH_SIZE) != 0)
         {
-          n += SHA1HashToBase64(psFTFileData->aucFileSha1, &pcOutData[n]);
+          n += DevelopFormatBase64(&pcOutData[n], psFTFileData->aucFileSha1, SHA1_HASH_SIZE);
         }
         else
         {
@@ -1575,7 +2010,7 @@ DevelopCompressedOutput(void *pvProperties, char *pcOutData, int *iWriteCount, F
     {
       if (memcmp(psFTFileData->aucFileSha1, gaucSha1ZeroHash, SHA1_HASH_SIZE) != 0)
       {
-        n += SHA1HashToBase64(psFTFileData->aucFileSha1, &pcOutData[n]);
+        n += DevelopFormatBase64(&pcOutData[n], psFTFileData->aucFileSha1, SHA1_HASH_SIZE);
       }
       else
       {
@@ -1589,7 +2024,7 @@ DevelopCompressedOutput(void *pvProperties, char *pcOutData, int *iWriteCount, F
       {
         if (memcmp(psFTFileData->aucFileSha1, gaucSha1ZeroHash, SHA1_HASH_SIZE) != 0)
         {
-          n += SHA1HashToBase64(psFTFileData->aucFileSha1, &pcOutData[n]);
+          n += DevelopFormatBase64(&pcOutData[n], psFTFileData->aucFileSha1, SHA1_HASH_SIZE);
         }
         else
         {
@@ -1606,7 +2041,7 @@ DevelopCompressedOutput(void *pvProperties, char *pcOutData, int *iWriteCount, F
     {
       if (psProperties->bAnalyzeDeviceFiles && memcmp(psFTFileData->aucFileSha1, gaucSha1ZeroHash, MD5_HASH_SIZE) != 0)
       {
-        n += MD5HashToBase64(psFTFileData->aucFileSha1, &pcOutData[n]);
+        n += DevelopFormatBase64(&pcOutData[n], psFTFileData->aucFileSha1, MD5_HASH_SIZE);
       }
       else
       {
@@ -1631,7 +2066,7 @@ DevelopCompressedOutput(void *pvProperties, char *pcOutData, int *iWriteCount, F
       {
         if (memcmp(psFTFileData->aucFileSha256, gaucSha256ZeroHash, SHA256_HASH_SIZE) != 0)
         {
-          n += SHA256HashToBase64(psFTFileData->aucFileSha256, &pcOutData[n]);
+          n += DevelopFormatBase64(&pcOutData[n], psFTFileData->aucFileSha256, SHA256_HASH_SIZE);
         }
         else
         {
@@ -1648,7 +2083,7 @@ DevelopCompressedOutput(void *pvProperties, char *pcOutData, int *iWriteCount, F
     {
       if (memcmp(psFTFileData->aucFileSha256, gaucSha256ZeroHash, SHA256_HASH_SIZE) != 0)
       {
-        n += SHA256HashToBase64(psFTFileData->aucFileSha256, &pcOutData[n]);
+        n += DevelopFormatBase64(&pcOutData[n], psFTFileData->aucFileSha256, SHA256_HASH_SIZE);
       }
       else
       {
@@ -1662,7 +2097,7 @@ DevelopCompressedOutput(void *pvProperties, char *pcOutData, int *iWriteCount, F
       {
         if (memcmp(psFTFileData->aucFileSha256, gaucSha256ZeroHash, SHA256_HASH_SIZE) != 0)
         {
-          n += SHA256HashToBase64(psFTFileData->aucFileSha256, &pcOutData[n]);
+          n += DevelopFormatBase64(&pcOutData[n], psFTFileData->aucFileSha256, SHA256_HASH_SIZE);
         }
         else
         {
@@ -1679,7 +2114,7 @@ DevelopCompressedOutput(void *pvProperties, char *pcOutData, int *iWriteCount, F
     {
       if (psProperties->bAnalyzeDeviceFiles && memcmp(psFTFileData->aucFileSha256, gaucSha256ZeroHash, MD5_HASH_SIZE) != 0)
       {
-        n += MD5HashToBase64(psFTFileData->aucFileSha256, &pcOutData[n]);
+        n += DevelopFormatBase64(&pcOutData[n], psFTFileData->aucFileSha256, MD5_HASH_SIZE);
       }
       else
       {
@@ -1707,7 +2142,7 @@ DevelopCompressedOutput(void *pvProperties, char *pcOutData, int *iWriteCount, F
    *
    *********************************************************************
    */
-  n += sprintf(&pcOutData[n], "%s", psProperties->acNewLine);
+  n += DevelopFormatString(&pcOutData[n], psProperties->acNewLine);
 
   /*-
    *********************************************************************
@@ -1906,7 +2341,7 @@ DevelopCompressedOutput(void *pvProperties, char *pcOutData, int *iWriteCount, F
     if (lRecoveryCounter == 0)
     {
       ui64FileIndex = (((unsigned __int64) psFTFileData->dwFileIndexHigh) << 32) | psFTFileData->dwFileIndexLow;
-      n += sprintf(&pcOutData[n], "%I64x", (APP_UI64) ui64FileIndex);
+      n += DevelopFormatHex(&pcOutData[n], (APP_UI64) ui64FileIndex);
     }
     else
     {
@@ -1920,7 +2355,7 @@ DevelopCompressedOutput(void *pvProperties, char *pcOutData, int *iWriteCount, F
         else
         {
           ui64FileIndex = (((unsigned __int64) psFTFileData->dwFileIndexHigh) << 32) | psFTFileData->dwFileIndexLow;
-          n += sprintf(&pcOutData[n], "%I64x", (APP_UI64) ui64FileIndex);
+          n += DevelopFormatHex(&pcOutData[n], (APP_UI64) ui64FileIndex);
         }
       }
       else
@@ -2246,7 +2681,7 @@ DevelopCompressedOutput(void *pvProperties, char *pcOutData, int *iWriteCount, F
   {
     pcOutData[n++] = '|';
     ui64FileSize = (((unsigned __int64) psFTFileData->dwFileSizeHigh) << 32) | psFTFileData->dwFileSizeLow;
-    n += sprintf(&pcOutData[n], "%I64x", (APP_UI64) ui64FileSize);
+    n += DevelopFormatHex(&pcOutData[n], (APP_UI64) ui64FileSize);
   }
 
   /*-
@@ -2289,7 +2724,7 @@ DevelopCompressedOutput(void *pvProperties, char *pcOutData, int *iWriteCount, F
       {
         if (memcmp(psFTFileData->aucFileMd5, gaucMd5ZeroHash, MD5_HASH_SIZE) != 0)
         {
-          n += MD5HashToBase64(psFTFileData->aucFileMd5, &pcOutData[n]);
+          n += DevelopFormatBase64(&pcOutData[n], psFTFileData->aucFileMd5, MD5_HASH_SIZE);
         }
         else
         {
@@ -2306,7 +2741,7 @@ DevelopCompressedOutput(void *pvProperties, char *pcOutData, int *iWriteCount, F
     {
       if (memcmp(psFTFileData->aucFileMd5, gaucMd5ZeroHash, MD5_HASH_SIZE) != 0)
       {
-        n += MD5HashToBase64(psFTFileData->aucFileMd5, &pcOutData[n]);
+        n += DevelopFormatBase64(&pcOutData[n], psFTFileData->aucFileMd5, MD5_HASH_SIZE);
       }
       else
       {
@@ -2332,7 +2767,7 @@ DevelopCompressedOutput(void *pvProperties, char *pcOutData, int *iWriteCount, F
       {
         if (memcmp(psFTFileData->aucFileSha1, gaucSha1ZeroHash, SHA1_HASH_SIZE) != 0)
         {
-          n += SHA1HashToBase64(psFTFileData->aucFileSha1, &pcOutData[n]);
+          n += DevelopFormatBase64(&pcOutData[n], psFTFileData->aucFileSha1, SHA1_HASH_SIZE);
         }
         else
         {
@@ -2349,7 +2784,7 @@ DevelopCompressedOutput(void *pvProperties, char *pcOutData, int *iWriteCount, F
     {
       if (memcmp(psFTFileData->aucFileSha1, gaucSha1ZeroHash, SHA1_HASH_SIZE) != 0)
       {
-        n += SHA1HashToBase64(psFTFileData->aucFileSha1, &pcOutData[n]);
+        n += DevelopFormatBase64(&pcOutData[n], psFTFileData->aucFileSha1, SHA1_HASH_SIZE);
       }
       else
       {
@@ -2375,7 +2810,7 @@ DevelopCompressedOutput(void *pvProperties, char *pcOutData, int *iWriteCount, F
       {
         if (memcmp(psFTFileData->aucFileSha256, gaucSha256ZeroHash, SHA256_HASH_SIZE) != 0)
         {
-          n += SHA256HashToBase64(psFTFileData->aucFileSha256, &pcOutData[n]);
+          n += DevelopFormatBase64(&pcOutData[n], psFTFileData->aucFileSha256, SHA256_HASH_SIZE);
         }
         else
         {
@@ -2392,7 +2827,7 @@ DevelopCompressedOutput(void *pvProperties, char *pcOutData, int *iWriteCount, F
     {
       if (memcmp(psFTFileData->aucFileSha256, gaucSha256ZeroHash, SHA256_HASH_SIZE) != 0)
       {
-        n += SHA256HashToBase64(psFTFileData->aucFileSha256, &pcOutData[n]);
+        n += DevelopFormatBase64(&pcOutData[n], psFTFileData->aucFileSha256, SHA256_HASH_SIZE);
       }
       else
       {
@@ -2457,7 +2892,7 @@ DevelopCompressedOutput(void *pvProperties, char *pcOutData, int *iWriteCount, F
    *
    *********************************************************************
    */
-  n += sprintf(&pcOutData[n], "%s", psProperties->acNewLine);
+  n += DevelopFormatString(&pcOutData[n], psProperties->acNewLine);
 
   /*-
    *********************************************************************
@@ -2527,7 +2962,8 @@ DevelopCompressHex(char *pcData, unsigned long ulHex, unsigned long ulOldHex)
     iHexDigitDeltaCount = 1 + DevelopCountHexDigits(ulDelta);
     if (iHexDigitDeltaCount < iHexDigitCount)
     {
-      return sprintf(pcData, "+%lx", ulDelta);
+      pcData[0] = '+';
+      return 1 + DevelopFormatHex(&pcData[1], ulDelta);
     }
   }
   else
@@ -2536,11 +2972,12 @@ DevelopCompressHex(char *pcData, unsigned long ulHex, unsigned long ulOldHex)
     iHexDigitDeltaCount = 1 + DevelopCountHexDigits(ulDelta);
     if (iHexDigitDeltaCount < iHexDigitCount)
     {
-      return sprintf(pcData, "-%lx", ulDelta);
+      pcData[0] = '-';
+      return 1 + DevelopFormatHex(&pcData[1], ulDelta);
     }
   }
 
-  return sprintf(pcData, "%lx", ulHex);
+  return DevelopFormatHex(pcData, ulHex);
 }
 
 
@@ -2554,16 +2991,307 @@ DevelopCompressHex(char *pcData, unsigned long ulHex, unsigned long ulOldHex)
 int
 DevelopCountHexDigits(unsigned long ulHex)
 {
-  int                 i = 8;
+  int                 i = 1;
 
-  if (ulHex == 0)
+  /*-
+   *********************************************************************
+   *
+   * Shift right rather than left. Shifting left never terminates for
+   * a nonzero value whose low 32 bits are zero (e.g., a time stamp of
+   * 0x100000000) when longs are 64 bits wide.
+   *
+   *********************************************************************
+   */
+  while ((ulHex >>= 4) != 0)
   {
-    return 1;
+    i++;
   }
-  while ((ulHex & 0xf0000000) == 0)
+  return i;
+}
+
+
+/*-
+ ***********************************************************************
+ *
+ * DevelopFormatBase64
+ *
+ ***********************************************************************
+ */
+int
+DevelopFormatBase64(char *pcData, unsigned char *pucBytes, int iLength)
+{
+  int                 i = 0;
+  int                 n = 0;
+  unsigned long       ul = 0;
+
+  /*-
+   *********************************************************************
+   *
+   * Convert three bytes to four digits per pass. Any leftover bytes
+   * are zero-padded on the right, and no '=' characters are added.
+   * This matches the output of the various *HashToBase64 routines.
+   *
+   *********************************************************************
+   */
+  for (i = 0; i + 3 <= iLength; i += 3)
   {
-    ulHex <<= 4;
-    i--;
+    ul = ((unsigned long) pucBytes[i] << 16) | ((unsigned long) pucBytes[i + 1] << 8) | (unsigned long) pucBytes[i + 2];
+    pcData[n++] = gacBase64Digits[(ul >> 18) & 0x3f];
+    pcData[n++] = gacBase64Digits[(ul >> 12) & 0x3f];
+    pcData[n++] = gacBase64Digits[(ul >>  6) & 0x3f];
+    pcData[n++] = gacBase64Digits[ul & 0x3f];
   }
-  return i;
+  switch (iLength - i)
+  {
+  case 2:
+    ul = ((unsigned long) pucBytes[i] << 16) | ((unsigned long) pucBytes[i + 1] << 8);
+    pcData[n++] = gacBase64Digits[(ul >> 18) & 0x3f];
+    pcData[n++] = gacBase64Digits[(ul >> 12) & 0x3f];
+    pcData[n++] = gacBase64Digits[(ul >>  6) & 0x3f];
+    break;
+  case 1:
+    ul = (unsigned long) pucBytes[i] << 16;
+    pcData[n++] = gacBase64Digits[(ul >> 18) & 0x3f];
+    pcData[n++] = gacBase64Digits[(ul >> 12) & 0x3f];
+    break;
+  default:
+    break;
+  }
+
+  return n;
+}
+
+
+/*-
+ ***********************************************************************
+ *
+ * DevelopFormatDecimal
+ *
+ ***********************************************************************
+ */
+int
+DevelopFormatDecimal(char *pcData, APP_UI64 ui64Value)
+{
+  char                acDigits[DEVELOP_MAX_DIGITS];
+  int                 i = DEVELOP_MAX_DIGITS;
+  int                 iPair = 0;
+
+  /*-
+   *********************************************************************
+   *
+   * Emit two digits per division, working right to left, and then
+   * copy the result into place. This yields the same output as "%u"
+   * or "%llu", but without the overhead of parsing a format string.
+   *
+   *********************************************************************
+   */
+  while (ui64Value >= 100)
+  {
+    iPair = (int) (ui64Value % 100) * 2;
+    ui64Value /= 100;
+    acDigits[--i] = gacDecimalPairs[iPair + 1];
+    acDigits[--i] = gacDecimalPairs[iPair];
+  }
+  if (ui64Value >= 10)
+  {
+    iPair = (int) ui64Value * 2;
+    acDigits[--i] = gacDecimalPairs[iPair + 1];
+    acDigits[--i] = gacDecimalPairs[iPair];
+  }
+  else
+  {
+    acDigits[--i] = (char) ('0' + ui64Value);
+  }
+  memcpy(pcData, &acDigits[i], DEVELOP_MAX_DIGITS - i);
+
+  return DEVELOP_MAX_DIGITS - i;
+}
+
+
+/*-
+ ***********************************************************************
+ *
+ * DevelopFormatHex
+ *
+ ***********************************************************************
+ */
+int
+DevelopFormatHex(char *pcData, APP_UI64 ui64Value)
+{
+  char                acDigits[DEVELOP_MAX_DIGITS];
+  int                 i = DEVELOP_MAX_DIGITS;
+
+  /*-
+   *********************************************************************
+   *
+   * This yields the same output as "%x", "%lx", or "%llx" (i.e., lower
+   * case digits with no leading zeros).
+   *
+   *********************************************************************
+   */
+  do
+  {
+    acDigits[--i] = gacHexDigits[ui64Value & 0xf];
+    ui64Value >>= 4;
+  } while (ui64Value != 0);
+  memcpy(pcData, &acDigits[i], DEVELOP_MAX_DIGITS - i);
+
+  return DEVELOP_MAX_DIGITS - i;
+}
+
+
+/*-
+ ***********************************************************************
+ *
+ * DevelopFormatHexBytes
+ *
+ ***********************************************************************
+ */
+int
+DevelopFormatHexBytes(char *pcData, unsigned char *pucBytes, int iLength)
+{
+  int                 i = 0;
+  int                 n = 0;
+
+  /*-
+   *********************************************************************
+   *
+   * This matches the output of the various *HashToHex routines.
+   *
+   *********************************************************************
+   */
+  for (i = 0; i < iLength; i++)
+  {
+    pcData[n++] = gacHexPairs[pucBytes[i] * 2];
+    pcData[n++] = gacHexPairs[pucBytes[i] * 2 + 1];
+  }
+
+  return n;
 }
+
+
+/*-
+ ***********************************************************************
+ *
+ * DevelopFormatOctal
+ *
+ ***********************************************************************
+ */
+int
+DevelopFormatOctal(char *pcData, APP_UI64 ui64Value)
+{
+  char                acDigits[DEVELOP_MAX_DIGITS];
+  int                 i = DEVELOP_MAX_DIGITS;
+
+  do
+  {
+    acDigits[--i] = (char) ('0' + (ui64Value & 0x7));
+    ui64Value >>= 3;
+  } while (ui64Value != 0);
+  memcpy(pcData, &acDigits[i], DEVELOP_MAX_DIGITS - i);
+
+  return DEVELOP_MAX_DIGITS - i;
+}
+
+
+/*-
+ ***********************************************************************
+ *
+ * DevelopFormatString
+ *
+ ***********************************************************************
+ */
+int
+DevelopFormatString(char *pcData, char *pcString)
+{
+  int                 iLength = strlen(pcString);
+
+  memcpy(pcData, pcString, iLength + 1);
+
+  return iLength;
+}
+
+
+#ifdef UNIX
+/*-
+ ***********************************************************************
+ *
+ * DevelopFormatTime
+ *
+ ***********************************************************************
+ */
+int
+DevelopFormatTime(time_t *pTimeValue, char *pcTime)
+{
+  int                 iError = 0;
+  int                 iSeconds = 0;
+  time_t              tDay = 0;
+
+  /*-
+   *********************************************************************
+   *
+   * Time stamps are relative to GMT, so every day is exactly 86400
+   * seconds long, and files in a given tree tend to share the same
+   * few days. Thus, the date portion of the last day formatted is
+   * cached, and the time portion is computed directly. On a miss,
+   * TimeFormatTime is used to do the work and to prime the cache.
+   *
+   *********************************************************************
+   */
+  tDay = *pTimeValue / DEVELOP_SECONDS_PER_DAY;
+  iSeconds = (int) (*pTimeValue % DEVELOP_SECONDS_PER_DAY);
+  if (iSeconds < 0)
+  {
+    iSeconds += DEVELOP_SECONDS_PER_DAY;
+    tDay--;
+  }
+
+  if (!giTimeDayCached || tDay != gtTimeDay)
+  {
+    iError = TimeFormatTime(pTimeValue, pcTime);
+    if (iError != ER_OK)
+    {
+      return iError;
+    }
+    memcpy(gacTimeDay, pcTime, DEVELOP_TIME_DAY_LENGTH);
+    gtTimeDay = tDay;
+    giTimeDayCached = 1;
+    return ER_OK;
+  }
+
+  memcpy(pcTime, gacTimeDay, DEVELOP_TIME_DAY_LENGTH);
+  memcpy(&pcTime[11], &gacDecimalPairs[(iSeconds / 3600) * 2], 2);
+  pcTime[13] = ':';
+  memcpy(&pcTime[14], &gacDecimalPairs[((iSeconds / 60) % 60) * 2], 2);
+  pcTime[16] = ':';
+  memcpy(&pcTime[17], &gacDecimalPairs[(iSeconds % 60) * 2], 2);
+  pcTime[19] = 0;
+
+  return ER_OK;
+}
+#endif
+
+
+#ifdef UNIX
+/*-
+ ***********************************************************************
+ *
+ * DevelopPutVarint
+ *
+ ***********************************************************************
+ */
+int
+DevelopPutVarint(unsigned char *pucData, APP_UI64 ui64Value)
+{
+  int                 n = 0;
+
+  while (ui64Value >= 0x80)
+  {
+    pucData[n++] = (unsigned char) ((ui64Value & 0x7f) | 0x80);
+    ui64Value >>= 7;
+  }
+  pucData[n++] = (unsigned char) ui64Value;
+
+  return n;
+}
+#endif
@@ -236,6 +236,17 @@ DigModeCheckDependencies(void *pvProperties, char *pcError)
       return ER_MissingControl;
     }
 
+#ifdef USE_ZLIB
+    if (psProperties->iOutputCompression != FTIMES_OUTPUT_COMPRESSION_NONE)
+    {
+      if (psProperties->bURLPutSnapshot)
+      {
+        snprintf(pcError, MESSAGE_SIZE, "%s: Compressed output can not be uploaded. Either disable URLPutSnapshot or set OutputCompression to none.", acRoutine);
+        return ER;
+      }
+    }
+#endif
+
 #ifdef USE_SSL
     if (SSLCheckDependencies(psProperties->psSslProperties, acLocalError) != ER_OK)
     {
@@ -262,6 +273,9 @@ DigModeFinalize(void *pvProperties, char *pcError)
   const char          acRoutine[] = "DigModeFinalize()";
   char                acLocalError[MESSAGE_SIZE] = "";
   FTIMES_PROPERTIES  *psProperties = (FTIMES_PROPERTIES *)pvProperties;
+#if defined(USE_ZLIB) || defined(USE_URL_STREAM)
+  FILE               *pFile;
+#endif
   int                 iError;
 
   /*-
@@ -415,6 +429,34 @@ DigModeFinalize(void *pvProperties, char *pcError)
   }
 #endif
 
+#ifdef USE_PCRE
+  /*-
+   *********************************************************************
+   *
+   * Combine path filters into as few expressions as possible.
+   *
+   *********************************************************************
+   */
+  if (psProperties->psExcludeFilterList != NULL)
+  {
+    psProperties->psExcludeFilterUnion = SupportNewFilterUnion(psProperties->psExcludeFilterList, acLocalError);
+    if (psProperties->psExcludeFilterUnion == NULL)
+    {
+      snprintf(pcError, MESSAGE_SIZE, "%s: %s", acRoutine, acLocalError);
+      return ER;
+    }
+  }
+  if (psProperties->psIncludeFilterList != NULL)
+  {
+    psProperties->psIncludeFilterUnion = SupportNewFilterUnion(psProperties->psIncludeFilterList, acLocalError);
+    if (psProperties->psIncludeFilterUnion == NULL)
+    {
+      snprintf(pcError, MESSAGE_SIZE, "%s: %s", acRoutine, acLocalError);
+      return ER;
+    }
+  }
+#endif
+
   /*-
    *********************************************************************
    *
@@ -480,7 +522,11 @@ DigModeFinalize(void *pvProperties, char *pcError)
    */
   if (psProperties->iRunMode == FTIMES_DIGMODE && strcmp(psProperties->acBaseName, "-") != 0)
   {
+#ifdef USE_ZLIB
+    iError = SupportMakeName(psProperties->acOutDirName, psProperties->acBaseName, psProperties->acBaseNameSuffix, (psProperties->iOutputCompression == FTIMES_OUTPUT_COMPRESSION_GZIP) ? ".dig.gz" : ".dig", psProperties->acOutFileName, acLocalError);
+#else
     iError = SupportMakeName(psProperties->acOutDirName, psProperties->acBaseName, psProperties->acBaseNameSuffix, ".dig", psProperties->acOutFileName, acLocalError);
+#endif
     if (iError != ER_OK)
     {
       snprintf(pcError, MESSAGE_SIZE, "%s: Out File: %s", acRoutine, acLocalError);
@@ -494,28 +540,37 @@ DigModeFinalize(void *pvProperties, char *pcError)
       return iError;
     }
 
-    psProperties->pFileOut = fopen(psProperties->acOutFileName, "wb+");
-    if (psProperties->pFileOut == NULL)
+#ifdef USE_URL_STREAM
+    if (psProperties->bURLPutSnapshot && psProperties->bURLPutStream && psProperties->bURLUnlinkOutput)
     {
-      snprintf(pcError, MESSAGE_SIZE, "%s: OutFile = [%s]: %s", acRoutine, psProperties->acOutFileName, strerror(errno));
-      return ER_fopen;
+      psProperties->pFileOut = NULL; /* The output is streamed, but not kept. */
     }
+    else
+#endif
+    {
+      psProperties->pFileOut = fopen(psProperties->acOutFileName, "wb+");
+      if (psProperties->pFileOut == NULL)
+      {
+        snprintf(pcError, MESSAGE_SIZE, "%s: OutFile = [%s]: %s", acRoutine, psProperties->acOutFileName, strerror(errno));
+        return ER_fopen;
+      }
 /* FIXME Remove this #ifdef at some point in the future. */
 #ifdef WIN32
-    /*-
-     *****************************************************************
-     *
-     * NOTE: The buffer size was explicitly set to prevent binaries
-     * made with Visual Studio 2005 (no service packs) from crashing
-     * when run in lean mode. This problem may have been fixed in
-     * Service Pack 1.
-     *
-     *****************************************************************
-     */
-    setvbuf(psProperties->pFileOut, NULL, _IOLBF, 1024);
+      /*-
+       *****************************************************************
+       *
+       * NOTE: The buffer size was explicitly set to prevent binaries
+       * made with Visual Studio 2005 (no service packs) from crashing
+       * when run in lean mode. This problem may have been fixed in
+       * Service Pack 1.
+       *
+       *****************************************************************
+       */
+      setvbuf(psProperties->pFileOut, NULL, _IOLBF, 1024);
 #else
-    setvbuf(psProperties->pFileOut, NULL, _IOLBF, 0);
+      setvbuf(psProperties->pFileOut, NULL, _IOLBF, 0);
 #endif
+    }
   }
   else
   {
@@ -523,6 +578,64 @@ DigModeFinalize(void *pvProperties, char *pcError)
     psProperties->pFileOut = stdout;
   }
 
+#ifdef USE_URL_STREAM
+  /*-
+   *********************************************************************
+   *
+   * Route the Out file stream to the server as it's written, if
+   * requested. The local copy, if any, is written through the stream.
+   *
+   *********************************************************************
+   */
+  if (psProperties->bURLPutSnapshot && psProperties->bURLPutStream && psProperties->iRunMode == FTIMES_DIGMODE)
+  {
+    pFile = URLNewStream(psProperties, psProperties->pFileOut, acLocalError);
+    if (pFile == NULL)
+    {
+      snprintf(pcError, MESSAGE_SIZE, "%s: OutFile = [%s]: %s", acRoutine, psProperties->acOutFileName, acLocalError);
+      return ER;
+    }
+    setvbuf(pFile, NULL, _IOLBF, 0);
+    psProperties->pFileOut = pFile;
+  }
+#endif
+
+#ifdef USE_ZLIB
+  /*-
+   *********************************************************************
+   *
+   * Route the Out file stream through the compressor, if requested.
+   * The OutFileHash is computed over the uncompressed data.
+   *
+   *********************************************************************
+   */
+  if (psProperties->iOutputCompression == FTIMES_OUTPUT_COMPRESSION_GZIP)
+  {
+    pFile = GzipNewWriteStream(psProperties->pFileOut, psProperties->iOutputCompressLevel, acLocalError);
+    if (pFile == NULL)
+    {
+      snprintf(pcError, MESSAGE_SIZE, "%s: OutFile = [%s]: %s", acRoutine, psProperties->acOutFileName, acLocalError);
+      return ER;
+    }
+    psProperties->pFileOut = pFile;
+  }
+#endif
+
+  /*-
+   *********************************************************************
+   *
+   * Compile the Exclude list into a trie. This must be done after the
+   * log and out files have been added to the list.
+   *
+   *********************************************************************
+   */
+  psProperties->psExcludeTrie = SupportNewTrie(psProperties->psExcludeList, acLocalError);
+  if (psProperties->psExcludeTrie == NULL)
+  {
+    snprintf(pcError, MESSAGE_SIZE, "%s: %s", acRoutine, acLocalError);
+    return ER;
+  }
+
   /*-
    *********************************************************************
    *
@@ -573,12 +686,24 @@ DigModeWorkHorse(void *pvProperties, char *pcError)
    */
   for (psList = psProperties->psIncludeList; psList != NULL; psList = psList->psNext)
   {
-    if (SupportMatchExclude(psProperties->psExcludeList, psList->pcRegularPath) == NULL)
+    if (SupportMatchTrie(psProperties->psExcludeTrie, psList->pcRegularPath) == NULL)
     {
       MapFile(psProperties, psList->pcRegularPath, acLocalError);
     }
   }
 
+#ifdef USE_FILE_HOOKS
+  /*-
+   *********************************************************************
+   *
+   * Wait for any hooks that are still running, and then shut down
+   * the hook workers.
+   *
+   *********************************************************************
+   */
+  MapStopHookWorkers(psProperties);
+#endif
+
   return ER_OK;
 }
 
@@ -593,6 +718,7 @@ DigModeWorkHorse(void *pvProperties, char *pcError)
 int
 DigModeFinishUp(void *pvProperties, char *pcError)
 {
+  const char          acRoutine[] = "DigModeFinishUp()";
   char                acMessage[MESSAGE_SIZE];
   FTIMES_PROPERTIES  *psProperties = (FTIMES_PROPERTIES *)pvProperties;
   int                 i;
@@ -610,7 +736,11 @@ DigModeFinishUp(void *pvProperties, char *pcError)
   if (psProperties->pFileOut && psProperties->pFileOut != stdout)
   {
     fflush(psProperties->pFileOut);
-    fclose(psProperties->pFileOut);
+    if (fclose(psProperties->pFileOut) != 0)
+    {
+      snprintf(acMessage, MESSAGE_SIZE, "%s: OutFile = [%s]: %s", acRoutine, psProperties->acOutFileName, strerror(errno));
+      ErrorHandler(ER_Failure, acMessage, ERROR_FAILURE);
+    }
     psProperties->pFileOut = NULL;
   }
 
@@ -763,7 +893,31 @@ DigModeFinalStage(void *pvProperties, char *pcError)
    */
   if (psProperties->bURLPutSnapshot && psProperties->iRunMode == FTIMES_DIGMODE)
   {
+#ifdef USE_URL_STREAM
+    if (psProperties->bURLPutStream)
+    {
+      iError = URLFinishStream(psProperties, acLocalError);
+      if (iError != ER_OK && !psProperties->bURLUnlinkOutput)
+      {
+        /*-
+         ***************************************************************
+         *
+         * A local copy exists, so fall back to a regular upload.
+         *
+         ***************************************************************
+         */
+        snprintf(pcError, MESSAGE_SIZE, "%s: %s: Retrying with a regular upload.", acRoutine, acLocalError);
+        ErrorHandler(ER_Warning, pcError, ERROR_WARNING);
+        iError = URLPutRequest(psProperties, acLocalError);
+      }
+    }
+    else
+    {
+      iError = URLPutRequest(psProperties, acLocalError);
+    }
+#else
     iError = URLPutRequest(psProperties, acLocalError);
+#endif
     if (iError != ER_OK)
     {
       snprintf(pcError, MESSAGE_SIZE, "%s: %s", acRoutine, acLocalError);
@@ -11,6 +11,111 @@
  */
 #include "all-includes.h"
 
+/*-
+ ***********************************************************************
+ *
+ * Filter variables. This table must remain sorted by name since it is
+ * searched with bsearch(). Each variable is bound to an ID, which lets
+ * FilterGetValueOfVar() go straight to the corresponding field.
+ *
+ ***********************************************************************
+ */
+static FILTER_TYPE_SPEC gasFilterVars[] =
+{
+#ifdef WIN32
+  { "f_altstreams",                      KLEL_TYPE_INT64,   FILTER_VAR_ALTSTREAMS                     }, /* file altstreams */
+#endif
+  { "f_atime",                           KLEL_TYPE_INT64,   FILTER_VAR_ATIME                          }, /* file atime */
+#ifdef WIN32
+  { "f_attributes",                      KLEL_TYPE_INT64,   FILTER_VAR_ATTRIBUTES                     }, /* file attributes */
+  { "f_attributes_archive",              KLEL_TYPE_BOOLEAN, FILTER_VAR_ATTRIBUTES_ARCHIVE             }, /* file attributes: archive */
+  { "f_attributes_compressed",           KLEL_TYPE_BOOLEAN, FILTER_VAR_ATTRIBUTES_COMPRESSED          }, /* file attributes: compressed */
+  { "f_attributes_device",               KLEL_TYPE_BOOLEAN, FILTER_VAR_ATTRIBUTES_DEVICE              }, /* file attributes: device */
+  { "f_attributes_directory",            KLEL_TYPE_BOOLEAN, FILTER_VAR_ATTRIBUTES_DIRECTORY           }, /* file attributes: directory */
+  { "f_attributes_encrypted",            KLEL_TYPE_BOOLEAN, FILTER_VAR_ATTRIBUTES_ENCRYPTED           }, /* file attributes: encryptedj */
+  { "f_attributes_hidden",               KLEL_TYPE_BOOLEAN, FILTER_VAR_ATTRIBUTES_HIDDEN              }, /* file attributes: hidden */
+  { "f_attributes_normal",               KLEL_TYPE_BOOLEAN, FILTER_VAR_ATTRIBUTES_NORMAL              }, /* file attributes: normal */
+  { "f_attributes_not_content_indexed",  KLEL_TYPE_BOOLEAN, FILTER_VAR_ATTRIBUTES_NOT_CONTENT_INDEXED }, /* file attributes: not content indexed */
+  { "f_attributes_offline",              KLEL_TYPE_BOOLEAN, FILTER_VAR_ATTRIBUTES_OFFLINE             }, /* file attributes: offline */
+  { "f_attributes_read_only",            KLEL_TYPE_BOOLEAN, FILTER_VAR_ATTRIBUTES_READ_ONLY           }, /* file attributes: read only */
+  { "f_attributes_reparse_point",        KLEL_TYPE_BOOLEAN, FILTER_VAR_ATTRIBUTES_REPARSE_POINT       }, /* file attributes: reparse point */
+  { "f_attributes_sparse_file",          KLEL_TYPE_BOOLEAN, FILTER_VAR_ATTRIBUTES_SPARSE_FILE         }, /* file attributes: sparse */
+  { "f_attributes_system",               KLEL_TYPE_BOOLEAN, FILTER_VAR_ATTRIBUTES_SYSTEM              }, /* file attributes: system */
+  { "f_attributes_temporary",            KLEL_TYPE_BOOLEAN, FILTER_VAR_ATTRIBUTES_TEMPORARY           }, /* file attributes: temporary */
+  { "f_attributes_unknown_1",            KLEL_TYPE_BOOLEAN, FILTER_VAR_ATTRIBUTES_UNKNOWN_1           }, /* file attributes: undocumented */
+  { "f_attributes_unknown_2",            KLEL_TYPE_BOOLEAN, FILTER_VAR_ATTRIBUTES_UNKNOWN_2           }, /* file attributes: undocumented */
+  { "f_attributes_virtual",              KLEL_TYPE_BOOLEAN, FILTER_VAR_ATTRIBUTES_VIRTUAL             }, /* file attributes: virtual */
+  { "f_chtime",                          KLEL_TYPE_INT64,   FILTER_VAR_CHTIME                         }, /* file chtime */
+#endif
+  { "f_ctime",                           KLEL_TYPE_INT64,   FILTER_VAR_CTIME                          }, /* file ctime */
+#ifdef WIN32
+  { "f_dacl",                            KLEL_TYPE_STRING,  FILTER_VAR_DACL                           }, /* file dacl */
+#endif
+#ifndef WIN32
+  { "f_dev",                             KLEL_TYPE_INT64,   FILTER_VAR_DEV                            }, /* file dev */
+#endif
+  { "f_exists",                          KLEL_TYPE_BOOLEAN, FILTER_VAR_EXISTS                         }, /* file exists */
+#ifdef WIN32
+  { "f_findex",                          KLEL_TYPE_INT64,   FILTER_VAR_FINDEX                         }, /* file findex */
+#endif
+#ifndef WIN32
+  { "f_fstype",                          KLEL_TYPE_STRING,  FILTER_VAR_FSTYPE                         }, /* file system type */
+  { "f_gid",                             KLEL_TYPE_INT64,   FILTER_VAR_GID                            }, /* file group ID */
+#endif
+#ifdef WIN32
+  { "f_gsid",                            KLEL_TYPE_STRING,  FILTER_VAR_GSID                           }, /* file group SID */
+#endif
+#ifndef WIN32
+  { "f_inode",                           KLEL_TYPE_INT64,   FILTER_VAR_INODE                          }, /* file inode */
+#endif
+  { "f_magic",                           KLEL_TYPE_STRING,  FILTER_VAR_MAGIC                          }, /* file type (XMagic) */
+  { "f_md5",                             KLEL_TYPE_STRING,  FILTER_VAR_MD5                            }, /* file hash (MD5) */
+#ifndef WIN32
+  { "f_mode",                            KLEL_TYPE_INT64,   FILTER_VAR_MODE                           }, /* file mode */
+  { "f_mode_gr",                         KLEL_TYPE_BOOLEAN, FILTER_VAR_MODE_GR                        }, /* file mode permission: group read */
+  { "f_mode_gw",                         KLEL_TYPE_BOOLEAN, FILTER_VAR_MODE_GW                        }, /* file mode permission: group write */
+  { "f_mode_gx",                         KLEL_TYPE_BOOLEAN, FILTER_VAR_MODE_GX                        }, /* file mode permission: group execute */
+  { "f_mode_or",                         KLEL_TYPE_BOOLEAN, FILTER_VAR_MODE_OR                        }, /* file mode permission: other read */
+  { "f_mode_ow",                         KLEL_TYPE_BOOLEAN, FILTER_VAR_MODE_OW                        }, /* file mode permission: other write */
+  { "f_mode_ox",                         KLEL_TYPE_BOOLEAN, FILTER_VAR_MODE_OX                        }, /* file mode permission: other execute */
+  { "f_mode_sg",                         KLEL_TYPE_BOOLEAN, FILTER_VAR_MODE_SG                        }, /* file mode SGID (set group id on execution) bit */
+  { "f_mode_st",                         KLEL_TYPE_BOOLEAN, FILTER_VAR_MODE_ST                        }, /* file mode sticky bit */
+  { "f_mode_su",                         KLEL_TYPE_BOOLEAN, FILTER_VAR_MODE_SU                        }, /* file mode SUID (set user id on execution) bit */
+  { "f_mode_tb",                         KLEL_TYPE_BOOLEAN, FILTER_VAR_MODE_TB                        }, /* file mode type: block special */
+  { "f_mode_tc",                         KLEL_TYPE_BOOLEAN, FILTER_VAR_MODE_TC                        }, /* file mode type: character special */
+  { "f_mode_td",                         KLEL_TYPE_BOOLEAN, FILTER_VAR_MODE_TD                        }, /* file mode type: directory */
+  { "f_mode_tl",                         KLEL_TYPE_BOOLEAN, FILTER_VAR_MODE_TL                        }, /* file mode type: symbolic link */
+  { "f_mode_tp",                         KLEL_TYPE_BOOLEAN, FILTER_VAR_MODE_TP                        }, /* file mode type: named pipe (fifo) */
+  { "f_mode_tr",                         KLEL_TYPE_BOOLEAN, FILTER_VAR_MODE_TR                        }, /* file mode type: regular file */
+  { "f_mode_ts",                         KLEL_TYPE_BOOLEAN, FILTER_VAR_MODE_TS                        }, /* file mode type: socket */
+  { "f_mode_tw",                         KLEL_TYPE_BOOLEAN, FILTER_VAR_MODE_TW                        }, /* file mode type: whiteout */
+  { "f_mode_ur",                         KLEL_TYPE_BOOLEAN, FILTER_VAR_MODE_UR                        }, /* file mode permission: user read */
+  { "f_mode_uw",                         KLEL_TYPE_BOOLEAN, FILTER_VAR_MODE_UW                        }, /* file mode permission: user write */
+  { "f_mode_ux",                         KLEL_TYPE_BOOLEAN, FILTER_VAR_MODE_UX                        }, /* file mode permission: user execute */
+#endif
+  { "f_mtime",                           KLEL_TYPE_INT64,   FILTER_VAR_MTIME                          }, /* file mtime */
+  { "f_name",                            KLEL_TYPE_STRING,  FILTER_VAR_NAME                           }, /* file name (full path) */
+#ifndef WIN32
+  { "f_nlink",                           KLEL_TYPE_INT64,   FILTER_VAR_NLINK                          }, /* file nlink */
+#endif
+#ifdef WIN32
+  { "f_osid",                            KLEL_TYPE_STRING,  FILTER_VAR_OSID                           }, /* file owner SID */
+#endif
+#ifndef WIN32
+  { "f_rdev",                            KLEL_TYPE_INT64,   FILTER_VAR_RDEV                           }, /* file rdev */
+#endif
+  { "f_sha1",                            KLEL_TYPE_STRING,  FILTER_VAR_SHA1                           }, /* file hash (SHA1) */
+  { "f_sha256",                          KLEL_TYPE_STRING,  FILTER_VAR_SHA256                         }, /* file hash (SHA256) */
+  { "f_size",                            KLEL_TYPE_INT64,   FILTER_VAR_SIZE                           }, /* file size */
+#ifndef WIN32
+  { "f_uid",                             KLEL_TYPE_INT64,   FILTER_VAR_UID                            }, /* file user ID */
+#endif
+#ifdef WIN32
+  { "f_volume",                          KLEL_TYPE_INT64,   FILTER_VAR_VOLUME                         }, /* file volume ID */
+#endif
+};
+
+
 /*-
  ***********************************************************************
  *
@@ -24,6 +129,64 @@ FilterApplyFilters(FTIMES_PROPERTIES *psProperties, FTIMES_FILE_DATA *psFTFileDa
   char                acMessage[MESSAGE_SIZE] = "";
   FILTER_LIST_KLEL   *psFilter = NULL;
   int                 iDataFilterCount = 0;
+  int                 iFilterSince = 0;
+  int                 iIncludeSets = 0;
+#ifdef USE_PCRE
+  char                acHexDigest[SHA256_HASH_SIZE * 2 + 1] = "";
+  char               *pcControl = NULL;
+#endif
+
+  /*-
+   *********************************************************************
+   *
+   * Record the filter point. Filters whose type is not greater than
+   * the last filter point have already been evaluated for this file,
+   * and their outcome can't change, so there's no need to run them
+   * again.
+   *
+   *********************************************************************
+   */
+  iFilterSince = psFTFileData->iFilterStage;
+  if (iFilterWhen > psFTFileData->iFilterStage)
+  {
+    psFTFileData->iFilterStage = iFilterWhen;
+  }
+
+  /*-
+   *********************************************************************
+   *
+   * Hash filters come in two kinds. Expressions were converted to KLEL
+   * filters when they were added (see SupportAddFilter()), so they are
+   * evaluated along with the rest of the KLEL lists. Literal digests
+   * are kept in digest sets instead (see SupportAddDigestFilter()), so
+   * they are checked here. This way, both kinds apply, just as they do
+   * in builds that use SupportApplyFiltersForHashes(). Sets only apply
+   * once file data have been processed.
+   *
+   *********************************************************************
+   */
+#ifdef USE_PCRE
+  iIncludeSets =
+    (
+      psProperties->psIncludeFilterMd5Set != NULL ||
+      psProperties->psIncludeFilterSha1Set != NULL ||
+      psProperties->psIncludeFilterSha256Set != NULL
+    ) ? 1 : 0;
+  if (iFilterWhen == FTIMES_FILTER_POST_DATA)
+  {
+    pcControl = SupportMatchDigestSets(psProperties, psFTFileData, 0, acHexDigest);
+    if (pcControl != NULL)
+    {
+      if (psProperties->iLogLevel <= MESSAGE_DEBUGGER)
+      {
+        snprintf(acMessage, MESSAGE_SIZE, "%s=[%s], RawPath=[%s]", pcControl, acHexDigest, psFTFileData->pcRawPath);
+        MessageHandler(MESSAGE_FLUSH_IT, MESSAGE_DEBUGGER, MESSAGE_DEBUGGER_STRING, acMessage);
+      }
+      psFTFileData->iFiltered = iFilterWhen;
+      return;
+    }
+  }
+#endif
 
   /*-
    *********************************************************************
@@ -35,12 +198,12 @@ FilterApplyFilters(FTIMES_PROPERTIES *psProperties, FTIMES_FILE_DATA *psFTFileDa
    */
   if (psProperties->psExcludeFilterListKlel)
   {
-    psFilter = FilterMatchFilter(psProperties->psExcludeFilterListKlel, psFTFileData, iFilterWhen);
+    psFilter = FilterMatchFilter(psProperties->psExcludeFilterListKlel, psFTFileData, iFilterSince, iFilterWhen);
     if (psFilter != NULL)
     {
       if (psProperties->iLogLevel <= MESSAGE_DEBUGGER)
       {
-        snprintf(acMessage, MESSAGE_SIZE, "ExcludeFilter=[%s] RawPath=[%s]", psFilter->pcExpression, psFTFileData->pcRawPath);
+        snprintf(acMessage, MESSAGE_SIZE, "ExcludeFilter=[%s], RawPath=[%s]", psFilter->pcExpression, psFTFileData->pcRawPath);
         MessageHandler(MESSAGE_FLUSH_IT, MESSAGE_DEBUGGER, MESSAGE_DEBUGGER_STRING, acMessage);
       }
       psFTFileData->iFiltered = iFilterWhen;
@@ -61,9 +224,29 @@ FilterApplyFilters(FTIMES_PROPERTIES *psProperties, FTIMES_FILE_DATA *psFTFileDa
    *
    *********************************************************************
    */
-  if (psProperties->psIncludeFilterListKlel)
+  if (psProperties->psIncludeFilterListKlel || iIncludeSets)
   {
-    psFilter = FilterMatchFilter(psProperties->psIncludeFilterListKlel, psFTFileData, iFilterWhen);
+    if (iFilterSince != 0 && psFTFileData->iFiltered == 0)
+    {
+      return; /* This object matched an include filter at an earlier filter point. */
+    }
+#ifdef USE_PCRE
+    if (iFilterWhen == FTIMES_FILTER_POST_DATA)
+    {
+      pcControl = SupportMatchDigestSets(psProperties, psFTFileData, 1, acHexDigest);
+      if (pcControl != NULL)
+      {
+        if (psProperties->iLogLevel <= MESSAGE_DEBUGGER)
+        {
+          snprintf(acMessage, MESSAGE_SIZE, "%s=[%s], RawPath=[%s]", pcControl, acHexDigest, psFTFileData->pcRawPath);
+          MessageHandler(MESSAGE_FLUSH_IT, MESSAGE_DEBUGGER, MESSAGE_DEBUGGER_STRING, acMessage);
+        }
+        psFTFileData->iFiltered = 0;
+        return;
+      }
+    }
+#endif
+    psFilter = FilterMatchFilter(psProperties->psIncludeFilterListKlel, psFTFileData, iFilterSince, iFilterWhen);
     if (psFilter != NULL)
     {
       if (psProperties->iLogLevel <= MESSAGE_DEBUGGER)
@@ -83,7 +266,7 @@ FilterApplyFilters(FTIMES_PROPERTIES *psProperties, FTIMES_FILE_DATA *psFTFileDa
         break;
       case FTIMES_FILTER_POST_ATTR:
         psFTFileData->iFiltered = FTIMES_FILTER_POST_ATTR; /* No deferment needed. */
-        iDataFilterCount = FilterGetFilterCount(psProperties->psIncludeFilterListKlel, FTIMES_FILTER_POST_DATA);
+        iDataFilterCount = FilterGetFilterCount(psProperties->psIncludeFilterListKlel, FTIMES_FILTER_POST_DATA) + iIncludeSets;
         if (iDataFilterCount > 0)
         {
           psFTFileData->iFiltered = FTIMES_FILTER_POST_DATA; /* Defer until the last filter point. */
@@ -147,33 +330,47 @@ FilterAddFilter(char *pcExpression, FILTER_LIST_KLEL **psHead, char *pcError)
   /*-
    *********************************************************************
    *
-   * If the head is NULL, insert the new filter and return. Otherwise,
-   * append each new/unique filter to the end of the list. Each filter
-   * is assigned an ID, which is a checksum of the compiled expression.
+   * Discard the new filter if it's a duplicate. Each filter is assigned
+   * an ID, which is a checksum of the compiled expression.
+   *
+   *********************************************************************
+   */
+  for (psCurrent = *psHead; psCurrent != NULL; psCurrent = psCurrent->psNext)
+  {
+    if (psFilter->uiId == psCurrent->uiId)
+    {
+      FilterFreeFilter(psFilter);
+      return ER_OK;
+    }
+  }
+
+  /*-
+   *********************************************************************
+   *
+   * Insert the new filter after the last filter of the same or lesser
+   * type. This keeps the list ordered from cheapest to most expensive
+   * (i.e., name, then attributes, then data), which is the order that
+   * FilterMatchFilter() relies on. Filters of the same type retain the
+   * order in which they were added.
    *
    *********************************************************************
    */
-  if (*psHead == NULL)
+  if (*psHead == NULL || (*psHead)->iType > psFilter->iType)
   {
+    psFilter->psNext = *psHead;
     *psHead = psFilter;
   }
   else
   {
-    psCurrent = *psHead;
-    while (psCurrent != NULL)
+    for (psCurrent = *psHead; psCurrent->psNext != NULL; psCurrent = psCurrent->psNext)
     {
-      if (psFilter->uiId == psCurrent->uiId)
-      {
-        FilterFreeFilter(psFilter);
-        return ER_OK;
-      }
-      if (psCurrent->psNext == NULL)
+      if (psCurrent->psNext->iType > psFilter->iType)
       {
-        psCurrent->psNext = psFilter;
         break;
       }
-      psCurrent = psCurrent->psNext;
     }
+    psFilter->psNext = psCurrent->psNext;
+    psCurrent->psNext = psFilter;
   }
 
   return ER_OK;
@@ -291,6 +488,20 @@ FilterClassifyFilter(FILTER_LIST_KLEL *psFilter, char *pcError)
 }
 
 
+/*-
+ ***********************************************************************
+ *
+ * FilterCompareVarSpecs
+ *
+ ***********************************************************************
+ */
+int
+FilterCompareVarSpecs(const void *pvKey, const void *pvVarSpec)
+{
+  return strcmp((const char *)pvKey, ((const FILTER_TYPE_SPEC *)pvVarSpec)->pcName);
+}
+
+
 /*-
  ***********************************************************************
  *
@@ -687,108 +898,12 @@ FilterGetFilterCount(FILTER_LIST_KLEL *psFilterList, int iType)
 KLEL_EXPR_TYPE
 FilterGetTypeOfVar(const char *pcName, void *pvContext)
 {
-  int                 i = 0;
-  FILTER_TYPE_SPEC    asTypes[] =
-  {
-#ifdef WIN32
-    { "f_altstreams",                     KLEL_TYPE_INT64   }, /* file altstreams */
-#endif
-    { "f_atime",                          KLEL_TYPE_INT64   }, /* file atime */
-#ifdef WIN32
-    { "f_attributes",                     KLEL_TYPE_INT64   }, /* file attributes */
-    { "f_attributes_archive",             KLEL_TYPE_BOOLEAN }, /* file attributes: archive */
-    { "f_attributes_compressed",          KLEL_TYPE_BOOLEAN }, /* file attributes: compressed */
-    { "f_attributes_device",              KLEL_TYPE_BOOLEAN }, /* file attributes: device */
-    { "f_attributes_directory",           KLEL_TYPE_BOOLEAN }, /* file attributes: directory */
-    { "f_attributes_encrypted",           KLEL_TYPE_BOOLEAN }, /* file attributes: encryptedj */
-    { "f_attributes_hidden",              KLEL_TYPE_BOOLEAN }, /* file attributes: hidden */
-    { "f_attributes_normal",              KLEL_TYPE_BOOLEAN }, /* file attributes: normal */
-    { "f_attributes_not_content_indexed", KLEL_TYPE_BOOLEAN }, /* file attributes: not content indexed */
-    { "f_attributes_offline",             KLEL_TYPE_BOOLEAN }, /* file attributes: offline */
-    { "f_attributes_read_only",           KLEL_TYPE_BOOLEAN }, /* file attributes: read only */
-    { "f_attributes_reparse_point",       KLEL_TYPE_BOOLEAN }, /* file attributes: reparse point */
-    { "f_attributes_sparse_file",         KLEL_TYPE_BOOLEAN }, /* file attributes: sparse */
-    { "f_attributes_system",              KLEL_TYPE_BOOLEAN }, /* file attributes: system */
-    { "f_attributes_temporary",           KLEL_TYPE_BOOLEAN }, /* file attributes: temporary */
-    { "f_attributes_unknown_1",           KLEL_TYPE_BOOLEAN }, /* file attributes: undocumented */
-    { "f_attributes_unknown_2",           KLEL_TYPE_BOOLEAN }, /* file attributes: undocumented */
-    { "f_attributes_virtual",             KLEL_TYPE_BOOLEAN }, /* file attributes: virtual */
-    { "f_chtime",                         KLEL_TYPE_INT64   }, /* file chtime */
-#endif
-    { "f_ctime",                          KLEL_TYPE_INT64   }, /* file ctime */
-#ifdef WIN32
-    { "f_dacl",                           KLEL_TYPE_STRING  }, /* file dacl */
-#endif
-#ifndef WIN32
-    { "f_dev",                            KLEL_TYPE_INT64   }, /* file dev */
-#endif
-    { "f_exists",                         KLEL_TYPE_BOOLEAN }, /* file exists */
-#ifdef WIN32
-    { "f_findex",                         KLEL_TYPE_INT64   }, /* file findex */
-#endif
-#ifndef WIN32
-    { "f_fstype",                         KLEL_TYPE_STRING  }, /* file system type */
-    { "f_gid",                            KLEL_TYPE_INT64   }, /* file group ID */
-#endif
-#ifdef WIN32
-    { "f_gsid",                           KLEL_TYPE_STRING  }, /* file group SID */
-#endif
-#ifndef WIN32
-    { "f_inode",                          KLEL_TYPE_INT64   }, /* file inode */
-#endif
-    { "f_magic",                          KLEL_TYPE_STRING  }, /* file type (XMagic) */
-    { "f_md5",                            KLEL_TYPE_STRING  }, /* file hash (MD5) */
-#ifndef WIN32
-    { "f_mode",                           KLEL_TYPE_INT64   }, /* file mode */
-    { "f_mode_gr",                        KLEL_TYPE_BOOLEAN }, /* file mode permission: group read */
-    { "f_mode_gw",                        KLEL_TYPE_BOOLEAN }, /* file mode permission: group write */
-    { "f_mode_gx",                        KLEL_TYPE_BOOLEAN }, /* file mode permission: group execute */
-    { "f_mode_or",                        KLEL_TYPE_BOOLEAN }, /* file mode permission: other read */
-    { "f_mode_ow",                        KLEL_TYPE_BOOLEAN }, /* file mode permission: other write */
-    { "f_mode_ox",                        KLEL_TYPE_BOOLEAN }, /* file mode permission: other execute */
-    { "f_mode_sg",                        KLEL_TYPE_BOOLEAN }, /* file mode SGID (set group id on execution) bit */
-    { "f_mode_st",                        KLEL_TYPE_BOOLEAN }, /* file mode sticky bit */
-    { "f_mode_su",                        KLEL_TYPE_BOOLEAN }, /* file mode SUID (set user id on execution) bit */
-    { "f_mode_tb",                        KLEL_TYPE_BOOLEAN }, /* file mode type: block special */
-    { "f_mode_tc",                        KLEL_TYPE_BOOLEAN }, /* file mode type: character special */
-    { "f_mode_td",                        KLEL_TYPE_BOOLEAN }, /* file mode type: directory */
-    { "f_mode_tl",                        KLEL_TYPE_BOOLEAN }, /* file mode type: symbolic link */
-    { "f_mode_tp",                        KLEL_TYPE_BOOLEAN }, /* file mode type: named pipe (fifo) */
-    { "f_mode_tr",                        KLEL_TYPE_BOOLEAN }, /* file mode type: regular file */
-    { "f_mode_ts",                        KLEL_TYPE_BOOLEAN }, /* file mode type: socket */
-    { "f_mode_tw",                        KLEL_TYPE_BOOLEAN }, /* file mode type: whiteout */
-    { "f_mode_ur",                        KLEL_TYPE_BOOLEAN }, /* file mode permission: user read */
-    { "f_mode_uw",                        KLEL_TYPE_BOOLEAN }, /* file mode permission: user write */
-    { "f_mode_ux",                        KLEL_TYPE_BOOLEAN }, /* file mode permission: user execute */
-#endif
-    { "f_mtime",                          KLEL_TYPE_INT64   }, /* file mtime */
-    { "f_name",                           KLEL_TYPE_STRING  }, /* file name (full path) */
-#ifndef WIN32
-    { "f_nlink",                          KLEL_TYPE_INT64   }, /* file nlink */
-#endif
-#ifdef WIN32
-    { "f_osid",                           KLEL_TYPE_STRING  }, /* file owner SID */
-#endif
-#ifndef WIN32
-    { "f_rdev",                           KLEL_TYPE_INT64   }, /* file rdev */
-#endif
-    { "f_sha1",                           KLEL_TYPE_STRING  }, /* file hash (SHA1) */
-    { "f_sha256",                         KLEL_TYPE_STRING  }, /* file hash (SHA256) */
-    { "f_size",                           KLEL_TYPE_INT64   }, /* file size */
-#ifndef WIN32
-    { "f_uid",                            KLEL_TYPE_INT64   }, /* file user ID */
-#endif
-#ifdef WIN32
-    { "f_volume",                         KLEL_TYPE_INT64   }, /* file volume ID */
-#endif
-  };
+  FILTER_TYPE_SPEC   *psVarSpec = NULL;
 
-  for (i = 0; i < (int)(sizeof(asTypes) / sizeof(asTypes[0])); i++)
+  psVarSpec = FilterGetVarSpec(pcName);
+  if (psVarSpec != NULL)
   {
-    if (strcmp(asTypes[i].pcName, pcName) == 0)
-    {
-      return asTypes[i].iType;
-    }
+    return psVarSpec->iType;
   }
 
   return KLEL_TYPE_UNKNOWN; /* This causes KLEL to retrieve the type of the specified variable, should it exist in the standard library. */
@@ -805,25 +920,29 @@ FilterGetTypeOfVar(const char *pcName, void *pvContext)
 KLEL_VALUE *
 FilterGetValueOfVar(const char *pcName, void *pvContext)
 {
+  FILTER_TYPE_SPEC   *psVarSpec = NULL;
   FTIMES_FILE_DATA   *psFTFileData = (FTIMES_FILE_DATA *)KlelGetPrivateData((KLEL_CONTEXT *)pvContext);
 #ifdef UNIX
   struct stat        *psFStatEntry = &psFTFileData->sStatEntry;
 #endif
 
-  if (pcName[0] == 'f' && pcName[1] == '_')
+  psVarSpec = FilterGetVarSpec(pcName);
+  if (psVarSpec != NULL)
   {
-    if (strcmp(pcName, "f_name") == 0)
+    switch (psVarSpec->iId)
+    {
+    case FILTER_VAR_NAME:
     {
       return KlelCreateValue(KLEL_TYPE_STRING, strlen(psFTFileData->pcRawPath), psFTFileData->pcRawPath);
     }
 
 #ifdef WIN32
-    if (strcmp(pcName, "f_altstreams") == 0)
+    case FILTER_VAR_ALTSTREAMS:
     {
       return KlelCreateValue(KLEL_TYPE_INT64, (APP_SI64)psFTFileData->iStreamCount);
     }
 #endif
-    if (strcmp(pcName, "f_atime") == 0)
+    case FILTER_VAR_ATIME:
     {
 #ifdef WIN32
       APP_SI64 i64Time = ((APP_SI64)psFTFileData->sFTATime.dwHighDateTime << 32) + ((APP_SI64)psFTFileData->sFTATime.dwLowDateTime);
@@ -833,85 +952,85 @@ FilterGetValueOfVar(const char *pcName, void *pvContext)
 #endif
     }
 #ifdef WIN32
-    if (strcmp(pcName, "f_attributes") == 0)
+    case FILTER_VAR_ATTRIBUTES:
     {
       return KlelCreateValue(KLEL_TYPE_INT64, (APP_SI64)psFTFileData->dwFileAttributes);
     }
-    if (strcmp(pcName, "f_attributes_archive") == 0)
+    case FILTER_VAR_ATTRIBUTES_ARCHIVE:
     {
       return KlelCreateValue(KLEL_TYPE_BOOLEAN, psFTFileData->dwFileAttributes & FILE_ATTRIBUTE_ARCHIVE);
     }
-    if (strcmp(pcName, "f_attributes_compressed") == 0)
+    case FILTER_VAR_ATTRIBUTES_COMPRESSED:
     {
       return KlelCreateValue(KLEL_TYPE_BOOLEAN, psFTFileData->dwFileAttributes & FILE_ATTRIBUTE_COMPRESSED);
     }
-    if (strcmp(pcName, "f_attributes_device") == 0)
+    case FILTER_VAR_ATTRIBUTES_DEVICE:
     {
       return KlelCreateValue(KLEL_TYPE_BOOLEAN, psFTFileData->dwFileAttributes & FILE_ATTRIBUTE_DEVICE);
     }
-    if (strcmp(pcName, "f_attributes_directory") == 0)
+    case FILTER_VAR_ATTRIBUTES_DIRECTORY:
     {
       return KlelCreateValue(KLEL_TYPE_BOOLEAN, psFTFileData->dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY);
     }
-    if (strcmp(pcName, "f_attributes_encrypted") == 0)
+    case FILTER_VAR_ATTRIBUTES_ENCRYPTED:
     {
       return KlelCreateValue(KLEL_TYPE_BOOLEAN, psFTFileData->dwFileAttributes & FILE_ATTRIBUTE_ENCRYPTED);
     }
-    if (strcmp(pcName, "f_attributes_hidden") == 0)
+    case FILTER_VAR_ATTRIBUTES_HIDDEN:
     {
       return KlelCreateValue(KLEL_TYPE_BOOLEAN, psFTFileData->dwFileAttributes & FILE_ATTRIBUTE_HIDDEN);
     }
-    if (strcmp(pcName, "f_attributes_normal") == 0)
+    case FILTER_VAR_ATTRIBUTES_NORMAL:
     {
       return KlelCreateValue(KLEL_TYPE_BOOLEAN, psFTFileData->dwFileAttributes & FILE_ATTRIBUTE_NORMAL);
     }
-    if (strcmp(pcName, "f_attributes_not_content_indexed") == 0)
+    case FILTER_VAR_ATTRIBUTES_NOT_CONTENT_INDEXED:
     {
       return KlelCreateValue(KLEL_TYPE_BOOLEAN, psFTFileData->dwFileAttributes & FILE_ATTRIBUTE_NOT_CONTENT_INDEXED);
     }
-    if (strcmp(pcName, "f_attributes_offline") == 0)
+    case FILTER_VAR_ATTRIBUTES_OFFLINE:
     {
       return KlelCreateValue(KLEL_TYPE_BOOLEAN, psFTFileData->dwFileAttributes & FILE_ATTRIBUTE_OFFLINE);
     }
-    if (strcmp(pcName, "f_attributes_read_only") == 0)
+    case FILTER_VAR_ATTRIBUTES_READ_ONLY:
     {
       return KlelCreateValue(KLEL_TYPE_BOOLEAN, psFTFileData->dwFileAttributes & FILE_ATTRIBUTE_READONLY);
     }
-    if (strcmp(pcName, "f_attributes_reparse_point") == 0)
+    case FILTER_VAR_ATTRIBUTES_REPARSE_POINT:
     {
       return KlelCreateValue(KLEL_TYPE_BOOLEAN, psFTFileData->dwFileAttributes & FILE_ATTRIBUTE_REPARSE_POINT);
     }
-    if (strcmp(pcName, "f_attributes_sparse_file") == 0)
+    case FILTER_VAR_ATTRIBUTES_SPARSE_FILE:
     {
       return KlelCreateValue(KLEL_TYPE_BOOLEAN, psFTFileData->dwFileAttributes & FILE_ATTRIBUTE_SPARSE_FILE);
     }
-    if (strcmp(pcName, "f_attributes_system") == 0)
+    case FILTER_VAR_ATTRIBUTES_SYSTEM:
     {
       return KlelCreateValue(KLEL_TYPE_BOOLEAN, psFTFileData->dwFileAttributes & FILE_ATTRIBUTE_SYSTEM);
     }
-    if (strcmp(pcName, "f_attributes_temporary") == 0)
+    case FILTER_VAR_ATTRIBUTES_TEMPORARY:
     {
       return KlelCreateValue(KLEL_TYPE_BOOLEAN, psFTFileData->dwFileAttributes & FILE_ATTRIBUTE_TEMPORARY);
     }
-    if (strcmp(pcName, "f_attributes_unknown_1") == 0)
+    case FILTER_VAR_ATTRIBUTES_UNKNOWN_1:
     {
       return KlelCreateValue(KLEL_TYPE_BOOLEAN, psFTFileData->dwFileAttributes & 0x00008);
     }
-    if (strcmp(pcName, "f_attributes_unknown_2") == 0)
+    case FILTER_VAR_ATTRIBUTES_UNKNOWN_2:
     {
       return KlelCreateValue(KLEL_TYPE_BOOLEAN, psFTFileData->dwFileAttributes & 0x08000);
     }
-    if (strcmp(pcName, "f_attributes_virtual") == 0)
+    case FILTER_VAR_ATTRIBUTES_VIRTUAL:
     {
       return KlelCreateValue(KLEL_TYPE_BOOLEAN, psFTFileData->dwFileAttributes & FILE_ATTRIBUTE_VIRTUAL);
     }
-    if (strcmp(pcName, "f_chtime") == 0)
+    case FILTER_VAR_CHTIME:
     {
       APP_SI64 i64Time = ((APP_SI64)psFTFileData->sFTChTime.dwHighDateTime << 32) + ((APP_SI64)psFTFileData->sFTChTime.dwLowDateTime);
       return KlelCreateValue(KLEL_TYPE_INT64, (APP_SI64)i64Time);
     }
 #endif
-    if (strcmp(pcName, "f_ctime") == 0)
+    case FILTER_VAR_CTIME:
     {
 #ifdef WIN32
       APP_SI64 i64Time = ((APP_SI64)psFTFileData->sFTCTime.dwHighDateTime << 32) + ((APP_SI64)psFTFileData->sFTCTime.dwLowDateTime);
@@ -921,7 +1040,7 @@ FilterGetValueOfVar(const char *pcName, void *pvContext)
 #endif
     }
 #ifdef WIN32
-    if (strcmp(pcName, "f_dacl") == 0)
+    case FILTER_VAR_DACL:
     {
       char *pcAclDacl = NULL;
       DWORD dwLength = 0;
@@ -933,33 +1052,33 @@ FilterGetValueOfVar(const char *pcName, void *pvContext)
     }
 #endif
 #ifndef WIN32
-    if (strcmp(pcName, "f_dev") == 0)
+    case FILTER_VAR_DEV:
     {
       return KlelCreateValue(KLEL_TYPE_INT64, (APP_SI64)(psFStatEntry->st_dev));
     }
 #endif
-    if (strcmp(pcName, "f_exists") == 0)
+    case FILTER_VAR_EXISTS:
     {
       return KlelCreateValue(KLEL_TYPE_BOOLEAN, psFTFileData->iFileExists);
     }
 #ifdef WIN32
-    if (strcmp(pcName, "f_findex") == 0)
+    case FILTER_VAR_FINDEX:
     {
       return KlelCreateValue(KLEL_TYPE_INT64, (APP_SI64)(((APP_SI64)psFTFileData->dwFileIndexHigh << 32) | psFTFileData->dwFileIndexLow));
     }
 #endif
-    if (strcmp(pcName, "f_fstype") == 0)
+    case FILTER_VAR_FSTYPE:
     {
       return KlelCreateValue(KLEL_TYPE_STRING, strlen(gaacFSType[psFTFileData->iFSType]), gaacFSType[psFTFileData->iFSType]);
     }
 #ifndef WIN32
-    if (strcmp(pcName, "f_gid") == 0)
+    case FILTER_VAR_GID:
     {
       return KlelCreateValue(KLEL_TYPE_INT64, (APP_SI64)(psFStatEntry->st_gid));
     }
 #endif
 #ifdef WIN32
-    if (strcmp(pcName, "f_gsid") == 0)
+    case FILTER_VAR_GSID:
     {
       char *pcSidGroup = NULL;
       KLEL_VALUE *psValue = NULL;
@@ -970,91 +1089,91 @@ FilterGetValueOfVar(const char *pcName, void *pvContext)
     }
 #endif
 #ifndef WIN32
-    if (strcmp(pcName, "f_inode") == 0)
+    case FILTER_VAR_INODE:
     {
       return KlelCreateValue(KLEL_TYPE_INT64, (APP_SI64)(psFStatEntry->st_ino));
     }
 #endif
-    if (strcmp(pcName, "f_magic") == 0)
+    case FILTER_VAR_MAGIC:
     {
       return KlelCreateValue(KLEL_TYPE_STRING, strlen(psFTFileData->acType), psFTFileData->acType);
     }
-    if (strcmp(pcName, "f_md5") == 0)
+    case FILTER_VAR_MD5:
     {
       char ac[MD5_HASH_SIZE*2+1];
       MD5HashToHex(psFTFileData->aucFileMd5, ac);
       return KlelCreateValue(KLEL_TYPE_STRING, MD5_HASH_SIZE*2, ac);
     }
 #ifndef WIN32
-    if (strcmp(pcName, "f_mode") == 0)
+    case FILTER_VAR_MODE:
     {
       return KlelCreateValue(KLEL_TYPE_INT64, (APP_SI64)(psFStatEntry->st_mode));
     }
-    if (strcmp(pcName, "f_mode_gr") == 0)
+    case FILTER_VAR_MODE_GR:
     {
       return KlelCreateValue(KLEL_TYPE_BOOLEAN, psFStatEntry->st_mode & S_IRGRP);
     }
-    if (strcmp(pcName, "f_mode_gw") == 0)
+    case FILTER_VAR_MODE_GW:
     {
       return KlelCreateValue(KLEL_TYPE_BOOLEAN, psFStatEntry->st_mode & S_IWGRP);
     }
-    if (strcmp(pcName, "f_mode_gx") == 0)
+    case FILTER_VAR_MODE_GX:
     {
       return KlelCreateValue(KLEL_TYPE_BOOLEAN, psFStatEntry->st_mode & S_IXGRP);
     }
-    if (strcmp(pcName, "f_mode_or") == 0)
+    case FILTER_VAR_MODE_OR:
     {
       return KlelCreateValue(KLEL_TYPE_BOOLEAN, psFStatEntry->st_mode & S_IROTH);
     }
-    if (strcmp(pcName, "f_mode_ow") == 0)
+    case FILTER_VAR_MODE_OW:
     {
       return KlelCreateValue(KLEL_TYPE_BOOLEAN, psFStatEntry->st_mode & S_IWOTH);
     }
-    if (strcmp(pcName, "f_mode_ox") == 0)
+    case FILTER_VAR_MODE_OX:
     {
       return KlelCreateValue(KLEL_TYPE_BOOLEAN, psFStatEntry->st_mode & S_IXOTH);
     }
-    if (strcmp(pcName, "f_mode_sg") == 0)
+    case FILTER_VAR_MODE_SG:
     {
       return KlelCreateValue(KLEL_TYPE_BOOLEAN, psFStatEntry->st_mode & S_ISGID);
     }
-    if (strcmp(pcName, "f_mode_st") == 0)
+    case FILTER_VAR_MODE_ST:
     {
       return KlelCreateValue(KLEL_TYPE_BOOLEAN, psFStatEntry->st_mode & S_ISVTX);
     }
-    if (strcmp(pcName, "f_mode_su") == 0)
+    case FILTER_VAR_MODE_SU:
     {
       return KlelCreateValue(KLEL_TYPE_BOOLEAN, psFStatEntry->st_mode & S_ISUID);
     }
-    if (strcmp(pcName, "f_mode_tb") == 0)
+    case FILTER_VAR_MODE_TB:
     {
       return KlelCreateValue(KLEL_TYPE_BOOLEAN, S_ISBLK(psFStatEntry->st_mode));
     }
-    if (strcmp(pcName, "f_mode_tc") == 0)
+    case FILTER_VAR_MODE_TC:
     {
       return KlelCreateValue(KLEL_TYPE_BOOLEAN, S_ISCHR(psFStatEntry->st_mode));
     }
-    if (strcmp(pcName, "f_mode_td") == 0)
+    case FILTER_VAR_MODE_TD:
     {
       return KlelCreateValue(KLEL_TYPE_BOOLEAN, S_ISDIR(psFStatEntry->st_mode));
     }
-    if (strcmp(pcName, "f_mode_tl") == 0)
+    case FILTER_VAR_MODE_TL:
     {
       return KlelCreateValue(KLEL_TYPE_BOOLEAN, S_ISLNK(psFStatEntry->st_mode));
     }
-    if (strcmp(pcName, "f_mode_tp") == 0)
+    case FILTER_VAR_MODE_TP:
     {
       return KlelCreateValue(KLEL_TYPE_BOOLEAN, S_ISFIFO(psFStatEntry->st_mode));
     }
-    if (strcmp(pcName, "f_mode_tr") == 0)
+    case FILTER_VAR_MODE_TR:
     {
       return KlelCreateValue(KLEL_TYPE_BOOLEAN, S_ISREG(psFStatEntry->st_mode));
     }
-    if (strcmp(pcName, "f_mode_ts") == 0)
+    case FILTER_VAR_MODE_TS:
     {
       return KlelCreateValue(KLEL_TYPE_BOOLEAN, S_ISSOCK(psFStatEntry->st_mode));
     }
-    if (strcmp(pcName, "f_mode_tw") == 0)
+    case FILTER_VAR_MODE_TW:
     {
 #ifdef S_ISWHT
       return KlelCreateValue(KLEL_TYPE_BOOLEAN, S_ISWHT(psFStatEntry->st_mode));
@@ -1062,20 +1181,20 @@ FilterGetValueOfVar(const char *pcName, void *pvContext)
       return KlelCreateValue(KLEL_TYPE_BOOLEAN, (((psFStatEntry->st_mode) & 0170000) == 0160000));
 #endif
     }
-    if (strcmp(pcName, "f_mode_ur") == 0)
+    case FILTER_VAR_MODE_UR:
     {
       return KlelCreateValue(KLEL_TYPE_BOOLEAN, psFStatEntry->st_mode & S_IRUSR);
     }
-    if (strcmp(pcName, "f_mode_uw") == 0)
+    case FILTER_VAR_MODE_UW:
     {
       return KlelCreateValue(KLEL_TYPE_BOOLEAN, psFStatEntry->st_mode & S_IWUSR);
     }
-    if (strcmp(pcName, "f_mode_ux") == 0)
+    case FILTER_VAR_MODE_UX:
     {
       return KlelCreateValue(KLEL_TYPE_BOOLEAN, psFStatEntry->st_mode & S_IXUSR);
     }
 #endif
-    if (strcmp(pcName, "f_mtime") == 0)
+    case FILTER_VAR_MTIME:
     {
 #ifdef WIN32
       APP_SI64 i64Time = ((APP_SI64)psFTFileData->sFTMTime.dwHighDateTime << 32) + ((APP_SI64)psFTFileData->sFTMTime.dwLowDateTime);
@@ -1085,13 +1204,13 @@ FilterGetValueOfVar(const char *pcName, void *pvContext)
 #endif
     }
 #ifndef WIN32
-    if (strcmp(pcName, "f_nlink") == 0)
+    case FILTER_VAR_NLINK:
     {
       return KlelCreateValue(KLEL_TYPE_INT64, (APP_SI64)(psFStatEntry->st_nlink));
     }
 #endif
 #ifdef WIN32
-    if (strcmp(pcName, "f_osid") == 0)
+    case FILTER_VAR_OSID:
     {
       char *pcSidOwner = NULL;
       KLEL_VALUE *psValue = NULL;
@@ -1102,24 +1221,24 @@ FilterGetValueOfVar(const char *pcName, void *pvContext)
     }
 #endif
 #ifndef WIN32
-    if (strcmp(pcName, "f_rdev") == 0)
+    case FILTER_VAR_RDEV:
     {
       return KlelCreateValue(KLEL_TYPE_INT64, (APP_SI64)(psFStatEntry->st_rdev));
     }
 #endif
-    if (strcmp(pcName, "f_sha1") == 0)
+    case FILTER_VAR_SHA1:
     {
       char ac[SHA1_HASH_SIZE*2+1];
       SHA1HashToHex(psFTFileData->aucFileSha1, ac);
       return KlelCreateValue(KLEL_TYPE_STRING, SHA1_HASH_SIZE*2, ac);
     }
-    if (strcmp(pcName, "f_sha256") == 0)
+    case FILTER_VAR_SHA256:
     {
       char ac[SHA256_HASH_SIZE*2+1];
       SHA256HashToHex(psFTFileData->aucFileSha256, ac);
       return KlelCreateValue(KLEL_TYPE_STRING, SHA256_HASH_SIZE*2, ac);
     }
-    if (strcmp(pcName, "f_size") == 0)
+    case FILTER_VAR_SIZE:
     {
 #ifdef WIN32
       return KlelCreateValue(KLEL_TYPE_INT64, (APP_SI64)(((APP_SI64)psFTFileData->dwFileSizeHigh << 32) | psFTFileData->dwFileSizeLow));
@@ -1128,23 +1247,53 @@ FilterGetValueOfVar(const char *pcName, void *pvContext)
 #endif
     }
 #ifndef WIN32
-    if (strcmp(pcName, "f_uid") == 0)
+    case FILTER_VAR_UID:
     {
       return KlelCreateValue(KLEL_TYPE_INT64, (APP_SI64)(psFStatEntry->st_uid));
     }
 #endif
 #ifdef WIN32
-    if (strcmp(pcName, "f_volume") == 0)
+    case FILTER_VAR_VOLUME:
     {
       return KlelCreateValue(KLEL_TYPE_INT64, (APP_SI64)psFTFileData->dwVolumeSerialNumber);
     }
 #endif
+    default:
+      break;
+    }
   }
 
   return KlelCreateUnknown(); /* This causes KLEL to retrieve the value of the specified variable, should it exist in the standard library. */
 }
 
 
+/*-
+ ***********************************************************************
+ *
+ * FilterGetVarSpec
+ *
+ ***********************************************************************
+ */
+FILTER_TYPE_SPEC *
+FilterGetVarSpec(const char *pcName)
+{
+  /*-
+   *********************************************************************
+   *
+   * All filter variables share the "f_" prefix. Anything else belongs
+   * to the KLEL standard library, so don't bother searching for it.
+   *
+   *********************************************************************
+   */
+  if (pcName[0] != 'f' || pcName[1] != '_')
+  {
+    return NULL;
+  }
+
+  return (FILTER_TYPE_SPEC *)bsearch(pcName, gasFilterVars, sizeof(gasFilterVars) / sizeof(gasFilterVars[0]), sizeof(gasFilterVars[0]), FilterCompareVarSpecs);
+}
+
+
 /*-
  ***********************************************************************
  *
@@ -1153,7 +1302,7 @@ FilterGetValueOfVar(const char *pcName, void *pvContext)
  ***********************************************************************
  */
 FILTER_LIST_KLEL *
-FilterMatchFilter(FILTER_LIST_KLEL *psFilterList, FTIMES_FILE_DATA *psFTFileData, int iFilterWhen)
+FilterMatchFilter(FILTER_LIST_KLEL *psFilterList, FTIMES_FILE_DATA *psFTFileData, int iFilterSince, int iFilterWhen)
 {
   BOOL                bMatch = FALSE;
   const char          acRoutine[] = "FilterMatchFilter()";
@@ -1164,13 +1313,23 @@ FilterMatchFilter(FILTER_LIST_KLEL *psFilterList, FTIMES_FILE_DATA *psFTFileData
   /*-
    *********************************************************************
    *
-   * Walk the filter list. Return a pointer to the first match.
+   * Walk the filter list. Return a pointer to the first match. The
+   * list is ordered by filter type (see FilterAddFilter()), so the
+   * cheapest filters are evaluated first, and the walk stops as soon
+   * as a filter that can't be evaluated yet is found. Filters that
+   * were already evaluated at an earlier filter point (i.e., those
+   * whose type is not greater than iFilterSince) are skipped since
+   * their outcome can't have changed.
    *
    *********************************************************************
    */
   for (psFilter = psFilterList; psFilter != NULL; psFilter = psFilter->psNext)
   {
     if (psFilter->iType > iFilterWhen)
+    {
+      break;
+    }
+    if (psFilter->iType <= iFilterSince)
     {
       continue;
     }
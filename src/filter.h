@@ -24,6 +24,80 @@
 #define FILTER_PREFIX_FOR_PCRE_SHA1 "f_sha1 =~ "
 #define FILTER_PREFIX_FOR_PCRE_SHA256 "f_sha256 =~ "
 
+/*-
+ ***********************************************************************
+ *
+ * Enums
+ *
+ ***********************************************************************
+ */
+typedef enum _FILTER_VAR_IDS
+{
+  FILTER_VAR_ALTSTREAMS = 0,
+  FILTER_VAR_ATIME,
+  FILTER_VAR_ATTRIBUTES,
+  FILTER_VAR_ATTRIBUTES_ARCHIVE,
+  FILTER_VAR_ATTRIBUTES_COMPRESSED,
+  FILTER_VAR_ATTRIBUTES_DEVICE,
+  FILTER_VAR_ATTRIBUTES_DIRECTORY,
+  FILTER_VAR_ATTRIBUTES_ENCRYPTED,
+  FILTER_VAR_ATTRIBUTES_HIDDEN,
+  FILTER_VAR_ATTRIBUTES_NORMAL,
+  FILTER_VAR_ATTRIBUTES_NOT_CONTENT_INDEXED,
+  FILTER_VAR_ATTRIBUTES_OFFLINE,
+  FILTER_VAR_ATTRIBUTES_READ_ONLY,
+  FILTER_VAR_ATTRIBUTES_REPARSE_POINT,
+  FILTER_VAR_ATTRIBUTES_SPARSE_FILE,
+  FILTER_VAR_ATTRIBUTES_SYSTEM,
+  FILTER_VAR_ATTRIBUTES_TEMPORARY,
+  FILTER_VAR_ATTRIBUTES_UNKNOWN_1,
+  FILTER_VAR_ATTRIBUTES_UNKNOWN_2,
+  FILTER_VAR_ATTRIBUTES_VIRTUAL,
+  FILTER_VAR_CHTIME,
+  FILTER_VAR_CTIME,
+  FILTER_VAR_DACL,
+  FILTER_VAR_DEV,
+  FILTER_VAR_EXISTS,
+  FILTER_VAR_FINDEX,
+  FILTER_VAR_FSTYPE,
+  FILTER_VAR_GID,
+  FILTER_VAR_GSID,
+  FILTER_VAR_INODE,
+  FILTER_VAR_MAGIC,
+  FILTER_VAR_MD5,
+  FILTER_VAR_MODE,
+  FILTER_VAR_MODE_GR,
+  FILTER_VAR_MODE_GW,
+  FILTER_VAR_MODE_GX,
+  FILTER_VAR_MODE_OR,
+  FILTER_VAR_MODE_OW,
+  FILTER_VAR_MODE_OX,
+  FILTER_VAR_MODE_SG,
+  FILTER_VAR_MODE_ST,
+  FILTER_VAR_MODE_SU,
+  FILTER_VAR_MODE_TB,
+  FILTER_VAR_MODE_TC,
+  FILTER_VAR_MODE_TD,
+  FILTER_VAR_MODE_TL,
+  FILTER_VAR_MODE_TP,
+  FILTER_VAR_MODE_TR,
+  FILTER_VAR_MODE_TS,
+  FILTER_VAR_MODE_TW,
+  FILTER_VAR_MODE_UR,
+  FILTER_VAR_MODE_UW,
+  FILTER_VAR_MODE_UX,
+  FILTER_VAR_MTIME,
+  FILTER_VAR_NAME,
+  FILTER_VAR_NLINK,
+  FILTER_VAR_OSID,
+  FILTER_VAR_RDEV,
+  FILTER_VAR_SHA1,
+  FILTER_VAR_SHA256,
+  FILTER_VAR_SIZE,
+  FILTER_VAR_UID,
+  FILTER_VAR_VOLUME,
+} FILTER_VAR_IDS;
+
 /*-
  ***********************************************************************
  *
@@ -45,6 +119,7 @@ typedef struct _FILTER_TYPE_SPEC
 {
   const char         *pcName;
   KLEL_EXPR_TYPE      iType;
+  FILTER_VAR_IDS      iId;
 } FILTER_TYPE_SPEC;
 
 /*-
@@ -58,13 +133,15 @@ int                 FilterAddFilter(char *pcExpression, FILTER_LIST_KLEL **psHea
 //void                FilterApplyFilters(FTIMES_PROPERTIES *psProperties, FTIMES_FILE_DATA *psFTFileData, int iFilterWhen); /* This is defined in ftimes.h */
 int                 FilterCheckFilterMasks(FILTER_LIST_KLEL *psFilterList, unsigned long ulMask, char *pcError);
 int                 FilterClassifyFilter(FILTER_LIST_KLEL *psFilter, char *pcError);
+int                 FilterCompareVarSpecs(const void *pvKey, const void *pvVarSpec);
 char               *FilterConvertFromPcre(char *pcExpression, char *pcConversionPrefix, char *pcError);
 char               *FilterEvaluateFilterNode(KLEL_NODE *psNode, int iLevel, char *pcError);
 void                FilterFreeFilter(FILTER_LIST_KLEL *psFilter);
 int                 FilterGetFilterCount(FILTER_LIST_KLEL *psFilterList, int iType);
 KLEL_EXPR_TYPE      FilterGetTypeOfVar(const char *pcName, void *pvContext);
 KLEL_VALUE         *FilterGetValueOfVar(const char *pcName, void *pvContext);
-//FILTER_LIST_KLEL   *FilterMatchFilter(FILTER_LIST_KLEL *psFilterList, FTIMES_FILE_DATA *psFTFileData, int iFilterWhen); /* This is defined in ftimes.h */
+FILTER_TYPE_SPEC   *FilterGetVarSpec(const char *pcName);
+//FILTER_LIST_KLEL   *FilterMatchFilter(FILTER_LIST_KLEL *psFilterList, FTIMES_FILE_DATA *psFTFileData, int iFilterSince, int iFilterWhen); /* This is defined in ftimes.h */
 FILTER_LIST_KLEL   *FilterNewFilter(char *pcExpression, char *pcError);
 
 #endif /* !_FILTER_H_INCLUDED */
@@ -584,6 +584,11 @@ FTimesFreeProperties(FTIMES_PROPERTIES *psProperties)
     DecodeFreeSnapshotContext(psProperties->psSnapshotContext);
 #ifdef USE_SSL
     SslFreeProperties(psProperties->psSslProperties);
+#endif
+    SupportFreeTrie(psProperties->psExcludeTrie);
+#ifdef USE_PCRE
+    SupportFreeFilterUnion(psProperties->psExcludeFilterUnion);
+    SupportFreeFilterUnion(psProperties->psIncludeFilterUnion);
 #endif
     if (psProperties->pcNonce)
     {
@@ -708,6 +713,60 @@ FTimesNewProperties(char *pcError)
   psProperties->iAnalyzeStepSize = AnalyzeGetStepSize();
 #endif
 
+  /*-
+   *********************************************************************
+   *
+   * Initialize OutputFormat variable -- text is the default.
+   *
+   *********************************************************************
+   */
+  psProperties->iOutputFormat = FTIMES_OUTPUT_FORMAT_TEXT;
+
+#ifdef USE_ZLIB
+  /*-
+   *********************************************************************
+   *
+   * Initialize OutputCompression variables -- none is the default.
+   *
+   *********************************************************************
+   */
+  psProperties->iOutputCompression = FTIMES_OUTPUT_COMPRESSION_NONE;
+  psProperties->iOutputCompressLevel = FTIMES_OUTPUT_COMPRESSION_LEVEL;
+#endif
+
+#ifdef USE_URL_COMPRESSION
+  /*-
+   *********************************************************************
+   *
+   * Initialize URLPutCompression variable -- none is the default.
+   *
+   *********************************************************************
+   */
+  psProperties->iURLPutCompression = FTIMES_URL_COMPRESSION_NONE;
+#endif
+
+#ifdef USE_FILE_HOOKS
+  /*-
+   *********************************************************************
+   *
+   * Initialize hook worker variables.
+   *
+   *********************************************************************
+   */
+  psProperties->iFileHookWorkers = HOOK_DEFAULT_WORKER_COUNT;
+#endif
+
+  /*-
+   *********************************************************************
+   *
+   * Initialize URL timeouts. Zero means wait indefinitely.
+   *
+   *********************************************************************
+   */
+  psProperties->iURLConnectTimeout = FTIMES_URL_CONNECT_TIMEOUT;
+  psProperties->iURLReadTimeout = FTIMES_URL_READ_TIMEOUT;
+  psProperties->iURLWriteTimeout = FTIMES_URL_WRITE_TIMEOUT;
+
   /*-
    *********************************************************************
    *
@@ -826,6 +885,9 @@ FTimesOptionHandler(void *pvOption, char *pcValue, void *pvProperties, char *pcE
 
   switch (psOption->iId)
   {
+  case OPT_Index:
+    psProperties->psSnapshotContext->iBuildIndex = 1;
+    break;
   case OPT_LogLevel:
     iError = SupportSetLogLevel(pcValue, &psProperties->iLogLevel, acLocalError);
     if (iError != ER_OK)
@@ -834,6 +896,14 @@ FTimesOptionHandler(void *pvOption, char *pcValue, void *pvProperties, char *pcE
       return ER;
     }
     break;
+  case OPT_Lookup:
+    if (iLength < 1 || iLength > FTIMES_MAX_PATH - 3)
+    {
+      snprintf(pcError, MESSAGE_SIZE, "%s: option=[%s]: Argument length must be in the range [1-%d].", acRoutine, psOption->atcFullName, FTIMES_MAX_PATH - 3);
+      return ER;
+    }
+    psProperties->psSnapshotContext->pcLookupName = pcValue;
+    break;
   case OPT_MagicFile:
     if (iLength < 1 || iLength > FTIMES_MAX_PATH - 1)
     {
@@ -864,6 +934,16 @@ FTimesOptionHandler(void *pvOption, char *pcValue, void *pvProperties, char *pcE
   case OPT_StrictTesting:
     psProperties->iTestLevel = FTIMES_TEST_STRICT;
     break;
+#ifdef USE_DECODE_THREADS
+  case OPT_Workers:
+    if (iLength < 1 || iLength > 2 || strspn(pcValue, "0123456789") != (size_t) iLength || atoi(pcValue) < 1 || atoi(pcValue) > DECODE_MAX_WORKERS)
+    {
+      snprintf(pcError, MESSAGE_SIZE, "%s: option=[%s]: Argument (%s) does not pass muster. Value must be in the range [1-%d].", acRoutine, psOption->atcFullName, pcValue, DECODE_MAX_WORKERS);
+      return ER;
+    }
+    psProperties->psSnapshotContext->iWorkerCount = atoi(pcValue);
+    break;
+#endif
   default:
     snprintf(pcError, MESSAGE_SIZE, "%s: Invalid option ID (%d). This should not happen.", acRoutine, psOption->iId);
     return ER;
@@ -906,7 +986,12 @@ FTimesProcessArguments(FTIMES_PROPERTIES *psProperties, int iArgumentCount, char
   };
   static OPTIONS_TABLE asDecodeOptions[] =
   {
+    { OPT_Index, "", "--Index", 0, 0, 0, 0, FTimesOptionHandler },
     { OPT_LogLevel, "-l", "--LogLevel", 0, 0, 1, 0, FTimesOptionHandler },
+    { OPT_Lookup, "", "--Lookup", 0, 0, 1, 0, FTimesOptionHandler },
+#ifdef USE_DECODE_THREADS
+    { OPT_Workers, "", "--Workers", 0, 0, 1, 0, FTimesOptionHandler },
+#endif
   };
   static OPTIONS_TABLE asDigOptions[] =
   {
@@ -1520,7 +1605,8 @@ FTimesFinalStage(FTIMES_PROPERTIES *psProperties, char *pcError)
   /*-
    *********************************************************************
    *
-   * Flush the Message Handler, and close the LogFile stream.
+   * Flush the Message Handler, and close the LogFile stream. Any
+   * messages generated after this point go to stderr.
    *
    *********************************************************************
    */
@@ -1529,6 +1615,7 @@ FTimesFinalStage(FTIMES_PROPERTIES *psProperties, char *pcError)
     MessageHandler(MESSAGE_FLUSH_IT, MESSAGE_INFORMATION, NULL, NULL);
     fclose(psProperties->pFileLog);
     psProperties->pFileLog = NULL;
+    MessageSetOutputStream(stderr);
   }
 
   /*-
@@ -1548,6 +1635,15 @@ FTimesFinalStage(FTIMES_PROPERTIES *psProperties, char *pcError)
     }
   }
 
+  /*-
+   *********************************************************************
+   *
+   * Close any connections that were kept alive for reuse.
+   *
+   *********************************************************************
+   */
+  HttpCloseConnections();
+
 #ifdef WINNT
   /*-
    *********************************************************************
@@ -1608,7 +1704,12 @@ FTimesUsage(void)
   fprintf(stderr, "\n");
   fprintf(stderr, "Usage: ftimes --cfgtest file mode [-s]\n");
   fprintf(stderr, "       ftimes --compare mask baseline snapshot [-l {0-6}]\n");
+#ifdef USE_DECODE_THREADS
+  fprintf(stderr, "       ftimes --decode snapshot [-l {0-6}] [--Workers {1-%d}]\n", DECODE_MAX_WORKERS);
+#else
   fprintf(stderr, "       ftimes --decode snapshot [-l {0-6}]\n");
+#endif
+  fprintf(stderr, "       ftimes --decode snapshot [-l {0-6}] {--Index|--Lookup name}\n");
   fprintf(stderr, "       ftimes --dig file [-l {0-6}] [target [...]]\n");
   fprintf(stderr, "       ftimes --digauto file [-l {0-6}] [target [...]]\n");
   fprintf(stderr, "       ftimes --get file [-l {0-6}]\n");
@@ -1706,6 +1807,7 @@ FTimesEraseFiles(FTIMES_PROPERTIES *psProperties, char *pcError)
   const char          acRoutine[] = "FTimesEraseFiles()";
   char                acLocalError[MESSAGE_SIZE] = "";
   int                 iError;
+  int                 iKeepsOutFile = 1;
 
   iError = SupportEraseFile(psProperties->acLogFileName, acLocalError);
   if (iError != ER_OK)
@@ -1713,11 +1815,29 @@ FTimesEraseFiles(FTIMES_PROPERTIES *psProperties, char *pcError)
     snprintf(pcError, MESSAGE_SIZE, "%s: File = [%s]: %s", acRoutine, psProperties->acLogFileName, acLocalError);
     ErrorHandler(ER_Warning, pcError, ERROR_WARNING);
   }
-  iError = SupportEraseFile(psProperties->acOutFileName, acLocalError);
-  if (iError != ER_OK)
+#ifdef USE_URL_STREAM
+  if (psProperties->bURLPutStream)
   {
-    snprintf(pcError, MESSAGE_SIZE, "%s: File = [%s]: %s", acRoutine, psProperties->acOutFileName, acLocalError);
-    ErrorHandler(ER_Warning, pcError, ERROR_WARNING);
+    iKeepsOutFile = 0; /* Streamed output is not written locally when it's to be erased. */
+  }
+#endif
+  if (iKeepsOutFile)
+  {
+    iError = SupportEraseFile(psProperties->acOutFileName, acLocalError);
+    if (iError != ER_OK)
+    {
+      snprintf(pcError, MESSAGE_SIZE, "%s: File = [%s]: %s", acRoutine, psProperties->acOutFileName, acLocalError);
+      ErrorHandler(ER_Warning, pcError, ERROR_WARNING);
+    }
+  }
+  if (psProperties->acIndexFileName[0])
+  {
+    iError = SupportEraseFile(psProperties->acIndexFileName, acLocalError);
+    if (iError != ER_OK)
+    {
+      snprintf(pcError, MESSAGE_SIZE, "%s: File = [%s]: %s", acRoutine, psProperties->acIndexFileName, acLocalError);
+      ErrorHandler(ER_Warning, pcError, ERROR_WARNING);
+    }
   }
 }
 
@@ -60,11 +60,16 @@ typedef enum _BOOL
 
 typedef enum _FTIMES_OPTION_IDS
 {
+  OPT_Index,
   OPT_LogLevel,
+  OPT_Lookup,
   OPT_MagicFile,
   OPT_MemoryMapEnable,
   OPT_NamesAreCaseInsensitive,
   OPT_StrictTesting,
+#ifdef USE_DECODE_THREADS
+  OPT_Workers,
+#endif
 } FTIMES_OPTION_IDS;
 
 #define N_100ns_UNITS_IN_1s         10000000
@@ -127,7 +132,9 @@ typedef enum _FTIMES_OPTION_IDS
 #define FTIMES_MIN_BLOCK_SIZE              1
 #define FTIMES_MAX_BLOCK_SIZE     1073741824 /* 1 GB */
 #define FTIMES_MAX_DEPTH               65536
+#define FTIMES_MAX_HOOK_TIMEOUT        86400 /* seconds */
 #define FTIMES_MAX_KBPS              2097152 /* 2^31/1024 */
+#define FTIMES_MAX_URL_TIMEOUT         86400 /* seconds */
 
 #define FTIMES_MIN_STRING_REPEATS          0
 #define FTIMES_MAX_STRING_REPEATS 0x7fffffff
@@ -168,6 +175,41 @@ typedef enum _FTIMES_OPTION_IDS
 #define FTIMES_FILTER_POST_ATTR_SCAN       3
 #define FTIMES_FILTER_POST_DATA            4
 
+#define FTIMES_OUTPUT_FORMAT_TEXT          0
+#define FTIMES_OUTPUT_FORMAT_BINARY        1
+
+#ifdef USE_ZLIB
+#define FTIMES_OUTPUT_COMPRESSION_NONE     0
+#define FTIMES_OUTPUT_COMPRESSION_GZIP     1
+#define FTIMES_OUTPUT_COMPRESSION_LEVEL    6
+#endif
+
+#define FTIMES_URL_CONNECT_TIMEOUT        60 /* seconds */
+#define FTIMES_URL_READ_TIMEOUT          300 /* seconds */
+#define FTIMES_URL_WRITE_TIMEOUT         300 /* seconds */
+
+#if defined(USE_URL_STREAM) && defined(USE_ZLIB)
+#define USE_URL_COMPRESSION                1
+#define FTIMES_URL_COMPRESSION_NONE        0
+#define FTIMES_URL_COMPRESSION_GZIP        1
+#endif
+
+#ifdef USE_URL_STREAM
+#define URL_STREAM_FLUSH_NONE              0 /* Let the compressor buffer data */
+#define URL_STREAM_FLUSH_SYNC              1 /* Push out all data sent so far */
+#define URL_STREAM_FLUSH_FINISH            2 /* End the compressed stream */
+#define URL_STREAM_FLUSH_INTERVAL          1 /* Seconds between partial chunks */
+#define URL_STREAM_QUEUE_DEPTH            16 /* Chunks waiting to be sent */
+#define URL_STREAM_TRAILER_SIZE          128
+#ifdef HAVE_FOPENCOOKIE
+#define URL_STREAM_IO_LENGTH size_t
+#define URL_STREAM_IO_RESULT ssize_t
+#else
+#define URL_STREAM_IO_LENGTH int
+#define URL_STREAM_IO_RESULT int
+#endif
+#endif
+
 #ifdef WIN32
 #ifndef IDLE_PRIORITY_CLASS
 #define IDLE_PRIORITY_CLASS         0x00000040
@@ -228,6 +270,7 @@ typedef struct _FTIMES_FILE_DATA
   int                 iDepth;
   int                 iFileExists;
   int                 iFiltered;
+  int                 iFilterStage;
   int                 iFSType;
   int                 iNeuteredPathLength;
   int                 iStreamCount;
@@ -253,6 +296,7 @@ typedef struct _FTIMES_FILE_DATA
   int                 iDepth;
   int                 iFileExists;
   int                 iFiltered;
+  int                 iFilterStage;
   int                 iFSType;
   int                 iNeuteredPathLength;
   int                 iRawPathLength;
@@ -262,6 +306,7 @@ typedef struct _FTIMES_FILE_DATA
   unsigned char       aucFileSha256[SHA256_HASH_SIZE];
   unsigned long       ulAttributeMask;
   struct _FTIMES_FILE_DATA *psParent;
+  struct _FTIMES_FILE_DATA *psNextFree;
 } FTIMES_FILE_DATA;
 #endif
 
@@ -276,6 +321,17 @@ typedef struct _FILE_LIST
   struct _FILE_LIST  *psNext;
 } FILE_LIST;
 
+#define FILE_TRIE_CHILD_COUNT 4
+typedef struct _FILE_TRIE
+{
+  char               *pcName; /* One path component -- not NULL terminated */
+  int                 iLength;
+  int                 iChildCount;
+  int                 iChildSize;
+  FILE_LIST          *psItem; /* Non-NULL when a list item ends here */
+  struct _FILE_TRIE **ppsChildren; /* Sorted by name */
+} FILE_TRIE;
+
 #ifdef USE_PCRE
 typedef struct _FILTER_LIST
 {
@@ -284,6 +340,62 @@ typedef struct _FILTER_LIST
   pcre_extra         *psPcreExtra;
   struct _FILTER_LIST *psNext;
 } FILTER_LIST;
+
+#define FILTER_DIGEST_SET_BUCKET_COUNT 0x10000 /* Indexed by the first two bytes of each digest. */
+#define FILTER_DIGEST_SET_REQUEST_COUNT 1024
+typedef struct _FILTER_DIGEST_SET
+{
+  int                 iCount;
+  int                 iDigestSize;
+  int                 iSize;
+  int                *piBuckets; /* Bucket start offsets (plus one end offset) once sorted */
+  unsigned char      *pucDigests;
+} FILTER_DIGEST_SET;
+
+#define FILTER_UNION_MAX_COUNT 256 /* Maximum number of filters combined into a single expression. */
+typedef struct _FILTER_UNION
+{
+  FILTER_LIST       **ppsFilters;
+  int                 iCount;
+  int                 iOVectorSize;
+  int                *piGroups; /* Capturing subpattern that wraps each filter */
+  int                *piOVector;
+  pcre               *psPcre;
+  pcre_extra         *psPcreExtra;
+  struct _FILTER_UNION *psNext;
+} FILTER_UNION;
+#endif
+
+#ifdef USE_URL_STREAM
+typedef struct _URL_PUT_STREAM
+{
+  char                aacQueue[URL_STREAM_QUEUE_DEPTH][HTTP_IO_BUFSIZE];
+  char                acData[HTTP_IO_BUFSIZE];
+#ifdef USE_URL_COMPRESSION
+  char                acDeflated[HTTP_IO_BUFSIZE];
+#endif
+  char                acError[MESSAGE_SIZE];
+  FILE               *pSinkFile; /* Local copy of the output, if any */
+  int                 aiQueueLengths[URL_STREAM_QUEUE_DEPTH];
+#ifdef USE_URL_COMPRESSION
+  int                 iCompress;
+#endif
+  int                 iError;
+  int                 iFinish;
+  int                 iLength;
+  int                 iQueueCount;
+  int                 iQueueFirst;
+  pid_t               tOwner;
+  pthread_cond_t      sCondition;
+  pthread_mutex_t     sMutex;
+  pthread_t           tThread;
+  time_t              tLastSend;
+  APP_UI64            ui64OutLength;
+  SOCKET_CONTEXT     *psSocketCTX;
+#ifdef USE_URL_COMPRESSION
+  z_stream            sZStream;
+#endif
+} URL_PUT_STREAM;
 #endif
 
 #define FTIMES_CMPDATA "cmp"
@@ -344,6 +456,8 @@ typedef struct _FILTER_LIST
 #define MODES_FieldMask           ((FTIMES_CMPMODE) | (FTIMES_MAPAUTO) | (FTIMES_MADMAP))
 #ifdef USE_FILE_HOOKS
 #define MODES_FileHook            (FTIMES_DIGMADMAP)
+#define MODES_FileHookTimeout     (FTIMES_DIGMADMAP)
+#define MODES_FileHookWorkers     (FTIMES_DIGMADMAP)
 #endif
 #define MODES_FileSizeLimit       (FTIMES_DIGMADMAP)
 #define MODES_GetAndExec          ((FTIMES_GETMODE))
@@ -359,24 +473,32 @@ typedef struct _FILTER_LIST
 #define MODES_IncludeFilterSha256 ((FTIMES_MAPAUTO) | (FTIMES_MADMAP))
 #endif
 #define MODES_IncludesMustExist   (FTIMES_DIGMADMAP)
+#define MODES_IndexSnapshot       (FTIMES_MAPMODE)
 #define MODES_LogDigStrings       ((FTIMES_DIGAUTO) | (FTIMES_DIGMAD))
 #define MODES_LogDir              (FTIMES_DIGMADMAP)
+#ifdef USE_XMAGIC
+#define MODES_MagicCacheFile      (FTIMES_MADMAP)
+#endif
 #define MODES_MagicFile           (FTIMES_MADMAP)
 #define MODES_MatchLimit          (FTIMES_DIGMAD)
 #define MODES_NewLine             (FTIMES_DIGMADMAP)
 #define MODES_OutDir              (FTIMES_DIGMADMAP)
+#define MODES_OutputFormat        (FTIMES_MAPMODE)
 #define MODES_Priority            ((FTIMES_CMPMODE) | (FTIMES_DIGAUTO) | (FTIMES_MAPAUTO) | (FTIMES_DIGMADMAP))
 #define MODES_RequirePrivilege    (FTIMES_DIGMADMAP)
 #define MODES_RunType             (FTIMES_DIGMADMAP)
 #define MODES_StrictControls      ((FTIMES_DIGMADMAP) | (FTIMES_GETMODE))
 #define MODES_URLAuthType         ((FTIMES_DIGMADMAP) | (FTIMES_GETMODE))
+#define MODES_URLConnectTimeout   ((FTIMES_DIGMADMAP) | (FTIMES_GETMODE))
 #define MODES_URLGetRequest       ((FTIMES_GETMODE))
 #define MODES_URLGetURL           ((FTIMES_GETMODE))
 #define MODES_URLPassword         ((FTIMES_DIGMADMAP) | (FTIMES_GETMODE))
 #define MODES_URLPutSnapshot      (FTIMES_DIGMADMAP)
 #define MODES_URLPutURL           (FTIMES_DIGMADMAP)
+#define MODES_URLReadTimeout      ((FTIMES_DIGMADMAP) | (FTIMES_GETMODE))
 #define MODES_URLUnlinkOutput     (FTIMES_DIGMADMAP)
 #define MODES_URLUsername         ((FTIMES_DIGMADMAP) | (FTIMES_GETMODE))
+#define MODES_URLWriteTimeout     ((FTIMES_DIGMADMAP) | (FTIMES_GETMODE))
 #ifdef USE_SSL
 #define MODES_SSLBundledCAsFile   ((FTIMES_DIGMADMAP) | (FTIMES_GETMODE))
 #define MODES_SSLExpectedPeerCN   ((FTIMES_DIGMADMAP) | (FTIMES_GETMODE))
@@ -391,6 +513,16 @@ typedef struct _FILTER_LIST
 #define MODES_ExcludeFilterKlel   ((FTIMES_DIGAUTO) | (FTIMES_MAPAUTO) | (FTIMES_DIGMADMAP))
 #define MODES_IncludeFilterKlel   ((FTIMES_DIGAUTO) | (FTIMES_MAPAUTO) | (FTIMES_DIGMADMAP))
 #endif
+#ifdef USE_ZLIB
+#define MODES_OutputCompression   (FTIMES_DIGMADMAP)
+#define MODES_OutputCompressLevel (FTIMES_DIGMADMAP)
+#endif
+#ifdef USE_URL_STREAM
+#define MODES_URLPutStream        (FTIMES_DIGMADMAP)
+#endif
+#ifdef USE_URL_COMPRESSION
+#define MODES_URLPutCompression   (FTIMES_DIGMADMAP)
+#endif
 
 #define KEY_AnalyzeBlockSize    "AnalyzeBlockSize"
 #define KEY_AnalyzeByteCount    "AnalyzeByteCount"
@@ -427,6 +559,8 @@ typedef struct _FILTER_LIST
 #define KEY_FieldMask           "FieldMask"
 #ifdef USE_FILE_HOOKS
 #define KEY_FileHook            "FileHook"
+#define KEY_FileHookTimeout     "FileHookTimeout"
+#define KEY_FileHookWorkers     "FileHookWorkers"
 #endif
 #define KEY_FileSizeLimit       "FileSizeLimit"
 #define KEY_GetAndExec          "GetAndExec"
@@ -442,25 +576,33 @@ typedef struct _FILTER_LIST
 #define KEY_IncludeFilterSha256 "IncludeFilterSha256"
 #endif
 #define KEY_IncludesMustExist   "IncludesMustExist"
+#define KEY_IndexSnapshot       "IndexSnapshot"
 #define KEY_LogDigStrings       "LogDigStrings"
 #define KEY_LogDir              "LogDir"
+#ifdef USE_XMAGIC
+#define KEY_MagicCacheFile      "MagicCacheFile"
+#endif
 #define KEY_MagicFile           "MagicFile"
 #define KEY_MapRemoteFiles      "MapRemoteFiles"
 #define KEY_MatchLimit          "MatchLimit"
 #define KEY_NewLine             "NewLine"
 #define KEY_OutDir              "OutDir"
+#define KEY_OutputFormat        "OutputFormat"
 #define KEY_Priority            "Priority"
 #define KEY_RequirePrivilege    "RequirePrivilege"
 #define KEY_RunType             "RunType"
 #define KEY_StrictControls      "StrictControls"
 #define KEY_URLAuthType         "URLAuthType"
+#define KEY_URLConnectTimeout   "URLConnectTimeout"
 #define KEY_URLGetRequest       "URLGetRequest"
 #define KEY_URLGetURL           "URLGetURL"
 #define KEY_URLPassword         "URLPassword"
 #define KEY_URLPutSnapshot      "URLPutSnapshot"
 #define KEY_URLPutURL           "URLPutURL"
+#define KEY_URLReadTimeout      "URLReadTimeout"
 #define KEY_URLUnlinkOutput     "URLUnlinkOutput"
 #define KEY_URLUsername         "URLUsername"
+#define KEY_URLWriteTimeout     "URLWriteTimeout"
 #ifdef USE_SSL
 #define KEY_SSLBundledCAsFile   "SSLBundledCAsFile"
 #define KEY_SSLExpectedPeerCN   "SSLExpectedPeerCN"
@@ -475,6 +617,16 @@ typedef struct _FILTER_LIST
 #define KEY_ExcludeFilterKlel   "ExcludeFilterKlel"
 #define KEY_IncludeFilterKlel   "IncludeFilterKlel"
 #endif
+#ifdef USE_ZLIB
+#define KEY_OutputCompression   "OutputCompression"
+#define KEY_OutputCompressLevel "OutputCompressLevel"
+#endif
+#ifdef USE_URL_STREAM
+#define KEY_URLPutStream        "URLPutStream"
+#endif
+#ifdef USE_URL_COMPRESSION
+#define KEY_URLPutCompression   "URLPutCompression"
+#endif
 
 typedef struct _CONTROLS_FOUND
 {
@@ -495,29 +647,41 @@ typedef struct _CONTROLS_FOUND
   BOOL                bEnableRecursionFound;
   BOOL                bExcludesMustExistFound;
   BOOL                bFieldMaskFound;
+#ifdef USE_FILE_HOOKS
+  BOOL                bFileHookTimeoutFound;
+  BOOL                bFileHookWorkersFound;
+#endif
   BOOL                bFileSizeLimitFound;
   BOOL                bGetAndExecFound;
   BOOL                bGetFileNameFound;
   BOOL                bHashDirectoriesFound;
   BOOL                bHashSymbolicLinksFound;
   BOOL                bIncludesMustExistFound;
+  BOOL                bIndexSnapshotFound;
   BOOL                bLogDigStringsFound;
   BOOL                bLogDirFound;
+#ifdef USE_XMAGIC
+  BOOL                bMagicCacheFileFound;
+#endif
   BOOL                bMagicFileFound;
   BOOL                bMatchLimitFound;
   BOOL                bNewLineFound;
   BOOL                bOutDirFound;
+  BOOL                bOutputFormatFound;
   BOOL                bPriorityFound;
   BOOL                bRequirePrivilegeFound;
   BOOL                bRunTypeFound;
   BOOL                bURLAuthTypeFound;
+  BOOL                bURLConnectTimeoutFound;
   BOOL                bURLGetRequestFound;
   BOOL                bURLGetURLFound;
   BOOL                bURLPasswordFound;
   BOOL                bURLPutSnapshotFound;
   BOOL                bURLPutURLFound;
+  BOOL                bURLReadTimeoutFound;
   BOOL                bURLUnlinkOutputFound;
   BOOL                bURLUsernameFound;
+  BOOL                bURLWriteTimeoutFound;
 #ifdef USE_SSL
   BOOL                bSSLBundledCAsFileFound;
   BOOL                bSSLExpectedPeerCNFound;
@@ -528,6 +692,16 @@ typedef struct _CONTROLS_FOUND
   BOOL                bSSLUseCertificateFound;
   BOOL                bSSLVerifyPeerCertFound;
 #endif
+#ifdef USE_ZLIB
+  BOOL                bOutputCompressionFound;
+  BOOL                bOutputCompressLevelFound;
+#endif
+#ifdef USE_URL_STREAM
+  BOOL                bURLPutStreamFound;
+#endif
+#ifdef USE_URL_COMPRESSION
+  BOOL                bURLPutCompressionFound;
+#endif
 } CONTROLS_FOUND;
 
 typedef struct _ANALYSIS_STAGES
@@ -560,14 +734,21 @@ typedef struct _FTIMES_PROPERTIES
   BOOL                bCompress;
   BOOL                bEnableRecursion;
   BOOL                bExcludesMustExist;
+#ifdef USE_FILE_HOOKS
+  BOOL                bFileHookBackground;
+#endif
   BOOL                bGetAndExec;
   BOOL                bHashDirectories;
   BOOL                bHashSymbolicLinks;
   BOOL                bIncludesMustExist;
+  BOOL                bIndexSnapshot;
   BOOL                bLogDigStrings;
   BOOL                bRequirePrivilege;
   BOOL                bStrictControls;
   BOOL                bURLPutSnapshot;
+#ifdef USE_URL_STREAM
+  BOOL                bURLPutStream;
+#endif
   BOOL                bURLUnlinkOutput;
   char                acBaseName[FTIMES_MAX_PATH];
   char                acBaseNameSuffix[FTIMES_SUFFIX_SIZE];
@@ -577,8 +758,12 @@ typedef struct _FTIMES_PROPERTIES
   char                acDateTime[FTIMES_TIME_SIZE];
   char                acDigRecordPrefix[FTIMES_RECORD_PREFIX_SIZE];
   char                acGetFileName[FTIMES_MAX_PATH];
+  char                acIndexFileName[FTIMES_MAX_PATH];
   char                acLogDirName[FTIMES_MAX_PATH];
   char                acLogFileName[FTIMES_MAX_PATH];
+#ifdef USE_XMAGIC
+  char                acMagicCacheFileName[FTIMES_MAX_PATH];
+#endif
   char                acMagicFileName[FTIMES_MAX_PATH];
   char                acMagicHash[FTIMES_MAX_MD5_LENGTH];
   char                acMapRecordPrefix[FTIMES_RECORD_PREFIX_SIZE];
@@ -608,6 +793,7 @@ typedef struct _FTIMES_PROPERTIES
   FILE               *pFileLog;
   FILE               *pFileOut;
   FILE_LIST          *psExcludeList;
+  FILE_TRIE          *psExcludeTrie;
   FILE_LIST          *psIncludeList;
 #ifdef USE_PCRE
   FILTER_LIST        *psExcludeFilterList;
@@ -618,6 +804,14 @@ typedef struct _FTIMES_PROPERTIES
   FILTER_LIST        *psIncludeFilterSha1List;
   FILTER_LIST        *psExcludeFilterSha256List;
   FILTER_LIST        *psIncludeFilterSha256List;
+  FILTER_DIGEST_SET  *psExcludeFilterMd5Set;
+  FILTER_DIGEST_SET  *psIncludeFilterMd5Set;
+  FILTER_DIGEST_SET  *psExcludeFilterSha1Set;
+  FILTER_DIGEST_SET  *psIncludeFilterSha1Set;
+  FILTER_DIGEST_SET  *psExcludeFilterSha256Set;
+  FILTER_DIGEST_SET  *psIncludeFilterSha256Set;
+  FILTER_UNION       *psExcludeFilterUnion;
+  FILTER_UNION       *psIncludeFilterUnion;
 #endif
 #ifdef USE_KLEL_FILTERS
   FILTER_LIST_KLEL   *psExcludeFilterListKlel;
@@ -625,17 +819,25 @@ typedef struct _FTIMES_PROPERTIES
 #endif
 #ifdef USE_FILE_HOOKS
   HOOK_LIST          *psFileHookList;
+  HOOK_WORKER        *psHookWorkers;
 #endif
 #define MAX_RUNMODE_STAGES 32
   RUNMODE_STAGES      sRunModeStages[MAX_RUNMODE_STAGES];
   HTTP_URL           *psGetURL;
   HTTP_URL           *psPutURL;
+#ifdef USE_URL_STREAM
+  URL_PUT_STREAM     *psPutStream;
+#endif
   int                 iAnalyzeBlockSize;
   int                 iAnalyzeCarrySize;
   int                 iAnalyzeMaxDepth;
   int                 iAnalyzeMaxDps;
 #ifdef USE_XMAGIC
   int                 iAnalyzeStepSize;
+#endif
+#ifdef USE_FILE_HOOKS
+  int                 iFileHookTimeout;
+  int                 iFileHookWorkers;
 #endif
   int                 iImportRecursionLevel;
   int                 iLastAnalysisStage;
@@ -643,12 +845,23 @@ typedef struct _FTIMES_PROPERTIES
   int                 iLogLevel;
   int                 iMatchLimit;
   int                 iMemoryMapEnable;
+  int                 iOutputFormat;
+#ifdef USE_ZLIB
+  int                 iOutputCompression;
+  int                 iOutputCompressLevel;
+#endif
   int                 iPriority;
   int                 iRunMode;
   int                 iNextRunMode;
   int                 iTestLevel;
   int                 iTestRunMode;
   int                 iURLAuthType;
+  int                 iURLConnectTimeout;
+#ifdef USE_URL_COMPRESSION
+  int                 iURLPutCompression;
+#endif
+  int                 iURLReadTimeout;
+  int                 iURLWriteTimeout;
 //int               (*piDevelopDigOutput)();
   int               (*piDevelopMapOutput)(void *pvProperties, char *pcOutData, int *iWriteCount, FTIMES_FILE_DATA *psFTFileData, char *pcError);
   int               (*piRunModeFinalStage)(void *pvProperties, char *pcError);
@@ -667,6 +880,7 @@ typedef struct _FTIMES_PROPERTIES
   unsigned long       ulFileSizeLimit;
 #ifdef USE_XMAGIC
   XMAGIC             *psXMagic;
+  XMAGIC_CACHE       *psXMagicCache;
 #endif
   OPTIONS_CONTEXT    *psOptionsContext;
 #ifdef USE_EMBEDDED_PERL
@@ -707,6 +921,9 @@ int                 AnalyzeGetStepSize(void);
 #endif
 unsigned char      *AnalyzeGetWorkBuffer(int iBlockSize, char *pcError);
 void               *AnalyzeMapMemory(int iMemoryMapSize);
+#if defined(USE_XMAGIC) && defined(HAVE_PREAD)
+unsigned char      *AnalyzeReadXMagicWindow(unsigned char *pucBlock, int iBlockLength, int iWindowSize, int *piWindowLength, char *pcError);
+#endif
 void                AnalyzeSetBlockSize(int iBlockSize);
 void                AnalyzeSetCarrySize(int iCarrySize);
 #ifdef USE_XMAGIC
@@ -733,12 +950,25 @@ int                 CompareEnumerateChanges(SNAPSHOT_CONTEXT *psBaseline, SNAPSH
  *
  ***********************************************************************
  */
+#ifdef UNIX
+int                 DevelopBinaryOutput(void *pvProperties, char *pcOutData, int *iWriteCount, FTIMES_FILE_DATA *psFTFileData, char *pcError);
+int                 DevelopPutVarint(unsigned char *pucData, APP_UI64 ui64Value);
+#endif
 int                 DevelopHaveNothingOutput(void *pvProperties, char *pcOutData, int *iWriteCount, FTIMES_FILE_DATA *psFTFileData, char *pcError);
 int                 DevelopNoOutput(void *pvProperties, char *pcOutData, int *iWriteCount, FTIMES_FILE_DATA *psFTFileData, char *pcError);
 int                 DevelopNormalOutput(void *pvProperties, char *pcOutData, int *iWriteCount, FTIMES_FILE_DATA *psFTFileData, char *pcError);
 int                 DevelopCompressedOutput(void *pvProperties, char *pcOutData, int *iWriteCount, FTIMES_FILE_DATA *psFTFileData, char *pcError);
 int                 DevelopCompressHex(char *pcData, unsigned long ulHex, unsigned long ulOldHex);
 int                 DevelopCountHexDigits(unsigned long ulHex);
+int                 DevelopFormatBase64(char *pcData, unsigned char *pucBytes, int iLength);
+int                 DevelopFormatDecimal(char *pcData, APP_UI64 ui64Value);
+int                 DevelopFormatHex(char *pcData, APP_UI64 ui64Value);
+int                 DevelopFormatHexBytes(char *pcData, unsigned char *pucBytes, int iLength);
+int                 DevelopFormatOctal(char *pcData, APP_UI64 ui64Value);
+int                 DevelopFormatString(char *pcData, char *pcString);
+#ifdef UNIX
+int                 DevelopFormatTime(time_t *pTimeValue, char *pcTime);
+#endif
 
 /*-
  ***********************************************************************
@@ -840,7 +1070,7 @@ int                 DigWriteHeader(FTIMES_PROPERTIES *psProperties, char *pcErro
  */
 #ifdef USE_KLEL_FILTERS
 void                FilterApplyFilters(FTIMES_PROPERTIES *psProperties, FTIMES_FILE_DATA *psFTFileData, int iFilterWhen);
-FILTER_LIST_KLEL   *FilterMatchFilter(FILTER_LIST_KLEL *psFilterList, FTIMES_FILE_DATA *psFTFileData, int iFilterWhen);
+FILTER_LIST_KLEL   *FilterMatchFilter(FILTER_LIST_KLEL *psFilterList, FTIMES_FILE_DATA *psFTFileData, int iFilterSince, int iFilterWhen);
 #endif
 
 /*-
@@ -865,27 +1095,50 @@ HOOK_LIST          *HookMatchHook(HOOK_LIST *psHookList, FTIMES_FILE_DATA *psFTF
 void                MapFreePythonArguments(size_t szArgumentCount, wchar_t **ppwcArgumentVector);
 wchar_t           **MapConvertPythonArguments(size_t tArgumentCount, char **ppcArgumentVector);
 #endif
+#ifdef USE_FILE_HOOKS
+void                MapCloseHookDescriptors(FTIMES_PROPERTIES *psProperties);
+void                MapCloseHookInterpreters(FTIMES_PROPERTIES *psProperties);
+#endif
 void                MapDirHashAlpha(FTIMES_PROPERTIES *psProperties, FTIMES_HASH_DATA *psFTHashData);
 void                MapDirHashCycle(FTIMES_PROPERTIES *psProperties, FTIMES_HASH_DATA *psFTHashData, FTIMES_FILE_DATA *psFTFileData);
 void                MapDirHashOmega(FTIMES_PROPERTIES *psProperties, FTIMES_HASH_DATA *psFTHashData, FTIMES_FILE_DATA *psFTFileData);
 char               *MapDirname(char *pcPath);
 #ifdef USE_FILE_HOOKS
+int                 MapDispatchHook(FTIMES_PROPERTIES *psProperties, HOOK_LIST *psHook, FTIMES_FILE_DATA *psFTFileData, char *pcError);
 int                 MapExecuteHook(FTIMES_PROPERTIES *psProperties, FTIMES_FILE_DATA *psFTFileData, char *pcError);
 #ifdef USE_EMBEDDED_PYTHON
-int                 MapExecutePythonScript(FTIMES_PROPERTIES *psProperties, HOOK_LIST *psHook, KLEL_COMMAND *psCommand, FTIMES_FILE_DATA *psFTFileData, char *pcMessage);
+int                 MapExecutePythonScript(FTIMES_PROPERTIES *psProperties, HOOK_LIST *psHook, KLEL_COMMAND *psCommand, char *pcNeuteredPath, char *pcMessage);
 #endif
 #endif
 int                 MapFile(FTIMES_PROPERTIES *psProperties, char *pcPath, char *pcError);
+#ifdef USE_FILE_HOOKS
+int                 MapFinishHookJob(FTIMES_PROPERTIES *psProperties, HOOK_WORKER *psWorker, int iReturn, int iCheckReturn, char *pcError);
+#endif
 void                MapFreeFTFileData(FTIMES_FILE_DATA *psFTFileData);
 unsigned long       MapGetAttributes(FTIMES_FILE_DATA *psFTFileData);
 int                 MapGetDirectoryCount(void);
 int                 MapGetFileCount(void);
+#ifdef USE_FILE_HOOKS
+int                 MapGetHookJobCount(FTIMES_PROPERTIES *psProperties);
+HOOK_WORKER        *MapGetHookWorker(FTIMES_PROPERTIES *psProperties, int iEmbedded);
+#endif
 int                 MapGetIncompleteRecordCount(void);
 int                 MapGetRecordCount(void);
 int                 MapGetSpecialCount(void);
 #ifndef WINNT
 FTIMES_FILE_DATA   *MapNewFTFileData(FTIMES_FILE_DATA *psParentFTFileData, char *pcName, char *pcError);
 #endif
+#ifdef USE_FILE_HOOKS
+int                 MapPollHookWorkers(FTIMES_PROPERTIES *psProperties, int iWait, char *pcError);
+int                 MapReadHookOutput(FTIMES_PROPERTIES *psProperties, HOOK_WORKER *psWorker, int iFd, char *pcError);
+int                 MapReleaseHookJobs(FTIMES_PROPERTIES *psProperties, char *pcError);
+int                 MapRunHookCommand(FTIMES_PROPERTIES *psProperties, HOOK_LIST *psHook, KLEL_COMMAND *psCommand, char *pcNeuteredPath);
+void                MapServeHookWorker(FTIMES_PROPERTIES *psProperties, HOOK_WORKER *psWorker);
+int                 MapStartHookKid(FTIMES_PROPERTIES *psProperties, HOOK_WORKER *psWorker, HOOK_LIST *psHook, KLEL_COMMAND *psCommand, char *pcNeuteredPath, char *pcError);
+int                 MapStartHookWorker(FTIMES_PROPERTIES *psProperties, HOOK_WORKER *psWorker, char *pcError);
+void                MapStopHookWorker(HOOK_WORKER *psWorker, int iSignal);
+void                MapStopHookWorkers(FTIMES_PROPERTIES *psProperties);
+#endif
 int                 MapTree(FTIMES_PROPERTIES *psProperties, FTIMES_FILE_DATA *psParentFTData, char *pcError);
 int                 MapWriteHeader(FTIMES_PROPERTIES *psProperties, char *pcError);
 int                 MapWriteRecord(FTIMES_PROPERTIES *psProperties, FTIMES_FILE_DATA *psFTFileData, char *pcError);
@@ -920,6 +1173,7 @@ int                 PropertiesTestFile(void *pvProperties, char *pcError);
  */
 FILE_LIST          *SupportAddListItem(FILE_LIST *psItem, FILE_LIST *psHead, char *pcError);
 int                 SupportAddToList(char *pcPath, FILE_LIST **ppList, char *pcListName, char *pcError);
+int                 SupportAddToTrie(FILE_TRIE *psRoot, FILE_LIST *psItem, char *pcError);
 #ifdef WIN32
 BOOL                SupportAdjustPrivileges(LPCTSTR lpcPrivilege);
 #endif
@@ -934,16 +1188,23 @@ int                 SupportExpandDirectoryPath(char *pcPath, char *pcFullPath, i
 int                 SupportExpandPath(char *pcPath, char *pcFullPath, int iFullPathSize, int iForceExpansion, char *pcError);
 void                SupportFreeData(void *pcData);
 void                SupportFreeListItem(FILE_LIST *psItem);
+void                SupportFreeTrie(FILE_TRIE *psNode);
 FILE               *SupportGetFileHandle(char *pcFile, char *pcError);
 int                 SupportGetFileType(char *pcPath, char *pcError);
 char               *SupportGetHostname(void);
 char               *SupportGetSystemOS(void);
+FILE_TRIE          *SupportGetTrieChild(FILE_TRIE *psNode, char *pcName, int iLength, int *piIndex);
+char               *SupportGetTrieTail(char *pcPath);
 FILE_LIST          *SupportIncludeEverything(char *pcError);
 int                 SupportMakeName(char *pcPath, char *pcBaseName, char *pcBaseNameSuffix, char *pcExtension, char *pcFilename, char *pcError);
 FILE_LIST          *SupportMatchExclude(FILE_LIST *psHead, char *pcPath);
-FILE_LIST          *SupportMatchSubTree(FILE_LIST *psHead, FILE_LIST *psTarget);
+FILE_LIST          *SupportMatchSubTree(FILE_TRIE *psRoot, FILE_LIST *psTarget);
+FILE_LIST          *SupportMatchTrie(FILE_TRIE *psRoot, char *pcPath);
 char               *SupportNeuterString(char *pcData, int iLength, char *pcError);
+int                 SupportNeuterStringToBuffer(char *pcData, int iLength, char *pcNeutered);
 FILE_LIST          *SupportNewListItem(char *pcPath, int iType, char *pcError);
+FILE_TRIE          *SupportNewTrie(FILE_LIST *psHead, char *pcError);
+FILE_TRIE          *SupportNewTrieNode(char *pcName, int iLength, char *pcError);
 FILE_LIST          *SupportPruneList(FILE_LIST *psList, char *pcListName);
 int                 SupportRequirePrivilege(char *pcError);
 int                 SupportSetLogLevel(char *pcLevel, int *piLevel, char *pcError);
@@ -952,13 +1213,25 @@ int                 SupportSetPriority(FTIMES_PROPERTIES *psProperties, char *pc
 int                 SupportSetPrivileges(char *pcError);
 #endif
 int                 SupportStringToUInt64(char *pcData, APP_UI64 *pui64Value, char *pcError);
+int                 SupportWriteBufferedData(FILE *pFile, char *pcData, int iLength, char *pcError);
 int                 SupportWriteData(FILE *pFile, char *pcData, int iLength, char *pcError);
 
 #ifdef USE_PCRE
+int                 SupportAddDigestFilter(char *pcFilter, int iDigestSize, FILTER_LIST **ppsList, FILTER_DIGEST_SET **ppsSet, char *pcError);
 int                 SupportAddFilter(char *pcFilter, FILTER_LIST **psHead, char *pcError);
+FILTER_UNION       *SupportCombineFilters(FILTER_LIST **ppsFilters, int iCount, char *pcError);
+int                 SupportCompareDigests(const void *pvDigest1, const void *pvDigest2);
 void                SupportFreeFilter(FILTER_LIST *psFilter);
+void                SupportFreeFilterUnion(FILTER_UNION *psUnion);
+int                 SupportIsCombinableFilter(char *pcFilter);
+int                 SupportMatchDigestSet(FILTER_DIGEST_SET *psSet, unsigned char *pucDigest);
+char               *SupportMatchDigestSets(FTIMES_PROPERTIES *psProperties, FTIMES_FILE_DATA *psFTFileData, int iInclude, char *pcHexDigest);
 FILTER_LIST        *SupportMatchFilter(FILTER_LIST *psFilterList, char *acPath);
+FILTER_LIST        *SupportMatchFilterUnion(FILTER_UNION *psUnion, char *pcPath);
 FILTER_LIST        *SupportNewFilter(char *pcFilter, char *pcError);
+FILTER_UNION       *SupportNewFilterUnion(FILTER_LIST *psFilterList, char *pcError);
+int                 SupportSortDigestSet(FILTER_DIGEST_SET *psSet, char *pcError);
+int                 SupportSortDigestSets(FTIMES_PROPERTIES *psProperties, char *pcError);
 #endif
 
 /*-
@@ -989,6 +1262,17 @@ int                 TimeFormatTime(time_t *pTimeValue, char *pcTime);
 int                 URLGetRequest(FTIMES_PROPERTIES *psProperties, char *pcError);
 int                 URLPingRequest(FTIMES_PROPERTIES *psProperties, char *pcError);
 int                 URLPutRequest(FTIMES_PROPERTIES *psProperties, char *pcError);
+#ifdef USE_URL_STREAM
+int                 URLCloseStream(void *pvStream);
+int                 URLFinishStream(FTIMES_PROPERTIES *psProperties, char *pcError);
+void                URLFlushStream(URL_PUT_STREAM *psStream);
+void                URLFreeStream(URL_PUT_STREAM *psStream);
+FILE               *URLNewStream(FTIMES_PROPERTIES *psProperties, FILE *pSinkFile, char *pcError);
+int                 URLPutStreamRequest(FTIMES_PROPERTIES *psProperties, char *pcError);
+int                 URLSendData(URL_PUT_STREAM *psStream, char *pcData, int iLength, int iFlush, char *pcError);
+void               *URLSendWorker(void *pvStream);
+URL_STREAM_IO_RESULT URLWriteStream(void *pvStream, const char *pcData, URL_STREAM_IO_LENGTH iLength);
+#endif
 
 /*-
  ***********************************************************************
@@ -0,0 +1,571 @@
+/*-
+ ***********************************************************************
+ *
+ * $Id: gzip.c,v 1.1 2019/09/03 17:42:11 klm Exp $
+ *
+ ***********************************************************************
+ *
+ * Copyright 2019-2019 The FTimes Project, All Rights Reserved.
+ *
+ ***********************************************************************
+ */
+#ifdef __linux__
+#define _GNU_SOURCE /* NOTE: This is required for fopencookie(). */
+#endif
+#include "all-includes.h"
+
+/*-
+ ***********************************************************************
+ *
+ * GzipCloseReadStream
+ *
+ ***********************************************************************
+ */
+int
+GzipCloseReadStream(void *pvStream)
+{
+  GZIP_STREAM        *psStream = (GZIP_STREAM *)pvStream;
+
+  inflateEnd(&psStream->sZStream);
+  if (psStream->pFile != stdin)
+  {
+    fclose(psStream->pFile);
+  }
+  GzipFreeStream(psStream);
+
+  return 0;
+}
+
+
+/*-
+ ***********************************************************************
+ *
+ * GzipCloseWriteStream
+ *
+ ***********************************************************************
+ */
+int
+GzipCloseWriteStream(void *pvStream)
+{
+  GZIP_STREAM        *psStream = (GZIP_STREAM *)pvStream;
+  int                 iError = 0;
+
+  /*-
+   *********************************************************************
+   *
+   * A forked child inherits a copy of this stream, but the worker
+   * thread and the sink belong to the parent. Leave them alone.
+   *
+   *********************************************************************
+   */
+  if (getpid() != psStream->tOwner)
+  {
+    return 0;
+  }
+
+  /*-
+   *********************************************************************
+   *
+   * Hand off the final (possibly empty) buffer, wait for the worker
+   * to write the gzip trailer, and then close the sink.
+   *
+   *********************************************************************
+   */
+  GzipSubmitBuffer(psStream, 1);
+  pthread_join(psStream->tThread, NULL);
+  deflateEnd(&psStream->sZStream);
+  if (psStream->iError)
+  {
+    iError = EIO;
+  }
+  if (psStream->pFile == stdout)
+  {
+    if (fflush(psStream->pFile) != 0 && iError == 0)
+    {
+      iError = errno;
+    }
+  }
+  else
+  {
+    if (fclose(psStream->pFile) != 0 && iError == 0)
+    {
+      iError = errno;
+    }
+  }
+  pthread_cond_destroy(&psStream->sCondition);
+  pthread_mutex_destroy(&psStream->sMutex);
+  GzipFreeStream(psStream);
+
+  if (iError)
+  {
+    errno = iError;
+    return -1;
+  }
+
+  return 0;
+}
+
+
+/*-
+ ***********************************************************************
+ *
+ * GzipDeflateBuffer
+ *
+ ***********************************************************************
+ */
+int
+GzipDeflateBuffer(GZIP_STREAM *psStream, unsigned char *pucData, int iLength, int iFlush)
+{
+  int                 iCount;
+  int                 iStatus;
+
+  psStream->sZStream.next_in = pucData;
+  psStream->sZStream.avail_in = iLength;
+  do
+  {
+    psStream->sZStream.next_out = psStream->pucOutput;
+    psStream->sZStream.avail_out = GZIP_BUFFER_SIZE;
+    iStatus = deflate(&psStream->sZStream, iFlush);
+    if (iStatus == Z_STREAM_ERROR)
+    {
+      return ER;
+    }
+    iCount = GZIP_BUFFER_SIZE - psStream->sZStream.avail_out;
+    if (iCount > 0 && fwrite(psStream->pucOutput, 1, iCount, psStream->pFile) != (size_t) iCount)
+    {
+      return ER;
+    }
+  } while (psStream->sZStream.avail_out == 0);
+
+  return ER_OK;
+}
+
+
+/*-
+ ***********************************************************************
+ *
+ * GzipFreeStream
+ *
+ ***********************************************************************
+ */
+void
+GzipFreeStream(GZIP_STREAM *psStream)
+{
+  if (psStream != NULL)
+  {
+    if (psStream->apucBuffers[0] != NULL)
+    {
+      free(psStream->apucBuffers[0]);
+    }
+    if (psStream->apucBuffers[1] != NULL)
+    {
+      free(psStream->apucBuffers[1]);
+    }
+    if (psStream->pucOutput != NULL)
+    {
+      free(psStream->pucOutput);
+    }
+    free(psStream);
+  }
+}
+
+
+/*-
+ ***********************************************************************
+ *
+ * GzipNewReadStream
+ *
+ ***********************************************************************
+ */
+FILE *
+GzipNewReadStream(FILE *pSourceFile, char *pcError)
+{
+  const char          acRoutine[] = "GzipNewReadStream()";
+  char                acLocalError[MESSAGE_SIZE] = "";
+  FILE               *pFile = NULL;
+  GZIP_STREAM        *psStream = NULL;
+
+  psStream = GzipNewStream(pSourceFile, acLocalError);
+  if (psStream == NULL)
+  {
+    snprintf(pcError, MESSAGE_SIZE, "%s: %s", acRoutine, acLocalError);
+    return NULL;
+  }
+
+  psStream->apucBuffers[0] = malloc(GZIP_BUFFER_SIZE);
+  if (psStream->apucBuffers[0] == NULL)
+  {
+    snprintf(pcError, MESSAGE_SIZE, "%s: malloc(): %s", acRoutine, strerror(errno));
+    GzipFreeStream(psStream);
+    return NULL;
+  }
+
+  if (inflateInit2(&psStream->sZStream, GZIP_WINDOW_BITS_AUTO) != Z_OK)
+  {
+    snprintf(pcError, MESSAGE_SIZE, "%s: inflateInit2(): %s", acRoutine, (psStream->sZStream.msg) ? psStream->sZStream.msg : "Unable to initialize decompressor.");
+    GzipFreeStream(psStream);
+    return NULL;
+  }
+
+  pFile = GzipOpenStream(psStream, 0);
+  if (pFile == NULL)
+  {
+    snprintf(pcError, MESSAGE_SIZE, "%s: GzipOpenStream(): %s", acRoutine, strerror(errno));
+    inflateEnd(&psStream->sZStream);
+    GzipFreeStream(psStream);
+    return NULL;
+  }
+
+  return pFile;
+}
+
+
+/*-
+ ***********************************************************************
+ *
+ * GzipNewStream
+ *
+ ***********************************************************************
+ */
+GZIP_STREAM *
+GzipNewStream(FILE *pFile, char *pcError)
+{
+  const char          acRoutine[] = "GzipNewStream()";
+  GZIP_STREAM        *psStream = NULL;
+
+  psStream = (GZIP_STREAM *) calloc(sizeof(GZIP_STREAM), 1);
+  if (psStream == NULL)
+  {
+    snprintf(pcError, MESSAGE_SIZE, "%s: calloc(): %s", acRoutine, strerror(errno));
+    return NULL;
+  }
+  psStream->pFile = pFile;
+  psStream->tOwner = getpid();
+
+  return psStream;
+}
+
+
+/*-
+ ***********************************************************************
+ *
+ * GzipNewWriteStream
+ *
+ ***********************************************************************
+ */
+FILE *
+GzipNewWriteStream(FILE *pSinkFile, int iLevel, char *pcError)
+{
+  const char          acRoutine[] = "GzipNewWriteStream()";
+  char                acLocalError[MESSAGE_SIZE] = "";
+  FILE               *pFile = NULL;
+  GZIP_STREAM        *psStream = NULL;
+  int                 iError;
+  sigset_t            sAllSignals;
+  sigset_t            sOldSignals;
+
+  psStream = GzipNewStream(pSinkFile, acLocalError);
+  if (psStream == NULL)
+  {
+    snprintf(pcError, MESSAGE_SIZE, "%s: %s", acRoutine, acLocalError);
+    return NULL;
+  }
+
+  psStream->apucBuffers[0] = malloc(GZIP_BUFFER_SIZE);
+  psStream->apucBuffers[1] = malloc(GZIP_BUFFER_SIZE);
+  psStream->pucOutput = malloc(GZIP_BUFFER_SIZE);
+  if (psStream->apucBuffers[0] == NULL || psStream->apucBuffers[1] == NULL || psStream->pucOutput == NULL)
+  {
+    snprintf(pcError, MESSAGE_SIZE, "%s: malloc(): %s", acRoutine, strerror(errno));
+    GzipFreeStream(psStream);
+    return NULL;
+  }
+
+  if (deflateInit2(&psStream->sZStream, iLevel, Z_DEFLATED, GZIP_WINDOW_BITS_GZIP, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+  {
+    snprintf(pcError, MESSAGE_SIZE, "%s: deflateInit2(): %s", acRoutine, (psStream->sZStream.msg) ? psStream->sZStream.msg : "Unable to initialize compressor.");
+    GzipFreeStream(psStream);
+    return NULL;
+  }
+
+  pthread_mutex_init(&psStream->sMutex, NULL);
+  pthread_cond_init(&psStream->sCondition, NULL);
+
+  /*-
+   *********************************************************************
+   *
+   * Start the worker with all signals blocked. Signal handlers (e.g.,
+   * hook timeouts) expect to run on the main thread.
+   *
+   *********************************************************************
+   */
+  sigfillset(&sAllSignals);
+  pthread_sigmask(SIG_BLOCK, &sAllSignals, &sOldSignals);
+  iError = pthread_create(&psStream->tThread, NULL, GzipWriteWorker, psStream);
+  pthread_sigmask(SIG_SETMASK, &sOldSignals, NULL);
+  if (iError != 0)
+  {
+    snprintf(pcError, MESSAGE_SIZE, "%s: pthread_create(): %s", acRoutine, strerror(iError));
+    pthread_cond_destroy(&psStream->sCondition);
+    pthread_mutex_destroy(&psStream->sMutex);
+    deflateEnd(&psStream->sZStream);
+    GzipFreeStream(psStream);
+    return NULL;
+  }
+
+  pFile = GzipOpenStream(psStream, 1);
+  if (pFile == NULL)
+  {
+    snprintf(pcError, MESSAGE_SIZE, "%s: GzipOpenStream(): %s", acRoutine, strerror(errno));
+    pthread_mutex_lock(&psStream->sMutex);
+    psStream->iError = 1; /* Prevent the worker from writing to the sink. */
+    pthread_mutex_unlock(&psStream->sMutex);
+    GzipSubmitBuffer(psStream, 1);
+    pthread_join(psStream->tThread, NULL);
+    pthread_cond_destroy(&psStream->sCondition);
+    pthread_mutex_destroy(&psStream->sMutex);
+    deflateEnd(&psStream->sZStream);
+    GzipFreeStream(psStream);
+    return NULL;
+  }
+  setvbuf(pFile, NULL, _IOFBF, 0);
+
+  return pFile;
+}
+
+
+/*-
+ ***********************************************************************
+ *
+ * GzipOpenStream
+ *
+ ***********************************************************************
+ */
+FILE *
+GzipOpenStream(GZIP_STREAM *psStream, int iWrite)
+{
+#ifdef HAVE_FOPENCOOKIE
+  cookie_io_functions_t sFunctions;
+
+  memset(&sFunctions, 0, sizeof(sFunctions));
+  if (iWrite)
+  {
+    sFunctions.write = GzipWriteStream;
+    sFunctions.close = GzipCloseWriteStream;
+  }
+  else
+  {
+    sFunctions.read = GzipReadStream;
+    sFunctions.close = GzipCloseReadStream;
+  }
+  return fopencookie(psStream, (iWrite) ? "w" : "r", sFunctions);
+#else
+  if (iWrite)
+  {
+    return funopen(psStream, NULL, GzipWriteStream, NULL, GzipCloseWriteStream);
+  }
+  return funopen(psStream, GzipReadStream, NULL, NULL, GzipCloseReadStream);
+#endif
+}
+
+
+/*-
+ ***********************************************************************
+ *
+ * GzipReadStream
+ *
+ ***********************************************************************
+ */
+GZIP_IO_RESULT
+GzipReadStream(void *pvStream, char *pcData, GZIP_IO_LENGTH iLength)
+{
+  GZIP_STREAM        *psStream = (GZIP_STREAM *)pvStream;
+  size_t              iNRead;
+  int                 iStatus;
+
+  if (psStream->iError)
+  {
+    errno = EIO;
+    return -1;
+  }
+
+  psStream->sZStream.next_out = (unsigned char *) pcData;
+  psStream->sZStream.avail_out = iLength;
+  while (psStream->sZStream.avail_out > 0 && !psStream->iFinish)
+  {
+    if (psStream->sZStream.avail_in == 0)
+    {
+      iNRead = fread(psStream->apucBuffers[0], 1, GZIP_BUFFER_SIZE, psStream->pFile);
+      if (iNRead == 0)
+      {
+        if (ferror(psStream->pFile) || !psStream->iMemberDone)
+        {
+          psStream->iError = 1; /* Read error or truncated stream. */
+          break;
+        }
+        psStream->iFinish = 1;
+        break;
+      }
+      psStream->sZStream.next_in = psStream->apucBuffers[0];
+      psStream->sZStream.avail_in = iNRead;
+    }
+    psStream->iMemberDone = 0;
+    iStatus = inflate(&psStream->sZStream, Z_NO_FLUSH);
+    if (iStatus == Z_STREAM_END)
+    {
+      /*-
+       *****************************************************************
+       *
+       * Keep going in case there are concatenated members.
+       *
+       *****************************************************************
+       */
+      psStream->iMemberDone = 1;
+      inflateReset(&psStream->sZStream);
+    }
+    else if (iStatus != Z_OK && iStatus != Z_BUF_ERROR)
+    {
+      psStream->iError = 1;
+      break;
+    }
+  }
+
+  if (psStream->iError && psStream->sZStream.avail_out == iLength)
+  {
+    errno = EIO;
+    return -1;
+  }
+
+  return iLength - psStream->sZStream.avail_out;
+}
+
+
+/*-
+ ***********************************************************************
+ *
+ * GzipSubmitBuffer
+ *
+ ***********************************************************************
+ */
+int
+GzipSubmitBuffer(GZIP_STREAM *psStream, int iFinish)
+{
+  int                 iError;
+
+  pthread_mutex_lock(&psStream->sMutex);
+  while (psStream->iPending)
+  {
+    pthread_cond_wait(&psStream->sCondition, &psStream->sMutex);
+  }
+  psStream->iPending = 1;
+  psStream->iPendingIndex = psStream->iFill;
+  psStream->iPendingLength = psStream->iFillLength;
+  psStream->iFinish = iFinish;
+  iError = psStream->iError;
+  pthread_cond_signal(&psStream->sCondition);
+  pthread_mutex_unlock(&psStream->sMutex);
+
+  psStream->iFill ^= 1;
+  psStream->iFillLength = 0;
+
+  return (iError) ? ER : ER_OK;
+}
+
+
+/*-
+ ***********************************************************************
+ *
+ * GzipWriteStream
+ *
+ ***********************************************************************
+ */
+GZIP_IO_RESULT
+GzipWriteStream(void *pvStream, const char *pcData, GZIP_IO_LENGTH iLength)
+{
+  GZIP_STREAM        *psStream = (GZIP_STREAM *)pvStream;
+  GZIP_IO_LENGTH      iCount;
+  GZIP_IO_LENGTH      iDone;
+
+  /*-
+   *********************************************************************
+   *
+   * Discard data flushed by a forked child. See GzipCloseWriteStream.
+   *
+   *********************************************************************
+   */
+  if (getpid() != psStream->tOwner)
+  {
+    return iLength;
+  }
+
+  for (iDone = 0; iDone < iLength; iDone += iCount)
+  {
+    iCount = GZIP_BUFFER_SIZE - psStream->iFillLength;
+    if (iCount > iLength - iDone)
+    {
+      iCount = iLength - iDone;
+    }
+    memcpy(&psStream->apucBuffers[psStream->iFill][psStream->iFillLength], &pcData[iDone], iCount);
+    psStream->iFillLength += iCount;
+    if (psStream->iFillLength == GZIP_BUFFER_SIZE && GzipSubmitBuffer(psStream, 0) != ER_OK)
+    {
+      errno = EIO;
+      return -1;
+    }
+  }
+
+  return iLength;
+}
+
+
+/*-
+ ***********************************************************************
+ *
+ * GzipWriteWorker
+ *
+ ***********************************************************************
+ */
+void *
+GzipWriteWorker(void *pvStream)
+{
+  GZIP_STREAM        *psStream = (GZIP_STREAM *)pvStream;
+  int                 iError;
+  int                 iFinish;
+  int                 iIndex;
+  int                 iLength;
+
+  do
+  {
+    pthread_mutex_lock(&psStream->sMutex);
+    while (!psStream->iPending)
+    {
+      pthread_cond_wait(&psStream->sCondition, &psStream->sMutex);
+    }
+    iIndex = psStream->iPendingIndex;
+    iLength = psStream->iPendingLength;
+    iFinish = psStream->iFinish;
+    iError = psStream->iError;
+    pthread_mutex_unlock(&psStream->sMutex);
+
+    /*-
+     *******************************************************************
+     *
+     * After an error, keep draining buffers so that the main thread
+     * never blocks, but stop writing to the sink.
+     *
+     *******************************************************************
+     */
+    if (!iError)
+    {
+      iError = (GzipDeflateBuffer(psStream, psStream->apucBuffers[iIndex], iLength, (iFinish) ? Z_FINISH : Z_NO_FLUSH) == ER_OK) ? 0 : 1;
+    }
+
+    pthread_mutex_lock(&psStream->sMutex);
+    psStream->iPending = 0;
+    psStream->iError = iError;
+    pthread_cond_signal(&psStream->sCondition);
+    pthread_mutex_unlock(&psStream->sMutex);
+  } while (!iFinish);
+
+  return NULL;
+}
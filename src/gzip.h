@@ -0,0 +1,88 @@
+/*-
+ ***********************************************************************
+ *
+ * $Id: gzip.h,v 1.1 2019/09/03 17:42:11 klm Exp $
+ *
+ ***********************************************************************
+ *
+ * Copyright 2019-2019 The FTimes Project, All Rights Reserved.
+ *
+ ***********************************************************************
+ */
+#ifndef _GZIP_H_INCLUDED
+#define _GZIP_H_INCLUDED
+
+#include <zlib.h>
+
+/*-
+ ***********************************************************************
+ *
+ * Defines
+ *
+ ***********************************************************************
+ */
+#ifndef MESSAGE_SIZE
+#define MESSAGE_SIZE 1024
+#endif
+
+#define GZIP_BUFFER_SIZE             0x40000
+#define GZIP_MAGIC_BYTE                 0x1f
+#define GZIP_WINDOW_BITS_AUTO      (15 + 32)
+#define GZIP_WINDOW_BITS_GZIP      (15 + 16)
+
+#ifdef HAVE_FOPENCOOKIE
+#define GZIP_IO_LENGTH size_t
+#define GZIP_IO_RESULT ssize_t
+#else
+#define GZIP_IO_LENGTH int
+#define GZIP_IO_RESULT int
+#endif
+
+/*-
+ ***********************************************************************
+ *
+ * Typedefs
+ *
+ ***********************************************************************
+ */
+typedef struct _GZIP_STREAM
+{
+  FILE               *pFile;
+  int                 iError;
+  int                 iFinish;
+  int                 iFill;
+  int                 iFillLength;
+  int                 iMemberDone;
+  int                 iPending;
+  int                 iPendingIndex;
+  int                 iPendingLength;
+  pid_t               tOwner;
+  pthread_cond_t      sCondition;
+  pthread_mutex_t     sMutex;
+  pthread_t           tThread;
+  unsigned char      *apucBuffers[2];
+  unsigned char      *pucOutput;
+  z_stream            sZStream;
+} GZIP_STREAM;
+
+/*-
+ ***********************************************************************
+ *
+ * Function Prototypes
+ *
+ ***********************************************************************
+ */
+int                   GzipCloseReadStream(void *pvStream);
+int                   GzipCloseWriteStream(void *pvStream);
+int                   GzipDeflateBuffer(GZIP_STREAM *psStream, unsigned char *pucData, int iLength, int iFlush);
+void                  GzipFreeStream(GZIP_STREAM *psStream);
+FILE                 *GzipNewReadStream(FILE *pSourceFile, char *pcError);
+GZIP_STREAM          *GzipNewStream(FILE *pFile, char *pcError);
+FILE                 *GzipNewWriteStream(FILE *pSinkFile, int iLevel, char *pcError);
+FILE                 *GzipOpenStream(GZIP_STREAM *psStream, int iWrite);
+GZIP_IO_RESULT        GzipReadStream(void *pvStream, char *pcData, GZIP_IO_LENGTH iLength);
+int                   GzipSubmitBuffer(GZIP_STREAM *psStream, int iFinish);
+void                 *GzipWriteWorker(void *pvStream);
+GZIP_IO_RESULT        GzipWriteStream(void *pvStream, const char *pcData, GZIP_IO_LENGTH iLength);
+
+#endif /* !_GZIP_H_INCLUDED */
@@ -77,6 +77,40 @@ HookAddHook(char *pcExpression, HOOK_LIST **psHead, char *pcError)
 }
 
 
+/*-
+ ***********************************************************************
+ *
+ * HookFreeCommand
+ *
+ ***********************************************************************
+ */
+void
+HookFreeCommand(KLEL_COMMAND *psCommand)
+{
+  size_t              szArgument = 0;
+
+  /*-
+   *********************************************************************
+   *
+   * This is only meant for commands created by HookReadCommand(). Use
+   * KlelFreeCommand() for commands produced by KLEL.
+   *
+   *********************************************************************
+   */
+  if (psCommand != NULL)
+  {
+    for (szArgument = 0; szArgument < psCommand->szArgumentCount; szArgument++)
+    {
+      if (psCommand->ppcArgumentVector[szArgument] != NULL)
+      {
+        free(psCommand->ppcArgumentVector[szArgument]);
+      }
+    }
+    free(psCommand);
+  }
+}
+
+
 /*-
  ***********************************************************************
  *
@@ -563,6 +597,47 @@ HookGetValueOfVar(const char *pcName, void *pvContext)
 }
 
 
+/*-
+ ***********************************************************************
+ *
+ * HookIsEmbedded
+ *
+ ***********************************************************************
+ */
+int
+HookIsEmbedded(HOOK_LIST *psHook)
+{
+  /*-
+   *********************************************************************
+   *
+   * Hooks that run inside an embedded interpreter can be serviced by
+   * persistent workers. Those that exec another program can't.
+   *
+   *********************************************************************
+   */
+#ifdef USE_EMBEDDED_LUA
+  if (strcmp(psHook->pcInterpreter, "lua") == 0)
+  {
+    return 1;
+  }
+#endif
+#ifdef USE_EMBEDDED_PERL
+  if (strcmp(psHook->pcInterpreter, "perl") == 0)
+  {
+    return 1;
+  }
+#endif
+#ifdef USE_EMBEDDED_PYTHON
+  if (strcmp(psHook->pcInterpreter, "python") == 0)
+  {
+    return 1;
+  }
+#endif
+
+  return 0;
+}
+
+
 /*-
  ***********************************************************************
  *
@@ -784,6 +859,263 @@ HookNewHook(char *pcExpression, char *pcError)
 }
 
 
+/*-
+ ***********************************************************************
+ *
+ * HookReadCommand
+ *
+ ***********************************************************************
+ */
+int
+HookReadCommand(int iFd, int *piHookIndex, char **ppcNeuteredPath, KLEL_COMMAND **ppsCommand, char *pcError)
+{
+  const char          acRoutine[] = "HookReadCommand()";
+  char               *apcStrings[3 + KLEL_MAX_FUNC_ARGS] = { NULL };
+  int                 aiHeader[2] = { 0, 0 };
+  int                 i = 0;
+  int                 iLength = 0;
+  int                 iStringCount = 0;
+  KLEL_COMMAND       *psCommand = NULL;
+
+  /*-
+   *********************************************************************
+   *
+   * Read the header (hook index and argument count). End of file at
+   * this point is not an error -- it means the parent is done.
+   *
+   *********************************************************************
+   */
+  if (HookReadData(iFd, aiHeader, sizeof(aiHeader)) != ER_OK)
+  {
+    pcError[0] = 0;
+    return ER;
+  }
+  if (aiHeader[1] < 0 || aiHeader[1] > KLEL_MAX_FUNC_ARGS)
+  {
+    snprintf(pcError, MESSAGE_SIZE, "%s: Invalid argument count (%d).", acRoutine, aiHeader[1]);
+    return ER;
+  }
+
+  /*-
+   *********************************************************************
+   *
+   * Read the neutered path, interpreter, program, and arguments. Each
+   * string is preceded by its length.
+   *
+   *********************************************************************
+   */
+  iStringCount = 3 + aiHeader[1];
+  for (i = 0; i < iStringCount; i++)
+  {
+    if (HookReadData(iFd, &iLength, sizeof(iLength)) != ER_OK || iLength < 0)
+    {
+      snprintf(pcError, MESSAGE_SIZE, "%s: Truncated or invalid command.", acRoutine);
+      break;
+    }
+    apcStrings[i] = malloc(iLength + 1);
+    if (apcStrings[i] == NULL)
+    {
+      snprintf(pcError, MESSAGE_SIZE, "%s: malloc(): %s", acRoutine, strerror(errno));
+      break;
+    }
+    if (HookReadData(iFd, apcStrings[i], iLength) != ER_OK)
+    {
+      snprintf(pcError, MESSAGE_SIZE, "%s: Truncated command.", acRoutine);
+      i++;
+      break;
+    }
+    apcStrings[i][iLength] = 0;
+  }
+
+  psCommand = (i == iStringCount) ? calloc(sizeof(KLEL_COMMAND), 1) : NULL;
+  if (psCommand == NULL)
+  {
+    if (i == iStringCount)
+    {
+      snprintf(pcError, MESSAGE_SIZE, "%s: calloc(): %s", acRoutine, strerror(errno));
+    }
+    while (i > 0)
+    {
+      free(apcStrings[--i]);
+    }
+    return ER;
+  }
+
+  /*-
+   *********************************************************************
+   *
+   * Assemble the command. The caller should free it (and the neutered
+   * path) with HookFreeCommand() and free(), respectively.
+   *
+   *********************************************************************
+   */
+  snprintf(psCommand->acInterpreter, sizeof(psCommand->acInterpreter), "%s", apcStrings[1]);
+  snprintf(psCommand->acProgram, sizeof(psCommand->acProgram), "%s", apcStrings[2]);
+  free(apcStrings[1]);
+  free(apcStrings[2]);
+  psCommand->szArgumentCount = aiHeader[1];
+  for (i = 0; i < aiHeader[1]; i++)
+  {
+    psCommand->ppcArgumentVector[i] = apcStrings[3 + i];
+  }
+  psCommand->ppcArgumentVector[i] = NULL;
+  *piHookIndex = aiHeader[0];
+  *ppcNeuteredPath = apcStrings[0];
+  *ppsCommand = psCommand;
+
+  return ER_OK;
+}
+
+
+/*-
+ ***********************************************************************
+ *
+ * HookReadData
+ *
+ ***********************************************************************
+ */
+int
+HookReadData(int iFd, void *pvData, int iLength)
+{
+  char               *pcData = (char *)pvData;
+  int                 iNRead = 0;
+
+  while (iLength > 0)
+  {
+    iNRead = read(iFd, pcData, iLength);
+    if (iNRead < 0 && errno == EINTR)
+    {
+      continue;
+    }
+    if (iNRead <= 0)
+    {
+      return ER;
+    }
+    pcData += iNRead;
+    iLength -= iNRead;
+  }
+
+  return ER_OK;
+}
+
+
+/*-
+ ***********************************************************************
+ *
+ * HookWriteCommand
+ *
+ ***********************************************************************
+ */
+int
+HookWriteCommand(int iFd, int iHookIndex, char *pcNeuteredPath, KLEL_COMMAND *psCommand, char *pcError)
+{
+  const char          acRoutine[] = "HookWriteCommand()";
+  char               *apcStrings[3 + KLEL_MAX_FUNC_ARGS] = { NULL };
+  char               *pcMessage = NULL;
+  int                 aiHeader[2] = { 0, 0 };
+  int                 i = 0;
+  int                 iError = 0;
+  int                 iLength = 0;
+  int                 iOffset = 0;
+  int                 iSize = sizeof(aiHeader);
+  int                 iStringCount = 0;
+
+  /*-
+   *********************************************************************
+   *
+   * Marshall the command into a single message: a header (hook index
+   * and argument count) followed by the neutered path, interpreter,
+   * program, and arguments, each preceded by its length.
+   *
+   *********************************************************************
+   */
+  if (psCommand->szArgumentCount > KLEL_MAX_FUNC_ARGS)
+  {
+    snprintf(pcError, MESSAGE_SIZE, "%s: Invalid argument count (%d).", acRoutine, (int) psCommand->szArgumentCount);
+    return ER;
+  }
+  aiHeader[0] = iHookIndex;
+  aiHeader[1] = (int) psCommand->szArgumentCount;
+  apcStrings[0] = pcNeuteredPath;
+  apcStrings[1] = psCommand->acInterpreter;
+  apcStrings[2] = psCommand->acProgram;
+  for (i = 0; i < aiHeader[1]; i++)
+  {
+    apcStrings[3 + i] = (psCommand->ppcArgumentVector[i] != NULL) ? psCommand->ppcArgumentVector[i] : "";
+  }
+  iStringCount = 3 + aiHeader[1];
+  for (i = 0; i < iStringCount; i++)
+  {
+    iSize += sizeof(iLength) + strlen(apcStrings[i]);
+  }
+
+  pcMessage = malloc(iSize);
+  if (pcMessage == NULL)
+  {
+    snprintf(pcError, MESSAGE_SIZE, "%s: malloc(): %s", acRoutine, strerror(errno));
+    return ER;
+  }
+  memcpy(pcMessage, aiHeader, sizeof(aiHeader));
+  iOffset = sizeof(aiHeader);
+  for (i = 0; i < iStringCount; i++)
+  {
+    iLength = strlen(apcStrings[i]);
+    memcpy(&pcMessage[iOffset], &iLength, sizeof(iLength));
+    iOffset += sizeof(iLength);
+    memcpy(&pcMessage[iOffset], apcStrings[i], iLength);
+    iOffset += iLength;
+  }
+
+  /*-
+   *********************************************************************
+   *
+   * Send the message.
+   *
+   *********************************************************************
+   */
+  iError = HookWriteData(iFd, pcMessage, iSize);
+  if (iError != ER_OK)
+  {
+    snprintf(pcError, MESSAGE_SIZE, "%s: write(): %s", acRoutine, strerror(errno));
+  }
+  free(pcMessage);
+
+  return iError;
+}
+
+
+/*-
+ ***********************************************************************
+ *
+ * HookWriteData
+ *
+ ***********************************************************************
+ */
+int
+HookWriteData(int iFd, void *pvData, int iLength)
+{
+  char               *pcData = (char *)pvData;
+  int                 iNWritten = 0;
+
+  while (iLength > 0)
+  {
+    iNWritten = write(iFd, pcData, iLength);
+    if (iNWritten < 0 && errno == EINTR)
+    {
+      continue;
+    }
+    if (iNWritten <= 0)
+    {
+      return ER;
+    }
+    pcData += iNWritten;
+    iLength -= iNWritten;
+  }
+
+  return ER_OK;
+}
+
+
 #ifdef USE_EMBEDDED_PYTHON
 /*-
  ***********************************************************************
@@ -19,8 +19,9 @@
  *
  ***********************************************************************
  */
-
-/* Empty */
+#define HOOK_DEFAULT_WORKER_COUNT 1
+#define HOOK_MAX_WORKER_COUNT 64
+#define HOOK_OUTPUT_BUFFER_SIZE 8192
 
 /*-
  ***********************************************************************
@@ -43,6 +44,27 @@ typedef struct _HOOK_LIST
   struct _HOOK_LIST  *psNext;
 } HOOK_LIST;
 
+typedef struct _HOOK_WORKER
+{
+  APP_UI64            ui64Sequence;    /* Hook output is released in dispatch order. */
+  char               *pcNeuteredPath; /* This identifies the file whose hook is in flight. */
+  char               *pcOutput;       /* Stdout is held here until the hook completes. */
+  HOOK_LIST          *psHook;
+  int                 iBusy;
+  int                 iCheckReturn;
+  int                 iDone;           /* The hook has completed, but its output is waiting its turn. */
+  int                 iKidPid;
+  int                 iOneShot;        /* The kid runs one command and exits (i.e., exec and system hooks). */
+  int                 iOutputLength;
+  int                 iOutputSize;
+  int                 iRequestFd;      /* Hook commands are sent to the kid on this pipe. */
+  int                 iResponseFd;     /* Return codes are sent back to the parent on this pipe. */
+  int                 iReturn;
+  int                 iStderrFd;
+  int                 iStdoutFd;
+  time_t              tStartTime;
+} HOOK_WORKER;
+
 typedef struct _HOOK_TYPE_SPEC
 {
   const char         *pcName;
@@ -73,13 +95,19 @@ typedef struct _HOOK_FUNC_DESC
  ***********************************************************************
  */
 int                   HookAddHook(char *pcExpression, HOOK_LIST **psHead, char *pcError);
+void                  HookFreeCommand(KLEL_COMMAND *psCommand);
 void                  HookFreeHook(HOOK_LIST *psHook);
 KLEL_EXPR_TYPE        HookGetTypeOfVar(const char *pcName, void *pvContext);
 KLEL_VALUE           *HookGetValueOfVar(const char *pcName, void *pvContext);
+int                   HookIsEmbedded(HOOK_LIST *psHook);
 #ifdef USE_EMBEDDED_PYTHON
 int                   HookLoadPythonScript(HOOK_LIST *psHook, char *pcError);
 #endif
 //HOOK_LIST            *HookMatchHook(HOOK_LIST *psHookList, FTIMES_FILE_DATA *psFTFileData); /* This is declared in ftimes.h. */
 HOOK_LIST            *HookNewHook(char *pcExpression, char *pcError);
+int                   HookReadCommand(int iFd, int *piHookIndex, char **ppcNeuteredPath, KLEL_COMMAND **ppsCommand, char *pcError);
+int                   HookReadData(int iFd, void *pvData, int iLength);
+int                   HookWriteCommand(int iFd, int iHookIndex, char *pcNeuteredPath, KLEL_COMMAND *psCommand, char *pcError);
+int                   HookWriteData(int iFd, void *pvData, int iLength);
 
 #endif /* !_HOOK_H_INCLUDED */
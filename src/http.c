@@ -13,6 +13,8 @@
 
 static unsigned char gaucBase64[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
 static unsigned char gaucBase16[] = "0123456789abcdef";
+static HTTP_CONNECTION gasConnections[HTTP_CONNECTION_CACHE_SIZE];
+static int giConnectionCount = 0;
 
 /*-
  ***********************************************************************
@@ -301,9 +303,11 @@ HttpBuildRequest(HTTP_URL *psUrl, char *pcError)
   iRequestLength += strlen("Host: ") + strlen(psUrl->pcHost) + strlen(":65535\r\n");
   iRequestLength += strlen("Content-Type: application/octet-stream\r\n");
   iRequestLength += strlen("Content-Length: 4294967295\r\n");
+  iRequestLength += strlen("Transfer-Encoding: chunked\r\n");
+  iRequestLength += strlen("Content-Encoding: gzip\r\n");
   iRequestLength += strlen("Job-Id: ") + strlen(psUrl->pcJobId) + strlen("\r\n");
   iRequestLength += strlen("Authorization: Basic ") + (4 * (strlen(psUrl->pcUser) + strlen(psUrl->pcPass))) + strlen("\r\n");
-  iRequestLength += strlen("Connection: close\r\n");
+  iRequestLength += strlen("Connection: keep-alive\r\n");
   iRequestLength += strlen("\r\n");
   if (psUrl->iUseProxy)
   {
@@ -363,7 +367,18 @@ HttpBuildRequest(HTTP_URL *psUrl, char *pcError)
   }
   iIndex += snprintf(&pcRequest[iIndex], iRequestLength - iIndex, "Host: %s:%d\r\n", psUrl->pcHost, psUrl->ui16Port);
   iIndex += snprintf(&pcRequest[iIndex], iRequestLength - iIndex, "Content-Type: application/octet-stream\r\n");
-  iIndex += snprintf(&pcRequest[iIndex], iRequestLength - iIndex, "Content-Length: %u\r\n", psUrl->ui32ContentLength);
+  if ((psUrl->iFlags & HTTP_FLAG_CHUNKED_TRANSFER) == HTTP_FLAG_CHUNKED_TRANSFER)
+  {
+    iIndex += snprintf(&pcRequest[iIndex], iRequestLength - iIndex, "Transfer-Encoding: chunked\r\n");
+  }
+  else
+  {
+    iIndex += snprintf(&pcRequest[iIndex], iRequestLength - iIndex, "Content-Length: %u\r\n", psUrl->ui32ContentLength);
+  }
+  if ((psUrl->iFlags & HTTP_FLAG_GZIP_CONTENT) == HTTP_FLAG_GZIP_CONTENT)
+  {
+    iIndex += snprintf(&pcRequest[iIndex], iRequestLength - iIndex, "Content-Encoding: gzip\r\n");
+  }
   if (psUrl->iAuthType == HTTP_AUTH_TYPE_BASIC)
   {
     pcBasicEncoding = HttpEncodeBasic(psUrl->pcUser, psUrl->pcPass, acLocalError);
@@ -392,13 +407,245 @@ HttpBuildRequest(HTTP_URL *psUrl, char *pcError)
   {
     iIndex += snprintf(&pcRequest[iIndex], iRequestLength - iIndex, "Job-Id: %s\r\n", psUrl->pcJobId);
   }
-  iIndex += snprintf(&pcRequest[iIndex], iRequestLength - iIndex, "Connection: close\r\n");
+  if ((psUrl->iFlags & HTTP_FLAG_KEEP_ALIVE) == HTTP_FLAG_KEEP_ALIVE && (psUrl->iFlags & HTTP_FLAG_USE_HTTP_1_0) != HTTP_FLAG_USE_HTTP_1_0)
+  {
+    iIndex += snprintf(&pcRequest[iIndex], iRequestLength - iIndex, "Connection: keep-alive\r\n");
+  }
+  else
+  {
+    iIndex += snprintf(&pcRequest[iIndex], iRequestLength - iIndex, "Connection: close\r\n");
+  }
   iIndex += snprintf(&pcRequest[iIndex], iRequestLength - iIndex, "\r\n");
 
   return pcRequest;
 }
 
 
+/*-
+ ***********************************************************************
+ *
+ * HttpCheckInConnection
+ *
+ ***********************************************************************
+ */
+void
+HttpCheckInConnection(HTTP_URL *psUrl, SOCKET_CONTEXT *psSocketCTX, HTTP_RESPONSE_HDR *psResponseHeader)
+{
+  HTTP_CONNECTION    *psConnection = NULL;
+
+  /*-
+   *********************************************************************
+   *
+   * Only keep the connection if both sides agreed to keep it alive.
+   * The caller must have consumed the entire response by this point.
+   *
+   *********************************************************************
+   */
+  if
+  (
+       (psUrl->iFlags & HTTP_FLAG_KEEP_ALIVE) != HTTP_FLAG_KEEP_ALIVE
+    || (psUrl->iFlags & HTTP_FLAG_USE_HTTP_1_0) == HTTP_FLAG_USE_HTTP_1_0
+    || psResponseHeader->iMajorVersion != 1
+    || psResponseHeader->iMinorVersion < 1
+    || psResponseHeader->iConnectionClose
+  )
+  {
+    SocketCleanup(psSocketCTX);
+    return;
+  }
+
+  /*-
+   *********************************************************************
+   *
+   * If the cache is full, close the connection that has been idle the
+   * longest (i.e., the first one) to make room.
+   *
+   *********************************************************************
+   */
+  if (giConnectionCount == HTTP_CONNECTION_CACHE_SIZE)
+  {
+    SocketCleanup(gasConnections[0].psSocketCTX);
+    memmove(&gasConnections[0], &gasConnections[1], (HTTP_CONNECTION_CACHE_SIZE - 1) * sizeof(HTTP_CONNECTION));
+    giConnectionCount--;
+  }
+
+  psConnection = &gasConnections[giConnectionCount++];
+  psConnection->iSocketType = psSocketCTX->iType;
+  psConnection->iUseProxy = psUrl->iUseProxy;
+  psConnection->ui16Port = psUrl->ui16Port;
+  psConnection->ui16ProxyPort = psUrl->ui16ProxyPort;
+  psConnection->ui32Ip = psUrl->ui32Ip;
+  psConnection->ui32ProxyIp = psUrl->ui32ProxyIp;
+#ifdef USE_SSL
+  psConnection->psslCTX = psSocketCTX->psslCTX;
+#endif
+  psConnection->psSocketCTX = psSocketCTX;
+}
+
+
+/*-
+ ***********************************************************************
+ *
+ * HttpCheckOutConnection
+ *
+ ***********************************************************************
+ */
+SOCKET_CONTEXT *
+HttpCheckOutConnection(HTTP_URL *psUrl, int iSocketType, char *pcError)
+{
+  const char          acRoutine[] = "HttpCheckOutConnection()";
+  char                acLocalError[MESSAGE_SIZE] = "";
+  int                 i = 0;
+  HTTP_CONNECTION    *psConnection = NULL;
+  SOCKET_CONTEXT     *psSocketCTX = NULL;
+
+  /*-
+   *********************************************************************
+   *
+   * Look for an idle connection to the same endpoint. Once claimed, a
+   * connection is removed from the cache. If the peer has closed it in
+   * the mean time, discard it and fall through to a new connection.
+   *
+   *********************************************************************
+   */
+  for (i = 0; i < giConnectionCount; i++)
+  {
+    psConnection = &gasConnections[i];
+    if
+    (
+         psConnection->iSocketType == iSocketType
+      && psConnection->iUseProxy == psUrl->iUseProxy
+      && psConnection->ui16Port == psUrl->ui16Port
+      && psConnection->ui32Ip == psUrl->ui32Ip
+      && (!psUrl->iUseProxy || (psConnection->ui16ProxyPort == psUrl->ui16ProxyPort && psConnection->ui32ProxyIp == psUrl->ui32ProxyIp))
+#ifdef USE_SSL
+      && (iSocketType != SOCKET_TYPE_SSL || psConnection->psslCTX == psUrl->psSslProperties->psslCTX)
+#endif
+    )
+    {
+      psSocketCTX = psConnection->psSocketCTX;
+      memmove(&gasConnections[i], &gasConnections[i + 1], (giConnectionCount - i - 1) * sizeof(HTTP_CONNECTION));
+      giConnectionCount--;
+      if (SocketIsReusable(psSocketCTX))
+      {
+        return psSocketCTX;
+      }
+      SocketCleanup(psSocketCTX);
+      break;
+    }
+  }
+
+  psSocketCTX = HttpConnect(psUrl, iSocketType, acLocalError);
+  if (psSocketCTX == NULL)
+  {
+    snprintf(pcError, MESSAGE_SIZE, "%s: %s", acRoutine, acLocalError);
+    return NULL;
+  }
+
+  return psSocketCTX;
+}
+
+
+/*-
+ ***********************************************************************
+ *
+ * HttpCloseChunkedRequest
+ *
+ ***********************************************************************
+ */
+int
+HttpCloseChunkedRequest(HTTP_URL *psUrl, SOCKET_CONTEXT *psSocketCTX, HTTP_RESPONSE_HDR *psResponseHeader, char *pcError)
+{
+  const char          acRoutine[] = "HttpCloseChunkedRequest()";
+  char                acLocalError[MESSAGE_SIZE] = "";
+  char                acSockData[HTTP_IO_BUFSIZE];
+  char                acLastChunk[] = "0\r\n\r\n";
+  int                 iError = 0;
+  int                 iNRead = 0;
+  int                 iNSent = 0;
+
+  /*-
+   *********************************************************************
+   *
+   * Transmit the last chunk. It has no data and no trailer fields.
+   *
+   *********************************************************************
+   */
+  iNSent = SocketWrite(psSocketCTX, acLastChunk, strlen(acLastChunk), acLocalError);
+  if (iNSent != (int) strlen(acLastChunk))
+  {
+    snprintf(pcError, MESSAGE_SIZE, "%s: Sent = [%d] != [%d]: Transmission Error: %s", acRoutine, iNSent, (int) strlen(acLastChunk), acLocalError);
+    SocketCleanup(psSocketCTX);
+    return -1;
+  }
+
+  /*-
+   *********************************************************************
+   *
+   * Read and parse the Response Header. Any Response Content is
+   * ignored.
+   *
+   *********************************************************************
+   */
+  memset(acSockData, 0, HTTP_IO_BUFSIZE);
+
+  iNRead = HttpReadHeader(psSocketCTX, acSockData, HTTP_IO_BUFSIZE - 1, acLocalError);
+  if (iNRead == -1)
+  {
+    snprintf(pcError, MESSAGE_SIZE, "%s: %s", acRoutine, acLocalError);
+    SocketCleanup(psSocketCTX);
+    return -1;
+  }
+  acSockData[iNRead] = 0;
+
+  iError = HttpParseHeader(acSockData, iNRead, psResponseHeader, acLocalError);
+  if (iError != 0)
+  {
+    snprintf(pcError, MESSAGE_SIZE, "%s: %s", acRoutine, acLocalError);
+    SocketCleanup(psSocketCTX);
+    return -1;
+  }
+
+  /*-
+   *********************************************************************
+   *
+   * The connection may only be kept if there is no content to skip.
+   *
+   *********************************************************************
+   */
+  if (psResponseHeader->iContentLengthFound && psResponseHeader->ui32ContentLength == 0)
+  {
+    HttpCheckInConnection(psUrl, psSocketCTX, psResponseHeader);
+  }
+  else
+  {
+    SocketCleanup(psSocketCTX);
+  }
+
+  return 0;
+}
+
+
+/*-
+ ***********************************************************************
+ *
+ * HttpCloseConnections
+ *
+ ***********************************************************************
+ */
+void
+HttpCloseConnections(void)
+{
+  int                 i = 0;
+
+  for (i = 0; i < giConnectionCount; i++)
+  {
+    SocketCleanup(gasConnections[i].psSocketCTX);
+  }
+  giConnectionCount = 0;
+}
+
+
 /*-
  ***********************************************************************
  *
@@ -438,7 +685,7 @@ HttpConnect(HTTP_URL *psUrl, int iSocketType, char *pcError)
      *
      *******************************************************************
      */
-    psSocketCTX = SocketConnect(psUrl->ui32ProxyIp, psUrl->ui16ProxyPort, SOCKET_TYPE_REGULAR, NULL, acLocalError);
+    psSocketCTX = SocketConnect(psUrl->ui32ProxyIp, psUrl->ui16ProxyPort, SOCKET_TYPE_REGULAR, NULL, psUrl->iConnectTimeout, psUrl->iReadTimeout, psUrl->iWriteTimeout, acLocalError);
     if (psSocketCTX == NULL)
     {
       snprintf(pcError, MESSAGE_SIZE, "%s: %s", acRoutine, acLocalError);
@@ -572,9 +819,9 @@ HttpConnect(HTTP_URL *psUrl, int iSocketType, char *pcError)
   else
   {
 #ifdef USE_SSL
-    psSocketCTX = SocketConnect(psUrl->ui32Ip, psUrl->ui16Port, iSocketType, (iSocketType == SOCKET_TYPE_SSL) ? psUrl->psSslProperties->psslCTX : NULL, acLocalError);
+    psSocketCTX = SocketConnect(psUrl->ui32Ip, psUrl->ui16Port, iSocketType, (iSocketType == SOCKET_TYPE_SSL) ? psUrl->psSslProperties->psslCTX : NULL, psUrl->iConnectTimeout, psUrl->iReadTimeout, psUrl->iWriteTimeout, acLocalError);
 #else
-    psSocketCTX = SocketConnect(psUrl->ui32Ip, psUrl->ui16Port, iSocketType, NULL, acLocalError);
+    psSocketCTX = SocketConnect(psUrl->ui32Ip, psUrl->ui16Port, iSocketType, NULL, psUrl->iConnectTimeout, psUrl->iReadTimeout, psUrl->iWriteTimeout, acLocalError);
 #endif
     if (psSocketCTX == NULL)
     {
@@ -994,6 +1241,122 @@ HttpNewUrl(char *pcError)
 }
 
 
+/*-
+ ***********************************************************************
+ *
+ * HttpOpenChunkedRequest
+ *
+ ***********************************************************************
+ */
+SOCKET_CONTEXT *
+HttpOpenChunkedRequest(HTTP_URL *psUrl, char *pcError)
+{
+  const char          acRoutine[] = "HttpOpenChunkedRequest()";
+  char                acLocalError[MESSAGE_SIZE] = "";
+  char               *pcRequest = NULL;
+  int                 iFlags = 0;
+  int                 iNSent = 0;
+  int                 iRequestLength = 0;
+  int                 iSocketType = 0;
+  SOCKET_CONTEXT     *psSocketCTX = NULL;
+
+  /*-
+   *********************************************************************
+   *
+   * If psUrl is not defined, abort. Chunked requests require HTTP/1.1.
+   *
+   *********************************************************************
+   */
+  if (psUrl == NULL)
+  {
+    snprintf(pcError, MESSAGE_SIZE, "%s: Undefined URL.", acRoutine);
+    return NULL;
+  }
+
+  if ((psUrl->iFlags & HTTP_FLAG_USE_HTTP_1_0) == HTTP_FLAG_USE_HTTP_1_0)
+  {
+    snprintf(pcError, MESSAGE_SIZE, "%s: Chunked transfers are not supported in HTTP/1.0.", acRoutine);
+    return NULL;
+  }
+
+  /*-
+   *********************************************************************
+   *
+   * Set the socket type based on the URL scheme.
+   *
+   *********************************************************************
+   */
+  switch (psUrl->iScheme)
+  {
+  case HTTP_SCHEME_FILE:
+    snprintf(pcError, MESSAGE_SIZE, "%s: Scheme = [file]: Unsupported Scheme.", acRoutine);
+    return NULL;
+    break;
+  case HTTP_SCHEME_HTTP:
+    iSocketType = SOCKET_TYPE_REGULAR;
+    break;
+  case HTTP_SCHEME_HTTPS:
+#ifdef USE_SSL
+    iSocketType = SOCKET_TYPE_SSL;
+#else
+    snprintf(pcError, MESSAGE_SIZE, "%s: Scheme = [https]: Unsupported Scheme.", acRoutine);
+    return NULL;
+#endif
+    break;
+  default:
+    snprintf(pcError, MESSAGE_SIZE, "%s: Scheme = [%d]: Unsupported Scheme.", acRoutine, psUrl->iScheme);
+    return NULL;
+    break;
+  }
+
+  /*-
+   *********************************************************************
+   *
+   * Build the Request Header. The chunked flag is only set for the
+   * duration of the build since the URL may be reused later on.
+   *
+   *********************************************************************
+   */
+  iFlags = psUrl->iFlags;
+  psUrl->iFlags |= HTTP_FLAG_CHUNKED_TRANSFER;
+  pcRequest = HttpBuildRequest(psUrl, acLocalError);
+  psUrl->iFlags = iFlags;
+  if (pcRequest == NULL)
+  {
+    snprintf(pcError, MESSAGE_SIZE, "%s: %s", acRoutine, acLocalError);
+    return NULL;
+  }
+  iRequestLength = strlen(pcRequest);
+
+  /*-
+   *********************************************************************
+   *
+   * Connect to the server, and transmit the Request Header.
+   *
+   *********************************************************************
+   */
+  psSocketCTX = HttpCheckOutConnection(psUrl, iSocketType, acLocalError);
+  if (psSocketCTX == NULL)
+  {
+    snprintf(pcError, MESSAGE_SIZE, "%s: %s", acRoutine, acLocalError);
+    HttpFreeData(pcRequest);
+    return NULL;
+  }
+
+  iNSent = SocketWrite(psSocketCTX, pcRequest, iRequestLength, acLocalError);
+  if (iNSent != iRequestLength)
+  {
+    snprintf(pcError, MESSAGE_SIZE, "%s: Sent = [%d] != [%d]: Transmission Error: %s", acRoutine, iNSent, iRequestLength, acLocalError);
+    HttpFreeData(pcRequest);
+    SocketCleanup(psSocketCTX);
+    return NULL;
+  }
+  HttpFreeData(pcRequest);
+
+  return psSocketCTX;
+}
+
+
 /*-
  ***********************************************************************
  *
@@ -1180,7 +1543,15 @@ HttpParseGreLine(char *pcLine, HTTP_RESPONSE_HDR *psResponseHeader, char *pcErro
    *
    *********************************************************************
    */
-  if (strcasecmp(pcFieldName, FIELD_ContentLength) == 0)
+  if (strcasecmp(pcFieldName, FIELD_Connection) == 0)
+  {
+    if (strcasecmp(pcFieldValue, "close") == 0)
+    {
+      psResponseHeader->iConnectionClose = 1;
+    }
+  }
+
+  else if (strcasecmp(pcFieldName, FIELD_ContentLength) == 0)
   {
     if (psResponseHeader->iContentLengthFound)
     {
@@ -1954,13 +2325,14 @@ HttpReadDataIntoStream(SOCKET_CONTEXT *psSocketCTX, FILE *pFile, APP_UI32 ui32Co
   /*-
    *********************************************************************
    *
-   * Read the data.
+   * Read the data. When the Content-Length is known, never read past
+   * it since the connection may be kept alive for another request.
    *
    *********************************************************************
    */
-  while (!iEmptyRead)
+  while (!iEmptyRead && (!iContentLengthRequired || ui32ToRead > 0))
   {
-    iNRead = SocketRead(psSocketCTX, acData, HTTP_IO_BUFSIZE, acLocalError);
+    iNRead = SocketRead(psSocketCTX, acData, (iContentLengthRequired && ui32ToRead < HTTP_IO_BUFSIZE) ? (int) ui32ToRead : HTTP_IO_BUFSIZE, acLocalError);
     switch (iNRead)
     {
     case 0:
@@ -1980,10 +2352,6 @@ HttpReadDataIntoStream(SOCKET_CONTEXT *psSocketCTX, FILE *pFile, APP_UI32 ui32Co
       ui32ToRead -= iNRead;
       break;
     }
-    if (iContentLengthRequired && ui32ToRead < 1)
-    {
-      break;
-    }
   }
   if (iContentLengthRequired && ui32Offset != ui32ContentLength)
   {
@@ -2633,6 +3001,22 @@ HttpSetUrlQuery(HTTP_URL *psUrl, char *pcQuery, char *pcError)
 }
 
 
+/*-
+ ***********************************************************************
+ *
+ * HttpSetUrlTimeouts
+ *
+ ***********************************************************************
+ */
+void
+HttpSetUrlTimeouts(HTTP_URL *psUrl, int iConnectTimeout, int iReadTimeout, int iWriteTimeout)
+{
+  psUrl->iConnectTimeout = iConnectTimeout;
+  psUrl->iReadTimeout = iReadTimeout;
+  psUrl->iWriteTimeout = iWriteTimeout;
+}
+
+
 /*-
  ***********************************************************************
  *
@@ -2807,14 +3191,15 @@ HttpSubmitRequest(HTTP_URL *psUrl, int iInputType, void *pInput, int iOutputType
   /*-
    *********************************************************************
    *
-   * Connect to the server.
+   * Connect to the server or reuse an idle connection to it.
    *
    *********************************************************************
    */
-  psSocketCTX = HttpConnect(psUrl, iSocketType, acLocalError);
+  psSocketCTX = HttpCheckOutConnection(psUrl, iSocketType, acLocalError);
   if (psSocketCTX == NULL)
   {
     snprintf(pcError, MESSAGE_SIZE, "%s: %s", acRoutine, acLocalError);
+    HttpFreeData(pcRequest);
     return -1;
   }
 
@@ -2867,6 +3252,27 @@ HttpSubmitRequest(HTTP_URL *psUrl, int iInputType, void *pInput, int iOutputType
   case HTTP_STREAM_INPUT:
     for (pSList = (HTTP_STREAM_LIST *)pInput; pSList != NULL; pSList = pSList->psNext)
     {
+#ifdef USE_SENDFILE
+      /*-
+       *****************************************************************
+       *
+       * Skip the copy through user space when the connection allows
+       * it. Exactly the number of bytes announced in Content-Length
+       * are sent.
+       *
+       *****************************************************************
+       */
+      if (SocketCanSendFile(psSocketCTX))
+      {
+        if (SocketSendFile(psSocketCTX, pSList->pFile, pSList->ui32Size, acLocalError) == -1)
+        {
+          snprintf(pcError, MESSAGE_SIZE, "%s: %s", acRoutine, acLocalError);
+          SocketCleanup(psSocketCTX);
+          return -1;
+        }
+        continue;
+      }
+#endif
       do
       {
         iNRead = fread(acFileData, 1, HTTP_IO_BUFSIZE, pSList->pFile);
@@ -3004,7 +3410,22 @@ HttpSubmitRequest(HTTP_URL *psUrl, int iInputType, void *pInput, int iOutputType
     return -1;
   }
 
-  SocketCleanup(psSocketCTX);
+  /*-
+   *********************************************************************
+   *
+   * Keep the connection for later requests if the Response Content
+   * was delimited and fully consumed. Otherwise, close it.
+   *
+   *********************************************************************
+   */
+  if (psResponseHeader->iContentLengthFound && (iOutputType != HTTP_IGNORE_OUTPUT || psResponseHeader->ui32ContentLength == 0))
+  {
+    HttpCheckInConnection(psUrl, psSocketCTX, psResponseHeader);
+  }
+  else
+  {
+    SocketCleanup(psSocketCTX);
+  }
 
   return 0;
 }
@@ -3072,3 +3493,50 @@ HttpUnEscape(char *pcEscaped, int *piUnEscapedLength, char *pcError)
 
   return pcUnEscaped;
 }
+
+
+/*-
+ ***********************************************************************
+ *
+ * HttpWriteChunk
+ *
+ ***********************************************************************
+ */
+int
+HttpWriteChunk(SOCKET_CONTEXT *psSocketCTX, char *pcData, int iLength, char *pcError)
+{
+  const char          acRoutine[] = "HttpWriteChunk()";
+  char                acLocalError[MESSAGE_SIZE] = "";
+  char                acChunk[HTTP_IO_BUFSIZE + HTTP_CHUNK_OVERHEAD];
+  int                 iChunkLength = 0;
+  int                 iCount = 0;
+  int                 iDone = 0;
+  int                 iNSent = 0;
+
+  /*-
+   *********************************************************************
+   *
+   * Frame the data as one or more chunks. Each chunk is assembled in
+   * a single buffer so that it goes out in one write. A zero-length
+   * chunk would terminate the body, so empty writes are ignored.
+   *
+   *********************************************************************
+   */
+  for (iDone = 0; iDone < iLength; iDone += iCount)
+  {
+    iCount = (iLength - iDone > HTTP_IO_BUFSIZE) ? HTTP_IO_BUFSIZE : iLength - iDone;
+    iChunkLength = snprintf(acChunk, HTTP_CHUNK_OVERHEAD, "%x\r\n", iCount);
+    memcpy(&acChunk[iChunkLength], &pcData[iDone], iCount);
+    iChunkLength += iCount;
+    acChunk[iChunkLength++] = '\r';
+    acChunk[iChunkLength++] = '\n';
+    iNSent = SocketWrite(psSocketCTX, acChunk, iChunkLength, acLocalError);
+    if (iNSent != iChunkLength)
+    {
+      snprintf(pcError, MESSAGE_SIZE, "%s: Sent = [%d] != [%d]: Transmission Error: %s", acRoutine, iNSent, iChunkLength, acLocalError);
+      return -1;
+    }
+  }
+
+  return 0;
+}
@@ -26,6 +26,8 @@
 #endif
 
 #define HTTP_IO_BUFSIZE              0x4000
+#define HTTP_CHUNK_OVERHEAD              16
+#define HTTP_CONNECTION_CACHE_SIZE        4
 
 #define HTTP_AUTH_TYPE_NONE               0
 #define HTTP_AUTH_TYPE_BASIC              1
@@ -64,7 +66,11 @@
 
 #define HTTP_FLAG_USE_HTTP_1_0            0x00000001
 #define HTTP_FLAG_CONTENT_LENGTH_OPTIONAL 0x00000002
+#define HTTP_FLAG_CHUNKED_TRANSFER        0x00000004
+#define HTTP_FLAG_KEEP_ALIVE              0x00000008
+#define HTTP_FLAG_GZIP_CONTENT            0x00000010
 
+#define FIELD_Connection              "Connection"
 #define FIELD_ContentLength       "Content-Length"
 #define FIELD_JobId                       "Job-Id"
 #define FIELD_TransferEncoding "Transfer-Encoding"
@@ -91,6 +97,7 @@ typedef struct _HTTP_RESPONSE_HDR
   int                 iMajorVersion;
   int                 iMinorVersion;
   int                 iStatusCode;
+  int                 iConnectionClose;
   int                 iContentLengthFound;
   int                 iJobIdFound;
 #ifdef USE_DSV
@@ -110,8 +117,11 @@ typedef struct _HTTP_URL
   char               *pcMeth;
   char               *pcJobId;
   int                 iAuthType;
+  int                 iConnectTimeout;
   int                 iFlags;
+  int                 iReadTimeout;
   int                 iScheme;
+  int                 iWriteTimeout;
   APP_UI32            ui32DownloadLimit;
   APP_UI32            ui32ContentLength;
   APP_UI32            ui32Ip;
@@ -131,6 +141,20 @@ typedef struct _HTTP_URL
 #endif
 } HTTP_URL;
 
+typedef struct _HTTP_CONNECTION
+{
+  int                 iSocketType;
+  int                 iUseProxy;
+  APP_UI16            ui16Port;
+  APP_UI16            ui16ProxyPort;
+  APP_UI32            ui32Ip;
+  APP_UI32            ui32ProxyIp;
+#ifdef USE_SSL
+  SSL_CTX            *psslCTX;
+#endif
+  SOCKET_CONTEXT     *psSocketCTX;
+} HTTP_CONNECTION;
+
 typedef struct _HTTP_MEMORY_LIST
 {
   APP_UI32            ui32Size;
@@ -167,6 +191,10 @@ typedef struct _HTTP_STREAM_LIST
  */
 char                 *HttpBuildProxyConnectRequest(HTTP_URL *psUrl, char *pcError);
 char                 *HttpBuildRequest(HTTP_URL *psUrl, char *pcError);
+void                  HttpCheckInConnection(HTTP_URL *psUrl, SOCKET_CONTEXT *psSocketCTX, HTTP_RESPONSE_HDR *psResponseHeader);
+SOCKET_CONTEXT       *HttpCheckOutConnection(HTTP_URL *psUrl, int iSocketType, char *pcError);
+int                   HttpCloseChunkedRequest(HTTP_URL *psUrl, SOCKET_CONTEXT *psSocketCTX, HTTP_RESPONSE_HDR *psResponseHeader, char *pcError);
+void                  HttpCloseConnections(void);
 SOCKET_CONTEXT       *HttpConnect(HTTP_URL *psUrl, int iSocketType, char *pcError);
 char                 *HttpEncodeBasic(char *pcUsername, char *pcPassword, char *pcError);
 void                  HttpEncodeCredentials(char *pcCredentials, char *pcAuthorization);
@@ -175,6 +203,7 @@ void                  HttpFreeData(char *pcData);
 void                  HttpFreeUrl(HTTP_URL *psUrl);
 int                   HttpHexToInt(int i);
 HTTP_URL             *HttpNewUrl(char *pcError);
+SOCKET_CONTEXT       *HttpOpenChunkedRequest(HTTP_URL *psUrl, char *pcError);
 int                   HttpParseAddress(char *pcUserPassHostPort, HTTP_URL *psUrl, char *pcError);
 int                   HttpParseGreLine(char *pcLine, HTTP_RESPONSE_HDR *psResponseHeader, char *pcError);
 int                   HttpParseHeader(char *pcResponseHeader, int iResponseHeaderLength, HTTP_RESPONSE_HDR *psResponseHeader, char *pcError);
@@ -199,8 +228,10 @@ int                   HttpSetUrlProxyPass(HTTP_URL *psUrl, char *pcProxyPass, ch
 int                   HttpSetUrlProxyPort(HTTP_URL *psUrl, char *pcProxyPort, char *pcError);
 int                   HttpSetUrlProxyUser(HTTP_URL *psUrl, char *pcProxyUser, char *pcError);
 int                   HttpSetUrlQuery(HTTP_URL *psUrl, char *pcQuery, char *pcError);
+void                  HttpSetUrlTimeouts(HTTP_URL *psUrl, int iConnectTimeout, int iReadTimeout, int iWriteTimeout);
 int                   HttpSetUrlUser(HTTP_URL *psUrl, char *pcUser, char *pcError);
 int                   HttpSubmitRequest(HTTP_URL *psUrl, int iInputType, void *pInput, int iOutputType, void *pOutput, HTTP_RESPONSE_HDR *psResponseHeader, char *pcError);
 char                 *HttpUnEscape(char *pcEscaped, int *piUnEscapedLength, char *pcError);
+int                   HttpWriteChunk(SOCKET_CONTEXT *psSocketCTX, char *pcData, int iLength, char *pcError);
 
 #endif /* !_HTTP_H_INCLUDED */
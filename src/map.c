@@ -21,6 +21,23 @@ static int giStreams;
 static int giRecords;
 static int giIncompleteRecords;
 
+#ifndef WINNT
+static FTIMES_FILE_DATA *gpsFTFileDataFreeList;
+#endif
+
+#ifdef USE_FILE_HOOKS
+static APP_UI64 gui64HookSequence;
+#ifdef USE_EMBEDDED_LUA
+static lua_State *gpsHookLuaState;
+#endif
+#ifdef USE_EMBEDDED_PERL
+static int giHookPerlUsed;
+#endif
+#ifdef USE_EMBEDDED_PYTHON
+static int giHookPythonUsed;
+#endif
+#endif
+
 /*-
  ***********************************************************************
  *
@@ -50,6 +67,100 @@ static int lua_neuter_string(lua_State *psLuaState)
 #endif
 
 
+#ifdef USE_FILE_HOOKS
+/*-
+ ***********************************************************************
+ *
+ * MapCloseHookDescriptors
+ *
+ ***********************************************************************
+ */
+void
+MapCloseHookDescriptors(FTIMES_PROPERTIES *psProperties)
+{
+  HOOK_WORKER        *psWorker = NULL;
+  int                 i = 0;
+
+  /*-
+   *********************************************************************
+   *
+   * A new kid must not hold on to other kids' pipes. Otherwise, the
+   * workers would never see end of file on their request pipes.
+   *
+   *********************************************************************
+   */
+  for (i = 0; psProperties->psHookWorkers != NULL && i < psProperties->iFileHookWorkers; i++)
+  {
+    psWorker = &psProperties->psHookWorkers[i];
+    if (psWorker->iKidPid > 0)
+    {
+      if (psWorker->iRequestFd >= 0)
+      {
+        close(psWorker->iRequestFd);
+      }
+      if (psWorker->iResponseFd >= 0)
+      {
+        close(psWorker->iResponseFd);
+      }
+      if (psWorker->iStdoutFd >= 0)
+      {
+        close(psWorker->iStdoutFd);
+      }
+      if (psWorker->iStderrFd >= 0)
+      {
+        close(psWorker->iStderrFd);
+      }
+    }
+  }
+}
+
+
+/*-
+ ***********************************************************************
+ *
+ * MapCloseHookInterpreters
+ *
+ ***********************************************************************
+ */
+void
+MapCloseHookInterpreters(FTIMES_PROPERTIES *psProperties)
+{
+  /*-
+   *********************************************************************
+   *
+   * Tear down any embedded interpreters that were used by this kid.
+   *
+   *********************************************************************
+   */
+#ifdef USE_EMBEDDED_LUA
+  if (gpsHookLuaState != NULL)
+  {
+    lua_close(gpsHookLuaState);
+    gpsHookLuaState = NULL;
+  }
+#endif
+#ifdef USE_EMBEDDED_PERL
+  if (giHookPerlUsed)
+  {
+    PL_perl_destruct_level = 1; /* This must be set to 1 since perl_construct() reset it to 0 according to perlembed. */
+    perl_destruct(psProperties->psMyPerl);
+    perl_free(psProperties->psMyPerl);
+    PERL_SYS_TERM();
+    psProperties->psMyPerl = NULL;
+    giHookPerlUsed = 0;
+  }
+#endif
+#ifdef USE_EMBEDDED_PYTHON
+  if (giHookPythonUsed)
+  {
+    Py_Finalize();
+    giHookPythonUsed = 0;
+  }
+#endif
+}
+#endif
+
+
 #ifdef USE_EMBEDDED_PYTHON
 /*-
  ***********************************************************************
@@ -351,6 +462,155 @@ MapDirname(char *pcPath)
 }
 
 
+#ifdef USE_FILE_HOOKS
+/*-
+ ***********************************************************************
+ *
+ * MapDispatchHook
+ *
+ ***********************************************************************
+ */
+int
+MapDispatchHook(FTIMES_PROPERTIES *psProperties, HOOK_LIST *psHook, FTIMES_FILE_DATA *psFTFileData, char *pcError)
+{
+  const char          acRoutine[] = "MapDispatchHook()";
+  char                acLocalError[MESSAGE_SIZE] = "";
+  char                acMessage[MESSAGE_SIZE] = "";
+  HOOK_LIST          *psItem = NULL;
+  HOOK_WORKER        *psWorker = NULL;
+  int                 i = 0;
+  int                 iError = 0;
+  int                 iHookIndex = 0;
+  int                 iTry = 0;
+  KLEL_COMMAND       *psCommand = NULL;
+
+  /*-
+   *********************************************************************
+   *
+   * Allocate the worker table. Workers are started on demand.
+   *
+   *********************************************************************
+   */
+  if (psProperties->psHookWorkers == NULL)
+  {
+    psProperties->psHookWorkers = (HOOK_WORKER *) calloc(psProperties->iFileHookWorkers, sizeof(HOOK_WORKER));
+    if (psProperties->psHookWorkers == NULL)
+    {
+      snprintf(pcError, MESSAGE_SIZE, "%s: calloc(): %s", acRoutine, strerror(errno));
+      return ER;
+    }
+    for (i = 0; i < psProperties->iFileHookWorkers; i++)
+    {
+      psProperties->psHookWorkers[i].iRequestFd = psProperties->psHookWorkers[i].iResponseFd = -1;
+      psProperties->psHookWorkers[i].iStdoutFd = psProperties->psHookWorkers[i].iStderrFd = -1;
+    }
+  }
+
+  /*-
+   *********************************************************************
+   *
+   * Collect the results of any hooks that have completed, and then
+   * find a place to run this one. If every worker is busy, the walk
+   * stalls here until one of them frees up.
+   *
+   *********************************************************************
+   */
+  if (MapPollHookWorkers(psProperties, 0, acLocalError) != ER_OK)
+  {
+    snprintf(pcError, MESSAGE_SIZE, "%s: %s", acRoutine, acLocalError);
+    return ER;
+  }
+  while ((psWorker = MapGetHookWorker(psProperties, HookIsEmbedded(psHook))) == NULL)
+  {
+    if (MapPollHookWorkers(psProperties, 1, acLocalError) != ER_OK)
+    {
+      snprintf(pcError, MESSAGE_SIZE, "%s: %s", acRoutine, acLocalError);
+      return ER;
+    }
+  }
+
+  /*-
+   *********************************************************************
+   *
+   * Evaluate the hook here so that the kid doesn't need access to the
+   * file's data. Workers locate the hook by its list index.
+   *
+   *********************************************************************
+   */
+  for (psItem = psProperties->psFileHookList; psItem != NULL && psItem != psHook; psItem = psItem->psNext)
+  {
+    iHookIndex++;
+  }
+  psHook->psContext->pvData = (void *)psFTFileData;
+  psCommand = KlelGetCommand(psHook->psContext);
+  if (psCommand == NULL)
+  {
+    snprintf(acMessage, MESSAGE_SIZE, "%s: NeuteredPath = [%s]: KlelGetCommand(): Hook (%s) failed to produce a valid command (%s).", acRoutine, psFTFileData->pcNeuteredPath, psHook->pcName, KlelGetError(psHook->psContext));
+    MessageHandler(MESSAGE_FLUSH_IT, MESSAGE_INFORMATION, MESSAGE_HOOK_STRING, acMessage);
+    return ER_OK;
+  }
+  psWorker->pcNeuteredPath = malloc(strlen(psFTFileData->pcNeuteredPath) + 1);
+  if (psWorker->pcNeuteredPath == NULL)
+  {
+    snprintf(pcError, MESSAGE_SIZE, "%s: malloc(): %s", acRoutine, strerror(errno));
+    KlelFreeCommand(psCommand);
+    return ER;
+  }
+  strcpy(psWorker->pcNeuteredPath, psFTFileData->pcNeuteredPath);
+
+  /*-
+   *********************************************************************
+   *
+   * Hand the command off. Embedded interpreter commands go to a worker,
+   * which is replaced (once) if it has gone away. All others get a kid
+   * of their own.
+   *
+   *********************************************************************
+   */
+  if (HookIsEmbedded(psHook))
+  {
+    for (iTry = 0; iTry < 2; iTry++)
+    {
+      if (psWorker->iKidPid <= 0)
+      {
+        iError = MapStartHookWorker(psProperties, psWorker, acLocalError);
+        if (iError != ER_OK)
+        {
+          break;
+        }
+      }
+      iError = HookWriteCommand(psWorker->iRequestFd, iHookIndex, psFTFileData->pcNeuteredPath, psCommand, acLocalError);
+      if (iError == ER_OK)
+      {
+        break;
+      }
+      MapStopHookWorker(psWorker, SIGKILL);
+    }
+  }
+  else
+  {
+    iError = MapStartHookKid(psProperties, psWorker, psHook, psCommand, psFTFileData->pcNeuteredPath, acLocalError);
+  }
+  KlelFreeCommand(psCommand);
+  if (iError != ER_OK)
+  {
+    snprintf(pcError, MESSAGE_SIZE, "%s: Hook (%s): %s", acRoutine, psHook->pcName, acLocalError);
+    free(psWorker->pcNeuteredPath);
+    psWorker->pcNeuteredPath = NULL;
+    return ER;
+  }
+  psWorker->psHook = psHook;
+  psWorker->iBusy = 1;
+  psWorker->iDone = 0;
+  psWorker->iOutputLength = 0;
+  psWorker->tStartTime = time(NULL);
+  psWorker->ui64Sequence = gui64HookSequence++;
+
+  return ER_OK;
+}
+#endif
+
+
 #ifdef USE_FILE_HOOKS
 /*-
  ***********************************************************************
@@ -365,6 +625,7 @@ MapExecuteHook(FTIMES_PROPERTIES *psProperties, FTIMES_FILE_DATA *psFTFileData,
   const char          acRoutine[] = "MapExecuteHook()";
 #define PIPE_READ_SIZE 8192
   char                acData[PIPE_READ_SIZE] = "";
+  char                acLocalError[MESSAGE_SIZE] = "";
   char                acMessage[MESSAGE_SIZE] = "";
   fd_set              sFdReadSet;
   fd_set              sFdSaveSet;
@@ -388,12 +649,7 @@ MapExecuteHook(FTIMES_PROPERTIES *psProperties, FTIMES_FILE_DATA *psFTFileData,
 #define PIPE_WRITER_INDEX 1
   int                 aaiPipes[3][2];
   KLEL_COMMAND       *psCommand = NULL;
-#ifdef USE_EMBEDDED_LUA
-  lua_State          *psLuaState = NULL;
-#endif
-#ifdef USE_EMBEDDED_PERL
-  SV                 *psScalarValue = NULL;
-#endif
+  time_t              tStartTime = 0;
 
   /*-
    *********************************************************************
@@ -421,6 +677,34 @@ MapExecuteHook(FTIMES_PROPERTIES *psProperties, FTIMES_FILE_DATA *psFTFileData,
     MessageHandler(MESSAGE_FLUSH_IT, MESSAGE_DEBUGGER, MESSAGE_DEBUGGER_STRING, acMessage);
   }
 
+  /*-
+   *********************************************************************
+   *
+   * If FileHookWorkers was set, the hook runs in the background while
+   * the walk continues. Otherwise, embedded interpreter commands go to
+   * a persistent worker, and the walk waits for them here. All other
+   * commands run in the foreground below.
+   *
+   *********************************************************************
+   */
+  if (psProperties->iFileHookWorkers > 0 && (psProperties->bFileHookBackground || HookIsEmbedded(psHook)))
+  {
+    iError = MapDispatchHook(psProperties, psHook, psFTFileData, pcError);
+    if (iError != ER_OK || psProperties->bFileHookBackground)
+    {
+      return iError;
+    }
+    while (MapGetHookJobCount(psProperties) > 0)
+    {
+      if (MapPollHookWorkers(psProperties, 1, acLocalError) != ER_OK)
+      {
+        snprintf(pcError, MESSAGE_SIZE, "%s: %s", acRoutine, acLocalError);
+        return ER;
+      }
+    }
+    return ER_OK;
+  }
+
   /*-
    *********************************************************************
    *
@@ -478,125 +762,11 @@ MapExecuteHook(FTIMES_PROPERTIES *psProperties, FTIMES_FILE_DATA *psFTFileData,
       KlelFreeCommand(psCommand);
       exit(-1);
     }
-#ifdef USE_EMBEDDED_LUA
-    else if (strcmp(psCommand->acInterpreter, "lua") == 0)
-    {
-      psLuaState = luaL_newstate();
-      if (psLuaState == NULL)
-      {
-        snprintf(acMessage, MESSAGE_SIZE, "%s: NeuteredPath = [%s]: Interpreter = [%s]: Hook (%s) failed to load lua state \"%s\" (%s).", acRoutine, psFTFileData->pcNeuteredPath, psCommand->acInterpreter, psHook->pcName, psCommand->acProgram, strerror(errno));
-        MessageHandler(MESSAGE_FLUSH_IT, MESSAGE_INFORMATION, MESSAGE_HOOK_STRING, acMessage);
-        exit(-2);
-      }
-      luaL_openlibs(psLuaState);
-
-      lua_register(psLuaState, "neuter_string", lua_neuter_string);
-
-      iError = luaL_loadfile(psLuaState, psCommand->ppcArgumentVector[0]);
-      if (iError != 0)
-      {
-        snprintf(acMessage, MESSAGE_SIZE, "%s: NeuteredPath = [%s]: Interpreter = [%s]: Hook (%s) failed to execute \"%s\" (%s).", acRoutine, psFTFileData->pcNeuteredPath, psCommand->acInterpreter, psHook->pcName, psCommand->acProgram, lua_tostring(psLuaState, -1));
-        MessageHandler(MESSAGE_FLUSH_IT, MESSAGE_INFORMATION, MESSAGE_HOOK_STRING, acMessage);
-      }
-
-      lua_newtable(psLuaState);
-      lua_pushnumber(psLuaState, 1);                               /* Push the table index. */
-      lua_pushstring(psLuaState, psCommand->ppcArgumentVector[1]); /* Push the cell value. */
-      lua_rawset(psLuaState, -3);                                  /* Store the pair in the table. */
-      lua_setglobal(psLuaState, "aArgs");
-
-      iError = lua_pcall(psLuaState, 0, LUA_MULTRET, 0);
-      if (iError != 0)
-      {
-        snprintf(acMessage, MESSAGE_SIZE, "%s: NeuteredPath = [%s]: Interpreter = [%s]: Hook (%s) failed to execute \"%s\" (%s).", acRoutine, psFTFileData->pcNeuteredPath, psCommand->acInterpreter, psHook->pcName, psCommand->acProgram, lua_tostring(psLuaState, -1));
-        MessageHandler(MESSAGE_FLUSH_IT, MESSAGE_INFORMATION, MESSAGE_HOOK_STRING, acMessage);
-      }
 
-      lua_close(psLuaState);
-      exit(iError);
-    }
-#endif
-#ifdef USE_EMBEDDED_PERL
-    else if (strcmp(psCommand->acInterpreter, "perl") == 0)
-    {
-      dSP;
-      ENTER;
-//    SAVETMPS; /* This should not be needed since mortal variables are not created/used. */
-      call_argv("Embed::Persistent::EvalScript", G_EVAL | G_KEEPERR | G_SCALAR, psCommand->ppcArgumentVector); /* Do not use G_DISCARD here so that Perl stack items are preserved. */
-      SPAGAIN;
-      psScalarValue = POPs;
-      PUTBACK;
-      if (SvTRUE(ERRSV))
-      {
-        iError = -1;
-        snprintf(acMessage, MESSAGE_SIZE, "%s: NeuteredPath = [%s]: Interpreter = [%s]: Hook (%s) failed to execute \"%s\" (%s).", acRoutine, psFTFileData->pcNeuteredPath, psCommand->acInterpreter, psHook->pcName, psCommand->acProgram, SvPV_nolen(ERRSV));
-        MessageHandler(MESSAGE_FLUSH_IT, MESSAGE_INFORMATION, MESSAGE_HOOK_STRING, acMessage);
-      }
-      else
-      {
-        if (SvOK(psScalarValue) && SvIOK(psScalarValue)) /* Expect the Perl stack to contain exactly one defined integer value. */
-        {
-          iError = SvIV(psScalarValue);
-        }
-        else
-        {
-          iError = -1;
-          snprintf(acMessage, MESSAGE_SIZE, "%s: NeuteredPath = [%s]: Interpreter = [%s]: Hook (%s) failed to execute \"%s\" (No $@).", acRoutine, psFTFileData->pcNeuteredPath, psCommand->acInterpreter, psHook->pcName, psCommand->acProgram);
-          MessageHandler(MESSAGE_FLUSH_IT, MESSAGE_INFORMATION, MESSAGE_HOOK_STRING, acMessage);
-        }
-      }
-//    FREETMPS; /* This should not be needed since mortal variables are not created/used. */
-      LEAVE;
-      PL_perl_destruct_level = 1; /* This must be set to 1 since perl_construct() reset it to 0 according to perlembed. */
-      perl_destruct(psProperties->psMyPerl);
-      perl_free(psProperties->psMyPerl);
-      PERL_SYS_TERM();
-      KlelFreeCommand(psCommand);
-      exit(iError);
-    }
-#endif
-#ifdef USE_EMBEDDED_PYTHON
-    else if (strcmp(psCommand->acInterpreter, "python") == 0)
-    {
-      iError = MapExecutePythonScript(psProperties, psHook, psCommand, psFTFileData, acMessage);
-      KlelFreeCommand(psCommand);
-      Py_Finalize();
-      exit(iError);
-    }
-#endif
-    else if (strcmp(psCommand->acInterpreter, "system") == 0)
-    {
-      if
-      (
-           psCommand->ppcArgumentVector[0] != NULL
-        && psCommand->ppcArgumentVector[1] != NULL
-        && strcmp(psCommand->ppcArgumentVector[0], "") == 0
-        && strcmp(psCommand->ppcArgumentVector[1], "") != 0
-      )
-      {
-        iError = system(psCommand->ppcArgumentVector[1]);
-        if (iError == -1)
-        {
-          snprintf(acMessage, MESSAGE_SIZE, "%s: NeuteredPath = [%s]: Interpreter = [%s]: Hook (%s) failed to execute \"%s\" (%s).", acRoutine, psFTFileData->pcNeuteredPath, psCommand->acInterpreter, psHook->pcName, psCommand->ppcArgumentVector[1], strerror(errno));
-          MessageHandler(MESSAGE_FLUSH_IT, MESSAGE_INFORMATION, MESSAGE_HOOK_STRING, acMessage);
-        }
-      }
-      else
-      {
-        iError = -1;
-        snprintf(acMessage, MESSAGE_SIZE, "%s: NeuteredPath = [%s]: Interpreter = [%s]: Hook (%s) failed to execute (Usage: eval(\"system\", \"\", \"<command>\")).", acRoutine, psFTFileData->pcNeuteredPath, psCommand->acInterpreter, psHook->pcName);
-        MessageHandler(MESSAGE_FLUSH_IT, MESSAGE_INFORMATION, MESSAGE_HOOK_STRING, acMessage);
-      }
-      KlelFreeCommand(psCommand);
-      exit(iError);
-    }
-    else
-    {
-      snprintf(acMessage, MESSAGE_SIZE, "%s: NeuteredPath = [%s]: Interpreter = [%s]: Hook (%s) requires an unsupported interpreter.", acRoutine, psFTFileData->pcNeuteredPath, psCommand->acInterpreter, psHook->pcName);
-      MessageHandler(MESSAGE_FLUSH_IT, MESSAGE_INFORMATION, MESSAGE_HOOK_STRING, acMessage);
-      KlelFreeCommand(psCommand);
-      exit(-1);
-    }
+    iError = MapRunHookCommand(psProperties, psHook, psCommand, psFTFileData->pcNeuteredPath);
+    MapCloseHookInterpreters(psProperties);
+    KlelFreeCommand(psCommand);
+    exit(iError);
   }
   else
   {
@@ -612,12 +782,27 @@ MapExecuteHook(FTIMES_PROPERTIES *psProperties, FTIMES_FILE_DATA *psFTFileData,
     FD_SET(aaiPipes[PIPE_STDERR_INDEX][PIPE_READER_INDEX], &sFdSaveSet);
     iNToWatch++;
 
+    tStartTime = time(NULL);
     while (iNToWatch > 0)
     {
       struct timeval sTvTimeout = { 1, 0 }; /* The Linux implementation of select() modifies the timeout value, so it must be initialized before each call. */
-      sFdReadSet = sFdSaveSet;
-      iNReady = select(FD_SETSIZE, &sFdReadSet, NULL, NULL, &sTvTimeout);
-      if (iNReady < 0)
+      if (psProperties->iFileHookTimeout > 0 && iKidPid > 0 && time(NULL) - tStartTime >= psProperties->iFileHookTimeout)
+      {
+        snprintf(acMessage, MESSAGE_SIZE, "%s: NeuteredPath = [%s]: Hook (%s) timed out after %d seconds.", acRoutine, psFTFileData->pcNeuteredPath, psHook->pcName, psProperties->iFileHookTimeout);
+        ErrorHandler(ER_Failure, acMessage, ERROR_FAILURE);
+        kill(iKidPid, SIGKILL);
+        for (iFd = 0; iFd < FD_SETSIZE; iFd++) /* Don't wait on the pipes, since the kid's own kids may still hold them open. */
+        {
+          if (FD_ISSET(iFd, &sFdSaveSet))
+          {
+            close(iFd);
+          }
+        }
+        break;
+      }
+      sFdReadSet = sFdSaveSet;
+      iNReady = select(FD_SETSIZE, &sFdReadSet, NULL, NULL, &sTvTimeout);
+      if (iNReady < 0)
       {
         snprintf(pcError, MESSAGE_SIZE, "%s: select(): Hook (%s) failed to select a file descriptor (%s).", acRoutine, psHook->pcName, strerror(errno));
         return ER;
@@ -675,10 +860,10 @@ MapExecuteHook(FTIMES_PROPERTIES *psProperties, FTIMES_FILE_DATA *psFTFileData,
       }
     }
 
-    iKidPid = wait(&iKidStatus);
+    iKidPid = waitpid(iKidPid, &iKidStatus, 0); /* Don't use wait() here -- it could reap a hook worker. */
     if (iKidPid == -1)
     {
-      snprintf(pcError, MESSAGE_SIZE, "%s: wait(): %s", acRoutine, strerror(errno));
+      snprintf(pcError, MESSAGE_SIZE, "%s: waitpid(): %s", acRoutine, strerror(errno));
       return ER;
     }
     iKidReturn = WEXITSTATUS(iKidStatus);
@@ -706,7 +891,7 @@ MapExecuteHook(FTIMES_PROPERTIES *psProperties, FTIMES_FILE_DATA *psFTFileData,
  ***********************************************************************
  */
 int
-MapExecutePythonScript(FTIMES_PROPERTIES *psProperties, HOOK_LIST *psHook, KLEL_COMMAND *psCommand, FTIMES_FILE_DATA *psFTFileData, char *pcMessage)
+MapExecutePythonScript(FTIMES_PROPERTIES *psProperties, HOOK_LIST *psHook, KLEL_COMMAND *psCommand, char *pcNeuteredPath, char *pcMessage)
 {
   int                 iError = -1;
   PyObject           *psPyLocals = NULL;
@@ -725,159 +910,1186 @@ MapExecutePythonScript(FTIMES_PROPERTIES *psProperties, HOOK_LIST *psHook, KLEL_
   psPyLocals = PyDict_New();
   if (psPyLocals == NULL)
   {
-    snprintf(pcMessage, MESSAGE_SIZE, "%s: NeuteredPath = [%s]: Interpreter = [%s]: Hook (%s) failed to execute \"%s\" (could not allocate locals).", "MapExecutePythonScript()", psFTFileData->pcNeuteredPath, psCommand->acInterpreter, psHook->pcName, psCommand->acProgram);
+    snprintf(pcMessage, MESSAGE_SIZE, "%s: NeuteredPath = [%s]: Interpreter = [%s]: Hook (%s) failed to execute \"%s\" (could not allocate locals).", "MapExecutePythonScript()", pcNeuteredPath, psCommand->acInterpreter, psHook->pcName, psCommand->acProgram);
+    MessageHandler(MESSAGE_FLUSH_IT, MESSAGE_INFORMATION, MESSAGE_HOOK_STRING, pcMessage);
+    return iError;
+  }
+
+  /*-
+   *********************************************************************
+   *
+   * Convert and marshall the script's arguments.
+   *
+   *********************************************************************
+   */
+  ppwcArgumentVector = MapConvertPythonArguments(psCommand->szArgumentCount, psCommand->ppcArgumentVector);
+  if (ppwcArgumentVector == NULL)
+  {
+    snprintf(pcMessage, MESSAGE_SIZE, "%s: NeuteredPath = [%s]: Interpreter = [%s]: Hook (%s) failed to execute \"%s\" (could not convert arguments).", "MapExecutePythonScript()", pcNeuteredPath, psCommand->acInterpreter, psHook->pcName, psCommand->acProgram);
     MessageHandler(MESSAGE_FLUSH_IT, MESSAGE_INFORMATION, MESSAGE_HOOK_STRING, pcMessage);
+    Py_XDECREF(psPyLocals);
     return iError;
   }
+  PySys_SetArgvEx(psCommand->szArgumentCount, ppwcArgumentVector, 0);
+
+  /*-
+   *********************************************************************
+   *
+   * Execute the script. Note that we don't care about the result of
+   * the module evaluation since it is generally None. However, we do
+   * care if a SystemExit exception was raised, meaning a return code
+   * was provided.
+   *
+   *********************************************************************
+   */
+  psPyResult = PyEval_EvalCode(psHook->psPyScript, psProperties->psPyGlobals, psPyLocals);
+  psPyExceptionType = PyErr_Occurred();
+  if (psPyExceptionType != NULL)
+  {
+    if (PyErr_ExceptionMatches(PyExc_SystemExit))
+    {
+      PyErr_Fetch(&psPyExceptionType, &psPyException, NULL);
+      if (PyLong_Check(psPyException))
+      {
+        iError = (PyLong_AsLong(psPyException) > INT_MAX) ? -1 : ((int)PyLong_AsLong(psPyException));
+      }
+    }
+    Py_XDECREF(psPyException);
+    PyErr_Clear();
+  }
+  else
+  {
+    iError = 0;
+  }
+
+  /*-
+   *********************************************************************
+   *
+   * Release any remaining local resources.
+   *
+   *********************************************************************
+   */
+  Py_XDECREF(psPyResult);
+  Py_XDECREF(psPyLocals);
+  MapFreePythonArguments(psCommand->szArgumentCount, ppwcArgumentVector);
+
+  return iError;
+}
+#endif
+#endif
+
+
+#ifdef USE_FILE_HOOKS
+/*-
+ ***********************************************************************
+ *
+ * MapFinishHookJob
+ *
+ ***********************************************************************
+ */
+int
+MapFinishHookJob(FTIMES_PROPERTIES *psProperties, HOOK_WORKER *psWorker, int iReturn, int iCheckReturn, char *pcError)
+{
+  const char          acRoutine[] = "MapFinishHookJob()";
+  char                acLocalError[MESSAGE_SIZE] = "";
+
+  /*-
+   *********************************************************************
+   *
+   * Mark the hook as done, and release whatever output is now next in
+   * line. The slot stays busy until its own output has been released.
+   *
+   *********************************************************************
+   */
+  psWorker->iReturn = iReturn;
+  psWorker->iCheckReturn = iCheckReturn;
+  psWorker->iDone = 1;
+
+  if (MapReleaseHookJobs(psProperties, acLocalError) != ER_OK)
+  {
+    snprintf(pcError, MESSAGE_SIZE, "%s: %s", acRoutine, acLocalError);
+    return ER;
+  }
+
+  return ER_OK;
+}
+
+
+/*-
+ ***********************************************************************
+ *
+ * MapGetHookJobCount
+ *
+ ***********************************************************************
+ */
+int
+MapGetHookJobCount(FTIMES_PROPERTIES *psProperties)
+{
+  int                 i = 0;
+  int                 iCount = 0;
+
+  /*-
+   *********************************************************************
+   *
+   * Count the hooks that are still running. Hooks that have finished,
+   * but whose output has yet to be released, are not counted.
+   *
+   *********************************************************************
+   */
+  for (i = 0; psProperties->psHookWorkers != NULL && i < psProperties->iFileHookWorkers; i++)
+  {
+    if (psProperties->psHookWorkers[i].iBusy && !psProperties->psHookWorkers[i].iDone)
+    {
+      iCount++;
+    }
+  }
+
+  return iCount;
+}
+
+
+/*-
+ ***********************************************************************
+ *
+ * MapGetHookWorker
+ *
+ ***********************************************************************
+ */
+HOOK_WORKER *
+MapGetHookWorker(FTIMES_PROPERTIES *psProperties, int iEmbedded)
+{
+  HOOK_WORKER        *psEmpty = NULL;
+  HOOK_WORKER        *psIdle = NULL;
+  HOOK_WORKER        *psWorker = NULL;
+  int                 i = 0;
+
+  /*-
+   *********************************************************************
+   *
+   * Embedded interpreter commands prefer an idle worker, since it has
+   * already paid to load the interpreter. Other commands need a slot
+   * of their own, so they'll retire an idle worker if they must. NULL
+   * means every slot is busy. Note that a slot whose hook has finished
+   * remains busy until its output has been released.
+   *
+   *********************************************************************
+   */
+  for (i = 0; i < psProperties->iFileHookWorkers; i++)
+  {
+    psWorker = &psProperties->psHookWorkers[i];
+    if (psWorker->iBusy)
+    {
+      continue;
+    }
+    if (psWorker->iKidPid <= 0)
+    {
+      psEmpty = (psEmpty == NULL) ? psWorker : psEmpty;
+    }
+    else if (!psWorker->iBusy)
+    {
+      psIdle = (psIdle == NULL) ? psWorker : psIdle;
+    }
+  }
+
+  if (iEmbedded)
+  {
+    return (psIdle != NULL) ? psIdle : psEmpty;
+  }
+  if (psEmpty == NULL && psIdle != NULL)
+  {
+    MapStopHookWorker(psIdle, 0);
+    psEmpty = psIdle;
+  }
+
+  return psEmpty;
+}
+#endif
+
+
+/*-
+ ***********************************************************************
+ *
+ * MapGetDirectoryCount
+ *
+ ***********************************************************************
+ */
+int
+MapGetDirectoryCount()
+{
+  return giDirectories;
+}
+
+
+/*-
+ ***********************************************************************
+ *
+ * MapGetFileCount
+ *
+ ***********************************************************************
+ */
+int
+MapGetFileCount()
+{
+  return giFiles;
+}
+
+
+/*-
+ ***********************************************************************
+ *
+ * MapGetSpecialCount
+ *
+ ***********************************************************************
+ */
+int
+MapGetSpecialCount()
+{
+  return giSpecial;
+}
+
+
+#ifdef WINNT
+/*-
+ ***********************************************************************
+ *
+ * MapGetStreamCount
+ *
+ ***********************************************************************
+ */
+int
+MapGetStreamCount()
+{
+  return giStreams;
+}
+#endif
+
+
+/*-
+ ***********************************************************************
+ *
+ * MapGetRecordCount
+ *
+ ***********************************************************************
+ */
+int
+MapGetRecordCount()
+{
+  return giRecords;
+}
+
+
+/*-
+ ***********************************************************************
+ *
+ * MapGetIncompleteRecordCount
+ *
+ ***********************************************************************
+ */
+int
+MapGetIncompleteRecordCount()
+{
+  return giIncompleteRecords;
+}
+
+
+#ifdef USE_FILE_HOOKS
+/*-
+ ***********************************************************************
+ *
+ * MapPollHookWorkers
+ *
+ ***********************************************************************
+ */
+int
+MapPollHookWorkers(FTIMES_PROPERTIES *psProperties, int iWait, char *pcError)
+{
+  const char          acRoutine[] = "MapPollHookWorkers()";
+  char                acLocalError[MESSAGE_SIZE] = "";
+  char                acMessage[MESSAGE_SIZE] = "";
+  fd_set              sFdReadSet;
+  HOOK_WORKER        *psWorker = NULL;
+  int                 i = 0;
+  int                 iError = 0;
+  int                 iKidStatus = 0;
+  int                 iNReady = 0;
+  int                 iNToWatch = 0;
+  int                 iReturn = 0;
+  struct timeval      sTvTimeout = { 0, 0 };
+
+  if (psProperties->psHookWorkers == NULL)
+  {
+    return ER_OK;
+  }
+
+  /*-
+   *********************************************************************
+   *
+   * Kill anything that has overstayed its welcome, and gather up the
+   * descriptors of those that are still running.
+   *
+   *********************************************************************
+   */
+  FD_ZERO(&sFdReadSet);
+  for (i = 0; i < psProperties->iFileHookWorkers; i++)
+  {
+    psWorker = &psProperties->psHookWorkers[i];
+    if (!psWorker->iBusy || psWorker->iDone)
+    {
+      continue;
+    }
+    if (psProperties->iFileHookTimeout > 0 && time(NULL) - psWorker->tStartTime >= psProperties->iFileHookTimeout)
+    {
+      snprintf(acMessage, MESSAGE_SIZE, "%s: NeuteredPath = [%s]: Hook (%s) timed out after %d seconds.", acRoutine, psWorker->pcNeuteredPath, psWorker->psHook->pcName, psProperties->iFileHookTimeout);
+      ErrorHandler(ER_Failure, acMessage, ERROR_FAILURE);
+      MapStopHookWorker(psWorker, SIGKILL);
+      iError = MapFinishHookJob(psProperties, psWorker, 0, 0, acLocalError);
+      if (iError != ER_OK)
+      {
+        snprintf(pcError, MESSAGE_SIZE, "%s: %s", acRoutine, acLocalError);
+        return ER;
+      }
+      continue;
+    }
+    if (psWorker->iResponseFd >= 0)
+    {
+      FD_SET(psWorker->iResponseFd, &sFdReadSet);
+    }
+    if (psWorker->iStdoutFd >= 0)
+    {
+      FD_SET(psWorker->iStdoutFd, &sFdReadSet);
+    }
+    if (psWorker->iStderrFd >= 0)
+    {
+      FD_SET(psWorker->iStderrFd, &sFdReadSet);
+    }
+    iNToWatch++;
+  }
+  if (iNToWatch == 0)
+  {
+    return ER_OK;
+  }
+
+  sTvTimeout.tv_sec = (iWait) ? 1 : 0;
+  iNReady = select(FD_SETSIZE, &sFdReadSet, NULL, NULL, &sTvTimeout);
+  if (iNReady < 0)
+  {
+    if (errno == EINTR)
+    {
+      return ER_OK;
+    }
+    snprintf(pcError, MESSAGE_SIZE, "%s: select(): %s", acRoutine, strerror(errno));
+    return ER;
+  }
+
+  /*-
+   *********************************************************************
+   *
+   * Relay output and retire the hooks that have completed. A worker
+   * is done when it sends back a return code. A one-shot kid is done
+   * when both of its output pipes have closed.
+   *
+   *********************************************************************
+   */
+  for (i = 0; iNReady > 0 && i < psProperties->iFileHookWorkers; i++)
+  {
+    psWorker = &psProperties->psHookWorkers[i];
+    if (!psWorker->iBusy || psWorker->iDone)
+    {
+      continue;
+    }
+    if (psWorker->iStdoutFd >= 0 && FD_ISSET(psWorker->iStdoutFd, &sFdReadSet) && MapReadHookOutput(psProperties, psWorker, psWorker->iStdoutFd, acLocalError) != ER_OK)
+    {
+      snprintf(pcError, MESSAGE_SIZE, "%s: %s", acRoutine, acLocalError);
+      return ER;
+    }
+    if (psWorker->iStderrFd >= 0 && FD_ISSET(psWorker->iStderrFd, &sFdReadSet) && MapReadHookOutput(psProperties, psWorker, psWorker->iStderrFd, acLocalError) != ER_OK)
+    {
+      snprintf(pcError, MESSAGE_SIZE, "%s: %s", acRoutine, acLocalError);
+      return ER;
+    }
+    if (psWorker->iOneShot)
+    {
+      if (psWorker->iStdoutFd >= 0 || psWorker->iStderrFd >= 0)
+      {
+        continue;
+      }
+      while (waitpid(psWorker->iKidPid, &iKidStatus, 0) == -1 && errno == EINTR)
+      {
+        continue;
+      }
+      psWorker->iKidPid = 0;
+      iError = MapFinishHookJob(psProperties, psWorker, WEXITSTATUS(iKidStatus), WIFEXITED(iKidStatus), acLocalError);
+    }
+    else
+    {
+      if (!FD_ISSET(psWorker->iResponseFd, &sFdReadSet))
+      {
+        continue;
+      }
+      iError = HookReadData(psWorker->iResponseFd, &iReturn, sizeof(iReturn));
+      if
+      (
+           MapReadHookOutput(psProperties, psWorker, psWorker->iStdoutFd, acLocalError) != ER_OK
+        || MapReadHookOutput(psProperties, psWorker, psWorker->iStderrFd, acLocalError) != ER_OK
+      )
+      {
+        snprintf(pcError, MESSAGE_SIZE, "%s: %s", acRoutine, acLocalError);
+        return ER;
+      }
+      if (iError != ER_OK)
+      {
+        snprintf(acMessage, MESSAGE_SIZE, "%s: NeuteredPath = [%s]: Hook (%s) worker (%d) exited unexpectedly.", acRoutine, psWorker->pcNeuteredPath, psWorker->psHook->pcName, psWorker->iKidPid);
+        ErrorHandler(ER_Failure, acMessage, ERROR_FAILURE);
+        MapStopHookWorker(psWorker, SIGKILL);
+        iError = MapFinishHookJob(psProperties, psWorker, 0, 0, acLocalError);
+      }
+      else
+      {
+        iError = MapFinishHookJob(psProperties, psWorker, iReturn & 0xff, 1, acLocalError); /* Mimic WEXITSTATUS() so that results match those of one-shot kids. */
+      }
+    }
+    if (iError != ER_OK)
+    {
+      snprintf(pcError, MESSAGE_SIZE, "%s: %s", acRoutine, acLocalError);
+      return ER;
+    }
+  }
+
+  return ER_OK;
+}
+
+
+/*-
+ ***********************************************************************
+ *
+ * MapReadHookOutput
+ *
+ ***********************************************************************
+ */
+int
+MapReadHookOutput(FTIMES_PROPERTIES *psProperties, HOOK_WORKER *psWorker, int iFd, char *pcError)
+{
+  const char          acRoutine[] = "MapReadHookOutput()";
+  char                acData[PIPE_READ_SIZE] = "";
+  char               *pcOutput = NULL;
+  int                 iNRead = 0;
+  int                 iNWritten = 0;
+
+  /*-
+   *********************************************************************
+   *
+   * The kid's output pipes are nonblocking, so read until they are
+   * empty. Stdout is held until the hook completes so that it comes
+   * out in one piece, and stderr goes straight to the log.
+   *
+   *********************************************************************
+   */
+  while (iFd >= 0)
+  {
+    iNRead = read(iFd, acData, PIPE_READ_SIZE);
+    if (iNRead < 0)
+    {
+      if (errno == EINTR)
+      {
+        continue;
+      }
+      if (errno == EAGAIN || errno == EWOULDBLOCK)
+      {
+        break;
+      }
+      snprintf(pcError, MESSAGE_SIZE, "%s: read(): Hook (%s) failed to read file descriptor %d (%s)", acRoutine, psWorker->psHook->pcName, iFd, strerror(errno));
+      return ER;
+    }
+    if (iNRead == 0)
+    {
+      if (psWorker->iOneShot) /* A worker that hits EOF is dead, and the caller will find out when it reads the return code. */
+      {
+        close(iFd);
+        if (iFd == psWorker->iStdoutFd)
+        {
+          psWorker->iStdoutFd = -1;
+        }
+        else
+        {
+          psWorker->iStderrFd = -1;
+        }
+      }
+      break;
+    }
+    if (iFd == psWorker->iStdoutFd)
+    {
+      if (psWorker->iOutputLength + iNRead > psWorker->iOutputSize)
+      {
+        psWorker->iOutputSize = (psWorker->iOutputSize > 0) ? psWorker->iOutputSize : HOOK_OUTPUT_BUFFER_SIZE;
+        while (psWorker->iOutputLength + iNRead > psWorker->iOutputSize)
+        {
+          psWorker->iOutputSize *= 2;
+        }
+        pcOutput = realloc(psWorker->pcOutput, psWorker->iOutputSize);
+        if (pcOutput == NULL)
+        {
+          snprintf(pcError, MESSAGE_SIZE, "%s: realloc(): %s", acRoutine, strerror(errno));
+          return ER;
+        }
+        psWorker->pcOutput = pcOutput;
+      }
+      memcpy(&psWorker->pcOutput[psWorker->iOutputLength], acData, iNRead);
+      psWorker->iOutputLength += iNRead;
+    }
+    else
+    {
+      iNWritten = fwrite(acData, 1, iNRead, psProperties->pFileLog);
+      if (iNWritten != iNRead)
+      {
+        snprintf(pcError, MESSAGE_SIZE, "%s: fwrite(): Hook (%s) failed to write on file descriptor %d (%s)", acRoutine, psWorker->psHook->pcName, iFd, strerror(errno));
+        return ER;
+      }
+    }
+  }
+
+  return ER_OK;
+}
+
+
+/*-
+ ***********************************************************************
+ *
+ * MapReleaseHookJobs
+ *
+ ***********************************************************************
+ */
+int
+MapReleaseHookJobs(FTIMES_PROPERTIES *psProperties, char *pcError)
+{
+  const char          acRoutine[] = "MapReleaseHookJobs()";
+  char                acMessage[MESSAGE_SIZE] = "";
+  HOOK_WORKER        *psNext = NULL;
+  HOOK_WORKER        *psRunning = NULL;
+  HOOK_WORKER        *psWorker = NULL;
+  int                 i = 0;
+  int                 iError = ER_OK;
+  int                 iNWritten = 0;
+
+  /*-
+   *********************************************************************
+   *
+   * Release finished hooks in the order they were dispatched, which is
+   * the order of the records they belong to. A finished hook must wait
+   * while any hook dispatched before it is still running.
+   *
+   *********************************************************************
+   */
+  while (psProperties->psHookWorkers != NULL)
+  {
+    psNext = psRunning = NULL;
+    for (i = 0; i < psProperties->iFileHookWorkers; i++)
+    {
+      psWorker = &psProperties->psHookWorkers[i];
+      if (!psWorker->iBusy)
+      {
+        continue;
+      }
+      if (psWorker->iDone)
+      {
+        psNext = (psNext == NULL || psWorker->ui64Sequence < psNext->ui64Sequence) ? psWorker : psNext;
+      }
+      else
+      {
+        psRunning = (psRunning == NULL || psWorker->ui64Sequence < psRunning->ui64Sequence) ? psWorker : psRunning;
+      }
+    }
+    if (psNext == NULL || (psRunning != NULL && psRunning->ui64Sequence < psNext->ui64Sequence))
+    {
+      break;
+    }
+
+    /*-
+     *******************************************************************
+     *
+     * Emit the hook's output as a single block, and check its return
+     * code against the ones the hook considers successful.
+     *
+     *******************************************************************
+     */
+    if (psNext->iOutputLength > 0)
+    {
+      iNWritten = fwrite(psNext->pcOutput, 1, psNext->iOutputLength, psProperties->pFileOut);
+      if (iNWritten != psNext->iOutputLength)
+      {
+        snprintf(pcError, MESSAGE_SIZE, "%s: NeuteredPath = [%s]: fwrite(): Hook (%s) failed to write its output (%s)", acRoutine, psNext->pcNeuteredPath, psNext->psHook->pcName, strerror(errno));
+        iError = ER;
+      }
+      else
+      {
+        MD5Cycle(&psProperties->sOutFileHashContext, (unsigned char *) psNext->pcOutput, iNWritten);
+      }
+    }
+    if (psNext->iCheckReturn && !KlelIsSuccessReturnCode(psNext->psHook->psContext, psNext->iReturn))
+    {
+      snprintf(acMessage, MESSAGE_SIZE, "%s: NeuteredPath = [%s]: Hook (%s) returned an unexpected exit code (%d).", acRoutine, psNext->pcNeuteredPath, psNext->psHook->pcName, psNext->iReturn);
+      ErrorHandler(ER_Failure, acMessage, ERROR_FAILURE);
+    }
+
+    free(psNext->pcNeuteredPath);
+    psNext->pcNeuteredPath = NULL;
+    psNext->psHook = NULL;
+    psNext->iOutputLength = 0;
+    psNext->iDone = 0;
+    psNext->iBusy = 0;
+  }
+
+  return iError;
+}
+
+
+/*-
+ ***********************************************************************
+ *
+ * MapRunHookCommand
+ *
+ ***********************************************************************
+ */
+int
+MapRunHookCommand(FTIMES_PROPERTIES *psProperties, HOOK_LIST *psHook, KLEL_COMMAND *psCommand, char *pcNeuteredPath)
+{
+  const char          acRoutine[] = "MapRunHookCommand()";
+  char                acMessage[MESSAGE_SIZE] = "";
+  int                 iError = 0;
+#ifdef USE_EMBEDDED_PERL
+  SV                 *psScalarValue = NULL;
+#endif
+
+  if (0)
+  {
+    /* Empty */
+  }
+#ifdef USE_EMBEDDED_LUA
+  else if (strcmp(psCommand->acInterpreter, "lua") == 0)
+  {
+    /*-
+     *******************************************************************
+     *
+     * The Lua state lives as long as the kid, and compiled scripts are
+     * cached in the registry (keyed by path), so each script is only
+     * loaded once per worker.
+     *
+     *******************************************************************
+     */
+    if (gpsHookLuaState == NULL)
+    {
+      gpsHookLuaState = luaL_newstate();
+      if (gpsHookLuaState == NULL)
+      {
+        snprintf(acMessage, MESSAGE_SIZE, "%s: NeuteredPath = [%s]: Interpreter = [%s]: Hook (%s) failed to load lua state \"%s\" (%s).", acRoutine, pcNeuteredPath, psCommand->acInterpreter, psHook->pcName, psCommand->acProgram, strerror(errno));
+        MessageHandler(MESSAGE_FLUSH_IT, MESSAGE_INFORMATION, MESSAGE_HOOK_STRING, acMessage);
+        return -2;
+      }
+      luaL_openlibs(gpsHookLuaState);
+      lua_register(gpsHookLuaState, "neuter_string", lua_neuter_string);
+    }
+
+    lua_getfield(gpsHookLuaState, LUA_REGISTRYINDEX, psCommand->ppcArgumentVector[0]);
+    if (!lua_isfunction(gpsHookLuaState, -1))
+    {
+      lua_pop(gpsHookLuaState, 1);
+      iError = luaL_loadfile(gpsHookLuaState, psCommand->ppcArgumentVector[0]);
+      if (iError != 0)
+      {
+        snprintf(acMessage, MESSAGE_SIZE, "%s: NeuteredPath = [%s]: Interpreter = [%s]: Hook (%s) failed to execute \"%s\" (%s).", acRoutine, pcNeuteredPath, psCommand->acInterpreter, psHook->pcName, psCommand->acProgram, lua_tostring(gpsHookLuaState, -1));
+        MessageHandler(MESSAGE_FLUSH_IT, MESSAGE_INFORMATION, MESSAGE_HOOK_STRING, acMessage);
+        lua_settop(gpsHookLuaState, 0);
+        return iError;
+      }
+      lua_pushvalue(gpsHookLuaState, -1);
+      lua_setfield(gpsHookLuaState, LUA_REGISTRYINDEX, psCommand->ppcArgumentVector[0]);
+    }
+
+    lua_newtable(gpsHookLuaState);
+    lua_pushnumber(gpsHookLuaState, 1);                               /* Push the table index. */
+    lua_pushstring(gpsHookLuaState, psCommand->ppcArgumentVector[1]); /* Push the cell value. */
+    lua_rawset(gpsHookLuaState, -3);                                  /* Store the pair in the table. */
+    lua_setglobal(gpsHookLuaState, "aArgs");
+
+    iError = lua_pcall(gpsHookLuaState, 0, LUA_MULTRET, 0);
+    if (iError != 0)
+    {
+      snprintf(acMessage, MESSAGE_SIZE, "%s: NeuteredPath = [%s]: Interpreter = [%s]: Hook (%s) failed to execute \"%s\" (%s).", acRoutine, pcNeuteredPath, psCommand->acInterpreter, psHook->pcName, psCommand->acProgram, lua_tostring(gpsHookLuaState, -1));
+      MessageHandler(MESSAGE_FLUSH_IT, MESSAGE_INFORMATION, MESSAGE_HOOK_STRING, acMessage);
+    }
+    lua_settop(gpsHookLuaState, 0);
+  }
+#endif
+#ifdef USE_EMBEDDED_PERL
+  else if (strcmp(psCommand->acInterpreter, "perl") == 0)
+  {
+    dSP;
+    giHookPerlUsed = 1;
+    ENTER;
+//  SAVETMPS; /* This should not be needed since mortal variables are not created/used. */
+    call_argv("Embed::Persistent::EvalScript", G_EVAL | G_KEEPERR | G_SCALAR, psCommand->ppcArgumentVector); /* Do not use G_DISCARD here so that Perl stack items are preserved. */
+    SPAGAIN;
+    psScalarValue = POPs;
+    PUTBACK;
+    if (SvTRUE(ERRSV))
+    {
+      iError = -1;
+      snprintf(acMessage, MESSAGE_SIZE, "%s: NeuteredPath = [%s]: Interpreter = [%s]: Hook (%s) failed to execute \"%s\" (%s).", acRoutine, pcNeuteredPath, psCommand->acInterpreter, psHook->pcName, psCommand->acProgram, SvPV_nolen(ERRSV));
+      MessageHandler(MESSAGE_FLUSH_IT, MESSAGE_INFORMATION, MESSAGE_HOOK_STRING, acMessage);
+      sv_setpvs(ERRSV, ""); /* G_KEEPERR accumulates errors, so clear them before the next script runs. */
+    }
+    else
+    {
+      if (SvOK(psScalarValue) && SvIOK(psScalarValue)) /* Expect the Perl stack to contain exactly one defined integer value. */
+      {
+        iError = SvIV(psScalarValue);
+      }
+      else
+      {
+        iError = -1;
+        snprintf(acMessage, MESSAGE_SIZE, "%s: NeuteredPath = [%s]: Interpreter = [%s]: Hook (%s) failed to execute \"%s\" (No $@).", acRoutine, pcNeuteredPath, psCommand->acInterpreter, psHook->pcName, psCommand->acProgram);
+        MessageHandler(MESSAGE_FLUSH_IT, MESSAGE_INFORMATION, MESSAGE_HOOK_STRING, acMessage);
+      }
+    }
+//  FREETMPS; /* This should not be needed since mortal variables are not created/used. */
+    LEAVE;
+    PerlIO_flush(PerlIO_stdout());
+    PerlIO_flush(PerlIO_stderr());
+  }
+#endif
+#ifdef USE_EMBEDDED_PYTHON
+  else if (strcmp(psCommand->acInterpreter, "python") == 0)
+  {
+    giHookPythonUsed = 1;
+    iError = MapExecutePythonScript(psProperties, psHook, psCommand, pcNeuteredPath, acMessage);
+    PyRun_SimpleString("import sys\nsys.stdout.flush()\nsys.stderr.flush()\n");
+  }
+#endif
+  else if (strcmp(psCommand->acInterpreter, "system") == 0)
+  {
+    if
+    (
+         psCommand->ppcArgumentVector[0] != NULL
+      && psCommand->ppcArgumentVector[1] != NULL
+      && strcmp(psCommand->ppcArgumentVector[0], "") == 0
+      && strcmp(psCommand->ppcArgumentVector[1], "") != 0
+    )
+    {
+      iError = system(psCommand->ppcArgumentVector[1]);
+      if (iError == -1)
+      {
+        snprintf(acMessage, MESSAGE_SIZE, "%s: NeuteredPath = [%s]: Interpreter = [%s]: Hook (%s) failed to execute \"%s\" (%s).", acRoutine, pcNeuteredPath, psCommand->acInterpreter, psHook->pcName, psCommand->ppcArgumentVector[1], strerror(errno));
+        MessageHandler(MESSAGE_FLUSH_IT, MESSAGE_INFORMATION, MESSAGE_HOOK_STRING, acMessage);
+      }
+    }
+    else
+    {
+      iError = -1;
+      snprintf(acMessage, MESSAGE_SIZE, "%s: NeuteredPath = [%s]: Interpreter = [%s]: Hook (%s) failed to execute (Usage: eval(\"system\", \"\", \"<command>\")).", acRoutine, pcNeuteredPath, psCommand->acInterpreter, psHook->pcName);
+      MessageHandler(MESSAGE_FLUSH_IT, MESSAGE_INFORMATION, MESSAGE_HOOK_STRING, acMessage);
+    }
+  }
+  else
+  {
+    iError = -1;
+    snprintf(acMessage, MESSAGE_SIZE, "%s: NeuteredPath = [%s]: Interpreter = [%s]: Hook (%s) requires an unsupported interpreter.", acRoutine, pcNeuteredPath, psCommand->acInterpreter, psHook->pcName);
+    MessageHandler(MESSAGE_FLUSH_IT, MESSAGE_INFORMATION, MESSAGE_HOOK_STRING, acMessage);
+  }
+
+  fflush(stdout);
+  fflush(stderr);
+
+  return iError;
+}
+
+
+/*-
+ ***********************************************************************
+ *
+ * MapServeHookWorker
+ *
+ ***********************************************************************
+ */
+void
+MapServeHookWorker(FTIMES_PROPERTIES *psProperties, HOOK_WORKER *psWorker)
+{
+  const char          acRoutine[] = "MapServeHookWorker()";
+  char                acLocalError[MESSAGE_SIZE] = "";
+  char                acMessage[MESSAGE_SIZE] = "";
+  char               *pcNeuteredPath = NULL;
+  HOOK_LIST          *psHook = NULL;
+  int                 i = 0;
+  int                 iHookIndex = 0;
+  int                 iReturn = 0;
+  KLEL_COMMAND       *psCommand = NULL;
+
+  /*-
+   *********************************************************************
+   *
+   * The parent relays this worker's stderr to the log, so messages
+   * must not also be written to the log stream inherited from it.
+   *
+   *********************************************************************
+   */
+  MessageSetOutputStream(NULL);
+
+  /*-
+   *********************************************************************
+   *
+   * Run commands until the parent closes the request pipe. Each one
+   * is answered with its return code once its output has been flushed.
+   *
+   *********************************************************************
+   */
+  while (HookReadCommand(psWorker->iRequestFd, &iHookIndex, &pcNeuteredPath, &psCommand, acLocalError) == ER_OK)
+  {
+    for (i = 0, psHook = psProperties->psFileHookList; psHook != NULL && i < iHookIndex; i++)
+    {
+      psHook = psHook->psNext;
+    }
+    iReturn = (psHook != NULL) ? MapRunHookCommand(psProperties, psHook, psCommand, pcNeuteredPath) : -1;
+    HookFreeCommand(psCommand);
+    free(pcNeuteredPath);
+    if (HookWriteData(psWorker->iResponseFd, &iReturn, sizeof(iReturn)) != ER_OK)
+    {
+      break;
+    }
+  }
+  if (acLocalError[0])
+  {
+    snprintf(acMessage, MESSAGE_SIZE, "%s: %s", acRoutine, acLocalError);
+    ErrorHandler(ER_Failure, acMessage, ERROR_FAILURE);
+  }
+
+  MapCloseHookInterpreters(psProperties);
+  _exit(0); /* Don't flush stdio buffers inherited from the parent. */
+}
+
+
+/*-
+ ***********************************************************************
+ *
+ * MapStartHookKid
+ *
+ ***********************************************************************
+ */
+int
+MapStartHookKid(FTIMES_PROPERTIES *psProperties, HOOK_WORKER *psWorker, HOOK_LIST *psHook, KLEL_COMMAND *psCommand, char *pcNeuteredPath, char *pcError)
+{
+  const char          acRoutine[] = "MapStartHookKid()";
+  char                acMessage[MESSAGE_SIZE] = "";
+  int                 aaiPipes[3][2];
+  int                 i = 0;
+  int                 iError = 0;
+  int                 iKidPid = 0;
+
+  /*-
+   *********************************************************************
+   *
+   * Create stdin/stdout/stderr pipes.
+   *
+   *********************************************************************
+   */
+  for (i = 0; i < 3; i++)
+  {
+    iError = pipe(aaiPipes[i]);
+    if (iError == -1)
+    {
+      snprintf(pcError, MESSAGE_SIZE, "%s: pipe(): %s", acRoutine, strerror(errno));
+      while (i > 0)
+      {
+        i--;
+        close(aaiPipes[i][PIPE_READER_INDEX]);
+        close(aaiPipes[i][PIPE_WRITER_INDEX]);
+      }
+      return ER;
+    }
+  }
+
+  /*-
+   *********************************************************************
+   *
+   * Fork off a kid to run the command. Flush first so that the kid
+   * doesn't write out a second copy of anything that's still buffered.
+   *
+   *********************************************************************
+   */
+  fflush(psProperties->pFileOut);
+  fflush(psProperties->pFileLog);
+  fflush(stdout);
+  fflush(stderr);
+
+  iKidPid = fork();
+  if (iKidPid == -1)
+  {
+    snprintf(pcError, MESSAGE_SIZE, "%s: fork(): %s", acRoutine, strerror(errno));
+    for (i = 0; i < 3; i++)
+    {
+      close(aaiPipes[i][PIPE_READER_INDEX]);
+      close(aaiPipes[i][PIPE_WRITER_INDEX]);
+    }
+    return ER;
+  }
+  else if (iKidPid == 0)
+  {
+    MapCloseHookDescriptors(psProperties);
+    close(aaiPipes[PIPE_STDIN_INDEX][PIPE_WRITER_INDEX]);
+    close(aaiPipes[PIPE_STDOUT_INDEX][PIPE_READER_INDEX]);
+    close(aaiPipes[PIPE_STDERR_INDEX][PIPE_READER_INDEX]);
+    dup2(aaiPipes[PIPE_STDIN_INDEX][PIPE_READER_INDEX], 0);
+    dup2(aaiPipes[PIPE_STDOUT_INDEX][PIPE_WRITER_INDEX], 1);
+    dup2(aaiPipes[PIPE_STDERR_INDEX][PIPE_WRITER_INDEX], 2);
+    if (strcmp(psCommand->acInterpreter, "exec") == 0)
+    {
+      execv(psCommand->acProgram, psCommand->ppcArgumentVector);
+      snprintf(acMessage, MESSAGE_SIZE, "%s: NeuteredPath = [%s]: Interpreter = [%s]: Hook (%s) failed to execute \"%s\" (%s).", acRoutine, pcNeuteredPath, psCommand->acInterpreter, psHook->pcName, psCommand->acProgram, strerror(errno));
+      MessageHandler(MESSAGE_FLUSH_IT, MESSAGE_INFORMATION, MESSAGE_HOOK_STRING, acMessage);
+      exit(-1);
+    }
+    iError = MapRunHookCommand(psProperties, psHook, psCommand, pcNeuteredPath);
+    MapCloseHookInterpreters(psProperties);
+    exit(iError);
+  }
+
+  close(aaiPipes[PIPE_STDIN_INDEX][PIPE_READER_INDEX]);
+  close(aaiPipes[PIPE_STDIN_INDEX][PIPE_WRITER_INDEX]); /* There's nothing to send to the kid on stdin. */
+  close(aaiPipes[PIPE_STDOUT_INDEX][PIPE_WRITER_INDEX]);
+  close(aaiPipes[PIPE_STDERR_INDEX][PIPE_WRITER_INDEX]);
+  psWorker->iKidPid = iKidPid;
+  psWorker->iOneShot = 1;
+  psWorker->iRequestFd = -1;
+  psWorker->iResponseFd = -1;
+  psWorker->iStdoutFd = aaiPipes[PIPE_STDOUT_INDEX][PIPE_READER_INDEX];
+  psWorker->iStderrFd = aaiPipes[PIPE_STDERR_INDEX][PIPE_READER_INDEX];
+  fcntl(psWorker->iStdoutFd, F_SETFD, FD_CLOEXEC);
+  fcntl(psWorker->iStderrFd, F_SETFD, FD_CLOEXEC);
+  fcntl(psWorker->iStdoutFd, F_SETFL, fcntl(psWorker->iStdoutFd, F_GETFL) | O_NONBLOCK);
+  fcntl(psWorker->iStderrFd, F_SETFL, fcntl(psWorker->iStderrFd, F_GETFL) | O_NONBLOCK);
+
+  return ER_OK;
+}
+
+
+/*-
+ ***********************************************************************
+ *
+ * MapStartHookWorker
+ *
+ ***********************************************************************
+ */
+int
+MapStartHookWorker(FTIMES_PROPERTIES *psProperties, HOOK_WORKER *psWorker, char *pcError)
+{
+  const char          acRoutine[] = "MapStartHookWorker()";
+#define WORKER_REQUEST_INDEX 0
+#define WORKER_RESPONSE_INDEX 1
+#define WORKER_STDOUT_INDEX 2
+#define WORKER_STDERR_INDEX 3
+  int                 aaiPipes[4][2];
+  int                 i = 0;
+  int                 iError = 0;
+  int                 iKidPid = 0;
 
   /*-
    *********************************************************************
    *
-   * Convert and marshall the script's arguments.
+   * Create request/response/stdout/stderr pipes.
    *
    *********************************************************************
    */
-  ppwcArgumentVector = MapConvertPythonArguments(psCommand->szArgumentCount, psCommand->ppcArgumentVector);
-  if (ppwcArgumentVector == NULL)
+  for (i = 0; i < 4; i++)
   {
-    snprintf(pcMessage, MESSAGE_SIZE, "%s: NeuteredPath = [%s]: Interpreter = [%s]: Hook (%s) failed to execute \"%s\" (could not convert arguments).", "MapExecutePythonScript()", psFTFileData->pcNeuteredPath, psCommand->acInterpreter, psHook->pcName, psCommand->acProgram);
-    MessageHandler(MESSAGE_FLUSH_IT, MESSAGE_INFORMATION, MESSAGE_HOOK_STRING, pcMessage);
-    Py_XDECREF(psPyLocals);
-    return iError;
+    iError = pipe(aaiPipes[i]);
+    if (iError == -1)
+    {
+      snprintf(pcError, MESSAGE_SIZE, "%s: pipe(): %s", acRoutine, strerror(errno));
+      while (i > 0)
+      {
+        i--;
+        close(aaiPipes[i][PIPE_READER_INDEX]);
+        close(aaiPipes[i][PIPE_WRITER_INDEX]);
+      }
+      return ER;
+    }
   }
-  PySys_SetArgvEx(psCommand->szArgumentCount, ppwcArgumentVector, 0);
 
   /*-
    *********************************************************************
    *
-   * Execute the script. Note that we don't care about the result of
-   * the module evaluation since it is generally None. However, we do
-   * care if a SystemExit exception was raised, meaning a return code
-   * was provided.
+   * A dead worker must not take the parent with it, and anything that
+   * is still buffered must not be written twice (once by each side).
    *
    *********************************************************************
    */
-  psPyResult = PyEval_EvalCode(psHook->psPyScript, psProperties->psPyGlobals, psPyLocals);
-  psPyExceptionType = PyErr_Occurred();
-  if (psPyExceptionType != NULL)
+  signal(SIGPIPE, SIG_IGN);
+  fflush(psProperties->pFileOut);
+  fflush(psProperties->pFileLog);
+  fflush(stdout);
+  fflush(stderr);
+
+  iKidPid = fork();
+  if (iKidPid == -1)
   {
-    if (PyErr_ExceptionMatches(PyExc_SystemExit))
+    snprintf(pcError, MESSAGE_SIZE, "%s: fork(): %s", acRoutine, strerror(errno));
+    for (i = 0; i < 4; i++)
     {
-      PyErr_Fetch(&psPyExceptionType, &psPyException, NULL);
-      if (PyLong_Check(psPyException))
-      {
-        iError = (PyLong_AsLong(psPyException) > INT_MAX) ? -1 : ((int)PyLong_AsLong(psPyException));
-      }
+      close(aaiPipes[i][PIPE_READER_INDEX]);
+      close(aaiPipes[i][PIPE_WRITER_INDEX]);
     }
-    Py_XDECREF(psPyException);
-    PyErr_Clear();
+    return ER;
   }
-  else
+  else if (iKidPid == 0)
   {
-    iError = 0;
+    MapCloseHookDescriptors(psProperties);
+    close(aaiPipes[WORKER_REQUEST_INDEX][PIPE_WRITER_INDEX]);
+    close(aaiPipes[WORKER_RESPONSE_INDEX][PIPE_READER_INDEX]);
+    close(aaiPipes[WORKER_STDOUT_INDEX][PIPE_READER_INDEX]);
+    close(aaiPipes[WORKER_STDERR_INDEX][PIPE_READER_INDEX]);
+    dup2(aaiPipes[WORKER_STDOUT_INDEX][PIPE_WRITER_INDEX], 1);
+    dup2(aaiPipes[WORKER_STDERR_INDEX][PIPE_WRITER_INDEX], 2);
+    close(aaiPipes[WORKER_STDOUT_INDEX][PIPE_WRITER_INDEX]);
+    close(aaiPipes[WORKER_STDERR_INDEX][PIPE_WRITER_INDEX]);
+    psWorker->iRequestFd = aaiPipes[WORKER_REQUEST_INDEX][PIPE_READER_INDEX];
+    psWorker->iResponseFd = aaiPipes[WORKER_RESPONSE_INDEX][PIPE_WRITER_INDEX];
+    MapServeHookWorker(psProperties, psWorker); /* This does not return. */
   }
 
+  close(aaiPipes[WORKER_REQUEST_INDEX][PIPE_READER_INDEX]);
+  close(aaiPipes[WORKER_RESPONSE_INDEX][PIPE_WRITER_INDEX]);
+  close(aaiPipes[WORKER_STDOUT_INDEX][PIPE_WRITER_INDEX]);
+  close(aaiPipes[WORKER_STDERR_INDEX][PIPE_WRITER_INDEX]);
+  psWorker->iKidPid = iKidPid;
+  psWorker->iOneShot = 0;
+  psWorker->iRequestFd = aaiPipes[WORKER_REQUEST_INDEX][PIPE_WRITER_INDEX];
+  psWorker->iResponseFd = aaiPipes[WORKER_RESPONSE_INDEX][PIPE_READER_INDEX];
+  psWorker->iStdoutFd = aaiPipes[WORKER_STDOUT_INDEX][PIPE_READER_INDEX];
+  psWorker->iStderrFd = aaiPipes[WORKER_STDERR_INDEX][PIPE_READER_INDEX];
+
   /*-
    *********************************************************************
    *
-   * Release any remaining local resources.
+   * Keep these descriptors out of hooks that exec other programs.
    *
    *********************************************************************
    */
-  Py_XDECREF(psPyResult);
-  Py_XDECREF(psPyLocals);
-  MapFreePythonArguments(psCommand->szArgumentCount, ppwcArgumentVector);
+  fcntl(psWorker->iRequestFd, F_SETFD, FD_CLOEXEC);
+  fcntl(psWorker->iResponseFd, F_SETFD, FD_CLOEXEC);
+  fcntl(psWorker->iStdoutFd, F_SETFD, FD_CLOEXEC);
+  fcntl(psWorker->iStderrFd, F_SETFD, FD_CLOEXEC);
+  fcntl(psWorker->iStdoutFd, F_SETFL, fcntl(psWorker->iStdoutFd, F_GETFL) | O_NONBLOCK);
+  fcntl(psWorker->iStderrFd, F_SETFL, fcntl(psWorker->iStderrFd, F_GETFL) | O_NONBLOCK);
 
-  return iError;
+  return ER_OK;
 }
-#endif
-#endif
 
 
 /*-
  ***********************************************************************
  *
- * MapGetDirectoryCount
+ * MapStopHookWorker
  *
  ***********************************************************************
  */
-int
-MapGetDirectoryCount()
+void
+MapStopHookWorker(HOOK_WORKER *psWorker, int iSignal)
 {
-  return giDirectories;
-}
-
+  if (psWorker->iKidPid <= 0)
+  {
+    return;
+  }
 
-/*-
- ***********************************************************************
- *
- * MapGetFileCount
- *
- ***********************************************************************
- */
-int
-MapGetFileCount()
-{
-  return giFiles;
+  /*-
+   *********************************************************************
+   *
+   * Closing the request pipe tells a worker to shut down. A signal is
+   * only sent when the kid can't be trusted to exit on its own.
+   *
+   *********************************************************************
+   */
+  if (psWorker->iRequestFd >= 0)
+  {
+    close(psWorker->iRequestFd);
+  }
+  if (iSignal != 0)
+  {
+    kill(psWorker->iKidPid, iSignal);
+  }
+  while (waitpid(psWorker->iKidPid, NULL, 0) == -1 && errno == EINTR)
+  {
+    continue;
+  }
+  if (psWorker->iResponseFd >= 0)
+  {
+    close(psWorker->iResponseFd);
+  }
+  if (psWorker->iStdoutFd >= 0)
+  {
+    close(psWorker->iStdoutFd);
+  }
+  if (psWorker->iStderrFd >= 0)
+  {
+    close(psWorker->iStderrFd);
+  }
+  psWorker->iKidPid = 0;
+  psWorker->iRequestFd = psWorker->iResponseFd = psWorker->iStdoutFd = psWorker->iStderrFd = -1;
 }
 
 
 /*-
  ***********************************************************************
  *
- * MapGetSpecialCount
+ * MapStopHookWorkers
  *
  ***********************************************************************
  */
-int
-MapGetSpecialCount()
+void
+MapStopHookWorkers(FTIMES_PROPERTIES *psProperties)
 {
-  return giSpecial;
-}
-
+  const char          acRoutine[] = "MapStopHookWorkers()";
+  char                acLocalError[MESSAGE_SIZE] = "";
+  char                acMessage[MESSAGE_SIZE] = "";
+  int                 i = 0;
 
-#ifdef WINNT
-/*-
- ***********************************************************************
- *
- * MapGetStreamCount
- *
- ***********************************************************************
- */
-int
-MapGetStreamCount()
-{
-  return giStreams;
-}
-#endif
+  if (psProperties->psHookWorkers == NULL)
+  {
+    return;
+  }
 
+  /*-
+   *********************************************************************
+   *
+   * Wait for the hooks that are still in flight, and then shut down
+   * the workers.
+   *
+   *********************************************************************
+   */
+  while (MapGetHookJobCount(psProperties) > 0)
+  {
+    if (MapPollHookWorkers(psProperties, 1, acLocalError) != ER_OK)
+    {
+      snprintf(acMessage, MESSAGE_SIZE, "%s: %s", acRoutine, acLocalError);
+      ErrorHandler(ER_Failure, acMessage, ERROR_FAILURE);
+      break;
+    }
+  }
 
-/*-
- ***********************************************************************
- *
- * MapGetRecordCount
- *
- ***********************************************************************
- */
-int
-MapGetRecordCount()
-{
-  return giRecords;
+  for (i = 0; i < psProperties->iFileHookWorkers; i++)
+  {
+    MapStopHookWorker(&psProperties->psHookWorkers[i], (psProperties->psHookWorkers[i].iBusy) ? SIGKILL : 0);
+    if (psProperties->psHookWorkers[i].pcNeuteredPath != NULL)
+    {
+      free(psProperties->psHookWorkers[i].pcNeuteredPath);
+    }
+    if (psProperties->psHookWorkers[i].pcOutput != NULL)
+    {
+      free(psProperties->psHookWorkers[i].pcOutput);
+    }
+  }
+  free(psProperties->psHookWorkers);
+  psProperties->psHookWorkers = NULL;
 }
 
 
-/*-
- ***********************************************************************
- *
- * MapGetIncompleteRecordCount
- *
- ***********************************************************************
- */
-int
-MapGetIncompleteRecordCount()
-{
-  return giIncompleteRecords;
-}
+#endif
 
 
 #ifdef UNIX
@@ -1046,12 +2258,13 @@ MapTree(FTIMES_PROPERTIES *psProperties, FTIMES_FILE_DATA *psFTTreeData, char *p
     /*-
      *******************************************************************
      *
-     * Get file attributes. This fills in several structure members.
+     * If the new path is in the exclude list, skip it. This is done
+     * before attributes are collected, so excluded objects (and the
+     * subtrees below excluded directories) cost nothing more.
      *
      *******************************************************************
      */
-    MapGetAttributes(psFTFileData);
-    if (!psFTFileData->iFileExists)
+    if (SupportMatchTrie(psProperties->psExcludeTrie, psFTFileData->pcRawPath) != NULL)
     {
       continue;
     }
@@ -1059,11 +2272,12 @@ MapTree(FTIMES_PROPERTIES *psProperties, FTIMES_FILE_DATA *psFTTreeData, char *p
     /*-
      *******************************************************************
      *
-     * If the new path is in the exclude list, skip it.
+     * Get file attributes. This fills in several structure members.
      *
      *******************************************************************
      */
-    if (SupportMatchExclude(psProperties->psExcludeList, psFTFileData->pcRawPath) != NULL)
+    MapGetAttributes(psFTFileData);
+    if (!psFTFileData->iFileExists)
     {
       continue;
     }
@@ -1660,12 +2874,13 @@ MapTree(FTIMES_PROPERTIES *psProperties, FTIMES_FILE_DATA *psFTTreeData, char *p
     /*-
      *******************************************************************
      *
-     * Get file attributes. This fills in several structure members.
+     * If the new path is in the exclude list, skip it. This is done
+     * before attributes are collected, so excluded objects (and the
+     * subtrees below excluded directories) cost nothing more.
      *
      *******************************************************************
      */
-    MapGetAttributes(psFTFileData);
-    if (!psFTFileData->iFileExists)
+    if (SupportMatchTrie(psProperties->psExcludeTrie, psFTFileData->pcRawPath) != NULL)
     {
       continue;
     }
@@ -1673,11 +2888,12 @@ MapTree(FTIMES_PROPERTIES *psProperties, FTIMES_FILE_DATA *psFTTreeData, char *p
     /*-
      *******************************************************************
      *
-     * If the new path is in the exclude list, skip it.
+     * Get file attributes. This fills in several structure members.
      *
      *******************************************************************
      */
-    if (SupportMatchExclude(psProperties->psExcludeList, psFTFileData->pcRawPath) != NULL)
+    MapGetAttributes(psFTFileData);
+    if (!psFTFileData->iFileExists)
     {
       continue;
     }
@@ -2020,6 +3236,7 @@ MapStream(FTIMES_PROPERTIES *psProperties, FTIMES_FILE_DATA *psFTFileData, FTIME
   sFTFileData.pcRawPath = acRawPath;
 
   sFTFileData.iStreamCount = 0;
+  sFTFileData.iFilterStage = 0; /* Streams have their own names, so any filters applied to the parent must be applied again. */
 
   if ((psFTFileData->dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) == FILE_ATTRIBUTE_DIRECTORY)
   {
@@ -3022,11 +4239,19 @@ MapWriteRecord(FTIMES_PROPERTIES *psProperties, FTIMES_FILE_DATA *psFTFileData,
   /*-
    *********************************************************************
    *
-   * Write the output data.
+   * Write the output data. Binary records are left in the stream's
+   * buffer rather than being flushed one at a time.
    *
    *********************************************************************
    */
-  iError = SupportWriteData(psProperties->pFileOut, acOutput, iWriteCount, acLocalError);
+  if (psProperties->iOutputFormat == FTIMES_OUTPUT_FORMAT_BINARY)
+  {
+    iError = SupportWriteBufferedData(psProperties->pFileOut, acOutput, iWriteCount, acLocalError);
+  }
+  else
+  {
+    iError = SupportWriteData(psProperties->pFileOut, acOutput, iWriteCount, acLocalError);
+  }
   if (iError != ER_OK)
   {
     snprintf(pcError, MESSAGE_SIZE, "%s: %s", acRoutine, acLocalError);
@@ -3059,6 +4284,7 @@ MapWriteHeader(FTIMES_PROPERTIES *psProperties, char *pcError)
   const char          acRoutine[] = "MapWriteHeader()";
   char                acLocalError[MESSAGE_SIZE] = "";
   char                acHeaderData[FTIMES_MAX_LINE] = "";
+  char               *pcFieldPrefix = "";
   int                 i = 0;
   int                 iError = 0;
   int                 iIndex = 0;
@@ -3069,74 +4295,48 @@ MapWriteHeader(FTIMES_PROPERTIES *psProperties, char *pcError)
   /*-
    *********************************************************************
    *
-   * Build the output's header. Conditionally add a header prefix.
+   * Build the output's header. Conditionally add a header prefix. The
+   * field names carry a "z_" or "b_" prefix when the records that
+   * follow are compressed or binary, respectively.
    *
    *********************************************************************
    */
   if (psProperties->bCompress)
   {
-    iIndex = sprintf(acHeaderData, "%sz_name", (psProperties->acMapRecordPrefix[0]) ? psProperties->acMapRecordPrefix : "");
-    for (i = 0; i < iMaskTableLength; i++)
-    {
-      ul = (1 << i);
-      if (MASK_BIT_IS_SET(psProperties->psFieldMask->ulMask, ul))
-      {
-#ifdef WIN32
-        switch (ul)
-        {
-        case MAP_ATIME:
-          iIndex += sprintf(&acHeaderData[iIndex], "|z_atime|z_ams");
-          break;
-        case MAP_MTIME:
-          iIndex += sprintf(&acHeaderData[iIndex], "|z_mtime|z_mms");
-          break;
-        case MAP_CTIME:
-          iIndex += sprintf(&acHeaderData[iIndex], "|z_ctime|z_cms");
-          break;
-        case MAP_CHTIME:
-          iIndex += sprintf(&acHeaderData[iIndex], "|z_chtime|z_chms");
-          break;
-        default:
-          iIndex += sprintf(&acHeaderData[iIndex], "|z_%s", (char *) psMaskTable[i].acName);
-          break;
-        }
-#else
-        iIndex += sprintf(&acHeaderData[iIndex], "|z_%s", (char *) psMaskTable[i].acName);
-#endif
-      }
-    }
+    pcFieldPrefix = "z_";
   }
-  else
+  else if (psProperties->iOutputFormat == FTIMES_OUTPUT_FORMAT_BINARY)
+  {
+    pcFieldPrefix = "b_";
+  }
+  iIndex = sprintf(acHeaderData, "%s%sname", (psProperties->acMapRecordPrefix[0]) ? psProperties->acMapRecordPrefix : "", pcFieldPrefix);
+  for (i = 0; i < iMaskTableLength; i++)
   {
-    iIndex = sprintf(acHeaderData, "%sname", (psProperties->acMapRecordPrefix[0]) ? psProperties->acMapRecordPrefix : "");
-    for (i = 0; i < iMaskTableLength; i++)
+    ul = (1 << i);
+    if (MASK_BIT_IS_SET(psProperties->psFieldMask->ulMask, ul))
     {
-      ul = (1 << i);
-      if (MASK_BIT_IS_SET(psProperties->psFieldMask->ulMask, ul))
-      {
 #ifdef WIN32
-        switch (ul)
-        {
-        case MAP_ATIME:
-          iIndex += sprintf(&acHeaderData[iIndex], "|atime|ams");
-          break;
-        case MAP_MTIME:
-          iIndex += sprintf(&acHeaderData[iIndex], "|mtime|mms");
-          break;
-        case MAP_CTIME:
-          iIndex += sprintf(&acHeaderData[iIndex], "|ctime|cms");
-          break;
-        case MAP_CHTIME:
-          iIndex += sprintf(&acHeaderData[iIndex], "|chtime|chms");
-          break;
-        default:
-          iIndex += sprintf(&acHeaderData[iIndex], "|%s", (char *) psMaskTable[i].acName);
-          break;
-        }
+      switch (ul)
+      {
+      case MAP_ATIME:
+        iIndex += sprintf(&acHeaderData[iIndex], "|%satime|%sams", pcFieldPrefix, pcFieldPrefix);
+        break;
+      case MAP_MTIME:
+        iIndex += sprintf(&acHeaderData[iIndex], "|%smtime|%smms", pcFieldPrefix, pcFieldPrefix);
+        break;
+      case MAP_CTIME:
+        iIndex += sprintf(&acHeaderData[iIndex], "|%sctime|%scms", pcFieldPrefix, pcFieldPrefix);
+        break;
+      case MAP_CHTIME:
+        iIndex += sprintf(&acHeaderData[iIndex], "|%schtime|%schms", pcFieldPrefix, pcFieldPrefix);
+        break;
+      default:
+        iIndex += sprintf(&acHeaderData[iIndex], "|%s%s", pcFieldPrefix, (char *) psMaskTable[i].acName);
+        break;
+      }
 #else
-        iIndex += sprintf(&acHeaderData[iIndex], "|%s", (char *) psMaskTable[i].acName);
+      iIndex += sprintf(&acHeaderData[iIndex], "|%s%s", pcFieldPrefix, (char *) psMaskTable[i].acName);
 #endif
-      }
     }
   }
   iIndex += sprintf(&acHeaderData[iIndex], "%s", psProperties->acNewLine);
@@ -3452,6 +4652,21 @@ MapGetAttributes(FTIMES_FILE_DATA *psFTFileData)
 void
 MapFreeFTFileData(FTIMES_FILE_DATA *psFTFileData)
 {
+#ifndef WINNT
+  /*-
+   *********************************************************************
+   *
+   * Return the structure, along with its path buffers, to the free
+   * list. MapNewFTFileData() recycles it.
+   *
+   *********************************************************************
+   */
+  if (psFTFileData != NULL)
+  {
+    psFTFileData->psNextFree = gpsFTFileDataFreeList;
+    gpsFTFileDataFreeList = psFTFileData;
+  }
+#else
   if (psFTFileData != NULL)
   {
     if (psFTFileData->pcNeuteredPath != NULL)
@@ -3462,7 +4677,6 @@ MapFreeFTFileData(FTIMES_FILE_DATA *psFTFileData)
     {
       free(psFTFileData->pcRawPath);
     }
-#ifdef WINNT
     if (psFTFileData->pwcRawPath != NULL)
     {
       free(psFTFileData->pwcRawPath);
@@ -3475,9 +4689,9 @@ MapFreeFTFileData(FTIMES_FILE_DATA *psFTFileData)
     {
       free(psFTFileData->pucStreamInfo);
     }
-#endif
     free(psFTFileData);
   }
+#endif
 }
 
 
@@ -3522,21 +4736,49 @@ MapNewFTFileData(FTIMES_FILE_DATA *psParentFTFileData, char *pcName, char *pcErr
 {
   const char          acRoutine[] = "MapNewFTFileData()";
   char                acLocalError[MESSAGE_SIZE] = "";
-  char                acSeparator[2] = "";
+  char               *pcNeuteredPath = NULL;
+  char               *pcRawPath = NULL;
   int                 iFSType = FSTYPE_UNSUPPORTED;
+  int                 iNameLength = 0;
+  int                 iSeparator = 0;
   FTIMES_FILE_DATA   *psFTFileData = NULL;
 
   /*
    *********************************************************************
    *
-   * Allocate and clear memory for the file data structure.
+   * Recycle a structure from the free list, if possible. Otherwise,
+   * allocate a new one. Recycled structures keep their path buffers,
+   * so a walk in steady state makes no calls to malloc() or free().
+   * The list is LIFO, which means that each level of the walk tends
+   * to get back the structure it released on the previous entry.
    *
    *********************************************************************
    */
-  psFTFileData = (FTIMES_FILE_DATA *) calloc(sizeof(FTIMES_FILE_DATA), 1);
-  if (psFTFileData == NULL)
+  if (gpsFTFileDataFreeList != NULL)
   {
-    snprintf(pcError, MESSAGE_SIZE, "%s: calloc(): %s", acRoutine, strerror(errno));
+    psFTFileData = gpsFTFileDataFreeList;
+    gpsFTFileDataFreeList = psFTFileData->psNextFree;
+    pcNeuteredPath = psFTFileData->pcNeuteredPath;
+    pcRawPath = psFTFileData->pcRawPath;
+    memset(psFTFileData, 0, sizeof(FTIMES_FILE_DATA));
+  }
+  else
+  {
+    psFTFileData = (FTIMES_FILE_DATA *) calloc(sizeof(FTIMES_FILE_DATA), 1);
+    if (psFTFileData == NULL)
+    {
+      snprintf(pcError, MESSAGE_SIZE, "%s: calloc(): %s", acRoutine, strerror(errno));
+      return NULL;
+    }
+    pcRawPath = malloc(FTIMES_MAX_PATH);
+    pcNeuteredPath = malloc(3 * FTIMES_MAX_PATH);
+  }
+  psFTFileData->pcNeuteredPath = pcNeuteredPath;
+  psFTFileData->pcRawPath = pcRawPath;
+  if (pcRawPath == NULL || pcNeuteredPath == NULL)
+  {
+    snprintf(pcError, MESSAGE_SIZE, "%s: malloc(): %s", acRoutine, strerror(errno));
+    MapFreeFTFileData(psFTFileData);
     return NULL;
   }
 
@@ -3558,19 +4800,15 @@ MapNewFTFileData(FTIMES_FILE_DATA *psParentFTFileData, char *pcName, char *pcErr
    *
    *********************************************************************
    */
+  iNameLength = strlen(pcName);
   if (psParentFTFileData)
   {
-    psFTFileData->iRawPathLength = psParentFTFileData->iRawPathLength + strlen(pcName);
-    if (psParentFTFileData->pcRawPath[psParentFTFileData->iRawPathLength - 1] != FTIMES_SLASHCHAR)
-    {
-      acSeparator[0] = FTIMES_SLASHCHAR;
-      acSeparator[1] = 0;
-      psFTFileData->iRawPathLength++;
-    }
+    iSeparator = (psParentFTFileData->pcRawPath[psParentFTFileData->iRawPathLength - 1] != FTIMES_SLASHCHAR) ? 1 : 0;
+    psFTFileData->iRawPathLength = psParentFTFileData->iRawPathLength + iSeparator + iNameLength;
   }
   else
   {
-    psFTFileData->iRawPathLength = strlen(pcName);
+    psFTFileData->iRawPathLength = iNameLength;
   }
   if (psFTFileData->iRawPathLength > FTIMES_MAX_PATH - 1) /* Subtract one for the NULL. */
   {
@@ -3578,36 +4816,29 @@ MapNewFTFileData(FTIMES_FILE_DATA *psParentFTFileData, char *pcName, char *pcErr
     MapFreeFTFileData(psFTFileData);
     return NULL;
   }
-  psFTFileData->pcRawPath = malloc(psFTFileData->iRawPathLength + 1);
-  if (psFTFileData->pcRawPath == NULL)
-  {
-    snprintf(pcError, MESSAGE_SIZE, "%s: malloc(): %s", acRoutine, strerror(errno));
-    MapFreeFTFileData(psFTFileData);
-    return NULL;
-  }
-  if (psParentFTFileData)
-  {
-    snprintf(psFTFileData->pcRawPath, FTIMES_MAX_PATH, "%s%s%s", psParentFTFileData->pcRawPath, acSeparator, pcName);
-  }
-  else
-  {
-    snprintf(psFTFileData->pcRawPath, FTIMES_MAX_PATH, "%s", pcName);
-  }
 
   /*-
    *********************************************************************
    *
-   * Neuter the new path.
+   * Build the raw and neutered paths by appending the new name to the
+   * parent's paths. Neutering is done one byte at a time, so only the
+   * separator and the new name need to be encoded.
    *
    *********************************************************************
    */
-  psFTFileData->pcNeuteredPath = SupportNeuterString(psFTFileData->pcRawPath, psFTFileData->iRawPathLength, acLocalError);
-  if (psFTFileData->pcNeuteredPath == NULL)
+  if (psParentFTFileData)
   {
-    snprintf(pcError, MESSAGE_SIZE, "%s: %s", acRoutine, acLocalError);
-    MapFreeFTFileData(psFTFileData);
-    return NULL;
+    memcpy(pcRawPath, psParentFTFileData->pcRawPath, psParentFTFileData->iRawPathLength);
+    memcpy(pcNeuteredPath, psParentFTFileData->pcNeuteredPath, psParentFTFileData->iNeuteredPathLength);
+    psFTFileData->iNeuteredPathLength = psParentFTFileData->iNeuteredPathLength;
+    if (iSeparator)
+    {
+      pcRawPath[psParentFTFileData->iRawPathLength] = FTIMES_SLASHCHAR;
+      psFTFileData->iNeuteredPathLength += SupportNeuterStringToBuffer(&pcRawPath[psParentFTFileData->iRawPathLength], 1, &pcNeuteredPath[psFTFileData->iNeuteredPathLength]);
+    }
   }
+  memcpy(&pcRawPath[psFTFileData->iRawPathLength - iNameLength], pcName, iNameLength + 1);
+  psFTFileData->iNeuteredPathLength += SupportNeuterStringToBuffer(pcName, iNameLength, &pcNeuteredPath[psFTFileData->iNeuteredPathLength]);
 
   /*-
    *********************************************************************
@@ -118,7 +118,18 @@ MapModeInitialize(void *pvProperties, char *pcError)
    *
    *********************************************************************
    */
+#ifdef UNIX
+  if (psProperties->iOutputFormat == FTIMES_OUTPUT_FORMAT_BINARY)
+  {
+    psProperties->piDevelopMapOutput = DevelopBinaryOutput;
+  }
+  else
+  {
+    psProperties->piDevelopMapOutput = (psProperties->bCompress) ? DevelopCompressedOutput : DevelopNormalOutput;
+  }
+#else
   psProperties->piDevelopMapOutput = (psProperties->bCompress) ? DevelopCompressedOutput : DevelopNormalOutput;
+#endif
 
   return ER_OK;
 }
@@ -187,6 +198,11 @@ MapModeCheckDependencies(void *pvProperties, char *pcError)
         snprintf(pcError, MESSAGE_SIZE, "%s: Uploads are not allowed when the BaseName is \"-\". Either disable URLPutSnapshot or change the BaseName.", acRoutine);
         return ER;
       }
+      if (psProperties->bIndexSnapshot)
+      {
+        snprintf(pcError, MESSAGE_SIZE, "%s: Indexes are not allowed when the BaseName is \"-\". Either disable IndexSnapshot or change the BaseName.", acRoutine);
+        return ER;
+      }
     }
     else
     {
@@ -197,6 +213,27 @@ MapModeCheckDependencies(void *pvProperties, char *pcError)
       }
     }
 
+    if (psProperties->iOutputFormat == FTIMES_OUTPUT_FORMAT_BINARY)
+    {
+#ifdef WIN32
+      snprintf(pcError, MESSAGE_SIZE, "%s: Binary output is not supported on this platform. Set OutputFormat to text.", acRoutine);
+      return ER;
+#else
+      if (psProperties->bCompress)
+      {
+        snprintf(pcError, MESSAGE_SIZE, "%s: Binary output can not be compressed. Either disable Compress or set OutputFormat to text.", acRoutine);
+        return ER;
+      }
+#ifdef USE_FILE_HOOKS
+      if (psProperties->psFileHookList != NULL)
+      {
+        snprintf(pcError, MESSAGE_SIZE, "%s: Hook output can not be mixed with binary output. Either remove all FileHook controls or set OutputFormat to text.", acRoutine);
+        return ER;
+      }
+#endif
+#endif
+    }
+
     if (psProperties->bURLPutSnapshot && psProperties->psPutURL == NULL)
     {
       snprintf(pcError, MESSAGE_SIZE, "%s: Missing URLPutURL.", acRoutine);
@@ -209,6 +246,30 @@ MapModeCheckDependencies(void *pvProperties, char *pcError)
       return ER_MissingControl;
     }
 
+#ifdef USE_URL_STREAM
+    if (psProperties->bURLPutSnapshot && psProperties->bURLPutStream && psProperties->bURLUnlinkOutput && psProperties->bIndexSnapshot)
+    {
+      snprintf(pcError, MESSAGE_SIZE, "%s: Streamed output that is not kept can not be indexed. Either disable IndexSnapshot or URLUnlinkOutput.", acRoutine);
+      return ER;
+    }
+#endif
+
+#ifdef USE_ZLIB
+    if (psProperties->iOutputCompression != FTIMES_OUTPUT_COMPRESSION_NONE)
+    {
+      if (psProperties->bIndexSnapshot)
+      {
+        snprintf(pcError, MESSAGE_SIZE, "%s: Compressed output can not be indexed. Either disable IndexSnapshot or set OutputCompression to none.", acRoutine);
+        return ER;
+      }
+      if (psProperties->bURLPutSnapshot)
+      {
+        snprintf(pcError, MESSAGE_SIZE, "%s: Compressed output can not be uploaded. Either disable URLPutSnapshot or set OutputCompression to none.", acRoutine);
+        return ER;
+      }
+    }
+#endif
+
 #ifdef USE_SSL
     if (SSLCheckDependencies(psProperties->psSslProperties, acLocalError) != ER_OK)
     {
@@ -226,19 +287,19 @@ MapModeCheckDependencies(void *pvProperties, char *pcError)
    *
    *********************************************************************
    */
-   if ((psProperties->psExcludeFilterMd5List || psProperties->psIncludeFilterMd5List) && !MASK_BIT_IS_SET(psProperties->psFieldMask->ulMask, MAP_MD5))
+   if ((psProperties->psExcludeFilterMd5List || psProperties->psIncludeFilterMd5List || psProperties->psExcludeFilterMd5Set || psProperties->psIncludeFilterMd5Set) && !MASK_BIT_IS_SET(psProperties->psFieldMask->ulMask, MAP_MD5))
    {
       snprintf(pcError, MESSAGE_SIZE, "%s: The specified attribute filter(s) require the MD5 attribute to be set. Either add this attribute to the FieldMask or remove/disable all include/exclude MD5 filters." , acRoutine);
       return ER;
    }
 
-   if ((psProperties->psExcludeFilterSha1List || psProperties->psIncludeFilterSha1List) && !MASK_BIT_IS_SET(psProperties->psFieldMask->ulMask, MAP_SHA1))
+   if ((psProperties->psExcludeFilterSha1List || psProperties->psIncludeFilterSha1List || psProperties->psExcludeFilterSha1Set || psProperties->psIncludeFilterSha1Set) && !MASK_BIT_IS_SET(psProperties->psFieldMask->ulMask, MAP_SHA1))
    {
       snprintf(pcError, MESSAGE_SIZE, "%s: The specified attribute filter(s) require the SHA1 attribute to be set. Either add this attribute to the FieldMask or remove/disable all include/exclude SHA1 filters." , acRoutine);
       return ER;
    }
 
-   if ((psProperties->psExcludeFilterSha256List || psProperties->psIncludeFilterSha256List) && !MASK_BIT_IS_SET(psProperties->psFieldMask->ulMask, MAP_SHA256))
+   if ((psProperties->psExcludeFilterSha256List || psProperties->psIncludeFilterSha256List || psProperties->psExcludeFilterSha256Set || psProperties->psIncludeFilterSha256Set) && !MASK_BIT_IS_SET(psProperties->psFieldMask->ulMask, MAP_SHA256))
    {
       snprintf(pcError, MESSAGE_SIZE, "%s: The specified attribute filter(s) require the SHA256 attribute to be set. Either add this attribute to the FieldMask or remove/disable all include/exclude SHA256 filters." , acRoutine);
       return ER;
@@ -265,6 +326,9 @@ MapModeFinalize(void *pvProperties, char *pcError)
   char                acMessage[MESSAGE_SIZE];
 #endif
   FTIMES_PROPERTIES  *psProperties = (FTIMES_PROPERTIES *)pvProperties;
+#if defined(USE_ZLIB) || defined(USE_URL_STREAM)
+  FILE               *pFile;
+#endif
   int                 iError;
 
   /*-
@@ -486,7 +550,11 @@ MapModeFinalize(void *pvProperties, char *pcError)
    */
   if (psProperties->iRunMode == FTIMES_MAPMODE && strcmp(psProperties->acBaseName, "-") != 0)
   {
+#ifdef USE_ZLIB
+    iError = SupportMakeName(psProperties->acOutDirName, psProperties->acBaseName, psProperties->acBaseNameSuffix, (psProperties->iOutputCompression == FTIMES_OUTPUT_COMPRESSION_GZIP) ? ".map.gz" : ".map", psProperties->acOutFileName, acLocalError);
+#else
     iError = SupportMakeName(psProperties->acOutDirName, psProperties->acBaseName, psProperties->acBaseNameSuffix, ".map", psProperties->acOutFileName, acLocalError);
+#endif
     if (iError != ER_OK)
     {
       snprintf(pcError, MESSAGE_SIZE, "%s: Out File: %s", acRoutine, acLocalError);
@@ -500,28 +568,45 @@ MapModeFinalize(void *pvProperties, char *pcError)
       return iError;
     }
 
-    psProperties->pFileOut = fopen(psProperties->acOutFileName, "wb+");
-    if (psProperties->pFileOut == NULL)
+#ifdef USE_URL_STREAM
+    if (psProperties->bURLPutSnapshot && psProperties->bURLPutStream && psProperties->bURLUnlinkOutput)
     {
-      snprintf(pcError, MESSAGE_SIZE, "%s: OutFile = [%s]: %s", acRoutine, psProperties->acOutFileName, strerror(errno));
-      return ER_fopen;
+      psProperties->pFileOut = NULL; /* The output is streamed, but not kept. */
     }
+    else
+#endif
+    {
+      psProperties->pFileOut = fopen(psProperties->acOutFileName, "wb+");
+      if (psProperties->pFileOut == NULL)
+      {
+        snprintf(pcError, MESSAGE_SIZE, "%s: OutFile = [%s]: %s", acRoutine, psProperties->acOutFileName, strerror(errno));
+        return ER_fopen;
+      }
 /* FIXME Remove this #ifdef at some point in the future. */
 #ifdef WIN32
-    /*-
-     *****************************************************************
-     *
-     * NOTE: The buffer size was explicitly set to prevent binaries
-     * made with Visual Studio 2005 (no service packs) from crashing
-     * when run in lean mode. This problem may have been fixed in
-     * Service Pack 1.
-     *
-     *****************************************************************
-     */
-    setvbuf(psProperties->pFileOut, NULL, _IOLBF, 1024);
+      /*-
+       *****************************************************************
+       *
+       * NOTE: The buffer size was explicitly set to prevent binaries
+       * made with Visual Studio 2005 (no service packs) from crashing
+       * when run in lean mode. This problem may have been fixed in
+       * Service Pack 1.
+       *
+       *****************************************************************
+       */
+      setvbuf(psProperties->pFileOut, NULL, _IOLBF, 1024);
 #else
-    setvbuf(psProperties->pFileOut, NULL, _IOLBF, 0);
+      /*-
+       *****************************************************************
+       *
+       * Binary records are not line oriented, so they are written
+       * through a fully buffered stream.
+       *
+       *****************************************************************
+       */
+      setvbuf(psProperties->pFileOut, NULL, (psProperties->iOutputFormat == FTIMES_OUTPUT_FORMAT_BINARY) ? _IOFBF : _IOLBF, 0);
 #endif
+    }
   }
   else
   {
@@ -529,6 +614,106 @@ MapModeFinalize(void *pvProperties, char *pcError)
     psProperties->pFileOut = stdout;
   }
 
+#ifdef USE_URL_STREAM
+  /*-
+   *********************************************************************
+   *
+   * Route the Out file stream to the server as it's written, if
+   * requested. The local copy, if any, is written through the stream.
+   *
+   *********************************************************************
+   */
+  if (psProperties->bURLPutSnapshot && psProperties->bURLPutStream && psProperties->iRunMode == FTIMES_MAPMODE)
+  {
+    pFile = URLNewStream(psProperties, psProperties->pFileOut, acLocalError);
+    if (pFile == NULL)
+    {
+      snprintf(pcError, MESSAGE_SIZE, "%s: OutFile = [%s]: %s", acRoutine, psProperties->acOutFileName, acLocalError);
+      return ER;
+    }
+    setvbuf(pFile, NULL, (psProperties->iOutputFormat == FTIMES_OUTPUT_FORMAT_BINARY) ? _IOFBF : _IOLBF, 0);
+    psProperties->pFileOut = pFile;
+  }
+#endif
+
+#ifdef USE_ZLIB
+  /*-
+   *********************************************************************
+   *
+   * Route the Out file stream through the compressor, if requested.
+   * The OutFileHash is computed over the uncompressed data.
+   *
+   *********************************************************************
+   */
+  if (psProperties->iOutputCompression == FTIMES_OUTPUT_COMPRESSION_GZIP)
+  {
+    pFile = GzipNewWriteStream(psProperties->pFileOut, psProperties->iOutputCompressLevel, acLocalError);
+    if (pFile == NULL)
+    {
+      snprintf(pcError, MESSAGE_SIZE, "%s: OutFile = [%s]: %s", acRoutine, psProperties->acOutFileName, acLocalError);
+      return ER;
+    }
+    psProperties->pFileOut = pFile;
+  }
+#endif
+
+  /*-
+   *********************************************************************
+   *
+   * Compile the Exclude list into a trie. This must be done after the
+   * log and out files have been added to the list.
+   *
+   *********************************************************************
+   */
+  psProperties->psExcludeTrie = SupportNewTrie(psProperties->psExcludeList, acLocalError);
+  if (psProperties->psExcludeTrie == NULL)
+  {
+    snprintf(pcError, MESSAGE_SIZE, "%s: %s", acRoutine, acLocalError);
+    return ER;
+  }
+
+#ifdef USE_PCRE
+  /*-
+   *********************************************************************
+   *
+   * Sort and index any digest sets created by hash filter controls.
+   *
+   *********************************************************************
+   */
+  iError = SupportSortDigestSets(psProperties, acLocalError);
+  if (iError != ER_OK)
+  {
+    snprintf(pcError, MESSAGE_SIZE, "%s: %s", acRoutine, acLocalError);
+    return iError;
+  }
+
+  /*-
+   *********************************************************************
+   *
+   * Combine path filters into as few expressions as possible.
+   *
+   *********************************************************************
+   */
+  if (psProperties->psExcludeFilterList != NULL)
+  {
+    psProperties->psExcludeFilterUnion = SupportNewFilterUnion(psProperties->psExcludeFilterList, acLocalError);
+    if (psProperties->psExcludeFilterUnion == NULL)
+    {
+      snprintf(pcError, MESSAGE_SIZE, "%s: %s", acRoutine, acLocalError);
+      return ER;
+    }
+  }
+  if (psProperties->psIncludeFilterList != NULL)
+  {
+    psProperties->psIncludeFilterUnion = SupportNewFilterUnion(psProperties->psIncludeFilterList, acLocalError);
+    if (psProperties->psIncludeFilterUnion == NULL)
+    {
+      snprintf(pcError, MESSAGE_SIZE, "%s: %s", acRoutine, acLocalError);
+      return ER;
+    }
+  }
+#endif
+
   /*-
    *********************************************************************
    *
@@ -590,12 +775,24 @@ MapModeWorkHorse(void *pvProperties, char *pcError)
    */
   for (psList = psProperties->psIncludeList; psList != NULL; psList = psList->psNext)
   {
-    if (SupportMatchExclude(psProperties->psExcludeList, psList->pcRegularPath) == NULL)
+    if (SupportMatchTrie(psProperties->psExcludeTrie, psList->pcRegularPath) == NULL)
     {
       MapFile(psProperties, psList->pcRegularPath, acLocalError);
     }
   }
 
+#ifdef USE_FILE_HOOKS
+  /*-
+   *********************************************************************
+   *
+   * Wait for any hooks that are still running, and then shut down
+   * the hook workers.
+   *
+   *********************************************************************
+   */
+  MapStopHookWorkers(psProperties);
+#endif
+
   return ER_OK;
 }
 
@@ -610,8 +807,11 @@ MapModeWorkHorse(void *pvProperties, char *pcError)
 int
 MapModeFinishUp(void *pvProperties, char *pcError)
 {
+  const char          acRoutine[] = "MapModeFinishUp()";
+  char                acLocalError[MESSAGE_SIZE] = "";
   char                acMessage[MESSAGE_SIZE];
   int                 i;
+  int                 iError;
   int                 iFirst;
   int                 iIndex;
   FTIMES_PROPERTIES  *psProperties = (FTIMES_PROPERTIES *)pvProperties;
@@ -627,7 +827,11 @@ MapModeFinishUp(void *pvProperties, char *pcError)
   if (psProperties->pFileOut && psProperties->pFileOut != stdout)
   {
     fflush(psProperties->pFileOut);
-    fclose(psProperties->pFileOut);
+    if (fclose(psProperties->pFileOut) != 0)
+    {
+      snprintf(acMessage, MESSAGE_SIZE, "%s: OutFile = [%s]: %s", acRoutine, psProperties->acOutFileName, strerror(errno));
+      ErrorHandler(ER_Failure, acMessage, ERROR_FAILURE);
+    }
     psProperties->pFileOut = NULL;
   }
 
@@ -635,6 +839,48 @@ MapModeFinishUp(void *pvProperties, char *pcError)
   MD5Omega(&psProperties->sOutFileHashContext, aucFileHash);
   MD5HashToHex(aucFileHash, psProperties->acOutFileHash);
 
+  /*-
+   *********************************************************************
+   *
+   * Build the snapshot's index, if requested. This requires another
+   * pass over the output file, which is now complete. A failure here
+   * is not fatal since the snapshot itself is intact.
+   *
+   *********************************************************************
+   */
+  if (psProperties->bIndexSnapshot && psProperties->iRunMode == FTIMES_MAPMODE)
+  {
+    snprintf(psProperties->acIndexFileName, FTIMES_MAX_PATH, "%s%s", psProperties->acOutFileName, DECODE_INDEX_SUFFIX);
+    DecodeBuildFromBase64Table();
+    iError = DecodeIndexSnapshot(psProperties->acOutFileName, psProperties->acIndexFileName, acLocalError);
+    if (iError != ER_OK)
+    {
+      snprintf(acMessage, MESSAGE_SIZE, "%s: %s", acRoutine, acLocalError);
+      ErrorHandler(ER_Failure, acMessage, ERROR_FAILURE);
+      psProperties->acIndexFileName[0] = 0;
+    }
+  }
+
+#ifdef USE_XMAGIC
+  /*-
+   *********************************************************************
+   *
+   * Save the XMagic result cache, if one is active. A failure here is
+   * not fatal since the snapshot itself is intact.
+   *
+   *********************************************************************
+   */
+  if (psProperties->psXMagicCache != NULL)
+  {
+    iError = XMagicSaveCache(psProperties->psXMagicCache, psProperties->acMagicCacheFileName, acLocalError);
+    if (iError != ER_OK)
+    {
+      snprintf(acMessage, MESSAGE_SIZE, "%s: %s", acRoutine, acLocalError);
+      ErrorHandler(ER_Failure, acMessage, ERROR_FAILURE);
+    }
+  }
+
+#endif
   /*-
    *********************************************************************
    *
@@ -651,6 +897,12 @@ MapModeFinishUp(void *pvProperties, char *pcError)
   snprintf(acMessage, MESSAGE_SIZE, "OutFileHash=%s", psProperties->acOutFileHash);
   MessageHandler(MESSAGE_QUEUE_IT, MESSAGE_INFORMATION, MESSAGE_PROPERTY_STRING, acMessage);
 
+  if (psProperties->acIndexFileName[0])
+  {
+    snprintf(acMessage, MESSAGE_SIZE, "IndexFileName=%s", psProperties->acIndexFileName);
+    MessageHandler(MESSAGE_QUEUE_IT, MESSAGE_INFORMATION, MESSAGE_PROPERTY_STRING, acMessage);
+  }
+
   snprintf(acMessage, MESSAGE_SIZE, "DataType=%s", psProperties->acDataType);
   MessageHandler(MESSAGE_QUEUE_IT, MESSAGE_INFORMATION, MESSAGE_PROPERTY_STRING, acMessage);
 
@@ -690,6 +942,14 @@ MapModeFinishUp(void *pvProperties, char *pcError)
     snprintf(acMessage, MESSAGE_SIZE, "ObjectsAnalyzed=%u", AnalyzeGetFileCount());
     MessageHandler(MESSAGE_QUEUE_IT, MESSAGE_INFORMATION, MESSAGE_PROPERTY_STRING, acMessage);
 
+#ifdef USE_XMAGIC
+    if (psProperties->psXMagicCache != NULL)
+    {
+      snprintf(acMessage, MESSAGE_SIZE, "MagicCacheHits=%d", psProperties->psXMagicCache->iHits);
+      MessageHandler(MESSAGE_QUEUE_IT, MESSAGE_INFORMATION, MESSAGE_PROPERTY_STRING, acMessage);
+    }
+#endif
+
 #ifdef UNIX
 #ifdef USE_AP_SNPRINTF
     snprintf(acMessage, MESSAGE_SIZE, "BytesAnalyzed=%qu", (unsigned long long) AnalyzeGetByteCount());
@@ -754,7 +1014,31 @@ MapModeFinalStage(void *pvProperties, char *pcError)
    */
   if (psProperties->bURLPutSnapshot && psProperties->iRunMode == FTIMES_MAPMODE)
   {
+#ifdef USE_URL_STREAM
+    if (psProperties->bURLPutStream)
+    {
+      iError = URLFinishStream(psProperties, acLocalError);
+      if (iError != ER_OK && !psProperties->bURLUnlinkOutput)
+      {
+        /*-
+         ***************************************************************
+         *
+         * A local copy exists, so fall back to a regular upload.
+         *
+         ***************************************************************
+         */
+        snprintf(pcError, MESSAGE_SIZE, "%s: %s: Retrying with a regular upload.", acRoutine, acLocalError);
+        ErrorHandler(ER_Warning, pcError, ERROR_WARNING);
+        iError = URLPutRequest(psProperties, acLocalError);
+      }
+    }
+    else
+    {
+      iError = URLPutRequest(psProperties, acLocalError);
+    }
+#else
     iError = URLPutRequest(psProperties, acLocalError);
+#endif
     if (iError != ER_OK)
     {
       snprintf(pcError, MESSAGE_SIZE, "%s: %s", acRoutine, acLocalError);
@@ -680,7 +680,7 @@ PropertiesReadLine(char *pcLine, FTIMES_PROPERTIES *psProperties, char *pcError)
 
   else if (strcasecmp(pcControl, KEY_ExcludeFilterMd5) == 0 && RUN_MODE_IS_SET(MODES_ExcludeFilterMd5, iRunMode))
   {
-    iError = SupportAddFilter(pc, &psProperties->psExcludeFilterMd5List, acLocalError);
+    iError = SupportAddDigestFilter(pc, MD5_HASH_SIZE, &psProperties->psExcludeFilterMd5List, &psProperties->psExcludeFilterMd5Set, acLocalError);
     if (iError != ER_OK)
     {
       snprintf(pcError, MESSAGE_SIZE, "%s: Control = [%s]: %s", acRoutine, pcControl, acLocalError);
@@ -690,7 +690,7 @@ PropertiesReadLine(char *pcLine, FTIMES_PROPERTIES *psProperties, char *pcError)
 
   else if (strcasecmp(pcControl, KEY_ExcludeFilterSha1) == 0 && RUN_MODE_IS_SET(MODES_ExcludeFilterSha1, iRunMode))
   {
-    iError = SupportAddFilter(pc, &psProperties->psExcludeFilterSha1List, acLocalError);
+    iError = SupportAddDigestFilter(pc, SHA1_HASH_SIZE, &psProperties->psExcludeFilterSha1List, &psProperties->psExcludeFilterSha1Set, acLocalError);
     if (iError != ER_OK)
     {
       snprintf(pcError, MESSAGE_SIZE, "%s: Control = [%s]: %s", acRoutine, pcControl, acLocalError);
@@ -700,7 +700,7 @@ PropertiesReadLine(char *pcLine, FTIMES_PROPERTIES *psProperties, char *pcError)
 
   else if (strcasecmp(pcControl, KEY_ExcludeFilterSha256) == 0 && RUN_MODE_IS_SET(MODES_ExcludeFilterSha256, iRunMode))
   {
-    iError = SupportAddFilter(pc, &psProperties->psExcludeFilterSha256List, acLocalError);
+    iError = SupportAddDigestFilter(pc, SHA256_HASH_SIZE, &psProperties->psExcludeFilterSha256List, &psProperties->psExcludeFilterSha256Set, acLocalError);
     if (iError != ER_OK)
     {
       snprintf(pcError, MESSAGE_SIZE, "%s: Control = [%s]: %s", acRoutine, pcControl, acLocalError);
@@ -750,6 +750,57 @@ PropertiesReadLine(char *pcLine, FTIMES_PROPERTIES *psProperties, char *pcError)
       return ER;
     }
   }
+
+  else if (strcasecmp(pcControl, KEY_FileHookTimeout) == 0 && RUN_MODE_IS_SET(MODES_FileHookTimeout, iRunMode))
+  {
+    DUPLICATE_ERROR(psProperties->sFound.bFileHookTimeoutFound);
+    while (iLength > 0)
+    {
+      if (!isdigit((int) pc[iLength - 1]))
+      {
+        snprintf(pcError, MESSAGE_SIZE, "%s: Control = [%s], Value = [%s], Value must be an integer.", acRoutine, pcControl, pc);
+        return ER;
+      }
+      iLength--;
+    }
+    iValue = atoi(pc);
+    if (iValue < 0 || iValue > FTIMES_MAX_HOOK_TIMEOUT)
+    {
+      snprintf(pcError, MESSAGE_SIZE, "%s: Control = [%s], Value = [%s], Value out of range.", acRoutine, pcControl, pc);
+      return ER;
+    }
+    else
+    {
+      psProperties->iFileHookTimeout = iValue;
+    }
+    psProperties->sFound.bFileHookTimeoutFound = TRUE;
+  }
+
+  else if (strcasecmp(pcControl, KEY_FileHookWorkers) == 0 && RUN_MODE_IS_SET(MODES_FileHookWorkers, iRunMode))
+  {
+    DUPLICATE_ERROR(psProperties->sFound.bFileHookWorkersFound);
+    while (iLength > 0)
+    {
+      if (!isdigit((int) pc[iLength - 1]))
+      {
+        snprintf(pcError, MESSAGE_SIZE, "%s: Control = [%s], Value = [%s], Value must be an integer.", acRoutine, pcControl, pc);
+        return ER;
+      }
+      iLength--;
+    }
+    iValue = atoi(pc);
+    if (iValue < 0 || iValue > HOOK_MAX_WORKER_COUNT)
+    {
+      snprintf(pcError, MESSAGE_SIZE, "%s: Control = [%s], Value = [%s], Value out of range.", acRoutine, pcControl, pc);
+      return ER;
+    }
+    else
+    {
+      psProperties->iFileHookWorkers = iValue;
+      psProperties->bFileHookBackground = (iValue > 0) ? TRUE : FALSE;
+    }
+    psProperties->sFound.bFileHookWorkersFound = TRUE;
+  }
 #endif
 
   else if (strcasecmp(pcControl, KEY_FileSizeLimit) == 0 && RUN_MODE_IS_SET(MODES_FileSizeLimit, iRunMode))
@@ -841,7 +892,7 @@ PropertiesReadLine(char *pcLine, FTIMES_PROPERTIES *psProperties, char *pcError)
 
   else if (strcasecmp(pcControl, KEY_IncludeFilterMd5) == 0 && RUN_MODE_IS_SET(MODES_IncludeFilterMd5, iRunMode))
   {
-    iError = SupportAddFilter(pc, &psProperties->psIncludeFilterMd5List, acLocalError);
+    iError = SupportAddDigestFilter(pc, MD5_HASH_SIZE, &psProperties->psIncludeFilterMd5List, &psProperties->psIncludeFilterMd5Set, acLocalError);
     if (iError != ER_OK)
     {
       snprintf(pcError, MESSAGE_SIZE, "%s: Control = [%s]: %s", acRoutine, pcControl, acLocalError);
@@ -851,7 +902,7 @@ PropertiesReadLine(char *pcLine, FTIMES_PROPERTIES *psProperties, char *pcError)
 
   else if (strcasecmp(pcControl, KEY_IncludeFilterSha1) == 0 && RUN_MODE_IS_SET(MODES_IncludeFilterSha1, iRunMode))
   {
-    iError = SupportAddFilter(pc, &psProperties->psIncludeFilterSha1List, acLocalError);
+    iError = SupportAddDigestFilter(pc, SHA1_HASH_SIZE, &psProperties->psIncludeFilterSha1List, &psProperties->psIncludeFilterSha1Set, acLocalError);
     if (iError != ER_OK)
     {
       snprintf(pcError, MESSAGE_SIZE, "%s: Control = [%s]: %s", acRoutine, pcControl, acLocalError);
@@ -861,7 +912,7 @@ PropertiesReadLine(char *pcLine, FTIMES_PROPERTIES *psProperties, char *pcError)
 
   else if (strcasecmp(pcControl, KEY_IncludeFilterSha256) == 0 && RUN_MODE_IS_SET(MODES_IncludeFilterSha256, iRunMode))
   {
-    iError = SupportAddFilter(pc, &psProperties->psIncludeFilterSha256List, acLocalError);
+    iError = SupportAddDigestFilter(pc, SHA256_HASH_SIZE, &psProperties->psIncludeFilterSha256List, &psProperties->psIncludeFilterSha256Set, acLocalError);
     if (iError != ER_OK)
     {
       snprintf(pcError, MESSAGE_SIZE, "%s: Control = [%s]: %s", acRoutine, pcControl, acLocalError);
@@ -890,6 +941,13 @@ PropertiesReadLine(char *pcLine, FTIMES_PROPERTIES *psProperties, char *pcError)
     psProperties->sFound.bIncludesMustExistFound = TRUE;
   }
 
+  else if (strcasecmp(pcControl, KEY_IndexSnapshot) == 0 && RUN_MODE_IS_SET(MODES_IndexSnapshot, iRunMode))
+  {
+    DUPLICATE_ERROR(psProperties->sFound.bIndexSnapshotFound);
+    EVALUATE_TWOSTATE(pc, "Y", "N", psProperties->bIndexSnapshot);
+    psProperties->sFound.bIndexSnapshotFound = TRUE;
+  }
+
   else if (strcasecmp(pcControl, KEY_LogDigStrings) == 0 && RUN_MODE_IS_SET(MODES_LogDigStrings, iRunMode))
   {
     DUPLICATE_ERROR(psProperties->sFound.bLogDigStringsFound);
@@ -912,6 +970,20 @@ PropertiesReadLine(char *pcLine, FTIMES_PROPERTIES *psProperties, char *pcError)
     psProperties->sFound.bLogDirFound = TRUE;
   }
 
+#ifdef USE_XMAGIC
+  else if (strcasecmp(pcControl, KEY_MagicCacheFile) == 0 && RUN_MODE_IS_SET(MODES_MagicCacheFile, iRunMode))
+  {
+    DUPLICATE_ERROR(psProperties->sFound.bMagicCacheFileFound);
+    if (iLength < 1 || iLength > FTIMES_MAX_PATH - 1)
+    {
+      snprintf(pcError, MESSAGE_SIZE, "%s: Control = [%s], Invalid length [%d].", acRoutine, pcControl, iLength);
+      return ER;
+    }
+    strncpy(psProperties->acMagicCacheFileName, pc, FTIMES_MAX_PATH);
+    psProperties->sFound.bMagicCacheFileFound = TRUE;
+  }
+#endif
+
   else if (strcasecmp(pcControl, KEY_MagicFile) == 0 && RUN_MODE_IS_SET(MODES_MagicFile, iRunMode))
   {
     DUPLICATE_ERROR(psProperties->sFound.bMagicFileFound);
@@ -983,6 +1055,58 @@ PropertiesReadLine(char *pcLine, FTIMES_PROPERTIES *psProperties, char *pcError)
     psProperties->sFound.bOutDirFound = TRUE;
   }
 
+  else if (strcasecmp(pcControl, KEY_OutputFormat) == 0 && RUN_MODE_IS_SET(MODES_OutputFormat, iRunMode))
+  {
+    DUPLICATE_ERROR(psProperties->sFound.bOutputFormatFound);
+    if (strcasecmp(pc, "text") == 0)
+    {
+      psProperties->iOutputFormat = FTIMES_OUTPUT_FORMAT_TEXT;
+    }
+    else if (strcasecmp(pc, "binary") == 0)
+    {
+      psProperties->iOutputFormat = FTIMES_OUTPUT_FORMAT_BINARY;
+    }
+    else
+    {
+      snprintf(pcError, MESSAGE_SIZE, "%s: Control = [%s], Value must be [text|binary].", acRoutine, pcControl);
+      return ER;
+    }
+    psProperties->sFound.bOutputFormatFound = TRUE;
+  }
+
+#ifdef USE_ZLIB
+  else if (strcasecmp(pcControl, KEY_OutputCompression) == 0 && RUN_MODE_IS_SET(MODES_OutputCompression, iRunMode))
+  {
+    DUPLICATE_ERROR(psProperties->sFound.bOutputCompressionFound);
+    if (strcasecmp(pc, "none") == 0)
+    {
+      psProperties->iOutputCompression = FTIMES_OUTPUT_COMPRESSION_NONE;
+    }
+    else if (strcasecmp(pc, "gzip") == 0)
+    {
+      psProperties->iOutputCompression = FTIMES_OUTPUT_COMPRESSION_GZIP;
+    }
+    else
+    {
+      snprintf(pcError, MESSAGE_SIZE, "%s: Control = [%s], Value must be [none|gzip].", acRoutine, pcControl);
+      return ER;
+    }
+    psProperties->sFound.bOutputCompressionFound = TRUE;
+  }
+
+  else if (strcasecmp(pcControl, KEY_OutputCompressLevel) == 0 && RUN_MODE_IS_SET(MODES_OutputCompressLevel, iRunMode))
+  {
+    DUPLICATE_ERROR(psProperties->sFound.bOutputCompressLevelFound);
+    if (iLength != 1 || pc[0] < '1' || pc[0] > '9')
+    {
+      snprintf(pcError, MESSAGE_SIZE, "%s: Control = [%s], Value = [%s], Value must be an integer in the range [1-9].", acRoutine, pcControl, pc);
+      return ER;
+    }
+    psProperties->iOutputCompressLevel = pc[0] - '0';
+    psProperties->sFound.bOutputCompressLevelFound = TRUE;
+  }
+#endif
+
   else if (strcasecmp(pcControl, KEY_Priority) == 0 && RUN_MODE_IS_SET(MODES_Priority, iRunMode))
   {
     DUPLICATE_ERROR(psProperties->sFound.bPriorityFound);
@@ -1177,6 +1301,31 @@ PropertiesReadLine(char *pcLine, FTIMES_PROPERTIES *psProperties, char *pcError)
     psProperties->sFound.bURLAuthTypeFound = TRUE;
   }
 
+  else if (strcasecmp(pcControl, KEY_URLConnectTimeout) == 0 && RUN_MODE_IS_SET(MODES_URLConnectTimeout, iRunMode))
+  {
+    DUPLICATE_ERROR(psProperties->sFound.bURLConnectTimeoutFound);
+    while (iLength > 0)
+    {
+      if (!isdigit((int) pc[iLength - 1]))
+      {
+        snprintf(pcError, MESSAGE_SIZE, "%s: Control = [%s], Value = [%s], Value must be an integer.", acRoutine, pcControl, pc);
+        return ER;
+      }
+      iLength--;
+    }
+    iValue = atoi(pc);
+    if (iValue < 0 || iValue > FTIMES_MAX_URL_TIMEOUT)
+    {
+      snprintf(pcError, MESSAGE_SIZE, "%s: Control = [%s], Value = [%s], Value out of range.", acRoutine, pcControl, pc);
+      return ER;
+    }
+    else
+    {
+      psProperties->iURLConnectTimeout = iValue;
+    }
+    psProperties->sFound.bURLConnectTimeoutFound = TRUE;
+  }
+
   else if (strcasecmp(pcControl, KEY_URLGetRequest) == 0 && RUN_MODE_IS_SET(MODES_URLGetRequest, iRunMode))
   {
     DUPLICATE_ERROR(psProperties->sFound.bURLGetRequestFound);
@@ -1227,6 +1376,27 @@ PropertiesReadLine(char *pcLine, FTIMES_PROPERTIES *psProperties, char *pcError)
     psProperties->sFound.bURLPasswordFound = TRUE;
   }
 
+#ifdef USE_URL_COMPRESSION
+  else if (strcasecmp(pcControl, KEY_URLPutCompression) == 0 && RUN_MODE_IS_SET(MODES_URLPutCompression, iRunMode))
+  {
+    DUPLICATE_ERROR(psProperties->sFound.bURLPutCompressionFound);
+    if (strcasecmp(pc, "none") == 0)
+    {
+      psProperties->iURLPutCompression = FTIMES_URL_COMPRESSION_NONE;
+    }
+    else if (strcasecmp(pc, "gzip") == 0)
+    {
+      psProperties->iURLPutCompression = FTIMES_URL_COMPRESSION_GZIP;
+    }
+    else
+    {
+      snprintf(pcError, MESSAGE_SIZE, "%s: Control = [%s], Value must be [none|gzip].", acRoutine, pcControl);
+      return ER;
+    }
+    psProperties->sFound.bURLPutCompressionFound = TRUE;
+  }
+#endif
+
   else if (strcasecmp(pcControl, KEY_URLPutSnapshot) == 0 && RUN_MODE_IS_SET(MODES_URLPutSnapshot, iRunMode))
   {
     DUPLICATE_ERROR(psProperties->sFound.bURLPutSnapshotFound);
@@ -1234,6 +1404,15 @@ PropertiesReadLine(char *pcLine, FTIMES_PROPERTIES *psProperties, char *pcError)
     psProperties->sFound.bURLPutSnapshotFound = TRUE;
   }
 
+#ifdef USE_URL_STREAM
+  else if (strcasecmp(pcControl, KEY_URLPutStream) == 0 && RUN_MODE_IS_SET(MODES_URLPutStream, iRunMode))
+  {
+    DUPLICATE_ERROR(psProperties->sFound.bURLPutStreamFound);
+    EVALUATE_TWOSTATE(pc, "Y", "N", psProperties->bURLPutStream);
+    psProperties->sFound.bURLPutStreamFound = TRUE;
+  }
+#endif
+
   else if (strcasecmp(pcControl, KEY_URLPutURL) == 0 && RUN_MODE_IS_SET(MODES_URLPutURL, iRunMode))
   {
     DUPLICATE_ERROR(psProperties->sFound.bURLPutURLFound);
@@ -1251,6 +1430,31 @@ PropertiesReadLine(char *pcLine, FTIMES_PROPERTIES *psProperties, char *pcError)
     psProperties->sFound.bURLPutURLFound = TRUE;
   }
 
+  else if (strcasecmp(pcControl, KEY_URLReadTimeout) == 0 && RUN_MODE_IS_SET(MODES_URLReadTimeout, iRunMode))
+  {
+    DUPLICATE_ERROR(psProperties->sFound.bURLReadTimeoutFound);
+    while (iLength > 0)
+    {
+      if (!isdigit((int) pc[iLength - 1]))
+      {
+        snprintf(pcError, MESSAGE_SIZE, "%s: Control = [%s], Value = [%s], Value must be an integer.", acRoutine, pcControl, pc);
+        return ER;
+      }
+      iLength--;
+    }
+    iValue = atoi(pc);
+    if (iValue < 0 || iValue > FTIMES_MAX_URL_TIMEOUT)
+    {
+      snprintf(pcError, MESSAGE_SIZE, "%s: Control = [%s], Value = [%s], Value out of range.", acRoutine, pcControl, pc);
+      return ER;
+    }
+    else
+    {
+      psProperties->iURLReadTimeout = iValue;
+    }
+    psProperties->sFound.bURLReadTimeoutFound = TRUE;
+  }
+
   else if (strcasecmp(pcControl, KEY_URLUnlinkOutput) == 0 && RUN_MODE_IS_SET(MODES_URLUnlinkOutput, iRunMode))
   {
     DUPLICATE_ERROR(psProperties->sFound.bURLUnlinkOutputFound);
@@ -1270,6 +1474,31 @@ PropertiesReadLine(char *pcLine, FTIMES_PROPERTIES *psProperties, char *pcError)
     psProperties->sFound.bURLUsernameFound = TRUE;
   }
 
+  else if (strcasecmp(pcControl, KEY_URLWriteTimeout) == 0 && RUN_MODE_IS_SET(MODES_URLWriteTimeout, iRunMode))
+  {
+    DUPLICATE_ERROR(psProperties->sFound.bURLWriteTimeoutFound);
+    while (iLength > 0)
+    {
+      if (!isdigit((int) pc[iLength - 1]))
+      {
+        snprintf(pcError, MESSAGE_SIZE, "%s: Control = [%s], Value = [%s], Value must be an integer.", acRoutine, pcControl, pc);
+        return ER;
+      }
+      iLength--;
+    }
+    iValue = atoi(pc);
+    if (iValue < 0 || iValue > FTIMES_MAX_URL_TIMEOUT)
+    {
+      snprintf(pcError, MESSAGE_SIZE, "%s: Control = [%s], Value = [%s], Value out of range.", acRoutine, pcControl, pc);
+      return ER;
+    }
+    else
+    {
+      psProperties->iURLWriteTimeout = iValue;
+    }
+    psProperties->sFound.bURLWriteTimeoutFound = TRUE;
+  }
+
   else
   {
     if (psProperties->bStrictControls)
@@ -1472,6 +1701,12 @@ PropertiesDisplaySettings(FTIMES_PROPERTIES *psProperties)
     MessageHandler(MESSAGE_QUEUE_IT, MESSAGE_INFORMATION, MESSAGE_PROPERTY_STRING, acMessage);
   }
 
+  if (RUN_MODE_IS_SET(MODES_IndexSnapshot, psProperties->iRunMode))
+  {
+    snprintf(acMessage, MESSAGE_SIZE, "%s=%s", KEY_IndexSnapshot, psProperties->bIndexSnapshot ? "Y" : "N");
+    MessageHandler(MESSAGE_QUEUE_IT, MESSAGE_INFORMATION, MESSAGE_PROPERTY_STRING, acMessage);
+  }
+
   if (RUN_MODE_IS_SET(MODES_LogDir, psProperties->iRunMode))
   {
     if (psProperties->acLogDirName[0])
@@ -1481,6 +1716,17 @@ PropertiesDisplaySettings(FTIMES_PROPERTIES *psProperties)
     }
   }
 
+#ifdef USE_XMAGIC
+  if (RUN_MODE_IS_SET(MODES_MagicCacheFile, psProperties->iRunMode))
+  {
+    if (psProperties->acMagicCacheFileName[0])
+    {
+      snprintf(acMessage, MESSAGE_SIZE, "%s=%s", KEY_MagicCacheFile, psProperties->acMagicCacheFileName);
+      MessageHandler(MESSAGE_QUEUE_IT, MESSAGE_INFORMATION, MESSAGE_PROPERTY_STRING, acMessage);
+    }
+  }
+#endif
+
   if (RUN_MODE_IS_SET(MODES_MagicFile, psProperties->iRunMode))
   {
     if (psProperties->acMagicFileName[0])
@@ -1511,6 +1757,26 @@ PropertiesDisplaySettings(FTIMES_PROPERTIES *psProperties)
     }
   }
 
+  if (RUN_MODE_IS_SET(MODES_OutputFormat, psProperties->iRunMode))
+  {
+    snprintf(acMessage, MESSAGE_SIZE, "%s=%s", KEY_OutputFormat, (psProperties->iOutputFormat == FTIMES_OUTPUT_FORMAT_BINARY) ? "binary" : "text");
+    MessageHandler(MESSAGE_QUEUE_IT, MESSAGE_INFORMATION, MESSAGE_PROPERTY_STRING, acMessage);
+  }
+
+#ifdef USE_ZLIB
+  if (RUN_MODE_IS_SET(MODES_OutputCompression, psProperties->iRunMode))
+  {
+    snprintf(acMessage, MESSAGE_SIZE, "%s=%s", KEY_OutputCompression, (psProperties->iOutputCompression == FTIMES_OUTPUT_COMPRESSION_GZIP) ? "gzip" : "none");
+    MessageHandler(MESSAGE_QUEUE_IT, MESSAGE_INFORMATION, MESSAGE_PROPERTY_STRING, acMessage);
+  }
+
+  if (RUN_MODE_IS_SET(MODES_OutputCompressLevel, psProperties->iRunMode))
+  {
+    snprintf(acMessage, MESSAGE_SIZE, "%s=%d", KEY_OutputCompressLevel, psProperties->iOutputCompressLevel);
+    MessageHandler(MESSAGE_QUEUE_IT, MESSAGE_INFORMATION, MESSAGE_PROPERTY_STRING, acMessage);
+  }
+#endif
+
   if (RUN_MODE_IS_SET(MODES_Priority, psProperties->iRunMode))
   {
     snprintf(acMessage, MESSAGE_SIZE, "%s=%s", KEY_Priority, psProperties->acPriority);
@@ -1594,6 +1860,28 @@ if (RUN_MODE_IS_SET(MODES_URLPutSnapshot, psProperties->iRunMode) && psPropertie
     }
   }
 
+#ifdef USE_URL_STREAM
+  if (RUN_MODE_IS_SET(MODES_URLPutStream, psProperties->iRunMode))
+  {
+    if (psProperties->bURLPutSnapshot)
+    {
+      snprintf(acMessage, MESSAGE_SIZE, "%s=%s", KEY_URLPutStream, psProperties->bURLPutStream ? "Y" : "N");
+      MessageHandler(MESSAGE_QUEUE_IT, MESSAGE_INFORMATION, MESSAGE_PROPERTY_STRING, acMessage);
+    }
+  }
+#endif
+
+#ifdef USE_URL_COMPRESSION
+  if (RUN_MODE_IS_SET(MODES_URLPutCompression, psProperties->iRunMode))
+  {
+    if (psProperties->bURLPutSnapshot)
+    {
+      snprintf(acMessage, MESSAGE_SIZE, "%s=%s", KEY_URLPutCompression, (psProperties->iURLPutCompression == FTIMES_URL_COMPRESSION_GZIP) ? "gzip" : "none");
+      MessageHandler(MESSAGE_QUEUE_IT, MESSAGE_INFORMATION, MESSAGE_PROPERTY_STRING, acMessage);
+    }
+  }
+#endif
+
   if (RUN_MODE_IS_SET(MODES_URLUnlinkOutput, psProperties->iRunMode))
   {
     if (psProperties->bURLPutSnapshot)
@@ -1627,6 +1915,24 @@ if (RUN_MODE_IS_SET(MODES_URLPutSnapshot, psProperties->iRunMode) && psPropertie
     }
   }
 
+  if (RUN_MODE_IS_SET(MODES_URLConnectTimeout, psProperties->iRunMode))
+  {
+    snprintf(acMessage, MESSAGE_SIZE, "%s=%d", KEY_URLConnectTimeout, psProperties->iURLConnectTimeout);
+    MessageHandler(MESSAGE_QUEUE_IT, MESSAGE_INFORMATION, MESSAGE_PROPERTY_STRING, acMessage);
+  }
+
+  if (RUN_MODE_IS_SET(MODES_URLReadTimeout, psProperties->iRunMode))
+  {
+    snprintf(acMessage, MESSAGE_SIZE, "%s=%d", KEY_URLReadTimeout, psProperties->iURLReadTimeout);
+    MessageHandler(MESSAGE_QUEUE_IT, MESSAGE_INFORMATION, MESSAGE_PROPERTY_STRING, acMessage);
+  }
+
+  if (RUN_MODE_IS_SET(MODES_URLWriteTimeout, psProperties->iRunMode))
+  {
+    snprintf(acMessage, MESSAGE_SIZE, "%s=%d", KEY_URLWriteTimeout, psProperties->iURLWriteTimeout);
+    MessageHandler(MESSAGE_QUEUE_IT, MESSAGE_INFORMATION, MESSAGE_PROPERTY_STRING, acMessage);
+  }
+
 #ifdef USE_SSL
   if (RUN_MODE_IS_SET(MODES_SSLVerifyPeerCert, psProperties->iRunMode))
   {
@@ -1806,6 +2112,11 @@ if (RUN_MODE_IS_SET(MODES_URLPutSnapshot, psProperties->iRunMode) && psPropertie
       snprintf(acMessage, MESSAGE_SIZE, "%s=%s", KEY_IncludeFilterMd5, psFilterList->pcFilter);
       MessageHandler(MESSAGE_QUEUE_IT, MESSAGE_INFORMATION, MESSAGE_PROPERTY_STRING, acMessage);
     }
+    if (psProperties->psIncludeFilterMd5Set != NULL)
+    {
+      snprintf(acMessage, MESSAGE_SIZE, "%sDigests=%d", KEY_IncludeFilterMd5, psProperties->psIncludeFilterMd5Set->iCount);
+      MessageHandler(MESSAGE_QUEUE_IT, MESSAGE_INFORMATION, MESSAGE_PROPERTY_STRING, acMessage);
+    }
   }
 
   if (RUN_MODE_IS_SET(MODES_ExcludeFilterMd5, psProperties->iRunMode))
@@ -1815,6 +2126,11 @@ if (RUN_MODE_IS_SET(MODES_URLPutSnapshot, psProperties->iRunMode) && psPropertie
       snprintf(acMessage, MESSAGE_SIZE, "%s=%s", KEY_ExcludeFilterMd5, psFilterList->pcFilter);
       MessageHandler(MESSAGE_QUEUE_IT, MESSAGE_INFORMATION, MESSAGE_PROPERTY_STRING, acMessage);
     }
+    if (psProperties->psExcludeFilterMd5Set != NULL)
+    {
+      snprintf(acMessage, MESSAGE_SIZE, "%sDigests=%d", KEY_ExcludeFilterMd5, psProperties->psExcludeFilterMd5Set->iCount);
+      MessageHandler(MESSAGE_QUEUE_IT, MESSAGE_INFORMATION, MESSAGE_PROPERTY_STRING, acMessage);
+    }
   }
 
   if (RUN_MODE_IS_SET(MODES_IncludeFilterSha1, psProperties->iRunMode))
@@ -1824,6 +2140,11 @@ if (RUN_MODE_IS_SET(MODES_URLPutSnapshot, psProperties->iRunMode) && psPropertie
       snprintf(acMessage, MESSAGE_SIZE, "%s=%s", KEY_IncludeFilterSha1, psFilterList->pcFilter);
       MessageHandler(MESSAGE_QUEUE_IT, MESSAGE_INFORMATION, MESSAGE_PROPERTY_STRING, acMessage);
     }
+    if (psProperties->psIncludeFilterSha1Set != NULL)
+    {
+      snprintf(acMessage, MESSAGE_SIZE, "%sDigests=%d", KEY_IncludeFilterSha1, psProperties->psIncludeFilterSha1Set->iCount);
+      MessageHandler(MESSAGE_QUEUE_IT, MESSAGE_INFORMATION, MESSAGE_PROPERTY_STRING, acMessage);
+    }
   }
 
   if (RUN_MODE_IS_SET(MODES_ExcludeFilterSha1, psProperties->iRunMode))
@@ -1833,6 +2154,11 @@ if (RUN_MODE_IS_SET(MODES_URLPutSnapshot, psProperties->iRunMode) && psPropertie
       snprintf(acMessage, MESSAGE_SIZE, "%s=%s", KEY_ExcludeFilterSha1, psFilterList->pcFilter);
       MessageHandler(MESSAGE_QUEUE_IT, MESSAGE_INFORMATION, MESSAGE_PROPERTY_STRING, acMessage);
     }
+    if (psProperties->psExcludeFilterSha1Set != NULL)
+    {
+      snprintf(acMessage, MESSAGE_SIZE, "%sDigests=%d", KEY_ExcludeFilterSha1, psProperties->psExcludeFilterSha1Set->iCount);
+      MessageHandler(MESSAGE_QUEUE_IT, MESSAGE_INFORMATION, MESSAGE_PROPERTY_STRING, acMessage);
+    }
   }
 
   if (RUN_MODE_IS_SET(MODES_IncludeFilterSha256, psProperties->iRunMode))
@@ -1842,6 +2168,11 @@ if (RUN_MODE_IS_SET(MODES_URLPutSnapshot, psProperties->iRunMode) && psPropertie
       snprintf(acMessage, MESSAGE_SIZE, "%s=%s", KEY_IncludeFilterSha256, psFilterList->pcFilter);
       MessageHandler(MESSAGE_QUEUE_IT, MESSAGE_INFORMATION, MESSAGE_PROPERTY_STRING, acMessage);
     }
+    if (psProperties->psIncludeFilterSha256Set != NULL)
+    {
+      snprintf(acMessage, MESSAGE_SIZE, "%sDigests=%d", KEY_IncludeFilterSha256, psProperties->psIncludeFilterSha256Set->iCount);
+      MessageHandler(MESSAGE_QUEUE_IT, MESSAGE_INFORMATION, MESSAGE_PROPERTY_STRING, acMessage);
+    }
   }
 
   if (RUN_MODE_IS_SET(MODES_ExcludeFilterSha256, psProperties->iRunMode))
@@ -1851,6 +2182,11 @@ if (RUN_MODE_IS_SET(MODES_URLPutSnapshot, psProperties->iRunMode) && psPropertie
       snprintf(acMessage, MESSAGE_SIZE, "%s=%s", KEY_ExcludeFilterSha256, psFilterList->pcFilter);
       MessageHandler(MESSAGE_QUEUE_IT, MESSAGE_INFORMATION, MESSAGE_PROPERTY_STRING, acMessage);
     }
+    if (psProperties->psExcludeFilterSha256Set != NULL)
+    {
+      snprintf(acMessage, MESSAGE_SIZE, "%sDigests=%d", KEY_ExcludeFilterSha256, psProperties->psExcludeFilterSha256Set->iCount);
+      MessageHandler(MESSAGE_QUEUE_IT, MESSAGE_INFORMATION, MESSAGE_PROPERTY_STRING, acMessage);
+    }
   }
 #endif
 
@@ -1888,6 +2224,18 @@ if (RUN_MODE_IS_SET(MODES_URLPutSnapshot, psProperties->iRunMode) && psPropertie
       MessageHandler(MESSAGE_QUEUE_IT, MESSAGE_INFORMATION, MESSAGE_PROPERTY_STRING, acMessage);
     }
   }
+
+  if (RUN_MODE_IS_SET(MODES_FileHookTimeout, psProperties->iRunMode))
+  {
+    snprintf(acMessage, MESSAGE_SIZE, "%s=%d", KEY_FileHookTimeout, psProperties->iFileHookTimeout);
+    MessageHandler(MESSAGE_QUEUE_IT, MESSAGE_INFORMATION, MESSAGE_PROPERTY_STRING, acMessage);
+  }
+
+  if (RUN_MODE_IS_SET(MODES_FileHookWorkers, psProperties->iRunMode))
+  {
+    snprintf(acMessage, MESSAGE_SIZE, "%s=%d", KEY_FileHookWorkers, psProperties->iFileHookWorkers);
+    MessageHandler(MESSAGE_QUEUE_IT, MESSAGE_INFORMATION, MESSAGE_PROPERTY_STRING, acMessage);
+  }
 }
 #endif
 }
@@ -11,6 +11,36 @@
  */
 #include "all-includes.h"
 
+#ifdef USE_SENDFILE
+/*-
+ ***********************************************************************
+ *
+ * SocketCanSendFile
+ *
+ ***********************************************************************
+ */
+int
+SocketCanSendFile(SOCKET_CONTEXT *psSocketCTX)
+{
+  switch (psSocketCTX->iType)
+  {
+#ifdef USE_SSL
+  case SOCKET_TYPE_SSL:
+#ifdef USE_SSL_SENDFILE
+    return SslCanSendFile(psSocketCTX->pssl);
+#else
+    return 0;
+#endif
+    break;
+#endif
+  default:
+    return 1;
+    break;
+  }
+}
+#endif
+
+
 /*-
  ***********************************************************************
  *
@@ -52,19 +82,29 @@ SocketCleanup(SOCKET_CONTEXT *psSocketCTX)
  ***********************************************************************
  */
 SOCKET_CONTEXT
-*SocketConnect(unsigned long ulIP, unsigned short usPort, int iType, void *psslCTX, char *pcError)
+*SocketConnect(unsigned long ulIP, unsigned short usPort, int iType, void *psslCTX, int iConnectTimeout, int iReadTimeout, int iWriteTimeout, char *pcError)
 {
   const char          acRoutine[] = "SocketConnect()";
 #ifdef USE_SSL
   char                acLocalError[MESSAGE_SIZE] = "";
 #endif
+  fd_set              sFdWriteSet;
+  int                 iNReady;
   struct sockaddr_in  sServerAddr;
+  struct timeval      sTvTimeout;
   SOCKET_CONTEXT     *psSocketCTX;
 
 #ifdef WIN32
   DWORD               dwStatus;
+  DWORD               dwTimeout;
   WORD                wVersion;
   WSADATA             wsaData;
+  u_long              ulNonBlocking;
+#endif
+#ifdef UNIX
+  int                 iFlags;
+  int                 iSocketError;
+  socklen_t           iSocketErrorLength;
 #endif
 
   /*-
@@ -82,6 +122,8 @@ SOCKET_CONTEXT
   }
   memset(psSocketCTX, 0, sizeof(SOCKET_CONTEXT));
   psSocketCTX->iSocket = -1;
+  psSocketCTX->iReadTimeout = iReadTimeout;
+  psSocketCTX->iWriteTimeout = iWriteTimeout;
 
   /*-
    ***********************************************************************
@@ -111,11 +153,61 @@ SOCKET_CONTEXT
     return NULL;
   }
 
+  /*-
+   *********************************************************************
+   *
+   * If a connect timeout was specified, connect in non-blocking mode,
+   * and wait for the socket to become writable.
+   *
+   *********************************************************************
+   */
+  ulNonBlocking = (iConnectTimeout > 0) ? 1 : 0;
+  ioctlsocket(psSocketCTX->iSocket, FIONBIO, &ulNonBlocking);
   if (connect(psSocketCTX->iSocket, (struct sockaddr *) & sServerAddr, sizeof(sServerAddr)) == SOCKET_ERROR)
   {
-    snprintf(pcError, MESSAGE_SIZE, "%s: connect(): %u", acRoutine, WSAGetLastError());
-    SocketCleanup(psSocketCTX);
-    return NULL;
+    if (iConnectTimeout <= 0 || WSAGetLastError() != WSAEWOULDBLOCK)
+    {
+      snprintf(pcError, MESSAGE_SIZE, "%s: connect(): %u", acRoutine, WSAGetLastError());
+      SocketCleanup(psSocketCTX);
+      return NULL;
+    }
+    FD_ZERO(&sFdWriteSet);
+    FD_SET(psSocketCTX->iSocket, &sFdWriteSet);
+    sTvTimeout.tv_sec = iConnectTimeout;
+    sTvTimeout.tv_usec = 0;
+    iNReady = select(0, NULL, &sFdWriteSet, NULL, &sTvTimeout);
+    if (iNReady == 0)
+    {
+      snprintf(pcError, MESSAGE_SIZE, "%s: connect(): Timed out after %d seconds.", acRoutine, iConnectTimeout);
+      SocketCleanup(psSocketCTX);
+      return NULL;
+    }
+    if (iNReady == SOCKET_ERROR)
+    {
+      snprintf(pcError, MESSAGE_SIZE, "%s: select(): %u", acRoutine, WSAGetLastError());
+      SocketCleanup(psSocketCTX);
+      return NULL;
+    }
+  }
+  ulNonBlocking = 0;
+  ioctlsocket(psSocketCTX->iSocket, FIONBIO, &ulNonBlocking);
+
+  /*-
+   *********************************************************************
+   *
+   * Bound all subsequent reads and writes (including the handshake).
+   *
+   *********************************************************************
+   */
+  if (iReadTimeout > 0)
+  {
+    dwTimeout = (DWORD) iReadTimeout * 1000;
+    setsockopt(psSocketCTX->iSocket, SOL_SOCKET, SO_RCVTIMEO, (char *) &dwTimeout, sizeof(dwTimeout));
+  }
+  if (iWriteTimeout > 0)
+  {
+    dwTimeout = (DWORD) iWriteTimeout * 1000;
+    setsockopt(psSocketCTX->iSocket, SOL_SOCKET, SO_SNDTIMEO, (char *) &dwTimeout, sizeof(dwTimeout));
   }
 #endif
 
@@ -128,11 +220,111 @@ SOCKET_CONTEXT
     return NULL;
   }
 
-  if (connect(psSocketCTX->iSocket, (struct sockaddr *) & sServerAddr, sizeof(sServerAddr)) == -1)
+  /*-
+   *********************************************************************
+   *
+   * If a connect timeout was specified, connect in non-blocking mode,
+   * and wait for the socket to become writable. Then, pick up the
+   * result of the connect, and restore blocking mode.
+   *
+   *********************************************************************
+   */
+  if (iConnectTimeout > 0)
   {
-    snprintf(pcError, MESSAGE_SIZE, "%s: connect(): %s", acRoutine, strerror(errno));
-    SocketCleanup(psSocketCTX);
-    return NULL;
+    iFlags = fcntl(psSocketCTX->iSocket, F_GETFL, 0);
+    if (iFlags == -1 || fcntl(psSocketCTX->iSocket, F_SETFL, iFlags | O_NONBLOCK) == -1)
+    {
+      snprintf(pcError, MESSAGE_SIZE, "%s: fcntl(): %s", acRoutine, strerror(errno));
+      SocketCleanup(psSocketCTX);
+      return NULL;
+    }
+    if (connect(psSocketCTX->iSocket, (struct sockaddr *) & sServerAddr, sizeof(sServerAddr)) == -1)
+    {
+      if (errno != EINPROGRESS)
+      {
+        snprintf(pcError, MESSAGE_SIZE, "%s: connect(): %s", acRoutine, strerror(errno));
+        SocketCleanup(psSocketCTX);
+        return NULL;
+      }
+      do
+      {
+        FD_ZERO(&sFdWriteSet);
+        FD_SET(psSocketCTX->iSocket, &sFdWriteSet);
+        sTvTimeout.tv_sec = iConnectTimeout; /* The Linux implementation of select() modifies the timeout value, so it must be initialized before each call. */
+        sTvTimeout.tv_usec = 0;
+        iNReady = select(psSocketCTX->iSocket + 1, NULL, &sFdWriteSet, NULL, &sTvTimeout);
+      } while (iNReady == -1 && errno == EINTR);
+      if (iNReady == 0)
+      {
+        snprintf(pcError, MESSAGE_SIZE, "%s: connect(): Timed out after %d seconds.", acRoutine, iConnectTimeout);
+        SocketCleanup(psSocketCTX);
+        return NULL;
+      }
+      if (iNReady == -1)
+      {
+        snprintf(pcError, MESSAGE_SIZE, "%s: select(): %s", acRoutine, strerror(errno));
+        SocketCleanup(psSocketCTX);
+        return NULL;
+      }
+      iSocketErrorLength = sizeof(iSocketError);
+      if (getsockopt(psSocketCTX->iSocket, SOL_SOCKET, SO_ERROR, (void *) &iSocketError, &iSocketErrorLength) == -1)
+      {
+        snprintf(pcError, MESSAGE_SIZE, "%s: getsockopt(): %s", acRoutine, strerror(errno));
+        SocketCleanup(psSocketCTX);
+        return NULL;
+      }
+      if (iSocketError != 0)
+      {
+        snprintf(pcError, MESSAGE_SIZE, "%s: connect(): %s", acRoutine, strerror(iSocketError));
+        SocketCleanup(psSocketCTX);
+        return NULL;
+      }
+    }
+    if (fcntl(psSocketCTX->iSocket, F_SETFL, iFlags) == -1)
+    {
+      snprintf(pcError, MESSAGE_SIZE, "%s: fcntl(): %s", acRoutine, strerror(errno));
+      SocketCleanup(psSocketCTX);
+      return NULL;
+    }
+  }
+  else
+  {
+    if (connect(psSocketCTX->iSocket, (struct sockaddr *) & sServerAddr, sizeof(sServerAddr)) == -1)
+    {
+      snprintf(pcError, MESSAGE_SIZE, "%s: connect(): %s", acRoutine, strerror(errno));
+      SocketCleanup(psSocketCTX);
+      return NULL;
+    }
+  }
+
+  /*-
+   *********************************************************************
+   *
+   * Bound all subsequent reads and writes (including the handshake).
+   *
+   *********************************************************************
+   */
+  if (iReadTimeout > 0)
+  {
+    sTvTimeout.tv_sec = iReadTimeout;
+    sTvTimeout.tv_usec = 0;
+    if (setsockopt(psSocketCTX->iSocket, SOL_SOCKET, SO_RCVTIMEO, (void *) &sTvTimeout, sizeof(sTvTimeout)) == -1)
+    {
+      snprintf(pcError, MESSAGE_SIZE, "%s: setsockopt(): SO_RCVTIMEO: %s", acRoutine, strerror(errno));
+      SocketCleanup(psSocketCTX);
+      return NULL;
+    }
+  }
+  if (iWriteTimeout > 0)
+  {
+    sTvTimeout.tv_sec = iWriteTimeout;
+    sTvTimeout.tv_usec = 0;
+    if (setsockopt(psSocketCTX->iSocket, SOL_SOCKET, SO_SNDTIMEO, (void *) &sTvTimeout, sizeof(sTvTimeout)) == -1)
+    {
+      snprintf(pcError, MESSAGE_SIZE, "%s: setsockopt(): SO_SNDTIMEO: %s", acRoutine, strerror(errno));
+      SocketCleanup(psSocketCTX);
+      return NULL;
+    }
   }
 #endif
 
@@ -172,6 +364,49 @@ SOCKET_CONTEXT
 }
 
 
+/*-
+ ***********************************************************************
+ *
+ * SocketIsReusable
+ *
+ ***********************************************************************
+ */
+int
+SocketIsReusable(SOCKET_CONTEXT *psSocketCTX)
+{
+  fd_set              sFdReadSet;
+  int                 iNReady;
+  struct timeval      sTvTimeout = { 0, 0 };
+
+  if (psSocketCTX == NULL || psSocketCTX->iSocket == -1)
+  {
+    return 0;
+  }
+
+#ifdef USE_SSL
+  if (psSocketCTX->iType == SOCKET_TYPE_SSL && (psSocketCTX->pssl == NULL || SSL_pending(psSocketCTX->pssl) > 0))
+  {
+    return 0;
+  }
+#endif
+
+  /*-
+   *********************************************************************
+   *
+   * An idle connection should have nothing to read. If the socket is
+   * readable, the peer has either closed its end or sent unsolicited
+   * data. In both cases, the connection must not be reused.
+   *
+   *********************************************************************
+   */
+  FD_ZERO(&sFdReadSet);
+  FD_SET(psSocketCTX->iSocket, &sFdReadSet);
+  iNReady = select(psSocketCTX->iSocket + 1, &sFdReadSet, NULL, NULL, &sTvTimeout);
+
+  return (iNReady == 0) ? 1 : 0;
+}
+
+
 /*-
  ***********************************************************************
  *
@@ -203,6 +438,13 @@ SocketRead(SOCKET_CONTEXT *psSocketCTX, char *pcData, int iToRead, char *pcError
     iNRead = recv(psSocketCTX->iSocket, pcData, iToRead, 0);
     if (iNRead == -1)
     {
+#ifdef UNIX
+      if (errno == EAGAIN || errno == EWOULDBLOCK)
+      {
+        snprintf(pcError, MESSAGE_SIZE, "%s: recv(): Timed out after %d seconds.", acRoutine, psSocketCTX->iReadTimeout);
+        break;
+      }
+#endif
       snprintf(pcError, MESSAGE_SIZE, "%s: recv(): %s", acRoutine, strerror(errno));
     }
     break;
@@ -212,6 +454,106 @@ SocketRead(SOCKET_CONTEXT *psSocketCTX, char *pcData, int iToRead, char *pcError
 }
 
 
+#ifdef USE_SENDFILE
+/*-
+ ***********************************************************************
+ *
+ * SocketSendFile
+ *
+ ***********************************************************************
+ */
+int
+SocketSendFile(SOCKET_CONTEXT *psSocketCTX, FILE *pFile, APP_UI32 ui32Size, char *pcError)
+{
+  const char          acRoutine[] = "SocketSendFile()";
+#ifdef USE_SSL_SENDFILE
+  char                acLocalError[MESSAGE_SIZE] = "";
+#endif
+  int                 iFile;
+  int                 iNSent;
+  int                 iToSend;
+  off_t               tOffset;
+
+  /*-
+   *********************************************************************
+   *
+   * Start at the stream's logical position. That accounts for any data
+   * that stdio has buffered but not yet handed out. Once done, leave
+   * the stream positioned just past the data that was sent.
+   *
+   *********************************************************************
+   */
+  iFile = fileno(pFile);
+  tOffset = ftello(pFile);
+  if (tOffset == (off_t) -1)
+  {
+    snprintf(pcError, MESSAGE_SIZE, "%s: ftello(): %s", acRoutine, strerror(errno));
+    return -1;
+  }
+
+  /*-
+   *********************************************************************
+   *
+   * Have the kernel copy file data straight to the socket. With SSL,
+   * this only works once kTLS has taken over record encryption (see
+   * SocketCanSendFile()).
+   *
+   *********************************************************************
+   */
+  while (ui32Size > 0)
+  {
+    iToSend = (ui32Size > SOCKET_SENDFILE_MAX) ? SOCKET_SENDFILE_MAX : (int) ui32Size;
+    switch (psSocketCTX->iType)
+    {
+#ifdef USE_SSL_SENDFILE
+    case SOCKET_TYPE_SSL:
+      iNSent = SslSendFile(psSocketCTX->pssl, iFile, tOffset, iToSend, acLocalError);
+      if (iNSent == -1)
+      {
+        snprintf(pcError, MESSAGE_SIZE, "%s: %s", acRoutine, acLocalError);
+        return -1;
+      }
+      tOffset += iNSent;
+      break;
+#endif
+    default:
+      iNSent = sendfile(psSocketCTX->iSocket, iFile, &tOffset, iToSend); /* This advances tOffset. */
+      if (iNSent == -1)
+      {
+        if (errno == EINTR)
+        {
+          iNSent = 0;
+          break;
+        }
+        if (errno == EAGAIN || errno == EWOULDBLOCK)
+        {
+          snprintf(pcError, MESSAGE_SIZE, "%s: sendfile(): Timed out after %d seconds.", acRoutine, psSocketCTX->iWriteTimeout);
+          return -1;
+        }
+        snprintf(pcError, MESSAGE_SIZE, "%s: sendfile(): %s", acRoutine, strerror(errno));
+        return -1;
+      }
+      if (iNSent == 0)
+      {
+        snprintf(pcError, MESSAGE_SIZE, "%s: sendfile(): Unexpected end of file.", acRoutine);
+        return -1;
+      }
+      break;
+    }
+    ui32Size -= (APP_UI32) iNSent;
+  }
+
+  if (fseeko(pFile, tOffset, SEEK_SET) != 0)
+  {
+    snprintf(pcError, MESSAGE_SIZE, "%s: fseeko(): %s", acRoutine, strerror(errno));
+    return -1;
+  }
+
+  return 0;
+}
+#endif
+
+
 /*-
  ***********************************************************************
  *
@@ -226,6 +568,7 @@ SocketWrite(SOCKET_CONTEXT *psSocketCTX, char *pcData, int iToSend, char *pcErro
 #ifdef USE_SSL
   char                acLocalError[MESSAGE_SIZE] = "";
 #endif
+  int                 iCount;
   int                 iNSent;
 
   if (iToSend == 0)
@@ -245,10 +588,30 @@ SocketWrite(SOCKET_CONTEXT *psSocketCTX, char *pcData, int iToSend, char *pcErro
     break;
 #endif
   default:
-    iNSent = send(psSocketCTX->iSocket, pcData, iToSend, 0);
-    if (iNSent == -1)
+    /*-
+     *******************************************************************
+     *
+     * A blocking send() only comes up short when the write timeout
+     * expires part way through. Keep going, so that the next call
+     * reports the timeout rather than a short count.
+     *
+     *******************************************************************
+     */
+    for (iNSent = 0; iNSent < iToSend; iNSent += iCount)
     {
-      snprintf(pcError, MESSAGE_SIZE, "%s: send(): %s", acRoutine, strerror(errno));
+      iCount = send(psSocketCTX->iSocket, &pcData[iNSent], iToSend - iNSent, 0);
+      if (iCount == -1)
+      {
+#ifdef UNIX
+        if (errno == EAGAIN || errno == EWOULDBLOCK)
+        {
+          snprintf(pcError, MESSAGE_SIZE, "%s: send(): Timed out after %d seconds.", acRoutine, psSocketCTX->iWriteTimeout);
+          return -1;
+        }
+#endif
+        snprintf(pcError, MESSAGE_SIZE, "%s: send(): %s", acRoutine, strerror(errno));
+        return -1;
+      }
     }
     break;
   }
@@ -28,6 +28,8 @@
 #define SOCKET_TYPE_REGULAR 0
 #define SOCKET_TYPE_SSL     1
 
+#define SOCKET_SENDFILE_MAX 0x40000000 /* Bytes handed to the kernel at a time */
+
 /*-
  ***********************************************************************
  *
@@ -37,8 +39,10 @@
  */
 typedef struct _SOCKET_CONTEXT
 {
+  int                 iReadTimeout;
   int                 iSocket;
   int                 iType;
+  int                 iWriteTimeout;
 #ifdef USE_SSL
   SSL_CTX            *psslCTX;
   SSL                *pssl;
@@ -52,9 +56,16 @@ typedef struct _SOCKET_CONTEXT
  *
  ***********************************************************************
  */
+#ifdef USE_SENDFILE
+int                   SocketCanSendFile(SOCKET_CONTEXT *psSocketCTX);
+#endif
 void                  SocketCleanup(SOCKET_CONTEXT *psSocketCTX);
-SOCKET_CONTEXT       *SocketConnect(unsigned long ulIP, unsigned short usPort, int iType, void *psslCTX, char *pcError);
+SOCKET_CONTEXT       *SocketConnect(unsigned long ulIP, unsigned short usPort, int iType, void *psslCTX, int iConnectTimeout, int iReadTimeout, int iWriteTimeout, char *pcError);
+int                   SocketIsReusable(SOCKET_CONTEXT *psSocketCTX);
 int                   SocketRead(SOCKET_CONTEXT *psSocketCTX, char *pcData, int iToRead, char *pcError);
+#ifdef USE_SENDFILE
+int                   SocketSendFile(SOCKET_CONTEXT *psSocketCTX, FILE *pFile, APP_UI32 ui32Size, char *pcError);
+#endif
 int                   SocketWrite(SOCKET_CONTEXT *psSocketCTX, char *pcData, int iToSend, char *pcError);
 
 #endif /* !_SOCKET_H_INCLUDED */
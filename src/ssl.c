@@ -36,6 +36,22 @@ SslBoot(void)
 }
 
 
+#ifdef USE_SSL_SENDFILE
+/*-
+ ***********************************************************************
+ *
+ * SslCanSendFile
+ *
+ ***********************************************************************
+ */
+int
+SslCanSendFile(SSL *ssl)
+{
+  return (BIO_get_ktls_send(SSL_get_wbio(ssl))) ? 1 : 0;
+}
+#endif
+
+
 /*-
  ***********************************************************************
  *
@@ -50,6 +66,7 @@ SslConnect(int iSocket, SSL_CTX *psslCTX, char *pcError)
   char                acLocalError[MESSAGE_SIZE] = "";
   int                 iError;
   SSL                 *pssl;
+  SSL_PROPERTIES     *psProperties;
 
   pssl = SSL_new(psslCTX);
   if (pssl == NULL)
@@ -68,9 +85,30 @@ SslConnect(int iSocket, SSL_CTX *psslCTX, char *pcError)
     return NULL;
   }
 
+  /*-
+   *********************************************************************
+   *
+   * Offer the last session negotiated under this context, if any. If
+   * the server declines it, a full handshake takes place.
+   *
+   *********************************************************************
+   */
+  psProperties = (SSL_PROPERTIES *) SSL_CTX_get_app_data(psslCTX);
+  if (psProperties != NULL && psProperties->psslSession != NULL)
+  {
+    SSL_set_session(pssl, psProperties->psslSession);
+  }
+
+  errno = 0;
   iError = SSL_connect(pssl);
   if (iError <= 0)
   {
+    if (SSL_IS_TIMEOUT(SSL_get_error(pssl, iError)))
+    {
+      snprintf(pcError, MESSAGE_SIZE, "%s: SSL_connect(): Handshake timed out.", acRoutine);
+      SSL_free(pssl);
+      return NULL;
+    }
     ERR_error_string(ERR_get_error(), acLocalError);
     snprintf(pcError, MESSAGE_SIZE, "%s: SSL_connect(): %s", acRoutine, acLocalError);
     SSL_free(pssl);
@@ -113,6 +151,10 @@ SslFreeProperties(SSL_PROPERTIES *psSslProperties)
     {
       free(psSslProperties->pcExpectedPeerCN);
     }
+    if (psSslProperties->psslSession != NULL)
+    {
+      SSL_SESSION_free(psSslProperties->psslSession);
+    }
     if (psSslProperties->psslCTX != NULL)
     {
       SSL_CTX_free(psSslProperties->psslCTX);
@@ -286,6 +328,39 @@ SslInitializeCTX(SSL_PROPERTIES *psProperties, char *pcError)
     )
   );
 
+  /*-
+   *********************************************************************
+   *
+   * Enable client-side session caching. New sessions are passed to
+   * SslNewSessionHandler(), which holds on to the latest one so that
+   * subsequent connections can resume it. A session negotiated under
+   * a previous context is discarded since its settings may differ.
+   *
+   *********************************************************************
+   */
+  if (psProperties->psslSession != NULL)
+  {
+    SSL_SESSION_free(psProperties->psslSession);
+    psProperties->psslSession = NULL;
+  }
+  SSL_CTX_set_app_data(psProperties->psslCTX, (void *) psProperties);
+  SSL_CTX_set_session_cache_mode(psProperties->psslCTX, SSL_SESS_CACHE_CLIENT | SSL_SESS_CACHE_NO_INTERNAL_STORE);
+  SSL_CTX_sess_set_new_cb(psProperties->psslCTX, SslNewSessionHandler);
+
+#ifdef USE_SSL_SENDFILE
+  /*-
+   *********************************************************************
+   *
+   * Let the kernel take over record encryption (kTLS) when it can. That
+   * allows uploads to be sent with SslSendFile(). If the kernel or the
+   * negotiated cipher doesn't support it, OpenSSL quietly carries on in
+   * user space.
+   *
+   *********************************************************************
+   */
+  SSL_CTX_set_options(psProperties->psslCTX, SSL_OP_ENABLE_KTLS);
+#endif
+
   /*-
    *********************************************************************
    *
@@ -465,6 +540,34 @@ SslNewProperties(char *pcError)
 }
 
 
+/*-
+ ***********************************************************************
+ *
+ * SslNewSessionHandler
+ *
+ ***********************************************************************
+ */
+int
+SslNewSessionHandler(SSL *ssl, SSL_SESSION *psslSession)
+{
+  SSL_PROPERTIES     *psProperties;
+
+  psProperties = (SSL_PROPERTIES *) SSL_CTX_get_app_data(SSL_get_SSL_CTX(ssl));
+  if (psProperties == NULL)
+  {
+    return 0;
+  }
+
+  if (psProperties->psslSession != NULL)
+  {
+    SSL_SESSION_free(psProperties->psslSession);
+  }
+  psProperties->psslSession = psslSession;
+
+  return 1; /* Tell OpenSSL that we now own a reference to the session. */
+}
+
+
 /*-
  ***********************************************************************
  *
@@ -509,6 +612,7 @@ SslRead(SSL *ssl, char *pcData, int iLength, char *pcError)
 
   iDone = iRRetries = 0;
 
+  errno = 0;
   iNRead = SSL_read(ssl, pcData, iLength);
 
   while (iDone == 0)
@@ -527,9 +631,15 @@ SslRead(SSL *ssl, char *pcData, int iLength, char *pcError)
       break;
 
     case SSL_ERROR_WANT_READ:
+      if (SSL_IS_TIMEOUT(SSL_ERROR_WANT_READ))
+      {
+        snprintf(pcError, MESSAGE_SIZE, "%s: SSL_read(): Timed out.", acRoutine);
+        return -1;
+      }
       if (++iRRetries < SSL_RETRY_LIMIT)
       {
         snprintf(pcError, MESSAGE_SIZE, "%s: SSL_read(): SSL_ERROR_WANT_READ", acRoutine);
+        errno = 0;
         iNRead = SSL_read(ssl, pcData, iLength);
         iDone = 0;
       }
@@ -582,6 +692,51 @@ SslRead(SSL *ssl, char *pcData, int iLength, char *pcError)
 }
 
 
+#ifdef USE_SSL_SENDFILE
+/*-
+ ***********************************************************************
+ *
+ * SslSendFile
+ *
+ ***********************************************************************
+ */
+int
+SslSendFile(SSL *ssl, int iFile, off_t tOffset, int iLength, char *pcError)
+{
+  const char          acRoutine[] = "SslSendFile()";
+  char                acLocalError[MESSAGE_SIZE] = "";
+  int                 iNSent;
+
+  errno = 0;
+  iNSent = (int) SSL_sendfile(ssl, iFile, tOffset, (size_t) iLength, 0);
+  if (iNSent < 0)
+  {
+    switch (SSL_get_error(ssl, iNSent))
+    {
+    case SSL_ERROR_SYSCALL:
+      snprintf(pcError, MESSAGE_SIZE, "%s: SSL_sendfile(): SSL_ERROR_SYSCALL: %s", acRoutine, strerror(errno));
+      break;
+    case SSL_ERROR_WANT_WRITE:
+      if (SSL_IS_TIMEOUT(SSL_ERROR_WANT_WRITE))
+      {
+        snprintf(pcError, MESSAGE_SIZE, "%s: SSL_sendfile(): Timed out.", acRoutine);
+        break;
+      }
+      snprintf(pcError, MESSAGE_SIZE, "%s: SSL_sendfile(): SSL_ERROR_WANT_WRITE", acRoutine);
+      break;
+    default:
+      ERR_error_string(ERR_get_error(), acLocalError);
+      snprintf(pcError, MESSAGE_SIZE, "%s: SSL_sendfile(): %s", acRoutine, acLocalError);
+      break;
+    }
+    return -1;
+  }
+
+  return iNSent;
+}
+#endif
+
+
 /*-
  ***********************************************************************
  *
@@ -856,6 +1011,7 @@ SslWrite(SSL *ssl, char *pcData, int iLength, char *pcError)
 
   do
   {
+    errno = 0;
     iNSent = SSL_write(ssl, &pcData[iOffset], iToSend);
 
     switch (SSL_get_error(ssl, iNSent))
@@ -884,6 +1040,11 @@ SslWrite(SSL *ssl, char *pcData, int iLength, char *pcError)
        *
        *****************************************************************
        */
+      if (SSL_IS_TIMEOUT(SSL_ERROR_WANT_WRITE))
+      {
+        snprintf(pcError, MESSAGE_SIZE, "%s: SSL_write(): Timed out.", acRoutine);
+        return -1;
+      }
       if (++iWRetries >= SSL_RETRY_LIMIT)
       {
         snprintf(pcError, MESSAGE_SIZE, "%s: SSL_write(): SSL_ERROR_WANT_WRITE: Retry limit reached!", acRoutine);
@@ -40,6 +40,10 @@
 #define SSL_READ_BUFSIZE             0x4000
 #define SSL_RETRY_LIMIT                  20
 
+#if defined(USE_SENDFILE) && defined(SSL_OP_ENABLE_KTLS) && !defined(OPENSSL_NO_KTLS)
+#define USE_SSL_SENDFILE 1
+#endif
+
 /*-
  ***********************************************************************
  *
@@ -58,8 +62,18 @@ typedef struct _SSL_PROPERTIES
   int                 iUseCertificate;
   int                 iVerifyPeerCert;
   SSL_CTX            *psslCTX;
+  SSL_SESSION        *psslSession;
 } SSL_PROPERTIES;
 
+/*-
+ ***********************************************************************
+ *
+ * Macros
+ *
+ ***********************************************************************
+ */
+#define SSL_IS_TIMEOUT(iSslError) ((((iSslError) == SSL_ERROR_WANT_READ) || ((iSslError) == SSL_ERROR_WANT_WRITE)) && ((errno == EAGAIN) || (errno == EWOULDBLOCK)))
+
 /*-
  ***********************************************************************
  *
@@ -68,14 +82,21 @@ typedef struct _SSL_PROPERTIES
  ***********************************************************************
  */
 void                  SslBoot(void);
+#ifdef USE_SSL_SENDFILE
+int                   SslCanSendFile(SSL *ssl);
+#endif
 SSL                  *SslConnect(int iSocket, SSL_CTX *psslCTX, char *pcError);
 void                  SslFreeProperties(SSL_PROPERTIES *psSslProperties);
 unsigned char        *SslGenerateSeed(unsigned char *pucSeed, unsigned long iLength);
 char                 *SslGetVersion(void);
 SSL_CTX              *SslInitializeCTX(SSL_PROPERTIES *psProperties, char *pcError);
 SSL_PROPERTIES       *SslNewProperties(char *pcError);
+int                   SslNewSessionHandler(SSL *ssl, SSL_SESSION *psslSession);
 int                   SslPassPhraseHandler(char *pcPassPhrase, int iSize, int iRWFlag, void *pUserData);
 int                   SslRead(SSL *ssl, char *pcData, int iLength, char *pcError);
+#ifdef USE_SSL_SENDFILE
+int                   SslSendFile(SSL *ssl, int iFile, off_t tOffset, int iLength, char *pcError);
+#endif
 void                  SslSessionCleanup(SSL *ssl);
 int                   SslSetBundledCAsFile(SSL_PROPERTIES *psProperties, char *pcBundledCAsFile, char *pcError);
 int                   SslSetDynamicString(char **ppcValue, char *pcNewValue, char *pcError);
@@ -18,6 +18,51 @@ static int (*NCompareFunction)(const char *s1, const char *s2, size_t n) = strnc
 static int (*CompareFunction)(const char *s1, const char *s2) = strcmp;
 static int (*NCompareFunction)(const char *s1, const char *s2, size_t n) = strncmp;
 #endif
+#ifdef USE_PCRE
+static int            giDigestSize; /* Used by SupportCompareDigests(). */
+#endif
+
+/*-
+ ***********************************************************************
+ *
+ * Encode non-printables and [|"'`%+#]. Conditionally encode '/' and
+ * '\' depending on the target platform. Spaces are flagged here too,
+ * but they get converted to '+' rather than percent-encoded. Avoid
+ * isprint() when changing this table because it has led to unexpected
+ * results on Windows platforms. In the past, isprint() on certain
+ * Windows systems has decided that several characters in the range
+ * 0x7f - 0xff are printable.
+ *
+ ***********************************************************************
+ */
+static const unsigned char gaucNeuterTable[256] =
+{
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, /* 0x00 - 0x0f */
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, /* 0x10 - 0x1f */
+#ifdef WINNT
+  1, 0, 1, 1, 0, 1, 0, 1, 0, 0, 0, 1, 0, 0, 0, 1, /* 0x20 - 0x2f */
+#else
+  1, 0, 1, 1, 0, 1, 0, 1, 0, 0, 0, 1, 0, 0, 0, 0, /* 0x20 - 0x2f */
+#endif
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, /* 0x30 - 0x3f */
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, /* 0x40 - 0x4f */
+#ifdef WINNT
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, /* 0x50 - 0x5f */
+#else
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 0, 0, 0, /* 0x50 - 0x5f */
+#endif
+  1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, /* 0x60 - 0x6f */
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 0, 0, 1, /* 0x70 - 0x7f */
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, /* 0x80 - 0x8f */
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, /* 0x90 - 0x9f */
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, /* 0xa0 - 0xaf */
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, /* 0xb0 - 0xbf */
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, /* 0xc0 - 0xcf */
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, /* 0xd0 - 0xdf */
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, /* 0xe0 - 0xef */
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, /* 0xf0 - 0xff */
+};
+static const char     gacNeuterHexDigits[] = "0123456789abcdef";
 
 /*-
  ***********************************************************************
@@ -238,6 +283,91 @@ SupportAddToList(char *pcPath, FILE_LIST **ppsList, char *pcListName, char *pcEr
 }
 
 
+/*-
+ ***********************************************************************
+ *
+ * SupportAddToTrie
+ *
+ ***********************************************************************
+ */
+int
+SupportAddToTrie(FILE_TRIE *psRoot, FILE_LIST *psItem, char *pcError)
+{
+  const char          acRoutine[] = "SupportAddToTrie()";
+  char                acLocalError[MESSAGE_SIZE] = "";
+  char               *pcEnd = NULL;
+  char               *pcName = NULL;
+  char               *pcTail = NULL;
+  int                 iIndex = 0;
+  FILE_TRIE          *psChild = NULL;
+  FILE_TRIE          *psNode = psRoot;
+  FILE_TRIE         **ppsChildren = NULL;
+
+  /*-
+   *********************************************************************
+   *
+   * Walk the path one component at a time, creating nodes as needed.
+   * Children are kept sorted, so new nodes are inserted in place.
+   *
+   *********************************************************************
+   */
+  pcTail = SupportGetTrieTail(psItem->pcRegularPath);
+  for (pcName = psItem->pcRegularPath; ; pcName = pcEnd + 1)
+  {
+    pcEnd = memchr(pcName, FTIMES_SLASHCHAR, pcTail - pcName);
+    if (pcEnd == NULL)
+    {
+      pcEnd = pcTail;
+    }
+    psChild = SupportGetTrieChild(psNode, pcName, pcEnd - pcName, &iIndex);
+    if (psChild == NULL)
+    {
+      psChild = SupportNewTrieNode(pcName, pcEnd - pcName, acLocalError);
+      if (psChild == NULL)
+      {
+        snprintf(pcError, MESSAGE_SIZE, "%s: %s", acRoutine, acLocalError);
+        return ER;
+      }
+      if (psNode->iChildCount >= psNode->iChildSize)
+      {
+        ppsChildren = (FILE_TRIE **) realloc(psNode->ppsChildren, (psNode->iChildSize + FILE_TRIE_CHILD_COUNT) * sizeof(FILE_TRIE *));
+        if (ppsChildren == NULL)
+        {
+          snprintf(pcError, MESSAGE_SIZE, "%s: realloc(): %s", acRoutine, strerror(errno));
+          SupportFreeTrie(psChild);
+          return ER;
+        }
+        psNode->ppsChildren = ppsChildren;
+        psNode->iChildSize += FILE_TRIE_CHILD_COUNT;
+      }
+      memmove(&psNode->ppsChildren[iIndex + 1], &psNode->ppsChildren[iIndex], (psNode->iChildCount - iIndex) * sizeof(FILE_TRIE *));
+      psNode->ppsChildren[iIndex] = psChild;
+      psNode->iChildCount++;
+    }
+    psNode = psChild;
+    if (pcEnd == pcTail)
+    {
+      break;
+    }
+  }
+
+  /*-
+   *********************************************************************
+   *
+   * Mark the final node. If the path is already present, the first
+   * item wins.
+   *
+   *********************************************************************
+   */
+  if (psNode->psItem == NULL)
+  {
+    psNode->psItem = psItem;
+  }
+
+  return ER_OK;
+}
+
+
 #ifdef WINNT
 /*-
  ***********************************************************************
@@ -339,13 +469,17 @@ SupportApplyFilters(FTIMES_PROPERTIES *psProperties, FTIMES_FILE_DATA *psFTFileD
    *********************************************************************
    *
    * Conditionally apply exclude filters. These filters take precedence
-   * over include filters. If there's a match, return immediately.
+   * over include filters. If there's a match, return immediately. The
+   * combined unions are used when the run mode built them. Otherwise,
+   * the filters are matched one at a time.
    *
    *********************************************************************
    */
   if (psProperties->psExcludeFilterList)
   {
-    psFilter = SupportMatchFilter(psProperties->psExcludeFilterList, psFTFileData->pcRawPath);
+    psFilter = (psProperties->psExcludeFilterUnion != NULL)
+      ? SupportMatchFilterUnion(psProperties->psExcludeFilterUnion, psFTFileData->pcRawPath)
+      : SupportMatchFilter(psProperties->psExcludeFilterList, psFTFileData->pcRawPath);
     if (psFilter != NULL)
     {
       if (psProperties->iLogLevel <= MESSAGE_DEBUGGER)
@@ -371,7 +505,9 @@ SupportApplyFilters(FTIMES_PROPERTIES *psProperties, FTIMES_FILE_DATA *psFTFileD
    */
   if (psProperties->psIncludeFilterList)
   {
-    psFilter = SupportMatchFilter(psProperties->psIncludeFilterList, psFTFileData->pcRawPath);
+    psFilter = (psProperties->psIncludeFilterUnion != NULL)
+      ? SupportMatchFilterUnion(psProperties->psIncludeFilterUnion, psFTFileData->pcRawPath)
+      : SupportMatchFilter(psProperties->psIncludeFilterList, psFTFileData->pcRawPath);
     if (psFilter != NULL)
     {
       if (psProperties->iLogLevel <= MESSAGE_DEBUGGER)
@@ -418,13 +554,16 @@ void
 SupportApplyFiltersForHashes(FTIMES_PROPERTIES *psProperties, FTIMES_FILE_DATA *psFTFileData, int iFilterWhen)
 {
   char                acMessage[MESSAGE_SIZE] = "";
+  int                 iMatch = 0;
   FILTER_LIST        *psFilter = NULL;
 
   /*-
    *********************************************************************
    *
    * Conditionally apply exclude filters. These filters take precedence
-   * over include filters. If there's a match, return immediately.
+   * over include filters. If there's a match, return immediately. The
+   * combined unions are used when the run mode built them. Otherwise,
+   * the filters are matched one at a time.
    *
    *********************************************************************
    */
@@ -432,14 +571,15 @@ SupportApplyFiltersForHashes(FTIMES_PROPERTIES *psProperties, FTIMES_FILE_DATA *
   {
     char acHash[MD5_HASH_SIZE*2+1];
     MD5HashToHex(psFTFileData->aucFileMd5, acHash);
-    if (psProperties->psExcludeFilterMd5List)
+    if (psProperties->psExcludeFilterMd5List || psProperties->psExcludeFilterMd5Set)
     {
-      psFilter = SupportMatchFilter(psProperties->psExcludeFilterMd5List, acHash);
-      if (psFilter != NULL)
+      iMatch = SupportMatchDigestSet(psProperties->psExcludeFilterMd5Set, psFTFileData->aucFileMd5);
+      psFilter = (iMatch) ? NULL : SupportMatchFilter(psProperties->psExcludeFilterMd5List, acHash);
+      if (iMatch || psFilter != NULL)
       {
         if (psProperties->iLogLevel <= MESSAGE_DEBUGGER)
         {
-          snprintf(acMessage, MESSAGE_SIZE, "ExcludeFilterMd5=[%s], RawPath=[%s]", psFilter->pcFilter, psFTFileData->pcRawPath);
+          snprintf(acMessage, MESSAGE_SIZE, "ExcludeFilterMd5=[%s], RawPath=[%s]", (iMatch) ? acHash : psFilter->pcFilter, psFTFileData->pcRawPath);
           MessageHandler(MESSAGE_FLUSH_IT, MESSAGE_DEBUGGER, MESSAGE_DEBUGGER_STRING, acMessage);
         }
         psFTFileData->iFiltered = FTIMES_FILTER_POST_DATA;
@@ -451,14 +591,15 @@ SupportApplyFiltersForHashes(FTIMES_PROPERTIES *psProperties, FTIMES_FILE_DATA *
   {
     char acHash[SHA1_HASH_SIZE*2+1];
     SHA1HashToHex(psFTFileData->aucFileSha1, acHash);
-    if (psProperties->psExcludeFilterSha1List)
+    if (psProperties->psExcludeFilterSha1List || psProperties->psExcludeFilterSha1Set)
     {
-      psFilter = SupportMatchFilter(psProperties->psExcludeFilterSha1List, acHash);
-      if (psFilter != NULL)
+      iMatch = SupportMatchDigestSet(psProperties->psExcludeFilterSha1Set, psFTFileData->aucFileSha1);
+      psFilter = (iMatch) ? NULL : SupportMatchFilter(psProperties->psExcludeFilterSha1List, acHash);
+      if (iMatch || psFilter != NULL)
       {
         if (psProperties->iLogLevel <= MESSAGE_DEBUGGER)
         {
-          snprintf(acMessage, MESSAGE_SIZE, "ExcludeFilterSha1=[%s], RawPath=[%s]", psFilter->pcFilter, psFTFileData->pcRawPath);
+          snprintf(acMessage, MESSAGE_SIZE, "ExcludeFilterSha1=[%s], RawPath=[%s]", (iMatch) ? acHash : psFilter->pcFilter, psFTFileData->pcRawPath);
           MessageHandler(MESSAGE_FLUSH_IT, MESSAGE_DEBUGGER, MESSAGE_DEBUGGER_STRING, acMessage);
         }
         psFTFileData->iFiltered = FTIMES_FILTER_POST_DATA;
@@ -470,14 +611,15 @@ SupportApplyFiltersForHashes(FTIMES_PROPERTIES *psProperties, FTIMES_FILE_DATA *
   {
     char acHash[SHA256_HASH_SIZE*2+1];
     SHA256HashToHex(psFTFileData->aucFileSha256, acHash);
-    if (psProperties->psExcludeFilterSha256List)
+    if (psProperties->psExcludeFilterSha256List || psProperties->psExcludeFilterSha256Set)
     {
-      psFilter = SupportMatchFilter(psProperties->psExcludeFilterSha256List, acHash);
-      if (psFilter != NULL)
+      iMatch = SupportMatchDigestSet(psProperties->psExcludeFilterSha256Set, psFTFileData->aucFileSha256);
+      psFilter = (iMatch) ? NULL : SupportMatchFilter(psProperties->psExcludeFilterSha256List, acHash);
+      if (iMatch || psFilter != NULL)
       {
         if (psProperties->iLogLevel <= MESSAGE_DEBUGGER)
         {
-          snprintf(acMessage, MESSAGE_SIZE, "ExcludeFilterSha256=[%s], RawPath=[%s]", psFilter->pcFilter, psFTFileData->pcRawPath);
+          snprintf(acMessage, MESSAGE_SIZE, "ExcludeFilterSha256=[%s], RawPath=[%s]", (iMatch) ? acHash : psFilter->pcFilter, psFTFileData->pcRawPath);
           MessageHandler(MESSAGE_FLUSH_IT, MESSAGE_DEBUGGER, MESSAGE_DEBUGGER_STRING, acMessage);
         }
         psFTFileData->iFiltered = FTIMES_FILTER_POST_DATA;
@@ -516,14 +658,15 @@ SupportApplyFiltersForHashes(FTIMES_PROPERTIES *psProperties, FTIMES_FILE_DATA *
   {
     char acHash[MD5_HASH_SIZE*2+1];
     MD5HashToHex(psFTFileData->aucFileMd5, acHash);
-    if (psProperties->psIncludeFilterMd5List)
+    if (psProperties->psIncludeFilterMd5List || psProperties->psIncludeFilterMd5Set)
     {
-      psFilter = SupportMatchFilter(psProperties->psIncludeFilterMd5List, acHash);
-      if (psFilter != NULL)
+      iMatch = SupportMatchDigestSet(psProperties->psIncludeFilterMd5Set, psFTFileData->aucFileMd5);
+      psFilter = (iMatch) ? NULL : SupportMatchFilter(psProperties->psIncludeFilterMd5List, acHash);
+      if (iMatch || psFilter != NULL)
       {
         if (psProperties->iLogLevel <= MESSAGE_DEBUGGER)
         {
-          snprintf(acMessage, MESSAGE_SIZE, "IncludeFilterMd5=[%s], RawPath=[%s]", psFilter->pcFilter, psFTFileData->pcRawPath);
+          snprintf(acMessage, MESSAGE_SIZE, "IncludeFilterMd5=[%s], RawPath=[%s]", (iMatch) ? acHash : psFilter->pcFilter, psFTFileData->pcRawPath);
           MessageHandler(MESSAGE_FLUSH_IT, MESSAGE_DEBUGGER, MESSAGE_DEBUGGER_STRING, acMessage);
         }
         psFTFileData->iFiltered = 0; /* We matched an include filter. Clear the filtered flag to indicate this object should not be filtered. */
@@ -539,14 +682,15 @@ SupportApplyFiltersForHashes(FTIMES_PROPERTIES *psProperties, FTIMES_FILE_DATA *
   {
     char acHash[SHA1_HASH_SIZE*2+1];
     SHA1HashToHex(psFTFileData->aucFileSha1, acHash);
-    if (psProperties->psIncludeFilterSha1List)
+    if (psProperties->psIncludeFilterSha1List || psProperties->psIncludeFilterSha1Set)
     {
-      psFilter = SupportMatchFilter(psProperties->psIncludeFilterSha1List, acHash);
-      if (psFilter != NULL)
+      iMatch = SupportMatchDigestSet(psProperties->psIncludeFilterSha1Set, psFTFileData->aucFileSha1);
+      psFilter = (iMatch) ? NULL : SupportMatchFilter(psProperties->psIncludeFilterSha1List, acHash);
+      if (iMatch || psFilter != NULL)
       {
         if (psProperties->iLogLevel <= MESSAGE_DEBUGGER)
         {
-          snprintf(acMessage, MESSAGE_SIZE, "IncludeFilterSha1=[%s], RawPath=[%s]", psFilter->pcFilter, psFTFileData->pcRawPath);
+          snprintf(acMessage, MESSAGE_SIZE, "IncludeFilterSha1=[%s], RawPath=[%s]", (iMatch) ? acHash : psFilter->pcFilter, psFTFileData->pcRawPath);
           MessageHandler(MESSAGE_FLUSH_IT, MESSAGE_DEBUGGER, MESSAGE_DEBUGGER_STRING, acMessage);
         }
         psFTFileData->iFiltered = 0; /* We matched an include filter. Clear the filtered flag to indicate this object should not be filtered. */
@@ -562,14 +706,15 @@ SupportApplyFiltersForHashes(FTIMES_PROPERTIES *psProperties, FTIMES_FILE_DATA *
   {
     char acHash[SHA256_HASH_SIZE*2+1];
     SHA256HashToHex(psFTFileData->aucFileSha256, acHash);
-    if (psProperties->psIncludeFilterSha256List)
+    if (psProperties->psIncludeFilterSha256List || psProperties->psIncludeFilterSha256Set)
     {
-      psFilter = SupportMatchFilter(psProperties->psIncludeFilterSha256List, acHash);
-      if (psFilter != NULL)
+      iMatch = SupportMatchDigestSet(psProperties->psIncludeFilterSha256Set, psFTFileData->aucFileSha256);
+      psFilter = (iMatch) ? NULL : SupportMatchFilter(psProperties->psIncludeFilterSha256List, acHash);
+      if (iMatch || psFilter != NULL)
       {
         if (psProperties->iLogLevel <= MESSAGE_DEBUGGER)
         {
-          snprintf(acMessage, MESSAGE_SIZE, "IncludeFilterSha256=[%s], RawPath=[%s]", psFilter->pcFilter, psFTFileData->pcRawPath);
+          snprintf(acMessage, MESSAGE_SIZE, "IncludeFilterSha256=[%s], RawPath=[%s]", (iMatch) ? acHash : psFilter->pcFilter, psFTFileData->pcRawPath);
           MessageHandler(MESSAGE_FLUSH_IT, MESSAGE_DEBUGGER, MESSAGE_DEBUGGER_STRING, acMessage);
         }
         psFTFileData->iFiltered = 0; /* We matched an include filter. Clear the filtered flag to indicate this object should not be filtered. */
@@ -1163,6 +1308,33 @@ SupportFreeListItem(FILE_LIST *psItem)
 }
 
 
+/*-
+ ***********************************************************************
+ *
+ * SupportFreeTrie
+ *
+ ***********************************************************************
+ */
+void
+SupportFreeTrie(FILE_TRIE *psNode)
+{
+  int                 i = 0;
+
+  if (psNode != NULL)
+  {
+    for (i = 0; i < psNode->iChildCount; i++)
+    {
+      SupportFreeTrie(psNode->ppsChildren[i]);
+    }
+    if (psNode->ppsChildren != NULL)
+    {
+      free(psNode->ppsChildren);
+    }
+    free(psNode);
+  }
+}
+
+
 /*-
  ***********************************************************************
  *
@@ -1431,6 +1603,89 @@ SupportGetSystemOS(void)
 }
 
 
+/*-
+ ***********************************************************************
+ *
+ * SupportGetTrieChild
+ *
+ ***********************************************************************
+ */
+FILE_TRIE *
+SupportGetTrieChild(FILE_TRIE *psNode, char *pcName, int iLength, int *piIndex)
+{
+  int                 iCompare = 0;
+  int                 iLower = 0;
+  int                 iMiddle = 0;
+  int                 iUpper = psNode->iChildCount;
+  FILE_TRIE          *psChild = NULL;
+
+  /*-
+   *********************************************************************
+   *
+   * Do a binary search on the (sorted) children. If there's no match,
+   * piIndex is set to the position where the name would be inserted.
+   * Names are not NULL terminated, so compare them by length as well.
+   *
+   *********************************************************************
+   */
+  while (iLower < iUpper)
+  {
+    iMiddle = (iLower + iUpper) / 2;
+    psChild = psNode->ppsChildren[iMiddle];
+    iCompare = NCompareFunction(pcName, psChild->pcName, MIN(iLength, psChild->iLength));
+    if (iCompare == 0)
+    {
+      iCompare = iLength - psChild->iLength;
+    }
+    if (iCompare == 0)
+    {
+      *piIndex = iMiddle;
+      return psChild;
+    }
+    if (iCompare < 0)
+    {
+      iUpper = iMiddle;
+    }
+    else
+    {
+      iLower = iMiddle + 1;
+    }
+  }
+  *piIndex = iLower;
+
+  return NULL;
+}
+
+
+/*-
+ ***********************************************************************
+ *
+ * SupportGetTrieTail
+ *
+ ***********************************************************************
+ */
+char *
+SupportGetTrieTail(char *pcPath)
+{
+  int                 iLength = strlen(pcPath);
+
+  /*-
+   *********************************************************************
+   *
+   * Ignore trailing slashes. This makes the root directory (i.e., "/"
+   * or "c:\") the parent of everything below it.
+   *
+   *********************************************************************
+   */
+  while (iLength > 0 && pcPath[iLength - 1] == FTIMES_SLASHCHAR)
+  {
+    iLength--;
+  }
+
+  return &pcPath[iLength];
+}
+
+
 /*-
  ***********************************************************************
  *
@@ -1616,42 +1871,98 @@ SupportMatchExclude(FILE_LIST *psHead, char *pcPath)
  ***********************************************************************
  */
 FILE_LIST *
-SupportMatchSubTree(FILE_LIST *psHead, FILE_LIST *psTarget)
+SupportMatchSubTree(FILE_TRIE *psRoot, FILE_LIST *psTarget)
 {
-  int                 x;
-  int                 y;
-  FILE_LIST          *psList;
+  char               *pcEnd = NULL;
+  char               *pcName = NULL;
+  char               *pcTail = NULL;
+  int                 iIndex = 0;
+  FILE_TRIE          *psNode = psRoot;
 
-  x = psTarget->iLength;
-  for (psList = psHead; psList != NULL; psList = psList->psNext)
+  /*-
+   *********************************************************************
+   *
+   * Return the shallowest item (other than the target itself) whose
+   * path is the same as or a parent of the target's path.
+   *
+   *********************************************************************
+   */
+  pcTail = SupportGetTrieTail(psTarget->pcRegularPath);
+  for (pcName = psTarget->pcRegularPath; psNode != NULL; pcName = pcEnd + 1)
   {
-    y = psList->iLength;
-    if (NCompareFunction(psTarget->pcRegularPath, psList->pcRegularPath, MIN(x, y)) == 0)
+    pcEnd = memchr(pcName, FTIMES_SLASHCHAR, pcTail - pcName);
+    if (pcEnd == NULL)
     {
-      if (x <= y)
-      {
-        if ((psList->pcRegularPath[x - 1] == FTIMES_SLASHCHAR && psList->pcRegularPath[x] != FTIMES_SLASHCHAR) ||
-            (psList->pcRegularPath[x - 1] != FTIMES_SLASHCHAR && psList->pcRegularPath[x] == FTIMES_SLASHCHAR) ||
-            (psList->pcRegularPath[x - 1] == FTIMES_SLASHCHAR && psList->pcRegularPath[x] == FTIMES_SLASHCHAR))
-        {
-          return psList;
-        }
-      }
-      else
-      {
-        if ((psTarget->pcRegularPath[y - 1] == FTIMES_SLASHCHAR && psTarget->pcRegularPath[y] != FTIMES_SLASHCHAR) ||
-            (psTarget->pcRegularPath[y - 1] != FTIMES_SLASHCHAR && psTarget->pcRegularPath[y] == FTIMES_SLASHCHAR) ||
-            (psTarget->pcRegularPath[y - 1] == FTIMES_SLASHCHAR && psTarget->pcRegularPath[y] == FTIMES_SLASHCHAR))
-        {
-          return psTarget;
-        }
-      }
+      pcEnd = pcTail;
+    }
+    psNode = SupportGetTrieChild(psNode, pcName, pcEnd - pcName, &iIndex);
+    if (psNode != NULL && psNode->psItem != NULL && psNode->psItem != psTarget)
+    {
+      return psNode->psItem;
+    }
+    if (pcEnd == pcTail)
+    {
+      break;
     }
   }
+
   return NULL;
 }
 
 
+/*-
+ ***********************************************************************
+ *
+ * SupportMatchTrie
+ *
+ ***********************************************************************
+ */
+FILE_LIST *
+SupportMatchTrie(FILE_TRIE *psRoot, char *pcPath)
+{
+  char               *pcEnd = NULL;
+  char               *pcName = NULL;
+  char               *pcTail = NULL;
+  int                 iIndex = 0;
+  FILE_TRIE          *psNode = psRoot;
+
+  if (psRoot == NULL || psRoot->iChildCount == 0)
+  {
+    return NULL;
+  }
+
+  /*-
+   *********************************************************************
+   *
+   * Descend one path component at a time. The cost of a lookup is
+   * proportional to the depth of the path rather than the number of
+   * items in the list.
+   *
+   *********************************************************************
+   */
+  pcTail = SupportGetTrieTail(pcPath);
+  for (pcName = pcPath; ; pcName = pcEnd + 1)
+  {
+    pcEnd = memchr(pcName, FTIMES_SLASHCHAR, pcTail - pcName);
+    if (pcEnd == NULL)
+    {
+      pcEnd = pcTail;
+    }
+    psNode = SupportGetTrieChild(psNode, pcName, pcEnd - pcName, &iIndex);
+    if (psNode == NULL)
+    {
+      return NULL;
+    }
+    if (pcEnd == pcTail)
+    {
+      break;
+    }
+  }
+
+  return psNode->psItem;
+}
+
+
 /*-
  ***********************************************************************
  *
@@ -1664,8 +1975,6 @@ SupportNeuterString(char *pcData, int iLength, char *pcError)
 {
   const char          acRoutine[] = "SupportNeuterString()";
   char               *pcNeutered = NULL;
-  int                 i = 0;
-  int                 n = 0;
 
   /*-
    *********************************************************************
@@ -1680,123 +1989,233 @@ SupportNeuterString(char *pcData, int iLength, char *pcError)
     snprintf(pcError, MESSAGE_SIZE, "%s: %s", acRoutine, strerror(errno));
     return NULL;
   }
+  SupportNeuterStringToBuffer(pcData, iLength, pcNeutered);
+
+  return pcNeutered;
+}
+
+
+/*-
+ ***********************************************************************
+ *
+ * SupportNeuterStringToBuffer
+ *
+ ***********************************************************************
+ */
+int
+SupportNeuterStringToBuffer(char *pcData, int iLength, char *pcNeutered)
+{
+  unsigned char      *pucData = (unsigned char *) pcData;
+  int                 i = 0;
+  int                 j = 0;
+  int                 n = 0;
+
+  /*-
+   *********************************************************************
+   *
+   * The caller must supply a buffer that holds at least 3 * iLength
+   * + 1 bytes. The length of the neutered string is returned.
+   *
+   *********************************************************************
+   */
   pcNeutered[0] = 0;
 
   /*-
    *********************************************************************
    *
-   * Encode non-printables and [|"'`%+#]. Conditionally encode '/' and
-   * '\' depending on the target platform. Convert spaces to '+'. Avoid
-   * isprint() here because it has led to unexpected results on Windows
-   * platforms. In the past, isprint() on certain Windows systems has
-   * decided that several characters in the range 0x7f - 0xff are
-   * printable.
+   * Copy runs of safe bytes in one go, and encode the byte that ends
+   * each run (see gaucNeuterTable). Most names are entirely safe, so
+   * they take a single scan and a single copy. The scan checks four
+   * bytes per step, which lets the lookups overlap.
    *
    *********************************************************************
    */
-  for (i = n = 0; i < iLength; i++)
+  for (i = n = 0; i < iLength; i = j + 1)
   {
-    if (pcData[i] > '~' || pcData[i] < ' ')
-    {
-      n += sprintf(&pcNeutered[n], "%%%02x", (unsigned char) pcData[i]);
-    }
-    else
+    for (j = i; j + 4 <= iLength; j += 4)
     {
-      switch (pcData[i])
+      if ((gaucNeuterTable[pucData[j]] | gaucNeuterTable[pucData[j + 1]] | gaucNeuterTable[pucData[j + 2]] | gaucNeuterTable[pucData[j + 3]]) != 0)
       {
-      case '|':
-      case '"':
-      case '\'':
-      case '`':
-      case '%':
-      case '+':
-      case '#':
-#ifdef WINNT
-      case '/':
-#else
-      case '\\':
-#endif
-        n += sprintf(&pcNeutered[n], "%%%02x", (unsigned char) pcData[i]);
-        break;
-      case ' ':
-        pcNeutered[n++] = '+';
-        break;
-      default:
-        pcNeutered[n++] = pcData[i];
         break;
       }
     }
+    for (; j < iLength && gaucNeuterTable[pucData[j]] == 0; j++)
+    {
+      continue;
+    }
+    memcpy(&pcNeutered[n], &pcData[i], j - i);
+    n += j - i;
+    if (j == iLength)
+    {
+      break;
+    }
+    if (pucData[j] == ' ')
+    {
+      pcNeutered[n++] = '+';
+    }
+    else
+    {
+      pcNeutered[n++] = '%';
+      pcNeutered[n++] = gacNeuterHexDigits[pucData[j] >> 4];
+      pcNeutered[n++] = gacNeuterHexDigits[pucData[j] & 0x0f];
+    }
   }
   pcNeutered[n] = 0;
 
-  return pcNeutered;
+  return n;
 }
 
 
 /*-
  ***********************************************************************
  *
- * SupportPruneList
+ * SupportNewTrie
  *
  ***********************************************************************
  */
-FILE_LIST *
-SupportPruneList(FILE_LIST *psList, char *pcListName)
+FILE_TRIE *
+SupportNewTrie(FILE_LIST *psHead, char *pcError)
 {
+  const char          acRoutine[] = "SupportNewTrie()";
   char                acLocalError[MESSAGE_SIZE] = "";
-  FILE_LIST          *psListHead;
-  FILE_LIST          *psListTree;
-  FILE_LIST          *psListKill;
+  int                 iError = 0;
+  FILE_LIST          *psList = NULL;
+  FILE_TRIE          *psRoot = NULL;
 
   /*-
    *********************************************************************
    *
-   * If there's nothing to prune, just return.
+   * Compile the list into a path component trie. The root node has
+   * no name -- the first component of each path (i.e., "" for "/" or
+   * the drive letter on WIN32 systems) hangs below it.
    *
    *********************************************************************
    */
-  if (psList == NULL)
+  psRoot = SupportNewTrieNode("", 0, acLocalError);
+  if (psRoot == NULL)
   {
-    return psList;
+    snprintf(pcError, MESSAGE_SIZE, "%s: %s", acRoutine, acLocalError);
+    return NULL;
   }
 
-  /*-
-   *********************************************************************
-   *
-   * Eliminate any subtree components from the tree list. For example,
-   * /usr/local would be eliminated from /usr. We also eliminate any
-   * duplicate entries in the process. However, there should not be any
-   * duplicates because they should have been automatically pruned as
-   * the list was being created.
-   *
-   *********************************************************************
-   */
-  for (psListTree = psListHead = psList; psListTree->psNext != NULL;)
+  for (psList = psHead; psList != NULL; psList = psList->psNext)
   {
-    psListKill = SupportMatchSubTree(psListTree->psNext, psListTree);
-
-    /*-
-     *******************************************************************
-     *
-     * When a match is found, another search is performed to ensure
-     * that there are no more matches further down in the list. This is
-     * done implicitly by setting psListTree to psListHead after the
-     * drop.
-     *
-     *******************************************************************
-     */
-    if (psListKill != NULL)
+    iError = SupportAddToTrie(psRoot, psList, acLocalError);
+    if (iError != ER_OK)
     {
-      snprintf(acLocalError, MESSAGE_SIZE, "List = [%s], NeuteredItem = [%s]: Pruning item because it is part of a larger branch.", pcListName, psListKill->pcEncodedPath);
-      ErrorHandler(ER_Warning, acLocalError, ERROR_WARNING);
-      psListHead = SupportDropListItem(psListHead, psListKill);
-      psListTree = psListHead;
+      snprintf(pcError, MESSAGE_SIZE, "%s: NeuteredItem = [%s]: %s", acRoutine, psList->pcEncodedPath, acLocalError);
+      SupportFreeTrie(psRoot);
+      return NULL;
     }
-    else
+  }
+
+  return psRoot;
+}
+
+
+/*-
+ ***********************************************************************
+ *
+ * SupportNewTrieNode
+ *
+ ***********************************************************************
+ */
+FILE_TRIE *
+SupportNewTrieNode(char *pcName, int iLength, char *pcError)
+{
+  const char          acRoutine[] = "SupportNewTrieNode()";
+  FILE_TRIE          *psNode = NULL;
+
+  /*-
+   *********************************************************************
+   *
+   * Allocate the node and its name in one block.
+   *
+   *********************************************************************
+   */
+  psNode = (FILE_TRIE *) calloc(sizeof(FILE_TRIE) + iLength + 1, 1);
+  if (psNode == NULL)
+  {
+    snprintf(pcError, MESSAGE_SIZE, "%s: calloc(): %s", acRoutine, strerror(errno));
+    return NULL;
+  }
+  psNode->pcName = (char *) &psNode[1];
+  memcpy(psNode->pcName, pcName, iLength);
+  psNode->iLength = iLength;
+
+  return psNode;
+}
+
+
+/*-
+ ***********************************************************************
+ *
+ * SupportPruneList
+ *
+ ***********************************************************************
+ */
+FILE_LIST *
+SupportPruneList(FILE_LIST *psList, char *pcListName)
+{
+  char                acLocalError[MESSAGE_SIZE] = "";
+  char                acMessage[MESSAGE_SIZE];
+  FILE_LIST          *psListHead;
+  FILE_LIST          *psListNext;
+  FILE_LIST          *psListTree;
+  FILE_TRIE          *psTrie;
+
+  /*-
+   *********************************************************************
+   *
+   * If there's nothing to prune, just return.
+   *
+   *********************************************************************
+   */
+  if (psList == NULL)
+  {
+    return psList;
+  }
+
+  /*-
+   *********************************************************************
+   *
+   * Compile the list into a trie. If that fails, leave the list as is.
+   *
+   *********************************************************************
+   */
+  psTrie = SupportNewTrie(psList, acLocalError);
+  if (psTrie == NULL)
+  {
+    snprintf(acMessage, MESSAGE_SIZE, "List = [%s]: Unable to prune list: %s", pcListName, acLocalError);
+    ErrorHandler(ER_Warning, acMessage, ERROR_WARNING);
+    return psList;
+  }
+
+  /*-
+   *********************************************************************
+   *
+   * Eliminate any subtree components from the tree list. For example,
+   * /usr/local would be eliminated from /usr. We also eliminate any
+   * duplicate entries in the process. However, there should not be any
+   * duplicates because they should have been automatically pruned as
+   * the list was being created. Since SupportMatchSubTree() returns the
+   * shallowest covering item, it never returns an item that has been
+   * dropped.
+   *
+   *********************************************************************
+   */
+  for (psListTree = psListHead = psList; psListTree != NULL; psListTree = psListNext)
+  {
+    psListNext = psListTree->psNext;
+    if (SupportMatchSubTree(psTrie, psListTree) != NULL)
     {
-      psListTree = psListTree->psNext;
+      snprintf(acMessage, MESSAGE_SIZE, "List = [%s], NeuteredItem = [%s]: Pruning item because it is part of a larger branch.", pcListName, psListTree->pcEncodedPath);
+      ErrorHandler(ER_Warning, acMessage, ERROR_WARNING);
+      psListHead = SupportDropListItem(psListHead, psListTree);
     }
   }
+  SupportFreeTrie(psTrie);
+
   return psListHead;
 }
 
@@ -2057,14 +2476,14 @@ SupportStringToUInt64(char *pcData, APP_UI64 *pui64Value, char *pcError)
 /*-
  ***********************************************************************
  *
- * SupportWriteData
+ * SupportWriteBufferedData
  *
  ***********************************************************************
  */
 int
-SupportWriteData(FILE *pFile, char *pcData, int iLength, char *pcError)
+SupportWriteBufferedData(FILE *pFile, char *pcData, int iLength, char *pcError)
 {
-  const char          acRoutine[] = "SupportWriteData()";
+  const char          acRoutine[] = "SupportWriteBufferedData()";
   int                 iNWritten;
 
   iNWritten = fwrite(pcData, 1, iLength, pFile);
@@ -2088,6 +2507,31 @@ SupportWriteData(FILE *pFile, char *pcData, int iLength, char *pcError)
     }
     return ER;
   }
+
+  return ER_OK;
+}
+
+
+/*-
+ ***********************************************************************
+ *
+ * SupportWriteData
+ *
+ ***********************************************************************
+ */
+int
+SupportWriteData(FILE *pFile, char *pcData, int iLength, char *pcError)
+{
+  const char          acRoutine[] = "SupportWriteData()";
+  char                acLocalError[MESSAGE_SIZE] = "";
+  int                 iError;
+
+  iError = SupportWriteBufferedData(pFile, pcData, iLength, acLocalError);
+  if (iError != ER_OK)
+  {
+    snprintf(pcError, MESSAGE_SIZE, "%s: %s", acRoutine, acLocalError);
+    return iError;
+  }
   if (fflush(pFile) != 0)
   {
     snprintf(pcError, MESSAGE_SIZE, "%s: fflush(): %s", acRoutine, strerror(errno));
@@ -2099,6 +2543,104 @@ SupportWriteData(FILE *pFile, char *pcData, int iLength, char *pcError)
 
 
 #ifdef USE_PCRE
+/*-
+ ***********************************************************************
+ *
+ * SupportAddDigestFilter
+ *
+ ***********************************************************************
+ */
+int
+SupportAddDigestFilter(char *pcFilter, int iDigestSize, FILTER_LIST **ppsList, FILTER_DIGEST_SET **ppsSet, char *pcError)
+{
+  const char          acRoutine[] = "SupportAddDigestFilter()";
+  char               *pc = pcFilter;
+  int                 i = 0;
+  int                 iLength = strlen(pcFilter);
+  unsigned char      *puc = NULL;
+  FILTER_DIGEST_SET  *psSet = NULL;
+
+  /*-
+   *********************************************************************
+   *
+   * A filter that is nothing more than a lowercase hex digest of the
+   * proper length (optionally anchored with '^' and/or '$') can only
+   * ever match that exact digest. Such filters are stored in a sorted
+   * set of raw digests instead of being compiled. Everything else is
+   * handed off to SupportAddFilter().
+   *
+   *********************************************************************
+   */
+  if (iLength > 0 && pc[0] == '^')
+  {
+    pc++;
+    iLength--;
+  }
+  if (iLength > 0 && pc[iLength - 1] == '$')
+  {
+    iLength--;
+  }
+  for (i = 0; i < iLength; i++)
+  {
+    if (!((pc[i] >= '0' && pc[i] <= '9') || (pc[i] >= 'a' && pc[i] <= 'f')))
+    {
+      break;
+    }
+  }
+  if (iLength != iDigestSize * 2 || i != iLength)
+  {
+    return SupportAddFilter(pcFilter, ppsList, pcError);
+  }
+
+  /*-
+   *********************************************************************
+   *
+   * Allocate the set, if necessary, and make room for the new digest.
+   *
+   *********************************************************************
+   */
+  if (*ppsSet == NULL)
+  {
+    *ppsSet = (FILTER_DIGEST_SET *) calloc(sizeof(FILTER_DIGEST_SET), 1);
+    if (*ppsSet == NULL)
+    {
+      snprintf(pcError, MESSAGE_SIZE, "%s: calloc(): %s", acRoutine, strerror(errno));
+      return ER;
+    }
+    (*ppsSet)->iDigestSize = iDigestSize;
+  }
+  psSet = *ppsSet;
+  if (psSet->iCount >= psSet->iSize)
+  {
+    puc = (unsigned char *) realloc(psSet->pucDigests, (size_t) (psSet->iSize + FILTER_DIGEST_SET_REQUEST_COUNT + psSet->iSize / 2) * iDigestSize);
+    if (puc == NULL)
+    {
+      snprintf(pcError, MESSAGE_SIZE, "%s: realloc(): %s", acRoutine, strerror(errno));
+      return ER;
+    }
+    psSet->pucDigests = puc;
+    psSet->iSize += FILTER_DIGEST_SET_REQUEST_COUNT + psSet->iSize / 2;
+  }
+
+  /*-
+   *********************************************************************
+   *
+   * Convert the digest to binary and append it. The set is sorted (and
+   * indexed) once all controls have been read.
+   *
+   *********************************************************************
+   */
+  puc = &psSet->pucDigests[(size_t) psSet->iCount * iDigestSize];
+  for (i = 0; i < iDigestSize; i++)
+  {
+    puc[i] = (unsigned char) ((HttpHexToInt(pc[2 * i]) << 4) | HttpHexToInt(pc[2 * i + 1]));
+  }
+  psSet->iCount++;
+
+  return ER_OK;
+}
+
+
 /*-
  ***********************************************************************
  *
@@ -2246,99 +2788,560 @@ SupportAddFilter(char *pcFilter, FILTER_LIST **psHead, char *pcError)
 /*-
  ***********************************************************************
  *
- * SupportFreeFilter
- *
- ***********************************************************************
- */
-void
-SupportFreeFilter(FILTER_LIST *psFilter)
-{
-  if (psFilter != NULL)
-  {
-    if (psFilter->pcFilter != NULL)
-    {
-      free(psFilter->pcFilter);
-    }
-    if (psFilter->psPcre != NULL)
-    {
-      pcre_free(psFilter->psPcre);
-    }
-    if (psFilter->psPcreExtra != NULL)
-    {
-      pcre_free(psFilter->psPcreExtra);
-    }
-    free(psFilter);
-  }
-}
-
-
-/*-
- ***********************************************************************
- *
- * SupportMatchFilter
- *
- ***********************************************************************
- */
-FILTER_LIST *
-SupportMatchFilter(FILTER_LIST *psFilterList, char *pcPath)
-{
-  FILTER_LIST        *psFilter;
-#ifndef PCRE_OVECTOR_ARRAY_SIZE
-#define PCRE_OVECTOR_ARRAY_SIZE 30
-#endif
-  int                 aiPcreOVector[PCRE_OVECTOR_ARRAY_SIZE];
-  int                 iError = 0;
-
-  for (psFilter = psFilterList; psFilter != NULL; psFilter = psFilter->psNext)
-  {
-    /*-
-     *******************************************************************
-     *
-     * PCRE_NOTEMPTY is used here to squash any attempts to match
-     * empty strings. Even though a value of zero would mean that that
-     * there was an overflow in ovector, accept those matches as
-     * valid. This should be OK since the elements in ovector are
-     * ignored anyway. Note that any value less than zero is currently
-     * being treated as if it were not a match. If that turns out to
-     * be an issue, this routine will need to be modified such that it
-     * can throw an error, and the upstream code will need to be
-     * adjusted accordingly.
-     *
-     *******************************************************************
-     */
-    iError = pcre_exec(psFilter->psPcre, psFilter->psPcreExtra, pcPath, strlen(pcPath), 0, PCRE_NOTEMPTY, aiPcreOVector, PCRE_OVECTOR_ARRAY_SIZE);
-    if (iError >= 0)
-    {
-      return psFilter;
-    }
-  }
-
-  return NULL;
-}
-
-
-/*-
- ***********************************************************************
- *
- * SupportNewFilter
+ * SupportCombineFilters
  *
  ***********************************************************************
  */
-FILTER_LIST *
-SupportNewFilter(char *pcFilter, char *pcError)
+FILTER_UNION *
+SupportCombineFilters(FILTER_LIST **ppsFilters, int iCount, char *pcError)
 {
-  const char          acRoutine[] = "SupportNewFilter()";
+  const char          acRoutine[] = "SupportCombineFilters()";
   const char         *pcPcreError = NULL;
-  FILTER_LIST        *psFilter = NULL;
-  int                 iError = 0;
+  char               *pcExpression = NULL;
+  FILTER_UNION       *psUnion = NULL;
+  int                 i = 0;
   int                 iCaptureCount = 0;
+  int                 iError = 0;
+  int                 iGroup = 1;
   int                 iLength = 0;
+  int                 iOffset = 0;
   int                 iPcreErrorOffset = 0;
 
   /*-
    *********************************************************************
    *
-   * Check that the input filter is not NULL and that it has length.
+   * Allocate memory for a new union. The caller should free this
+   * memory with SupportFreeFilterUnion(). Note that the union merely
+   * references its filters -- it does not own them.
+   *
+   *********************************************************************
+   */
+  psUnion = calloc(sizeof(FILTER_UNION), 1);
+  if (psUnion == NULL)
+  {
+    snprintf(pcError, MESSAGE_SIZE, "%s: calloc(): %s", acRoutine, strerror(errno));
+    return NULL;
+  }
+
+  psUnion->ppsFilters = calloc(iCount, sizeof(FILTER_LIST *));
+  psUnion->piGroups = calloc(iCount, sizeof(int));
+  if (psUnion->ppsFilters == NULL || psUnion->piGroups == NULL)
+  {
+    snprintf(pcError, MESSAGE_SIZE, "%s: calloc(): %s", acRoutine, strerror(errno));
+    SupportFreeFilterUnion(psUnion);
+    return NULL;
+  }
+  memcpy(psUnion->ppsFilters, ppsFilters, iCount * sizeof(FILTER_LIST *));
+  psUnion->iCount = iCount;
+
+  /*-
+   *********************************************************************
+   *
+   * A union of one is matched using the filter's own expression.
+   *
+   *********************************************************************
+   */
+  if (iCount == 1)
+  {
+    return psUnion;
+  }
+
+  /*-
+   *********************************************************************
+   *
+   * Join the filters into a single alternation (i.e., "(f1)|(f2)|..."),
+   * and record the capturing subpattern that wraps each filter. That
+   * subpattern's number is one more than the number of subpatterns
+   * that precede it, and it is what identifies the matching filter.
+   *
+   *********************************************************************
+   */
+  for (i = 0; i < iCount; i++)
+  {
+    iLength += strlen(ppsFilters[i]->pcFilter) + 3;
+  }
+
+  pcExpression = malloc(iLength + 1);
+  if (pcExpression == NULL)
+  {
+    snprintf(pcError, MESSAGE_SIZE, "%s: malloc(): %s", acRoutine, strerror(errno));
+    SupportFreeFilterUnion(psUnion);
+    return NULL;
+  }
+
+  for (i = 0; i < iCount; i++)
+  {
+    iError = pcre_fullinfo(ppsFilters[i]->psPcre, ppsFilters[i]->psPcreExtra, PCRE_INFO_CAPTURECOUNT, (void *) &iCaptureCount);
+    if (iError != ER_OK)
+    {
+      snprintf(pcError, MESSAGE_SIZE, "%s: pcre_fullinfo(): Unexpected return value [%d]. That shouldn't happen.", acRoutine, iError);
+      free(pcExpression);
+      SupportFreeFilterUnion(psUnion);
+      return NULL;
+    }
+    psUnion->piGroups[i] = iGroup;
+    iGroup += iCaptureCount + 1;
+    iOffset += sprintf(&pcExpression[iOffset], "%s(%s)", (i > 0) ? "|" : "", ppsFilters[i]->pcFilter);
+  }
+
+  /*-
+   *********************************************************************
+   *
+   * Compile and study the combined expression, and size its ovector
+   * to hold every capturing subpattern.
+   *
+   *********************************************************************
+   */
+  psUnion->psPcre = pcre_compile(pcExpression, 0, &pcPcreError, &iPcreErrorOffset, NULL);
+  free(pcExpression);
+  if (psUnion->psPcre == NULL)
+  {
+    snprintf(pcError, MESSAGE_SIZE, "%s: pcre_compile(): %s", acRoutine, pcPcreError);
+    SupportFreeFilterUnion(psUnion);
+    return NULL;
+  }
+  psUnion->psPcreExtra = pcre_study(psUnion->psPcre, 0, &pcPcreError);
+  if (pcPcreError != NULL)
+  {
+    snprintf(pcError, MESSAGE_SIZE, "%s: pcre_study(): %s", acRoutine, pcPcreError);
+    SupportFreeFilterUnion(psUnion);
+    return NULL;
+  }
+  iError = pcre_fullinfo(psUnion->psPcre, psUnion->psPcreExtra, PCRE_INFO_CAPTURECOUNT, (void *) &iCaptureCount);
+  if (iError != ER_OK || iCaptureCount != iGroup - 1)
+  {
+    snprintf(pcError, MESSAGE_SIZE, "%s: pcre_fullinfo(): Unexpected capture count [%d != %d]. That shouldn't happen.", acRoutine, iCaptureCount, iGroup - 1);
+    SupportFreeFilterUnion(psUnion);
+    return NULL;
+  }
+  psUnion->iOVectorSize = (iCaptureCount + 1) * 3;
+  psUnion->piOVector = calloc(psUnion->iOVectorSize, sizeof(int));
+  if (psUnion->piOVector == NULL)
+  {
+    snprintf(pcError, MESSAGE_SIZE, "%s: calloc(): %s", acRoutine, strerror(errno));
+    SupportFreeFilterUnion(psUnion);
+    return NULL;
+  }
+
+  return psUnion;
+}
+
+
+/*-
+ ***********************************************************************
+ *
+ * SupportCompareDigests
+ *
+ ***********************************************************************
+ */
+int
+SupportCompareDigests(const void *pvDigest1, const void *pvDigest2)
+{
+  return memcmp(pvDigest1, pvDigest2, giDigestSize);
+}
+
+
+/*-
+ ***********************************************************************
+ *
+ * SupportFreeFilter
+ *
+ ***********************************************************************
+ */
+void
+SupportFreeFilter(FILTER_LIST *psFilter)
+{
+  if (psFilter != NULL)
+  {
+    if (psFilter->pcFilter != NULL)
+    {
+      free(psFilter->pcFilter);
+    }
+    if (psFilter->psPcre != NULL)
+    {
+      pcre_free(psFilter->psPcre);
+    }
+    if (psFilter->psPcreExtra != NULL)
+    {
+      pcre_free(psFilter->psPcreExtra);
+    }
+    free(psFilter);
+  }
+}
+
+
+/*-
+ ***********************************************************************
+ *
+ * SupportFreeFilterUnion
+ *
+ ***********************************************************************
+ */
+void
+SupportFreeFilterUnion(FILTER_UNION *psUnion)
+{
+  FILTER_UNION       *psNext = NULL;
+
+  while (psUnion != NULL)
+  {
+    psNext = psUnion->psNext;
+    if (psUnion->ppsFilters != NULL)
+    {
+      free(psUnion->ppsFilters);
+    }
+    if (psUnion->piGroups != NULL)
+    {
+      free(psUnion->piGroups);
+    }
+    if (psUnion->piOVector != NULL)
+    {
+      free(psUnion->piOVector);
+    }
+    if (psUnion->psPcre != NULL)
+    {
+      pcre_free(psUnion->psPcre);
+    }
+    if (psUnion->psPcreExtra != NULL)
+    {
+      pcre_free(psUnion->psPcreExtra);
+    }
+    free(psUnion);
+    psUnion = psNext;
+  }
+}
+
+
+/*-
+ ***********************************************************************
+ *
+ * SupportIsCombinableFilter
+ *
+ ***********************************************************************
+ */
+int
+SupportIsCombinableFilter(char *pcFilter)
+{
+  char               *pc = NULL;
+
+  /*-
+   *********************************************************************
+   *
+   * A filter can be wrapped in a capturing subpattern and joined with
+   * others only if it doesn't depend on its own subpattern numbering
+   * or names (back references, recursion, conditionals, etc.), and it
+   * doesn't contain constructs that could swallow the closing ')' or
+   * that must appear at the start of a pattern (\Q, comments, and
+   * verbs). This check is conservative -- filters that fail it are
+   * simply matched on their own.
+   *
+   *********************************************************************
+   */
+  for (pc = pcFilter; *pc != 0; pc++)
+  {
+    switch (*pc)
+    {
+    case '\\':
+      if (pc[1] == 0 || isdigit((int) pc[1]) || pc[1] == 'g' || pc[1] == 'k' || pc[1] == 'Q')
+      {
+        return 0;
+      }
+      pc++;
+      break;
+    case '#':
+      return 0;
+    case '(':
+      if (pc[1] == '*')
+      {
+        return 0;
+      }
+      if (pc[1] == '?')
+      {
+        switch (pc[2])
+        {
+        case '&':
+        case '\'':
+        case '(':
+        case '+':
+        case 'C':
+        case 'P':
+        case 'R':
+        case '|':
+          return 0;
+        case '-':
+          if (isdigit((int) pc[3]))
+          {
+            return 0;
+          }
+          break;
+        case '<':
+          if (pc[3] != '=' && pc[3] != '!')
+          {
+            return 0;
+          }
+          break;
+        default:
+          if (isdigit((int) pc[2]))
+          {
+            return 0;
+          }
+          break;
+        }
+      }
+      break;
+    default:
+      break;
+    }
+  }
+
+  return 1;
+}
+
+
+/*-
+ ***********************************************************************
+ *
+ * SupportMatchDigestSet
+ *
+ ***********************************************************************
+ */
+int
+SupportMatchDigestSet(FILTER_DIGEST_SET *psSet, unsigned char *pucDigest)
+{
+  int                 iBucket = 0;
+  int                 iCompare = 0;
+  int                 iLower = 0;
+  int                 iMiddle = 0;
+  int                 iUpper = 0;
+
+  if (psSet == NULL || psSet->piBuckets == NULL)
+  {
+    return 0;
+  }
+
+  /*-
+   *********************************************************************
+   *
+   * Use the first two bytes of the digest to locate its bucket. Then,
+   * do a binary search on that bucket. Since digests are uniformly
+   * distributed, buckets stay small (e.g., ~150 entries for 10M
+   * digests), and the cost of a lookup is essentially independent of
+   * the size of the set.
+   *
+   *********************************************************************
+   */
+  iBucket = (pucDigest[0] << 8) | pucDigest[1];
+  iLower = psSet->piBuckets[iBucket];
+  iUpper = psSet->piBuckets[iBucket + 1];
+  while (iLower < iUpper)
+  {
+    iMiddle = iLower + (iUpper - iLower) / 2;
+    iCompare = memcmp(pucDigest, &psSet->pucDigests[(size_t) iMiddle * psSet->iDigestSize], psSet->iDigestSize);
+    if (iCompare == 0)
+    {
+      return 1;
+    }
+    if (iCompare < 0)
+    {
+      iUpper = iMiddle;
+    }
+    else
+    {
+      iLower = iMiddle + 1;
+    }
+  }
+
+  return 0;
+}
+
+
+/*-
+ ***********************************************************************
+ *
+ * SupportMatchDigestSets
+ *
+ ***********************************************************************
+ */
+char *
+SupportMatchDigestSets(FTIMES_PROPERTIES *psProperties, FTIMES_FILE_DATA *psFTFileData, int iInclude, char *pcHexDigest)
+{
+  unsigned long       ulMask = psProperties->psFieldMask->ulMask;
+
+  /*-
+   *********************************************************************
+   *
+   * Check the include or exclude digest sets in MD5, SHA1, SHA256
+   * order. Return the name of the control that matched, and convert
+   * the matching digest to hex (for logging purposes).
+   *
+   *********************************************************************
+   */
+  if (MASK_BIT_IS_SET(ulMask, MAP_MD5) && SupportMatchDigestSet((iInclude) ? psProperties->psIncludeFilterMd5Set : psProperties->psExcludeFilterMd5Set, psFTFileData->aucFileMd5))
+  {
+    MD5HashToHex(psFTFileData->aucFileMd5, pcHexDigest);
+    return (iInclude) ? KEY_IncludeFilterMd5 : KEY_ExcludeFilterMd5;
+  }
+  if (MASK_BIT_IS_SET(ulMask, MAP_SHA1) && SupportMatchDigestSet((iInclude) ? psProperties->psIncludeFilterSha1Set : psProperties->psExcludeFilterSha1Set, psFTFileData->aucFileSha1))
+  {
+    SHA1HashToHex(psFTFileData->aucFileSha1, pcHexDigest);
+    return (iInclude) ? KEY_IncludeFilterSha1 : KEY_ExcludeFilterSha1;
+  }
+  if (MASK_BIT_IS_SET(ulMask, MAP_SHA256) && SupportMatchDigestSet((iInclude) ? psProperties->psIncludeFilterSha256Set : psProperties->psExcludeFilterSha256Set, psFTFileData->aucFileSha256))
+  {
+    SHA256HashToHex(psFTFileData->aucFileSha256, pcHexDigest);
+    return (iInclude) ? KEY_IncludeFilterSha256 : KEY_ExcludeFilterSha256;
+  }
+
+  return NULL;
+}
+
+
+/*-
+ ***********************************************************************
+ *
+ * SupportMatchFilter
+ *
+ ***********************************************************************
+ */
+FILTER_LIST *
+SupportMatchFilter(FILTER_LIST *psFilterList, char *pcPath)
+{
+  FILTER_LIST        *psFilter;
+#ifndef PCRE_OVECTOR_ARRAY_SIZE
+#define PCRE_OVECTOR_ARRAY_SIZE 30
+#endif
+  int                 aiPcreOVector[PCRE_OVECTOR_ARRAY_SIZE];
+  int                 iError = 0;
+
+  for (psFilter = psFilterList; psFilter != NULL; psFilter = psFilter->psNext)
+  {
+    /*-
+     *******************************************************************
+     *
+     * PCRE_NOTEMPTY is used here to squash any attempts to match
+     * empty strings. Even though a value of zero would mean that that
+     * there was an overflow in ovector, accept those matches as
+     * valid. This should be OK since the elements in ovector are
+     * ignored anyway. Note that any value less than zero is currently
+     * being treated as if it were not a match. If that turns out to
+     * be an issue, this routine will need to be modified such that it
+     * can throw an error, and the upstream code will need to be
+     * adjusted accordingly.
+     *
+     *******************************************************************
+     */
+    iError = pcre_exec(psFilter->psPcre, psFilter->psPcreExtra, pcPath, strlen(pcPath), 0, PCRE_NOTEMPTY, aiPcreOVector, PCRE_OVECTOR_ARRAY_SIZE);
+    if (iError >= 0)
+    {
+      return psFilter;
+    }
+  }
+
+  return NULL;
+}
+
+
+/*-
+ ***********************************************************************
+ *
+ * SupportMatchFilterUnion
+ *
+ ***********************************************************************
+ */
+FILTER_LIST *
+SupportMatchFilterUnion(FILTER_UNION *psUnion, char *pcPath)
+{
+  FILTER_LIST        *psFilter = NULL;
+#ifndef PCRE_OVECTOR_ARRAY_SIZE
+#define PCRE_OVECTOR_ARRAY_SIZE 30
+#endif
+  int                 aiPcreOVector[PCRE_OVECTOR_ARRAY_SIZE];
+  int                 i = 0;
+  int                 iError = 0;
+  int                 iGroup = 0;
+  int                 iLength = strlen(pcPath);
+
+  for (; psUnion != NULL; psUnion = psUnion->psNext)
+  {
+    /*-
+     *******************************************************************
+     *
+     * Unions of one are matched using the filter's own expression.
+     * See SupportMatchFilter() for an explanation of the options and
+     * return values.
+     *
+     *******************************************************************
+     */
+    if (psUnion->psPcre == NULL)
+    {
+      psFilter = psUnion->ppsFilters[0];
+      iError = pcre_exec(psFilter->psPcre, psFilter->psPcreExtra, pcPath, iLength, 0, PCRE_NOTEMPTY, aiPcreOVector, PCRE_OVECTOR_ARRAY_SIZE);
+      if (iError >= 0)
+      {
+        return psFilter;
+      }
+      continue;
+    }
+
+    /*-
+     *******************************************************************
+     *
+     * Otherwise, a single pass over the path decides whether any of
+     * the union's filters match, and the first wrapping subpattern
+     * that was set identifies the one that did. If the ovector can't
+     * tell, fall back to trying each filter in turn.
+     *
+     *******************************************************************
+     */
+    iError = pcre_exec(psUnion->psPcre, psUnion->psPcreExtra, pcPath, iLength, 0, PCRE_NOTEMPTY, psUnion->piOVector, psUnion->iOVectorSize);
+    if (iError < 0)
+    {
+      continue;
+    }
+    for (i = 0; i < psUnion->iCount; i++)
+    {
+      iGroup = psUnion->piGroups[i];
+      if (iGroup < iError && psUnion->piOVector[iGroup * 2] >= 0)
+      {
+        return psUnion->ppsFilters[i];
+      }
+    }
+    for (i = 0; i < psUnion->iCount; i++)
+    {
+      psFilter = psUnion->ppsFilters[i];
+      iError = pcre_exec(psFilter->psPcre, psFilter->psPcreExtra, pcPath, iLength, 0, PCRE_NOTEMPTY, aiPcreOVector, PCRE_OVECTOR_ARRAY_SIZE);
+      if (iError >= 0)
+      {
+        return psFilter;
+      }
+    }
+  }
+
+  return NULL;
+}
+
+
+/*-
+ ***********************************************************************
+ *
+ * SupportNewFilter
+ *
+ ***********************************************************************
+ */
+FILTER_LIST *
+SupportNewFilter(char *pcFilter, char *pcError)
+{
+  const char          acRoutine[] = "SupportNewFilter()";
+  const char         *pcPcreError = NULL;
+  FILTER_LIST        *psFilter = NULL;
+  int                 iError = 0;
+  int                 iCaptureCount = 0;
+  int                 iLength = 0;
+  int                 iPcreErrorOffset = 0;
+
+  /*-
+   *********************************************************************
+   *
+   * Check that the input filter is not NULL and that it has length.
    *
    *********************************************************************
    */
@@ -2421,6 +3424,233 @@ SupportNewFilter(char *pcFilter, char *pcError)
 
   return psFilter;
 }
+
+
+/*-
+ ***********************************************************************
+ *
+ * SupportNewFilterUnion
+ *
+ ***********************************************************************
+ */
+FILTER_UNION *
+SupportNewFilterUnion(FILTER_LIST *psFilterList, char *pcError)
+{
+  const char          acRoutine[] = "SupportNewFilterUnion()";
+  char                acLocalError[MESSAGE_SIZE] = "";
+  FILTER_LIST        *apsFilters[FILTER_UNION_MAX_COUNT];
+  FILTER_LIST        *psFilter = NULL;
+  FILTER_UNION       *psHead = NULL;
+  FILTER_UNION       *psTail = NULL;
+  FILTER_UNION       *psUnion = NULL;
+  int                 i = 0;
+  int                 iCount = 0;
+  int                 iSplit = 0;
+
+  /*-
+   *********************************************************************
+   *
+   * Walk the filter list, and combine each run of combinable filters
+   * into a single expression. Filters that can't be combined stand on
+   * their own. The resulting chain preserves the order of the list.
+   * If a combined expression fails to compile (e.g., it's too large),
+   * its filters are split back out into unions of one.
+   *
+   *********************************************************************
+   */
+  psFilter = psFilterList;
+  while (psFilter != NULL)
+  {
+    iCount = 0;
+    if (!SupportIsCombinableFilter(psFilter->pcFilter))
+    {
+      apsFilters[iCount++] = psFilter;
+      psFilter = psFilter->psNext;
+    }
+    else
+    {
+      while (psFilter != NULL && iCount < FILTER_UNION_MAX_COUNT && SupportIsCombinableFilter(psFilter->pcFilter))
+      {
+        apsFilters[iCount++] = psFilter;
+        psFilter = psFilter->psNext;
+      }
+    }
+    psUnion = SupportCombineFilters(apsFilters, iCount, acLocalError);
+    iSplit = (psUnion == NULL && iCount > 1) ? 1 : 0;
+    for (i = 0; i < ((iSplit) ? iCount : 1); i++)
+    {
+      if (iSplit)
+      {
+        psUnion = SupportCombineFilters(&apsFilters[i], 1, acLocalError);
+      }
+      if (psUnion == NULL)
+      {
+        snprintf(pcError, MESSAGE_SIZE, "%s: %s", acRoutine, acLocalError);
+        SupportFreeFilterUnion(psHead);
+        return NULL;
+      }
+      if (psHead == NULL)
+      {
+        psHead = psUnion;
+      }
+      else
+      {
+        psTail->psNext = psUnion;
+      }
+      psTail = psUnion;
+    }
+  }
+
+  return psHead;
+}
+
+
+/*-
+ ***********************************************************************
+ *
+ * SupportSortDigestSet
+ *
+ ***********************************************************************
+ */
+int
+SupportSortDigestSet(FILTER_DIGEST_SET *psSet, char *pcError)
+{
+  const char          acRoutine[] = "SupportSortDigestSet()";
+  int                 i = 0;
+  int                 iBucket = 0;
+  int                 iCount = 0;
+  int                 iStart = 0;
+  int                 iStop = 0;
+  int                *piBuckets = NULL;
+  int                *piNext = NULL;
+  size_t              tSize = psSet->iDigestSize;
+  unsigned char      *pucDigests = NULL;
+
+  /*-
+   *********************************************************************
+   *
+   * Distribute the digests into buckets based on their first two
+   * bytes (i.e., a single pass of a radix sort).
+   *
+   *********************************************************************
+   */
+  piBuckets = (int *) calloc(FILTER_DIGEST_SET_BUCKET_COUNT + 1, sizeof(int));
+  piNext = (int *) calloc(FILTER_DIGEST_SET_BUCKET_COUNT, sizeof(int));
+  pucDigests = (unsigned char *) malloc(((psSet->iCount > 0) ? psSet->iCount : 1) * tSize);
+  if (piBuckets == NULL || piNext == NULL || pucDigests == NULL)
+  {
+    snprintf(pcError, MESSAGE_SIZE, "%s: calloc()/malloc(): %s", acRoutine, strerror(errno));
+    if (piBuckets != NULL)
+    {
+      free(piBuckets);
+    }
+    if (piNext != NULL)
+    {
+      free(piNext);
+    }
+    if (pucDigests != NULL)
+    {
+      free(pucDigests);
+    }
+    return ER;
+  }
+  for (i = 0; i < psSet->iCount; i++)
+  {
+    iBucket = (psSet->pucDigests[i * tSize] << 8) | psSet->pucDigests[i * tSize + 1];
+    piBuckets[iBucket + 1]++;
+  }
+  for (iBucket = 0; iBucket < FILTER_DIGEST_SET_BUCKET_COUNT; iBucket++)
+  {
+    piBuckets[iBucket + 1] += piBuckets[iBucket];
+    piNext[iBucket] = piBuckets[iBucket];
+  }
+  for (i = 0; i < psSet->iCount; i++)
+  {
+    iBucket = (psSet->pucDigests[i * tSize] << 8) | psSet->pucDigests[i * tSize + 1];
+    memcpy(&pucDigests[piNext[iBucket]++ * tSize], &psSet->pucDigests[i * tSize], tSize);
+  }
+  free(piNext);
+  free(psSet->pucDigests);
+  psSet->pucDigests = pucDigests;
+
+  /*-
+   *********************************************************************
+   *
+   * Sort each bucket, and squeeze out any duplicates. Bucket offsets
+   * are adjusted as the digests are shifted down.
+   *
+   *********************************************************************
+   */
+  giDigestSize = psSet->iDigestSize;
+  for (iBucket = iCount = 0; iBucket < FILTER_DIGEST_SET_BUCKET_COUNT; iBucket++)
+  {
+    iStart = piBuckets[iBucket];
+    iStop = piBuckets[iBucket + 1];
+    piBuckets[iBucket] = iCount;
+    if (iStop - iStart > 1)
+    {
+      qsort(&pucDigests[iStart * tSize], iStop - iStart, tSize, SupportCompareDigests);
+    }
+    for (i = iStart; i < iStop; i++)
+    {
+      if (iCount > piBuckets[iBucket] && memcmp(&pucDigests[(iCount - 1) * tSize], &pucDigests[i * tSize], tSize) == 0)
+      {
+        continue;
+      }
+      if (iCount != i)
+      {
+        memcpy(&pucDigests[iCount * tSize], &pucDigests[i * tSize], tSize);
+      }
+      iCount++;
+    }
+  }
+  piBuckets[FILTER_DIGEST_SET_BUCKET_COUNT] = iCount;
+  psSet->iCount = psSet->iSize = iCount;
+  psSet->piBuckets = piBuckets;
+
+  return ER_OK;
+}
+
+
+/*-
+ ***********************************************************************
+ *
+ * SupportSortDigestSets
+ *
+ ***********************************************************************
+ */
+int
+SupportSortDigestSets(FTIMES_PROPERTIES *psProperties, char *pcError)
+{
+  const char          acRoutine[] = "SupportSortDigestSets()";
+  char                acLocalError[MESSAGE_SIZE] = "";
+  int                 i = 0;
+  int                 iError = 0;
+  FILTER_DIGEST_SET  *apsSets[] =
+  {
+    psProperties->psExcludeFilterMd5Set,
+    psProperties->psIncludeFilterMd5Set,
+    psProperties->psExcludeFilterSha1Set,
+    psProperties->psIncludeFilterSha1Set,
+    psProperties->psExcludeFilterSha256Set,
+    psProperties->psIncludeFilterSha256Set,
+  };
+
+  for (i = 0; i < (int) (sizeof(apsSets) / sizeof(apsSets[0])); i++)
+  {
+    if (apsSets[i] != NULL && apsSets[i]->piBuckets == NULL)
+    {
+      iError = SupportSortDigestSet(apsSets[i], acLocalError);
+      if (iError != ER_OK)
+      {
+        snprintf(pcError, MESSAGE_SIZE, "%s: %s", acRoutine, acLocalError);
+        return ER;
+      }
+    }
+  }
+
+  return ER_OK;
+}
 #endif
 
 
@@ -94,7 +94,17 @@
 #include <sys/param.h>
 #include <sys/mount.h>
 #endif
+#if defined(USE_DECODE_THREADS) || defined(USE_URL_STREAM) || defined(USE_ZLIB)
+#include <pthread.h>
+#endif
+#if defined(USE_URL_STREAM) || defined(USE_ZLIB)
+#include <signal.h>
+#endif
+#ifdef USE_SENDFILE
+#include <sys/sendfile.h>
+#endif
 #ifdef USE_FILE_HOOKS
+#include <signal.h>
 #include <sys/wait.h>
 #endif
 #endif
@@ -142,19 +142,28 @@ int
 TimeFormatTime(time_t *pTimeValue, char *pcTime)
 {
   int                 iCount;
+#ifdef USE_DECODE_THREADS
+  struct tm           sTm;
+#endif
 
   /*-
    *********************************************************************
    *
    * Constraint all time stamps are relative to GMT. In practice, this
-   * means we use gmtime instead of localtime.
+   * means we use gmtime instead of localtime. Decode workers call this
+   * routine concurrently, so use the reentrant version when they are
+   * enabled.
    *
    *********************************************************************
    */
 
   pcTime[0] = 0;
 
+#ifdef USE_DECODE_THREADS
+  iCount = strftime(pcTime, FTIMES_TIME_SIZE, FTIMES_TIME_FORMAT, gmtime_r(pTimeValue, &sTm));
+#else
   iCount = strftime(pcTime, FTIMES_TIME_SIZE, FTIMES_TIME_FORMAT, gmtime(pTimeValue));
+#endif
 
   if (iCount != FTIMES_TIME_FORMAT_SIZE - 1)
   {
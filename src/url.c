@@ -9,8 +9,279 @@
  *
  ***********************************************************************
  */
+#ifdef __linux__
+#define _GNU_SOURCE /* NOTE: This is required for fopencookie(). */
+#endif
 #include "all-includes.h"
 
+#ifdef USE_URL_STREAM
+/*-
+ ***********************************************************************
+ *
+ * URLCloseStream
+ *
+ ***********************************************************************
+ */
+int
+URLCloseStream(void *pvStream)
+{
+  URL_PUT_STREAM     *psStream = (URL_PUT_STREAM *)pvStream;
+  int                 iError = 0;
+
+  /*-
+   *********************************************************************
+   *
+   * Only the process that opened the stream may finish it. Children
+   * inherit the stream, but they must not send its pending data.
+   *
+   *********************************************************************
+   */
+  if (getpid() != psStream->tOwner)
+  {
+    return 0;
+  }
+
+  /*-
+   *********************************************************************
+   *
+   * Queue whatever is pending, and wait for the sender to drain the
+   * queue. The connection is left open so that URLFinishStream() can
+   * send the log file and complete the request.
+   *
+   *********************************************************************
+   */
+  URLFlushStream(psStream);
+
+  pthread_mutex_lock(&psStream->sMutex);
+  psStream->iFinish = 1;
+  pthread_cond_signal(&psStream->sCondition);
+  pthread_mutex_unlock(&psStream->sMutex);
+  pthread_join(psStream->tThread, NULL);
+  pthread_cond_destroy(&psStream->sCondition);
+  pthread_mutex_destroy(&psStream->sMutex);
+
+  /*-
+   *********************************************************************
+   *
+   * Close the local copy, if any.
+   *
+   *********************************************************************
+   */
+  if (psStream->pSinkFile != NULL)
+  {
+    iError = fclose(psStream->pSinkFile);
+    psStream->pSinkFile = NULL;
+    return (iError == 0) ? 0 : EOF;
+  }
+
+  return (psStream->iError) ? EOF : 0;
+}
+
+
+/*-
+ ***********************************************************************
+ *
+ * URLFinishStream
+ *
+ ***********************************************************************
+ */
+int
+URLFinishStream(FTIMES_PROPERTIES *psProperties, char *pcError)
+{
+  const char          acRoutine[] = "URLFinishStream()";
+  char                acLocalError[MESSAGE_SIZE] = "";
+  char                acData[HTTP_IO_BUFSIZE];
+  char                acTrailer[URL_STREAM_TRAILER_SIZE + 1];
+  FILE               *pFile;
+  int                 iError;
+  int                 iLength;
+  int                 iNRead;
+  APP_UI64            ui64LogLength;
+  HTTP_RESPONSE_HDR   sResponseHeader;
+  URL_PUT_STREAM     *psStream;
+
+  psStream = psProperties->psPutStream;
+  if (psStream == NULL)
+  {
+    snprintf(pcError, MESSAGE_SIZE, "%s: Undefined stream.", acRoutine);
+    return ER;
+  }
+  psProperties->psPutStream = NULL;
+
+  /*-
+   *********************************************************************
+   *
+   * If the stream broke during the run, there's nothing left to do.
+   *
+   *********************************************************************
+   */
+  if (psStream->iError)
+  {
+    snprintf(pcError, MESSAGE_SIZE, "%s: %s", acRoutine, psStream->acError);
+    SocketCleanup(psStream->psSocketCTX);
+    URLFreeStream(psStream);
+    return ER;
+  }
+
+  /*-
+   *********************************************************************
+   *
+   * Send the log file. It follows the out data in the request body.
+   *
+   *********************************************************************
+   */
+  pFile = fopen(psProperties->acLogFileName, "rb");
+  if (pFile == NULL)
+  {
+    snprintf(pcError, MESSAGE_SIZE, "%s: fopen(): File = [%s]: %s", acRoutine, psProperties->acLogFileName, strerror(errno));
+    SocketCleanup(psStream->psSocketCTX);
+    URLFreeStream(psStream);
+    return ER;
+  }
+
+  ui64LogLength = 0;
+  while ((iNRead = fread(acData, 1, HTTP_IO_BUFSIZE, pFile)) > 0)
+  {
+    iError = URLSendData(psStream, acData, iNRead, URL_STREAM_FLUSH_NONE, acLocalError);
+    if (iError != ER_OK)
+    {
+      snprintf(pcError, MESSAGE_SIZE, "%s: %s", acRoutine, acLocalError);
+      fclose(pFile);
+      SocketCleanup(psStream->psSocketCTX);
+      URLFreeStream(psStream);
+      return ER;
+    }
+    ui64LogLength += iNRead;
+  }
+  if (ferror(pFile))
+  {
+    snprintf(pcError, MESSAGE_SIZE, "%s: fread(): File = [%s]: %s", acRoutine, psProperties->acLogFileName, strerror(errno));
+    fclose(pFile);
+    SocketCleanup(psStream->psSocketCTX);
+    URLFreeStream(psStream);
+    return ER;
+  }
+  fclose(pFile);
+
+  /*-
+   *********************************************************************
+   *
+   * Send the trailer. It has a fixed size, so the server can split the
+   * body without knowing either length in advance. It carries the
+   * same fields that a regular upload puts in its query string. If
+   * the body is compressed, the lengths are those of the uncompressed
+   * data, and the trailer ends the compressed stream.
+   *
+   *********************************************************************
+   */
+  iLength = snprintf(acTrailer, URL_STREAM_TRAILER_SIZE, "LOGLENGTH=%llu&OUTLENGTH=%llu&MD5=%s",
+    (unsigned long long) ui64LogLength,
+    (unsigned long long) psStream->ui64OutLength,
+    psProperties->acOutFileHash
+    );
+  memset(&acTrailer[iLength], ' ', URL_STREAM_TRAILER_SIZE - iLength);
+  acTrailer[URL_STREAM_TRAILER_SIZE - 1] = '\n';
+  acTrailer[URL_STREAM_TRAILER_SIZE] = 0;
+
+  iError = URLSendData(psStream, acTrailer, URL_STREAM_TRAILER_SIZE, URL_STREAM_FLUSH_FINISH, acLocalError);
+  if (iError != ER_OK)
+  {
+    snprintf(pcError, MESSAGE_SIZE, "%s: %s", acRoutine, acLocalError);
+    SocketCleanup(psStream->psSocketCTX);
+    URLFreeStream(psStream);
+    return ER;
+  }
+
+  /*-
+   *********************************************************************
+   *
+   * Complete the request, and check the HTTP response code.
+   *
+   *********************************************************************
+   */
+  iError = HttpCloseChunkedRequest(psProperties->psPutURL, psStream->psSocketCTX, &sResponseHeader, acLocalError);
+  URLFreeStream(psStream);
+  if (iError != ER_OK)
+  {
+    snprintf(pcError, MESSAGE_SIZE, "%s: %s", acRoutine, acLocalError);
+    return ER;
+  }
+
+  if (sResponseHeader.iStatusCode < 200 || sResponseHeader.iStatusCode > 299)
+  {
+    snprintf(pcError, MESSAGE_SIZE, "%s: Status = [%d], Reason = [%s]", acRoutine, sResponseHeader.iStatusCode, sResponseHeader.acReasonPhrase);
+    return ER;
+  }
+
+  return ER_OK;
+}
+
+
+/*-
+ ***********************************************************************
+ *
+ * URLFlushStream
+ *
+ ***********************************************************************
+ */
+void
+URLFlushStream(URL_PUT_STREAM *psStream)
+{
+  int                 iIndex;
+
+  /*-
+   *********************************************************************
+   *
+   * Hand pending data to the sender as a single chunk. If the queue is
+   * full, wait for the sender to make room. That bounds the memory in
+   * use and throttles the run to the speed of the connection. Once the
+   * sender has failed, further data is not queued.
+   *
+   *********************************************************************
+   */
+  if (psStream->iLength > 0)
+  {
+    pthread_mutex_lock(&psStream->sMutex);
+    while (psStream->iQueueCount == URL_STREAM_QUEUE_DEPTH && !psStream->iError)
+    {
+      pthread_cond_wait(&psStream->sCondition, &psStream->sMutex);
+    }
+    if (!psStream->iError)
+    {
+      iIndex = (psStream->iQueueFirst + psStream->iQueueCount) % URL_STREAM_QUEUE_DEPTH;
+      memcpy(psStream->aacQueue[iIndex], psStream->acData, psStream->iLength);
+      psStream->aiQueueLengths[iIndex] = psStream->iLength;
+      psStream->iQueueCount++;
+      pthread_cond_signal(&psStream->sCondition);
+    }
+    pthread_mutex_unlock(&psStream->sMutex);
+  }
+  psStream->iLength = 0;
+  psStream->tLastSend = time(NULL);
+}
+
+
+/*-
+ ***********************************************************************
+ *
+ * URLFreeStream
+ *
+ ***********************************************************************
+ */
+void
+URLFreeStream(URL_PUT_STREAM *psStream)
+{
+#ifdef USE_URL_COMPRESSION
+  if (psStream->iCompress)
+  {
+    deflateEnd(&psStream->sZStream);
+  }
+#endif
+  free(psStream);
+}
+#endif
+
+
 /*-
  ***********************************************************************
  *
@@ -148,7 +419,189 @@ URLGetRequest(FTIMES_PROPERTIES *psProperties, char *pcError)
   if (iError != ER_OK)
   {
     snprintf(pcError, MESSAGE_SIZE, "%s: %s", acRoutine, acLocalError);
-    return ER;
+    return ER;
+  }
+
+  /*-
+   *********************************************************************
+   *
+   * Set the request method.
+   *
+   *********************************************************************
+   */
+  iError = HttpSetUrlMeth(psURL, "GET", acLocalError);
+  if (iError != ER_OK)
+  {
+    snprintf(pcError, MESSAGE_SIZE, "%s: %s", acRoutine, acLocalError);
+    return ER;
+  }
+
+  /*-
+   *********************************************************************
+   *
+   * Set the timeouts.
+   *
+   *********************************************************************
+   */
+  HttpSetUrlTimeouts(psURL, psProperties->iURLConnectTimeout, psProperties->iURLReadTimeout, psProperties->iURLWriteTimeout);
+
+  /*-
+   *********************************************************************
+   *
+   * Submit the request.
+   *
+   *********************************************************************
+   */
+  iError = HttpSubmitRequest(psURL, HTTP_IGNORE_INPUT, NULL, HTTP_STREAM_OUTPUT, psProperties->pFileOut, &sResponseHeader, acLocalError);
+  if (iError != ER_OK)
+  {
+    snprintf(pcError, MESSAGE_SIZE, "%s: %s", acRoutine, acLocalError);
+    return ER;
+  }
+
+  /*-
+   *********************************************************************
+   *
+   * Check the HTTP response code.
+   *
+   *********************************************************************
+   */
+  if (sResponseHeader.iStatusCode < 200 || sResponseHeader.iStatusCode > 299)
+  {
+    snprintf(pcError, MESSAGE_SIZE, "%s: Status = [%d], Reason = [%s]", acRoutine, sResponseHeader.iStatusCode, sResponseHeader.acReasonPhrase);
+    return ER;
+  }
+
+  return ER_OK;
+}
+
+
+#ifdef USE_URL_STREAM
+/*-
+ ***********************************************************************
+ *
+ * URLNewStream
+ *
+ ***********************************************************************
+ */
+FILE *
+URLNewStream(FTIMES_PROPERTIES *psProperties, FILE *pSinkFile, char *pcError)
+{
+  const char          acRoutine[] = "URLNewStream()";
+  char                acLocalError[MESSAGE_SIZE] = "";
+  char                acQuery[1024];
+  char               *apcEscaped[6];
+  char               *apcValues[6];
+  int                 i;
+  int                 iEscaped;
+  int                 iError;
+  FILE               *pFile;
+  HTTP_URL           *psURL;
+  URL_PUT_STREAM     *psStream;
+  sigset_t            sOldSignalSet;
+  sigset_t            sSignalSet;
+#ifdef HAVE_FOPENCOOKIE
+  cookie_io_functions_t sFunctions;
+#endif
+
+  /*-
+   *********************************************************************
+   *
+   * If the URL is not defined, abort.
+   *
+   *********************************************************************
+   */
+  psURL = psProperties->psPutURL;
+  if (psURL == NULL)
+  {
+    snprintf(pcError, MESSAGE_SIZE, "%s: Undefined URL.", acRoutine);
+    return NULL;
+  }
+
+  /*-
+   *********************************************************************
+   *
+   * If AuthType is basic, require both a username and a password. If
+   * a URL User and/or Pass is not defined, use the general Username
+   * and Password. If either of those is not defined, abort.
+   *
+   *********************************************************************
+   */
+  if (psProperties->iURLAuthType == HTTP_AUTH_TYPE_BASIC)
+  {
+    if (!psURL->pcUser[0] || !psURL->pcPass[0])
+    {
+      if (!psProperties->acURLUsername[0] || !psProperties->acURLPassword[0])
+      {
+        snprintf(pcError, MESSAGE_SIZE, "%s: Missing Username and/or Password.", acRoutine);
+        return NULL;
+      }
+      else
+      {
+        iError = HttpSetUrlUser(psURL, psProperties->acURLUsername, acLocalError);
+        if (iError != ER_OK)
+        {
+          snprintf(pcError, MESSAGE_SIZE, "%s: %s", acRoutine, acLocalError);
+          return NULL;
+        }
+        iError = HttpSetUrlPass(psURL, psProperties->acURLPassword, acLocalError);
+        if (iError != ER_OK)
+        {
+          snprintf(pcError, MESSAGE_SIZE, "%s: %s", acRoutine, acLocalError);
+          return NULL;
+        }
+      }
+    }
+    psURL->iAuthType = HTTP_AUTH_TYPE_BASIC;
+  }
+
+  /*-
+   *********************************************************************
+   *
+   * Set the query string. The lengths and digest aren't known yet, so
+   * they are sent in a trailer at the end of the body.
+   *
+   *********************************************************************
+   */
+  apcValues[0] = VersionGetVersion();
+  apcValues[1] = psProperties->acBaseName;
+  apcValues[2] = psProperties->acDataType;
+  apcValues[3] = psProperties->psFieldMask->pcMask;
+  apcValues[4] = psProperties->acRunType;
+  apcValues[5] = psProperties->acRunDateTime;
+  for (iEscaped = 0; iEscaped < 6; iEscaped++)
+  {
+    apcEscaped[iEscaped] = HttpEscape(apcValues[iEscaped], acLocalError);
+    if (apcEscaped[iEscaped] == NULL)
+    {
+      snprintf(pcError, MESSAGE_SIZE, "%s: %s", acRoutine, acLocalError);
+      for (i = 0; i < iEscaped; i++)
+      {
+        HttpFreeData(apcEscaped[i]);
+      }
+      return NULL;
+    }
+  }
+
+  snprintf(acQuery, 1024, "VERSION=%s&CLIENTID=%s&DATATYPE=%s&FIELDMASK=%s&RUNTYPE=%s&DATETIME=%s&STREAM=chunked",
+           apcEscaped[0],
+           apcEscaped[1],
+           apcEscaped[2],
+           apcEscaped[3],
+           apcEscaped[4],
+           apcEscaped[5]
+         );
+
+  for (i = 0; i < iEscaped; i++)
+  {
+    HttpFreeData(apcEscaped[i]);
+  }
+
+  iError = HttpSetUrlQuery(psURL, acQuery, acLocalError);
+  if (iError != ER_OK)
+  {
+    snprintf(pcError, MESSAGE_SIZE, "%s: %s", acRoutine, acLocalError);
+    return NULL;
   }
 
   /*-
@@ -158,42 +611,151 @@ URLGetRequest(FTIMES_PROPERTIES *psProperties, char *pcError)
    *
    *********************************************************************
    */
-  iError = HttpSetUrlMeth(psURL, "GET", acLocalError);
+  iError = HttpSetUrlMeth(psURL, "PUT", acLocalError);
   if (iError != ER_OK)
   {
     snprintf(pcError, MESSAGE_SIZE, "%s: %s", acRoutine, acLocalError);
-    return ER;
+    return NULL;
   }
 
   /*-
    *********************************************************************
    *
-   * Submit the request.
+   * Set the timeouts.
    *
    *********************************************************************
    */
-  iError = HttpSubmitRequest(psURL, HTTP_IGNORE_INPUT, NULL, HTTP_STREAM_OUTPUT, psProperties->pFileOut, &sResponseHeader, acLocalError);
-  if (iError != ER_OK)
+  HttpSetUrlTimeouts(psURL, psProperties->iURLConnectTimeout, psProperties->iURLReadTimeout, psProperties->iURLWriteTimeout);
+
+  /*-
+   *********************************************************************
+   *
+   * Allocate the stream, and start the request. A lost connection
+   * must show up as a write error rather than a fatal signal.
+   *
+   *********************************************************************
+   */
+  psStream = (URL_PUT_STREAM *) calloc(sizeof(URL_PUT_STREAM), 1);
+  if (psStream == NULL)
+  {
+    snprintf(pcError, MESSAGE_SIZE, "%s: calloc(): %s", acRoutine, strerror(errno));
+    return NULL;
+  }
+  psStream->pSinkFile = pSinkFile;
+  psStream->tOwner = getpid();
+  psStream->tLastSend = time(NULL);
+
+#ifdef USE_URL_COMPRESSION
+  /*-
+   *********************************************************************
+   *
+   * Set up the compressor, if requested. The whole body is sent as a
+   * single gzip stream, and the server is told so via the request's
+   * Content-Encoding. The local copy, if any, is not compressed.
+   *
+   *********************************************************************
+   */
+  if (psProperties->iURLPutCompression == FTIMES_URL_COMPRESSION_GZIP)
+  {
+    iError = deflateInit2(&psStream->sZStream, psProperties->iOutputCompressLevel, Z_DEFLATED, GZIP_WINDOW_BITS_GZIP, 8, Z_DEFAULT_STRATEGY);
+    if (iError != Z_OK)
+    {
+      snprintf(pcError, MESSAGE_SIZE, "%s: deflateInit2(): %s", acRoutine, (psStream->sZStream.msg != NULL) ? psStream->sZStream.msg : "Unknown error");
+      free(psStream);
+      return NULL;
+    }
+    psStream->iCompress = 1;
+    psURL->iFlags |= HTTP_FLAG_GZIP_CONTENT;
+  }
+#endif
+
+  signal(SIGPIPE, SIG_IGN);
+
+  psStream->psSocketCTX = HttpOpenChunkedRequest(psURL, acLocalError);
+#ifdef USE_URL_COMPRESSION
+  psURL->iFlags &= ~HTTP_FLAG_GZIP_CONTENT;
+#endif
+  if (psStream->psSocketCTX == NULL)
   {
     snprintf(pcError, MESSAGE_SIZE, "%s: %s", acRoutine, acLocalError);
-    return ER;
+    URLFreeStream(psStream);
+    return NULL;
   }
 
   /*-
    *********************************************************************
    *
-   * Check the HTTP response code.
+   * Start the sender. It owns the connection until the stream is
+   * closed, so the run doesn't stall each time a chunk goes out.
+   * Block all signals while the thread is created, so that it doesn't
+   * steal any from the main thread (e.g., SIGALRM or SIGCHLD).
    *
    *********************************************************************
    */
-  if (sResponseHeader.iStatusCode < 200 || sResponseHeader.iStatusCode > 299)
+  iError = pthread_mutex_init(&psStream->sMutex, NULL);
+  if (iError != 0)
   {
-    snprintf(pcError, MESSAGE_SIZE, "%s: Status = [%d], Reason = [%s]", acRoutine, sResponseHeader.iStatusCode, sResponseHeader.acReasonPhrase);
-    return ER;
+    snprintf(pcError, MESSAGE_SIZE, "%s: pthread_mutex_init(): %s", acRoutine, strerror(iError));
+    SocketCleanup(psStream->psSocketCTX);
+    URLFreeStream(psStream);
+    return NULL;
+  }
+  iError = pthread_cond_init(&psStream->sCondition, NULL);
+  if (iError != 0)
+  {
+    snprintf(pcError, MESSAGE_SIZE, "%s: pthread_cond_init(): %s", acRoutine, strerror(iError));
+    pthread_mutex_destroy(&psStream->sMutex);
+    SocketCleanup(psStream->psSocketCTX);
+    URLFreeStream(psStream);
+    return NULL;
+  }
+  sigfillset(&sSignalSet);
+  pthread_sigmask(SIG_SETMASK, &sSignalSet, &sOldSignalSet);
+  iError = pthread_create(&psStream->tThread, NULL, URLSendWorker, psStream);
+  pthread_sigmask(SIG_SETMASK, &sOldSignalSet, NULL);
+  if (iError != 0)
+  {
+    snprintf(pcError, MESSAGE_SIZE, "%s: pthread_create(): %s", acRoutine, strerror(iError));
+    pthread_cond_destroy(&psStream->sCondition);
+    pthread_mutex_destroy(&psStream->sMutex);
+    SocketCleanup(psStream->psSocketCTX);
+    URLFreeStream(psStream);
+    return NULL;
   }
 
-  return ER_OK;
+#ifdef HAVE_FOPENCOOKIE
+  memset(&sFunctions, 0, sizeof(sFunctions));
+  sFunctions.write = URLWriteStream;
+  sFunctions.close = URLCloseStream;
+  pFile = fopencookie(psStream, "w", sFunctions);
+#else
+  pFile = funopen(psStream, NULL, URLWriteStream, NULL, URLCloseStream);
+#endif
+  if (pFile == NULL)
+  {
+    snprintf(pcError, MESSAGE_SIZE, "%s: %s: %s", acRoutine,
+#ifdef HAVE_FOPENCOOKIE
+      "fopencookie()",
+#else
+      "funopen()",
+#endif
+      strerror(errno));
+    pthread_mutex_lock(&psStream->sMutex);
+    psStream->iFinish = 1;
+    pthread_cond_signal(&psStream->sCondition);
+    pthread_mutex_unlock(&psStream->sMutex);
+    pthread_join(psStream->tThread, NULL);
+    pthread_cond_destroy(&psStream->sCondition);
+    pthread_mutex_destroy(&psStream->sMutex);
+    SocketCleanup(psStream->psSocketCTX);
+    URLFreeStream(psStream);
+    return NULL;
+  }
+  psProperties->psPutStream = psStream;
+
+  return pFile;
 }
+#endif
 
 
 /*-
@@ -361,6 +923,25 @@ URLPingRequest(FTIMES_PROPERTIES *psProperties, char *pcError)
     return ER;
   }
 
+  /*-
+   *********************************************************************
+   *
+   * Set the timeouts.
+   *
+   *********************************************************************
+   */
+  HttpSetUrlTimeouts(psURL, psProperties->iURLConnectTimeout, psProperties->iURLReadTimeout, psProperties->iURLWriteTimeout);
+
+  /*-
+   *********************************************************************
+   *
+   * Ask the server to keep the connection open so that the upload
+   * that follows can reuse it.
+   *
+   *********************************************************************
+   */
+  psURL->iFlags |= HTTP_FLAG_KEEP_ALIVE;
+
   /*-
    *********************************************************************
    *
@@ -420,6 +1001,27 @@ URLPutRequest(FTIMES_PROPERTIES *psProperties, char *pcError)
   HTTP_RESPONSE_HDR   sResponseHeader;
   APP_UI64            ui64Size;
 
+#ifdef USE_URL_COMPRESSION
+  /*-
+   *********************************************************************
+   *
+   * The size of a compressed body isn't known up front, so compressed
+   * uploads are always streamed.
+   *
+   *********************************************************************
+   */
+  if (psProperties->iURLPutCompression == FTIMES_URL_COMPRESSION_GZIP)
+  {
+    iError = URLPutStreamRequest(psProperties, acLocalError);
+    if (iError != ER_OK)
+    {
+      snprintf(pcError, MESSAGE_SIZE, "%s: %s", acRoutine, acLocalError);
+      return ER;
+    }
+    return ER_OK;
+  }
+#endif
+
   /*-
    *********************************************************************
    *
@@ -674,6 +1276,15 @@ URLPutRequest(FTIMES_PROPERTIES *psProperties, char *pcError)
     return ER;
   }
 
+  /*-
+   *********************************************************************
+   *
+   * Set the timeouts.
+   *
+   *********************************************************************
+   */
+  HttpSetUrlTimeouts(psURL, psProperties->iURLConnectTimeout, psProperties->iURLReadTimeout, psProperties->iURLWriteTimeout);
+
   /*-
    *********************************************************************
    *
@@ -719,3 +1330,297 @@ URLPutRequest(FTIMES_PROPERTIES *psProperties, char *pcError)
 
   return ER_OK;
 }
+
+
+#ifdef USE_URL_STREAM
+/*-
+ ***********************************************************************
+ *
+ * URLPutStreamRequest
+ *
+ ***********************************************************************
+ */
+int
+URLPutStreamRequest(FTIMES_PROPERTIES *psProperties, char *pcError)
+{
+  const char          acRoutine[] = "URLPutStreamRequest()";
+  char                acLocalError[MESSAGE_SIZE] = "";
+  char                acData[HTTP_IO_BUFSIZE];
+  FILE               *pFile;
+  FILE               *pStreamFile;
+  int                 iError;
+  int                 iNRead;
+  URL_PUT_STREAM     *psStream;
+
+  /*-
+   *********************************************************************
+   *
+   * Upload a finished Out file as though it had been streamed during
+   * the run. The stream's sender does the work, so reading the file
+   * overlaps with compressing and sending it.
+   *
+   *********************************************************************
+   */
+  pFile = fopen(psProperties->acOutFileName, "rb");
+  if (pFile == NULL)
+  {
+    snprintf(pcError, MESSAGE_SIZE, "%s: fopen(): File = [%s]: %s", acRoutine, psProperties->acOutFileName, strerror(errno));
+    return ER;
+  }
+
+  pStreamFile = URLNewStream(psProperties, NULL, acLocalError);
+  if (pStreamFile == NULL)
+  {
+    snprintf(pcError, MESSAGE_SIZE, "%s: %s", acRoutine, acLocalError);
+    fclose(pFile);
+    return ER;
+  }
+
+  while ((iNRead = fread(acData, 1, HTTP_IO_BUFSIZE, pFile)) > 0)
+  {
+    if (fwrite(acData, 1, iNRead, pStreamFile) != (size_t) iNRead)
+    {
+      break; /* The stream broke. URLFinishStream() will report why. */
+    }
+  }
+  iError = (ferror(pFile)) ? ER : ER_OK;
+  if (iError != ER_OK)
+  {
+    snprintf(pcError, MESSAGE_SIZE, "%s: fread(): File = [%s]: %s", acRoutine, psProperties->acOutFileName, strerror(errno));
+  }
+  fclose(pFile);
+  fclose(pStreamFile);
+
+  /*-
+   *********************************************************************
+   *
+   * If the file couldn't be read, abandon the request. Otherwise, send
+   * the log file and trailer, and complete the request.
+   *
+   *********************************************************************
+   */
+  if (iError != ER_OK)
+  {
+    psStream = psProperties->psPutStream;
+    psProperties->psPutStream = NULL;
+    SocketCleanup(psStream->psSocketCTX);
+    URLFreeStream(psStream);
+    return ER;
+  }
+
+  iError = URLFinishStream(psProperties, acLocalError);
+  if (iError != ER_OK)
+  {
+    snprintf(pcError, MESSAGE_SIZE, "%s: %s", acRoutine, acLocalError);
+    return ER;
+  }
+
+  return ER_OK;
+}
+
+
+/*-
+ ***********************************************************************
+ *
+ * URLSendData
+ *
+ ***********************************************************************
+ */
+int
+URLSendData(URL_PUT_STREAM *psStream, char *pcData, int iLength, int iFlush, char *pcError)
+{
+  const char          acRoutine[] = "URLSendData()";
+  char                acLocalError[MESSAGE_SIZE] = "";
+#ifdef USE_URL_COMPRESSION
+  int                 iError;
+  int                 iDeflated;
+
+  /*-
+   *********************************************************************
+   *
+   * Run the data through the compressor, and send whatever comes out.
+   * Keep going until the compressor has room to spare, which means it
+   * has consumed all input and produced everything the flush calls for.
+   *
+   *********************************************************************
+   */
+  if (psStream->iCompress)
+  {
+    psStream->sZStream.next_in = (Bytef *) pcData;
+    psStream->sZStream.avail_in = iLength;
+    do
+    {
+      psStream->sZStream.next_out = (Bytef *) psStream->acDeflated;
+      psStream->sZStream.avail_out = HTTP_IO_BUFSIZE;
+      iError = deflate(&psStream->sZStream, (iFlush == URL_STREAM_FLUSH_FINISH) ? Z_FINISH : (iFlush == URL_STREAM_FLUSH_SYNC) ? Z_SYNC_FLUSH : Z_NO_FLUSH);
+      if (iError == Z_STREAM_ERROR)
+      {
+        snprintf(pcError, MESSAGE_SIZE, "%s: deflate(): Stream error.", acRoutine);
+        return ER;
+      }
+      iDeflated = HTTP_IO_BUFSIZE - psStream->sZStream.avail_out;
+      if (iDeflated > 0)
+      {
+        if (HttpWriteChunk(psStream->psSocketCTX, psStream->acDeflated, iDeflated, acLocalError) != ER_OK)
+        {
+          snprintf(pcError, MESSAGE_SIZE, "%s: %s", acRoutine, acLocalError);
+          return ER;
+        }
+      }
+    } while (psStream->sZStream.avail_out == 0);
+    return ER_OK;
+  }
+#endif
+
+  if (HttpWriteChunk(psStream->psSocketCTX, pcData, iLength, acLocalError) != ER_OK)
+  {
+    snprintf(pcError, MESSAGE_SIZE, "%s: %s", acRoutine, acLocalError);
+    return ER;
+  }
+
+  return ER_OK;
+}
+
+
+/*-
+ ***********************************************************************
+ *
+ * URLSendWorker
+ *
+ ***********************************************************************
+ */
+void *
+URLSendWorker(void *pvStream)
+{
+  URL_PUT_STREAM     *psStream = (URL_PUT_STREAM *)pvStream;
+  char                acLocalError[MESSAGE_SIZE] = "";
+  int                 iError;
+  int                 iIndex;
+
+  /*-
+   *********************************************************************
+   *
+   * Send queued chunks in order. The connection and the compressor,
+   * if any, are only touched here while the sender runs. Each chunk
+   * is flushed through the compressor, so the server stays current.
+   * If a send fails (or times out), remember why, and stop. The main
+   * thread checks iError before it queues more data, and it reports
+   * the error when the stream is finished.
+   *
+   *********************************************************************
+   */
+  for (;;)
+  {
+    pthread_mutex_lock(&psStream->sMutex);
+    while (psStream->iQueueCount == 0 && !psStream->iFinish)
+    {
+      pthread_cond_wait(&psStream->sCondition, &psStream->sMutex);
+    }
+    if (psStream->iQueueCount == 0)
+    {
+      pthread_mutex_unlock(&psStream->sMutex);
+      break;
+    }
+    iIndex = psStream->iQueueFirst;
+    pthread_mutex_unlock(&psStream->sMutex);
+
+    iError = URLSendData(psStream, psStream->aacQueue[iIndex], psStream->aiQueueLengths[iIndex], URL_STREAM_FLUSH_SYNC, acLocalError);
+
+    pthread_mutex_lock(&psStream->sMutex);
+    psStream->iQueueFirst = (psStream->iQueueFirst + 1) % URL_STREAM_QUEUE_DEPTH;
+    psStream->iQueueCount--;
+    if (iError != ER_OK)
+    {
+      snprintf(psStream->acError, MESSAGE_SIZE, "URLSendWorker(): %s", acLocalError);
+      psStream->iError = 1;
+    }
+    pthread_cond_signal(&psStream->sCondition);
+    pthread_mutex_unlock(&psStream->sMutex);
+    if (iError != ER_OK)
+    {
+      break;
+    }
+  }
+
+  return NULL;
+}
+
+
+/*-
+ ***********************************************************************
+ *
+ * URLWriteStream
+ *
+ ***********************************************************************
+ */
+URL_STREAM_IO_RESULT
+URLWriteStream(void *pvStream, const char *pcData, URL_STREAM_IO_LENGTH iLength)
+{
+  URL_PUT_STREAM     *psStream = (URL_PUT_STREAM *)pvStream;
+  int                 iCount;
+  int                 iDone;
+
+  if (getpid() != psStream->tOwner)
+  {
+    return iLength;
+  }
+
+  /*-
+   *********************************************************************
+   *
+   * Keep the local copy, if any, whole even if the connection breaks.
+   * Without one, a broken connection means the data has nowhere to go.
+   *
+   *********************************************************************
+   */
+  if (psStream->pSinkFile != NULL)
+  {
+    if (fwrite(pcData, 1, iLength, psStream->pSinkFile) != (size_t) iLength)
+    {
+      return -1;
+    }
+  }
+  else if (psStream->iError)
+  {
+    errno = EIO;
+    return -1;
+  }
+  psStream->ui64OutLength += iLength;
+
+  /*-
+   *********************************************************************
+   *
+   * Gather data into full chunks, but don't sit on a partial chunk for
+   * longer than the flush interval. That keeps the server current when
+   * records trickle in.
+   *
+   *********************************************************************
+   */
+  for (iDone = 0; iDone < (int) iLength && !psStream->iError; iDone += iCount)
+  {
+    iCount = HTTP_IO_BUFSIZE - psStream->iLength;
+    if (iCount > (int) iLength - iDone)
+    {
+      iCount = (int) iLength - iDone;
+    }
+    memcpy(&psStream->acData[psStream->iLength], &pcData[iDone], iCount);
+    psStream->iLength += iCount;
+    if (psStream->iLength == HTTP_IO_BUFSIZE)
+    {
+      URLFlushStream(psStream);
+    }
+  }
+  if (psStream->iLength > 0 && time(NULL) - psStream->tLastSend >= URL_STREAM_FLUSH_INTERVAL)
+  {
+    URLFlushStream(psStream);
+  }
+
+  if (psStream->iError && psStream->pSinkFile == NULL)
+  {
+    errno = EIO;
+    return -1;
+  }
+
+  return iLength;
+}
+#endif
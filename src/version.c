@@ -23,7 +23,7 @@ VersionGetVersion(void)
 {
   static char         acMyVersion[VERSION_MAX_VERSION_LENGTH] = "NA";
   static char         acMyState[3] = "";
-#if defined(USE_KLEL) || defined(USE_KLEL_FILTERS) || defined(USE_EMBEDDED_LUA) || defined(USE_PCRE) || defined(USE_EMBEDDED_PERL) || defined(USE_EMBEDDED_PYTHON) || defined(USE_SSL) || defined(USE_XMAGIC) || defined(USE_FILE_HOOKS)
+#if defined(USE_KLEL) || defined(USE_KLEL_FILTERS) || defined(USE_EMBEDDED_LUA) || defined(USE_PCRE) || defined(USE_EMBEDDED_PERL) || defined(USE_EMBEDDED_PYTHON) || defined(USE_SSL) || defined(USE_XMAGIC) || defined(USE_FILE_HOOKS) || defined(USE_DECODE_THREADS) || defined(USE_ZLIB)
   int                 iCount = 0;
   int                 iIndex = 0;
   int                 iSize = VERSION_MAX_VERSION_LENGTH;
@@ -93,7 +93,7 @@ VersionGetVersion(void)
    */
   if (((VERSION >> 10) & 0x03) == 2 && ((VERSION & 0x3ff) == 0))
   {
-#if defined(USE_KLEL) || defined(USE_KLEL_FILTERS) || defined(USE_EMBEDDED_LUA) || defined(USE_PCRE) || defined(USE_EMBEDDED_PERL) || defined(USE_EMBEDDED_PYTHON) || defined(USE_SSL) || defined(USE_XMAGIC) || defined(USE_FILE_HOOKS)
+#if defined(USE_KLEL) || defined(USE_KLEL_FILTERS) || defined(USE_EMBEDDED_LUA) || defined(USE_PCRE) || defined(USE_EMBEDDED_PERL) || defined(USE_EMBEDDED_PYTHON) || defined(USE_SSL) || defined(USE_XMAGIC) || defined(USE_FILE_HOOKS) || defined(USE_DECODE_THREADS) || defined(USE_ZLIB)
     iIndex = 
 #endif
     snprintf(acMyVersion, VERSION_MAX_VERSION_LENGTH, "%s %d.%d.%d %d-bit",
@@ -106,7 +106,7 @@ VersionGetVersion(void)
   }
   else
   {
-#if defined(USE_KLEL) || defined(USE_KLEL_FILTERS) || defined(USE_EMBEDDED_LUA) || defined(USE_PCRE) || defined(USE_EMBEDDED_PERL) || defined(USE_EMBEDDED_PYTHON) || defined(USE_SSL) || defined(USE_XMAGIC) || defined(USE_FILE_HOOKS)
+#if defined(USE_KLEL) || defined(USE_KLEL_FILTERS) || defined(USE_EMBEDDED_LUA) || defined(USE_PCRE) || defined(USE_EMBEDDED_PERL) || defined(USE_EMBEDDED_PYTHON) || defined(USE_SSL) || defined(USE_XMAGIC) || defined(USE_FILE_HOOKS) || defined(USE_DECODE_THREADS) || defined(USE_ZLIB)
     iIndex = 
 #endif
     snprintf(acMyVersion, VERSION_MAX_VERSION_LENGTH, "%s %d.%d.%d (%s%d) %d-bit",
@@ -119,7 +119,7 @@ VersionGetVersion(void)
       (int) (sizeof(&VersionGetVersion) * 8)
       );
   }
-#if defined(USE_KLEL) || defined(USE_KLEL_FILTERS) || defined(USE_EMBEDDED_LUA) || defined(USE_PCRE) || defined(USE_EMBEDDED_PERL) || defined(USE_EMBEDDED_PYTHON) || defined(USE_SSL) || defined(USE_XMAGIC) || defined(USE_FILE_HOOKS)
+#if defined(USE_KLEL) || defined(USE_KLEL_FILTERS) || defined(USE_EMBEDDED_LUA) || defined(USE_PCRE) || defined(USE_EMBEDDED_PERL) || defined(USE_EMBEDDED_PYTHON) || defined(USE_SSL) || defined(USE_XMAGIC) || defined(USE_FILE_HOOKS) || defined(USE_DECODE_THREADS) || defined(USE_ZLIB)
   iSize = ((VERSION_MAX_VERSION_LENGTH - iIndex) <= 0) ? 0 : VERSION_MAX_VERSION_LENGTH - iIndex;
 #endif
 
@@ -171,6 +171,14 @@ VersionGetVersion(void)
   iIndex += snprintf(&acMyVersion[iIndex], iSize, "%sxmagic", (iCount++ == 0) ? " " : ",");
   iSize = ((VERSION_MAX_VERSION_LENGTH - iIndex) <= 0) ? 0 : VERSION_MAX_VERSION_LENGTH - iIndex;
 #endif
+#ifdef USE_DECODE_THREADS
+  iIndex += snprintf(&acMyVersion[iIndex], iSize, "%sthreads", (iCount++ == 0) ? " " : ",");
+  iSize = ((VERSION_MAX_VERSION_LENGTH - iIndex) <= 0) ? 0 : VERSION_MAX_VERSION_LENGTH - iIndex;
+#endif
+#ifdef USE_ZLIB
+  iIndex += snprintf(&acMyVersion[iIndex], iSize, "%szlib(%s)", (iCount++ == 0) ? " " : ",", zlibVersion());
+  iSize = ((VERSION_MAX_VERSION_LENGTH - iIndex) <= 0) ? 0 : VERSION_MAX_VERSION_LENGTH - iIndex;
+#endif
 
   return acMyVersion;
 }
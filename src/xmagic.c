@@ -23,6 +23,7 @@
 
 int                 giSystemByteOrder = -1;
 APP_UI8             gaui08ByteOrderMagic[4] = {0x01, 0x02, 0x03, 0x04};
+static XMAGIC_HISTOGRAM gsXMagicHistogram;
 
 #ifdef USE_KLEL
 XMAGIC_KLEL_TYPE_SPEC gasKlelTypes[] =
@@ -71,43 +72,197 @@ size_t strnlen(const char *pcString, size_t szMaxLength)
 /*-
  ***********************************************************************
  *
- * XMagicComputePercentage
+ * XMagicCompareCodes
  *
  ***********************************************************************
  */
-double
-XMagicComputePercentage(unsigned char *pucBuffer, int iLength, int iType)
+int
+XMagicCompareCodes(const void *pvCode1, const void *pvCode2)
 {
-  double              dSum = 0.0;
-  double              dTotal = 0.0;
-  int                 aiCodeCounts[XMAGIC_PERCENT_1BYTE_CODES];
+  int                 iCode1 = *((const int *) pvCode1);
+  int                 iCode2 = *((const int *) pvCode2);
+
+  return (iCode1 > iCode2) - (iCode1 < iCode2);
+}
+
+
+/*-
+ ***********************************************************************
+ *
+ * XMagicCompileIndex
+ *
+ ***********************************************************************
+ */
+int
+XMagicCompileIndex(XMAGIC *psXMagic, char *pcError)
+{
+  const char          acRoutine[] = "XMagicCompileIndex()";
   int                 i = 0;
-  int               (*piRoutine)();
+  int                 iBucket = 0;
+  int                 iOrdinal = 0;
+  int                 iPass = 0;
+  unsigned char       ucKey = 0;
+  XMAGIC             *psMyXMagic = NULL;
+  XMAGIC_INDEX       *psIndex = NULL;
+  XMAGIC_INDEX_BUCKET *psBuckets = NULL;
+  XMAGIC_INDEX_LIST  *psList = NULL;
 
   /*-
    *********************************************************************
    *
-   * Clear the code counts array.
+   * Allocate the index, and record the level zero tests in order.
    *
    *********************************************************************
    */
-  for (i = 0; i < XMAGIC_PERCENT_1BYTE_CODES; i++)
+  psIndex = (XMAGIC_INDEX *) calloc(sizeof(XMAGIC_INDEX), 1);
+  if (psIndex == NULL)
   {
-    aiCodeCounts[i] = 0;
+    snprintf(pcError, MESSAGE_SIZE, "%s: calloc(): %s", acRoutine, strerror(errno));
+    return ER;
+  }
+  for (psMyXMagic = psXMagic; psMyXMagic != NULL; psMyXMagic = psMyXMagic->psSibling)
+  {
+    psIndex->iTestCount++;
+  }
+  psIndex->ppsTests = (XMAGIC **) calloc(sizeof(XMAGIC *), psIndex->iTestCount);
+  if (psIndex->ppsTests == NULL)
+  {
+    snprintf(pcError, MESSAGE_SIZE, "%s: calloc(): %s", acRoutine, strerror(errno));
+    XMagicFreeIndex(psIndex);
+    return ER;
+  }
+  for (psMyXMagic = psXMagic, iOrdinal = 0; psMyXMagic != NULL; psMyXMagic = psMyXMagic->psSibling, iOrdinal++)
+  {
+    psIndex->ppsTests[iOrdinal] = psMyXMagic;
   }
 
   /*-
    *********************************************************************
    *
-   * Tally up the the code counts.
+   * Distribute the tests in two passes. The first pass creates one
+   * bucket per distinct offset and sizes each candidate list. The
+   * second pass allocates the lists and fills them in test order.
+   *
+   *********************************************************************
+   */
+  for (iPass = 0; iPass < 2; iPass++)
+  {
+    for (iOrdinal = 0; iOrdinal < psIndex->iTestCount; iOrdinal++)
+    {
+      psMyXMagic = psIndex->ppsTests[iOrdinal];
+      if (XMagicGetIndexKey(psMyXMagic, &ucKey))
+      {
+        for (iBucket = 0; iBucket < psIndex->iBucketCount; iBucket++)
+        {
+          if (psIndex->psBuckets[iBucket].i32Offset == psMyXMagic->i32XOffset)
+          {
+            break;
+          }
+        }
+        if (iBucket == psIndex->iBucketCount)
+        {
+          psBuckets = (XMAGIC_INDEX_BUCKET *) realloc(psIndex->psBuckets, sizeof(XMAGIC_INDEX_BUCKET) * (psIndex->iBucketCount + 1));
+          if (psBuckets == NULL)
+          {
+            snprintf(pcError, MESSAGE_SIZE, "%s: realloc(): %s", acRoutine, strerror(errno));
+            XMagicFreeIndex(psIndex);
+            return ER;
+          }
+          memset(&psBuckets[iBucket], 0, sizeof(XMAGIC_INDEX_BUCKET));
+          psBuckets[iBucket].i32Offset = psMyXMagic->i32XOffset;
+          psIndex->psBuckets = psBuckets;
+          psIndex->iBucketCount++;
+        }
+        psList = &psIndex->psBuckets[iBucket].asLists[ucKey];
+      }
+      else
+      {
+        psList = &psIndex->sUnkeyed;
+      }
+      if (iPass == 0)
+      {
+        psList->iCount++;
+      }
+      else
+      {
+        psList->piOrdinals[psList->iCount++] = iOrdinal;
+      }
+    }
+
+    if (iPass == 0)
+    {
+      for (i = 0; i <= psIndex->iBucketCount * XMAGIC_INDEX_BYTE_CODES; i++)
+      {
+        if (i < psIndex->iBucketCount * XMAGIC_INDEX_BYTE_CODES)
+        {
+          psList = &psIndex->psBuckets[i / XMAGIC_INDEX_BYTE_CODES].asLists[i % XMAGIC_INDEX_BYTE_CODES];
+        }
+        else
+        {
+          psList = &psIndex->sUnkeyed;
+        }
+        if (psList->iCount > 0)
+        {
+          psList->piOrdinals = (int *) calloc(sizeof(int), psList->iCount);
+          if (psList->piOrdinals == NULL)
+          {
+            snprintf(pcError, MESSAGE_SIZE, "%s: calloc(): %s", acRoutine, strerror(errno));
+            XMagicFreeIndex(psIndex);
+            return ER;
+          }
+        }
+        psList->iCount = 0;
+      }
+    }
+  }
+
+  /*-
+   *********************************************************************
+   *
+   * Allocate enough cursors to merge every bucket plus the unkeyed
+   * list.
    *
    *********************************************************************
    */
-  for (i = 0; i < iLength; i++)
+  psIndex->psCursors = (XMAGIC_INDEX_LIST *) calloc(sizeof(XMAGIC_INDEX_LIST), psIndex->iBucketCount + 1);
+  if (psIndex->psCursors == NULL)
   {
-    aiCodeCounts[pucBuffer[i]]++;
+    snprintf(pcError, MESSAGE_SIZE, "%s: calloc(): %s", acRoutine, strerror(errno));
+    XMagicFreeIndex(psIndex);
+    return ER;
   }
 
+  psXMagic->psIndex = psIndex;
+
+  return ER_OK;
+}
+
+
+/*-
+ ***********************************************************************
+ *
+ * XMagicComputePercentage
+ *
+ ***********************************************************************
+ */
+double
+XMagicComputePercentage(unsigned char *pucBuffer, int iLength, int iType)
+{
+  double              dSum = 0.0;
+  double              dTotal = 0.0;
+  int                *piCodeCounts = NULL;
+  int                 i = 0;
+  int               (*piRoutine)();
+
+  /*-
+   *********************************************************************
+   *
+   * Get the code counts.
+   *
+   *********************************************************************
+   */
+  piCodeCounts = XMagicGetHistogram(pucBuffer, iLength);
+
   /*-
    *********************************************************************
    *
@@ -157,10 +312,13 @@ XMagicComputePercentage(unsigned char *pucBuffer, int iLength, int iType)
 
   for (i = 0; i < XMAGIC_PERCENT_1BYTE_CODES; i++)
   {
-    dTotal += (double) aiCodeCounts[i];
-    if (piRoutine(i))
+    if (piCodeCounts[i] > 0)
     {
-      dSum += (double) aiCodeCounts[i];
+      dTotal += (double) piCodeCounts[i];
+      if (piRoutine(i))
+      {
+        dSum += (double) piCodeCounts[i];
+      }
     }
   }
 
@@ -182,7 +340,7 @@ XMagicComputePercentageCombo(unsigned char *pucBuffer, int iLength, int iType)
   double              dPercents[XMAGIC_COMBO_SLOT_COUNT];
   double              dSums[XMAGIC_COMBO_SLOT_COUNT];
   double              dTotal = 0.0;
-  int                 aiCodeCounts[XMAGIC_PERCENT_1BYTE_CODES];
+  int                *piCodeCounts = NULL;
   int                 i = 0;
   int                 n = 0;
 
@@ -203,15 +361,10 @@ XMagicComputePercentageCombo(unsigned char *pucBuffer, int iLength, int iType)
   /*-
    *********************************************************************
    *
-   * Clear the code counts, sums, and percentages arrays.
+   * Clear the sums and percentages arrays.
    *
    *********************************************************************
    */
-  for (i = 0; i < XMAGIC_PERCENT_1BYTE_CODES; i++)
-  {
-    aiCodeCounts[i] = 0;
-  }
-
   for (i = 0; i < XMAGIC_COMBO_SLOT_COUNT; i++)
   {
     dSums[i] = dPercents[i] = 0.0;
@@ -220,14 +373,11 @@ XMagicComputePercentageCombo(unsigned char *pucBuffer, int iLength, int iType)
   /*-
    *********************************************************************
    *
-   * Tally up the code counts.
+   * Get the code counts.
    *
    *********************************************************************
    */
-  for (i = 0; i < iLength; i++)
-  {
-    aiCodeCounts[pucBuffer[i]]++;
-  }
+  piCodeCounts = XMagicGetHistogram(pucBuffer, iLength);
 
   /*-
    *********************************************************************
@@ -238,33 +388,33 @@ XMagicComputePercentageCombo(unsigned char *pucBuffer, int iLength, int iType)
    */
   for (i = 0; i < XMAGIC_PERCENT_1BYTE_CODES; i++)
   {
-    dTotal += (double) aiCodeCounts[i];
+    dTotal += (double) piCodeCounts[i];
     switch (iType)
     {
     case XMAGIC_PERCENT_COMBO_CSPDAE:
       if (iscntrl(i) && !isspace(i))
       {
-        dSums[0] += (double) aiCodeCounts[i];
+        dSums[0] += (double) piCodeCounts[i];
       }
       else if (isspace(i))
       {
-        dSums[1] += (double) aiCodeCounts[i];
+        dSums[1] += (double) piCodeCounts[i];
       }
       else if (ispunct(i))
       {
-        dSums[2] += (double) aiCodeCounts[i];
+        dSums[2] += (double) piCodeCounts[i];
       }
       else if (isdigit(i))
       {
-        dSums[3] += (double) aiCodeCounts[i];
+        dSums[3] += (double) piCodeCounts[i];
       }
       else if (isalpha(i))
       {
-        dSums[4] += (double) aiCodeCounts[i];
+        dSums[4] += (double) piCodeCounts[i];
       }
       else
       {
-        dSums[5] += (double) aiCodeCounts[i];
+        dSums[5] += (double) piCodeCounts[i];
       }
       break;
     default:
@@ -322,49 +472,26 @@ XMagicComputePercentageCombo(unsigned char *pucBuffer, int iLength, int iType)
 double
 XMagicComputeRowAverage1(unsigned char *pucBuffer, int iLength)
 {
-  int                 aiCodeCounts[XMAGIC_ROW_AVERAGE_1_CODES];
+  APP_UI64            ui64Sum = 0;
+  int                *piCodeCounts = NULL;
   int                 i = 0;
-  double              dAverage = 0.0;
-  double              dSum = 0.0;
-
-  /*-
-   *********************************************************************
-   *
-   * Clear the code counts array.
-   *
-   *********************************************************************
-   */
-  for (i = 0; i < XMAGIC_ROW_AVERAGE_1_CODES; i++)
-  {
-    aiCodeCounts[i] = 0;
-  }
-
-  /*-
-   *********************************************************************
-   *
-   * Tally up the the code counts.
-   *
-   *********************************************************************
-   */
-  for (i = 0; i < iLength; i++)
-  {
-    aiCodeCounts[pucBuffer[i]]++;
-  }
 
   /*-
    *********************************************************************
    *
-   * Compute the average.
+   * Get the code counts, and compute the average. The sum is kept as
+   * an integer, so the result is exact regardless of the order in
+   * which the codes are visited.
    *
    *********************************************************************
    */
+  piCodeCounts = XMagicGetHistogram(pucBuffer, iLength);
   for (i = 0; i < XMAGIC_ROW_AVERAGE_1_CODES; i++)
   {
-    dSum += (double) (i * aiCodeCounts[i]);
+    ui64Sum += (APP_UI64) i * piCodeCounts[i];
   }
-  dAverage = dSum / iLength;
 
-  return dAverage;
+  return (double) ui64Sum / iLength;
 }
 
 
@@ -378,50 +505,27 @@ XMagicComputeRowAverage1(unsigned char *pucBuffer, int iLength)
 double
 XMagicComputeRowAverage2(unsigned char *pucBuffer, int iLength)
 {
-  int                 aiCodeCounts[XMAGIC_ROW_AVERAGE_2_CODES];
+  APP_UI64            ui64Sum = 0;
+  int                *piCodeCounts = NULL;
   int                 i = 0;
-  double              dAverage = 0.0;
-  double              dSum = 0.0;
-
-  /*-
-   *********************************************************************
-   *
-   * Clear the code counts array.
-   *
-   *********************************************************************
-   */
-  for (i = 0; i < XMAGIC_ROW_AVERAGE_2_CODES; i++)
-  {
-    aiCodeCounts[i] = 0;
-  }
-
-  /*-
-   *********************************************************************
-   *
-   * Tally up the the code counts.
-   *
-   *********************************************************************
-   */
-  for (i = 0; i < iLength - 1; i++)
-  {
-    aiCodeCounts[(pucBuffer[i] << 8) | pucBuffer[i + 1]]++;
-  }
-  aiCodeCounts[(pucBuffer[i] << 8) | pucBuffer[0]]++;
 
   /*-
    *********************************************************************
    *
-   * Compute the average.
+   * The codes are formed from each byte and its (circular) successor,
+   * so every byte appears exactly once as a high byte and once as a
+   * low byte. Therefore, the sum of all codes is 257 times the sum of
+   * all bytes, and the single byte histogram is sufficient.
    *
    *********************************************************************
    */
-  for (i = 0; i < XMAGIC_ROW_AVERAGE_2_CODES; i++)
+  piCodeCounts = XMagicGetHistogram(pucBuffer, iLength);
+  for (i = 0; i < XMAGIC_ROW_AVERAGE_1_CODES; i++)
   {
-    dSum += (double) (i * aiCodeCounts[i]);
+    ui64Sum += (APP_UI64) i * piCodeCounts[i];
   }
-  dAverage = dSum / iLength;
 
-  return dAverage;
+  return (double) (ui64Sum * 257) / iLength;
 }
 
 
@@ -435,7 +539,7 @@ XMagicComputeRowAverage2(unsigned char *pucBuffer, int iLength)
 double
 XMagicComputeRowEntropy1(unsigned char *pucBuffer, int iLength)
 {
-  int                 aiCodeCounts[XMAGIC_ROW_ENTROPY_1_CODES];
+  int                *piCodeCounts = NULL;
   int                 i = 0;
   double              dEntropy = 0.0;
   double              dProbability = 0.0;
@@ -443,26 +547,11 @@ XMagicComputeRowEntropy1(unsigned char *pucBuffer, int iLength)
   /*-
    *********************************************************************
    *
-   * Clear the code counts array.
-   *
-   *********************************************************************
-   */
-  for (i = 0; i < XMAGIC_ROW_ENTROPY_1_CODES; i++)
-  {
-    aiCodeCounts[i] = 0;
-  }
-
-  /*-
-   *********************************************************************
-   *
-   * Tally up the the code counts.
+   * Get the code counts.
    *
    *********************************************************************
    */
-  for (i = 0; i < iLength; i++)
-  {
-    aiCodeCounts[pucBuffer[i]]++;
-  }
+  piCodeCounts = XMagicGetHistogram(pucBuffer, iLength);
 
   /*-
    *********************************************************************
@@ -473,9 +562,9 @@ XMagicComputeRowEntropy1(unsigned char *pucBuffer, int iLength)
    */
   for (i = 0; i < XMAGIC_ROW_ENTROPY_1_CODES; i++)
   {
-    if (aiCodeCounts[i] > 0)
+    if (piCodeCounts[i] > 0)
     {
-      dProbability = (double) aiCodeCounts[i] / iLength;
+      dProbability = (double) piCodeCounts[i] / iLength;
       dEntropy -= dProbability * log10(dProbability) * XMAGIC_LOG2_OF_10;
     }
   }
@@ -495,10 +584,43 @@ double
 XMagicComputeRowEntropy2(unsigned char *pucBuffer, int iLength)
 {
   int                 aiCodeCounts[XMAGIC_ROW_ENTROPY_2_CODES];
+  int                 aiCodes[XMAGIC_ROW_ENTROPY_2_SORT_LIMIT];
   int                 i = 0;
+  int                 j = 0;
   double              dEntropy = 0.0;
   double              dProbability = 0.0;
 
+  /*-
+   *********************************************************************
+   *
+   * For short rows, sort the codes rather than clearing and scanning
+   * a 64K-entry table. Runs of equal codes are then visited in the
+   * same ascending order as the table scan below, so both methods
+   * produce the same result. H(Px) = - Sigma Px * log2(Px)
+   *
+   *********************************************************************
+   */
+  if (iLength > 0 && iLength <= XMAGIC_ROW_ENTROPY_2_SORT_LIMIT)
+  {
+    for (i = 0; i < iLength - 1; i++)
+    {
+      aiCodes[i] = (pucBuffer[i] << 8) | pucBuffer[i + 1];
+    }
+    aiCodes[i] = (pucBuffer[i] << 8) | pucBuffer[0];
+    qsort(aiCodes, iLength, sizeof(int), XMagicCompareCodes);
+    for (i = 0; i < iLength; i = j)
+    {
+      j = i + 1;
+      while (j < iLength && aiCodes[j] == aiCodes[i])
+      {
+        j++;
+      }
+      dProbability = (double) (j - i) / iLength;
+      dEntropy -= dProbability * log10(dProbability) * XMAGIC_LOG2_OF_10;
+    }
+    return dEntropy;
+  }
+
   /*-
    *********************************************************************
    *
@@ -967,6 +1089,89 @@ XMagicFormatDescription(void *pvValue, XMAGIC *psXMagic, char *pcDescription)
 }
 
 
+/*-
+ ***********************************************************************
+ *
+ * XMagicFreeCache
+ *
+ ***********************************************************************
+ */
+void
+XMagicFreeCache(XMAGIC_CACHE *psCache)
+{
+  int                 i = 0;
+  XMAGIC_CACHE_ENTRY *psEntry = NULL;
+  XMAGIC_CACHE_ENTRY *psNext = NULL;
+
+  if (psCache != NULL)
+  {
+    if (psCache->ppsBuckets != NULL)
+    {
+      for (i = 0; i < XMAGIC_CACHE_BUCKETS; i++)
+      {
+        for (psEntry = psCache->ppsBuckets[i]; psEntry != NULL; psEntry = psNext)
+        {
+          psNext = psEntry->psNext;
+          if (psEntry->pcDescription != NULL)
+          {
+            free(psEntry->pcDescription);
+          }
+          free(psEntry);
+        }
+      }
+      free(psCache->ppsBuckets);
+    }
+    free(psCache);
+  }
+}
+
+
+/*-
+ ***********************************************************************
+ *
+ * XMagicFreeIndex
+ *
+ ***********************************************************************
+ */
+void
+XMagicFreeIndex(XMAGIC_INDEX *psIndex)
+{
+  int                 i = 0;
+  int                 iCode = 0;
+
+  if (psIndex != NULL)
+  {
+    for (i = 0; i < psIndex->iBucketCount; i++)
+    {
+      for (iCode = 0; iCode < XMAGIC_INDEX_BYTE_CODES; iCode++)
+      {
+        if (psIndex->psBuckets[i].asLists[iCode].piOrdinals != NULL)
+        {
+          free(psIndex->psBuckets[i].asLists[iCode].piOrdinals);
+        }
+      }
+    }
+    if (psIndex->sUnkeyed.piOrdinals != NULL)
+    {
+      free(psIndex->sUnkeyed.piOrdinals);
+    }
+    if (psIndex->psBuckets != NULL)
+    {
+      free(psIndex->psBuckets);
+    }
+    if (psIndex->psCursors != NULL)
+    {
+      free(psIndex->psCursors);
+    }
+    if (psIndex->ppsTests != NULL)
+    {
+      free(psIndex->ppsTests);
+    }
+    free(psIndex);
+  }
+}
+
+
 /*-
  ***********************************************************************
  *
@@ -997,6 +1202,7 @@ XMagicFreeXMagic(XMAGIC *psXMagic)
       free(psXMagic->psPcreExtra);
     }
 #endif
+    XMagicFreeIndex(psXMagic->psIndex);
     free(psXMagic);
   }
 }
@@ -1063,12 +1269,186 @@ XMagicGetDescription(char *pcS, char *pcE, XMAGIC *psXMagic, char *pcError)
 /*-
  ***********************************************************************
  *
- * XMagicGetLine
+ * XMagicGetHistogram
  *
  ***********************************************************************
  */
-char *
-XMagicGetLine(FILE *pFile, int iMaxLine, unsigned int uiFlags, int *piLinesConsumed, char *pcError)
+int *
+XMagicGetHistogram(unsigned char *pucBuffer, int iLength)
+{
+  int                 aaiLanes[XMAGIC_HISTOGRAM_LANES][XMAGIC_HISTOGRAM_CODES];
+  int                *piCodeCounts = gsXMagicHistogram.aiCodeCounts;
+  int                 i = 0;
+
+  /*-
+   *********************************************************************
+   *
+   * Entropy, average, and percent tests frequently examine the same
+   * region. If this region was already tallied for the current buffer,
+   * reuse the counts. The cache is invalidated by XMagicTestIndex()
+   * each time a new buffer is tested.
+   *
+   *********************************************************************
+   */
+  if (gsXMagicHistogram.iValid && gsXMagicHistogram.pucData == pucBuffer && gsXMagicHistogram.iLength == iLength)
+  {
+    return piCodeCounts;
+  }
+
+  /*-
+   *********************************************************************
+   *
+   * Tally up the code counts. Large regions are spread over several
+   * independent tables, which keeps back-to-back increments of the
+   * same byte value from stalling on one another. The tables are
+   * summed at the end in a loop that the compiler can vectorize.
+   *
+   *********************************************************************
+   */
+  if (iLength >= XMAGIC_HISTOGRAM_LANE_LIMIT)
+  {
+    memset(aaiLanes, 0, sizeof(aaiLanes));
+    for (i = 0; i + XMAGIC_HISTOGRAM_LANES <= iLength; i += XMAGIC_HISTOGRAM_LANES)
+    {
+      aaiLanes[0][pucBuffer[i    ]]++;
+      aaiLanes[1][pucBuffer[i + 1]]++;
+      aaiLanes[2][pucBuffer[i + 2]]++;
+      aaiLanes[3][pucBuffer[i + 3]]++;
+    }
+    for (; i < iLength; i++)
+    {
+      aaiLanes[0][pucBuffer[i]]++;
+    }
+    for (i = 0; i < XMAGIC_HISTOGRAM_CODES; i++)
+    {
+      piCodeCounts[i] = aaiLanes[0][i] + aaiLanes[1][i] + aaiLanes[2][i] + aaiLanes[3][i];
+    }
+  }
+  else
+  {
+    memset(piCodeCounts, 0, sizeof(gsXMagicHistogram.aiCodeCounts));
+    for (i = 0; i < iLength; i++)
+    {
+      piCodeCounts[pucBuffer[i]]++;
+    }
+  }
+  gsXMagicHistogram.pucData = pucBuffer;
+  gsXMagicHistogram.iLength = iLength;
+  gsXMagicHistogram.iValid = 1;
+
+  return piCodeCounts;
+}
+
+
+/*-
+ ***********************************************************************
+ *
+ * XMagicGetIndexKey
+ *
+ ***********************************************************************
+ */
+int
+XMagicGetIndexKey(XMAGIC *psXMagic, unsigned char *pucKey)
+{
+  APP_UI32            ui32Limit = 0;
+  APP_UI32            ui32Mask = 0xffffffff;
+  int                 iShift = 0;
+
+  /*-
+   *********************************************************************
+   *
+   * Only level zero equality tests at a fixed, non-negative offset can
+   * be keyed. A '&' warp is allowed as long as it preserves all bits
+   * in the key byte. Everything else must be evaluated for each
+   * buffer.
+   *
+   *********************************************************************
+   */
+  if (psXMagic->ui32Level != 0 || psXMagic->i32XOffset < 0 || psXMagic->iTestOperator != XMAGIC_OP_EQ)
+  {
+    return 0;
+  }
+  if (psXMagic->iWarpOperator == XMAGIC_WARP_OP_AND)
+  {
+    ui32Mask = psXMagic->ui32WarpValue;
+  }
+  else if (psXMagic->iWarpOperator != 0)
+  {
+    return 0;
+  }
+
+  /*-
+   *********************************************************************
+   *
+   * The key is the first byte of the value as it would appear in the
+   * buffer.
+   *
+   *********************************************************************
+   */
+  switch (psXMagic->iType)
+  {
+  case XMAGIC_STRING:
+    if (psXMagic->iStringLength < 1)
+    {
+      return 0;
+    }
+    *pucKey = psXMagic->sValue.ui8String[0];
+    return 1;
+    break;
+  case XMAGIC_BYTE:
+    ui32Limit = 0x000000ff;
+    iShift = 0;
+    break;
+  case XMAGIC_SHORT:
+    ui32Limit = 0x0000ffff;
+    iShift = (giSystemByteOrder == XMAGIC_MSB) ? 8 : 0;
+    break;
+  case XMAGIC_BESHORT:
+    ui32Limit = 0x0000ffff;
+    iShift = 8;
+    break;
+  case XMAGIC_LESHORT:
+    ui32Limit = 0x0000ffff;
+    iShift = 0;
+    break;
+  case XMAGIC_LONG:
+  case XMAGIC_DATE:
+    ui32Limit = 0xffffffff;
+    iShift = (giSystemByteOrder == XMAGIC_MSB) ? 24 : 0;
+    break;
+  case XMAGIC_BELONG:
+  case XMAGIC_BEDATE:
+    ui32Limit = 0xffffffff;
+    iShift = 24;
+    break;
+  case XMAGIC_LELONG:
+  case XMAGIC_LEDATE:
+    ui32Limit = 0xffffffff;
+    iShift = 0;
+    break;
+  default:
+    return 0;
+    break;
+  }
+  if (psXMagic->sValue.ui32Number > ui32Limit || ((ui32Mask >> iShift) & 0xff) != 0xff)
+  {
+    return 0;
+  }
+  *pucKey = (unsigned char) ((psXMagic->sValue.ui32Number >> iShift) & 0xff);
+
+  return 1;
+}
+
+
+/*-
+ ***********************************************************************
+ *
+ * XMagicGetLine
+ *
+ ***********************************************************************
+ */
+char *
+XMagicGetLine(FILE *pFile, int iMaxLine, unsigned int uiFlags, int *piLinesConsumed, char *pcError)
 {
   const char          acRoutine[] = "XMagicGetLine()";
   char               *pcComment = NULL;
@@ -1201,6 +1581,101 @@ XMagicGetLine(FILE *pFile, int iMaxLine, unsigned int uiFlags, int *piLinesConsu
 }
 
 
+/*-
+ ***********************************************************************
+ *
+ * XMagicGetMaxOffset
+ *
+ ***********************************************************************
+ */
+APP_SI64
+XMagicGetMaxOffset(XMAGIC *psXMagic)
+{
+  APP_SI64            i64Bound = 0;
+  APP_SI64            i64ParentOffset = 0;
+  APP_SI64            i64XOffset = 0;
+
+  /*-
+   *********************************************************************
+   *
+   * This routine mirrors XMagicGetValueOffset(), but it works on the
+   * largest values that could possibly be seen rather than the actual
+   * contents of a buffer. A return value of -1 means that the offset
+   * is not bounded (e.g., it was read through a long indirection).
+   *
+   *********************************************************************
+   */
+  if (psXMagic->ui32Level && psXMagic->psParent != NULL)
+  {
+    if
+    (
+      ((psXMagic->psParent)->ui32Flags & XMAGIC_RELATIVE_OFFSET) == XMAGIC_RELATIVE_OFFSET ||
+      ((psXMagic->psParent)->ui32Flags & XMAGIC_INDIRECT_OFFSET) == XMAGIC_INDIRECT_OFFSET
+    )
+    {
+      i64ParentOffset = XMagicGetMaxOffset(psXMagic->psParent);
+      if (i64ParentOffset < 0)
+      {
+        return -1;
+      }
+    }
+    else
+    {
+      i64ParentOffset = (psXMagic->psParent)->i32XOffset;
+    }
+  }
+
+  if (psXMagic->ui32Level && (psXMagic->ui32Flags & XMAGIC_INDIRECT_OFFSET) == XMAGIC_INDIRECT_OFFSET)
+  {
+    switch (psXMagic->sIndirection.iType)
+    {
+    case XMAGIC_BYTE:
+      i64Bound = 0xff;
+      break;
+    case XMAGIC_BESHORT:
+    case XMAGIC_LESHORT:
+      i64Bound = 0xffff;
+      break;
+    default:
+      return -1;
+      break;
+    }
+    switch (psXMagic->sIndirection.iOperator)
+    {
+    case XMAGIC_WARP_OP_AND:
+    case XMAGIC_WARP_OP_DIV:
+    case XMAGIC_WARP_OP_MOD:
+    case XMAGIC_WARP_OP_RSHIFT:
+      break;
+    case XMAGIC_WARP_OP_ADD:
+    case XMAGIC_WARP_OP_OR:
+    case XMAGIC_WARP_OP_XOR:
+      i64Bound += psXMagic->sIndirection.ui32Value;
+      break;
+    case XMAGIC_WARP_OP_LSHIFT:
+    case XMAGIC_WARP_OP_MUL:
+    case XMAGIC_WARP_OP_SUB:
+      return -1;
+      break;
+    default:
+      break;
+    }
+    i64XOffset = i64Bound;
+  }
+  else
+  {
+    i64XOffset = psXMagic->i32XOffset;
+  }
+
+  if (psXMagic->ui32Level && (psXMagic->ui32Flags & XMAGIC_RELATIVE_OFFSET) == XMAGIC_RELATIVE_OFFSET)
+  {
+    i64XOffset += i64ParentOffset;
+  }
+
+  return (i64XOffset < 0) ? 0 : i64XOffset;
+}
+
+
 /*-
  ***********************************************************************
  *
@@ -1476,6 +1951,128 @@ XMagicGetOffset(char *pcS, char *pcE, XMAGIC *psXMagic, char *pcError)
 }
 
 
+/*-
+ ***********************************************************************
+ *
+ * XMagicGetReach
+ *
+ ***********************************************************************
+ */
+int
+XMagicGetReach(XMAGIC *psXMagic)
+{
+  APP_SI64            i64Offset = 0;
+  APP_SI64            i64Reach = 0;
+  APP_SI64            i64Span = 0;
+  int                 iChildReach = 0;
+  XMAGIC             *psMagic = NULL;
+
+  /*-
+   *********************************************************************
+   *
+   * Walk the tree and determine how far into a buffer any test could
+   * look. Each test's reach is its largest absolute offset plus the
+   * number of bytes it examines there. Indirect tests also read their
+   * pointer, which is at most four bytes wide. A return value of -1
+   * means that the reach can't be bounded, and the whole buffer must
+   * be considered.
+   *
+   *********************************************************************
+   */
+  for (psMagic = psXMagic; psMagic != NULL; psMagic = psMagic->psSibling)
+  {
+    switch (psMagic->iType)
+    {
+#ifdef USE_KLEL
+    case XMAGIC_KLELEXP:
+      return -1;
+      break;
+#endif
+    case XMAGIC_NLEFT:
+      i64Span = 0;
+      break;
+    case XMAGIC_PSTRING:
+      i64Span = 1 + 0xff;
+      break;
+    case XMAGIC_STRING:
+      i64Span = (psMagic->iStringLength + 1 > XMAGIC_STRING_BUFSIZE) ? psMagic->iStringLength + 1 : XMAGIC_STRING_BUFSIZE;
+      break;
+    case XMAGIC_MD5:
+#ifdef USE_PCRE
+    case XMAGIC_REGEXP:
+#endif
+    case XMAGIC_PERCENT_COMBO_CSPDAE:
+    case XMAGIC_PERCENT_CTYPE_80_FF:
+    case XMAGIC_PERCENT_CTYPE_ALNUM:
+    case XMAGIC_PERCENT_CTYPE_ALPHA:
+    case XMAGIC_PERCENT_CTYPE_ASCII:
+    case XMAGIC_PERCENT_CTYPE_CNTRL:
+    case XMAGIC_PERCENT_CTYPE_DIGIT:
+    case XMAGIC_PERCENT_CTYPE_LOWER:
+    case XMAGIC_PERCENT_CTYPE_PRINT:
+    case XMAGIC_PERCENT_CTYPE_PUNCT:
+    case XMAGIC_PERCENT_CTYPE_SPACE:
+    case XMAGIC_PERCENT_CTYPE_UPPER:
+    case XMAGIC_ROW_AVERAGE_1:
+    case XMAGIC_ROW_AVERAGE_2:
+    case XMAGIC_ROW_ENTROPY_1:
+    case XMAGIC_ROW_ENTROPY_2:
+    case XMAGIC_SHA1:
+    case XMAGIC_SHA256:
+      i64Span = psMagic->ui32Size;
+      break;
+    default:
+      i64Span = sizeof(APP_UI64);
+      break;
+    }
+    i64Offset = XMagicGetMaxOffset(psMagic);
+    if (i64Offset < 0)
+    {
+      return -1;
+    }
+    if (i64Offset + i64Span > i64Reach)
+    {
+      i64Reach = i64Offset + i64Span;
+    }
+    if (psMagic->ui32Level && (psMagic->ui32Flags & XMAGIC_INDIRECT_OFFSET) == XMAGIC_INDIRECT_OFFSET)
+    {
+      i64Offset = psMagic->i32XOffset;
+      if ((psMagic->ui32Flags & XMAGIC_RELATIVE_X_OFFSET) == XMAGIC_RELATIVE_X_OFFSET && psMagic->psParent != NULL)
+      {
+        i64Offset = XMagicGetMaxOffset(psMagic->psParent);
+        if (i64Offset < 0)
+        {
+          return -1;
+        }
+        i64Offset += psMagic->i32XOffset;
+      }
+      if (i64Offset + (APP_SI64) sizeof(APP_UI32) > i64Reach)
+      {
+        i64Reach = i64Offset + sizeof(APP_UI32);
+      }
+    }
+    if (psMagic->psChild != NULL)
+    {
+      iChildReach = XMagicGetReach(psMagic->psChild);
+      if (iChildReach < 0)
+      {
+        return -1;
+      }
+      if (iChildReach > i64Reach)
+      {
+        i64Reach = iChildReach;
+      }
+    }
+    if (i64Reach > 0x7fffffff)
+    {
+      return -1;
+    }
+  }
+
+  return (int) i64Reach;
+}
+
+
 /*-
  ***********************************************************************
  *
@@ -2807,49 +3404,246 @@ XMagicGetValueOffset(unsigned char *pucBuffer, int iNRead, XMAGIC *psXMagic)
 /*-
  ***********************************************************************
  *
- * XMagicLoadMagic
+ * XMagicInsertCache
  *
  ***********************************************************************
  */
-XMAGIC *
-XMagicLoadMagic(char *pcFilename, char *pcError)
+int
+XMagicInsertCache(XMAGIC_CACHE *psCache, APP_UI64 ui64Size, int iLength, unsigned char *pucDigest, char *pcDescription, char *pcError)
 {
-  const char          acRoutine[] = "XMagicLoadMagic()";
-  char                acLocalError[MESSAGE_SIZE] = "";
-  char               *pcLine = NULL;
-  FILE               *pFile = NULL;
-  int                 iError = ER_OK;
-  int                 iFinalLineNumber = 0;
-  int                 iFirstLineNumber = 0;
-  int                 iLineNumber = 0;
-  int                 iLinesConsumed = 0;
-  int                 iParentExists = 0;
-  XMAGIC             *psHead = NULL;
-  XMAGIC             *psLast = NULL;
-  XMAGIC             *psXMagic = NULL;
-  APP_UI32           *pui32ByteOrderMagic = (APP_UI32 *) gaui08ByteOrderMagic;
-
-  giSystemByteOrder = (*pui32ByteOrderMagic == 0x01020304) ? XMAGIC_MSB : XMAGIC_LSB;
+  const char          acRoutine[] = "XMagicInsertCache()";
+  int                 iBucket = (pucDigest[0] << 8 | pucDigest[1]) & (XMAGIC_CACHE_BUCKETS - 1);
+  XMAGIC_CACHE_ENTRY *psEntry = NULL;
 
   /*-
    *********************************************************************
    *
-   * Make sure the file is magical.
+   * Once the cache is full, new results are simply not remembered.
    *
    *********************************************************************
    */
-  if ((pFile = fopen(pcFilename, "r")) == NULL)
+  if (psCache->iEntries >= XMAGIC_CACHE_MAX_ENTRIES)
   {
-    snprintf(pcError, MESSAGE_SIZE, "%s: fopen(): File = [%s]: %s", acRoutine, pcFilename, strerror(errno));
-    return NULL;
+    return ER_OK;
   }
-  pcLine = XMagicGetLine(pFile, XMAGIC_MAX_LINE, XMAGIC_PRESERVE_COMMENTS, &iLinesConsumed, acLocalError);
-  if (iLinesConsumed < 1)
+
+  psEntry = (XMAGIC_CACHE_ENTRY *) calloc(sizeof(XMAGIC_CACHE_ENTRY), 1);
+  if (psEntry == NULL)
   {
-    iFirstLineNumber = iLineNumber;
-    iFinalLineNumber = iLineNumber;
+    snprintf(pcError, MESSAGE_SIZE, "%s: calloc(): %s", acRoutine, strerror(errno));
+    return ER;
   }
-  else
+  psEntry->pcDescription = malloc(strlen(pcDescription) + 1);
+  if (psEntry->pcDescription == NULL)
+  {
+    snprintf(pcError, MESSAGE_SIZE, "%s: malloc(): %s", acRoutine, strerror(errno));
+    free(psEntry);
+    return ER;
+  }
+  strcpy(psEntry->pcDescription, pcDescription);
+  psEntry->ui64Size = ui64Size;
+  psEntry->iLength = iLength;
+  memcpy(psEntry->aucDigest, pucDigest, XMAGIC_CACHE_DIGEST_SIZE);
+  psEntry->psNext = psCache->ppsBuckets[iBucket];
+  psCache->ppsBuckets[iBucket] = psEntry;
+  psCache->iEntries++;
+  psCache->iInserts++;
+
+  return ER_OK;
+}
+
+
+/*-
+ ***********************************************************************
+ *
+ * XMagicLoadCache
+ *
+ ***********************************************************************
+ */
+XMAGIC_CACHE *
+XMagicLoadCache(char *pcFilename, char *pcMagicHash, char *pcError)
+{
+  const char          acRoutine[] = "XMagicLoadCache()";
+  char                acLine[XMAGIC_MAX_LINE];
+  char                acLocalError[MESSAGE_SIZE] = "";
+  char               *pcDescription = NULL;
+  char               *pcDigest = NULL;
+  char               *pcEnd = NULL;
+  FILE               *pFile = NULL;
+  int                 i = 0;
+  int                 iError = ER_OK;
+  int                 iLength = 0;
+  int                 iLineNumber = 0;
+  unsigned char       aucDigest[XMAGIC_CACHE_DIGEST_SIZE];
+  APP_UI64            ui64Size = 0;
+  XMAGIC_CACHE       *psCache = NULL;
+
+  psCache = XMagicNewCache(pcMagicHash, acLocalError);
+  if (psCache == NULL)
+  {
+    snprintf(pcError, MESSAGE_SIZE, "%s: %s", acRoutine, acLocalError);
+    return NULL;
+  }
+
+  /*-
+   *********************************************************************
+   *
+   * A missing cache file is not an error -- it will be created when
+   * the cache is saved.
+   *
+   *********************************************************************
+   */
+  if ((pFile = fopen(pcFilename, "r")) == NULL)
+  {
+    if (errno == ENOENT)
+    {
+      return psCache;
+    }
+    snprintf(pcError, MESSAGE_SIZE, "%s: fopen(): File = [%s]: %s", acRoutine, pcFilename, strerror(errno));
+    XMagicFreeCache(psCache);
+    return NULL;
+  }
+
+  /*-
+   *********************************************************************
+   *
+   * Check the header. If the cache was built with different magic,
+   * its entries are stale. In that case, start over with an empty
+   * cache.
+   *
+   *********************************************************************
+   */
+  if (fgets(acLine, XMAGIC_MAX_LINE, pFile) == NULL || strncmp(acLine, XMAGIC_CACHE_HEADER, strlen(XMAGIC_CACHE_HEADER)) != 0)
+  {
+    snprintf(pcError, MESSAGE_SIZE, "%s: File = [%s]: File has an invalid cache header.", acRoutine, pcFilename);
+    fclose(pFile);
+    XMagicFreeCache(psCache);
+    return NULL;
+  }
+  iLineNumber++;
+  if (fgets(acLine, XMAGIC_MAX_LINE, pFile) == NULL || strncmp(acLine, "MagicHash=", 10) != 0)
+  {
+    snprintf(pcError, MESSAGE_SIZE, "%s: File = [%s]: File has no magic hash.", acRoutine, pcFilename);
+    fclose(pFile);
+    XMagicFreeCache(psCache);
+    return NULL;
+  }
+  iLineNumber++;
+  acLine[strcspn(acLine, "\r\n")] = 0;
+  if (strcmp(&acLine[10], pcMagicHash) != 0)
+  {
+    fclose(pFile);
+    return psCache;
+  }
+
+  /*-
+   *********************************************************************
+   *
+   * Read the entries. Each one has the form size|length|md5|description.
+   *
+   *********************************************************************
+   */
+  while (fgets(acLine, XMAGIC_MAX_LINE, pFile) != NULL)
+  {
+    iLineNumber++;
+    acLine[strcspn(acLine, "\r\n")] = 0;
+    ui64Size = (APP_UI64) strtoull(acLine, &pcEnd, 10);
+    if (pcEnd == acLine || *pcEnd != '|')
+    {
+      iError = ER;
+      break;
+    }
+    iLength = (int) strtol(pcEnd + 1, &pcEnd, 10);
+    if (iLength < 1 || *pcEnd != '|')
+    {
+      iError = ER;
+      break;
+    }
+    pcDigest = pcEnd + 1;
+    for (i = 0; i < XMAGIC_CACHE_DIGEST_SIZE * 2; i++)
+    {
+      if (!isxdigit((int) pcDigest[i]))
+      {
+        break;
+      }
+    }
+    if (i != XMAGIC_CACHE_DIGEST_SIZE * 2 || pcDigest[i] != '|')
+    {
+      iError = ER;
+      break;
+    }
+    pcDigest[i] = 0;
+    pcDescription = &pcDigest[i + 1];
+    MD5HexToHash(pcDigest, aucDigest);
+    if (XMagicInsertCache(psCache, ui64Size, iLength, aucDigest, pcDescription, acLocalError) != ER_OK)
+    {
+      snprintf(pcError, MESSAGE_SIZE, "%s: File = [%s], Line = [%d]: %s", acRoutine, pcFilename, iLineNumber, acLocalError);
+      fclose(pFile);
+      XMagicFreeCache(psCache);
+      return NULL;
+    }
+  }
+  if (iError != ER_OK)
+  {
+    snprintf(pcError, MESSAGE_SIZE, "%s: File = [%s], Line = [%d]: Invalid cache entry.", acRoutine, pcFilename, iLineNumber);
+    fclose(pFile);
+    XMagicFreeCache(psCache);
+    return NULL;
+  }
+  fclose(pFile);
+
+  psCache->iInserts = 0; /* Only count entries added during this run. */
+
+  return psCache;
+}
+
+
+/*-
+ ***********************************************************************
+ *
+ * XMagicLoadMagic
+ *
+ ***********************************************************************
+ */
+XMAGIC *
+XMagicLoadMagic(char *pcFilename, char *pcError)
+{
+  const char          acRoutine[] = "XMagicLoadMagic()";
+  char                acLocalError[MESSAGE_SIZE] = "";
+  char               *pcLine = NULL;
+  FILE               *pFile = NULL;
+  int                 iError = ER_OK;
+  int                 iFinalLineNumber = 0;
+  int                 iFirstLineNumber = 0;
+  int                 iLineNumber = 0;
+  int                 iLinesConsumed = 0;
+  int                 iParentExists = 0;
+  XMAGIC             *psHead = NULL;
+  XMAGIC             *psLast = NULL;
+  XMAGIC             *psXMagic = NULL;
+  APP_UI32           *pui32ByteOrderMagic = (APP_UI32 *) gaui08ByteOrderMagic;
+
+  giSystemByteOrder = (*pui32ByteOrderMagic == 0x01020304) ? XMAGIC_MSB : XMAGIC_LSB;
+
+  /*-
+   *********************************************************************
+   *
+   * Make sure the file is magical.
+   *
+   *********************************************************************
+   */
+  if ((pFile = fopen(pcFilename, "r")) == NULL)
+  {
+    snprintf(pcError, MESSAGE_SIZE, "%s: fopen(): File = [%s]: %s", acRoutine, pcFilename, strerror(errno));
+    return NULL;
+  }
+  pcLine = XMagicGetLine(pFile, XMAGIC_MAX_LINE, XMAGIC_PRESERVE_COMMENTS, &iLinesConsumed, acLocalError);
+  if (iLinesConsumed < 1)
+  {
+    iFirstLineNumber = iLineNumber;
+    iFinalLineNumber = iLineNumber;
+  }
+  else
   {
     iFirstLineNumber = iLineNumber + 1;
     iFinalLineNumber = iLineNumber + iLinesConsumed;
@@ -3021,6 +3815,22 @@ XMagicLoadMagic(char *pcFilename, char *pcError)
     return NULL;
   }
 
+  /*-
+   *********************************************************************
+   *
+   * Compile the level zero tests into an index so that only plausible
+   * candidates are evaluated for a given buffer.
+   *
+   *********************************************************************
+   */
+  iError = XMagicCompileIndex(psHead, acLocalError);
+  if (iError != ER_OK)
+  {
+    snprintf(pcError, MESSAGE_SIZE, "%s: File = [%s]: %s", acRoutine, pcFilename, acLocalError);
+    XMagicFreeXMagic(psHead);
+    return NULL;
+  }
+
   return psHead;
 }
 
@@ -3307,6 +4117,84 @@ XMagicKlelStringAt(KLEL_VALUE **ppsArgs, void *pvContext)
 #endif
 
 
+/*-
+ ***********************************************************************
+ *
+ * XMagicLookupCache
+ *
+ ***********************************************************************
+ */
+char *
+XMagicLookupCache(XMAGIC_CACHE *psCache, APP_UI64 ui64Size, unsigned char *pucBuffer, int iLength, unsigned char *pucDigest)
+{
+  int                 iBucket = 0;
+  XMAGIC_CACHE_ENTRY *psEntry = NULL;
+
+  /*-
+   *********************************************************************
+   *
+   * Digest the part of the buffer that the magic can reach. The digest
+   * is returned to the caller so that it can be used to insert the
+   * result on a miss. The cache is only enabled when the reach is
+   * bounded, so this never digests more than that.
+   *
+   *********************************************************************
+   */
+  MD5HashString(pucBuffer, (psCache->iReach < iLength) ? psCache->iReach : iLength, pucDigest);
+  iBucket = (pucDigest[0] << 8 | pucDigest[1]) & (XMAGIC_CACHE_BUCKETS - 1);
+  for (psEntry = psCache->ppsBuckets[iBucket]; psEntry != NULL; psEntry = psEntry->psNext)
+  {
+    if
+    (
+      psEntry->ui64Size == ui64Size &&
+      psEntry->iLength == iLength &&
+      memcmp(psEntry->aucDigest, pucDigest, XMAGIC_CACHE_DIGEST_SIZE) == 0
+    )
+    {
+      psCache->iHits++;
+      return psEntry->pcDescription;
+    }
+  }
+
+  return NULL;
+}
+
+
+/*-
+ ***********************************************************************
+ *
+ * XMagicNewCache
+ *
+ ***********************************************************************
+ */
+XMAGIC_CACHE *
+XMagicNewCache(char *pcMagicHash, char *pcError)
+{
+  const char          acRoutine[] = "XMagicNewCache()";
+  XMAGIC_CACHE       *psCache = NULL;
+
+  psCache = (XMAGIC_CACHE *) calloc(sizeof(XMAGIC_CACHE), 1);
+  if (psCache == NULL)
+  {
+    snprintf(pcError, MESSAGE_SIZE, "%s: calloc(): %s", acRoutine, strerror(errno));
+    return NULL;
+  }
+
+  psCache->ppsBuckets = (XMAGIC_CACHE_ENTRY **) calloc(sizeof(XMAGIC_CACHE_ENTRY *), XMAGIC_CACHE_BUCKETS);
+  if (psCache->ppsBuckets == NULL)
+  {
+    snprintf(pcError, MESSAGE_SIZE, "%s: calloc(): %s", acRoutine, strerror(errno));
+    XMagicFreeCache(psCache);
+    return NULL;
+  }
+
+  snprintf(psCache->acMagicHash, sizeof(psCache->acMagicHash), "%s", pcMagicHash);
+  psCache->iReach = -1;
+
+  return psCache;
+}
+
+
 /*-
  ***********************************************************************
  *
@@ -3567,6 +4455,88 @@ XMagicParseLine(char *pcLine, char *pcError)
 }
 
 
+/*-
+ ***********************************************************************
+ *
+ * XMagicSaveCache
+ *
+ ***********************************************************************
+ */
+int
+XMagicSaveCache(XMAGIC_CACHE *psCache, char *pcFilename, char *pcError)
+{
+  const char          acRoutine[] = "XMagicSaveCache()";
+  char                acDigest[XMAGIC_CACHE_DIGEST_SIZE * 2 + 1];
+  char                acTempFile[FTIMES_MAX_PATH];
+  FILE               *pFile = NULL;
+  int                 i = 0;
+  int                 iError = 0;
+  XMAGIC_CACHE_ENTRY *psEntry = NULL;
+
+  /*-
+   *********************************************************************
+   *
+   * There's nothing to do if no new results were added.
+   *
+   *********************************************************************
+   */
+  if (psCache->iInserts == 0)
+  {
+    return ER_OK;
+  }
+
+  /*-
+   *********************************************************************
+   *
+   * Write the cache to a temporary file, and rename it into place so
+   * that an interrupted save never leaves a partial cache behind.
+   *
+   *********************************************************************
+   */
+  if (snprintf(acTempFile, FTIMES_MAX_PATH, "%s.tmp", pcFilename) >= FTIMES_MAX_PATH)
+  {
+    snprintf(pcError, MESSAGE_SIZE, "%s: File = [%s]: Filename is too long.", acRoutine, pcFilename);
+    return ER;
+  }
+  if ((pFile = fopen(acTempFile, "w")) == NULL)
+  {
+    snprintf(pcError, MESSAGE_SIZE, "%s: fopen(): File = [%s]: %s", acRoutine, acTempFile, strerror(errno));
+    return ER;
+  }
+  fprintf(pFile, "%s\nMagicHash=%s\n", XMAGIC_CACHE_HEADER, psCache->acMagicHash);
+  for (i = 0; i < XMAGIC_CACHE_BUCKETS; i++)
+  {
+    for (psEntry = psCache->ppsBuckets[i]; psEntry != NULL; psEntry = psEntry->psNext)
+    {
+      if (strpbrk(psEntry->pcDescription, "\r\n") != NULL)
+      {
+        continue; /* These can't be represented in a line-oriented file. */
+      }
+      MD5HashToHex(psEntry->aucDigest, acDigest);
+      fprintf(pFile, "%llu|%d|%s|%s\n", (unsigned long long) psEntry->ui64Size, psEntry->iLength, acDigest, psEntry->pcDescription);
+    }
+  }
+  iError = ferror(pFile);
+  if (fclose(pFile) != 0 || iError)
+  {
+    snprintf(pcError, MESSAGE_SIZE, "%s: File = [%s]: Unable to write cache.", acRoutine, acTempFile);
+    unlink(acTempFile);
+    return ER;
+  }
+#ifdef WIN32
+  unlink(pcFilename); /* The rename() will fail if the target exists. */
+#endif
+  if (rename(acTempFile, pcFilename) != 0)
+  {
+    snprintf(pcError, MESSAGE_SIZE, "%s: rename(): File = [%s]: %s", acRoutine, pcFilename, strerror(errno));
+    unlink(acTempFile);
+    return ER;
+  }
+
+  return ER_OK;
+}
+
+
 /*-
  ***********************************************************************
  *
@@ -4048,6 +5018,19 @@ XMagicTestMagic(XMAGIC *psXMagic, unsigned char *pucBuffer, int iNRead, char *pc
   APP_SI32            i32AbsoluteOffset = 0;
   XMAGIC             *psMyXMagic = NULL;
 
+  /*-
+   *********************************************************************
+   *
+   * If this is the head of a compiled tree, let the index select the
+   * level zero tests that are worth evaluating.
+   *
+   *********************************************************************
+   */
+  if (psXMagic != NULL && psXMagic->psIndex != NULL)
+  {
+    return XMagicTestIndex(psXMagic->psIndex, pucBuffer, iNRead, pcDescription, iBytesUsed, iBytesLeft, pcError);
+  }
+
   /*-
    *********************************************************************
    *
@@ -4068,6 +5051,34 @@ XMagicTestMagic(XMAGIC *psXMagic, unsigned char *pucBuffer, int iNRead, char *pc
    */
   for (psMyXMagic = psXMagic; psMyXMagic != NULL; psMyXMagic = psMyXMagic->psSibling)
   {
+    /*-
+     *******************************************************************
+     *
+     * Level zero tests are evaluated by XMagicTestLevelZero(), which
+     * is shared with XMagicTestIndex(). A level zero test either ends
+     * the traversal with a match (or error) or leaves the description
+     * buffer as it was, so there is nothing to accumulate here.
+     *
+     *******************************************************************
+     */
+    if (psMyXMagic->ui32Level == 0)
+    {
+      iMatch = XMagicTestLevelZero(psMyXMagic, pucBuffer, iNRead, pcDescription, iBytesUsed, iBytesLeft, acLocalError);
+      switch (iMatch)
+      {
+      case XMAGIC_TEST_ERROR:
+        snprintf(pcError, MESSAGE_SIZE, "%s: %s", acRoutine, acLocalError);
+        return XMAGIC_TEST_ERROR;
+        break;
+      case XMAGIC_TEST_MATCH:
+        return XMAGIC_TEST_MATCH;
+        break;
+      default:
+        continue;
+        break;
+      }
+    }
+
     /*-
      *******************************************************************
      *
@@ -4076,34 +5087,25 @@ XMagicTestMagic(XMAGIC *psXMagic, unsigned char *pucBuffer, int iNRead, char *pc
      * offset can legitimately be out of range if the buffer is too
      * small. If the fallback count is nonzero, clear any child data
      * that has accumulated in the description buffer, and return to
-     * the parent. If the current level is zero, there should not be
-     * anything in the description buffer, so just continue with the
-     * next sibling.
+     * the parent.
      *
      *******************************************************************
      */
     i32AbsoluteOffset = XMagicGetValueOffset(pucBuffer, iNRead, psMyXMagic);
     if (i32AbsoluteOffset < 0)
     {
-      if (psMyXMagic->ui32Level == 0)
+      if (psMyXMagic->ui32FallbackCount > 0)
       {
-        continue; /* This is either mode, and we're at the top of the tree, so continue with the next sibling. */
+        iMatches = 0;
+/* FIXME Need to check the number of bytes used/left before updating the buffer. */
+        *iBytesUsed = iOriginalBytesUsed;
+        *iBytesLeft = iOriginalBytesLeft;
+        pcDescription[*iBytesUsed] = 0;
+        return XMAGIC_TEST_FALSE; /* This is fallback mode, and we're not at the top of the tree, so return. */
       }
       else
       {
-        if (psMyXMagic->ui32FallbackCount > 0)
-        {
-          iMatches = 0;
-/* FIXME Need to check the number of bytes used/left before updating the buffer. */
-          *iBytesUsed = iOriginalBytesUsed;
-          *iBytesLeft = iOriginalBytesLeft;
-          pcDescription[*iBytesUsed] = 0;
-          return XMAGIC_TEST_FALSE; /* This is fallback mode, and we're not at the top of the tree, so return. */
-        }
-        else
-        {
-          continue; /* This is accumulate mode, and we're not at the top of the tree, so continue with the next sibling. */
-        }
+        continue; /* This is accumulate mode, and we're not at the top of the tree, so continue with the next sibling. */
       }
     }
 
@@ -4118,42 +5120,31 @@ XMagicTestMagic(XMAGIC *psXMagic, unsigned char *pucBuffer, int iNRead, char *pc
     switch (iMatch)
     {
     case XMAGIC_TEST_ERROR:
-      if (psMyXMagic->ui32Level == 0)
-      {
-        snprintf(pcError, MESSAGE_SIZE, "%s: %s", acRoutine, acLocalError);
-      }
-      else
-      {
-        snprintf(pcError, MESSAGE_SIZE, "%s", acLocalError);
-      }
+      snprintf(pcError, MESSAGE_SIZE, "%s", acLocalError);
       return XMAGIC_TEST_ERROR;
       break;
     case XMAGIC_TEST_FALSE:
-      if (psMyXMagic->ui32Level == 0)
+      if (psMyXMagic->ui32FallbackCount > 0)
       {
-        continue; /* This is either mode, and we're at the top of the tree, so continue with the next sibling. */
+        iMatches = 0;
+/* FIXME Need to check the number of bytes used/left before updating the buffer. */
+        *iBytesUsed = iOriginalBytesUsed;
+        *iBytesLeft = iOriginalBytesLeft;
+        pcDescription[*iBytesUsed] = 0;
+        return XMAGIC_TEST_FALSE; /* This is fallback mode, and we're not at the top of the tree, so return. */
       }
       else
       {
-        if (psMyXMagic->ui32FallbackCount > 0)
-        {
-          iMatches = 0;
-/* FIXME Need to check the number of bytes used/left before updating the buffer. */
-          *iBytesUsed = iOriginalBytesUsed;
-          *iBytesLeft = iOriginalBytesLeft;
-          pcDescription[*iBytesUsed] = 0;
-          return XMAGIC_TEST_FALSE; /* This is fallback mode, and we're not at the top of the tree, so return. */
-        }
-        else
-        {
-          continue; /* This is accumulate mode, and we're not at the top of the tree, so continue with the next sibling. */
-        }
+        continue; /* This is accumulate mode, and we're not at the top of the tree, so continue with the next sibling. */
       }
       break;
     case XMAGIC_TEST_MATCH:
       iMatches++;
-/* FIXME Need to check the number of bytes used/left before updating the buffer. */
       iLength = snprintf(&pcDescription[*iBytesUsed], *iBytesLeft, "%s", acDescriptionLocal);
+      if (iLength >= *iBytesLeft)
+      {
+        iLength = (*iBytesLeft > 0) ? *iBytesLeft - 1 : 0; /* The description was truncated. */
+      }
       *iBytesUsed += iLength;
       *iBytesLeft -= iLength;
       if (psMyXMagic->psChild != NULL)
@@ -4162,85 +5153,45 @@ XMagicTestMagic(XMAGIC *psXMagic, unsigned char *pucBuffer, int iNRead, char *pc
         switch (iChildMatch)
         {
         case XMAGIC_TEST_ERROR:
-          if (psMyXMagic->ui32Level == 0)
-          {
-            snprintf(pcError, MESSAGE_SIZE, "%s: %s", acRoutine, acLocalError);
-          }
-          else
-          {
-            snprintf(pcError, MESSAGE_SIZE, "%s", acLocalError);
-          }
+          snprintf(pcError, MESSAGE_SIZE, "%s", acLocalError);
           return XMAGIC_TEST_ERROR;
           break;
         case XMAGIC_TEST_FALSE:
-          if (psMyXMagic->ui32Level == 0)
+          if (psMyXMagic->ui32FallbackCount > 0)
           {
-            if (psMyXMagic->psChild->ui32FallbackCount > 0)
-            {
-              iMatches = 0;
+            iMatches = 0;
 /* FIXME Need to check the number of bytes used/left before updating the buffer. */
-              *iBytesUsed = iOriginalBytesUsed;
-              *iBytesLeft = iOriginalBytesLeft;
-              pcDescription[*iBytesUsed] = 0;
-              continue; /* This is fallback mode, and we're at the top of the tree, so continue with the next sibling. */
-            }
-            else
-            {
-              return XMAGIC_TEST_MATCH; /* This is accumulate mode, and we're at the top of the tree, so the overall result is a match. */
-            }
+            *iBytesUsed = iOriginalBytesUsed;
+            *iBytesLeft = iOriginalBytesLeft;
+            pcDescription[*iBytesUsed] = 0;
+            return XMAGIC_TEST_FALSE; /* The is fallback mode, and we're not at the top of the tree, so return. */
           }
           else
           {
-            if (psMyXMagic->ui32FallbackCount > 0)
-            {
-              iMatches = 0;
-/* FIXME Need to check the number of bytes used/left before updating the buffer. */
-              *iBytesUsed = iOriginalBytesUsed;
-              *iBytesLeft = iOriginalBytesLeft;
-              pcDescription[*iBytesUsed] = 0;
-              return XMAGIC_TEST_FALSE; /* The is fallback mode, and we're not at the top of the tree, so return. */
-            }
-            else
-            {
-              continue; /* This is accumulate mode, and we're not at the top of the tree, so continue with the next sibling. */
-            }
+            continue; /* This is accumulate mode, and we're not at the top of the tree, so continue with the next sibling. */
           }
           break;
         case XMAGIC_TEST_MATCH:
-          if (psMyXMagic->ui32Level == 0)
+          if (psMyXMagic->ui32FallbackCount > 0)
           {
-            return XMAGIC_TEST_MATCH; /* This is either mode, and we're at the top of the tree, so the overall result is a match. */
+            return XMAGIC_TEST_MATCH; /* This is fallback mode, and we're not at the top of the tree, so return. */
           }
           else
           {
-            if (psMyXMagic->ui32FallbackCount > 0)
-            {
-              return XMAGIC_TEST_MATCH; /* This is fallback mode, and we're not at the top of the tree, so return. */
-            }
-            else
-            {
-              continue; /* This is accumulate mode, and we're not at the top of the tree, so continue with the next sibling. */
-            }
+            continue; /* This is accumulate mode, and we're not at the top of the tree, so continue with the next sibling. */
           }
           break;
         }
       }
       else
       {
-        if (psMyXMagic->ui32Level == 0)
+        if (psMyXMagic->ui32FallbackCount > 0)
         {
-          return XMAGIC_TEST_MATCH; /* This is either mode, and we're at the top of the tree, so the overall result is a match. */
+          return XMAGIC_TEST_MATCH; /* This is fallback mode, and we're not at the top of the tree, so return. */
         }
         else
         {
-          if (psMyXMagic->ui32FallbackCount > 0)
-          {
-            return XMAGIC_TEST_MATCH; /* This is fallback mode, and we're not at the top of the tree, so return. */
-          }
-          else
-          {
-            continue; /* This is accumulate mode, and we're not at the top of the tree, so continue with the next sibling. */
-          }
+          continue; /* This is accumulate mode, and we're not at the top of the tree, so continue with the next sibling. */
         }
       }
       break;
@@ -4319,6 +5270,212 @@ XMagicTestHash(XMAGIC *psXMagic, unsigned char *pucBuffer, int iLength, APP_SI32
 }
 
 
+/*-
+ ***********************************************************************
+ *
+ * XMagicTestIndex
+ *
+ ***********************************************************************
+ */
+int
+XMagicTestIndex(XMAGIC_INDEX *psIndex, unsigned char *pucBuffer, int iNRead, char *pcDescription, int *iBytesUsed, int *iBytesLeft, char *pcError)
+{
+  const char          acRoutine[] = "XMagicTestIndex()";
+  char                acLocalError[MESSAGE_SIZE] = "";
+  int                 i = 0;
+  int                 iCursor = 0;
+  int                 iCursorCount = 0;
+  int                 iMatch = 0;
+  XMAGIC             *psMyXMagic = NULL;
+  XMAGIC_INDEX_BUCKET *psBucket = NULL;
+  XMAGIC_INDEX_LIST  *psCursors = psIndex->psCursors;
+
+  /*-
+   *********************************************************************
+   *
+   * A new buffer is being tested, so any histogram that was computed
+   * for the previous one is stale.
+   *
+   *********************************************************************
+   */
+  gsXMagicHistogram.iValid = 0;
+
+  /*-
+   *********************************************************************
+   *
+   * Gather the candidate lists. Each bucket contributes the list that
+   * corresponds to the byte found at its offset. Buckets whose offset
+   * is out of range are skipped because XMagicGetValueOffset() would
+   * reject their tests anyway.
+   *
+   *********************************************************************
+   */
+  for (i = 0; i < psIndex->iBucketCount; i++)
+  {
+    psBucket = &psIndex->psBuckets[i];
+    if (psBucket->i32Offset > (APP_SI32) (iNRead - sizeof(APP_UI32)))
+    {
+      continue;
+    }
+    if (psBucket->asLists[pucBuffer[psBucket->i32Offset]].iCount > 0)
+    {
+      psCursors[iCursorCount++] = psBucket->asLists[pucBuffer[psBucket->i32Offset]];
+    }
+  }
+  if (psIndex->sUnkeyed.iCount > 0)
+  {
+    psCursors[iCursorCount++] = psIndex->sUnkeyed;
+  }
+
+  /*-
+   *********************************************************************
+   *
+   * Merge the candidate lists by ordinal, and evaluate each candidate
+   * in file order using the same routine that XMagicTestMagic() uses
+   * for level zero tests.
+   *
+   *********************************************************************
+   */
+  while (1)
+  {
+    for (i = 0, iCursor = -1; i < iCursorCount; i++)
+    {
+      if (psCursors[i].iCount > 0 && (iCursor < 0 || psCursors[i].piOrdinals[0] < psCursors[iCursor].piOrdinals[0]))
+      {
+        iCursor = i;
+      }
+    }
+    if (iCursor < 0)
+    {
+      break;
+    }
+    psMyXMagic = psIndex->ppsTests[psCursors[iCursor].piOrdinals[0]];
+    psCursors[iCursor].piOrdinals++;
+    psCursors[iCursor].iCount--;
+
+    iMatch = XMagicTestLevelZero(psMyXMagic, pucBuffer, iNRead, pcDescription, iBytesUsed, iBytesLeft, acLocalError);
+    switch (iMatch)
+    {
+    case XMAGIC_TEST_ERROR:
+      snprintf(pcError, MESSAGE_SIZE, "%s: %s", acRoutine, acLocalError);
+      return XMAGIC_TEST_ERROR;
+      break;
+    case XMAGIC_TEST_MATCH:
+      return XMAGIC_TEST_MATCH;
+      break;
+    default:
+      continue;
+      break;
+    }
+  }
+
+  return XMAGIC_TEST_FALSE;
+}
+
+
+/*-
+ ***********************************************************************
+ *
+ * XMagicTestLevelZero
+ *
+ ***********************************************************************
+ */
+int
+XMagicTestLevelZero(XMAGIC *psXMagic, unsigned char *pucBuffer, int iNRead, char *pcDescription, int *iBytesUsed, int *iBytesLeft, char *pcError)
+{
+  const char          acRoutine[] = "XMagicTestLevelZero()";
+  char                acDescriptionLocal[XMAGIC_DESCRIPTION_BUFSIZE] = "";
+  char                acLocalError[MESSAGE_SIZE] = "";
+  int                 iChildMatch = 0;
+  int                 iLength = 0;
+  int                 iMatch = 0;
+  int                 iOriginalBytesUsed = *iBytesUsed;
+  int                 iOriginalBytesLeft = *iBytesLeft;
+  APP_SI32            i32AbsoluteOffset = 0;
+
+  /*-
+   *********************************************************************
+   *
+   * Evaluate a single level zero test and its children. A match means
+   * the caller is done. Otherwise, the description buffer is restored
+   * to its original state, and the caller should move on to the next
+   * test. An offset that is out of range is treated as a failed match.
+   *
+   *********************************************************************
+   */
+  i32AbsoluteOffset = XMagicGetValueOffset(pucBuffer, iNRead, psXMagic);
+  if (i32AbsoluteOffset < 0)
+  {
+    return XMAGIC_TEST_FALSE;
+  }
+
+  iMatch = XMagicTestValue(psXMagic, pucBuffer, iNRead, i32AbsoluteOffset, acDescriptionLocal, acLocalError);
+  switch (iMatch)
+  {
+  case XMAGIC_TEST_ERROR:
+    snprintf(pcError, MESSAGE_SIZE, "%s: %s", acRoutine, acLocalError);
+    return XMAGIC_TEST_ERROR;
+    break;
+  case XMAGIC_TEST_FALSE:
+    return XMAGIC_TEST_FALSE;
+    break;
+  default:
+    break;
+  }
+
+  /*-
+   *********************************************************************
+   *
+   * Append the description, but never claim more bytes than are left.
+   * The return value of snprintf() is the length that would have been
+   * written had there been enough room.
+   *
+   *********************************************************************
+   */
+  iLength = snprintf(&pcDescription[*iBytesUsed], *iBytesLeft, "%s", acDescriptionLocal);
+  if (iLength >= *iBytesLeft)
+  {
+    iLength = (*iBytesLeft > 0) ? *iBytesLeft - 1 : 0; /* The description was truncated. */
+  }
+  *iBytesUsed += iLength;
+  *iBytesLeft -= iLength;
+  if (psXMagic->psChild == NULL)
+  {
+    return XMAGIC_TEST_MATCH;
+  }
+
+  /*-
+   *********************************************************************
+   *
+   * A failed child only undoes the match in fallback mode. In
+   * accumulate mode, the level zero match stands on its own.
+   *
+   *********************************************************************
+   */
+  iChildMatch = XMagicTestMagic(psXMagic->psChild, pucBuffer, iNRead, pcDescription, iBytesUsed, iBytesLeft, acLocalError);
+  switch (iChildMatch)
+  {
+  case XMAGIC_TEST_ERROR:
+    snprintf(pcError, MESSAGE_SIZE, "%s: %s", acRoutine, acLocalError);
+    return XMAGIC_TEST_ERROR;
+    break;
+  case XMAGIC_TEST_FALSE:
+    if (psXMagic->psChild->ui32FallbackCount > 0)
+    {
+      *iBytesUsed = iOriginalBytesUsed;
+      *iBytesLeft = iOriginalBytesLeft;
+      pcDescription[*iBytesUsed] = 0;
+      return XMAGIC_TEST_FALSE;
+    }
+    break;
+  default:
+    break;
+  }
+
+  return XMAGIC_TEST_MATCH;
+}
+
+
 /*-
  ***********************************************************************
  *
@@ -29,6 +29,11 @@
 #define XMAGIC_CURRENT_LOCATION ".\\xmagic"
 #endif
 
+#define XMAGIC_CACHE_BUCKETS        65536
+#define XMAGIC_CACHE_DIGEST_SIZE       16 /* MD5 */
+#define XMAGIC_CACHE_HEADER "# XMagic Cache"
+#define XMAGIC_CACHE_MAX_ENTRIES  1000000
+
 #define XMAGIC_DEFAULT     "other/unknown"
 #define XMAGIC_ISEMPTY       "other/empty"
 
@@ -37,11 +42,16 @@
 
 #define XMAGIC_PERCENT_COMBO_CSPDAE_SLOTS 6
 
+#define XMAGIC_HISTOGRAM_CODES        256
+#define XMAGIC_HISTOGRAM_LANES          4
+#define XMAGIC_HISTOGRAM_LANE_LIMIT  1024
+#define XMAGIC_INDEX_BYTE_CODES       256
 #define XMAGIC_PERCENT_1BYTE_CODES    256
 #define XMAGIC_ROW_AVERAGE_1_CODES    256
 #define XMAGIC_ROW_AVERAGE_2_CODES  65536
 #define XMAGIC_ROW_ENTROPY_1_CODES    256
 #define XMAGIC_ROW_ENTROPY_2_CODES  65536
+#define XMAGIC_ROW_ENTROPY_2_SORT_LIMIT 4096
 #define XMAGIC_LOG2_OF_10 3.32192809488736234787 /* log2(10) = ln(10)/ln(2) */
 #define XMAGIC_LSB                      0
 #define XMAGIC_MSB                      1
@@ -114,6 +124,65 @@ typedef struct _XMAGIC_KLEL_TYPE_SPEC
 } XMAGIC_KLEL_TYPE_SPEC;
 #endif
 
+/*-
+ ***********************************************************************
+ *
+ * The meaning of XMAGIC_CACHE...
+ *
+ * acMagicHash        MD5 of the magic file that produced the entries
+ * iEntries           Number of entries in the cache
+ * iHits              Number of successful lookups
+ * iInserts           Number of entries added since the cache was loaded
+ * iReach             Number of leading bytes the magic can examine (-1 if unbounded)
+ * ppsBuckets         Hash buckets (keyed on the leading digest bytes)
+ *
+ * Entries are keyed on the size of the file, the number of bytes that
+ * were tested, and the MD5 of those bytes that lie within reach of the
+ * magic tree. Since the key covers all of the data that the tree can
+ * see, a hit always yields the same description that a full evaluation
+ * would.
+ *
+ ***********************************************************************
+ */
+typedef struct _XMAGIC_CACHE_ENTRY
+{
+  struct _XMAGIC_CACHE_ENTRY *psNext;
+  APP_UI64            ui64Size;
+  int                 iLength;
+  unsigned char       aucDigest[XMAGIC_CACHE_DIGEST_SIZE];
+  char               *pcDescription;
+} XMAGIC_CACHE_ENTRY;
+
+typedef struct _XMAGIC_CACHE
+{
+  char                acMagicHash[XMAGIC_CACHE_DIGEST_SIZE * 2 + 1];
+  int                 iEntries;
+  int                 iHits;
+  int                 iInserts;
+  int                 iReach;
+  XMAGIC_CACHE_ENTRY **ppsBuckets;
+} XMAGIC_CACHE;
+
+/*-
+ ***********************************************************************
+ *
+ * The meaning of XMAGIC_HISTOGRAM...
+ *
+ * pucData            Start of the region that was tallied
+ * iLength            Length of the region that was tallied
+ * iValid             Set when the counts belong to the current buffer
+ * aiCodeCounts       Number of times each byte value occurs in the region
+ *
+ ***********************************************************************
+ */
+typedef struct _XMAGIC_HISTOGRAM
+{
+  unsigned char      *pucData;
+  int                 iLength;
+  int                 iValid;
+  int                 aiCodeCounts[XMAGIC_HISTOGRAM_CODES];
+} XMAGIC_HISTOGRAM;
+
 typedef enum _XMAGIC_TEST_OPERATORS
 {
   XMAGIC_OP_AND = 0,   /* '&'         */
@@ -258,6 +327,7 @@ typedef struct _XMAGIC_VALUE
  * dPercent           Percent computed over ui32Size bytes at i32XOffset
  * iStringLength      Length of sValue.ui8String
  * pcHash             Computed hash (MD5, SHA1, SHA256, etc.)
+ * psIndex            Compiled index of level zero tests (head of the tree only)
  *
  ***********************************************************************
  */
@@ -296,8 +366,51 @@ typedef struct _XMAGIC
 #ifdef USE_KLEL
   KLEL_CONTEXT       *psKlelContext;
 #endif
+  struct _XMAGIC_INDEX *psIndex;
 } XMAGIC;
 
+/*-
+ ***********************************************************************
+ *
+ * The meaning of XMAGIC_INDEX...
+ *
+ * iBucketCount       Number of distinct offsets used by keyed tests
+ * iTestCount         Number of level zero tests
+ * ppsTests           Level zero tests in file order (indexed by ordinal)
+ * psBuckets          Per-offset jump tables -- one candidate list for
+ *                    each value of the byte found at that offset
+ * psCursors          Scratch space used to merge candidate lists
+ * sUnkeyed           Tests that must always be evaluated
+ *
+ * A level zero test is keyed when its outcome depends on the value of
+ * a single byte at a fixed offset (e.g., an equality test on a byte,
+ * short, long, or string). Candidate lists hold test ordinals in
+ * ascending order, so merging them preserves the file's test order.
+ *
+ ***********************************************************************
+ */
+typedef struct _XMAGIC_INDEX_LIST
+{
+  int                 iCount;
+  int                *piOrdinals;
+} XMAGIC_INDEX_LIST;
+
+typedef struct _XMAGIC_INDEX_BUCKET
+{
+  APP_SI32            i32Offset;
+  XMAGIC_INDEX_LIST   asLists[XMAGIC_INDEX_BYTE_CODES];
+} XMAGIC_INDEX_BUCKET;
+
+typedef struct _XMAGIC_INDEX
+{
+  int                 iBucketCount;
+  int                 iTestCount;
+  XMAGIC            **ppsTests;
+  XMAGIC_INDEX_BUCKET *psBuckets;
+  XMAGIC_INDEX_LIST  *psCursors;
+  XMAGIC_INDEX_LIST   sUnkeyed;
+} XMAGIC_INDEX;
+
 /*-
  ***********************************************************************
  *
@@ -309,6 +422,8 @@ int                 is80_ff(int c);
 #if defined(USE_KLEL) && !defined(HAVE_STRNLEN)
 size_t              strnlen(const char *pcString, size_t szMaxLength);
 #endif
+int                 XMagicCompareCodes(const void *pvCode1, const void *pvCode2);
+int                 XMagicCompileIndex(XMAGIC *psXMagic, char *pcError);
 double              XMagicComputePercentage(unsigned char *pucBuffer, int iLength, int iType);
 char               *XMagicComputePercentageCombos(unsigned char *pucBuffer, int iLength, int iType);
 double              XMagicComputeRowAverage1(unsigned char *pucBuffer, int iLength);
@@ -319,14 +434,21 @@ int                 XMagicConvert2charHex(char *pcSRC, char *pcDST);
 int                 XMagicConvert3charOct(char *pcSRC, char *pcDST);
 int                 XMagicConvertHexToInt(int iC);
 void                XMagicFormatDescription(void *pvValue, XMAGIC *psXMagic, char *pcDescription);
+void                XMagicFreeCache(XMAGIC_CACHE *psCache);
+void                XMagicFreeIndex(XMAGIC_INDEX *psIndex);
 void                XMagicFreeXMagic(XMAGIC *psXMagic);
 int                 XMagicGetDescription(char *pcS, char *pcE, XMAGIC *psXMagic, char *pcError);
+int                *XMagicGetHistogram(unsigned char *pucBuffer, int iLength);
+int                 XMagicGetIndexKey(XMAGIC *psXMagic, unsigned char *pucKey);
 char               *XMagicGetLine(FILE *pFile, int iMaxLine, unsigned int uiFlags, int *piLinesConsumed, char *pcError);
+APP_SI64            XMagicGetMaxOffset(XMAGIC *psXMagic);
 int                 XMagicGetOffset(char *pcS, char *pcE, XMAGIC *psXMagic, char *pcError);
+int                 XMagicGetReach(XMAGIC *psXMagic);
 int                 XMagicGetTestOperator(char *pcS, char *pcE, XMAGIC *psXMagic, char *pcError);
 int                 XMagicGetTestValue(char *pcS, char *pcE, XMAGIC *psXMagic, char *pcError);
 int                 XMagicGetType(char *pcS, char *pcE, XMAGIC *psXMagic, char *pcError);
 APP_SI32            XMagicGetValueOffset(unsigned char *pucBuffer, int iNRead, XMAGIC *psXMagic);
+XMAGIC_CACHE       *XMagicLoadCache(char *pcFilename, char *pcMagicHash, char *pcError);
 XMAGIC             *XMagicLoadMagic(char *pcFilename, char *pcError);
 #ifdef USE_KLEL
 KLEL_VALUE         *XMagicKlelBeLongAt(KLEL_VALUE **ppsArgs, void *pvContext);
@@ -339,8 +461,12 @@ KLEL_VALUE         *XMagicKlelLeLongAt(KLEL_VALUE **ppsArgs, void *pvContext);
 KLEL_VALUE         *XMagicKlelLeShortAt(KLEL_VALUE **ppsArgs, void *pvContext);
 KLEL_VALUE         *XMagicKlelStringAt(KLEL_VALUE **ppsArgs, void *pvContext);
 #endif
+int                 XMagicInsertCache(XMAGIC_CACHE *psCache, APP_UI64 ui64Size, int iLength, unsigned char *pucDigest, char *pcDescription, char *pcError);
+char               *XMagicLookupCache(XMAGIC_CACHE *psCache, APP_UI64 ui64Size, unsigned char *pucBuffer, int iLength, unsigned char *pucDigest);
+XMAGIC_CACHE       *XMagicNewCache(char *pcMagicHash, char *pcError);
 XMAGIC             *XMagicNewXMagic(char *pcError);
 XMAGIC             *XMagicParseLine(char *pcLine, char *pcError);
+int                 XMagicSaveCache(XMAGIC_CACHE *psCache, char *pcFilename, char *pcError);
 int                 XMagicStringToUi64(char *pcNumber, APP_UI64 *pui64Value);
 APP_UI16            XMagicSwapUi16(APP_UI16 ui16Value, APP_UI32 ui32MagicType);
 APP_UI32            XMagicSwapUi32(APP_UI32 ui32Value, APP_UI32 ui32MagicType);
@@ -350,6 +476,8 @@ int                 XMagicTestBuffer(XMAGIC *psXMagic, unsigned char *pucBuffer,
 int                 XMagicTestEntropy(XMAGIC *psXMagic, unsigned char *pucBuffer, int iLength, APP_SI32 iOffset, char *pcError);
 int                 XMagicTestFile(XMAGIC *psXMagic, char *pcFilename, char *pcDescription, int iDescriptionLength, char *pcError);
 int                 XMagicTestHash(XMAGIC *psXMagic, unsigned char *pucBuffer, int iLength, APP_SI32 iOffset, char *pcError);
+int                 XMagicTestIndex(XMAGIC_INDEX *psIndex, unsigned char *pucBuffer, int iNRead, char *pcDescription, int *iBytesUsed, int *iBytesLeft, char *pcError);
+int                 XMagicTestLevelZero(XMAGIC *psXMagic, unsigned char *pucBuffer, int iNRead, char *pcDescription, int *iBytesUsed, int *iBytesLeft, char *pcError);
 int                 XMagicTestMagic(XMAGIC *psXMagic, unsigned char *pucBuffer, int iNRead, char *pcDescription, int *iBytesUsed, int *iBytesLeft, char *pcError);
 int                 XMagicTestNumber(XMAGIC *psXMagic, APP_UI32 ui32Value);
 int                 XMagicTestNumber64(XMAGIC *psXMagic, APP_UI64 ui64Value);
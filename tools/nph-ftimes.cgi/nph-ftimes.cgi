@@ -35,6 +35,7 @@ use Fcntl qw(:flock);
     '455' => "Content-Length Exceeds Limit",
     '456' => "Content-Length Mismatch",
     '457' => "File Not Available",
+    '458' => "Content-Encoding Not Supported",
     '460' => "RequiredMask-FieldMask Mismatch",
     '500' => "Internal Server Error",
     '550' => "Internal Server Initialization Error",
@@ -75,6 +76,12 @@ use Fcntl qw(:flock);
       $hProperties{'ReturnReason'} = $hReturnCodes{$hProperties{'ReturnStatus'}};
       $hProperties{'ErrorMessage'} = $sLocalError;
     }
+    elsif ($hProperties{'RequestMethod'} eq "PUT" && defined($hProperties{'QueryString'}) && $hProperties{'QueryString'} =~ /&STREAM=/)
+    {
+      $hProperties{'ReturnStatus'} = ProcessStreamRequest(\%hProperties, \$sLocalError);
+      $hProperties{'ReturnReason'} = $hReturnCodes{$hProperties{'ReturnStatus'}};
+      $hProperties{'ErrorMessage'} = $sLocalError;
+    }
     elsif ($hProperties{'RequestMethod'} eq "PUT")
     {
       $hProperties{'ReturnStatus'} = ProcessPutRequest(\%hProperties, \$sLocalError);
@@ -298,7 +305,8 @@ sub CreateRunTimeEnvironment
     'Request'   => qq(&REQUEST=(Map(?:Full|Lean)?Config|Dig(?:Full|Lean)?Config)),
     'RunType'   => qq(&RUNTYPE=(baseline|linktest|snapshot)),
     'SOL'       => qq(^),
-    'Version'   => qq(VERSION=(ftimes[\\w (),.-]{1,64})),
+    'Stream'    => qq(&STREAM=(chunked)),
+    'Version'   => qq(VERSION=(ftimes[\\w (),.-]{1,128})),
   );
 
   $$phProperties{'GETRegex'} =
@@ -332,19 +340,49 @@ sub CreateRunTimeEnvironment
     $hRegexes{'EOL'}
     ;
 
+  $$phProperties{'STREAMRegex'} =
+    $hRegexes{'SOL'} .
+    $hRegexes{'Version'} .
+    $hRegexes{'ClientId'} .
+    $hRegexes{'DataType'} .
+    $hRegexes{'FieldMask'} .
+    $hRegexes{'RunType'} .
+    $hRegexes{'DateTime'} .
+    $hRegexes{'Stream'} .
+    $hRegexes{'EOL'}
+    ;
+
+  ####################################################################
+  #
+  # Streamed uploads end with a fixed-size trailer that carries the
+  # stream lengths and digest (e.g., LOGLENGTH=n&OUTLENGTH=n&MD5=x),
+  # padded with spaces and terminated with a newline.
+  #
+  ####################################################################
+
+  $$phProperties{'StreamTrailerSize'} = 128;
+
+  $$phProperties{'TrailerRegex'} =
+    qq(^LOGLENGTH=(\\d{1,20})) .
+    qq(&OUTLENGTH=(\\d{1,20})) .
+    qq(&MD5=([0-9a-fA-F]{32})) .
+    qq( *\n\$)
+    ;
+
   ####################################################################
   #
   # Initialize environment-specific variables.
   #
   ####################################################################
 
-  $$phProperties{'ContentLength'}  = $ENV{'CONTENT_LENGTH'};
-  $$phProperties{'QueryString'}    = $ENV{'QUERY_STRING'};
-  $$phProperties{'RemoteAddress'}  = $ENV{'REMOTE_ADDR'};
-  $$phProperties{'RemoteUser'}     = $ENV{'REMOTE_USER'};
-  $$phProperties{'RequestMethod'}  = $ENV{'REQUEST_METHOD'};
-  $$phProperties{'ServerSoftware'} = $ENV{'SERVER_SOFTWARE'};
-  $$phProperties{'PropertiesFile'} = $ENV{'FTIMES_PROPERTIES_FILE'};
+  $$phProperties{'ContentEncoding'} = $ENV{'HTTP_CONTENT_ENCODING'};
+  $$phProperties{'ContentLength'}    = $ENV{'CONTENT_LENGTH'};
+  $$phProperties{'QueryString'}      = $ENV{'QUERY_STRING'};
+  $$phProperties{'RemoteAddress'}    = $ENV{'REMOTE_ADDR'};
+  $$phProperties{'RemoteUser'}       = $ENV{'REMOTE_USER'};
+  $$phProperties{'RequestMethod'}    = $ENV{'REQUEST_METHOD'};
+  $$phProperties{'ServerSoftware'}   = $ENV{'SERVER_SOFTWARE'};
+  $$phProperties{'PropertiesFile'}   = $ENV{'FTIMES_PROPERTIES_FILE'};
 
   ####################################################################
   #
@@ -1099,6 +1137,274 @@ sub ProcessPutRequest
 }
 
 
+######################################################################
+#
+# ProcessStreamRequest
+#
+######################################################################
+
+sub ProcessStreamRequest
+{
+  my ($phProperties, $psError) = @_;
+
+  ####################################################################
+  #
+  # Proceed only if QueryString matches STREAMRegex.
+  #
+  ####################################################################
+
+  my $sQueryString = URLDecode($$phProperties{'QueryString'});
+
+  if ($sQueryString =~ /$$phProperties{'STREAMRegex'}/)
+  {
+    $$phProperties{'ClientVersion'}   = $1;
+    $$phProperties{'ClientId'}        = $2 || "nobody";
+    $$phProperties{'ClientDataType'}  = $3;
+    $$phProperties{'ClientFieldMask'} = $4;
+    $$phProperties{'ClientRunType'}   = $5;
+    $$phProperties{'ClientDateTime'}  = $6;
+
+    $$phProperties{'ClientFilename'} = $$phProperties{'ClientId'} . "_" . $$phProperties{'ClientDateTime'} . "_" . $$phProperties{'ClientRunType'};
+
+    ##################################################################
+    #
+    # Do username and client ID checks.
+    #
+    ##################################################################
+
+    if ($$phProperties{'RequireUser'} =~ /^[Yy]$/ && (!defined($$phProperties{'RemoteUser'}) || !length($$phProperties{'RemoteUser'})))
+    {
+      $$psError = "Remote user is undefined or null";
+      return 452;
+    }
+
+    if ($$phProperties{'RequireUser'} =~ /^[Yy]$/ && $$phProperties{'RequireMatch'} =~ /^[Yy]$/ && $$phProperties{'RemoteUser'} ne $$phProperties{'ClientId'})
+    {
+      $$psError = "Remote user ($$phProperties{'RemoteUser'}) does not match client ID ($$phProperties{'ClientId'})";
+      return 453;
+    }
+
+    ##################################################################
+    #
+    # Do field mask check.
+    #
+    ##################################################################
+
+    if ($$phProperties{'RequireMask'} =~ /^[Yy]$/)
+    {
+      my $sRequiredMask = ($$phProperties{'ClientDataType'} =~ /^map$/i) ? $$phProperties{'RequiredMapMask'} : $$phProperties{'RequiredDigMask'};
+      if (!CompareMasks($sRequiredMask, $$phProperties{'ClientFieldMask'}))
+      {
+        $$psError = "Field mask ($$phProperties{'ClientFieldMask'}) does not match required field mask ($sRequiredMask)";
+        return 460;
+      }
+    }
+
+    ##################################################################
+    #
+    # Do content encoding check. Only gzip is decoded.
+    #
+    ##################################################################
+
+    my $sContentEncoding = (defined($$phProperties{'ContentEncoding'}) && length($$phProperties{'ContentEncoding'})) ? lc($$phProperties{'ContentEncoding'}) : "identity";
+
+    if ($sContentEncoding !~ /^(?:gzip|identity)$/)
+    {
+      $$psError = "Content encoding ($sContentEncoding) is not supported";
+      SysReadWrite(\*STDIN, undef, undef, undef); # Slurp up data to prevent a broken pipe.
+      return 458;
+    }
+
+    ##################################################################
+    #
+    # If this is a link test, dump the data and return success.
+    #
+    ##################################################################
+
+    if ($$phProperties{'ClientRunType'} eq "linktest")
+    {
+      SysReadWrite(\*STDIN, undef, undef, undef); # Slurp up data to prevent a broken pipe.
+      $$psError = "Success";
+      return 251;
+    }
+
+    ##################################################################
+    #
+    # Make output filenames.
+    #
+    ##################################################################
+
+    my ($sLckFile, $sLogFile, $sOutFile, $sRdyFile);
+
+    $sLckFile = $$phProperties{'IncomingDirectory'} . "/" . $$phProperties{'ClientFilename'} . ".lck";
+    $sLogFile = $$phProperties{'IncomingDirectory'} . "/" . $$phProperties{'ClientFilename'} . ".log";
+    $sOutFile = $$phProperties{'IncomingDirectory'} . "/" . $$phProperties{'ClientFilename'} . "." . $$phProperties{'ClientDataType'};
+    $sRdyFile = $$phProperties{'IncomingDirectory'} . "/" . $$phProperties{'ClientFilename'} . ".rdy";
+
+    ##################################################################
+    #
+    # Create a group lockfile and lock it.
+    #
+    ##################################################################
+
+    if (!open(LH, "> $sLckFile"))
+    {
+      $$psError = "File ($sLckFile) could not be opened ($!)";
+      SysReadWrite(\*STDIN, undef, undef, undef); # Slurp up data to prevent a broken pipe.
+      return 500;
+    }
+    flock(LH, LOCK_EX);
+
+    ##################################################################
+    #
+    # Make sure that none of the output files exist.
+    #
+    ##################################################################
+
+    foreach my $sPutFile ($sOutFile, $sLogFile, $sRdyFile)
+    {
+      if (-e $sPutFile)
+      {
+        $$psError = "File ($sPutFile) already exists";
+        SysReadWrite(\*STDIN, undef, undef, undef); # Slurp up data to prevent a broken pipe.
+        flock(LH, LOCK_UN); close(LH); unlink($sLckFile); # Unlock, close, and remove the group lockfile.
+        return 451;
+      }
+    }
+
+    ##################################################################
+    #
+    # Write the body to the output file as it arrives. The body holds
+    # the out data, the log data, and a fixed-size trailer with the
+    # stream lengths. The lengths aren't known until the end, so the
+    # log data and trailer are split off once the body is complete.
+    # A gzip-encoded body is decoded on the way in, so the limit and
+    # all lengths below refer to decoded data.
+    #
+    ##################################################################
+
+    my ($sByteCount, $sLimit, $sLocalError);
+
+    $sLimit = ($$phProperties{'CapContentLength'} =~ /^[Yy]$/) ? $$phProperties{'MaxContentLength'} + $$phProperties{'StreamTrailerSize'} + 1 : undef;
+
+    if (!open(FH, "+> $sOutFile"))
+    {
+      $$psError = "File ($sOutFile) could not be opened ($!)";
+      SysReadWrite(\*STDIN, undef, undef, undef); # Slurp up data to prevent a broken pipe.
+      flock(LH, LOCK_UN); close(LH); unlink($sLckFile); # Unlock, close, and remove the group lockfile.
+      return 500;
+    }
+    binmode(FH);
+    flock(FH, LOCK_EX);
+    $sByteCount = ($sContentEncoding eq "gzip") ? SysReadInflateWrite(\*STDIN, \*FH, $sLimit, \$sLocalError) : SysReadWrite(\*STDIN, \*FH, $sLimit, \$sLocalError);
+    if (!defined($sByteCount))
+    {
+      $$psError = $sLocalError;
+      SysReadWrite(\*STDIN, undef, undef, undef); # Slurp up data to prevent a broken pipe.
+      flock(FH, LOCK_UN); close(FH); unlink($sOutFile);
+      flock(LH, LOCK_UN); close(LH); unlink($sLckFile); # Unlock, close, and remove the group lockfile.
+      return 500;
+    }
+    $$phProperties{'ContentLength'}    = $sByteCount;
+
+    if (defined($sLimit) && $sByteCount >= $sLimit)
+    {
+      $$psError = "Content length exceeds maximum allowed length ($$phProperties{'MaxContentLength'})";
+      SysReadWrite(\*STDIN, undef, undef, undef); # Slurp up data to prevent a broken pipe.
+      flock(FH, LOCK_UN); close(FH); unlink($sOutFile);
+      flock(LH, LOCK_UN); close(LH); unlink($sLckFile); # Unlock, close, and remove the group lockfile.
+      return 455;
+    }
+
+    ##################################################################
+    #
+    # Read and check the trailer. A broken connection shows up here as
+    # a missing trailer.
+    #
+    ##################################################################
+
+    my ($sLogLength, $sOutLength, $sTrailer);
+
+    $sTrailer = "";
+    if ($sByteCount >= $$phProperties{'StreamTrailerSize'})
+    {
+      sysseek(FH, $sByteCount - $$phProperties{'StreamTrailerSize'}, 0);
+      sysread(FH, $sTrailer, $$phProperties{'StreamTrailerSize'});
+    }
+    if ($sTrailer !~ /$$phProperties{'TrailerRegex'}/)
+    {
+      $$psError = "Stream trailer is missing or invalid";
+      flock(FH, LOCK_UN); close(FH); unlink($sOutFile);
+      flock(LH, LOCK_UN); close(LH); unlink($sLckFile); # Unlock, close, and remove the group lockfile.
+      return 456;
+    }
+    $$phProperties{'ClientLogLength'} = $sLogLength = $1;
+    $$phProperties{'ClientOutLength'} = $sOutLength = $2;
+    $$phProperties{'ClientMD5'}       = $3;
+
+    if ($sByteCount != ($sOutLength + $sLogLength + $$phProperties{'StreamTrailerSize'}))
+    {
+      $$psError = "Content length ($sByteCount) does not equal sum of individual stream lengths ($sOutLength + $sLogLength + $$phProperties{'StreamTrailerSize'})";
+      flock(FH, LOCK_UN); close(FH); unlink($sOutFile);
+      flock(LH, LOCK_UN); close(LH); unlink($sLckFile); # Unlock, close, and remove the group lockfile.
+      return 456;
+    }
+
+    ##################################################################
+    #
+    # Split the log data off the end of the output file, and then
+    # write the ready file.
+    #
+    ##################################################################
+
+    if (!open(GH, "> $sLogFile"))
+    {
+      $$psError = "File ($sLogFile) could not be opened ($!)";
+      flock(FH, LOCK_UN); close(FH); unlink($sOutFile);
+      flock(LH, LOCK_UN); close(LH); unlink($sLckFile); # Unlock, close, and remove the group lockfile.
+      return 500;
+    }
+    binmode(GH);
+    flock(GH, LOCK_EX);
+    sysseek(FH, $sOutLength, 0);
+    $sByteCount = SysReadWrite(\*FH, \*GH, $sLogLength, \$sLocalError);
+    if (!defined($sByteCount) || $sByteCount != $sLogLength || !truncate(FH, $sOutLength))
+    {
+      $$psError = (defined($sByteCount)) ? "Log data could not be split from output file ($sOutFile)" : $sLocalError;
+      flock(GH, LOCK_UN); close(GH); unlink($sLogFile);
+      flock(FH, LOCK_UN); close(FH); unlink($sOutFile);
+      flock(LH, LOCK_UN); close(LH); unlink($sLckFile); # Unlock, close, and remove the group lockfile.
+      return 500;
+    }
+    flock(GH, LOCK_UN); close(GH);
+    flock(FH, LOCK_UN); close(FH);
+
+    if (!open(FH, "> $sRdyFile"))
+    {
+      $$psError = "File ($sRdyFile) could not be opened ($!)";
+      flock(LH, LOCK_UN); close(LH); unlink($sLckFile); # Unlock, close, and remove the group lockfile.
+      return 500;
+    }
+    binmode(FH);
+    flock(FH, LOCK_EX);
+    print FH "Version=", $$phProperties{'Version'}, $$phProperties{'Newline'};
+    foreach my $sKey (sort(keys(%{$$phProperties{'GlobalConfigTemplate'}})))
+    {
+      print FH $sKey, "=", $$phProperties{$sKey}, $$phProperties{'Newline'};
+    }
+    flock(FH, LOCK_UN); close(FH);
+    flock(LH, LOCK_UN); close(LH); unlink($sLckFile); # Unlock, close, and remove the group lockfile.
+    $$psError = "Success";
+    return 200;
+  }
+  else
+  {
+    $$psError = "Invalid query string ($$phProperties{'QueryString'})";
+    return 450;
+  }
+}
+
+
 ######################################################################
 #
 # SendResponse
@@ -1147,6 +1453,78 @@ sub SendResponse
 }
 
 
+######################################################################
+#
+# SysReadInflateWrite
+#
+######################################################################
+
+sub SysReadInflateWrite
+{
+  my ($sReadHandle, $sWriteHandle, $sLength, $psError) = @_;
+
+  ####################################################################
+  #
+  # Read gzip-encoded data until EOF or the end of the gzip stream,
+  # and write out the decoded data. If the length is defined, stop
+  # once at least that many decoded bytes have been written.
+  #
+  ####################################################################
+
+  eval { require Compress::Raw::Zlib; };
+  if ($@)
+  {
+    $$psError = "Compress::Raw::Zlib is required to decode gzip content" if (defined($psError));
+    return undef;
+  }
+
+  my ($oInflater, $sStatus) = Compress::Raw::Zlib::Inflate->new(-WindowBits => Compress::Raw::Zlib::WANT_GZIP(), -ConsumeInput => 1);
+  if (!defined($oInflater))
+  {
+    $$psError = "Inflater could not be created ($sStatus)" if (defined($psError));
+    return undef;
+  }
+
+  my ($sData, $sEOF, $sInflated, $sNRead, $sNProcessed, $sNWritten);
+
+  for ($sEOF = $sNProcessed = 0; !$sEOF && (!defined($sLength) || $sNProcessed < $sLength); )
+  {
+    $sNRead = sysread($sReadHandle, $sData, 0x4000);
+    if (!defined($sNRead))
+    {
+      $$psError = "Error reading from input stream ($!)" if (defined($psError));
+      return undef;
+    }
+    elsif ($sNRead == 0)
+    {
+      $sEOF = 1;
+    }
+    else
+    {
+      $sStatus = $oInflater->inflate($sData, $sInflated);
+      if ($sStatus != Compress::Raw::Zlib::Z_OK() && $sStatus != Compress::Raw::Zlib::Z_STREAM_END())
+      {
+        $$psError = "Error decoding input stream ($sStatus)" if (defined($psError));
+        return undef;
+      }
+      if (length($sInflated) > 0)
+      {
+        $sNWritten = syswrite($sWriteHandle, $sInflated, length($sInflated));
+        if (!defined($sNWritten))
+        {
+          $$psError = "Error writing to output stream ($!)" if (defined($psError));
+          return undef;
+        }
+        $sNProcessed += $sNWritten;
+      }
+      $sEOF = 1 if ($sStatus == Compress::Raw::Zlib::Z_STREAM_END());
+    }
+  }
+
+  return $sNProcessed;
+}
+
+
 ######################################################################
 #
 # SysReadWrite
@@ -1160,14 +1538,15 @@ sub SysReadWrite
   ####################################################################
   #
   # Read/Write data, but discard data if write handle is undefined.
+  # If the length is undefined, read until EOF.
   #
   ####################################################################
 
   my ($sData, $sEOF, $sNRead, $sNProcessed, $sNWritten);
 
-  for ($sEOF = $sNRead = $sNProcessed = 0; !$sEOF && $sLength > 0; $sLength -= $sNRead)
+  for ($sEOF = $sNRead = $sNProcessed = 0; !$sEOF && (!defined($sLength) || $sLength > 0); $sLength = (defined($sLength)) ? $sLength - $sNRead : undef)
   {
-    $sNRead = sysread($sReadHandle, $sData, ($sLength > 0x4000) ? 0x4000 : $sLength);
+    $sNRead = sysread($sReadHandle, $sData, (!defined($sLength) || $sLength > 0x4000) ? 0x4000 : $sLength);
     if (!defined($sNRead))
     {
       $$psError = "Error reading from input stream ($!)" if (defined($psError));